@@ -267,11 +267,16 @@ static void applyAndroidFonts(QApplication& app)
 // Test includes (desktop debug builds only)
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS) && defined(SPEEDYNOTE_DEBUG)
 #include "core/PageTests.h"
+#include "strokes/StrokeKernelsTests.h"
 #include "core/DocumentTests.h"
 #include "core/DocumentViewportTests.h"
+#include "core/DarkModeUtilsTests.h"
+#include "core/LibrarySearchIndexTests.h"
 #include "ui/ToolbarButtonTests.h"
 #include "objects/LinkObjectTests.h"
 #include "pdf/MuPdfExporterTests.h"
+#include "pdf/MuPdfProviderTests.h"
+#include "pdf/PdfSearchIndexTests.h"
 #include "ui/ToolbarButtonTestWidget.h"
 #include "ocr/OcrRasterTests.h"
 #include "ocr/OcrGoldenTests.h"
@@ -601,7 +606,7 @@ static void showLauncherAtColdStart(Launcher* launcher)
 // ============================================================================
 
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS) && defined(SPEEDYNOTE_DEBUG)
-static int runTests(const QString& testType)
+static int runTests(const QString& testType, const QString& inputFile)
 {
 #ifdef Q_OS_WIN
     AllocConsole();
@@ -613,16 +618,42 @@ static int runTests(const QString& testType)
 
     if (testType == "page") {
         success = PageTests::runAllTests();
+    } else if (testType == "bench-page-codec") {
+        success = PageTests::benchmarkPageCodec();
+    } else if (testType == "bench-stroke-index") {
+        success = PageTests::benchmarkStrokeSpatialIndex();
+    } else if (testType == "bench-stroke-ids") {
+        success = PageTests::benchmarkStrokeIdMemory();
+    } else if (testType == "bench-stroke-points") {
+        success = PageTests::benchmarkStrokePointMemory();
+    } else if (testType == "stroke-kernels") {
+        success = StrokeKernelsTests::runAllTests();
+    } else if (testType == "bench-stroke-kernels") {
+        success = StrokeKernelsTests::benchmarkStrokeKernels(inputFile);
     } else if (testType == "document") {
         success = DocumentTests::runAllTests();
     } else if (testType == "linkobject") {
         success = LinkObjectTests::runAllTests();
     } else if (testType == "pdfexporter") {
         success = MuPdfExporterTests::runAllTests();
+    } else if (testType == "pdfprovider") {
+        success = MuPdfProviderTests::runAllTests();
+    } else if (testType == "bench-pdf-render") {
+        success = MuPdfProviderTests::benchmarkParallelRender(inputFile);
+    } else if (testType == "search-index") {
+        success = PdfSearchIndexTests::runAllTests();
+    } else if (testType == "library-search") {
+        success = LibrarySearchIndexTests::runAllTests();
+    } else if (testType == "dark-mode") {
+        success = DarkModeUtilsTests::runAllTests();
+    } else if (testType == "bench-dark-mode") {
+        success = DarkModeUtilsTests::benchmarkInversion();
     } else if (testType == "ocr-raster") {
         success = OcrRasterTests::runAllTests();
     } else if (testType == "ocr-golden") {
         success = OcrGoldenTests::runAllTests();
+    } else if (testType == "bench-ocr") {
+        success = OcrGoldenTests::benchmarkOcrThroughput();
 #ifdef SPEEDYNOTE_HAS_VISION_OCR
     } else if (testType == "ocr-vision") {
         success = OcrVisionTests::runAllTests();
@@ -947,6 +978,18 @@ int main(int argc, char* argv[])
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS) && defined(SPEEDYNOTE_DEBUG)
         else if (arg == "--test-page") {
             testToRun = "page";
+        } else if (arg == "--bench-page-codec") {
+            testToRun = "bench-page-codec";
+        } else if (arg == "--bench-stroke-index") {
+            testToRun = "bench-stroke-index";
+        } else if (arg == "--bench-stroke-ids") {
+            testToRun = "bench-stroke-ids";
+        } else if (arg == "--bench-stroke-points") {
+            testToRun = "bench-stroke-points";
+        } else if (arg == "--test-stroke-kernels") {
+            testToRun = "stroke-kernels";
+        } else if (arg == "--bench-stroke-kernels") {
+            testToRun = "bench-stroke-kernels";
         } else if (arg == "--test-document") {
             testToRun = "document";
         } else if (arg == "--test-viewport") {
@@ -959,10 +1002,24 @@ int main(int argc, char* argv[])
             testToRun = "linkobject";
         } else if (arg == "--test-pdfexporter") {
             testToRun = "pdfexporter";
+        } else if (arg == "--test-pdfprovider") {
+            testToRun = "pdfprovider";
+        } else if (arg == "--bench-pdf-render") {
+            testToRun = "bench-pdf-render";
+        } else if (arg == "--test-search-index") {
+            testToRun = "search-index";
+        } else if (arg == "--test-library-search") {
+            testToRun = "library-search";
+        } else if (arg == "--test-dark-mode") {
+            testToRun = "dark-mode";
+        } else if (arg == "--bench-dark-mode") {
+            testToRun = "bench-dark-mode";
         } else if (arg == "--test-ocr-raster") {
             testToRun = "ocr-raster";
         } else if (arg == "--test-ocr-golden") {
             testToRun = "ocr-golden";
+        } else if (arg == "--bench-ocr") {
+            testToRun = "bench-ocr";
         } else if (arg == "--test-ocr-vision") {
             testToRun = "ocr-vision";
         } else if (arg == "--test-ocr-paddle") {
@@ -977,7 +1034,7 @@ int main(int argc, char* argv[])
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS) && defined(SPEEDYNOTE_DEBUG)
     // Handle test commands
     if (!testToRun.isEmpty()) {
-        return runTests(testToRun);
+        return runTests(testToRun, inputFile);
     }
 
     if (runViewportTests) {
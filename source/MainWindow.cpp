@@ -42,6 +42,7 @@
 #include "pdf/MuPdfExporter.h"                 // Phase 8: PDF export engine
 #include <QClipboard>  // For clipboard signal connection
 #include <algorithm>   // Phase M.4: For std::sort in searchMarkdownNotes
+#include <utility>     // For std::as_const
 #include <cmath>       // For std::floor in renderEdgelessThumbnail
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -285,7 +286,10 @@ MainWindow::MainWindow(QWidget *parent)
 #ifdef SPEEDYNOTE_DEBUG
                 qDebug() << "[MainWindow] Triggering auto-save, document count:" << m_documentManager->documentCount();
 #endif
-                int saved = m_documentManager->autoSaveModifiedDocuments();
+                // Inactive (focus lost): write in the background. Suspended:
+                // the process may be killed next, so save synchronously.
+                int saved = m_documentManager->autoSaveModifiedDocuments(
+                    state == Qt::ApplicationInactive);
 #ifdef SPEEDYNOTE_DEBUG
                 qDebug() << "[MainWindow] Auto-saved" << saved << "documents";
 #endif
@@ -6504,6 +6508,18 @@ void MainWindow::setupOcr()
     m_toolbar->setOcrAvailable(false);
 
     m_ocrWorker = new OcrWorker();
+    {
+        // Advanced tuning for in-process recognizers (Linux PaddleOCR); 0 keeps
+        // the engine's own default. No UI: set via the settings file.
+        QSettings settings("SpeedyNote", "App");
+        OcrEngine::InferenceOptions inference;
+        inference.maxBatchSize = settings.value("ocrMaxBatchSize", 0).toInt();
+        inference.intraOpThreads = settings.value("ocrIntraOpThreads", 0).toInt();
+        inference.interOpThreads = settings.value("ocrInterOpThreads", 0).toInt();
+        // 1 turns off parallel line preparation (one thread for everything).
+        inference.prepareThreads = settings.value("ocrPrepareThreads", 0).toInt();
+        m_ocrWorker->setInferenceOptions(inference);
+    }
     m_ocrThread = new QThread(this);
     m_ocrWorker->moveToThread(m_ocrThread);
     connect(m_ocrThread, &QThread::finished, m_ocrWorker, &QObject::deleteLater);
@@ -6909,7 +6925,7 @@ QVector<VectorStroke> MainWindow::collectPageStrokes(const Page* page) const
     QVector<VectorStroke> allStrokes;
     for (const auto& layer : page->vectorLayers) {
         if (layer && layer->visible)
-            allStrokes.append(layer->strokes());
+            allStrokes.append(std::as_const(*layer).strokes());
     }
     return allStrokes;
 }
@@ -12,6 +12,15 @@
 #include <QFileInfo>
 #include <QElapsedTimer>
 #include <QDebug>
+#include <QFuture>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
 
 /**
  * @file BatchOperations.cpp
@@ -97,6 +106,168 @@ bool isSingleFileOutput(const QString& outputPath, const QString& extension)
     return false;
 }
 
+// =============================================================================
+// Parallel Batch Driver
+// =============================================================================
+
+namespace {
+
+/**
+ * @brief Runs the per-notebook work of one batch, several notebooks at a time.
+ * 
+ * The batch loop stays on the calling thread and walks the inputs in order:
+ * settle() reports a result decided on the spot (dry run, invalid bundle,
+ * cancelled), submit() hands the expensive part to the pool, where each
+ * notebook gets its own Document and exporter. Results are counted and passed
+ * to the ResultCallback in input order either way, so callers see the same
+ * sequence as a one-at-a-time run. With one job, submit() runs inline.
+ * 
+ * Once the ResultCallback asks to stop, work already running is finished and
+ * recorded in the BatchResult without further callbacks.
+ */
+class OrderedBatch {
+public:
+    using Work = std::function<FileResult(FileResult)>;
+    
+    OrderedBatch(BatchResult& result, int total, int maxParallelJobs, ResultCallback resultCb)
+        : m_result(result)
+        , m_total(total)
+        , m_resultCb(std::move(resultCb))
+    {
+        const int wanted = maxParallelJobs > 0 ? maxParallelJobs : QThread::idealThreadCount();
+        m_jobs = qBound(1, wanted, qMax(1, total));
+        m_pool.setMaxThreadCount(m_jobs);
+    }
+    
+    /// Notebooks processed at once (at least 1).
+    int jobs() const { return m_jobs; }
+    
+    /// True once the ResultCallback asked to stop.
+    bool stopped() const { return m_stopped; }
+    
+    /// Called on the calling thread for each successful file before it is reported.
+    void setOnSuccess(std::function<void(FileResult&)> onSuccess) { m_onSuccess = std::move(onSuccess); }
+    
+    /// Report a result decided on the calling thread (after everything before it).
+    void settle(int index, const FileResult& fr)
+    {
+        finishAll();
+        if (!m_stopped) {
+            report(index, fr);
+        }
+    }
+    
+    /// Run @p work for @p fr, on the pool when more than one job is allowed.
+    void submit(int index, const FileResult& fr, const Work& work)
+    {
+        if (m_jobs <= 1) {
+            report(index, work(fr));
+            return;
+        }
+        while (int(m_pending.size()) >= m_jobs) {
+            finishFront();
+        }
+        if (m_stopped) {
+            return;
+        }
+        m_pending.push_back({index, fr.outputPath,
+                             QtConcurrent::run(&m_pool, [work, fr]() { return work(fr); })});
+    }
+    
+    /// True if a running notebook writes to @p path.
+    bool isTargetInFlight(const QString& path) const
+    {
+        return std::any_of(m_pending.begin(), m_pending.end(),
+                           [&path](const Pending& p) { return p.target == path; });
+    }
+    
+    /// Finish the running notebooks up to the last one writing to @p path.
+    void waitForTarget(const QString& path)
+    {
+        while (isTargetInFlight(path)) {
+            finishFront();
+        }
+    }
+    
+    /// Finish and report everything still running.
+    void finishAll()
+    {
+        while (!m_pending.empty()) {
+            finishFront();
+        }
+    }
+    
+private:
+    struct Pending {
+        int index;
+        QString target;
+        QFuture<FileResult> future;
+    };
+    
+    void finishFront()
+    {
+        Pending front = m_pending.front();
+        m_pending.pop_front();
+        report(front.index, front.future.result());
+    }
+    
+    void report(int index, FileResult fr)
+    {
+        switch (fr.status) {
+            case FileStatus::Success:
+                if (m_onSuccess) {
+                    m_onSuccess(fr);
+                }
+                m_result.successCount++;
+                m_result.totalOutputSize += fr.outputSize;
+                break;
+            case FileStatus::Skipped:
+                m_result.skippedCount++;
+                break;
+            case FileStatus::Error:
+                m_result.errorCount++;
+                break;
+        }
+        m_result.results.append(fr);
+        if (!m_stopped && m_resultCb && !m_resultCb(index + 1, m_total, fr)) {
+            m_stopped = true;
+        }
+    }
+    
+    BatchResult& m_result;
+    const int m_total;
+    int m_jobs = 1;
+    ResultCallback m_resultCb;
+    std::function<void(FileResult&)> m_onSuccess;
+    bool m_stopped = false;
+    
+    // Declared before the queue: its destructor waits for running work
+    QThreadPool m_pool;
+    std::deque<Pending> m_pending;
+};
+
+/**
+ * @brief generateOutputPath() that also avoids outputs still being written.
+ * 
+ * With auto-rename, notebooks of the same name running side by side must not
+ * both pick "Name.pdf" just because neither file exists yet.
+ */
+QString batchOutputPath(const OrderedBatch& batch, const QString& bundlePath,
+                        const QString& outputDir, const QString& extension, bool autoRename)
+{
+    QString path = generateOutputPath(bundlePath, outputDir, extension, false);
+    if (!autoRename) {
+        return path;
+    }
+    const QString stem = path.left(path.length() - extension.length());
+    for (int counter = 1; QFile::exists(path) || batch.isTargetInFlight(path); ++counter) {
+        path = stem + QString(" (%1)").arg(counter) + extension;
+    }
+    return path;
+}
+
+} // namespace
+
 // =============================================================================
 // SNBX Batch Export
 // =============================================================================
@@ -161,18 +332,53 @@ BatchResult exportSnbxBatch(const QStringList& bundlePaths,
         }
     }
     
-    // Helper: append result and notify caller via callback.
-    // Returns false if caller requested early stop (e.g., fail-fast).
-    bool stopped = false;
-    auto emitResult = [&](int index, const FileResult& fr) {
-        result.results.append(fr);
-        if (resultCb && !resultCb(index + 1, total, fr)) {
-            stopped = true;
+    OrderedBatch batch(result, total, options.maxParallelJobs, resultCb);
+    
+    // Notebooks side by side share the cores: compress each one single-threaded
+    const int compressionThreads = (batch.jobs() > 1) ? 1 : 0;
+    
+    // Worker side: load, materialize and package one notebook
+    auto exportOne = [options, compressionThreads](FileResult fr) {
+        // Load document from bundle
+        std::unique_ptr<Document> doc = Document::loadBundle(fr.inputPath);
+        if (!doc) {
+            fr.status = FileStatus::Error;
+            fr.message = QObject::tr("Failed to load document");
+            return fr;
+        }
+        
+        // Plan B2: materialize imported PDF sources into bundled mini-PDFs before the
+        // recursive zip so the exported .snbx is self-contained.
+        if (doc->needsMaterialization()) {
+            doc->saveBundle(fr.inputPath, /*finalize=*/true);
+        }
+        
+        // Prepare export options
+        NotebookExporter::ExportOptions exportOpts;
+        exportOpts.destPath = fr.outputPath;
+        exportOpts.includePdf = options.includePdf;
+        exportOpts.compressionLevel = options.compressionLevel;
+        exportOpts.maxThreads = compressionThreads;
+        
+        // Call NotebookExporter
+        NotebookExporter::ExportResult exportResult = 
+            NotebookExporter::exportPackage(doc.get(), exportOpts);
+        
+        if (exportResult.success) {
+            fr.status = FileStatus::Success;
+            fr.outputPath = exportResult.exportedPath;
+            fr.outputSize = exportResult.fileSize;
+        } else {
+            fr.status = FileStatus::Error;
+            fr.message = exportResult.errorMessage;
         }
+        return fr;
+        
+        // Document is automatically destroyed here (unique_ptr goes out of scope)
     };
     
     // Process each bundle
-    for (int i = 0; i < total && !stopped; ++i) {
+    for (int i = 0; i < total && !batch.stopped(); ++i) {
         const QString& bundlePath = bundlePaths.at(i);
         FileResult fr;
         fr.inputPath = bundlePath;
@@ -181,8 +387,7 @@ BatchResult exportSnbxBatch(const QStringList& bundlePaths,
         if (cancelled && cancelled->load()) {
             fr.status = FileStatus::Skipped;
             fr.message = QObject::tr("Cancelled");
-            result.skippedCount++;
-            emitResult(i, fr);
+            batch.settle(i, fr);
             continue;
         }
         
@@ -198,7 +403,7 @@ BatchResult exportSnbxBatch(const QStringList& bundlePaths,
         if (singleFileMode) {
             outputPath = options.outputPath;
         } else {
-            outputPath = generateOutputPath(bundlePath, outputDir, ".snbx", !options.overwrite);
+            outputPath = batchOutputPath(batch, bundlePath, outputDir, ".snbx", !options.overwrite);
         }
         fr.outputPath = outputPath;
         
@@ -206,8 +411,7 @@ BatchResult exportSnbxBatch(const QStringList& bundlePaths,
         if (options.dryRun) {
             fr.status = FileStatus::Success;
             fr.message = QObject::tr("Would export to: %1").arg(outputPath);
-            result.successCount++;
-            emitResult(i, fr);
+            batch.settle(i, fr);
             continue;
         }
         
@@ -215,52 +419,15 @@ BatchResult exportSnbxBatch(const QStringList& bundlePaths,
         if (!isValidBundle(bundlePath)) {
             fr.status = FileStatus::Error;
             fr.message = QObject::tr("Not a valid SpeedyNote bundle");
-            result.errorCount++;
-            emitResult(i, fr);
+            batch.settle(i, fr);
             continue;
         }
         
-        // Load document from bundle
-        std::unique_ptr<Document> doc = Document::loadBundle(bundlePath);
-        if (!doc) {
-            fr.status = FileStatus::Error;
-            fr.message = QObject::tr("Failed to load document");
-            result.errorCount++;
-            emitResult(i, fr);
-            continue;
-        }
-        
-        // Plan B2: materialize imported PDF sources into bundled mini-PDFs before the
-        // recursive zip so the exported .snbx is self-contained.
-        if (doc->needsMaterialization()) {
-            doc->saveBundle(bundlePath, /*finalize=*/true);
-        }
-        
-        // Prepare export options
-        NotebookExporter::ExportOptions exportOpts;
-        exportOpts.destPath = outputPath;
-        exportOpts.includePdf = options.includePdf;
-        
-        // Call NotebookExporter
-        NotebookExporter::ExportResult exportResult = 
-            NotebookExporter::exportPackage(doc.get(), exportOpts);
-        
-        if (exportResult.success) {
-            fr.status = FileStatus::Success;
-            fr.outputPath = exportResult.exportedPath;
-            fr.outputSize = exportResult.fileSize;
-            result.successCount++;
-            result.totalOutputSize += exportResult.fileSize;
-        } else {
-            fr.status = FileStatus::Error;
-            fr.message = exportResult.errorMessage;
-            result.errorCount++;
-        }
-        
-        emitResult(i, fr);
-        
-        // Document is automatically destroyed here (unique_ptr goes out of scope)
+        // Overwriting the same file twice: let the earlier export finish first
+        batch.waitForTarget(outputPath);
+        batch.submit(i, fr, exportOne);
     }
+    batch.finishAll();
     
     result.elapsedMs = timer.elapsed();
     
@@ -339,83 +506,32 @@ BatchResult exportPdfBatch(const QStringList& bundlePaths,
         }
     }
     
-    // Helper: append result and notify caller via callback.
-    // Returns false if caller requested early stop (e.g., fail-fast).
-    bool stopped = false;
-    auto emitResult = [&](int index, const FileResult& fr) {
-        result.results.append(fr);
-        if (resultCb && !resultCb(index + 1, total, fr)) {
-            stopped = true;
-        }
-    };
+    OrderedBatch batch(result, total, options.maxParallelJobs, resultCb);
     
-    // Process each bundle
-    for (int i = 0; i < total && !stopped; ++i) {
-        const QString& bundlePath = bundlePaths.at(i);
-        FileResult fr;
-        fr.inputPath = bundlePath;
-        
-        // Check cancellation
-        if (cancelled && cancelled->load()) {
-            fr.status = FileStatus::Skipped;
-            fr.message = QObject::tr("Cancelled");
-            result.skippedCount++;
-            emitResult(i, fr);
-            continue;
-        }
-        
-        // Report progress
-        if (progress) {
-            progress(i + 1, total, bundlePath, QObject::tr("Exporting to PDF..."));
-        }
-        
-        // Determine output path
-        // When overwrite is false, auto-rename to avoid conflicts (e.g., "file (1).pdf")
-        // When overwrite is true, use original filename and overwrite existing
-        QString outputPath;
-        if (singleFileMode) {
-            outputPath = options.outputPath;
-        } else {
-            outputPath = generateOutputPath(bundlePath, outputDir, ".pdf", !options.overwrite);
-        }
-        fr.outputPath = outputPath;
-        
-        // Validate bundle before loading
-        if (!isValidBundle(bundlePath)) {
-            fr.status = FileStatus::Error;
-            fr.message = QObject::tr("Not a valid SpeedyNote bundle");
-            result.errorCount++;
-            emitResult(i, fr);
-            continue;
-        }
-        
+    // Worker side: load and export one notebook with its own Document and
+    // MuPdfExporter (each exporter has its own MuPDF context)
+    auto exportOne = [options](FileResult fr) {
         // Load document from bundle
-        std::unique_ptr<Document> doc = Document::loadBundle(bundlePath);
+        std::unique_ptr<Document> doc = Document::loadBundle(fr.inputPath);
         if (!doc) {
             fr.status = FileStatus::Error;
             fr.message = QObject::tr("Failed to load document");
-            result.errorCount++;
-            emitResult(i, fr);
-            continue;
+            return fr;
         }
         
         // Check if edgeless - PDF export not supported for edgeless notebooks
         if (doc->isEdgeless()) {
             fr.status = FileStatus::Skipped;
             fr.message = QObject::tr("Edgeless notebooks cannot be exported to PDF");
-            result.skippedCount++;
-            emitResult(i, fr);
-            continue;
+            return fr;
         }
         
         // Dry run - just report what would happen
         if (options.dryRun) {
             fr.status = FileStatus::Success;
-            fr.message = QObject::tr("Would export to: %1").arg(outputPath);
+            fr.message = QObject::tr("Would export to: %1").arg(fr.outputPath);
             fr.pagesProcessed = doc->pageCount();
-            result.successCount++;
-            emitResult(i, fr);
-            continue;
+            return fr;
         }
         
         // Release the PdfProvider before exporting. loadBundle() eagerly creates
@@ -430,7 +546,7 @@ BatchResult exportPdfBatch(const QStringList& bundlePaths,
         exporter.setDocument(doc.get());
         
         PdfExportOptions pdfOpts;
-        pdfOpts.outputPath = outputPath;
+        pdfOpts.outputPath = fr.outputPath;
         pdfOpts.dpi = options.dpi;
         pdfOpts.pageRange = options.pageRange;
         pdfOpts.preserveMetadata = options.preserveMetadata;
@@ -439,6 +555,8 @@ BatchResult exportPdfBatch(const QStringList& bundlePaths,
         pdfOpts.darkModeBackground = options.darkModeBackground;
         pdfOpts.darkenStrokes = options.darkenStrokes;
         pdfOpts.skipImageMasking = options.skipImageMasking;
+        pdfOpts.incremental = options.incremental;
+        pdfOpts.appendUpdate = options.appendUpdate;
         
         // Perform export
         PdfExportResult exportResult = exporter.exportPdf(pdfOpts);
@@ -447,18 +565,67 @@ BatchResult exportPdfBatch(const QStringList& bundlePaths,
             fr.status = FileStatus::Success;
             fr.outputSize = exportResult.fileSizeBytes;
             fr.pagesProcessed = exportResult.pagesExported;
-            result.successCount++;
-            result.totalOutputSize += exportResult.fileSizeBytes;
+            fr.pagesReused = exportResult.pagesReused;
         } else {
             fr.status = FileStatus::Error;
             fr.message = exportResult.errorMessage;
-            result.errorCount++;
         }
-        
-        emitResult(i, fr);
+        return fr;
         
         // Document is automatically destroyed here (unique_ptr goes out of scope)
+    };
+    
+    // Process each bundle
+    for (int i = 0; i < total && !batch.stopped(); ++i) {
+        const QString& bundlePath = bundlePaths.at(i);
+        FileResult fr;
+        fr.inputPath = bundlePath;
+        
+        // Check cancellation
+        if (cancelled && cancelled->load()) {
+            fr.status = FileStatus::Skipped;
+            fr.message = QObject::tr("Cancelled");
+            batch.settle(i, fr);
+            continue;
+        }
+        
+        // Report progress
+        if (progress) {
+            progress(i + 1, total, bundlePath, QObject::tr("Exporting to PDF..."));
+        }
+        
+        // Determine output path
+        // When overwrite is false, auto-rename to avoid conflicts (e.g., "file (1).pdf")
+        // When overwrite is true, use original filename and overwrite existing
+        // Incremental exports update their own previous output (an unchanged
+        // file whose manifest names this notebook) in place; any other file
+        // keeps the normal rules.
+        QString outputPath;
+        if (singleFileMode) {
+            outputPath = options.outputPath;
+        } else {
+            const bool ownPreviousExport = options.incremental &&
+                MuPdfExporter::isIncrementalExportOf(
+                    generateOutputPath(bundlePath, outputDir, ".pdf", false),
+                    Document::peekBundleId(bundlePath));
+            outputPath = batchOutputPath(batch, bundlePath, outputDir, ".pdf",
+                                         !options.overwrite && !ownPreviousExport);
+        }
+        fr.outputPath = outputPath;
+        
+        // Validate bundle before loading
+        if (!isValidBundle(bundlePath)) {
+            fr.status = FileStatus::Error;
+            fr.message = QObject::tr("Not a valid SpeedyNote bundle");
+            batch.settle(i, fr);
+            continue;
+        }
+        
+        // Overwriting the same file twice: let the earlier export finish first
+        batch.waitForTarget(outputPath);
+        batch.submit(i, fr, exportOne);
     }
+    batch.finishAll();
     
     result.elapsedMs = timer.elapsed();
     
@@ -579,18 +746,58 @@ BatchResult importSnbxBatch(const QStringList& snbxPaths,
         }
     }
     
-    // Helper: append result and notify caller via callback.
-    // Returns false if caller requested early stop (e.g., fail-fast).
-    bool stopped = false;
-    auto emitResult = [&](int index, const FileResult& fr) {
-        result.results.append(fr);
-        if (resultCb && !resultCb(index + 1, total, fr)) {
-            stopped = true;
+    OrderedBatch batch(result, total, options.maxParallelJobs, resultCb);
+    
+    // Register in NotebookLibrary if requested (on the calling thread)
+    if (options.addToLibrary) {
+        batch.setOnSuccess([](FileResult& fr) {
+            NotebookLibrary::instance()->addToRecent(fr.outputPath);
+        });
+    }
+    
+    // Packages side by side share the cores; a single package at a time gets
+    // the threads for its own entries instead
+    const int entryThreads = (batch.jobs() > 1) ? 1 : 0;
+    
+    // Worker side: extract, fix the extension and measure the bundle
+    auto importOne = [destDir = options.destDir, entryThreads](FileResult fr) {
+        NotebookImporter::ImportResult importResult = 
+            NotebookImporter::importPackage(fr.inputPath, destDir, entryThreads);
+        
+        if (!importResult.success) {
+            fr.status = FileStatus::Error;
+            fr.message = importResult.errorMessage;
+            return fr;
         }
+        
+        // Ensure .snb extension on imported bundle
+        QString finalPath = importResult.extractedSnbPath;
+        if (!finalPath.endsWith(".snb", Qt::CaseInsensitive)) {
+            QString renamedPath = ensureSnbExtension(finalPath);
+            if (renamedPath.isEmpty()) {
+                // Rename failed, but import succeeded - add a note
+                fr.message = QObject::tr("Imported but could not add .snb extension");
+            } else {
+                finalPath = renamedPath;
+            }
+        }
+        
+        // Calculate output size (bundle directory size)
+        qint64 bundleSize = 0;
+        QDirIterator it(finalPath, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            bundleSize += it.fileInfo().size();
+        }
+        
+        fr.status = FileStatus::Success;
+        fr.outputPath = finalPath;
+        fr.outputSize = bundleSize;
+        return fr;
     };
     
     // Process each .snbx file
-    for (int i = 0; i < total && !stopped; ++i) {
+    for (int i = 0; i < total && !batch.stopped(); ++i) {
         const QString& snbxPath = snbxPaths.at(i);
         FileResult fr;
         fr.inputPath = snbxPath;
@@ -599,8 +806,7 @@ BatchResult importSnbxBatch(const QStringList& snbxPaths,
         if (cancelled && cancelled->load()) {
             fr.status = FileStatus::Skipped;
             fr.message = QObject::tr("Cancelled");
-            result.skippedCount++;
-            emitResult(i, fr);
+            batch.settle(i, fr);
             continue;
         }
         
@@ -613,8 +819,7 @@ BatchResult importSnbxBatch(const QStringList& snbxPaths,
         if (!QFile::exists(snbxPath)) {
             fr.status = FileStatus::Error;
             fr.message = QObject::tr("File not found");
-            result.errorCount++;
-            emitResult(i, fr);
+            batch.settle(i, fr);
             continue;
         }
         
@@ -632,11 +837,17 @@ BatchResult importSnbxBatch(const QStringList& snbxPaths,
         if (options.dryRun) {
             fr.status = FileStatus::Success;
             fr.message = QObject::tr("Would import to: %1").arg(expectedOutputPath);
-            result.successCount++;
-            emitResult(i, fr);
+            batch.settle(i, fr);
             continue;
         }
         
+        // Two packages of the same name: let the first finish, so overwrite
+        // and auto-rename behave as they do one at a time
+        batch.waitForTarget(expectedOutputPath);
+        if (batch.stopped()) {
+            break;
+        }
+        
         // If overwrite is enabled and target exists, remove it first
         // When overwrite is false, NotebookImporter handles auto-rename internally
         if (QDir(expectedOutputPath).exists() && options.overwrite) {
@@ -644,57 +855,14 @@ BatchResult importSnbxBatch(const QStringList& snbxPaths,
             if (!existingDir.removeRecursively()) {
                 fr.status = FileStatus::Error;
                 fr.message = QObject::tr("Failed to remove existing notebook for overwrite");
-                result.errorCount++;
-                emitResult(i, fr);
+                batch.settle(i, fr);
                 continue;
             }
         }
         
-        // Call NotebookImporter
-        NotebookImporter::ImportResult importResult = 
-            NotebookImporter::importPackage(snbxPath, options.destDir);
-        
-        if (!importResult.success) {
-            fr.status = FileStatus::Error;
-            fr.message = importResult.errorMessage;
-            result.errorCount++;
-            emitResult(i, fr);
-            continue;
-        }
-        
-        // Ensure .snb extension on imported bundle
-        QString finalPath = importResult.extractedSnbPath;
-        if (!finalPath.endsWith(".snb", Qt::CaseInsensitive)) {
-            QString renamedPath = ensureSnbExtension(finalPath);
-            if (renamedPath.isEmpty()) {
-                // Rename failed, but import succeeded - add a note
-                fr.message = QObject::tr("Imported but could not add .snb extension");
-            } else {
-                finalPath = renamedPath;
-            }
-        }
-        
-        // Calculate output size (bundle directory size)
-        qint64 bundleSize = 0;
-        QDirIterator it(finalPath, QDir::Files, QDirIterator::Subdirectories);
-        while (it.hasNext()) {
-            it.next();
-            bundleSize += it.fileInfo().size();
-        }
-        
-        // Register in NotebookLibrary if requested
-        if (options.addToLibrary) {
-            NotebookLibrary::instance()->addToRecent(finalPath);
-        }
-        
-        fr.status = FileStatus::Success;
-        fr.outputPath = finalPath;
-        fr.outputSize = bundleSize;
-        result.successCount++;
-        result.totalOutputSize += bundleSize;
-        
-        emitResult(i, fr);
+        batch.submit(i, fr, importOne);
     }
+    batch.finishAll();
     
     result.elapsedMs = timer.elapsed();
     
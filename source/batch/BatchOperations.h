@@ -48,6 +48,7 @@ struct FileResult {
     QString message;                ///< Error message or skip reason
     qint64 outputSize = 0;          ///< Output file size in bytes (0 if not created)
     int pagesProcessed = 0;         ///< Number of pages exported (PDF only)
+    int pagesReused = 0;            ///< Pages copied from the previous export (incremental PDF only)
 };
 
 /**
@@ -117,6 +118,8 @@ using ResultCallback = std::function<bool(int current, int total,
 struct ExportSnbxOptions {
     QString outputPath;             ///< Output file (single) or directory (batch)
     bool includePdf = true;         ///< Embed source PDF in package
+    int compressionLevel = 6;       ///< Deflate level: 0 = store, 1 = fastest ... 9 = smallest
+    int maxParallelJobs = 1;        ///< Notebooks exported at once; 0 = QThread::idealThreadCount()
     bool overwrite = false;         ///< Overwrite existing output files
     bool dryRun = false;            ///< Preview only, don't create files
 };
@@ -134,6 +137,9 @@ struct ExportPdfOptions {
     bool darkModeBackground = false; ///< Apply HSL lightness inversion to PDF background
     bool darkenStrokes = false;      ///< Darken light-coloured strokes for printing
     bool skipImageMasking = false;   ///< Bypass image-region detection (invert everything)
+    bool incremental = false;       ///< Re-export over the previous output, re-rendering changed pages only
+    bool appendUpdate = false;      ///< With incremental: append changes as a PDF incremental update
+    int maxParallelJobs = 1;        ///< Notebooks exported at once; 0 = QThread::idealThreadCount()
     bool overwrite = false;         ///< Overwrite existing output files
     bool dryRun = false;            ///< Preview only, don't create files
 };
@@ -146,6 +152,7 @@ struct ImportOptions {
     bool overwrite = false;         ///< Overwrite existing bundles with same name
     bool dryRun = false;            ///< Preview only, don't extract files
     bool addToLibrary = false;      ///< Register imported notebooks in NotebookLibrary
+    int maxParallelJobs = 1;        ///< Packages imported at once; 0 = QThread::idealThreadCount()
 };
 
 // =============================================================================
@@ -162,6 +169,14 @@ struct ImportOptions {
  * - Multiple bundles + directory: generates filenames from bundle names
  * - Single bundle + directory: generates filename from bundle name
  * 
+ * Parallelism: with options.maxParallelJobs > 1, that many notebooks are
+ * loaded and exported at once on a private thread pool, each with its own
+ * Document. Progress and result callbacks still run on the calling thread,
+ * in input order, and auto-renamed outputs are unique across the batch.
+ * Cancellation stops new notebooks from starting; ones already running
+ * complete. After a result callback returns false, running notebooks are
+ * finished and added to the BatchResult without further callbacks.
+ * 
  * @param bundlePaths List of .snb bundle paths (directories)
  * @param options Export options
  * @param progress Optional progress callback (called before each file)
@@ -183,6 +198,13 @@ BatchResult exportSnbxBatch(const QStringList& bundlePaths,
  * - Edgeless notebooks are skipped with FileStatus::Skipped
  * - Page range applies to all documents (pages out of range are clamped)
  * - annotationsOnly mode exports strokes on blank background
+ * - incremental mode reuses the unchanged pages of the notebook's previous
+ *   incremental export: an output with a manifest (see
+ *   MuPdfExporter::manifestPath()) is updated in place rather than
+ *   auto-renamed; other existing files keep the normal collision rules
+ * - Runs options.maxParallelJobs notebooks at once, each with its own
+ *   Document and MuPdfExporter (see exportSnbxBatch() for the ordering
+ *   and cancellation guarantees)
  * 
  * @param bundlePaths List of .snb bundle paths (directories)
  * @param options Export options
@@ -202,6 +224,9 @@ BatchResult exportPdfBatch(const QStringList& bundlePaths,
  * Extracts SNBX packages to the destination directory.
  * Imported bundles are given .snb extension if the original didn't have one.
  * 
+ * Up to ImportOptions::maxParallelJobs packages are extracted concurrently
+ * (see exportSnbxBatch() for the ordering guarantees).
+ * 
  * @param snbxPaths List of .snbx file paths
  * @param options Import options
  * @param progress Optional progress callback
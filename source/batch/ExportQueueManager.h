@@ -81,8 +81,9 @@ public:
     /**
      * @brief Cancel the current export and clear the queue.
      * 
-     * The current job will complete its current file before stopping.
-     * Already exported files are not affected.
+     * The current job will complete the file(s) it is working on before
+     * stopping (several when options.maxParallelJobs > 1); no new files are
+     * started. Already exported files are not affected.
      */
     void cancelAll();
 
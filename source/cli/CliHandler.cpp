@@ -49,6 +49,34 @@ int exitCodeFromResult(const BatchOps::BatchResult& result)
     return ExitCode::PartialFailure;
 }
 
+namespace {
+
+/**
+ * @brief Apply --jobs (notebooks processed in parallel) to a batch command.
+ * 
+ * Stores the job count in @p maxParallelJobs (0 = one per CPU core) and
+ * switches @p progress to concurrent reporting when more than one runs.
+ * 
+ * @return ExitCode::Success, or ExitCode::InvalidArgs after reporting a bad value
+ */
+int applyJobsOption(const QCommandLineParser& parser, ConsoleProgress& progress,
+                    int& maxParallelJobs)
+{
+    bool ok = false;
+    const int jobs = parser.value(QStringLiteral("jobs")).toInt(&ok);
+    if (!ok || jobs < 0) {
+        progress.reportError(QCoreApplication::translate("CLI",
+            "Invalid job count: %1 (expected 0 or more).")
+            .arg(parser.value(QStringLiteral("jobs"))));
+        return ExitCode::InvalidArgs;
+    }
+    maxParallelJobs = jobs;
+    progress.setConcurrent(jobs != 1);
+    return ExitCode::Success;
+}
+
+} // namespace
+
 // =============================================================================
 // Export PDF Handler
 // =============================================================================
@@ -126,7 +154,17 @@ int handleExportPdf(const QCommandLineParser& parser)
     options.darkModeBackground = parser.isSet(QStringLiteral("dark-background"));
     options.darkenStrokes = parser.isSet(QStringLiteral("darken-strokes"));
     options.skipImageMasking = parser.isSet(QStringLiteral("skip-image-masking"));
+    
+    // Incremental re-export (--append-update implies --incremental)
+    options.appendUpdate = parser.isSet(QStringLiteral("append-update"));
+    options.incremental = options.appendUpdate || parser.isSet(QStringLiteral("incremental"));
 
+    // Parallel notebooks
+    int jobsExit = applyJobsOption(parser, progress, options.maxParallelJobs);
+    if (jobsExit != ExitCode::Success) {
+        return jobsExit;
+    }
+    
     // Fail-fast support
     bool failFast = parser.isSet(QStringLiteral("fail-fast"));
     
@@ -220,6 +258,23 @@ int handleExportSnbx(const QCommandLineParser& parser)
     options.dryRun = parser.isSet(QStringLiteral("dry-run"));
     options.includePdf = !parser.isSet(QStringLiteral("no-pdf"));
     
+    // Compression level
+    bool levelOk = false;
+    int level = parser.value(QStringLiteral("level")).toInt(&levelOk);
+    if (!levelOk || level < 0 || level > 9) {
+        progress.reportError(QCoreApplication::translate("CLI",
+            "Invalid compression level: %1 (expected 0-9).")
+            .arg(parser.value(QStringLiteral("level"))));
+        return ExitCode::InvalidArgs;
+    }
+    options.compressionLevel = level;
+    
+    // Parallel notebooks
+    int jobsExit = applyJobsOption(parser, progress, options.maxParallelJobs);
+    if (jobsExit != ExitCode::Success) {
+        return jobsExit;
+    }
+    
     // Fail-fast support
     bool failFast = parser.isSet(QStringLiteral("fail-fast"));
     
@@ -307,6 +362,12 @@ int handleImport(const QCommandLineParser& parser)
     options.dryRun = parser.isSet(QStringLiteral("dry-run"));
     options.addToLibrary = parser.isSet(QStringLiteral("add-to-library"));
     
+    // Parallel notebooks
+    int jobsExit = applyJobsOption(parser, progress, options.maxParallelJobs);
+    if (jobsExit != ExitCode::Success) {
+        return jobsExit;
+    }
+    
     // Fail-fast support
     bool failFast = parser.isSet(QStringLiteral("fail-fast"));
     
@@ -153,6 +153,14 @@ void setupParser(QCommandLineParser& parser, Command cmd)
                 QStringLiteral("skip-image-masking"),
                 QCoreApplication::translate("CLI", "Bypass image-region detection and invert entire page")));
 
+            parser.addOption(QCommandLineOption(
+                QStringLiteral("incremental"),
+                QCoreApplication::translate("CLI", "Re-render only pages changed since the last incremental export")));
+
+            parser.addOption(QCommandLineOption(
+                QStringLiteral("append-update"),
+                QCoreApplication::translate("CLI", "Append changed pages as a PDF incremental update (implies --incremental)")));
+
             parser.addOption(QCommandLineOption(
                 QStringLiteral("overwrite"),
                 QCoreApplication::translate("CLI", "Overwrite existing output files")));
@@ -165,6 +173,12 @@ void setupParser(QCommandLineParser& parser, Command cmd)
                 QStringLiteral("detect-all"),
                 QCoreApplication::translate("CLI", "Find bundles without .snb extension")));
             
+            parser.addOption(QCommandLineOption(
+                QStringLiteral("jobs"),
+                QCoreApplication::translate("CLI", "Notebooks processed in parallel (0 = all cores, default: 1)"),
+                QStringLiteral("N"),
+                QStringLiteral("1")));
+            
             parser.addOption(QCommandLineOption(
                 QStringLiteral("fail-fast"),
                 QCoreApplication::translate("CLI", "Stop on first error")));
@@ -197,6 +211,12 @@ void setupParser(QCommandLineParser& parser, Command cmd)
                 QStringLiteral("no-pdf"),
                 QCoreApplication::translate("CLI", "Don't embed source PDF in package")));
             
+            parser.addOption(QCommandLineOption(
+                QStringLiteral("level"),
+                QCoreApplication::translate("CLI", "Compression level 0-9: 0 = store, 1 = fastest, 9 = smallest (default: 6)"),
+                QStringLiteral("N"),
+                QStringLiteral("6")));
+            
             parser.addOption(QCommandLineOption(
                 QStringLiteral("overwrite"),
                 QCoreApplication::translate("CLI", "Overwrite existing output files")));
@@ -209,6 +229,12 @@ void setupParser(QCommandLineParser& parser, Command cmd)
                 QStringLiteral("detect-all"),
                 QCoreApplication::translate("CLI", "Find bundles without .snb extension")));
             
+            parser.addOption(QCommandLineOption(
+                QStringLiteral("jobs"),
+                QCoreApplication::translate("CLI", "Notebooks processed in parallel (0 = all cores, default: 1)"),
+                QStringLiteral("N"),
+                QStringLiteral("1")));
+            
             parser.addOption(QCommandLineOption(
                 QStringLiteral("fail-fast"),
                 QCoreApplication::translate("CLI", "Stop on first error")));
@@ -249,6 +275,12 @@ void setupParser(QCommandLineParser& parser, Command cmd)
                 QStringLiteral("recursive"),
                 QCoreApplication::translate("CLI", "Search input directories recursively")));
             
+            parser.addOption(QCommandLineOption(
+                QStringLiteral("jobs"),
+                QCoreApplication::translate("CLI", "Notebooks processed in parallel (0 = all cores, default: 1)"),
+                QStringLiteral("N"),
+                QStringLiteral("1")));
+            
             parser.addOption(QCommandLineOption(
                 QStringLiteral("fail-fast"),
                 QCoreApplication::translate("CLI", "Stop on first error")));
@@ -346,6 +378,11 @@ void showHelp(const QCommandLineParser& parser, Command cmd)
             "  --dark-background      Apply dark mode lightness inversion to PDF backgrounds\n"
             "  --darken-strokes       Darken light-coloured strokes for printing\n"
             "  --skip-image-masking   Bypass image detection, invert entire page\n"
+            "  --incremental           Re-render only pages changed since the last\n"
+            "                          incremental export to the same file\n"
+            "  --append-update         Append changed pages to the existing PDF as an\n"
+            "                          incremental update instead of rewriting it\n"
+            "                          (implies --incremental; the file grows each time)\n"
             "  --no-metadata           Don't preserve PDF metadata\n"
             "  --no-outline            Don't preserve PDF bookmarks/outline\n"
             "\n"
@@ -357,6 +394,8 @@ void showHelp(const QCommandLineParser& parser, Command cmd)
             "  --verbose               Show detailed progress\n"
             "  --json                  Output results as JSON\n"
             "  --fail-fast             Stop on first error\n"
+            "  --jobs <N>              Notebooks processed in parallel (default: 1)\n"
+            "                          0 = one per CPU core. Results keep input order.\n"
             "  --dry-run               Preview without creating files\n"
             "  -h, --help              Show this help\n"
             "\n"
@@ -373,6 +412,12 @@ void showHelp(const QCommandLineParser& parser, Command cmd)
             "  # Preview what would be exported\n"
             "  speedynote export-pdf ~/Notes/ -o ~/PDFs/ --dry-run\n"
             "\n"
+            "  # Re-export after small edits, rendering only changed pages\n"
+            "  speedynote export-pdf ~/Notes/Thesis.snb -o ~/PDFs/thesis.pdf --incremental\n"
+            "\n"
+            "  # Export a large library using every CPU core\n"
+            "  speedynote export-pdf ~/Notes/ -o ~/PDFs/ --recursive --jobs 0\n"
+            "\n"
             "NOTE: Edgeless canvas notebooks are skipped (PDF export requires pages).\n");
     } else if (cmd == Command::ExportSnbx) {
         // SNBX export help
@@ -390,6 +435,9 @@ void showHelp(const QCommandLineParser& parser, Command cmd)
             "\n"
             "EXPORT OPTIONS:\n"
             "  --no-pdf                Don't embed source PDF (smaller package files)\n"
+            "  --level <N>             Compression level 0-9 (default: 6)\n"
+            "                          1 = fastest, 9 = smallest, 0 = store only.\n"
+            "                          PDFs and images are always stored as-is.\n"
             "\n"
             "DISCOVERY OPTIONS:\n"
             "  --recursive             Search directories recursively\n"
@@ -399,6 +447,8 @@ void showHelp(const QCommandLineParser& parser, Command cmd)
             "  --verbose               Show detailed progress\n"
             "  --json                  Output results as JSON\n"
             "  --fail-fast             Stop on first error\n"
+            "  --jobs <N>              Notebooks processed in parallel (default: 1)\n"
+            "                          0 = one per CPU core. Results keep input order.\n"
             "  --dry-run               Preview without creating files\n"
             "  -h, --help              Show this help\n"
             "\n"
@@ -409,6 +459,9 @@ void showHelp(const QCommandLineParser& parser, Command cmd)
             "  # Backup without PDFs (smaller files)\n"
             "  speedynote export-snbx ~/Notes/ -o ~/Backup/ --no-pdf\n"
             "\n"
+            "  # Fast backup of large notebooks\n"
+            "  speedynote export-snbx ~/Notes/ -o ~/Backup/ --level 1\n"
+            "\n"
             "  # Single notebook backup\n"
             "  speedynote export-snbx ~/Notes/Project.snb -o ~/Desktop/project.snbx\n"
             "\n"
@@ -441,6 +494,8 @@ void showHelp(const QCommandLineParser& parser, Command cmd)
             "  --verbose               Show detailed progress\n"
             "  --json                  Output results as JSON\n"
             "  --fail-fast             Stop on first error\n"
+            "  --jobs <N>              Notebooks processed in parallel (default: 1)\n"
+            "                          0 = one per CPU core. Results keep input order.\n"
             "  --dry-run               Preview without importing\n"
             "  -h, --help              Show this help\n"
             "\n"
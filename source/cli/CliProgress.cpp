@@ -38,7 +38,7 @@ BatchOps::ProgressCallback ConsoleProgress::callback()
             return;
         }
         
-        if (m_mode == OutputMode::Verbose) {
+        if (m_mode == OutputMode::Verbose && !m_concurrent) {
             // Verbose: show what we're about to process
             m_out << QStringLiteral("[%1/%2] %3: %4\n")
                      .arg(current)
@@ -74,6 +74,13 @@ void ConsoleProgress::reportFile(int index, int total, const BatchOps::FileResul
 {
     m_currentIndex = index;
     m_totalCount = total;
+    if (m_mode == OutputMode::Verbose && m_concurrent) {
+        // The header was held back at start (see setConcurrent())
+        m_out << QStringLiteral("[%1/%2] %3\n")
+                 .arg(index)
+                 .arg(total)
+                 .arg(shortName(result.inputPath));
+    }
     reportFile(result);
 }
 
@@ -87,7 +94,10 @@ void ConsoleProgress::reportFileSimple(const BatchOps::FileResult& result)
     switch (result.status) {
         case BatchOps::FileStatus::Success:
             statusStr = QCoreApplication::translate("CLI", "OK");
-            if (result.pagesProcessed > 0) {
+            if (result.pagesProcessed > 0 && result.pagesReused > 0) {
+                statusStr += QStringLiteral(" (%1 pages, %2 reused)")
+                                 .arg(result.pagesProcessed).arg(result.pagesReused);
+            } else if (result.pagesProcessed > 0) {
                 statusStr += QStringLiteral(" (%1 pages)").arg(result.pagesProcessed);
             }
             break;
@@ -132,6 +142,9 @@ void ConsoleProgress::reportFileVerbose(const BatchOps::FileResult& result)
             m_out << QCoreApplication::translate("CLI", "Success");
             if (result.pagesProcessed > 0) {
                 m_out << QStringLiteral(" (%1 pages").arg(result.pagesProcessed);
+                if (result.pagesReused > 0) {
+                    m_out << QStringLiteral(", %1 reused").arg(result.pagesReused);
+                }
                 if (result.outputSize > 0) {
                     m_out << ", " << formatSize(result.outputSize);
                 }
@@ -181,6 +194,10 @@ void ConsoleProgress::reportFileJson(const BatchOps::FileResult& result)
         m_out << ",\"pages\":" << result.pagesProcessed;
     }
     
+    if (result.pagesReused > 0) {
+        m_out << ",\"reused\":" << result.pagesReused;
+    }
+    
     if (!result.message.isEmpty()) {
         m_out << ",\"message\":\"" << jsonEscape(result.message) << "\"";
     }
@@ -58,6 +58,16 @@ public:
      */
     BatchOps::ProgressCallback callback();
     
+    /**
+     * @brief Tell the reporter that several files are processed at once.
+     * 
+     * With --jobs, files start well before their results arrive. Verbose
+     * mode then prints each file's "[n/total]" header together with its
+     * result instead of at start, so every block stays contiguous. Results
+     * must be reported with reportFile(index, total, result).
+     */
+    void setConcurrent(bool concurrent) { m_concurrent = concurrent; }
+    
     /**
      * @brief Report completion of a file operation.
      * 
@@ -150,6 +160,7 @@ private:
     QTextStream m_err;      ///< stderr stream
     int m_currentIndex = 0; ///< Current file index (for progress callback)
     int m_totalCount = 0;   ///< Total file count (for progress callback)
+    bool m_concurrent = false; ///< Several files in flight (see setConcurrent())
 };
 
 } // namespace Cli
@@ -5,8 +5,12 @@
 #include "DarkModeUtils.h"
 #include "../compat/qt_compat.h"
 
+#include <QThreadPool>
+#include <QtConcurrent>
+
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace DarkModeUtils {
 
@@ -85,6 +89,187 @@ static void hslToRgb(const HSL& hsl, int& r, int& g, int& b)
     b = std::clamp(hslComponent(p, q, hsl.h - 120), 0, 255);
 }
 
+static inline QRgb invertPixelHsl(QRgb px)
+{
+    int r = qRed(px);
+    int g = qGreen(px);
+    int b = qBlue(px);
+
+    HSL hsl = rgbToHsl(r, g, b);
+    hsl.l = 255 - hsl.l;
+    hslToRgb(hsl, r, g, b);
+
+    return qRgba(r, g, b, qAlpha(px));
+}
+
+// ---------------------------------------------------------------------------
+// Fast inversion kernel
+// ---------------------------------------------------------------------------
+// Exact shortcuts that keep the output bit-identical to invertPixelHsl():
+//  - Gray pixels (r == g == b == c) have L = c and are achromatic, so they
+//    map to 255 - c per channel, i.e. an XOR of the colour bits with 0xFF.
+//    PDF pages are mostly white paper and gray anti-aliased text, which the
+//    SIMD loop below handles four pixels at a time.
+//  - Coloured pixels go through the integer HSL round trip, memoized in a
+//    small direct-mapped cache: pages use few distinct colours, and their
+//    anti-aliased edges repeat the same blends over and over.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SN_DARKMODE_SSE 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SN_DARKMODE_NEON 1
+#endif
+
+namespace {
+
+constexpr QRgb kGrayFlip = 0x00FFFFFF;
+
+/// Row bands handed to the thread pool; tall enough to amortize scheduling.
+constexpr int kBandRows = 64;
+
+/// Below this many pixels the image is inverted on the calling thread.
+constexpr qint64 kParallelMinPixels = 512 * 1024;
+
+class ColorCache {
+public:
+    ColorCache() : m_entries(kSize, Entry{kEmpty, 0}) {}
+
+    QRgb invert(QRgb px)
+    {
+        const quint32 rgb = px & 0x00FFFFFFu;
+        Entry& e = m_entries[(rgb * 2654435761u) >> (32 - kBits)];
+        if (e.rgb != rgb) {
+            e.rgb = rgb;
+            e.inverted = invertPixelHsl(px) & 0x00FFFFFFu;
+        }
+        return (px & 0xFF000000u) | e.inverted;
+    }
+
+private:
+    static constexpr int kBits = 12;
+    static constexpr int kSize = 1 << kBits;
+    static constexpr quint32 kEmpty = 0xFFFFFFFFu;  // never a 24-bit key
+
+    struct Entry {
+        quint32 rgb;
+        quint32 inverted;
+    };
+    std::vector<Entry> m_entries;
+};
+
+inline QRgb invertPixelFast(QRgb px, ColorCache& cache)
+{
+    if (qAlpha(px) == 0)
+        return px;
+    if (((px ^ (px >> 8)) & 0xFFFFu) == 0)
+        return px ^ kGrayFlip;
+    return cache.invert(px);
+}
+
+/// Invert the pixels [0, count) of one span-free run.
+void invertRun(QRgb* px, int count, ColorCache& cache)
+{
+    int i = 0;
+#if defined(SN_DARKMODE_SSE)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lowMask = _mm_set1_epi32(0xFFFF);
+    const __m128i flip = _mm_set1_epi32(int(kGrayFlip));
+    for (; i + 4 <= count; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(px + i);
+        const __m128i v = _mm_loadu_si128(p);
+        const __m128i chroma = _mm_and_si128(_mm_xor_si128(v, _mm_srli_epi32(v, 8)), lowMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(chroma, zero)) == 0xFFFF) {
+            const __m128i transparent = _mm_cmpeq_epi32(_mm_srli_epi32(v, 24), zero);
+            _mm_storeu_si128(p, _mm_xor_si128(v, _mm_andnot_si128(transparent, flip)));
+        } else {
+            for (int k = i; k < i + 4; ++k)
+                px[k] = invertPixelFast(px[k], cache);
+        }
+    }
+#elif defined(SN_DARKMODE_NEON)
+    const uint32x4_t zero = vdupq_n_u32(0);
+    const uint32x4_t lowMask = vdupq_n_u32(0xFFFF);
+    const uint32x4_t flip = vdupq_n_u32(kGrayFlip);
+    for (; i + 4 <= count; i += 4) {
+        uint32_t* p = reinterpret_cast<uint32_t*>(px + i);
+        const uint32x4_t v = vld1q_u32(p);
+        const uint32x4_t chroma = vandq_u32(veorq_u32(v, vshrq_n_u32(v, 8)), lowMask);
+        if (vmaxvq_u32(chroma) == 0) {
+            const uint32x4_t transparent = vceqq_u32(vshrq_n_u32(v, 24), zero);
+            vst1q_u32(p, veorq_u32(v, vbicq_u32(flip, transparent)));
+        } else {
+            for (int k = i; k < i + 4; ++k)
+                px[k] = invertPixelFast(px[k], cache);
+        }
+    }
+#endif
+    for (; i < count; ++i)
+        px[i] = invertPixelFast(px[i], cache);
+}
+
+using SkipSpans = QVector<QVector<std::pair<int, int>>>;
+
+/**
+ * Per-row skip spans, sorted and merged, with the same clamping as the
+ * reference: a rect is clamped into the image (so one lying entirely off to
+ * the side still masks the edge column) and spans with x0 > x1 mask nothing.
+ */
+SkipSpans buildSkipSpans(const QVector<QRect>& imageRegions, int w, int h)
+{
+    SkipSpans skipSpans;
+    if (imageRegions.isEmpty())
+        return skipSpans;
+
+    skipSpans.resize(h);
+    for (const QRect& r : imageRegions) {
+        const int y0 = std::clamp(r.top(),    0, h - 1);
+        const int y1 = std::clamp(r.bottom(), 0, h - 1);
+        const int x0 = std::clamp(r.left(),   0, w - 1);
+        const int x1 = std::clamp(r.right(),  0, w - 1);
+        if (x0 > x1)
+            continue;
+        for (int y = y0; y <= y1; ++y)
+            skipSpans[y].append({x0, x1});
+    }
+
+    for (auto& spans : skipSpans) {
+        if (spans.size() < 2)
+            continue;
+        std::sort(spans.begin(), spans.end());
+        int out = 0;
+        for (int i = 1; i < spans.size(); ++i) {
+            if (spans[i].first <= spans[out].second + 1)
+                spans[out].second = std::max(spans[out].second, spans[i].second);
+            else
+                spans[++out] = spans[i];
+        }
+        spans.resize(out + 1);
+    }
+    return skipSpans;
+}
+
+void invertRows(uchar* bits, qsizetype stride, int w, int y0, int y1, const SkipSpans& skipSpans)
+{
+    ColorCache cache;
+    for (int y = y0; y < y1; ++y) {
+        auto* scanline = reinterpret_cast<QRgb*>(bits + y * stride);
+        if (skipSpans.isEmpty() || skipSpans[y].isEmpty()) {
+            invertRun(scanline, w, cache);
+            continue;
+        }
+        int x = 0;
+        for (const auto& span : skipSpans[y]) {
+            invertRun(scanline + x, span.first - x, cache);
+            x = span.second + 1;
+        }
+        invertRun(scanline + x, w - x, cache);
+    }
+}
+
+} // namespace
+
 // ---------------------------------------------------------------------------
 // Public API
 // ---------------------------------------------------------------------------
@@ -98,13 +283,44 @@ void invertImageLightness(QImage& image, const QVector<QRect>& imageRegions)
         image = image.convertToFormat(QImage::Format_ARGB32);
     }
 
+    const int w = image.width();
+    const int h = image.height();
+    const SkipSpans skipSpans = buildSkipSpans(imageRegions, w, h);
+
+    // Detach once up front; the bands then write through the raw pointer.
+    uchar* bits = image.bits();
+    const qsizetype stride = image.bytesPerLine();
+
+    if (qint64(w) * h < kParallelMinPixels || QThreadPool::globalInstance()->maxThreadCount() < 2) {
+        invertRows(bits, stride, w, 0, h, skipSpans);
+        return;
+    }
+
+    // Bands are disjoint row ranges; blockingMap lets the calling thread
+    // take bands too, so this never waits on an otherwise busy pool.
+    QVector<int> bandStarts;
+    bandStarts.reserve((h + kBandRows - 1) / kBandRows);
+    for (int y = 0; y < h; y += kBandRows)
+        bandStarts.append(y);
+    QtConcurrent::blockingMap(bandStarts, [=, &skipSpans](const int& y0) {
+        invertRows(bits, stride, w, y0, std::min(y0 + kBandRows, h), skipSpans);
+    });
+}
+
+void invertImageLightnessReference(QImage& image, const QVector<QRect>& imageRegions)
+{
+    if (image.isNull()) return;
+
+    if (image.format() != QImage::Format_ARGB32) {
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
     const int w = image.width();
     const int h = image.height();
 
     // Build a per-scanline skip mask so that pixels inside raster-image
     // bounding boxes are left untouched.  For each row we store a sorted
     // list of (x_start, x_end) spans.
-    // For pages without images this is empty and costs almost nothing.
     QVector<QVector<std::pair<int,int>>> skipSpans(h);
     for (const QRect& r : imageRegions) {
         int y0 = std::clamp(r.top(),    0, h - 1);
@@ -116,8 +332,6 @@ void invertImageLightness(QImage& image, const QVector<QRect>& imageRegions)
         }
     }
 
-    // Pure HSL lightness inversion for non-image pixels.
-    // Image regions are skipped entirely (structural masking via MuPDF).
     for (int y = 0; y < h; ++y) {
         auto* scanline = reinterpret_cast<QRgb*>(image.scanLine(y));
         const auto& spans = skipSpans[y];
@@ -135,18 +349,9 @@ void invertImageLightness(QImage& image, const QVector<QRect>& imageRegions)
             if (inImage) continue;
 
             QRgb px = scanline[x];
-            int a = qAlpha(px);
-            if (a == 0) continue;
-
-            int r = qRed(px);
-            int g = qGreen(px);
-            int b = qBlue(px);
-
-            HSL hsl = rgbToHsl(r, g, b);
-            hsl.l = 255 - hsl.l;
-            hslToRgb(hsl, r, g, b);
+            if (qAlpha(px) == 0) continue;
 
-            scanline[x] = qRgba(r, g, b, a);
+            scanline[x] = invertPixelHsl(px);
         }
     }
 }
@@ -30,9 +30,22 @@ namespace DarkModeUtils {
  * @param image         Must be Format_ARGB32 or similar; converted if needed.
  * @param imageRegions  Bounding rectangles of raster images (pixel coords).
  *                      Pass an empty vector to apply inversion everywhere.
+ *
+ * Gray pixels take an exact XOR shortcut (SSE2/NEON, four at a time) and
+ * coloured ones a memoized integer HSL round trip; large images are split
+ * into row bands on the global thread pool. The output is bit-identical to
+ * invertImageLightnessReference().
  */
 void invertImageLightness(QImage& image, const QVector<QRect>& imageRegions = {});
 
+/**
+ * @brief Straightforward per-pixel HSL version of invertImageLightness().
+ *
+ * Single-threaded, no shortcuts. Kept as the golden reference for tests and
+ * benchmarks (see DarkModeUtilsTests).
+ */
+void invertImageLightnessReference(QImage& image, const QVector<QRect>& imageRegions = {});
+
 /**
  * @brief Invert the lightness of a single colour.
  *
@@ -0,0 +1,275 @@
+#pragma once
+
+// ============================================================================
+// DarkModeUtilsTests - Golden tests for the dark-mode lightness inversion
+// ============================================================================
+// invertImageLightness() takes shortcuts (gray XOR, SIMD, colour cache, row
+// bands on the thread pool) that must not change a single bit of output.
+// These tests compare it against invertImageLightnessReference() on every
+// 24-bit colour, on image-region masks with awkward edges, and on a synthetic
+// page, and report the speed-up.
+//
+// Run with: speedynote --test-dark-mode
+// Benchmark only: speedynote --bench-dark-mode
+// ============================================================================
+
+#include "DarkModeUtils.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QRandomGenerator>
+
+namespace DarkModeUtilsTests {
+
+/// Run both implementations on copies of @p source; true if identical.
+inline bool matchesReference(const QImage& source, const QVector<QRect>& regions,
+                             const char* label)
+{
+    QImage expected = source.copy();
+    QImage actual = source.copy();
+    DarkModeUtils::invertImageLightnessReference(expected, regions);
+    DarkModeUtils::invertImageLightness(actual, regions);
+    if (actual.format() != expected.format() || actual.size() != expected.size()) {
+        qDebug() << "FAIL:" << label << "format/size differ";
+        return false;
+    }
+    for (int y = 0; y < expected.height(); ++y) {
+        const auto* e = reinterpret_cast<const QRgb*>(expected.constScanLine(y));
+        const auto* a = reinterpret_cast<const QRgb*>(actual.constScanLine(y));
+        for (int x = 0; x < expected.width(); ++x) {
+            if (e[x] != a[x]) {
+                qDebug().noquote() << QString("FAIL: %1 differs at (%2, %3): %4 vs reference %5")
+                                          .arg(label).arg(x).arg(y)
+                                          .arg(a[x], 8, 16, QChar('0'))
+                                          .arg(e[x], 8, 16, QChar('0'));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Every 24-bit colour, at several alphas (including 0), matches.
+ *
+ * One 4096x4096 image holds all 16.7M colours, so this also runs the banded
+ * multi-threaded path.
+ */
+inline bool testAllColors()
+{
+    qDebug() << "=== Test: dark-mode inversion, all colours ===";
+
+    QImage image(4096, 4096, QImage::Format_ARGB32);
+    static const quint32 alphas[] = {255, 255, 255, 128, 1, 0, 255};
+    for (int y = 0; y < image.height(); ++y) {
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            const quint32 rgb = quint32(y) * 4096u + quint32(x);
+            line[x] = (alphas[(x + y) % 7] << 24) | rgb;
+        }
+    }
+
+    if (!matchesReference(image, {}, "all colours"))
+        return false;
+    qDebug() << "PASS: dark-mode inversion, all colours";
+    return true;
+}
+
+/**
+ * @brief Image-region masks: overlaps, edges, off-image and inverted rects.
+ */
+inline bool testRegions()
+{
+    qDebug() << "=== Test: dark-mode inversion, image regions ===";
+
+    QRandomGenerator rng(2024);
+    auto randomImage = [&rng](int w, int h, QImage::Format format) {
+        QImage image(w, h, QImage::Format_ARGB32);
+        for (int y = 0; y < h; ++y) {
+            auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x = 0; x < w; ++x) {
+                const quint32 alpha = rng.bounded(4) ? 0xFFu : rng.bounded(256u);
+                const quint32 rgb = rng.bounded(2) ? rng.bounded(0x1000000u)
+                                                   : rng.bounded(256u) * 0x010101u;
+                line[x] = (alpha << 24) | rgb;
+            }
+        }
+        return format == QImage::Format_ARGB32 ? image : image.convertToFormat(format);
+    };
+
+    struct Case {
+        const char* label;
+        QVector<QRect> regions;
+    };
+    const QVector<Case> cases = {
+        {"no regions", {}},
+        {"single region", {QRect(10, 5, 30, 20)}},
+        {"overlapping regions", {QRect(10, 5, 30, 20), QRect(25, 10, 40, 4), QRect(12, 6, 3, 3)}},
+        {"adjacent regions", {QRect(0, 0, 10, 50), QRect(10, 0, 10, 50)}},
+        {"whole image", {QRect(0, 0, 97, 61)}},
+        {"beyond the edges", {QRect(-20, -10, 30, 30), QRect(80, 50, 100, 100)}},
+        {"off the image", {QRect(200, 10, 20, 20), QRect(-50, -50, 10, 10)}},
+        {"inverted rect", {QRect(QPoint(40, 30), QPoint(20, 10))}},
+    };
+
+    bool success = true;
+    for (const Case& c : cases)
+        success &= matchesReference(randomImage(97, 61, QImage::Format_ARGB32), c.regions, c.label);
+
+    // Random masks on odd sizes (SIMD tails, runs shorter than a vector).
+    for (int i = 0; i < 200 && success; ++i) {
+        const int w = 1 + int(rng.bounded(70));
+        const int h = 1 + int(rng.bounded(40));
+        QVector<QRect> regions;
+        const int count = int(rng.bounded(5));
+        for (int r = 0; r < count; ++r) {
+            regions.append(QRect(int(rng.bounded(w + 40)) - 20, int(rng.bounded(h + 40)) - 20,
+                                 int(rng.bounded(40)) - 4, int(rng.bounded(30)) - 4));
+        }
+        success &= matchesReference(randomImage(w, h, QImage::Format_ARGB32), regions, "random regions");
+    }
+
+    // Other formats are converted to ARGB32 by both.
+    success &= matchesReference(randomImage(64, 48, QImage::Format_RGB32), {QRect(4, 4, 8, 8)}, "RGB32 input");
+    success &= matchesReference(randomImage(64, 48, QImage::Format_ARGB32_Premultiplied), {}, "premultiplied input");
+
+    if (success)
+        qDebug() << "PASS: dark-mode inversion, image regions";
+    return success;
+}
+
+/**
+ * @brief A few hand-checked values: paper, ink, gray, a saturated colour.
+ */
+inline bool testKnownValues()
+{
+    qDebug() << "=== Test: dark-mode inversion, known values ===";
+
+    QImage image(5, 1, QImage::Format_ARGB32);
+    auto* line = reinterpret_cast<QRgb*>(image.scanLine(0));
+    line[0] = qRgba(255, 255, 255, 255);
+    line[1] = qRgba(0, 0, 0, 255);
+    line[2] = qRgba(100, 100, 100, 200);
+    line[3] = qRgba(255, 0, 0, 255);   // L = 128: stays (almost) the same
+    line[4] = qRgba(10, 20, 30, 0);    // transparent: untouched
+
+    DarkModeUtils::invertImageLightness(image);
+    line = reinterpret_cast<QRgb*>(image.scanLine(0));
+
+    const QRgb expected[] = {
+        qRgba(0, 0, 0, 255),
+        qRgba(255, 255, 255, 255),
+        qRgba(155, 155, 155, 200),
+        qRgba(254, 0, 0, 255),
+        qRgba(10, 20, 30, 0),
+    };
+    bool success = true;
+    for (int x = 0; x < 5; ++x) {
+        if (line[x] != expected[x]) {
+            qDebug().noquote() << QString("FAIL: pixel %1 is %2, expected %3").arg(x)
+                                      .arg(line[x], 8, 16, QChar('0'))
+                                      .arg(expected[x], 8, 16, QChar('0'));
+            success = false;
+        }
+    }
+    if (success)
+        qDebug() << "PASS: dark-mode inversion, known values";
+    return success;
+}
+
+/**
+ * @brief Reference vs. fast inversion on a synthetic 300 DPI A4 page.
+ *
+ * White paper, anti-aliased gray text, a coloured diagram and a photo-like
+ * region excluded by an image rect. Fails only if the outputs differ.
+ */
+inline bool benchmarkInversion()
+{
+    qDebug() << "=== Benchmark: dark-mode inversion ===";
+
+    QImage page(2480, 3508, QImage::Format_ARGB32);
+    page.fill(Qt::white);
+    {
+        QPainter painter(&page);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        QFont font = painter.font();
+        font.setPixelSize(42);
+        painter.setFont(font);
+        painter.setPen(QColor(30, 30, 30));
+        for (int y = 200; y < 3300; y += 60) {
+            painter.drawText(200, y, QStringLiteral("The quick brown fox jumps over the lazy dog, "
+                                                   "0123456789 — dark mode inversion benchmark."));
+        }
+        painter.setPen(QPen(QColor(40, 90, 200), 6));
+        painter.setBrush(QColor(250, 220, 120));
+        for (int i = 0; i < 12; ++i)
+            painter.drawEllipse(QPoint(600 + i * 110, 1800), 90, 140);
+        QLinearGradient gradient(1300, 2400, 2200, 3100);
+        gradient.setColorAt(0, QColor(200, 40, 40));
+        gradient.setColorAt(1, QColor(40, 160, 90));
+        painter.fillRect(QRect(1300, 2400, 900, 700), gradient);
+    }
+    const QVector<QRect> regions = {QRect(1300, 2400, 900, 700)};
+
+    const int reps = 5;
+    QImage result;
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < reps; ++i) {
+        result = page.copy();
+        DarkModeUtils::invertImageLightnessReference(result, regions);
+    }
+    const qreal referenceMs = timer.nsecsElapsed() / 1e6 / reps;
+    const QImage expected = result;
+
+    timer.restart();
+    for (int i = 0; i < reps; ++i) {
+        result = page.copy();
+        DarkModeUtils::invertImageLightness(result, regions);
+    }
+    const qreal fastMs = timer.nsecsElapsed() / 1e6 / reps;
+
+    qDebug().noquote() << QString("%1x%2 page: reference %3 ms | fast %4 ms (%5x)")
+                              .arg(page.width()).arg(page.height())
+                              .arg(referenceMs, 0, 'f', 1).arg(fastMs, 0, 'f', 1)
+                              .arg(referenceMs / qMax<qreal>(0.001, fastMs), 0, 'f', 1);
+
+    const bool identical = (result == expected);
+    qDebug() << (identical ? "PASS:" : "FAIL:") << "benchmark output matches the reference";
+    return identical;
+}
+
+/**
+ * @brief Run all DarkModeUtils tests.
+ * @return true if all tests pass, false otherwise.
+ */
+inline bool runAllTests()
+{
+    qDebug() << "";
+    qDebug() << "========================================";
+    qDebug() << "   DarkModeUtils Tests";
+    qDebug() << "========================================";
+
+    bool allPassed = true;
+
+    allPassed &= testKnownValues();
+    allPassed &= testRegions();
+    allPassed &= testAllColors();
+    allPassed &= benchmarkInversion();
+
+    qDebug() << "";
+    if (allPassed) {
+        qDebug() << "✅ All DarkModeUtils tests passed!";
+    } else {
+        qDebug() << "❌ Some DarkModeUtils tests failed!";
+    }
+    qDebug() << "========================================";
+    qDebug() << "";
+
+    return allPassed;
+}
+
+} // namespace DarkModeUtilsTests
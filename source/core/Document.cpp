@@ -9,11 +9,17 @@
 #include "../objects/LinkObject.h"
 #include "../pdf/PdfMaterializer.h"
 #include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QRandomGenerator>
 #include <QSettings>
+#include <QThreadPool>
+#include <QtConcurrent>
 #include <cmath>
 #include <algorithm>  // Phase 5.4: for std::sort, std::greater in merge
 #include <functional>
 #include <limits>
+#include <utility>
 
 #ifdef __GLIBC__
 #include <malloc.h>
@@ -37,9 +43,10 @@ Document::Document()
 
 Document::~Document()
 {
+    finishPendingSave();
 #ifdef SPEEDYNOTE_DEBUG
     qDebug() << "Document DESTROYED:" << this << "id=" << id.left(8) 
-             << "pages=" << m_pageOrder.size() << "tiles=" << m_tiles.size();
+             << "pages=" << pageCount() << "tiles=" << m_tiles.size();
 #endif
     // Note: m_loadedPages, m_tiles, and m_pdfProviders own unique_ptrs, auto-cleaned
     
@@ -301,6 +308,8 @@ void Document::dismissSourceRelink(const QString& sourceId)
 
 QStringList Document::unreferencedSourceIds() const
 {
+    ensurePageTables();
+
     // Collect ids referenced by any page (empty = primary).
     QSet<QString> referenced;
     bool primaryReferenced = false;
@@ -597,6 +606,8 @@ void Document::unloadPdf()
 
 void Document::clearPdfReference()
 {
+    ensurePageTables();
+
     m_pdfProviders.clear();
     m_pdfSources.clear();
     m_pagePdfSource.clear();
@@ -622,6 +633,20 @@ QImage Document::renderPdfPageToImage(const QString& sourceId, int pageIndex, qr
     return provider->renderPageToImage(providerPage, dpi);
 }
 
+QImage Document::renderPdfPageRegionToImage(const QString& sourceId, int pageIndex, qreal dpi,
+                                            const QRect& region) const
+{
+    PdfProvider* provider = providerForSource(sourceId);
+    if (!provider || !provider->isValid()) {
+        return QImage();
+    }
+    const int providerPage = resolveSourcePageIndex(sourceId, pageIndex);
+    if (providerPage < 0) {
+        return QImage();
+    }
+    return provider->renderPageRegionToImage(providerPage, dpi, region);
+}
+
 QPixmap Document::renderPdfPageToPixmap(int pageIndex, qreal dpi) const
 {
     PdfProvider* provider = providerForSource(QString());
@@ -693,6 +718,8 @@ QSizeF Document::pdfPageSize(const QString& sourceId, int pageIndex) const
 
 int Document::notebookPageIndexForPdfPage(int pdfPageIndex) const
 {
+    ensurePageTables();
+
     // Use m_pagePdfIndex which maps UUID → PDF page index
     // We need to find the UUID with matching PDF page, then use pageIndexByUuid() for O(1) lookup
     // NOTE: This maps against the PRIMARY source only. Pages backed by a non-primary
@@ -715,26 +742,17 @@ int Document::notebookPageIndexForPdfPage(int pdfPageIndex) const
 int Document::pdfPageIndexForNotebookPage(int notebookPageIndex) const
 {
     // Bounds check
-    if (notebookPageIndex < 0 || notebookPageIndex >= m_pageOrder.size()) {
+    if (notebookPageIndex < 0 || notebookPageIndex >= pageCount()) {
         return -1;
     }
-    
-    // Get the UUID at this notebook page index
-    QString uuid = m_pageOrder[notebookPageIndex];
 
     // Only primary-source pages participate in primary outline/link mapping.
-    auto srcIt = m_pagePdfSource.find(uuid);
-    if (srcIt != m_pagePdfSource.end() && !srcIt->second.isEmpty()) {
+    if (!manifestPdfSource(notebookPageIndex).isEmpty()) {
         return -1;  // Backed by a non-primary source
     }
     
-    // Look up the PDF page index for this UUID
-    auto it = m_pagePdfIndex.find(uuid);
-    if (it != m_pagePdfIndex.end()) {
-        return it->second;
-    }
-    
-    return -1;  // Not a PDF page (blank or custom background)
+    // -1 if not a PDF page (blank or custom background)
+    return manifestPdfPage(notebookPageIndex);
 }
 
 bool Document::pdfBindingForNotebookPage(int notebookPageIndex, QString& outSourceId, int& outPdfPage) const
@@ -751,11 +769,36 @@ bool Document::pdfBindingForNotebookPage(int notebookPageIndex, QString& outSour
     return true;
 }
 
+bool Document::peekPdfBinding(int notebookPageIndex, QString& outSourceId, int& outPdfPage) const
+{
+    if (notebookPageIndex < 0 || notebookPageIndex >= pageCount()) {
+        return false;
+    }
+    auto it = m_loadedPages.find(Id128::fromString(pageUuidAt(notebookPageIndex)));
+    if (it != m_loadedPages.end()) {
+        const Page* p = it->second.get();
+        if (p->pdfPageNumber < 0) {
+            return false;
+        }
+        outSourceId = p->pdfSourceId;
+        outPdfPage = p->pdfPageNumber;
+        return true;
+    }
+    const int pdfPage = manifestPdfPage(notebookPageIndex);
+    if (pdfPage < 0) {
+        return false;
+    }
+    outSourceId = manifestPdfSource(notebookPageIndex);
+    outPdfPage = pdfPage;
+    return true;
+}
+
 int Document::notebookPageIndexForSourcePage(const QString& sourceId, int originalPage) const
 {
     if (originalPage < 0) {
         return -1;
     }
+    ensurePageTables();
     // Resolve via the manifest maps (kept in sync on insert/import/remove and keyed
     // by page uuid) plus the O(1) uuid->index cache, rather than page(i) which would
     // force-load every page (and its images) from disk just to navigate one link.
@@ -843,6 +886,8 @@ QVector<PdfOutlineItem> Document::pdfOutline() const
 
 QStringList Document::sourceDisplayOrder() const
 {
+    ensurePageTables();
+
     QStringList order;
     QSet<QString> seen;
 
@@ -1046,14 +1091,14 @@ QVector<PdfOutlineItem> Document::aggregatedOutline() const
 Page* Document::page(int index)
 {
     // Bounds check
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return nullptr;
     }
     
-    QString uuid = m_pageOrder[index];
+    const Id128 key = Id128::fromString(pageUuidAt(index));
     
     // Check if already loaded
-    auto it = m_loadedPages.find(uuid);
+    auto it = m_loadedPages.find(key);
     if (it != m_loadedPages.end()) {
         return it->second.get();
     }
@@ -1065,21 +1110,21 @@ Page* Document::page(int index)
     
     // Use find() instead of [] to avoid inserting nullptr if something went wrong
     // (defensive programming - loadPageFromDisk should have inserted it)
-    it = m_loadedPages.find(uuid);
+    it = m_loadedPages.find(key);
     return it != m_loadedPages.end() ? it->second.get() : nullptr;
 }
 
 const Page* Document::page(int index) const
 {
     // Bounds check
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return nullptr;
     }
     
-    QString uuid = m_pageOrder[index];
+    const Id128 key = Id128::fromString(pageUuidAt(index));
     
     // Check if already loaded
-    auto it = m_loadedPages.find(uuid);
+    auto it = m_loadedPages.find(key);
     if (it != m_loadedPages.end()) {
         return it->second.get();
     }
@@ -1091,7 +1136,7 @@ const Page* Document::page(int index) const
     
     // Use find() instead of at() to avoid potential std::out_of_range exception
     // (defensive programming - loadPageFromDisk should have inserted it)
-    it = m_loadedPages.find(uuid);
+    it = m_loadedPages.find(key);
     return it != m_loadedPages.end() ? it->second.get() : nullptr;
 }
 
@@ -1100,11 +1145,11 @@ const Page* Document::page(int index) const
 bool Document::isPageLoaded(int index) const
 {
     // Bounds check
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return false;
     }
-    QString uuid = m_pageOrder[index];
-    return m_loadedPages.find(uuid) != m_loadedPages.end();
+    QString uuid = pageUuidAt(index);
+    return m_loadedPages.find(Id128::fromString(uuid)) != m_loadedPages.end();
 }
 
 QVector<int> Document::loadedPageIndices() const
@@ -1114,8 +1159,8 @@ QVector<int> Document::loadedPageIndices() const
     
     // Iterate through loaded pages and use cached UUID→index lookup
     // This is O(loaded) after cache is built (vs O(loaded * pageCount) before)
-    for (const auto& [uuid, page] : m_loadedPages) {
-        int idx = pageIndexByUuid(uuid);  // O(1) cached lookup
+    for (const auto& [key, page] : m_loadedPages) {
+        int idx = pageIndexByKey(key);  // O(1) cached lookup
         if (idx >= 0) {
             result.append(idx);
         }
@@ -1125,6 +1170,9 @@ QVector<int> Document::loadedPageIndices() const
 
 QString Document::pageUuidAt(int index) const
 {
+    if (m_pageIndex.isOpen()) {
+        return m_pageIndex.uuidAt(index);
+    }
     if (index < 0 || index >= m_pageOrder.size()) {
         return QString();
     }
@@ -1134,15 +1182,14 @@ QString Document::pageUuidAt(int index) const
 QSizeF Document::pageSizeAt(int index) const
 {
     // Bounds check
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return QSizeF();
     }
     
     // Use cached metadata (avoids loading the full page)
-    QString uuid = m_pageOrder[index];
-    auto it = m_pageMetadata.find(uuid);
-    if (it != m_pageMetadata.end()) {
-        return it->second;
+    QSizeF size;
+    if (manifestPageSize(index, size)) {
+        return size;
     }
     
     // Fallback: load the page and get its size
@@ -1152,64 +1199,66 @@ QSizeF Document::pageSizeAt(int index) const
 
 void Document::setPageSize(int index, const QSizeF& size)
 {
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return;
     }
     
     // Update the layout metadata so pageSizeAt() returns the new size
-    QString uuid = m_pageOrder[index];
+    // (with a mapped page index this is an override on top of it)
+    QString uuid = pageUuidAt(index);
     m_pageMetadata[uuid] = size;
     
     // Update the actual page object if it is loaded in memory
     Page* p = page(index);
     if (p) {
         p->size = size;
-        m_dirtyPages.insert(uuid);
+        m_dirtyPages.insert(Id128::fromString(uuid));
     }
+    invalidateThumbnail(Id128::fromString(uuid));
     
     markModified();
 }
 
 bool Document::loadPageFromDisk(int index) const
 {
+    waitForPendingSaveWrites();
+
     if (m_bundlePath.isEmpty()) {
         return false;
     }
     
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return false;
     }
     
-    QString uuid = m_pageOrder[index];
-    QString pagePath = m_bundlePath + "/pages/" + uuid + ".json";
+    QString uuid = pageUuidAt(index);
+    QString pageStem = m_bundlePath + "/pages/" + uuid;
     
-    QFile file(pagePath);
-    if (!file.open(QIODevice::ReadOnly)) {
+    if (!PageCodec::fileExists(pageStem)) {
         // File doesn't exist - check if we can synthesize a pristine PDF page
-        auto pdfIt = m_pagePdfIndex.find(uuid);
-        if (pdfIt != m_pagePdfIndex.end()) {
+        const int pdfPage = manifestPdfPage(index);
+        if (pdfPage >= 0) {
             // Synthesize pristine PDF page from manifest metadata
             auto page = std::make_unique<Page>();
             page->uuid = uuid;
             page->pageIndex = index;
             page->backgroundType = Page::BackgroundType::PDF;
-            page->pdfPageNumber = pdfIt->second;
+            page->pdfPageNumber = pdfPage;
             // Resolve the page's PDF source (empty = primary).
-            auto srcIt = m_pagePdfSource.find(uuid);
-            const QString pageSourceId = (srcIt != m_pagePdfSource.end()) ? srcIt->second : QString();
+            const QString pageSourceId = manifestPdfSource(index);
             page->pdfSourceId = pageSourceId;
             
             // Get size from metadata
-            auto sizeIt = m_pageMetadata.find(uuid);
-            if (sizeIt != m_pageMetadata.end()) {
-                page->size = sizeIt->second;
+            QSizeF metaSize;
+            if (manifestPageSize(index, metaSize)) {
+                page->size = metaSize;
             } else {
                 // Fallback to PDF page size if available (from the page's own source).
                 // Bounds-check against the provider using the resolved (mini-PDF) index,
                 // since bundled sources remap the original page number.
-                const int providerPage = resolveSourcePageIndex(pageSourceId, pdfIt->second);
+                const int providerPage = resolveSourcePageIndex(pageSourceId, pdfPage);
                 if (providerPage >= 0 && providerPage < pdfPageCount(pageSourceId)) {
-                    QSizeF pdfSize = pdfPageSize(pageSourceId, pdfIt->second);
+                    QSizeF pdfSize = pdfPageSize(pageSourceId, pdfPage);
                     qreal scale = 96.0 / 72.0;  // PDF points to 96 dpi
                     page->size = QSizeF(pdfSize.width() * scale, pdfSize.height() * scale);
                 }
@@ -1221,7 +1270,7 @@ bool Document::loadPageFromDisk(int index) const
             page->gridSpacing = defaultGridSpacing;
             page->lineSpacing = defaultLineSpacing;
             
-            m_loadedPages[uuid] = std::move(page);
+            m_loadedPages[Id128::fromString(uuid)] = std::move(page);
             
 #ifdef SPEEDYNOTE_DEBUG
             qDebug() << "Synthesized pristine PDF page" << index << "(" << uuid.left(8) << ")";
@@ -1230,23 +1279,22 @@ bool Document::loadPageFromDisk(int index) const
         }
         
         // Not a PDF page and file doesn't exist - actual error
-        qWarning() << "Cannot load page: file not found" << pagePath;
+        qWarning() << "Cannot load page: file not found" << pageStem;
         return false;
     }
     
-    QByteArray data = file.readAll();
-    file.close();
-    
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &parseError);
-    if (parseError.error != QJsonParseError::NoError) {
-        qWarning() << "Cannot load page: JSON parse error" << parseError.errorString();
+    // Binary container (bundle format 4+) or legacy JSON page file
+    PageCodec::Container container;
+    QString readError;
+    if (!m_journal.read(pageStem, container, true, &readError)) {
+        qWarning() << "Cannot load page:" << readError;
         return false;
     }
+    m_journal.setBaseline(pageStem, container);
     
-    auto page = Page::fromJson(jsonDoc.object());
+    auto page = Page::fromContainer(std::move(container));
     if (!page) {
-        qWarning() << "Cannot load page: Page::fromJson failed";
+        qWarning() << "Cannot load page: Page::fromContainer failed";
         return false;
     }
     
@@ -1269,7 +1317,7 @@ bool Document::loadPageFromDisk(int index) const
     }
     
     Page* rawPagePtr = page.get();
-    m_loadedPages[uuid] = std::move(page);
+    m_loadedPages[Id128::fromString(uuid)] = std::move(page);
     
     // Load OCR sidecar data and materialize text objects
     loadPageOcr(rawPagePtr, uuid);
@@ -1287,16 +1335,19 @@ bool Document::loadPageFromDisk(int index) const
 
 bool Document::savePage(int index)
 {
+    finishPendingSave();
+
     if (m_bundlePath.isEmpty()) {
         return false;
     }
     
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return false;
     }
     
-    QString uuid = m_pageOrder[index];
-    auto it = m_loadedPages.find(uuid);
+    QString uuid = pageUuidAt(index);
+    const Id128 key = Id128::fromString(uuid);
+    auto it = m_loadedPages.find(key);
     if (it == m_loadedPages.end()) {
         return false;  // Not loaded, nothing to save
     }
@@ -1304,22 +1355,19 @@ bool Document::savePage(int index)
     // Ensure pages directory exists
     QDir().mkpath(m_bundlePath + "/pages");
     
-    QString pagePath = m_bundlePath + "/pages/" + uuid + ".json";
-    QFile file(pagePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Cannot save page:" << pagePath;
+    QString pageStem = m_bundlePath + "/pages/" + uuid;
+    const Page* pagePtr = it->second.get();
+    if (m_journal.save(pageStem, pagePtr->toJson(false), pagePtr->layerStrokeLists())
+            == PageJournal::SaveResult::Failed) {
+        qWarning() << "Cannot save page:" << pageStem;
         return false;
     }
     
-    QJsonDocument jsonDoc(it->second->toJson());
-    file.write(jsonDoc.toJson(QJsonDocument::Compact));
-    file.close();
-    
     // Save OCR sidecar file
     savePageOcr(uuid, it->second.get());
     
     // Clear dirty flag
-    m_dirtyPages.erase(uuid);
+    m_dirtyPages.erase(key);
     
     // Update metadata
     m_pageMetadata[uuid] = it->second->size;
@@ -1336,18 +1384,19 @@ bool Document::savePage(int index)
 
 void Document::evictPage(int index)
 {
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return;
     }
     
-    QString uuid = m_pageOrder[index];
-    auto it = m_loadedPages.find(uuid);
+    QString uuid = pageUuidAt(index);
+    const Id128 key = Id128::fromString(uuid);
+    auto it = m_loadedPages.find(key);
     if (it == m_loadedPages.end()) {
         return;  // Not loaded, nothing to evict
     }
     
     // Save if dirty
-    if (m_dirtyPages.count(uuid) > 0) {
+    if (m_dirtyPages.count(key) > 0) {
         if (!savePage(index)) {
             qWarning() << "Failed to save page before eviction" << index;
             // Continue with eviction anyway to free memory
@@ -1356,6 +1405,7 @@ void Document::evictPage(int index)
     
     // Remove from memory
     m_loadedPages.erase(it);
+    m_journal.dropBaseline(m_bundlePath + "/pages/" + uuid);
     
 #ifdef SPEEDYNOTE_DEBUG
     qDebug() << "Evicted page" << index << "(" << uuid.left(8) << ") from memory";
@@ -1364,21 +1414,24 @@ void Document::evictPage(int index)
 
 void Document::markPageDirty(int index)
 {
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return;
     }
-    QString uuid = m_pageOrder[index];
-    m_dirtyPages.insert(uuid);
+    QString uuid = pageUuidAt(index);
+    const Id128 key = Id128::fromString(uuid);
+    m_dirtyPages.insert(key);
+    invalidateThumbnail(key);
+    m_pageEdits[key] = ++m_pageEditCounter;
     markModified();
 }
 
 bool Document::isPageDirty(int index) const
 {
-    if (index < 0 || index >= m_pageOrder.size()) {
+    if (index < 0 || index >= pageCount()) {
         return false;
     }
-    QString uuid = m_pageOrder[index];
-    return m_dirtyPages.count(uuid) > 0;
+    QString uuid = pageUuidAt(index);
+    return m_dirtyPages.count(Id128::fromString(uuid)) > 0;
 }
 
 // =========================================================================
@@ -1393,7 +1446,7 @@ void Document::rebuildUuidCache() const
     for (int i = 0; i < m_pageOrder.size(); i++) {
         const QString& uuid = m_pageOrder[i];
         if (!uuid.isEmpty()) {
-            m_uuidToIndexCache[uuid] = i;
+            m_uuidToIndexCache[Id128::fromString(uuid)] = i;
         }
     }
     
@@ -1410,11 +1463,30 @@ int Document::pageIndexByUuid(const QString& uuid) const
         return -1;
     }
     
+    // Binary search in the mapped index until the page tables are built
+    if (m_pageIndex.isOpen()) {
+        return m_pageIndex.indexOf(uuid);
+    }
+    
     if (m_uuidCacheDirty) {
         rebuildUuidCache();  // O(n) but only once per page change
     }
     
-    return m_uuidToIndexCache.value(uuid, -1);  // O(1)
+    return m_uuidToIndexCache.value(Id128::fromString(uuid), -1);  // O(1)
+}
+
+int Document::pageIndexByKey(const Id128& key) const
+{
+    if (key.isNull()) {
+        return -1;
+    }
+    if (m_pageIndex.isOpen()) {
+        return m_pageIndex.indexOf(key.toString());
+    }
+    if (m_uuidCacheDirty) {
+        rebuildUuidCache();
+    }
+    return m_uuidToIndexCache.value(key, -1);
 }
 
 void Document::invalidateUuidCache()
@@ -1422,8 +1494,77 @@ void Document::invalidateUuidCache()
     m_uuidCacheDirty = true;
 }
 
+// =========================================================================
+// Page Index (pages.snpi)
+// =========================================================================
+
+void Document::ensurePageTables() const
+{
+    if (!m_pageIndex.isOpen()) {
+        return;
+    }
+    
+    const int count = m_pageIndex.pageCount();
+    m_pageOrder.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString uuid = m_pageIndex.uuidAt(i);
+        m_pageOrder.append(uuid);
+        
+        // emplace: sizes changed since load (setPageSize/savePage) win.
+        QSizeF size;
+        if (m_pageIndex.sizeAt(i, size)) {
+            m_pageMetadata.emplace(uuid, size);
+        }
+        const int pdfPage = m_pageIndex.pdfPageAt(i);
+        if (pdfPage >= 0) {
+            m_pagePdfIndex[uuid] = pdfPage;
+        }
+        const QString source = m_pageIndex.pdfSourceAt(i);
+        if (!source.isEmpty()) {
+            m_pagePdfSource[uuid] = source;
+        }
+    }
+    
+    m_pageIndex.close();
+    m_uuidCacheDirty = true;
+    
+#ifdef SPEEDYNOTE_DEBUG
+    qDebug() << "Built page tables from page index:" << count << "pages";
+#endif
+}
+
+bool Document::manifestPageSize(int index, QSizeF& size) const
+{
+    auto it = m_pageMetadata.find(pageUuidAt(index));
+    if (it != m_pageMetadata.end()) {
+        size = it->second;
+        return true;
+    }
+    return m_pageIndex.isOpen() && m_pageIndex.sizeAt(index, size);
+}
+
+int Document::manifestPdfPage(int index) const
+{
+    if (m_pageIndex.isOpen()) {
+        return m_pageIndex.pdfPageAt(index);
+    }
+    auto it = m_pagePdfIndex.find(pageUuidAt(index));
+    return it != m_pagePdfIndex.end() ? it->second : -1;
+}
+
+QString Document::manifestPdfSource(int index) const
+{
+    if (m_pageIndex.isOpen()) {
+        return m_pageIndex.pdfSourceAt(index);
+    }
+    auto it = m_pagePdfSource.find(pageUuidAt(index));
+    return it != m_pagePdfSource.end() ? it->second : QString();
+}
+
 Page* Document::addPage()
 {
+    ensurePageTables();
+
     auto newPage = createDefaultPage();
     Page* pagePtr = newPage.get();
     
@@ -1435,10 +1576,11 @@ Page* Document::addPage()
     m_pageMetadata[uuid] = newPage->size;
     
     // Store in loaded pages
-    m_loadedPages[uuid] = std::move(newPage);
+    const Id128 key = Id128::fromString(uuid);
+    m_loadedPages[key] = std::move(newPage);
     
     // Mark as dirty
-    m_dirtyPages.insert(uuid);
+    m_dirtyPages.insert(key);
     invalidateUuidCache();
 
     // Outline cache: new empty page contributes no entries, but keep the
@@ -1453,6 +1595,8 @@ Page* Document::addPage()
 
 Page* Document::insertPage(int index)
 {
+    ensurePageTables();
+
     // Allow inserting at the end (index == size)
     if (index < 0 || index > m_pageOrder.size()) {
         return nullptr;
@@ -1469,10 +1613,11 @@ Page* Document::insertPage(int index)
     m_pageMetadata[uuid] = newPage->size;
     
     // Store in loaded pages
-    m_loadedPages[uuid] = std::move(newPage);
+    const Id128 key = Id128::fromString(uuid);
+    m_loadedPages[key] = std::move(newPage);
     
     // Mark as dirty
-    m_dirtyPages.insert(uuid);
+    m_dirtyPages.insert(key);
     invalidateUuidCache();
 
     // Outline cache: shift all entries >= index up by one, then insert
@@ -1497,6 +1642,8 @@ Page* Document::insertPage(int index)
 
 Page* Document::addPageForPdf(int pdfPageIndex)
 {
+    ensurePageTables();
+
     auto newPage = createDefaultPage();
     
     // Configure for PDF background
@@ -1518,8 +1665,9 @@ Page* Document::addPageForPdf(int pdfPageIndex)
     m_pageOrder.append(uuid);
     m_pageMetadata[uuid] = newPage->size;
     m_pagePdfIndex[uuid] = pdfPageIndex;  // Track PDF page mapping
-    m_loadedPages[uuid] = std::move(newPage);
-    m_dirtyPages.insert(uuid);
+    const Id128 key = Id128::fromString(uuid);
+    m_loadedPages[key] = std::move(newPage);
+    m_dirtyPages.insert(key);
     invalidateUuidCache();
 
     if (m_linkOutlineCacheReady) {
@@ -1532,6 +1680,8 @@ Page* Document::addPageForPdf(int pdfPageIndex)
 
 bool Document::removePage(int index)
 {
+    ensurePageTables();
+
     // Cannot remove if index invalid
     if (index < 0 || index >= m_pageOrder.size()) {
         return false;
@@ -1548,10 +1698,11 @@ bool Document::removePage(int index)
     m_pageOrder.removeAt(index);
     
     // Evict from memory if loaded
-    m_loadedPages.erase(uuid);
+    const Id128 key = Id128::fromString(uuid);
+    m_loadedPages.erase(key);
     
     // Remove from dirty tracking
-    m_dirtyPages.erase(uuid);
+    m_dirtyPages.erase(key);
     
     // Remove metadata
     m_pageMetadata.erase(uuid);
@@ -1575,6 +1726,8 @@ bool Document::removePage(int index)
 
 bool Document::restorePageFromSnapshot(int index, const QJsonObject& pageJson)
 {
+    ensurePageTables();
+
     // Allow reinserting at the end (index == size).
     if (index < 0 || index > static_cast<int>(m_pageOrder.size())) {
         return false;
@@ -1609,8 +1762,11 @@ bool Document::restorePageFromSnapshot(int index, const QJsonObject& pageJson)
     }
 
     // Store the live page and mark it dirty so it re-persists on save.
-    m_loadedPages[uuid] = std::move(page);
-    m_dirtyPages.insert(uuid);
+    const Id128 key = Id128::fromString(uuid);
+    m_loadedPages[key] = std::move(page);
+    m_dirtyPages.insert(key);
+    invalidateThumbnail(key);
+    m_pageEdits[key] = ++m_pageEditCounter;
 
     invalidateUuidCache();
 
@@ -1923,6 +2079,7 @@ PageImportResult Document::importPagesFrom(Document* srcDoc, const QStringList&
     if (!srcDoc || srcPageUuids.isEmpty()) {
         return result;
     }
+    ensurePageTables();
 
     // Clamp the insertion point into [0, pageCount()].
     const int maxIndex = static_cast<int>(m_pageOrder.size());
@@ -2002,6 +2159,8 @@ PageImportResult Document::importPagesFrom(Document* srcDoc, const QStringList&
 
 bool Document::movePage(int from, int to)
 {
+    ensurePageTables();
+
     int count = static_cast<int>(m_pageOrder.size());
     
     // Validate indices
@@ -2076,9 +2235,10 @@ const Page* Document::edgelessPage() const
 void Document::ensureMinimumPages()
 {
     // Check if we already have pages
-    if (!m_pageOrder.isEmpty()) {
+    if (pageCount() > 0) {
         return;
     }
+    ensurePageTables();
     
     auto newPage = createDefaultPage();
     
@@ -2093,13 +2253,16 @@ void Document::ensureMinimumPages()
     QString uuid = newPage->uuid;
     m_pageOrder.append(uuid);
     m_pageMetadata[uuid] = newPage->size;
-    m_loadedPages[uuid] = std::move(newPage);
-    m_dirtyPages.insert(uuid);
+    const Id128 key = Id128::fromString(uuid);
+    m_loadedPages[key] = std::move(newPage);
+    m_dirtyPages.insert(key);
     invalidateUuidCache();
 }
 
 void Document::createPagesForPdf()
 {
+    ensurePageTables();
+
     // Clear existing pages (lazy loading structures)
     m_pageOrder.clear();
     m_pageMetadata.clear();
@@ -2534,6 +2697,8 @@ int Document::bookmarkCount() const
 
 QJsonObject Document::toJson() const
 {
+    ensurePageTables();
+
     QJsonObject obj;
     
     // Bundle format version (integer, for forward compatibility checks)
@@ -2794,6 +2959,8 @@ std::unique_ptr<Document> Document::fromFullJson(const QJsonObject& obj)
 
 int Document::loadPagesFromJson(const QJsonArray& pagesArray)
 {
+    ensurePageTables();
+
     // Clear existing pages (lazy loading structures)
     m_pageOrder.clear();
     m_pageMetadata.clear();
@@ -2843,8 +3010,9 @@ int Document::loadPagesFromJson(const QJsonArray& pagesArray)
                     m_pagePdfSource[uuid] = page->pdfSourceId;
                 }
             }
-            m_loadedPages[uuid] = std::move(page);
-            m_dirtyPages.insert(uuid);  // Mark as dirty since loaded from JSON
+            const Id128 key = Id128::fromString(uuid);
+            m_loadedPages[key] = std::move(page);
+            m_dirtyPages.insert(key);  // Mark as dirty since loaded from JSON
             
             ++loadedCount;
         }
@@ -2858,11 +3026,13 @@ int Document::loadPagesFromJson(const QJsonArray& pagesArray)
 
 QJsonArray Document::pagesToJson() const
 {
+    ensurePageTables();
+
     QJsonArray pagesArray;
     
     // Iterate pages in order
     for (const QString& uuid : m_pageOrder) {
-        auto it = m_loadedPages.find(uuid);
+        auto it = m_loadedPages.find(Id128::fromString(uuid));
         if (it != m_loadedPages.end()) {
             pagesArray.append(it->second->toJson());
         }
@@ -2976,55 +3146,25 @@ void Document::markTileDirty(TileCoord coord)
     markModified();
 }
 
-bool Document::saveTile(TileCoord coord)
+QJsonObject Document::tileJson(TileCoord coord, const Page* tile,
+                               QVector<const QVector<VectorStroke>*>& layerStrokes) const
 {
-    if (m_bundlePath.isEmpty()) {
-        qWarning() << "Cannot save tile: bundle path not set";
-        return false;
-    }
-    
-    auto it = m_tiles.find(coord);
-    if (it == m_tiles.end()) {
-        qWarning() << "Cannot save tile: not loaded in memory" << coord.first << coord.second;
-        return false;
-    }
-    
-    // Ensure tiles directory exists
-    QString tilesDir = m_bundlePath + "/tiles";
-    QDir().mkpath(tilesDir);
-    
-    // Build tile file path
-    QString tilePath = tilesDir + "/" + 
-                       QString("%1,%2.json").arg(coord.first).arg(coord.second);
-    
-    QFile file(tilePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Cannot save tile: failed to open file" << tilePath;
-        return false;
-    }
-    
     // Phase 5.6.3: For edgeless mode, use compact format:
-    // - layers: array of {id, strokes} (layer properties stored in manifest)
+    // - layers: array of {id} (layer properties stored in manifest); the
+    //   strokes of each listed layer live in the container's stroke columns
     // - objects: array of InsertedObjects (Phase O2)
     // - coord_x, coord_y: tile coordinates for debugging
     QJsonObject tileObj;
-    Page* tile = it->second.get();
     
     if (isEdgeless()) {
         QJsonArray layersArray;
         for (int i = 0; i < tile->layerCount(); ++i) {
-            VectorLayer* layer = tile->layer(i);
+            const VectorLayer* layer = tile->layer(i);
             if (layer && !layer->isEmpty()) {
                 QJsonObject layerObj;
                 layerObj["id"] = layer->id;
-                
-                QJsonArray strokesArray;
-                for (const auto& stroke : layer->strokes()) {
-                    strokesArray.append(stroke.toJson());
-                }
-                layerObj["strokes"] = strokesArray;
-                
                 layersArray.append(layerObj);
+                layerStrokes.append(&layer->strokes());
             }
         }
         tileObj["layers"] = layersArray;
@@ -3035,7 +3175,7 @@ bool Document::saveTile(TileCoord coord)
             QJsonArray objectsArray;
             for (const auto& obj : tile->objects) {
                 if (obj->type() == QStringLiteral("ocr_text")) {
-                    auto* ocr = static_cast<OcrTextObject*>(obj.get());
+                    const auto* ocr = static_cast<const OcrTextObject*>(obj.get());
                     if (!ocr->ocrLocked)
                         continue;
                 }
@@ -3049,12 +3189,44 @@ bool Document::saveTile(TileCoord coord)
         tileObj["coord_y"] = coord.second;
     } else {
         // Paged mode: use full Page serialization (legacy behavior)
-        tileObj = tile->toJson();
+        tileObj = tile->toJson(false);
+        layerStrokes = tile->layerStrokeLists();
     }
     
-    QJsonDocument jsonDoc(tileObj);
-    file.write(jsonDoc.toJson(QJsonDocument::Compact));
-    file.close();
+    return tileObj;
+}
+
+bool Document::saveTile(TileCoord coord)
+{
+    // A background save may still be writing this tile.
+    finishPendingSave();
+    
+    if (m_bundlePath.isEmpty()) {
+        qWarning() << "Cannot save tile: bundle path not set";
+        return false;
+    }
+    
+    auto it = m_tiles.find(coord);
+    if (it == m_tiles.end()) {
+        qWarning() << "Cannot save tile: not loaded in memory" << coord.first << coord.second;
+        return false;
+    }
+    
+    // Ensure tiles directory exists
+    QString tilesDir = m_bundlePath + "/tiles";
+    QDir().mkpath(tilesDir);
+    
+    // Build tile file path (suffix chosen by PageCodec)
+    QString tileStem = tilesDir + "/" + 
+                       QString("%1,%2").arg(coord.first).arg(coord.second);
+    
+    QVector<const QVector<VectorStroke>*> layerStrokes;
+    const QJsonObject tileObj = tileJson(coord, it->second.get(), layerStrokes);
+    
+    if (m_journal.save(tileStem, tileObj, layerStrokes) == PageJournal::SaveResult::Failed) {
+        qWarning() << "Cannot save tile: failed to write file" << tileStem;
+        return false;
+    }
     
     // Save OCR sidecar file
     saveTileOcr(coord);
@@ -3067,164 +3239,226 @@ bool Document::saveTile(TileCoord coord)
     refreshLinkOutlineFor(coord);
 
 #ifdef SPEEDYNOTE_DEBUG
-    qDebug() << "Saved tile" << coord.first << "," << coord.second << "to" << tilePath;
+    qDebug() << "Saved tile" << coord.first << "," << coord.second << "to" << tileStem;
 #endif
     
     return true;
 }
 
+namespace {
+
+/// Path of a tile's container without suffix.
+QString tileStemIn(const QString& bundlePath, Document::TileCoord coord)
+{
+    return bundlePath + "/tiles/" + QString("%1,%2").arg(coord.first).arg(coord.second);
+}
+
+/// Document state a tile is reconstructed from, copied so tiles can be
+/// built off the GUI thread (see Document::tileDecoder()).
+struct TileTemplate {
+    bool edgelessLayers = false;    ///< Edgeless mode with a manifest layer table
+    std::vector<LayerDefinition> layers;
+    int activeLayerIndex = 0;
+    Page::BackgroundType backgroundType = Page::BackgroundType::None;
+    QColor backgroundColor;
+    QColor gridColor;
+    int gridSpacing = 32;
+    int lineSpacing = 32;
+};
+
+TileTemplate tileTemplateOf(const Document& doc)
+{
+    TileTemplate t;
+    t.edgelessLayers = doc.isEdgeless() && !doc.edgelessLayers().empty();
+    t.layers = doc.edgelessLayers();
+    t.activeLayerIndex = doc.edgelessActiveLayerIndex();
+    t.backgroundType = doc.defaultBackgroundType;
+    t.backgroundColor = doc.defaultBackgroundColor;
+    t.gridColor = doc.defaultGridColor;
+    t.gridSpacing = doc.defaultGridSpacing;
+    t.lineSpacing = doc.defaultLineSpacing;
+    return t;
+}
+
+/**
+ * @brief Reconstruct a tile from its container.
+ * @param moveStrokes Take the strokes out of @p container; otherwise they are
+ *        shared with it (it is then kept as the journal baseline).
+ * @return The tile (image assets not loaded), or nullptr if the container is
+ *         malformed.
+ * 
+ * Touches nothing but its arguments, so it may run on any thread.
+ */
+std::unique_ptr<Page> buildTile(const TileTemplate& t, PageCodec::Container& container,
+                                bool moveStrokes, const QString& tileStem)
+{
+    const QJsonObject& obj = container.meta;
+    
+    // Phase 5.6.4: For edgeless mode, reconstruct layers from manifest
+    // Tile files only contain {id, strokes} per layer, not full layer properties.
+    // We check for coord_x/coord_y as markers of the new compact format.
+    bool isNewFormat = obj.contains("coord_x") && obj.contains("coord_y");
+    
+    if (!t.edgelessLayers || !isNewFormat) {
+        // Legacy format or paged mode: use full Page deserialization
+        std::unique_ptr<Page> tile;
+        if (moveStrokes) {
+            tile = Page::fromContainer(std::move(container));
+        } else {
+            PageCodec::Container copy = container;
+            tile = Page::fromContainer(std::move(copy));
+        }
+        if (!tile) {
+            qWarning() << "Cannot load tile: Page::fromContainer failed";
+        }
+        return tile;
+    }
+    
+    // New compact format: reconstruct full VectorLayers from manifest
+    
+    // Build map of layerId → strokes from tile file. Binary containers
+    // carry the strokes in packed columns (one list per header layer);
+    // legacy JSON tiles carry them inline.
+    std::map<QString, QVector<VectorStroke>> strokesByLayerId;
+    QJsonArray tileLayersArray = obj["layers"].toArray();
+    if (container.binary && container.layerStrokes.size() != tileLayersArray.size()) {
+        qWarning() << "Cannot load tile: layer table mismatch in" << tileStem;
+        return nullptr;
+    }
+    for (int i = 0; i < tileLayersArray.size(); ++i) {
+        QJsonObject layerObj = tileLayersArray[i].toObject();
+        QString layerId = layerObj["id"].toString();
+        QVector<VectorStroke> strokes;
+        if (container.binary) {
+            if (moveStrokes) {
+                strokes = std::move(container.layerStrokes[i]);
+            } else {
+                strokes = container.layerStrokes[i];
+            }
+        } else {
+            for (const auto& strokeVal : layerObj["strokes"].toArray()) {
+                strokes.append(VectorStroke::fromJson(strokeVal.toObject()));
+            }
+        }
+        strokesByLayerId[layerId] = std::move(strokes);
+    }
+    
+    // Create tile with default page settings
+    auto tile = std::make_unique<Page>();
+    tile->size = QSizeF(Document::EDGELESS_TILE_SIZE, Document::EDGELESS_TILE_SIZE);
+    tile->backgroundType = t.backgroundType;
+    tile->backgroundColor = t.backgroundColor;
+    tile->gridColor = t.gridColor;
+    tile->gridSpacing = t.gridSpacing;
+    tile->lineSpacing = t.lineSpacing;
+    
+    // Clear default layer and reconstruct from manifest
+    tile->vectorLayers.clear();
+    for (const auto& layerDef : t.layers) {
+        auto layer = std::make_unique<VectorLayer>(layerDef.name);
+        layer->id = layerDef.id;
+        layer->visible = layerDef.visible;
+        layer->opacity = layerDef.opacity;
+        layer->locked = layerDef.locked;
+        
+        // Add strokes if this tile has any for this layer
+        auto it = strokesByLayerId.find(layerDef.id);
+        if (it != strokesByLayerId.end()) {
+            layer->setStrokes(std::move(it->second));
+        }
+        
+        tile->vectorLayers.push_back(std::move(layer));
+    }
+    
+    tile->activeLayerIndex = t.activeLayerIndex;
+    
+    // Phase O1.5: Load objects from tile file
+    if (obj.contains("objects")) {
+        QJsonArray objectsArray = obj["objects"].toArray();
+        for (const auto& val : objectsArray) {
+            auto object = InsertedObject::fromJson(val.toObject());
+            if (object) {
+                tile->objects.push_back(std::move(object));
+            }
+        }
+        // Rebuild affinity map after loading objects
+        tile->rebuildAffinityMap();
+    }
+    
+    return tile;
+}
+
+} // namespace
+
 bool Document::loadTileFromDisk(TileCoord coord) const
 {
+    waitForPendingSaveWrites();
+
     if (m_bundlePath.isEmpty()) {
         return false;
     }
     
-    QString tilePath = m_bundlePath + "/tiles/" + 
-                       QString("%1,%2.json").arg(coord.first).arg(coord.second);
+    // A synchronous load overtakes any tileDecoder() request in flight.
+    m_tileLoadTickets.erase(coord);
     
-    QFile file(tilePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Cannot load tile: file not found" << tilePath;
+    QString tileStem = tileStemIn(m_bundlePath, coord);
+    
+    // Binary container (bundle format 4+) or legacy JSON tile file
+    PageCodec::Container container;
+    QString readError;
+    if (!m_journal.read(tileStem, container, true, &readError)) {
+        qWarning() << "Cannot load tile" << tileStem << ":" << readError;
         // CR-6: Remove from index to prevent repeated failed loads
         m_tileIndex.erase(coord);
         return false;
     }
+    m_journal.setBaseline(tileStem, container);
     
-    QByteArray data = file.readAll();
-    file.close();
-    
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &parseError);
-    if (parseError.error != QJsonParseError::NoError) {
-        qWarning() << "Cannot load tile: JSON parse error" << parseError.errorString();
+    auto tile = buildTile(tileTemplateOf(*this), container, true, tileStem);
+    if (!tile) {
         m_tileIndex.erase(coord);  // CR-6: Remove from index
         return false;
     }
+    loadTileOcrFromBundle(m_bundlePath, tile.get(), coord);
+    insertLoadedTile(coord, std::move(tile));
     
-    QJsonObject obj = jsonDoc.object();
-    
-    // Phase 5.6.4: For edgeless mode, reconstruct layers from manifest
-    // Tile files only contain {id, strokes} per layer, not full layer properties.
-    // We check for coord_x/coord_y as markers of the new compact format.
-    bool isNewFormat = obj.contains("coord_x") && obj.contains("coord_y");
+#ifdef SPEEDYNOTE_DEBUG
+    qDebug() << "Loaded tile" << coord.first << "," << coord.second << "from disk";
+#endif
+    return true;
+}
+
+Page* Document::insertLoadedTile(TileCoord coord, std::unique_ptr<Page> tile) const
+{
+    // Phase O2 (BF.3): Load image objects from assets folder.
+    // InsertedObject::fromJson() only sets imagePath; it does NOT load the pixmap.
+    tile->loadImages(m_bundlePath);
     
-    if (mode == Mode::Edgeless && isNewFormat && !m_edgelessLayers.empty()) {
-        // New compact format: reconstruct full VectorLayers from manifest
-        
-        // Build map of layerId → strokes from tile file
-        std::map<QString, QVector<VectorStroke>> strokesByLayerId;
-        QJsonArray tileLayersArray = obj["layers"].toArray();
-        for (const auto& val : tileLayersArray) {
-            QJsonObject layerObj = val.toObject();
-            QString layerId = layerObj["id"].toString();
-            QVector<VectorStroke> strokes;
-            for (const auto& strokeVal : layerObj["strokes"].toArray()) {
-                strokes.append(VectorStroke::fromJson(strokeVal.toObject()));
-            }
-            strokesByLayerId[layerId] = strokes;
+    // Phase O1.5: Update max object extent from loaded objects
+    for (const auto& object : tile->objects) {
+        int extent = static_cast<int>(qMax(object->size.width(), object->size.height()));
+        if (extent > m_maxObjectExtent) {
+            m_maxObjectExtent = extent;
         }
-        
-        // Create tile with default page settings
-        auto tile = std::make_unique<Page>();
-        tile->size = QSizeF(EDGELESS_TILE_SIZE, EDGELESS_TILE_SIZE);
-        tile->backgroundType = defaultBackgroundType;
-        tile->backgroundColor = defaultBackgroundColor;
-        tile->gridColor = defaultGridColor;
-        tile->gridSpacing = defaultGridSpacing;
-        tile->lineSpacing = defaultLineSpacing;
-        
-        // Clear default layer and reconstruct from manifest
-        tile->vectorLayers.clear();
-        for (const auto& layerDef : m_edgelessLayers) {
-            auto layer = std::make_unique<VectorLayer>(layerDef.name);
-            layer->id = layerDef.id;
-            layer->visible = layerDef.visible;
-            layer->opacity = layerDef.opacity;
-            layer->locked = layerDef.locked;
-            
-            // Add strokes if this tile has any for this layer
-            auto it = strokesByLayerId.find(layerDef.id);
-            if (it != strokesByLayerId.end()) {
-                for (const auto& stroke : it->second) {
-                    layer->addStroke(stroke);
-                }
-            }
-            
-            tile->vectorLayers.push_back(std::move(layer));
-        }
-        
-        tile->activeLayerIndex = m_edgelessActiveLayerIndex;
-        
-        // Phase O1.5: Load objects from tile file
-        if (obj.contains("objects")) {
-            QJsonArray objectsArray = obj["objects"].toArray();
-            for (const auto& val : objectsArray) {
-                auto object = InsertedObject::fromJson(val.toObject());
-                if (object) {
-                    // Update max object extent
-                    int extent = static_cast<int>(qMax(object->size.width(), object->size.height()));
-                    if (extent > m_maxObjectExtent) {
-                        m_maxObjectExtent = extent;
-                    }
-                    tile->objects.push_back(std::move(object));
-                }
-            }
-            // Rebuild affinity map after loading objects
-            tile->rebuildAffinityMap();
-            
-            // Phase O2 (BF.3): Load image objects from assets folder.
-            // InsertedObject::fromJson() only sets imagePath; it does NOT load the pixmap.
-            tile->loadImages(m_bundlePath);
-        }
-        
-        Page* rawTilePtr = tile.get();
-        m_tiles[coord] = std::move(tile);
-        ++m_tileLoadVersion;
-        loadTileOcr(rawTilePtr, coord);
-        materializeOcrTextObjects(rawTilePtr);
-        
-#ifdef SPEEDYNOTE_DEBUG
-        qDebug() << "Loaded tile" << coord.first << "," << coord.second 
-                 << "from disk (manifest reconstruction)";
-#endif
-    } else {
-        // Legacy format or paged mode: use full Page deserialization
-        auto tile = Page::fromJson(obj);
-        if (!tile) {
-            qWarning() << "Cannot load tile: Page::fromJson failed";
-            m_tileIndex.erase(coord);  // CR-6: Remove from index
-            return false;
-        }
-        
-        // Phase O2 (BF.3): Load image objects from assets folder.
-        // Page::fromJson() only sets imagePath; it does NOT load the actual pixmap.
-        tile->loadImages(m_bundlePath);
-        
-        // Phase O1.5: Update max object extent from loaded objects
-        for (const auto& object : tile->objects) {
-            int extent = static_cast<int>(qMax(object->size.width(), object->size.height()));
-            if (extent > m_maxObjectExtent) {
-                m_maxObjectExtent = extent;
-            }
-        }
-        
-        Page* rawTilePtr = tile.get();
-        m_tiles[coord] = std::move(tile);
-        ++m_tileLoadVersion;
-        loadTileOcr(rawTilePtr, coord);
-        materializeOcrTextObjects(rawTilePtr);
-        
-#ifdef SPEEDYNOTE_DEBUG
-        qDebug() << "Loaded tile" << coord.first << "," << coord.second << "from disk (legacy)";
-#endif
     }
+    
+    Page* rawTilePtr = tile.get();
+    m_tiles[coord] = std::move(tile);
+    ++m_tileLoadVersion;
+    materializeOcrTextObjects(rawTilePtr);
 
     // Outline cache: in-memory tile is now authoritative; reconcile with
     // any prior disk-peek entry.  Safe no-op if the cache hasn't been
     // built yet (refreshLinkOutlineFor gates on m_linkOutlineCacheReady).
     refreshLinkOutlineFor(coord);
 
-    return true;
+    return rawTilePtr;
+}
+
+Page* Document::loadedTile(TileCoord coord) const
+{
+    auto it = m_tiles.find(coord);
+    return it != m_tiles.end() ? it->second.get() : nullptr;
 }
 
 void Document::evictTile(TileCoord coord)
@@ -3245,6 +3479,8 @@ void Document::evictTile(TileCoord coord)
     // Remove from memory
     m_tiles.erase(it);
     ++m_tileLoadVersion;
+    m_journal.dropBaseline(m_bundlePath + "/tiles/"
+                           + QString("%1,%2").arg(coord.first).arg(coord.second));
 
 #ifdef SPEEDYNOTE_DEBUG
     qDebug() << "Evicted tile" << coord.first << "," << coord.second << "from memory";
@@ -3339,6 +3575,8 @@ int Document::saveUnsavedImages(const QString& bundlePath)
 
 void Document::cleanupOrphanedAssets()
 {
+    ensurePageTables();
+
     if (m_bundlePath.isEmpty()) {
         return;  // Unsaved document, nothing on disk
     }
@@ -3380,33 +3618,25 @@ void Document::cleanupOrphanedAssets()
         }
         
         // Scan evicted tiles (on disk but not in memory) by reading their
-        // JSON files directly.  Only the "objects" array is inspected for
-        // imagePath references — no full Page deserialization required.
+        // files directly.  Only the JSON header's "objects" array is
+        // inspected for imagePath references — stroke columns are skipped
+        // and no full Page deserialization is required.
         for (const auto& coord : m_tileIndex) {
             if (m_tiles.find(coord) != m_tiles.end())
                 continue;  // already scanned above
 
-            QString tilePath = m_bundlePath + "/tiles/" +
-                QString("%1,%2.json").arg(coord.first).arg(coord.second);
-            QFile file(tilePath);
-            if (!file.open(QIODevice::ReadOnly)) {
-                qWarning() << "cleanupOrphanedAssets: cannot open tile" << tilePath
-                           << "- skipping asset cleanup to avoid data loss";
-                incompleteScan = true;
-                continue;
-            }
-
-            QJsonParseError parseError;
-            QJsonDocument tileDoc = QJsonDocument::fromJson(file.readAll(), &parseError);
-            file.close();
-            if (parseError.error != QJsonParseError::NoError) {
-                qWarning() << "cleanupOrphanedAssets: parse error in tile" << tilePath
-                           << parseError.errorString()
+            QString tileStem = m_bundlePath + "/tiles/" +
+                QString("%1,%2").arg(coord.first).arg(coord.second);
+            PageCodec::Container container;
+            QString readError;
+            if (!m_journal.read(tileStem, container, false, &readError)) {
+                qWarning() << "cleanupOrphanedAssets: cannot read tile" << tileStem
+                           << readError
                            << "- skipping asset cleanup to avoid data loss";
                 incompleteScan = true;
                 continue;
             }
-            QJsonObject tileObj = tileDoc.object();
+            const QJsonObject& tileObj = container.meta;
 
             QJsonArray objects = tileObj["objects"].toArray();
             for (const auto& val : objects) {
@@ -3423,45 +3653,36 @@ void Document::cleanupOrphanedAssets()
         //
         // Loaded pages are scanned in memory (authoritative - may carry
         // imagePath changes not yet flushed to disk). Evicted pages are read
-        // directly from their JSON file: this avoids mass-loading every page
+        // directly from their page file header: this avoids mass-loading every page
         // into memory at close, and - critically - lets us detect a failed
         // read so we can abort deletion instead of dropping references and
         // deleting in-use assets (the cause of the silent image-loss bug).
         QString pagesDir = m_bundlePath + "/pages";
         for (const QString& uuid : m_pageOrder) {
-            auto loadedIt = m_loadedPages.find(uuid);
+            auto loadedIt = m_loadedPages.find(Id128::fromString(uuid));
             if (loadedIt != m_loadedPages.end()) {
                 collectFromPage(loadedIt->second.get());
                 continue;
             }
 
-            QString pagePath = pagesDir + "/" + uuid + ".json";
-            QFile file(pagePath);
-            if (!file.exists()) {
-                // Pristine PDF pages legitimately have no JSON file (they are
+            QString pageStem = pagesDir + "/" + uuid;
+            if (!PageCodec::fileExists(pageStem)) {
+                // Pristine PDF pages legitimately have no page file (they are
                 // synthesized on load). Any other absent page carries no image
                 // references, so there is nothing to collect or lose.
                 continue;
             }
-            if (!file.open(QIODevice::ReadOnly)) {
-                qWarning() << "cleanupOrphanedAssets: cannot open page" << pagePath
-                           << "- skipping asset cleanup to avoid data loss";
-                incompleteScan = true;
-                continue;
-            }
-
-            QJsonParseError parseError;
-            QJsonDocument jsonDoc = QJsonDocument::fromJson(file.readAll(), &parseError);
-            file.close();
-            if (parseError.error != QJsonParseError::NoError) {
-                qWarning() << "cleanupOrphanedAssets: parse error in page" << pagePath
-                           << parseError.errorString()
+            PageCodec::Container container;
+            QString readError;
+            if (!m_journal.read(pageStem, container, false, &readError)) {
+                qWarning() << "cleanupOrphanedAssets: cannot read page" << pageStem
+                           << readError
                            << "- skipping asset cleanup to avoid data loss";
                 incompleteScan = true;
                 continue;
             }
 
-            QJsonArray objects = jsonDoc.object()["objects"].toArray();
+            QJsonArray objects = container.meta["objects"].toArray();
             for (const auto& val : objects) {
                 QJsonObject obj = val.toObject();
                 if (obj["type"].toString() == QLatin1String("image")) {
@@ -3519,6 +3740,8 @@ QString Document::notesPath() const
 
 bool Document::deleteNoteFile(const QString& noteId)
 {
+    ensurePageTables();
+
     QString notes = notesPath();
     if (notes.isEmpty()) {
         return false;
@@ -3648,31 +3871,26 @@ Document::extractLinkOutlineFromJsonObjects(const QJsonArray& objects,
     return out;
 }
 
-// -------- Disk peek: tile JSON → outline entries ---------------------------
+// -------- Disk peek: tile file → outline entries ---------------------------
 
 QVector<LinkOutlineEntry>
 Document::peekTileLinkOutlineFromDisk(TileCoord coord, bool requireMarkdown) const
 {
     if (m_bundlePath.isEmpty()) return {};
 
-    const QString path = m_bundlePath + "/tiles/"
-        + QString("%1,%2.json").arg(coord.first).arg(coord.second);
-    QFile f(path);
-    if (!f.open(QIODevice::ReadOnly)) return {};
-
-    QJsonParseError perr;
-    const QJsonDocument jd = QJsonDocument::fromJson(f.readAll(), &perr);
-    f.close();
-    if (perr.error != QJsonParseError::NoError || !jd.isObject()) return {};
+    const QString stem = m_bundlePath + "/tiles/"
+        + QString("%1,%2").arg(coord.first).arg(coord.second);
+    PageCodec::Container container;
+    if (!m_journal.read(stem, container, /*withStrokes=*/false)) return {};
 
     const QPointF tileOrigin(coord.first  * static_cast<qreal>(EDGELESS_TILE_SIZE),
                               coord.second * static_cast<qreal>(EDGELESS_TILE_SIZE));
     return extractLinkOutlineFromJsonObjects(
-        jd.object()["objects"].toArray(),
+        container.meta["objects"].toArray(),
         /*pageIndex=*/ -1, coord.first, coord.second, tileOrigin, requireMarkdown);
 }
 
-// -------- Disk peek: page JSON → outline entries ---------------------------
+// -------- Disk peek: page file → outline entries ---------------------------
 
 QVector<LinkOutlineEntry>
 Document::peekPageLinkOutlineFromDisk(int pageIndex, bool requireMarkdown) const
@@ -3680,17 +3898,13 @@ Document::peekPageLinkOutlineFromDisk(int pageIndex, bool requireMarkdown) const
     if (m_bundlePath.isEmpty()) return {};
     if (pageIndex < 0 || pageIndex >= m_pageOrder.size()) return {};
 
-    const QString path = m_bundlePath + "/pages/" + m_pageOrder[pageIndex] + ".json";
-    QFile f(path);
-    if (!f.open(QIODevice::ReadOnly)) return {};  // e.g. pristine PDF page (no file yet)
-
-    QJsonParseError perr;
-    const QJsonDocument jd = QJsonDocument::fromJson(f.readAll(), &perr);
-    f.close();
-    if (perr.error != QJsonParseError::NoError || !jd.isObject()) return {};
+    const QString stem = m_bundlePath + "/pages/" + m_pageOrder[pageIndex];
+    PageCodec::Container container;
+    // Missing file is normal, e.g. pristine PDF page (no file yet)
+    if (!m_journal.read(stem, container, /*withStrokes=*/false)) return {};
 
     return extractLinkOutlineFromJsonObjects(
-        jd.object()["objects"].toArray(),
+        container.meta["objects"].toArray(),
         pageIndex, /*tileX=*/0, /*tileY=*/0, /*tileOrigin=*/QPointF(), requireMarkdown);
 }
 
@@ -3722,10 +3936,10 @@ void Document::buildLinkOutlineCache() const
             m_tileOutline[coord] = std::move(entries);
         }
     } else {
-        const int count = static_cast<int>(m_pageOrder.size());
+        const int count = pageCount();
         for (int i = 0; i < count; ++i) {
-            const QString uuid = m_pageOrder[i];
-            auto it = m_loadedPages.find(uuid);
+            const QString uuid = pageUuidAt(i);
+            auto it = m_loadedPages.find(Id128::fromString(uuid));
             QVector<LinkOutlineEntry> entries;
             if (it != m_loadedPages.end() && it->second) {
                 entries = extractLinkOutlineFromPage(
@@ -3766,7 +3980,7 @@ void Document::refreshLinkOutlineFor(int pageIndex) const
     // (all-links) caches can be populated independently.
     if (!m_linkOutlineCacheReady && !m_markerCacheReady) return;
 
-    if (pageIndex < 0 || pageIndex >= m_pageOrder.size()) {
+    if (pageIndex < 0 || pageIndex >= pageCount()) {
         if (m_linkOutlineCacheReady) m_pageOutline.erase(pageIndex);
         if (m_markerCacheReady)      m_pageMarkers.erase(pageIndex);
         return;
@@ -3774,8 +3988,8 @@ void Document::refreshLinkOutlineFor(int pageIndex) const
 
     // Re-extract from the most authoritative source once, then filter per cache
     // via requireMarkdown.
-    const QString uuid = m_pageOrder[pageIndex];
-    auto it = m_loadedPages.find(uuid);
+    const QString uuid = pageUuidAt(pageIndex);
+    auto it = m_loadedPages.find(Id128::fromString(uuid));
     const bool loaded = (it != m_loadedPages.end() && it->second);
 
     auto compute = [&](bool requireMarkdown) -> QVector<LinkOutlineEntry> {
@@ -3835,10 +4049,10 @@ void Document::buildMarkerCache() const
 
     // Markers are a paged-mode concept (edgeless has no page track).
     if (!isEdgeless()) {
-        const int count = static_cast<int>(m_pageOrder.size());
+        const int count = pageCount();
         for (int i = 0; i < count; ++i) {
-            const QString uuid = m_pageOrder[i];
-            auto it = m_loadedPages.find(uuid);
+            const QString uuid = pageUuidAt(i);
+            auto it = m_loadedPages.find(Id128::fromString(uuid));
             QVector<LinkOutlineEntry> entries;
             if (it != m_loadedPages.end() && it->second) {
                 entries = extractLinkOutlineFromPage(
@@ -3864,14 +4078,14 @@ QVector<Document::PageLinkMarker> Document::pageLinkMarkers() const
     // page the user is editing is always the loaded/visible one. UNLOADED pages
     // fall back to the disk-peek-backed cache (no force-load on scroll).
     QVector<PageLinkMarker> out;
-    const int count = static_cast<int>(m_pageOrder.size());
+    const int count = pageCount();
     out.reserve(count);
     for (int i = 0; i < count; ++i) {
         QVector<LinkOutlineEntry> live;
         const QVector<LinkOutlineEntry>* entries = nullptr;
 
-        const QString& uuid = m_pageOrder[i];
-        auto lit = m_loadedPages.find(uuid);
+        const QString uuid = pageUuidAt(i);
+        auto lit = m_loadedPages.find(Id128::fromString(uuid));
         if (lit != m_loadedPages.end() && lit->second) {
             live = extractLinkOutlineFromPage(lit->second.get(), i, 0, 0,
                                               /*edgeless=*/false, /*requireMarkdown=*/false);
@@ -3919,11 +4133,12 @@ QVector<LinkOutlineEntry> Document::enumerateLinkOutline() const
     return isEdgeless() ? flatten(m_tileOutline) : flatten(m_pageOutline);
 }
 
-bool Document::saveBundle(const QString& path, bool finalize)
+bool Document::prepareBundleManifest(const QString& path, bool finalize, QJsonObject& manifest,
+                                     std::set<TileCoord>& allTileCoords, quint64& indexStamp)
 {
-    // Save old bundle path before overwriting - needed for copying evicted tiles/pages
-    QString oldBundlePath = m_bundlePath;
-    m_bundlePath = path;
+    // The page tables are serialized below and pages.snpi is rewritten, so
+    // build them from the mapped index and release the mapping first.
+    ensurePageTables();
     
     // Phase P.1.1: Write .snb_marker file to identify this as a SpeedyNote bundle
     QString markerPath = path + "/.snb_marker";
@@ -3977,10 +4192,7 @@ bool Document::saveBundle(const QString& path, bool finalize)
     }
     
     // Build manifest
-    QJsonObject manifest = toJson();  // Metadata only
-    
-    // For edgeless mode: track all tile coordinates (shared between blocks)
-    std::set<TileCoord> allTileCoords;
+    manifest = toJson();  // Metadata only
     
     // ========== MODE-SPECIFIC SAVE ==========
     if (mode == Mode::Edgeless) {
@@ -4069,6 +4281,12 @@ bool Document::saveBundle(const QString& path, bool finalize)
             pageMetadataObj[uuid] = metaObj;
         }
         manifest["page_metadata"] = pageMetadataObj;
+        
+        // Binary page index (pages.snpi) so loadBundle() can skip building the
+        // page tables; written by the caller. The stamp ties it to this
+        // manifest: a missing or stale index falls back to page_order/
+        // page_metadata above.
+        indexStamp = QRandomGenerator::global()->generate64();
     }
     
     // Phase SHARE: Write pdf_relative_path (primary mirror) for portability.
@@ -4080,6 +4298,40 @@ bool Document::saveBundle(const QString& path, bool finalize)
         }
     }
     
+    return true;
+}
+
+bool Document::saveBundle(const QString& path, bool finalize)
+{
+    // A background save may still be writing to this bundle.
+    finishPendingSave();
+    
+    QElapsedTimer stallTimer;
+    stallTimer.start();
+    
+    // Save old bundle path before overwriting - needed for copying evicted tiles/pages
+    QString oldBundlePath = m_bundlePath;
+    m_bundlePath = path;
+    
+    QJsonObject manifest;
+    std::set<TileCoord> allTileCoords;  // Edgeless: all tile coordinates
+    quint64 indexStamp = 0;
+    if (!prepareBundleManifest(path, finalize, manifest, allTileCoords, indexStamp)) {
+        return false;
+    }
+    
+    if (mode != Mode::Edgeless) {
+        const QString indexPath = path + "/" + PageIndex::fileName();
+        if (PageIndex::canIndex(m_pageOrder)
+            && PageIndex::writeFile(indexPath, m_pageOrder, m_pageMetadata,
+                                    m_pagePdfIndex, m_pagePdfSource, indexStamp)) {
+            // String, not double: JSON numbers cannot carry all 64 bits.
+            manifest["page_index_stamp"] = QString::number(indexStamp);
+        } else {
+            QFile::remove(indexPath);
+        }
+    }
+    
     // Write manifest
     QString manifestPath = path + "/document.json";
     QFile manifestFile(manifestPath);
@@ -4132,18 +4384,18 @@ bool Document::saveBundle(const QString& path, bool finalize)
                     continue;
                 }
                 
-                QString tileFileName = QString("%1,%2.json").arg(coord.first).arg(coord.second);
-                QString oldTilePath = oldBundlePath + "/tiles/" + tileFileName;
-                QString newTilePath = path + "/tiles/" + tileFileName;
+                QString tileStemName = QString("%1,%2").arg(coord.first).arg(coord.second);
+                QString oldTileStem = oldBundlePath + "/tiles/" + tileStemName;
+                QString newTileStem = path + "/tiles/" + tileStemName;
                 
-                // Copy tile file from old location to new location
-                if (QFile::exists(oldTilePath)) {
-                    if (QFile::copy(oldTilePath, newTilePath)) {
+                // Copy tile file (binary or legacy JSON) from old location to new location
+                if (PageCodec::fileExists(oldTileStem)) {
+                    if (m_journal.copyFile(oldTileStem, newTileStem)) {
 #ifdef SPEEDYNOTE_DEBUG
                         qDebug() << "Copied evicted tile" << coord.first << "," << coord.second;
 #endif
                     } else {
-                        qWarning() << "Failed to copy tile" << oldTilePath << "to" << newTilePath;
+                        qWarning() << "Failed to copy tile" << oldTileStem << "to" << newTileStem;
                     }
                 }
                 
@@ -4157,6 +4409,12 @@ bool Document::saveBundle(const QString& path, bool finalize)
             }
         }
         
+        // Evicted tiles were copied with their journal records folded in;
+        // from here on the journal belongs to the new location.
+        if (m_journal.bundlePath() != path) {
+            m_journal.open(path);
+        }
+        
         // Save tiles in memory
         for (const auto& pair : m_tiles) {
             TileCoord coord = pair.first;
@@ -4172,16 +4430,16 @@ bool Document::saveBundle(const QString& path, bool finalize)
         
         // ========== DELETE EMPTY TILES FROM DISK ==========
         for (const auto& coord : m_deletedTiles) {
-            QString tileFileName = QString("%1,%2.json").arg(coord.first).arg(coord.second);
-            QString tilePath = path + "/tiles/" + tileFileName;
-            if (QFile::exists(tilePath)) {
-                if (QFile::remove(tilePath)) {
+            QString tileStemName = QString("%1,%2").arg(coord.first).arg(coord.second);
+            QString tileStem = path + "/tiles/" + tileStemName;
+            if (PageCodec::fileExists(tileStem)) {
+                if (m_journal.removeFiles(tileStem)) {
 #ifdef SPEEDYNOTE_DEBUG
-                    qDebug() << "Deleted empty tile file:" << tileFileName;
+                    qDebug() << "Deleted empty tile file:" << tileStemName;
 #endif
                 } else {
                     #ifdef SPEEDYNOTE_DEBUG
-                        qDebug() << "Failed to delete empty tile file:" << tilePath;
+                        qDebug() << "Failed to delete empty tile file:" << tileStem;
                     #endif
                 }
             }
@@ -4204,22 +4462,21 @@ bool Document::saveBundle(const QString& path, bool finalize)
         if (savingToNewLocation) {
             for (const QString& uuid : m_pageOrder) {
                 // Skip pages that are in memory - they'll be saved below
-                if (m_loadedPages.find(uuid) != m_loadedPages.end()) {
+                if (m_loadedPages.find(Id128::fromString(uuid)) != m_loadedPages.end()) {
                     continue;
                 }
                 
-                QString pageFileName = uuid + ".json";
-                QString oldPagePath = oldBundlePath + "/pages/" + pageFileName;
-                QString newPagePath = path + "/pages/" + pageFileName;
+                QString oldPageStem = oldBundlePath + "/pages/" + uuid;
+                QString newPageStem = path + "/pages/" + uuid;
                 
-                if (QFile::exists(oldPagePath)) {
-                    if (QFile::copy(oldPagePath, newPagePath)) {
+                if (PageCodec::fileExists(oldPageStem)) {
+                    if (m_journal.copyFile(oldPageStem, newPageStem)) {
 #ifdef SPEEDYNOTE_DEBUG
                         qDebug() << "Copied evicted page" << uuid;
 #endif
                     } else {
                         #ifdef SPEEDYNOTE_DEBUG
-                            qDebug() << "Failed to copy page" << oldPagePath << "to" << newPagePath;
+                            qDebug() << "Failed to copy page" << oldPageStem << "to" << newPageStem;
                         #endif
                     }
                 }
@@ -4233,8 +4490,15 @@ bool Document::saveBundle(const QString& path, bool finalize)
             }
         }
         
+        // Evicted pages were copied with their journal records folded in;
+        // from here on the journal belongs to the new location.
+        if (m_journal.bundlePath() != path) {
+            m_journal.open(path);
+        }
+        
         // Save pages in memory
-        for (const auto& [uuid, pagePtr] : m_loadedPages) {
+        for (const auto& [key, pagePtr] : m_loadedPages) {
+            const QString uuid = key.toString();
             // Skip pristine PDF pages - they can be synthesized from manifest
             // A page is "pristine" if it has PDF background, no user content, and no bookmark
             bool isPristinePdfPage = (pagePtr->backgroundType == Page::BackgroundType::PDF) 
@@ -4251,9 +4515,8 @@ bool Document::saveBundle(const QString& path, bool finalize)
                 }
                 
                 // Delete any stale file from when page had content
-                QString pagePath = path + "/pages/" + uuid + ".json";
-                if (QFile::exists(pagePath)) {
-                    QFile::remove(pagePath);
+                QString pageStem = path + "/pages/" + uuid;
+                if (m_journal.removeFiles(pageStem)) {
 #ifdef SPEEDYNOTE_DEBUG
                     qDebug() << "Deleted stale file for pristine PDF page" << uuid;
 #endif
@@ -4264,20 +4527,17 @@ bool Document::saveBundle(const QString& path, bool finalize)
             
             // When saving to new location: save ALL in-memory pages (with content)
             // When saving to same location: only save dirty pages
-            bool needsSave = savingToNewLocation || m_dirtyPages.count(uuid) > 0;
+            bool needsSave = savingToNewLocation || m_dirtyPages.count(key) > 0;
             if (needsSave) {
-                QString pagePath = path + "/pages/" + uuid + ".json";
-                QFile file(pagePath);
-                if (file.open(QIODevice::WriteOnly)) {
-                    QJsonDocument doc(pagePtr->toJson());
-                    file.write(doc.toJson(QJsonDocument::Compact));
-                    file.close();
+                QString pageStem = path + "/pages/" + uuid;
+                if (m_journal.save(pageStem, pagePtr->toJson(false), pagePtr->layerStrokeLists())
+                        != PageJournal::SaveResult::Failed) {
 #ifdef SPEEDYNOTE_DEBUG
                     qDebug() << "Saved page" << uuid;
 #endif
                 } else {
                     #ifdef SPEEDYNOTE_DEBUG
-                        qDebug() << "Failed to save page" << pagePath;
+                        qDebug() << "Failed to save page" << pageStem;
                     #endif
                 }
             }
@@ -4285,14 +4545,14 @@ bool Document::saveBundle(const QString& path, bool finalize)
         
         // ========== DELETE REMOVED PAGES FROM DISK ==========
         for (const QString& uuid : m_deletedPages) {
-            QString pagePath = path + "/pages/" + uuid + ".json";
-            if (QFile::exists(pagePath)) {
-                if (QFile::remove(pagePath)) {
+            QString pageStem = path + "/pages/" + uuid;
+            if (PageCodec::fileExists(pageStem)) {
+                if (m_journal.removeFiles(pageStem)) {
 #ifdef SPEEDYNOTE_DEBUG
                     qDebug() << "Deleted page file:" << uuid;
 #endif
                 } else {
-                    qWarning() << "Failed to delete page file:" << pagePath;
+                    qWarning() << "Failed to delete page file:" << pageStem;
                 }
             }
             // Also delete OCR sidecar
@@ -4310,9 +4570,618 @@ bool Document::saveBundle(const QString& path, bool finalize)
     m_lazyLoadEnabled = true;
     clearModified();
     
+    // Closing/exporting saves leave a bundle without pending journal records.
+    if (finalize || m_journal.needsCompaction()) {
+        m_journal.compact();
+    }
+    
+    // After compaction: it rewrites page files and so changes their stamps.
+    writeThumbnails();
+    
+    m_lastSaveStallNs = stallTimer.nsecsElapsed();
     return true;
 }
 
+// =========================================================================
+// Background Bundle Saving
+// =========================================================================
+
+/**
+ * @brief Everything the writer thread needs for one in-place bundle save.
+ *
+ * Built on the GUI thread by saveBundleAsync(). Page/tile JSON is copied and
+ * stroke vectors are implicitly shared copies, so taking the snapshot is
+ * O(dirty pages) pointer work; encoding and I/O happen on the writer.
+ */
+struct BundleSaveJob {
+    struct Record {
+        QString stem;                           ///< Container path without suffix
+        QJsonObject json;                       ///< Container JSON (no strokes)
+        QVector<QVector<VectorStroke>> strokes; ///< Stroke columns per saved layer
+        bool isTile = false;
+        Id128 pageKey;                          ///< Paged mode
+        Document::TileCoord tile;               ///< Edgeless mode
+        QString ocrPath;                        ///< Tiles: OCR sidecar to write/remove
+        QJsonObject ocr;                        ///< Empty = remove the sidecar
+        bool written = false;                   ///< Set by the writer
+    };
+    
+    QString path;
+    QJsonObject manifest;
+    PageJournal* journal = nullptr;             ///< The document's; outlives the job
+    
+    // pages.snpi inputs (paged mode)
+    bool writeIndex = false;
+    quint64 indexStamp = 0;
+    QStringList pageOrder;
+    std::map<QString, QSizeF> pageMetadata;
+    std::map<QString, int> pagePdfIndex;
+    std::map<QString, QString> pagePdfSource;
+    
+    std::vector<Record> records;
+    QStringList removeStems;                    ///< Deleted/pristine containers
+    QStringList removeFiles;                    ///< Deleted OCR sidecars
+    
+    QFuture<bool> future;
+    bool applied = false;                       ///< GUI thread only
+    qint64 writeNs = 0;                         ///< Written by the writer
+};
+
+namespace {
+
+/// One writer thread for all documents, so saves never compete for the disk.
+QThreadPool* bundleWriterPool()
+{
+    static QThreadPool* pool = [] {
+        auto* p = new QThreadPool();
+        p->setMaxThreadCount(1);
+        return p;
+    }();
+    return pool;
+}
+
+/// Writer-thread half of saveBundleAsync().
+bool writeBundleJob(BundleSaveJob& job)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    if (job.writeIndex) {
+        const QString indexPath = job.path + "/" + PageIndex::fileName();
+        if (PageIndex::writeFile(indexPath, job.pageOrder, job.pageMetadata,
+                                 job.pagePdfIndex, job.pagePdfSource, job.indexStamp)) {
+            // String, not double: JSON numbers cannot carry all 64 bits.
+            job.manifest["page_index_stamp"] = QString::number(job.indexStamp);
+        } else {
+            QFile::remove(indexPath);
+        }
+    }
+    
+    bool ok = true;
+    QFile manifestFile(job.path + "/document.json");
+    if (manifestFile.open(QIODevice::WriteOnly)) {
+        manifestFile.write(QJsonDocument(job.manifest).toJson(QJsonDocument::Indented));
+        manifestFile.close();
+    } else {
+        qWarning() << "Cannot write manifest" << manifestFile.fileName();
+        ok = false;
+    }
+    
+    for (BundleSaveJob::Record& record : job.records) {
+        QVector<const QVector<VectorStroke>*> layerStrokes;
+        layerStrokes.reserve(record.strokes.size());
+        for (const QVector<VectorStroke>& strokes : std::as_const(record.strokes)) {
+            layerStrokes.append(&strokes);
+        }
+        record.written = job.journal->save(record.stem, record.json, layerStrokes)
+                         != PageJournal::SaveResult::Failed;
+        if (!record.written) {
+            qWarning() << "Background save: failed to write" << record.stem;
+            ok = false;
+            continue;
+        }
+        if (record.isTile) {
+            if (record.ocr.isEmpty()) {
+                QFile::remove(record.ocrPath);
+            } else {
+                QFile ocrFile(record.ocrPath);
+                if (ocrFile.open(QIODevice::WriteOnly)) {
+                    ocrFile.write(QJsonDocument(record.ocr).toJson(QJsonDocument::Compact));
+                }
+            }
+        }
+    }
+    
+    for (const QString& stem : std::as_const(job.removeStems)) {
+        job.journal->removeFiles(stem);
+    }
+    for (const QString& file : std::as_const(job.removeFiles)) {
+        QFile::remove(file);
+    }
+    if (job.journal->needsCompaction()) {
+        job.journal->compact();
+    }
+    
+    job.writeNs = timer.nsecsElapsed();
+    return ok;
+}
+
+} // namespace
+
+Document::AsyncSaveResult Document::saveBundleAsync(const QString& path)
+{
+    // Only in-place saves of an existing bundle: saving elsewhere copies
+    // evicted pages and assets from the old location, which stays on the
+    // synchronous path.
+    if (path.isEmpty() || path != m_bundlePath || !QFileInfo::exists(path + "/document.json")) {
+        return AsyncSaveResult::NotApplicable;
+    }
+    if (m_pendingSave) {
+        if (!m_pendingSave->future.isFinished()) {
+            return AsyncSaveResult::Busy;  // Dirty state untouched; next save picks it up
+        }
+        finishPendingSave();
+    }
+    
+    QElapsedTimer stallTimer;
+    stallTimer.start();
+    
+    auto job = std::make_shared<BundleSaveJob>();
+    job->path = path;
+    job->journal = &m_journal;
+    std::set<TileCoord> allTileCoords;
+    if (!prepareBundleManifest(path, false, job->manifest, allTileCoords, job->indexStamp)) {
+        return AsyncSaveResult::NotApplicable;  // saveBundle() reports the error
+    }
+    
+    if (mode == Mode::Edgeless) {
+        m_edgelessManifestDirty = false;
+        
+        for (const auto& [coord, tile] : m_tiles) {
+            if (m_dirtyTiles.count(coord) == 0 && m_tileIndex.count(coord) > 0) {
+                continue;
+            }
+            const QString stemName = QString("%1,%2").arg(coord.first).arg(coord.second);
+            BundleSaveJob::Record record;
+            record.isTile = true;
+            record.tile = coord;
+            record.stem = path + "/tiles/" + stemName;
+            QVector<const QVector<VectorStroke>*> layerStrokes;
+            record.json = tileJson(coord, tile.get(), layerStrokes);
+            for (const QVector<VectorStroke>* strokes : std::as_const(layerStrokes)) {
+                record.strokes.append(*strokes);  // Implicitly shared copy
+            }
+            record.ocrPath = path + "/tiles/" + stemName + ".ocr.json";
+            record.ocr = ocrSidecarJson(tile.get());
+            job->records.push_back(std::move(record));
+            
+            // Outline cache: the in-memory tile is authoritative.
+            refreshLinkOutlineFor(coord);
+        }
+        
+        for (const auto& coord : m_deletedTiles) {
+            const QString stem = path + "/tiles/" + QString("%1,%2").arg(coord.first).arg(coord.second);
+            job->removeStems.append(stem);
+            job->removeFiles.append(stem + ".ocr.json");
+        }
+        m_deletedTiles.clear();
+        m_dirtyTiles.clear();
+        m_tileIndex = allTileCoords;
+    } else {
+        job->writeIndex = PageIndex::canIndex(m_pageOrder);
+        if (job->writeIndex) {
+            job->pageOrder = m_pageOrder;
+            job->pageMetadata = m_pageMetadata;
+            job->pagePdfIndex = m_pagePdfIndex;
+            job->pagePdfSource = m_pagePdfSource;
+        } else {
+            job->removeFiles.append(path + "/" + PageIndex::fileName());
+        }
+        
+        for (const auto& [key, pagePtr] : m_loadedPages) {
+            const QString uuid = key.toString();
+            // Pristine PDF pages are synthesized on load (see saveBundle()).
+            if (pagePtr->backgroundType == Page::BackgroundType::PDF
+                && !pagePtr->hasContent() && !pagePtr->isBookmarked) {
+                if (m_pagePdfIndex.find(uuid) == m_pagePdfIndex.end()) {
+                    m_pagePdfIndex[uuid] = pagePtr->pdfPageNumber;
+                }
+                if (!pagePtr->pdfSourceId.isEmpty()) {
+                    m_pagePdfSource[uuid] = pagePtr->pdfSourceId;
+                }
+                job->removeStems.append(path + "/pages/" + uuid);
+                continue;
+            }
+            if (m_dirtyPages.count(key) == 0) {
+                continue;
+            }
+            BundleSaveJob::Record record;
+            record.pageKey = key;
+            record.stem = path + "/pages/" + uuid;
+            record.json = pagePtr->toJson(false);
+            const QVector<const QVector<VectorStroke>*> layerStrokes = pagePtr->layerStrokeLists();
+            for (const QVector<VectorStroke>* strokes : layerStrokes) {
+                record.strokes.append(*strokes);  // Implicitly shared copy
+            }
+            job->records.push_back(std::move(record));
+        }
+        
+        for (const QString& uuid : m_deletedPages) {
+            job->removeStems.append(path + "/pages/" + uuid);
+            job->removeFiles.append(path + "/pages/" + uuid + ".ocr.json");
+        }
+        m_deletedPages.clear();
+        m_dirtyPages.clear();
+    }
+    
+    m_lazyLoadEnabled = true;
+    clearModified();
+    
+    job->future = QtConcurrent::run(bundleWriterPool(), [job, this]() {
+        const bool ok = writeBundleJob(*job);
+        // Apply the result on the GUI thread. A document that finished the
+        // job itself (synchronous save, destruction) marked it applied.
+        if (QCoreApplication* app = QCoreApplication::instance()) {
+            QMetaObject::invokeMethod(app, [job, this]() {
+                if (!job->applied) {
+                    finishPendingSave();
+                }
+            }, Qt::QueuedConnection);
+        }
+        return ok;
+    });
+    m_pendingSave = std::move(job);
+    
+    m_lastSaveStallNs = stallTimer.nsecsElapsed();
+#ifdef SPEEDYNOTE_DEBUG
+    qDebug() << "saveBundleAsync: GUI thread stall" << m_lastSaveStallNs / 1000 << "us for"
+             << m_pendingSave->records.size() << "pages/tiles";
+#endif
+    return AsyncSaveResult::Started;
+}
+
+void Document::finishPendingSave()
+{
+    if (!m_pendingSave) {
+        return;
+    }
+    std::shared_ptr<BundleSaveJob> job = std::move(m_pendingSave);
+    m_pendingSave.reset();
+    job->future.waitForFinished();
+    job->applied = true;
+    
+    // Successfully written pages are clean unless edited again since the
+    // snapshot, in which case the edit already re-marked them dirty.
+    bool anyFailed = !job->future.result();
+    for (const BundleSaveJob::Record& record : job->records) {
+        if (record.written) {
+            continue;
+        }
+        anyFailed = true;
+        if (record.isTile) {
+            m_dirtyTiles.insert(record.tile);
+        } else {
+            m_dirtyPages.insert(record.pageKey);
+        }
+    }
+    if (anyFailed) {
+        if (mode == Mode::Edgeless) {
+            m_edgelessManifestDirty = true;
+        }
+        markModified();
+        qWarning() << "Background save to" << job->path << "failed; changes stay unsaved";
+    }
+    
+    // Failed pages are dirty again and keep their thumbnails pending.
+    writeThumbnails();
+    
+#ifdef SPEEDYNOTE_DEBUG
+    qDebug() << "saveBundleAsync: wrote" << job->records.size() << "pages/tiles in"
+             << job->writeNs / 1000000 << "ms on the writer thread";
+#endif
+}
+
+void Document::waitForPendingSaveWrites() const
+{
+    if (m_pendingSave) {
+        m_pendingSave->future.waitForFinished();
+    }
+}
+
+bool Document::compactJournal()
+{
+    finishPendingSave();
+    return m_journal.compact();
+}
+
+// =========================================================================
+// Asynchronous Tile Loading
+// =========================================================================
+
+std::function<std::shared_ptr<Document::DecodedTile>()>
+Document::tileDecoder(TileCoord coord, qreal cacheZoom, qreal cacheDpr) const
+{
+    if (!m_lazyLoadEnabled || m_bundlePath.isEmpty() ||
+        m_tileIndex.count(coord) == 0 || m_tiles.count(coord) > 0) {
+        return {};
+    }
+    
+    const quint64 ticket = ++m_tileLoadTicketCounter;
+    m_tileLoadTickets[coord] = ticket;
+    
+    // The worker must not see writes of a background save half done
+    // (waitForPendingSaveWrites(), without blocking the GUI thread here).
+    QFuture<bool> pendingWrites;
+    if (m_pendingSave) {
+        pendingWrites = m_pendingSave->future;
+    }
+    
+    const TileTemplate tileTemplate = tileTemplateOf(*this);
+    const QString bundlePath = m_bundlePath;
+    PageJournal* journal = &m_journal;
+    
+    return [=]() {
+        auto decoded = std::make_shared<DecodedTile>();
+        decoded->coord = coord;
+        decoded->bundlePath = bundlePath;
+        decoded->ticket = ticket;
+        
+        if (!pendingWrites.isFinished()) {
+            QFuture<bool> writes = pendingWrites;
+            writes.waitForFinished();
+        }
+        
+        const QString tileStem = tileStemIn(bundlePath, coord);
+        PageCodec::Container container;
+        QString readError;
+        if (!journal->read(tileStem, container, true, &readError)) {
+            qWarning() << "Cannot load tile" << tileStem << ":" << readError;
+            return decoded;
+        }
+        
+        // Strokes are shared, not moved: the container is the baseline.
+        decoded->tile = buildTile(tileTemplate, container, false, tileStem);
+        if (!decoded->tile) {
+            return decoded;
+        }
+        decoded->baseline = std::move(container);
+        loadTileOcrFromBundle(bundlePath, decoded->tile.get(), coord);
+        
+        if (cacheZoom > 0 && cacheDpr > 0) {
+            for (const auto& layer : decoded->tile->vectorLayers) {
+                // Empty and hidden layers are cheap to leave to the viewport.
+                decoded->strokeCaches.append(layer->visible && !layer->isEmpty()
+                    ? layer->renderStrokeCacheImage(decoded->tile->size, cacheZoom, cacheDpr)
+                    : QImage());
+            }
+            decoded->cacheZoom = cacheZoom;
+            decoded->cacheDpr = cacheDpr;
+        }
+        return decoded;
+    };
+}
+
+bool Document::adoptDecodedTile(DecodedTile& decoded)
+{
+    const TileCoord coord = decoded.coord;
+    
+    // Superseded by a newer request or by a synchronous load.
+    auto ticketIt = m_tileLoadTickets.find(coord);
+    if (ticketIt == m_tileLoadTickets.end() || ticketIt->second != decoded.ticket) {
+        return false;
+    }
+    m_tileLoadTickets.erase(ticketIt);
+    
+    // Loaded, created or deleted meanwhile, or the bundle moved (save as).
+    if (decoded.bundlePath != m_bundlePath || m_tiles.count(coord) > 0 ||
+        m_tileIndex.count(coord) == 0) {
+        return false;
+    }
+    
+    if (!decoded.tile) {
+        // CR-6: Remove from index to prevent repeated failed loads
+        m_tileIndex.erase(coord);
+        return false;
+    }
+    
+    m_journal.setBaseline(tileStemIn(m_bundlePath, coord), decoded.baseline);
+    decoded.baseline = PageCodec::Container();
+    
+    Page* tile = insertLoadedTile(coord, std::move(decoded.tile));
+    if (!decoded.strokeCaches.isEmpty()) {
+        const int count = qMin(int(decoded.strokeCaches.size()), int(tile->vectorLayers.size()));
+        for (int i = 0; i < count; ++i) {
+            tile->vectorLayers[i]->adoptStrokeCacheImage(decoded.strokeCaches[i], tile->size,
+                                                         decoded.cacheZoom, decoded.cacheDpr);
+        }
+        decoded.strokeCaches.clear();
+    }
+    
+#ifdef SPEEDYNOTE_DEBUG
+    qDebug() << "Loaded tile" << coord.first << "," << coord.second << "from disk (async)";
+#endif
+    return true;
+}
+
+// =========================================================================
+// Persistent Thumbnails
+// =========================================================================
+
+quint64 Document::pageContentStamp(int index) const
+{
+    // FNV-1a over everything that decides what a page looks like on disk.
+    // Full writes replace the file (new mtime), deltas add journal records.
+    quint64 h = 14695981039346656037ull;
+    auto mix = [&h](quint64 v) {
+        for (int i = 0; i < 8; ++i) {
+            h ^= (v >> (i * 8)) & 0xFF;
+            h *= 1099511628211ull;
+        }
+    };
+    auto mixString = [&mix](const QString& str) {
+        mix(quint64(str.size()));
+        for (QChar c : str) {
+            mix(c.unicode());
+        }
+    };
+    
+    const QString stem = m_bundlePath + "/pages/" + pageUuidAt(index);
+    const QFileInfo file(PageCodec::existingFile(stem));
+    if (file.exists()) {
+        mix(quint64(file.size()));
+        mix(quint64(file.lastModified().toMSecsSinceEpoch()));
+    }
+    mix(m_journal.lastRecordSeq(stem));
+    
+    // Pages without a file are synthesized from their manifest entry.
+    QSizeF size;
+    if (manifestPageSize(index, size)) {
+        mix(quint64(qRound64(size.width() * 1000)));
+        mix(quint64(qRound64(size.height() * 1000)));
+    }
+    const int pdfPage = manifestPdfPage(index);
+    mix(quint64(qint64(pdfPage)));
+    if (pdfPage >= 0) {
+        // A relinked PDF changes the background without touching the page.
+        const PdfSource* source = pdfSourceById(manifestPdfSource(index));
+        mixString(source ? source->hash : QString());
+    }
+    return h;
+}
+
+quint64 Document::pageTextStamp(int index, bool* hasStoredText) const
+{
+    quint64 h = pageContentStamp(index);
+    auto mix = [&h](quint64 v) {
+        for (int i = 0; i < 8; ++i) {
+            h ^= (v >> (i * 8)) & 0xFF;
+            h *= 1099511628211ull;
+        }
+    };
+    
+    // OCR results are written to the sidecar, not the page file.
+    const QString stem = m_bundlePath + "/pages/" + pageUuidAt(index);
+    const QFileInfo sidecar(stem + ".ocr.json");
+    const bool hasSidecar = sidecar.exists();
+    if (hasSidecar) {
+        mix(quint64(sidecar.size()));
+        mix(quint64(sidecar.lastModified().toMSecsSinceEpoch()));
+    }
+    if (hasStoredText) {
+        *hasStoredText = hasSidecar || PageCodec::fileExists(stem);
+    }
+    return h;
+}
+
+quint64 Document::pageEditEpoch(int index) const
+{
+    if (index < 0 || index >= pageCount()) {
+        return 0;
+    }
+    auto it = m_pageEdits.find(Id128::fromString(pageUuidAt(index)));
+    return it != m_pageEdits.end() ? it->second : 0;
+}
+
+QByteArray Document::storedThumbnail(int index, int pixelWidth, bool pdfDarkMode) const
+{
+    if (mode == Mode::Edgeless || index < 0 || index >= pageCount()) {
+        return QByteArray();
+    }
+    const QString uuid = pageUuidAt(index);
+    const Id128 key = Id128::fromString(uuid);
+    auto it = m_pendingThumbnails.find(key);
+    if (it != m_pendingThumbnails.end()) {
+        const PendingThumbnail& pending = it->second;
+        return (pending.pixelWidth == pixelWidth && pending.pdfDarkMode == pdfDarkMode)
+            ? pending.data : QByteArray();
+    }
+    if (!m_thumbnails.isOpen() || m_dirtyPages.count(key) > 0
+        || m_staleThumbnails.count(key) > 0) {
+        return QByteArray();
+    }
+    return m_thumbnails.find(uuid, quint32(pixelWidth), pdfDarkMode,
+                             pageContentStamp(index));
+}
+
+void Document::storeThumbnail(const QString& pageUuid, int pixelWidth, bool pdfDarkMode,
+                              const QByteArray& encoded, quint64 epoch)
+{
+    if (mode == Mode::Edgeless || encoded.isEmpty()) {
+        return;
+    }
+    const Id128 key = Id128::fromString(pageUuid);
+    if (pageIndexByKey(key) < 0) {
+        return;  // Deleted while rendering
+    }
+    auto inv = m_thumbnailInvalidations.find(key);
+    if (inv != m_thumbnailInvalidations.end() && inv->second > epoch) {
+        return;  // Edited after the renderer took its snapshot
+    }
+    PendingThumbnail& pending = m_pendingThumbnails[key];
+    pending.pixelWidth = pixelWidth;
+    pending.pdfDarkMode = pdfDarkMode;
+    pending.data = encoded;
+}
+
+void Document::flushThumbnails()
+{
+    finishPendingSave();  // Writes the thumbnails of a finished background save
+    writeThumbnails();
+}
+
+void Document::invalidateThumbnail(const Id128& key)
+{
+    m_pendingThumbnails.erase(key);
+    m_staleThumbnails.insert(key);
+    m_thumbnailInvalidations[key] = ++m_thumbnailEpoch;
+}
+
+void Document::writeThumbnails()
+{
+    if (mode == Mode::Edgeless || m_bundlePath.isEmpty()
+        || !QFileInfo::exists(m_bundlePath + "/document.json")) {
+        return;
+    }
+    
+    // Remembered thumbnails show the in-memory page; they can be stamped
+    // with the on-disk state once the page has been saved. Pages that are
+    // still dirty keep theirs for the next save.
+    QVector<ThumbnailStore::Entry> added;
+    for (auto it = m_pendingThumbnails.begin(); it != m_pendingThumbnails.end();) {
+        if (m_dirtyPages.count(it->first) > 0) {
+            ++it;
+            continue;
+        }
+        const int index = pageIndexByKey(it->first);
+        if (index >= 0) {
+            ThumbnailStore::Entry entry;
+            entry.uuid = it->first.toString();
+            entry.contentStamp = pageContentStamp(index);
+            entry.pixelWidth = quint32(it->second.pixelWidth);
+            entry.pdfDarkMode = it->second.pdfDarkMode;
+            entry.data = it->second.data;
+            added.append(entry);
+        }
+        it = m_pendingThumbnails.erase(it);
+    }
+    
+    // Entries of pages saved since they were marked stale no longer match
+    // their stamp, so the stale set has done its job.
+    m_staleThumbnails.clear();
+    if (added.isEmpty()) {
+        return;
+    }
+    
+    const QString path = m_bundlePath + "/" + ThumbnailStore::fileName();
+    m_thumbnails.close();  // Never write under our own mapping
+    if (!ThumbnailStore::update(path, added, [this](const QString& uuid) {
+            return pageIndexByUuid(uuid) >= 0;
+        })) {
+        qWarning() << "Cannot write thumbnails" << path;
+    }
+    m_thumbnails.open(path);
+}
+
 std::unique_ptr<Document> Document::loadBundle(const QString& path)
 {
     QString manifestPath = path + "/document.json";
@@ -4352,6 +5221,12 @@ std::unique_ptr<Document> Document::loadBundle(const QString& path)
     // Set bundle path and enable lazy loading
     doc->m_bundlePath = path;
     doc->m_lazyLoadEnabled = true;
+    // Index journal.snj; pending records are replayed as pages load.
+    doc->m_journal.open(path);
+    // Map thumbnails.snth for the page panel.
+    if (doc->mode != Mode::Edgeless) {
+        doc->m_thumbnails.open(path + "/" + ThumbnailStore::fileName());
+    }
     
     // ========== MODE-SPECIFIC LOADING ==========
     if (doc->mode == Mode::Edgeless) {
@@ -4421,8 +5296,17 @@ std::unique_ptr<Document> Document::loadBundle(const QString& path)
 #endif
     } else {
         // ========== PAGED MODE LOADING (Phase O1.7.4) ==========
-        // Parse page_order (just UUIDs, no actual content loading!)
-        if (obj.contains("page_order")) {
+        // Prefer the memory-mapped page index: page order and metadata are
+        // then read on demand instead of being converted up front.
+        bool stampOk = false;
+        const quint64 indexStamp = obj["page_index_stamp"].toString().toULongLong(&stampOk);
+        if (stampOk && doc->m_pageIndex.open(path + "/" + PageIndex::fileName(), indexStamp)) {
+#ifdef SPEEDYNOTE_DEBUG
+            qDebug() << "Loaded paged bundle from" << path << "with"
+                     << doc->m_pageIndex.pageCount() << "pages (mapped page index)";
+#endif
+        } else if (obj.contains("page_order")) {
+            // Parse page_order (just UUIDs, no actual content loading!)
             QJsonArray pageOrderArray = obj["page_order"].toArray();
             for (const auto& val : pageOrderArray) {
                 doc->m_pageOrder.append(val.toString());
@@ -4846,7 +5730,7 @@ int Document::duplicateEdgelessLayer(int index)
         if (source) {
             for (const VectorStroke& stroke : source->strokes()) {
                 VectorStroke copy = stroke;  // Copy all properties
-                copy.id = QUuid::createUuid().toString(QUuid::WithoutBraces);  // New UUID
+                copy.id = Id128::create();  // New UUID
                 newLayer->addStroke(std::move(copy));
             }
         }
@@ -4997,21 +5881,12 @@ void Document::setEdgelessActiveLayerIndex(int index)
 // OCR Sidecar File I/O (Phase 1A)
 // =========================================================================
 
-bool Document::savePageOcr(const QString& uuid, const Page* page)
+QJsonObject Document::ocrSidecarJson(const Page* page)
 {
-    if (m_bundlePath.isEmpty() || !page)
-        return false;
-
-    QString ocrPath = m_bundlePath + "/pages/" + uuid + ".ocr.json";
-
-    if (page->ocrTextBlocks.isEmpty() && page->suppressedStrokeIds.isEmpty()) {
-        QFile::remove(ocrPath);
-        return true;
-    }
-
-    QDir().mkpath(m_bundlePath + "/pages");
-
     QJsonObject root;
+    if (page->ocrTextBlocks.isEmpty() && page->suppressedStrokeIds.isEmpty())
+        return root;
+
     root["version"] = 1;
     if (!page->ocrTextBlocks.isEmpty())
         root["engineId"] = page->ocrTextBlocks.first().engineId;
@@ -5027,6 +5902,24 @@ bool Document::savePageOcr(const QString& uuid, const Page* page)
             suppressed.append(id);
         root["suppressedStrokeIds"] = suppressed;
     }
+    return root;
+}
+
+bool Document::savePageOcr(const QString& uuid, const Page* page)
+{
+    if (m_bundlePath.isEmpty() || !page)
+        return false;
+
+    QString ocrPath = m_bundlePath + "/pages/" + uuid + ".ocr.json";
+    m_pageEdits[Id128::fromString(uuid)] = ++m_pageEditCounter;
+
+    const QJsonObject root = ocrSidecarJson(page);
+    if (root.isEmpty()) {
+        QFile::remove(ocrPath);
+        return true;
+    }
+
+    QDir().mkpath(m_bundlePath + "/pages");
 
     QFile file(ocrPath);
     if (!file.open(QIODevice::WriteOnly))
@@ -5080,30 +5973,14 @@ bool Document::saveTileOcr(TileCoord coord)
     QString ocrPath = m_bundlePath + "/tiles/" +
         QString("%1,%2.ocr.json").arg(coord.first).arg(coord.second);
 
-    if (tile->ocrTextBlocks.isEmpty() && tile->suppressedStrokeIds.isEmpty()) {
+    const QJsonObject root = ocrSidecarJson(tile);
+    if (root.isEmpty()) {
         QFile::remove(ocrPath);
         return true;
     }
 
     QDir().mkpath(m_bundlePath + "/tiles");
 
-    QJsonObject root;
-    root["version"] = 1;
-    if (!tile->ocrTextBlocks.isEmpty())
-        root["engineId"] = tile->ocrTextBlocks.first().engineId;
-
-    QJsonArray blocks;
-    for (const auto& block : tile->ocrTextBlocks)
-        blocks.append(block.toJson());
-    root["blocks"] = blocks;
-
-    if (!tile->suppressedStrokeIds.isEmpty()) {
-        QJsonArray suppressed;
-        for (const auto& id : tile->suppressedStrokeIds)
-            suppressed.append(id);
-        root["suppressedStrokeIds"] = suppressed;
-    }
-
     QFile file(ocrPath);
     if (!file.open(QIODevice::WriteOnly))
         return false;
@@ -5113,10 +5990,15 @@ bool Document::saveTileOcr(TileCoord coord)
 
 bool Document::loadTileOcr(Page* tile, TileCoord coord) const
 {
-    if (m_bundlePath.isEmpty() || !tile)
+    return loadTileOcrFromBundle(m_bundlePath, tile, coord);
+}
+
+bool Document::loadTileOcrFromBundle(const QString& bundlePath, Page* tile, TileCoord coord)
+{
+    if (bundlePath.isEmpty() || !tile)
         return false;
 
-    QString ocrPath = m_bundlePath + "/tiles/" +
+    QString ocrPath = bundlePath + "/tiles/" +
         QString("%1,%2.ocr.json").arg(coord.first).arg(coord.second);
 
     QFile file(ocrPath);
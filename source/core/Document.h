@@ -16,6 +16,10 @@
 // ============================================================================
 
 #include "Page.h"
+#include "Id128.h"
+#include "PageIndex.h"
+#include "PageJournal.h"
+#include "ThumbnailStore.h"
 #include "../pdf/PdfProvider.h"
 #include "../ui/sidebars/LinkOutlineEntry.h"
 
@@ -31,10 +35,12 @@
 #include <QDir>
 #include <QFile>
 #include <QPixmap>
+#include <QImage>
 #include <QSet>
 #include <QHash>
 #include <QVector>
 #include <QStringList>
+#include <functional>
 #include <vector>
 #include <map>
 #include <set>
@@ -140,6 +146,9 @@ struct PageImportResult {
 
 // ============================================================================
 
+/// Snapshot of one background bundle save (defined in Document.cpp).
+struct BundleSaveJob;
+
 /**
  * @brief The central data structure representing an open notebook.
  * 
@@ -164,8 +173,10 @@ public:
      * Version history:
      * - 1: Initial .snb bundle format (2026-01)
      * - 2: Added pdf_relative_path for portable .snbx packages (2026-01)
+     * - 4: Binary columnar page/tile containers (.snpb, see PageCodec);
+     *      legacy .json page/tile files are still read
      */
-    static constexpr int BUNDLE_FORMAT_VERSION = 3;
+    static constexpr int BUNDLE_FORMAT_VERSION = 4;
     
     // ===== Document Mode =====
     
@@ -616,6 +627,14 @@ public:
      */
     bool loadTileOcr(Page* tile, TileCoord coord) const;
     
+    /**
+     * @brief loadTileOcr() for a tile of the bundle at @p bundlePath.
+     * 
+     * Touches nothing but @p tile, so tileDecoder() can run it off the GUI
+     * thread.
+     */
+    static bool loadTileOcrFromBundle(const QString& bundlePath, Page* tile, TileCoord coord);
+    
     /**
      * @brief Create OcrTextObjects on a page from its ocrTextBlocks.
      * Called after loadPageOcr/loadTileOcr to materialize the derived cache.
@@ -689,6 +708,62 @@ public:
      */
     bool tileExistsOnDisk(TileCoord coord) const { return m_tileIndex.count(coord) > 0; }
     
+    /**
+     * @brief Get a tile only if it is in memory (never touches the disk).
+     * @param coord Tile coordinate.
+     * @return Pointer to the tile, or nullptr if it is not loaded.
+     * 
+     * For the paint path: unlike getTile(), a tile that is only on disk is
+     * not loaded synchronously (see tileDecoder()).
+     */
+    Page* loadedTile(TileCoord coord) const;
+    
+    // ----- Asynchronous tile loading -----
+    
+    /**
+     * @brief A tile read and decoded off the GUI thread (see tileDecoder()).
+     */
+    struct DecodedTile {
+        TileCoord coord;
+        QString bundlePath;                   ///< Bundle the tile was read from
+        quint64 ticket = 0;                   ///< Request this result answers
+        std::unique_ptr<Page> tile;           ///< nullptr if the tile could not be read
+        PageCodec::Container baseline;        ///< Journal baseline (shares the tile's strokes)
+        QVector<QImage> strokeCaches;         ///< Pre-rendered layer caches (empty: none)
+        qreal cacheZoom = 0;                  ///< Zoom the caches were rendered at
+        qreal cacheDpr = 0;                   ///< DPR the caches were rendered at
+    };
+    
+    /**
+     * @brief Prepare loading a tile on a worker thread.
+     * @param coord Tile coordinate; must be on disk and not in memory.
+     * @param cacheZoom If > 0, also pre-render each layer's stroke cache at
+     *        this zoom and @p cacheDpr (the Capped render tier).
+     * @param cacheDpr Device pixel ratio for the pre-rendered caches.
+     * @return A function that may run on any thread, or an empty function if
+     *         there is nothing to load.
+     * 
+     * The function reads the tile container and OCR sidecar, reconstructs
+     * the tile and renders its stroke caches into images, touching only a
+     * copy of the document state taken here and the (thread-safe) page
+     * journal. Its result goes to adoptDecodedTile() on the GUI thread. The
+     * Document must outlive the call.
+     */
+    std::function<std::shared_ptr<DecodedTile>()>
+    tileDecoder(TileCoord coord, qreal cacheZoom = 0, qreal cacheDpr = 0) const;
+    
+    /**
+     * @brief Insert a tile decoded by tileDecoder() into memory (GUI thread).
+     * @return True if the tile was adopted. False if the result is stale -
+     *         the tile was loaded synchronously, created, deleted or the
+     *         bundle moved in the meantime - or the tile could not be read;
+     *         the result is then dropped.
+     * 
+     * Image assets are loaded here: they become QPixmaps, which only the GUI
+     * thread may create.
+     */
+    bool adoptDecodedTile(DecodedTile& decoded);
+    
     // Phase 5.6.5: syncTileLayerStructure() removed - layer structure now comes from manifest
     
     /**
@@ -698,10 +773,127 @@ public:
      *        bundled mini-PDFs (Plan B2) before writing the manifest, so the bundle
      *        becomes self-contained. Only used on document close and .snbx export;
      *        ordinary saves/autosaves pass false to avoid grafting churn.
+     *        A finalizing save also compacts the page journal.
      * @return True if saved successfully.
+     * 
+     * In-place saves of a page/tile that changed little since it was last
+     * written append a delta to journal.snj instead of rewriting its file.
      */
     bool saveBundle(const QString& path, bool finalize = false);
     
+    /// Outcome of saveBundleAsync().
+    enum class AsyncSaveResult {
+        Started,        ///< Snapshot taken; the writer thread is saving it
+        Busy,           ///< The previous background save is still writing
+        NotApplicable   ///< Use saveBundle() (new location, unsaved bundle)
+    };
+    
+    /**
+     * @brief Save in place with serialization and disk I/O off this thread.
+     * @param path Path to the .snb directory; must be the current bundle path.
+     * 
+     * The calling (GUI) thread builds the manifest and takes copy-on-write
+     * snapshots of the dirty pages/tiles (their JSON and implicitly shared
+     * stroke vectors), then clears the dirty sets and the modified flag.
+     * A dedicated writer thread encodes and writes the snapshot. Pages that
+     * are edited again meanwhile are simply re-marked dirty by the edit.
+     * On completion, pages whose write failed are marked dirty again.
+     * 
+     * Saving to a new location or with finalize=true still requires
+     * saveBundle(), which first waits for any background save.
+     */
+    AsyncSaveResult saveBundleAsync(const QString& path);
+    
+    /// True while a background save has not been applied yet.
+    bool hasPendingSave() const { return m_pendingSave != nullptr; }
+    
+    /**
+     * @brief Wait for the background save (if any) and apply its result.
+     * 
+     * Called automatically before synchronous saves and on destruction;
+     * otherwise the result is applied from the event loop.
+     */
+    void finishPendingSave();
+    
+    /**
+     * @brief Time the calling thread spent in the last save: the snapshot
+     *        for saveBundleAsync(), the whole save for saveBundle().
+     */
+    qint64 lastSaveStallNs() const { return m_lastSaveStallNs; }
+    
+    /**
+     * @brief Fold the bundle's stroke journal into its page/tile files.
+     * 
+     * Saves append page deltas to journal.snj (see PageJournal) and compact
+     * it on their own once it grows large or on a finalizing save; this
+     * forces it, e.g. before handing the bundle to another program.
+     */
+    bool compactJournal();
+    
+    /// The bundle's page/tile journal (read-only; for diagnostics and tests).
+    const PageJournal& journal() const { return m_journal; }
+    
+    // ===== Persistent Thumbnails (paged mode) =====
+    
+    /**
+     * @brief Stored thumbnail of a page, if one matches its current state.
+     * @param index Page index.
+     * @param pixelWidth Thumbnail width in device pixels.
+     * @param pdfDarkMode Whether the PDF background is shown inverted.
+     * @return Encoded image, or empty if the page has to be rendered.
+     * 
+     * Looks at thumbnails remembered this session, then at the bundle's
+     * memory-mapped thumbnails.snth (see ThumbnailStore). Pages edited since
+     * the last save never match.
+     */
+    QByteArray storedThumbnail(int index, int pixelWidth, bool pdfDarkMode) const;
+    
+    /**
+     * @brief Token for storeThumbnail(); take it before snapshotting a page
+     *        for rendering.
+     */
+    quint64 thumbnailEpoch() const { return m_thumbnailEpoch; }
+    
+    /**
+     * @brief Remember a freshly rendered thumbnail for the bundle.
+     * @param pageUuid Page the thumbnail was rendered from.
+     * @param epoch thumbnailEpoch() when the page was snapshotted; renders
+     *        of pages edited since then are ignored.
+     * 
+     * Written to thumbnails.snth by the next save or flushThumbnails(),
+     * unless markPageDirty() drops it first.
+     */
+    void storeThumbnail(const QString& pageUuid, int pixelWidth, bool pdfDarkMode,
+                        const QByteArray& encoded, quint64 epoch);
+    
+    /**
+     * @brief Write remembered thumbnails of saved pages to the bundle.
+     * 
+     * Saves do this on their own; call it when closing a document that
+     * may not be saved again (e.g. opened only for reading).
+     */
+    void flushThumbnails();
+    
+    // ===== Search Index Support (paged mode) =====
+    
+    /**
+     * @brief Fingerprint of the searchable text of page @p index as stored in
+     *        the bundle: pageContentStamp() plus the page's OCR sidecar.
+     * @param hasStoredText Set to whether the page has a file or an OCR
+     *        sidecar; pristine PDF pages have neither and no text of their own.
+     */
+    quint64 pageTextStamp(int index, bool* hasStoredText = nullptr) const;
+    
+    /**
+     * @brief Edit counter of page @p index for this session.
+     * 
+     * Grows whenever the page is marked dirty or its OCR sidecar is written;
+     * 0 for pages untouched since the document was opened. Lets PdfSearchIndex
+     * tell whether text it read earlier in the session is still current
+     * without touching the disk again.
+     */
+    quint64 pageEditEpoch(int index) const;
+    
     /**
      * @brief Load a document from a bundle (tiles lazy-loaded).
      * @param path Path to the .snb directory.
@@ -1057,6 +1249,17 @@ public:
      * @return Rendered image, or null image if the source is not available.
      */
     QImage renderPdfPageToImage(const QString& sourceId, int pageIndex, qreal dpi = 96.0) const;
+
+    /**
+     * @brief Render a rectangular region of a PDF page (tiled PDF cache).
+     * @param sourceId Source id (empty = primary source).
+     * @param pageIndex 0-based page index within that source.
+     * @param dpi Rendering DPI.
+     * @param region Region in pixel coordinates of the full-page image at @p dpi.
+     * @return Rendered region, or null image if the source is not available.
+     */
+    QImage renderPdfPageRegionToImage(const QString& sourceId, int pageIndex, qreal dpi,
+                                      const QRect& region) const;
     
     /**
      * @brief Render a PDF page to a pixmap.
@@ -1278,6 +1481,15 @@ public:
      */
     bool pdfBindingForNotebookPage(int notebookPageIndex, QString& outSourceId, int& outPdfPage) const;
 
+    /**
+     * @brief pdfBindingForNotebookPage() without loading the page.
+     *
+     * Loaded pages answer from their live fields, the others from the
+     * manifest. For callers visiting every page on the main thread (the
+     * search index snapshot).
+     */
+    bool peekPdfBinding(int notebookPageIndex, QString& outSourceId, int& outPdfPage) const;
+
     /**
      * @brief Find the notebook page displaying a given source's original PDF page.
      * @param sourceId PDF source id (empty = primary source).
@@ -1384,9 +1596,13 @@ public:
      * @brief Get the number of pages in the document.
      * @return Page count (always >= 1 after ensureMinimumPages).
      * 
-     * Phase O1.7: Returns m_pageOrder.size() in lazy loading mode.
+     * Phase O1.7: Returns m_pageOrder.size() in lazy loading mode, or the
+     * record count of the mapped page index before the tables are built.
      */
     int pageCount() const { 
+        if (m_pageIndex.isOpen()) {
+            return m_pageIndex.pageCount();
+        }
         return static_cast<int>(m_pageOrder.size()); 
     }
     
@@ -1864,33 +2080,77 @@ private:
     // ===== Paged Mode Lazy Loading (Phase O1.7) =====
     /// Ordered list of page UUIDs. Defines page order in the document.
     /// Pages are loaded on-demand from pages/{uuid}.json files.
-    QStringList m_pageOrder;
+    /// The four page tables below are empty while m_pageIndex is open and
+    /// are filled by ensurePageTables() (hence mutable).
+    mutable QStringList m_pageOrder;
     
     /// Minimal metadata for layout calculations without loading full pages.
     /// Key: page UUID, Value: page size (width, height).
-    std::map<QString, QSizeF> m_pageMetadata;
+    /// While m_pageIndex is open this only holds sizes changed since load
+    /// (setPageSize/savePage); they take precedence over the index.
+    mutable std::map<QString, QSizeF> m_pageMetadata;
     
     /// PDF page index for each page (for pristine PDF page synthesis).
     /// Key: page UUID, Value: PDF page index (0-based).
     /// Only contains entries for pages with PDF backgrounds.
     /// Pages not in this map are non-PDF pages (blank, grid, lines, etc.).
-    std::map<QString, int> m_pagePdfIndex;
+    mutable std::map<QString, int> m_pagePdfIndex;
 
     /// PDF source id for each PDF page whose source is NOT the primary.
     /// Key: page UUID, Value: source id. Absence = primary source (empty id).
     /// Parallel to m_pagePdfIndex.
-    std::map<QString, QString> m_pagePdfSource;
+    mutable std::map<QString, QString> m_pagePdfSource;
+    
+    /// Memory-mapped pages.snpi of the loaded bundle. Open from loadBundle()
+    /// until the first operation that needs the full page tables; lookups by
+    /// position/uuid are answered from it directly in the meantime.
+    mutable PageIndex m_pageIndex;
+    
+    /// Delta log of the bundle at m_bundlePath: every page/tile read and
+    /// write goes through it (see PageJournal).
+    mutable PageJournal m_journal;
     
-    /// Currently loaded pages. Key: page UUID, Value: Page object.
+    /// Currently loaded pages. Key: page UUID (as Id128), Value: Page object.
     /// Mutable for lazy loading in const methods like page().
-    mutable std::map<QString, std::unique_ptr<Page>> m_loadedPages;
+    mutable std::map<Id128, std::unique_ptr<Page>> m_loadedPages;
     
     /// Pages that have been modified since last save.
-    mutable std::set<QString> m_dirtyPages;
+    mutable std::set<Id128> m_dirtyPages;
+    
+    /// Memory-mapped thumbnails.snth of m_bundlePath (paged mode).
+    ThumbnailStore m_thumbnails;
+    
+    /// Rendered thumbnail waiting for the next writeThumbnails().
+    struct PendingThumbnail {
+        int pixelWidth = 0;
+        bool pdfDarkMode = false;
+        QByteArray data;
+    };
+    std::map<Id128, PendingThumbnail> m_pendingThumbnails;
+    
+    /// Pages marked dirty since m_thumbnails was last written. Covers the
+    /// window in which a background save has cleared m_dirtyPages but not
+    /// yet written the pages.
+    std::set<Id128> m_staleThumbnails;
+    
+    /// Bumped by invalidateThumbnail(); the value each page was last
+    /// invalidated at (see storeThumbnail()).
+    quint64 m_thumbnailEpoch = 0;
+    std::map<Id128, quint64> m_thumbnailInvalidations;
+    
+    /// Per-page edit counter behind pageEditEpoch().
+    quint64 m_pageEditCounter = 0;
+    std::map<Id128, quint64> m_pageEdits;
     
     /// Pages that have been deleted and need cleanup on next save.
     std::set<QString> m_deletedPages;
     
+    /// Background save not yet applied (see saveBundleAsync()).
+    std::shared_ptr<BundleSaveJob> m_pendingSave;
+    
+    /// See lastSaveStallNs().
+    qint64 m_lastSaveStallNs = 0;
+    
     // ===== Tiles (Phase E1 - Edgeless Mode) =====
     /// Sparse 2D map of tiles for edgeless mode. Key = (tx, ty) tile coordinate.
     /// Uses std::map instead of QMap because QMap requires copyable values,
@@ -1904,6 +2164,8 @@ private:
     // ===== Tile Persistence (Phase E5) =====
     QString m_bundlePath;                           ///< Path to .snb bundle directory
     mutable std::set<TileCoord> m_tileIndex;        ///< All tile coords that exist on disk (mutable for lazy-load failure cleanup)
+    mutable std::map<TileCoord, quint64> m_tileLoadTickets;  ///< Latest tileDecoder() request per tile
+    mutable quint64 m_tileLoadTicketCounter = 0;
     mutable std::set<TileCoord> m_dirtyTiles;       ///< Tiles modified since last save
     std::set<TileCoord> m_deletedTiles;             ///< Tiles to delete from disk on next save
     bool m_lazyLoadEnabled = false;                 ///< True after loading from bundle
@@ -1947,7 +2209,7 @@ private:
     // ===== UUID→Index Cache (Phase C.0.2) =====
     /// Cached mapping from page UUID to index for O(1) lookups.
     /// Mutable for lazy rebuilding in const methods.
-    mutable QHash<QString, int> m_uuidToIndexCache;
+    mutable QHash<Id128, int> m_uuidToIndexCache;
     
     /// True if cache needs rebuilding (page order changed).
     mutable bool m_uuidCacheDirty = true;
@@ -1958,6 +2220,74 @@ private:
      */
     void rebuildUuidCache() const;
     
+    /**
+     * @brief pageIndexByUuid() for a key that is already an Id128
+     *        (iteration over m_loadedPages), without a text round trip.
+     */
+    int pageIndexByKey(const Id128& key) const;
+    
+    // ===== Page Index (pages.snpi) =====
+    
+    /**
+     * @brief Build m_pageOrder and the page metadata maps from the mapped
+     *        page index, then close it. No-op when the index is not open.
+     *
+     * Every code path that iterates or mutates the page tables calls this
+     * first; position/uuid/size lookups go through the helpers below instead.
+     */
+    void ensurePageTables() const;
+    
+    // ===== Bundle Saving =====
+    
+    /**
+     * @brief First half of saveBundle()/saveBundleAsync(): prepare the bundle
+     *        directory and build the manifest.
+     * @param indexStamp Receives the stamp to record for pages.snpi (paged
+     *        mode); the caller writes the index itself.
+     */
+    bool prepareBundleManifest(const QString& path, bool finalize, QJsonObject& manifest,
+                               std::set<TileCoord>& allTileCoords, quint64& indexStamp);
+    
+    /**
+     * @brief Container JSON of a tile plus the stroke lists of its saved
+     *        layers (see saveTile()).
+     */
+    QJsonObject tileJson(TileCoord coord, const Page* tile,
+                         QVector<const QVector<VectorStroke>*>& layerStrokes) const;
+    
+    /// Sidecar JSON for a page's OCR state; empty when there is none.
+    static QJsonObject ocrSidecarJson(const Page* page);
+    
+    /// Block until the background save's writes are on disk (lazy loads).
+    void waitForPendingSaveWrites() const;
+    
+    /**
+     * @brief Second half of loadTileFromDisk()/adoptDecodedTile(): load the
+     *        tile's image assets and insert it into m_tiles.
+     */
+    Page* insertLoadedTile(TileCoord coord, std::unique_ptr<Page> tile) const;
+    
+    /**
+     * @brief Fingerprint of page @p index as stored in the bundle: its file
+     *        (size, mtime), pending journal records and PDF binding.
+     */
+    quint64 pageContentStamp(int index) const;
+    
+    /// Flush m_pendingThumbnails of clean pages to thumbnails.snth.
+    void writeThumbnails();
+    
+    /// Forget a page's remembered thumbnail and hide its stored one.
+    void invalidateThumbnail(const Id128& key);
+    
+    /// Manifest size of page @p index (overrides, then index, then tables).
+    bool manifestPageSize(int index, QSizeF& size) const;
+    
+    /// Manifest PDF page of page @p index, or -1 if not PDF-backed.
+    int manifestPdfPage(int index) const;
+    
+    /// Manifest PDF source id of page @p index (empty = primary).
+    QString manifestPdfSource(int index) const;
+    
     /**
      * @brief CR-L13: Load all evicted tiles from disk into memory.
      * 
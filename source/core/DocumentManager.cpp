@@ -48,6 +48,7 @@ DocumentManager::~DocumentManager()
         // This is the same cleanup that closeDocument() does, but for
         // documents still open when the application quits.
         doc->cleanupOrphanedAssets();
+        doc->flushThumbnails();
         
         delete doc;
     }
@@ -321,6 +322,9 @@ void DocumentManager::closeDocument(Document* doc)
     // This deletes image files that are no longer referenced by any object.
     doc->cleanupOrphanedAssets();
     
+    // Keep thumbnails rendered this session, even if nothing was edited.
+    doc->flushThumbnails();
+    
     // Delete the document
     delete doc;
 }
@@ -678,10 +682,22 @@ void DocumentManager::cleanupTempBundle(Document* doc)
     }
 }
 
-int DocumentManager::autoSaveModifiedDocuments()
+int DocumentManager::autoSaveModifiedDocuments(bool background)
 {
     int savedCount = 0;
     
+    if (!background) {
+        // A background save started earlier (e.g. on Inactive) may still be
+        // writing, with its document already reported clean. Wait for it so
+        // the data is on disk before the process can be killed; pages whose
+        // write failed are marked modified again and get saved below.
+        for (Document* doc : m_documents) {
+            if (doc) {
+                doc->finishPendingSave();
+            }
+        }
+    }
+    
     for (Document* doc : m_documents) {
         if (!doc) continue;
         
@@ -714,8 +730,25 @@ int DocumentManager::autoSaveModifiedDocuments()
             }
         }
         
-        // Perform the save
-        if (doc->saveBundle(savePath)) {
+        // Perform the save. In background mode, in-place saves only snapshot
+        // the dirty pages here and write them on the bundle writer thread.
+        bool saved = false;
+        if (background && !isNewDocument) {
+            switch (doc->saveBundleAsync(savePath)) {
+            case Document::AsyncSaveResult::Started:
+                saved = true;
+                break;
+            case Document::AsyncSaveResult::Busy:
+                continue;  // Previous save still writing; the next one catches up
+            case Document::AsyncSaveResult::NotApplicable:
+                saved = doc->saveBundle(savePath);
+                break;
+            }
+        } else {
+            saved = doc->saveBundle(savePath);
+        }
+        
+        if (saved) {
             // Update document path if this was a new save location
             if (isNewDocument) {
                 m_documentPaths[doc] = savePath;
@@ -99,8 +99,14 @@ public:
      * This is designed for Android where the app may be killed without
      * closeEvent() when swiped from recents. Call this when the app
      * goes to background (ApplicationSuspended/ApplicationInactive).
+     * 
+     * @param background If true, documents already saved in-place use
+     *        Document::saveBundleAsync() so the GUI thread does not block on
+     *        disk I/O. Use false when the process may be killed right after
+     *        (ApplicationSuspended), since the write must be on disk; this
+     *        also waits for background saves started by an earlier call.
      */
-    int autoSaveModifiedDocuments();
+    int autoSaveModifiedDocuments(bool background = false);
 
     /**
      * @brief Load a document from a file.
@@ -11,14 +11,20 @@
 // - Bookmarks (set, remove, navigate)
 // - Serialization round-trip (toFullJson/fromFullJson)
 // - PDF reference (if PDF available)
+// - Mapped page index (pages.snpi) bundle round-trip and JSON fallback
+// - Background (snapshot + writer thread) bundle saving
+// - Page journal: delta saves, replay on load, torn tail, compaction
+// - Persistent thumbnails (thumbnails.snth): reuse, invalidation, pruning
 // ============================================================================
 
 #include "Document.h"
 #include "Page.h"
 #include <QDebug>
+#include <QDateTime>
 #include <QJsonDocument>
 #include <QFileInfo>
 #include <QImage>
+#include <QTemporaryDir>
 #include <cassert>
 
 namespace DocumentTests {
@@ -485,7 +491,7 @@ inline bool testSerializationRoundTrip()
     
     // Add strokes to pages
     VectorStroke stroke1;
-    stroke1.id = "stroke-001";
+    stroke1.id = Id128::fromString(QStringLiteral("stroke-001"));
     stroke1.color = Qt::red;
     stroke1.baseThickness = 3.0;
     stroke1.points.append({QPointF(10, 10), 0.5});
@@ -494,7 +500,7 @@ inline bool testSerializationRoundTrip()
     doc->page(0)->activeLayer()->addStroke(stroke1);
     
     VectorStroke stroke2;
-    stroke2.id = "stroke-002";
+    stroke2.id = Id128::fromString(QStringLiteral("stroke-002"));
     stroke2.color = Qt::blue;
     stroke2.baseThickness = 5.0;
     stroke2.points.append({QPointF(50, 100), 1.0});
@@ -595,7 +601,7 @@ inline bool testSerializationRoundTrip()
     }
     
     const auto& restoredStroke = restored->page(0)->activeLayer()->strokes()[0];
-    if (restoredStroke.id != "stroke-001") {
+    if (restoredStroke.id.toString() != "stroke-001") {
         qDebug() << "FAIL: stroke id mismatch:" << restoredStroke.id;
         success = false;
     }
@@ -1099,7 +1105,7 @@ inline bool testMovePage()
     
     // Add a stroke to page 1 to verify strokes follow pages
     VectorStroke testStroke;
-    testStroke.id = "move-test-stroke";
+    testStroke.id = Id128::fromString(QStringLiteral("move-test-stroke"));
     testStroke.color = Qt::green;
     testStroke.baseThickness = 2.0;
     testStroke.points.append({QPointF(10, 10), 0.5});
@@ -1161,7 +1167,7 @@ inline bool testMovePage()
     
     // The stroke should still be on what was originally page 1 (now at index 0)
     if (doc->page(0)->activeLayer()->strokeCount() != 1 ||
-        doc->page(0)->activeLayer()->strokes()[0].id != "move-test-stroke") {
+        doc->page(0)->activeLayer()->strokes()[0].id.toString() != "move-test-stroke") {
         qDebug() << "FAIL: Stroke did not follow page during move";
         success = false;
     }
@@ -1332,6 +1338,599 @@ inline bool testMovePage()
     return success;
 }
 
+/**
+ * @brief Test that a paged bundle reloads through the mapped page index.
+ * 
+ * Tests:
+ * - Page order, sizes and uuid lookups match after a save/load round-trip
+ * - Size changes made before the page tables are built survive a structural edit
+ * - A stale pages.snpi is ignored in favor of the JSON page table
+ */
+inline bool testPageIndexRoundTrip()
+{
+    qDebug() << "=== Test: Page index (pages.snpi) round-trip ===";
+    bool success = true;
+    
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: Could not create temporary directory";
+        return false;
+    }
+    const QString bundlePath = dir.filePath("index.snb");
+    QDir().mkpath(bundlePath);
+    
+    auto doc = Document::createNew("Page Index Test");
+    for (int i = 0; i < 5; ++i) {
+        doc->addPage();
+    }
+    doc->setPageSize(2, QSizeF(400, 300));
+    QStringList uuids;
+    for (int i = 0; i < doc->pageCount(); ++i) {
+        uuids.append(doc->pageUuidAt(i));
+    }
+    if (!doc->saveBundle(bundlePath)) {
+        qDebug() << "FAIL: saveBundle failed";
+        return false;
+    }
+    if (!QFile::exists(bundlePath + "/" + PageIndex::fileName())) {
+        qDebug() << "FAIL: pages.snpi was not written";
+        success = false;
+    }
+    
+    auto checkLoaded = [&](Document* loaded, const char* label) {
+        if (!loaded || loaded->pageCount() != uuids.size()) {
+            qDebug() << "FAIL:" << label << "page count mismatch";
+            return false;
+        }
+        bool ok = true;
+        for (int i = 0; i < uuids.size(); ++i) {
+            if (loaded->pageUuidAt(i) != uuids[i] || loaded->pageIndexByUuid(uuids[i]) != i) {
+                qDebug() << "FAIL:" << label << "uuid lookup mismatch at" << i;
+                ok = false;
+            }
+        }
+        if (loaded->pageSizeAt(2) != QSizeF(400, 300)) {
+            qDebug() << "FAIL:" << label << "page size not preserved";
+            ok = false;
+        }
+        return ok;
+    };
+    
+    auto loaded = Document::loadBundle(bundlePath);
+    success &= checkLoaded(loaded.get(), "mapped index:");
+    
+    if (loaded) {
+        // Overrides made while the index is mapped must outlive building the tables.
+        loaded->setPageSize(4, QSizeF(123, 456));
+        loaded->addPage();
+        if (loaded->pageCount() != uuids.size() + 1
+            || loaded->pageSizeAt(4) != QSizeF(123, 456)
+            || loaded->pageIndexByUuid(uuids.last()) != uuids.size() - 1) {
+            qDebug() << "FAIL: page tables inconsistent after first structural edit";
+            success = false;
+        }
+    }
+    loaded.reset();
+    
+    // Corrupt the index: loading must fall back to the JSON page table.
+    {
+        QFile indexFile(bundlePath + "/" + PageIndex::fileName());
+        if (indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            indexFile.write(QByteArray(64, 'x'));
+        }
+    }
+    auto fallback = Document::loadBundle(bundlePath);
+    success &= checkLoaded(fallback.get(), "JSON fallback:");
+    
+    if (success) {
+        qDebug() << "PASS: Page index round-trip";
+    }
+    return success;
+}
+
+/**
+ * @brief Test saveBundleAsync(): snapshot on the caller, write on the writer.
+ * 
+ * Tests:
+ * - Only in-place saves of an existing bundle run in the background
+ * - The snapshot clears dirty state; edits made afterwards stay dirty
+ * - The written bundle holds the snapshot, not the later edit
+ */
+inline bool testBackgroundSave()
+{
+    qDebug() << "=== Test: Background bundle save ===";
+    bool success = true;
+    
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: Could not create temporary directory";
+        return false;
+    }
+    const QString bundlePath = dir.filePath("async.snb");
+    QDir().mkpath(bundlePath);
+    
+    auto addStroke = [](Page* page, qreal y) {
+        VectorStroke stroke;
+        stroke.id = Id128::create();
+        stroke.color = Qt::black;
+        stroke.baseThickness = 2.0;
+        stroke.points.append({QPointF(10, y), 0.5});
+        stroke.points.append({QPointF(200, y + 20), 0.8});
+        stroke.updateBoundingBox();
+        page->layer(0)->addStroke(stroke);
+    };
+    
+    auto doc = Document::createNew("Background Save Test");
+    doc->addPage();
+    doc->addPage();
+    
+    if (doc->saveBundleAsync(bundlePath) != Document::AsyncSaveResult::NotApplicable) {
+        qDebug() << "FAIL: first save of a bundle should not run in the background";
+        success = false;
+    }
+    for (int i = 0; i < doc->pageCount(); ++i) {
+        addStroke(doc->page(i), 10);
+        doc->markPageDirty(i);
+    }
+    if (!doc->saveBundle(bundlePath)) {
+        qDebug() << "FAIL: saveBundle failed";
+        return false;
+    }
+    
+    addStroke(doc->page(1), 60);
+    doc->markPageDirty(1);
+    if (doc->saveBundleAsync(bundlePath) != Document::AsyncSaveResult::Started) {
+        qDebug() << "FAIL: in-place save did not start in the background";
+        return false;
+    }
+    if (doc->modified || doc->isPageDirty(1) || !doc->hasPendingSave()) {
+        qDebug() << "FAIL: snapshot did not take over the dirty state";
+        success = false;
+    }
+    
+    // Edit after the snapshot: not part of this save.
+    addStroke(doc->page(2), 110);
+    doc->markPageDirty(2);
+    doc->finishPendingSave();
+    if (doc->hasPendingSave() || !doc->isPageDirty(2) || !doc->modified) {
+        qDebug() << "FAIL: edit made during the background save was lost";
+        success = false;
+    }
+    qDebug() << "  Snapshot stall:" << doc->lastSaveStallNs() / 1000 << "us";
+    
+    auto loaded = Document::loadBundle(bundlePath);
+    if (!loaded || loaded->pageCount() != 3) {
+        qDebug() << "FAIL: could not reload bundle";
+        return false;
+    }
+    if (loaded->page(1)->layer(0)->strokeCount() != 2) {
+        qDebug() << "FAIL: background save did not write the snapshot";
+        success = false;
+    }
+    if (loaded->page(2)->layer(0)->strokeCount() != 1) {
+        qDebug() << "FAIL: background save wrote an edit made after the snapshot";
+        success = false;
+    }
+    
+    if (doc->saveBundleAsync(dir.filePath("elsewhere.snb")) != Document::AsyncSaveResult::NotApplicable) {
+        qDebug() << "FAIL: save to a new location should stay synchronous";
+        success = false;
+    }
+    
+    if (success) {
+        qDebug() << "PASS: Background bundle save";
+    }
+    return success;
+}
+
+/**
+ * @brief Test the page journal (journal.snj).
+ * 
+ * Tests:
+ * - A small edit to a saved page is journaled, leaving the page file as is
+ * - Layer-table/header changes travel with the delta
+ * - loadBundle() replays pending records; a torn tail is ignored
+ * - compactJournal() folds records into the page files
+ * - Deltas to a container stamped ahead of the clock are still replayed
+ */
+inline bool testPageJournal()
+{
+    qDebug() << "=== Test: Page journal ===";
+    bool success = true;
+    
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: Could not create temporary directory";
+        return false;
+    }
+    const QString bundlePath = dir.filePath("journal.snb");
+    QDir().mkpath(bundlePath);
+    
+    auto makeStroke = [](qreal y) {
+        VectorStroke stroke;
+        stroke.id = Id128::create();
+        stroke.color = Qt::blue;
+        stroke.baseThickness = 3.0;
+        for (int i = 0; i < 20; ++i) {
+            stroke.points.append({QPointF(10 + i * 5, y + (i % 3)), 0.5 + i * 0.01});
+        }
+        stroke.updateBoundingBox();
+        return stroke;
+    };
+    
+    auto doc = Document::createNew("Journal Test");
+    doc->addPage();
+    for (int i = 0; i < 200; ++i) {
+        doc->page(0)->layer(0)->addStroke(makeStroke(i * 4));
+    }
+    doc->markPageDirty(0);
+    doc->markPageDirty(1);
+    if (!doc->saveBundle(bundlePath)) {
+        qDebug() << "FAIL: saveBundle failed";
+        return false;
+    }
+    
+    const QString uuid0 = doc->pageUuidAt(0);
+    const QString page0File = bundlePath + "/pages/" + uuid0 + PageCodec::binarySuffix();
+    const QByteArray page0Bytes = [&] {
+        QFile f(page0File);
+        return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+    }();
+    
+    // Add one stroke, erase one, bookmark the other page.
+    const VectorStroke added = makeStroke(1000);
+    const Id128 erased = doc->page(0)->layer(0)->strokes().at(7).id;
+    doc->page(0)->layer(0)->addStroke(added);
+    doc->page(0)->layer(0)->removeStroke(erased);
+    doc->markPageDirty(0);
+    doc->page(1)->isBookmarked = true;
+    doc->markPageDirty(1);
+    if (!doc->saveBundle(bundlePath)) {
+        qDebug() << "FAIL: second saveBundle failed";
+        return false;
+    }
+    
+    if (doc->journal().pendingRecords() != 2) {
+        qDebug() << "FAIL: expected 2 journal records, got" << doc->journal().pendingRecords();
+        success = false;
+    }
+    {
+        QFile f(page0File);
+        if (!f.open(QIODevice::ReadOnly) || f.readAll() != page0Bytes) {
+            qDebug() << "FAIL: journaled save rewrote the page file";
+            success = false;
+        }
+    }
+    qDebug() << "  Journal size after delta save:" << doc->journal().sizeBytes()
+             << "bytes; page file:" << page0Bytes.size() << "bytes";
+    
+    auto checkLoaded = [&](Document* loaded, const char* label) {
+        if (!loaded || loaded->pageCount() != 2) {
+            qDebug() << "FAIL:" << label << "could not reload bundle";
+            return false;
+        }
+        bool ok = true;
+        const VectorLayer* layer = loaded->page(0)->layer(0);
+        bool hasAdded = false;
+        bool hasErased = false;
+        for (const VectorStroke& s : layer->strokes()) {
+            hasAdded |= (s.id == added.id);
+            hasErased |= (s.id == erased);
+        }
+        if (layer->strokeCount() != 200 || !hasAdded || hasErased
+            || layer->strokes().last().id != added.id) {
+            qDebug() << "FAIL:" << label << "stroke delta not replayed";
+            ok = false;
+        }
+        if (!loaded->page(1)->isBookmarked) {
+            qDebug() << "FAIL:" << label << "page header delta not replayed";
+            ok = false;
+        }
+        return ok;
+    };
+    
+    auto loaded = Document::loadBundle(bundlePath);
+    success &= checkLoaded(loaded.get(), "replay:");
+    loaded.reset();
+    
+    // A torn record at the end (crash mid-append) must not hide the rest.
+    {
+        QFile f(bundlePath + "/" + PageJournal::fileName());
+        if (f.open(QIODevice::Append)) {
+            f.write(QByteArray("\x40\x00\x00\x00partial", 11));
+        }
+    }
+    loaded = Document::loadBundle(bundlePath);
+    success &= checkLoaded(loaded.get(), "torn tail:");
+    
+    if (loaded && (!loaded->compactJournal() || loaded->journal().pendingRecords() != 0)) {
+        qDebug() << "FAIL: compactJournal did not fold the journal";
+        success = false;
+    }
+    loaded.reset();
+    loaded = Document::loadBundle(bundlePath);
+    success &= checkLoaded(loaded.get(), "compacted:");
+    if (loaded && loaded->journal().pendingRecords() != 0) {
+        qDebug() << "FAIL: records left after compaction";
+        success = false;
+    }
+    loaded.reset();
+    
+    // A container stamped ahead of the clock (copied from a machine whose
+    // clock ran fast): deltas appended after it must still be replayed.
+    {
+        const QString stem = bundlePath + "/pages/" + uuid0;
+        PageCodec::Container container;
+        if (!PageCodec::readFile(stem, container)) {
+            qDebug() << "FAIL: could not read page container";
+            return false;
+        }
+        const quint64 ahead = quint64(QDateTime::currentMSecsSinceEpoch() + 86400000) << 10;
+        container.meta["journalSeq"] = QString::number(ahead);
+        QVector<const QVector<VectorStroke>*> lists;
+        for (const QVector<VectorStroke>& strokes : container.layerStrokes) {
+            lists.append(&strokes);
+        }
+        if (!PageCodec::writeFile(stem, container.meta, lists)) {
+            qDebug() << "FAIL: could not restamp page container";
+            return false;
+        }
+    }
+    const VectorStroke late = makeStroke(1200);
+    loaded = Document::loadBundle(bundlePath);
+    if (loaded && loaded->pageCount() == 2) {
+        loaded->page(0)->layer(0)->addStroke(late);
+        loaded->markPageDirty(0);
+        if (!loaded->saveBundle(bundlePath) || loaded->journal().pendingRecords() != 1) {
+            qDebug() << "FAIL: edit of a future-stamped page was not journaled";
+            success = false;
+        }
+    }
+    loaded.reset();
+    loaded = Document::loadBundle(bundlePath);
+    if (!loaded || loaded->pageCount() != 2
+        || loaded->page(0)->layer(0)->strokes().last().id != late.id) {
+        qDebug() << "FAIL: delta after a future stamp was not replayed";
+        success = false;
+    }
+    
+    if (success) {
+        qDebug() << "PASS: Page journal";
+    }
+    return success;
+}
+
+/**
+ * @brief Test persistent page thumbnails (thumbnails.snth).
+ * 
+ * Tests:
+ * - Stored thumbnails are served after a reload while their page is unchanged
+ * - Width and PDF dark mode are part of the key
+ * - markPageDirty() hides a thumbnail; renders snapshotted before an edit
+ *   are not stored
+ * - A saved edit invalidates the thumbnail; removed pages are pruned
+ */
+inline bool testThumbnailStore()
+{
+    qDebug() << "=== Test: Persistent thumbnails ===";
+    bool success = true;
+    
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: Could not create temporary directory";
+        return false;
+    }
+    const QString bundlePath = dir.filePath("thumbs.snb");
+    QDir().mkpath(bundlePath);
+    
+    auto doc = Document::createNew("Thumbnail Test");
+    doc->addPage();
+    doc->addPage();
+    for (int i = 0; i < 3; ++i) {
+        doc->markPageDirty(i);
+    }
+    if (!doc->saveBundle(bundlePath)) {
+        qDebug() << "FAIL: saveBundle failed";
+        return false;
+    }
+    
+    const QByteArray thumb0("thumbnail-0");
+    const QByteArray thumb1("thumbnail-1");
+    const quint64 epoch = doc->thumbnailEpoch();
+    doc->storeThumbnail(doc->pageUuidAt(0), 150, false, thumb0, epoch);
+    doc->storeThumbnail(doc->pageUuidAt(1), 150, false, thumb1, epoch);
+    doc->storeThumbnail(doc->pageUuidAt(2), 150, false, QByteArray("thumbnail-2"), epoch);
+    if (doc->storedThumbnail(0, 150, false) != thumb0) {
+        qDebug() << "FAIL: pending thumbnail not served before flushing";
+        success = false;
+    }
+    doc->flushThumbnails();
+    if (!QFileInfo::exists(bundlePath + "/" + ThumbnailStore::fileName())) {
+        qDebug() << "FAIL: thumbnails.snth not written";
+        return false;
+    }
+    doc.reset();
+    
+    auto loaded = Document::loadBundle(bundlePath);
+    if (!loaded || loaded->pageCount() != 3) {
+        qDebug() << "FAIL: could not reload bundle";
+        return false;
+    }
+    if (loaded->storedThumbnail(0, 150, false) != thumb0
+        || loaded->storedThumbnail(1, 150, false) != thumb1) {
+        qDebug() << "FAIL: stored thumbnails not served after reload";
+        success = false;
+    }
+    if (!loaded->storedThumbnail(0, 300, false).isEmpty()
+        || !loaded->storedThumbnail(0, 150, true).isEmpty()) {
+        qDebug() << "FAIL: thumbnail served for a different width/mode";
+        success = false;
+    }
+    
+    // Edit page 0; a render snapshotted before the edit must not be kept.
+    const quint64 staleEpoch = loaded->thumbnailEpoch();
+    VectorStroke stroke;
+    stroke.id = Id128::create();
+    stroke.points.append({QPointF(10, 10), 0.5});
+    stroke.points.append({QPointF(50, 50), 0.5});
+    stroke.updateBoundingBox();
+    loaded->page(0)->layer(0)->addStroke(stroke);
+    loaded->markPageDirty(0);
+    loaded->storeThumbnail(loaded->pageUuidAt(0), 150, false, QByteArray("stale"), staleEpoch);
+    if (!loaded->storedThumbnail(0, 150, false).isEmpty()) {
+        qDebug() << "FAIL: thumbnail of an edited page still served";
+        success = false;
+    }
+    
+    // Saving the edit leaves page 0's entry unmatched; the next update
+    // replaces page 1's entry and drops the removed page's.
+    loaded->removePage(2);
+    if (!loaded->saveBundle(bundlePath)) {
+        qDebug() << "FAIL: second saveBundle failed";
+        return false;
+    }
+    loaded->storeThumbnail(loaded->pageUuidAt(1), 150, true, QByteArray("dark-1"),
+                           loaded->thumbnailEpoch());
+    loaded->flushThumbnails();
+    loaded.reset();
+    
+    loaded = Document::loadBundle(bundlePath);
+    if (!loaded || loaded->pageCount() != 2) {
+        qDebug() << "FAIL: could not reload edited bundle";
+        return false;
+    }
+    if (!loaded->storedThumbnail(0, 150, false).isEmpty()) {
+        qDebug() << "FAIL: thumbnail survived a saved edit";
+        success = false;
+    }
+    if (loaded->storedThumbnail(1, 150, true) != "dark-1") {
+        qDebug() << "FAIL: incremental update lost the new entry";
+        success = false;
+    }
+    
+    ThumbnailStore store;
+    if (!store.open(bundlePath + "/" + ThumbnailStore::fileName())
+        || store.entryCount() != 2) {
+        qDebug() << "FAIL: removed page not pruned; entries:" << store.entryCount();
+        success = false;
+    }
+    
+    if (success) {
+        qDebug() << "PASS: Persistent thumbnails";
+    }
+    return success;
+}
+
+/**
+ * @brief Test asynchronous edgeless tile loading (tileDecoder()/adoptDecodedTile()).
+ * 
+ * Tests:
+ * - A decoded tile is adopted with its strokes, OCR-free, and its
+ *   pre-rendered stroke cache installed
+ * - loadedTile() never loads from disk
+ * - A result overtaken by a synchronous load is rejected
+ * - A superseded request is rejected; the newer one is adopted
+ */
+inline bool testAsyncTileLoad()
+{
+    qDebug() << "=== Test: Asynchronous tile loading ===";
+    bool success = true;
+    
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: Could not create temporary directory";
+        return false;
+    }
+    const QString bundlePath = dir.filePath("tiles.snb");
+    QDir().mkpath(bundlePath);
+    
+    const Document::TileCoord a(0, 0);
+    const Document::TileCoord b(1, 0);
+    const Document::TileCoord c(0, 1);
+    {
+        auto doc = Document::createNew("Async Tile Test", Document::Mode::Edgeless);
+        for (const auto& coord : {a, b, c}) {
+            Page* tile = doc->getOrCreateTile(coord.first, coord.second);
+            for (int i = 0; i < 5; ++i) {
+                VectorStroke stroke;
+                stroke.id = Id128::create();
+                stroke.color = Qt::black;
+                stroke.baseThickness = 2.0;
+                stroke.points.append({QPointF(10, 20 + i * 30), 0.5});
+                stroke.points.append({QPointF(600, 40 + i * 30), 0.8});
+                stroke.updateBoundingBox();
+                tile->layer(0)->addStroke(stroke);
+            }
+            doc->markTileDirty(coord);
+        }
+        if (!doc->saveBundle(bundlePath)) {
+            qDebug() << "FAIL: saveBundle failed";
+            return false;
+        }
+    }
+    
+    auto doc = Document::loadBundle(bundlePath);
+    if (!doc || !doc->tileExistsOnDisk(a) || doc->isTileLoaded(a)) {
+        qDebug() << "FAIL: could not reload bundle lazily";
+        return false;
+    }
+    
+    // Decode as a worker would (the function touches no Document state).
+    auto decodeA = doc->tileDecoder(a, 0.5, 1.0);
+    if (!decodeA) {
+        qDebug() << "FAIL: no decoder for a tile on disk";
+        return false;
+    }
+    auto decodedA = decodeA();
+    if (doc->loadedTile(a)) {
+        qDebug() << "FAIL: loadedTile() loaded from disk";
+        success = false;
+    }
+    if (!decodedA || !decodedA->tile || decodedA->strokeCaches.isEmpty()) {
+        qDebug() << "FAIL: decoding tile" << a.first << a.second;
+        return false;
+    }
+    if (!doc->adoptDecodedTile(*decodedA)) {
+        qDebug() << "FAIL: fresh decoded tile was not adopted";
+        success = false;
+    }
+    Page* tileA = doc->loadedTile(a);
+    if (!tileA || tileA->layer(0)->strokeCount() != 5 || !tileA->layer(0)->isCacheValidForZoom(0.5)) {
+        qDebug() << "FAIL: adopted tile lacks strokes or its stroke cache";
+        success = false;
+    }
+    if (doc->tileDecoder(a)) {
+        qDebug() << "FAIL: decoder offered for a loaded tile";
+        success = false;
+    }
+    
+    // A synchronous load overtakes the request in flight.
+    auto decodeB = doc->tileDecoder(b);
+    auto decodedB = decodeB();
+    doc->getTile(b.first, b.second);
+    if (doc->adoptDecodedTile(*decodedB)) {
+        qDebug() << "FAIL: result overtaken by a synchronous load was adopted";
+        success = false;
+    }
+    
+    // Only the newest request for a tile counts.
+    auto staleC = doc->tileDecoder(c)();
+    auto freshC = doc->tileDecoder(c)();
+    if (doc->adoptDecodedTile(*staleC) || !doc->adoptDecodedTile(*freshC)) {
+        qDebug() << "FAIL: superseded request handling";
+        success = false;
+    }
+    if (!doc->loadedTile(c) || doc->loadedTile(c)->layer(0)->strokeCount() != 5) {
+        qDebug() << "FAIL: tile" << c.first << c.second << "not loaded with its strokes";
+        success = false;
+    }
+    
+    if (success) {
+        qDebug() << "PASS: Asynchronous tile loading";
+    }
+    return success;
+}
+
 /**
  * @brief Run all Document tests.
  * @return True if all tests pass.
@@ -1368,6 +1967,21 @@ inline bool runAllTests()
     allPass &= testActualPdfLoad();
     qDebug() << "";
     
+    allPass &= testPageIndexRoundTrip();
+    qDebug() << "";
+    
+    allPass &= testBackgroundSave();
+    qDebug() << "";
+    
+    allPass &= testPageJournal();
+    qDebug() << "";
+    
+    allPass &= testThumbnailStore();
+    qDebug() << "";
+    
+    allPass &= testAsyncTileLoad();
+    qDebug() << "";
+    
     qDebug() << "\n========================================";
     if (allPass) {
         qDebug() << "ALL DOCUMENT TESTS PASSED!";
@@ -32,6 +32,7 @@
 #include <QThreadStorage> // For thread-local PDF provider caching
 #include <cmath>      // For std::floor, std::ceil
 #include <algorithm>  // For std::remove_if
+#include <utility>    // For std::as_const
 #include <limits>
 #include <climits>    // For INT_MIN (Phase O3.5.5: affinity filtering)
 #include <set>        // For touched-container tracking (Phase M.9)
@@ -191,6 +192,11 @@ DocumentViewport::DocumentViewport(QWidget* parent)
     m_scrollSettleTimer->setInterval(SCROLL_SETTLE_MS);
     connect(m_scrollSettleTimer, &QTimer::timeout, this, &DocumentViewport::onScrollSettled);
     
+    // Edgeless tile loads run on their own small pool so prefetching never
+    // queues behind PDF renders on the global pool (and vice versa).
+    m_tileLoadPool.setMaxThreadCount(2);
+    m_panVelocityClock.start();
+    
     // Gesture timeout timer - fallback for detecting gesture end (zoom or pan)
     m_gestureTimeoutTimer = new QTimer(this);
     m_gestureTimeoutTimer->setSingleShot(true);
@@ -276,7 +282,7 @@ DocumentViewport::~DocumentViewport()
     
     // Wait for and clean up any active async PDF watchers.
     // Must happen before clearing caches or m_document pointer, since the
-    // finished-signal handlers access m_activePdfWatchers and m_pdfCacheMutex.
+    // finished-signal handlers access m_activePdfWatchers and m_pdfTileCache.
     cancelAndWaitForBackgroundThreads();
     
     // Clear gesture cached frame (releases memory)
@@ -290,11 +296,7 @@ DocumentViewport::~DocumentViewport()
     // 3. Any circular references are broken
     
     // Clear PDF cache (can be several MB for multi-page documents)
-    {
-        QMutexLocker locker(&m_pdfCacheMutex);
-        m_pdfCache.clear();
-        m_pdfCache.squeeze();  // Release excess capacity
-    }
+    m_pdfTileCache.clear();
     
     // Clear selection/drag snapshot caches (can be full viewport-sized pixmaps)
     m_selectionBackgroundSnapshot = QPixmap();
@@ -354,6 +356,11 @@ void DocumentViewport::setDocument(Document* doc)
     m_undoStack.clear();
     m_redoStack.clear();
     
+    // Background tile loads read the old document
+    cancelTileLoads();
+    m_panVelocity = QPointF();
+    m_lastTrackedPanMs = -1;
+    
     m_document = doc;
     
     // Emit selection changed signal after document change
@@ -993,14 +1000,10 @@ void DocumentViewport::setZoomLevel(qreal zoom)
         m_focusRebuildTimer->start(150);
     }
 
-    qreal oldDpi = effectivePdfDpi();
     m_zoomLevel = zoom;
-    qreal newDpi = effectivePdfDpi();
     
-    // Invalidate PDF cache if DPI changed significantly (Task 1.3.6)
-    if (!qFuzzyCompare(oldDpi, newDpi)) {
-        invalidatePdfCache();
-    }
+    // No PDF cache invalidation: tiles are keyed by resolution level, so the
+    // old level keeps serving as a stand-in until the new one is rendered.
     
     // Note: Stroke caches are zoom-aware and will rebuild automatically
     // when ensureStrokeCacheValid() is called with the new zoom level.
@@ -2398,6 +2401,13 @@ void DocumentViewport::paintEvent(QPaintEvent* event)
         m_paintTimestamps.push_back(m_benchmarkTimer.elapsed());
     }
     
+    // Edgeless: keep background tile loads ahead of the view. Runs before the
+    // gesture fast path, which keeps showing a cached frame while they stream in.
+    if (m_document && m_document->isEdgeless()) {
+        trackPanVelocity();
+        scheduleTileLoads();
+    }
+    
     QPainter painter(this);
     // Note: Antialiasing is deferred until after gesture fast paths.
     // Gesture paths only blit cached pixmaps and don't need it.
@@ -3735,8 +3745,7 @@ void DocumentViewport::endZoomGesture()
     m_zoomLevel = finalZoom;
     m_panOffset = newPan;
     
-    // Invalidate PDF cache (DPI changed)
-    invalidatePdfCache();
+    // PDF tiles of the previous level stay cached as stand-ins (Task 1.3.6)
     
     // Clamp and emit signals
     clampPanOffset();
@@ -3998,108 +4007,316 @@ bool DocumentViewport::event(QEvent* event)
 
 // ===== PDF Cache Helpers (Task 1.3.6) =====
 
-QPixmap DocumentViewport::lookupCachedPdfPage(const QString& sourceId, int pageIndex, qreal dpi) const
+PdfPageRaster DocumentViewport::pdfRasterForPage(const Page* page, qreal dpi) const
 {
-    if (!m_document) {
-        return QPixmap();
+    PdfPageRaster raster;
+    if (!m_document || !page || page->backgroundType != Page::BackgroundType::PDF
+        || page->pdfPageNumber < 0) {
+        return raster;
+    }
+
+    // Each page resolves against its own PDF source (multi-source documents).
+    // Skip pages whose source is missing or doesn't have this page.
+    PdfProvider* prov = m_document->providerForSource(page->pdfSourceId);
+    const int resolvedPage = m_document->resolveSourcePageIndex(page->pdfSourceId,
+                                                                page->pdfPageNumber);
+    if (!prov || !prov->isValid() || resolvedPage < 0 || resolvedPage >= prov->pageCount()) {
+        return raster;
+    }
+
+    raster.sourceId = page->pdfSourceId;
+    raster.pageIndex = page->pdfPageNumber;
+    raster.level = PdfTileCache::levelForDpi(dpi);
+    raster.pagePts = prov->pageSize(resolvedPage);
+    raster.pageRect = QRectF(QPointF(0, 0), page->size);
+    return raster;
+}
+
+QVector<QPoint> DocumentViewport::lookupCachedPdfPage(QPainter& painter, const PdfPageRaster& raster,
+                                                      const QRectF& visibleRect,
+                                                      QVector<QPoint>* uncovered)
+{
+    // Cache-only (SP2): never renders, so it is safe on the paint path while
+    // scrolling. Missing target tiles get the nearest cached stand-in level.
+    QVector<QPoint> missing;
+    const int level = raster.level;
+    const QVector<QPoint> tiles = PdfTileCache::tilesCovering(
+        raster.pixelSize(level), raster.pixelRectForPageRect(level, visibleRect));
+
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    for (const QPoint& t : tiles) {
+        const QPixmap tile = m_pdfTileCache.find({ raster.sourceId, raster.pageIndex, level, t.x(), t.y() });
+        if (!tile.isNull()) {
+            painter.drawPixmap(raster.tileRectInPage(level, t.x(), t.y()), tile, QRectF(tile.rect()));
+            continue;
+        }
+        missing.append(t);
+        if (!drawPdfTileFallback(painter, raster, t.x(), t.y()) && uncovered) {
+            uncovered->append(t);
+        }
     }
+    painter.restore();
+    return missing;
+}
+
+bool DocumentViewport::drawPdfTileFallback(QPainter& painter, const PdfPageRaster& raster,
+                                           int tx, int ty)
+{
+    const QRectF target = raster.tileRectInPage(raster.level, tx, ty);
+    const int maxLevel = PdfTileCache::levelForDpi(PdfTileCache::MAX_DPI);
+
+    // Nearest level first; at equal distance prefer the sharper one
+    // (downscaling looks better than upscaling).
+    for (int d = 1; d <= PdfTileCache::MAX_FALLBACK_LEVEL_DISTANCE; ++d) {
+        for (int level : { raster.level + d, raster.level - d }) {
+            if (level > maxLevel) {
+                continue;  // Never rendered: levels above the DPI cap alias maxLevel
+            }
+            const QVector<QPoint> tiles = PdfTileCache::tilesCovering(
+                raster.pixelSize(level), raster.pixelRectForPageRect(level, target));
+            if (tiles.isEmpty()) {
+                continue;
+            }
+
+            // Only use a level that covers the whole target tile; a patchwork
+            // of levels flickers as tiles arrive.
+            QVector<QPixmap> found;
+            found.reserve(tiles.size());
+            for (const QPoint& t : tiles) {
+                const QPixmap tile = m_pdfTileCache.find({ raster.sourceId, raster.pageIndex, level, t.x(), t.y() });
+                if (tile.isNull()) {
+                    break;
+                }
+                found.append(tile);
+            }
+            if (found.size() != tiles.size()) {
+                continue;
+            }
 
-    // Thread-safe cache lookup. Never renders (SP2): safe on the paint path
-    // while scrolling.
-    QMutexLocker locker(&m_pdfCacheMutex);
-    for (const PdfCacheEntry& entry : m_pdfCache) {
-        if (entry.matches(sourceId, pageIndex, dpi)) {
-            return entry.pixmap;  // Cache hit
+            painter.save();
+            painter.setClipRect(target, Qt::IntersectClip);
+            for (int i = 0; i < tiles.size(); ++i) {
+                painter.drawPixmap(raster.tileRectInPage(level, tiles[i].x(), tiles[i].y()),
+                                   found[i], QRectF(found[i].rect()));
+            }
+            painter.restore();
+            return true;
         }
     }
-    return QPixmap();  // Miss - caller decides whether to render synchronously
+    return false;
 }
 
-QPixmap DocumentViewport::getCachedPdfPage(const QString& sourceId, int pageIndex, qreal dpi)
+void DocumentViewport::getCachedPdfPage(QPainter& painter, const PdfPageRaster& raster,
+                                        const QRectF& visibleRect)
 {
     if (!m_document) {
-        return QPixmap();
+        return;
     }
-    
-    // Fast path: return the cached pixmap if present (no render).
-    QPixmap cached = lookupCachedPdfPage(sourceId, pageIndex, dpi);
-    if (!cached.isNull()) {
-        return cached;
+
+    QVector<QPoint> uncovered;
+    const QVector<QPoint> missing = lookupCachedPdfPage(painter, raster, visibleRect, &uncovered);
+    if (missing.isEmpty()) {
+        return;  // Everything visible is cached at the target level
     }
-    
-    // Cache miss - render synchronously (for visible pages that MUST be shown).
-    // This should only happen on first paint of a new page (settled state).
-    // The expensive render runs without holding the cache mutex; we lock only
-    // to insert the result below.
-    
+
+    const int level = raster.level;
+    const QSize pagePx = raster.pixelSize(level);
+
+    // Tiles with nothing to show must be rendered now (first paint of a new
+    // page): render their bounding region in one call, then draw them.
+    if (!uncovered.isEmpty()) {
+        QRect region;
+        for (const QPoint& t : std::as_const(uncovered)) {
+            region |= PdfTileCache::tilePixelRect(pagePx, t.x(), t.y());
+        }
+
 #ifdef SPEEDYNOTE_DEBUG
-    // Build cache contents string for debug
-    QString cacheContents;
-    {
-        QMutexLocker debugLocker(&m_pdfCacheMutex);
-        for (const PdfCacheEntry& e : m_pdfCache) {
-            if (!cacheContents.isEmpty()) cacheContents += ",";
-            cacheContents += QString::number(e.pageIndex);
+        qDebug() << "PDF CACHE MISS: rendering page" << raster.pageIndex
+                 << "level" << level << "tiles" << uncovered.size() << "region" << region
+                 << "| cache" << m_pdfTileCache.tileCount() << "tiles,"
+                 << (m_pdfTileCache.bytesUsed() >> 20) << "/"
+                 << (m_pdfTileCache.budgetBytes() >> 20) << "MB";
+#endif
+
+        QImage image = m_document->renderPdfPageRegionToImage(
+            raster.sourceId, raster.pageIndex, PdfTileCache::dpiForLevel(level), region);
+        if (!image.isNull()) {
+            insertPdfTiles(raster, std::move(image), region);
+            m_document->trimPdfStore();
+
+            painter.save();
+            painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+            for (const QPoint& t : std::as_const(uncovered)) {
+                const QPixmap tile = m_pdfTileCache.find({ raster.sourceId, raster.pageIndex, level, t.x(), t.y() });
+                if (!tile.isNull()) {
+                    painter.drawPixmap(raster.tileRectInPage(level, t.x(), t.y()), tile, QRectF(tile.rect()));
+                }
+            }
+            painter.restore();
         }
     }
-    qDebug() << "PDF CACHE MISS: rendering page" << pageIndex 
-             << "| cache has [" << cacheContents << "] capacity=" << m_pdfCacheCapacity;
-#endif
-    
-    // Render the page (expensive operation - done outside mutex)
-    QImage pdfImage = m_document->renderPdfPageToImage(sourceId, pageIndex, dpi);
-    if (pdfImage.isNull()) {
-        return QPixmap();
+
+    // Tiles currently shown from another level refine in the background.
+    QVector<QPoint> deferred;
+    for (const QPoint& t : missing) {
+        if (!uncovered.contains(t)) {
+            deferred.append(t);
+        }
+    }
+    requestPdfTiles(raster, deferred);
+}
+
+void DocumentViewport::insertPdfTiles(const PdfPageRaster& raster, QImage image, const QRect& region)
+{
+    if (!m_document || image.isNull()) {
+        return;
     }
 
-    // Apply HSL lightness inversion for PDF dark mode
+    const int level = raster.level;
+    const qreal dpi = PdfTileCache::dpiForLevel(level);
+
+    // Apply HSL lightness inversion for PDF dark mode. Image regions come in
+    // full-page pixels; shift them into the rendered region.
     if (m_isDarkMode && m_pdfDarkModeEnabled) {
         QVector<QRect> imgRegions;
         if (!m_skipImageMasking) {
-            imgRegions = m_document->pdfImageRegions(sourceId, pageIndex, dpi);
+            const QVector<QRect> pageRegions = m_document->pdfImageRegions(raster.sourceId, raster.pageIndex, dpi);
+            for (const QRect& r : pageRegions) {
+                const QRect local = r.translated(-region.topLeft()).intersected(image.rect());
+                if (!local.isEmpty()) {
+                    imgRegions.append(local);
+                }
+            }
         }
-        DarkModeUtils::invertImageLightness(pdfImage, imgRegions);
+        DarkModeUtils::invertImageLightness(image, imgRegions);
     }
-    
-    m_document->trimPdfStore();
-    
-    QPixmap pixmap = QPixmap::fromImage(pdfImage);
-    
-    // Add to cache (thread-safe)
-    QMutexLocker locker(&m_pdfCacheMutex);
-    
-    // Double-check it wasn't added by another thread while we were rendering
-    for (const PdfCacheEntry& entry : m_pdfCache) {
-        if (entry.matches(sourceId, pageIndex, dpi)) {
-            return entry.pixmap;  // Another thread added it
+
+    // SAFE: QPixmap::fromImage on main thread
+    const QSize pagePx = raster.pixelSize(level);
+    const QVector<QPoint> tiles = PdfTileCache::tilesCovering(pagePx, region);
+    for (const QPoint& t : tiles) {
+        const QRect tileRect = PdfTileCache::tilePixelRect(pagePx, t.x(), t.y());
+        if (!region.contains(tileRect)) {
+            continue;  // Partially rendered tile - leave it to a full render
+        }
+        // The provider may round the page one pixel smaller than pagePixelSize()
+        // predicts; clip so the copy never picks up out-of-image (black) pixels.
+        const QRect src = tileRect.translated(-region.topLeft()).intersected(image.rect());
+        if (src.isEmpty()) {
+            continue;
         }
+        m_pdfTileCache.insert({ raster.sourceId, raster.pageIndex, level, t.x(), t.y() },
+                              QPixmap::fromImage(image.copy(src)));
     }
-    
-    PdfCacheEntry entry;
-    entry.sourceId = sourceId;
-    entry.pageIndex = pageIndex;
-    entry.dpi = dpi;
-    entry.pixmap = pixmap;
-    
-    // If cache is full, evict the page FURTHEST from current page (smart eviction)
-    // This prevents evicting pages we're about to need (like the next visible page)
-    if (m_pdfCache.size() >= m_pdfCacheCapacity) {
-        int evictIndex = 0;
-        int maxDistance = -1;
-        for (int i = 0; i < m_pdfCache.size(); ++i) {
-            int distance = qAbs(m_pdfCache[i].pageIndex - pageIndex);
-            if (distance > maxDistance) {
-                maxDistance = distance;
-                evictIndex = i;
-            }
+}
+
+void DocumentViewport::requestPdfTiles(const PdfPageRaster& raster, const QVector<QPoint>& tiles)
+{
+    if (!m_document || tiles.isEmpty()) {
+        return;
+    }
+
+    const int level = raster.level;
+    const QSize pagePx = raster.pixelSize(level);
+
+    QVector<PdfTileKey> keys;
+    QRect region;
+    for (const QPoint& t : tiles) {
+        const PdfTileKey key{ raster.sourceId, raster.pageIndex, level, t.x(), t.y() };
+        if (m_pendingPdfTiles.contains(key) || m_pdfTileCache.contains(key)) {
+            continue;
         }
-        m_pdfCache.removeAt(evictIndex);
+        keys.append(key);
+        region |= PdfTileCache::tilePixelRect(pagePx, t.x(), t.y());
     }
-    
-    m_pdfCache.append(entry);
-    m_cachedDpi = dpi;
-    
-    return pixmap;
+    if (keys.isEmpty()) {
+        return;  // All cached or already in flight
+    }
+
+    // renderPageNum is the index the provider actually uses: for a bundled source
+    // it is the compact mini-PDF index (via pageMap); otherwise it equals pageIndex.
+    const QString pdfPath = m_document->pdfPathForSource(raster.sourceId);
+    if (pdfPath.isEmpty()) {
+        return;  // Source unavailable
+    }
+    const int renderPageNum = m_document->resolveSourcePageIndex(raster.sourceId, raster.pageIndex);
+    if (renderPageNum < 0) {
+        return;  // Bundled source without this page mapped
+    }
+
+    for (const PdfTileKey& key : std::as_const(keys)) {
+        m_pendingPdfTiles.insert(key);
+    }
+
+    // Requests always target the current zoom; anything still queued for
+    // another level is now stale.
+    m_pdfWantedLevel->store(level);
+
+    const qreal dpi = PdfTileCache::dpiForLevel(level);
+    QFutureWatcher<QImage>* watcher = new QFutureWatcher<QImage>(this);
+
+    // Track watcher for cleanup
+    m_activePdfWatchers.append(watcher);
+
+    // THREAD SAFETY FIX: QPixmap must only be created on the main thread.
+    // The background thread returns QImage, and we split it into tile
+    // pixmaps here in the finished handler which runs on the main thread.
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, raster, keys, region]() {
+        // BUG-A006 FIX: Check if watcher was cancelled (e.g., by invalidatePdfCache)
+        // This happens when document/page changes while render is in progress
+        m_activePdfWatchers.removeOne(watcher);
+
+        bool wasCancelled = watcher->isCanceled();
+        QImage pdfImage;
+        if (!wasCancelled) {
+            pdfImage = watcher->result();
+        }
+        delete watcher;
+
+        if (wasCancelled) {
+            return;  // invalidatePdfCache() already dropped the pending keys
+        }
+
+        for (const PdfTileKey& key : keys) {
+            m_pendingPdfTiles.remove(key);
+        }
+
+        // Failed, skipped as stale, or the document went away meanwhile
+        if (pdfImage.isNull() || !m_document) {
+            return;
+        }
+
+        insertPdfTiles(raster, std::move(pdfImage), region);
+
+        // Trigger repaint to show the refined tiles
+        update();
+    });
+
+    // Background thread: render PDF region to QImage (thread-safe)
+    // NOTE: QImage is explicitly documented as thread-safe for read operations
+    // and can be safely passed between threads.
+    std::shared_ptr<std::atomic<int>> wantedLevel = m_pdfWantedLevel;
+    QFuture<QImage> future = QtConcurrent::run([renderPageNum, dpi, pdfPath, region, level, wantedLevel]() -> QImage {
+        if (wantedLevel->load() != level) {
+            return QImage();  // Zoomed away while queued
+        }
+
+        // Use thread-local cached PDF provider to avoid re-opening the PDF
+        // for every render. Each thread pool worker caches its own provider
+        // (keyed by resolved source path).
+        ThreadPdfCache& cache = s_threadPdfCache.localData();
+        PdfProvider* threadPdf = cache.getOrCreate(pdfPath);
+        if (!threadPdf || !threadPdf->isValid()) {
+            return QImage();  // Return null image on failure
+        }
+
+        QImage result = threadPdf->renderPageRegionToImage(renderPageNum, dpi, region);
+        threadPdf->trimStore();
+        return result;
+    });
+
+    watcher->setFuture(future);
 }
 
 void DocumentViewport::preloadPdfCache()
@@ -4133,167 +4350,66 @@ void DocumentViewport::doAsyncPdfPreload()
     int preloadStart = qMax(0, first - preloadBuffer);
     int preloadEnd = qMin(m_document->pageCount() - 1, last + preloadBuffer);
     
-    qreal dpi = effectivePdfDpi();
-    
-    // Collect (sourceId, pdfPageNum) pairs that need preloading, resolving each page
-    // to its own PDF source so multi-source documents preload the correct backgrounds.
-    // renderPageNum is the index the provider actually uses: for a bundled source it
-    // is the compact mini-PDF index (via pageMap); otherwise it equals pdfPageNum.
-    struct PreloadItem { QString sourceId; int pdfPageNum; int renderPageNum; QString path; };
-    QList<PreloadItem> pagesToPreload;
-    {
-        QMutexLocker locker(&m_pdfCacheMutex);
+    const qreal dpi = effectivePdfDpi();
+
+    // Tiles are preloaded for the viewport extended by one screen above and
+    // below: exactly what the next scroll will uncover, instead of whole
+    // neighbouring pages at full resolution.
+    const QRectF view = visibleRect();
+    const QRectF preloadArea = view.adjusted(0, -view.height(), 0, view.height());
+
+    // Two passes so the thread pool (FIFO) finishes what is on screen first:
+    // visible parts of visible pages, then the surrounding area.
+    for (int pass = 0; pass < 2; ++pass) {
+        const QRectF area = (pass == 0) ? view : preloadArea;
         for (int i = preloadStart; i <= preloadEnd; ++i) {
-            Page* page = m_document->page(i);
-            if (!page || page->backgroundType != Page::BackgroundType::PDF) {
+            if (pass == 0 && !visible.contains(i)) {
                 continue;
             }
-            int pdfPageNum = page->pdfPageNumber;
-            const QString sourceId = page->pdfSourceId;
-            
-            // Check if already cached
-            bool alreadyCached = false;
-            for (const PdfCacheEntry& entry : m_pdfCache) {
-                if (entry.matches(sourceId, pdfPageNum, dpi)) {
-                    alreadyCached = true;
-                    break;
-                }
-            }
-            if (alreadyCached) {
+            const PdfPageRaster raster = pdfRasterForPage(m_document->page(i), dpi);
+            if (!raster.isValid()) {
                 continue;
             }
-            
-            QString path = m_document->pdfPathForSource(sourceId);
-            if (path.isEmpty()) {
-                continue;  // Source unavailable (will render placeholder synchronously)
-            }
-            const int renderPageNum = m_document->resolveSourcePageIndex(sourceId, pdfPageNum);
-            if (renderPageNum < 0) {
-                continue;  // Bundled source without this page mapped
+            const QRectF pageArea = area.translated(-pagePosition(i)).intersected(raster.pageRect);
+            if (pageArea.isEmpty()) {
+                continue;
             }
-            pagesToPreload.append({ sourceId, pdfPageNum, renderPageNum, path });
+            requestPdfTiles(raster, PdfTileCache::tilesCovering(
+                raster.pixelSize(raster.level), raster.pixelRectForPageRect(raster.level, pageArea)));
         }
     }
-    
-    if (pagesToPreload.isEmpty()) {
-        return;  // All pages already cached
-    }
-    
-    // Launch async render for each page that needs caching
-    for (const PreloadItem& item : pagesToPreload) {
-        const QString sourceId = item.sourceId;
-        const int pdfPageNum = item.pdfPageNum;
-        const int renderPageNum = item.renderPageNum;
-        const QString pdfPath = item.path;
-        QFutureWatcher<QImage>* watcher = new QFutureWatcher<QImage>(this);
-        
-        // Track watcher for cleanup
-        m_activePdfWatchers.append(watcher);
-        
-        // THREAD SAFETY FIX: QPixmap must only be created on the main thread.
-        // The background thread returns QImage, and we convert to QPixmap here
-        // in the finished handler which runs on the main thread.
-        connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, sourceId, pdfPageNum, dpi]() {
-            // BUG-A006 FIX: Check if watcher was cancelled (e.g., by invalidatePdfCache)
-            // This happens when document/page changes while render is in progress
-            m_activePdfWatchers.removeOne(watcher);
-            
-            bool wasCancelled = watcher->isCanceled();
-            QImage pdfImage;
-            if (!wasCancelled) {
-                pdfImage = watcher->result();
-            }
-            delete watcher;
-            
-            if (wasCancelled) {
-                return;
-            }
-            
-            // Check if rendering failed
-            if (pdfImage.isNull()) {
-                return;
-            }
-            
-            // Guard against document changing between render start and signal delivery
-            if (!m_document) {
-                return;
-            }
 
-            // Apply HSL lightness inversion for PDF dark mode
-            if (m_isDarkMode && m_pdfDarkModeEnabled) {
-                QVector<QRect> imgRegions;
-                if (!m_skipImageMasking) {
-                    imgRegions = m_document->pdfImageRegions(sourceId, pdfPageNum, dpi);
-                }
-                DarkModeUtils::invertImageLightness(pdfImage, imgRegions);
+    // Text layouts for the same pages (visible first), so selecting or
+    // highlighting on any of them does not wait for text extraction. Grouped
+    // per PDF source; each provider extracts on its own background thread.
+    QHash<QString, QVector<int>> textPages;
+    QStringList textSources;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = preloadStart; i <= preloadEnd; ++i) {
+            if (visible.contains(i) != (pass == 0)) {
+                continue;
             }
-
-            // SAFE: QPixmap::fromImage on main thread
-            QPixmap pixmap = QPixmap::fromImage(pdfImage);
-            
-            // Add to cache (thread-safe access to shared cache)
-            QMutexLocker locker(&m_pdfCacheMutex);
-            
-            // Check if already added (race condition prevention)
-            for (const PdfCacheEntry& entry : m_pdfCache) {
-                if (entry.matches(sourceId, pdfPageNum, dpi)) {
-                    return;  // Already cached by another path
-                }
+            const Page* page = m_document->page(i);
+            if (!page || page->backgroundType != Page::BackgroundType::PDF || page->pdfPageNumber < 0) {
+                continue;
             }
-            
-            PdfCacheEntry entry;
-            entry.sourceId = sourceId;
-            entry.pageIndex = pdfPageNum;
-            entry.dpi = dpi;
-            entry.pixmap = pixmap;
-            
-            // Evict page FURTHEST from this page (smart eviction)
-            if (m_pdfCache.size() >= m_pdfCacheCapacity) {
-                int evictIndex = 0;
-                int maxDistance = -1;
-                for (int i = 0; i < m_pdfCache.size(); ++i) {
-                    int distance = qAbs(m_pdfCache[i].pageIndex - pdfPageNum);
-                    if (distance > maxDistance) {
-                        maxDistance = distance;
-                        evictIndex = i;
-                    }
-                }
-                m_pdfCache.removeAt(evictIndex);
+            const int providerPage = m_document->resolveSourcePageIndex(page->pdfSourceId,
+                                                                        page->pdfPageNumber);
+            if (providerPage < 0) {
+                continue;
             }
-            
-            m_pdfCache.append(entry);
-            m_cachedDpi = dpi;
-            
-            // Trigger repaint to show newly cached page
-            update();
-        });
-        
-        // Background thread: render PDF to QImage (thread-safe)
-        // NOTE: QImage is explicitly documented as thread-safe for read operations
-        // and can be safely passed between threads.
-        QFuture<QImage> future = QtConcurrent::run([renderPageNum, dpi, pdfPath]() -> QImage {
-            // Use thread-local cached PDF provider to avoid re-opening the PDF
-            // for every page render. Each thread pool worker caches its own provider
-            // (keyed by resolved source path).
-            ThreadPdfCache& cache = s_threadPdfCache.localData();
-            PdfProvider* threadPdf = cache.getOrCreate(pdfPath);
-            if (!threadPdf || !threadPdf->isValid()) {
-                return QImage();  // Return null image on failure
-            }
-            
-            QImage result = threadPdf->renderPageToImage(renderPageNum, dpi);
-            threadPdf->trimStore();
-            return result;
-        });
-        
-        watcher->setFuture(future);
+            if (!textPages.contains(page->pdfSourceId)) {
+                textSources.append(page->pdfSourceId);
+            }
+            textPages[page->pdfSourceId].append(providerPage);
+        }
     }
-    /*
-    if (!pagesToPreload.isEmpty()) {
-        qDebug() << "PDF async preload: started" << pagesToPreload.size() 
-                 << "background renders for pages" << pagesToPreload;
+    for (const QString& sourceId : std::as_const(textSources)) {
+        const PdfProvider* pdf = m_document->providerForSource(sourceId);
+        if (pdf && pdf->supportsTextExtraction()) {
+            pdf->prefetchTextBoxes(textPages.value(sourceId));
+        }
     }
-    */
 }
 
 void DocumentViewport::cancelAndWaitForBackgroundThreads()
@@ -4306,6 +4422,8 @@ void DocumentViewport::cancelAndWaitForBackgroundThreads()
         delete watcher;
     }
     m_activePdfWatchers.clear();
+    m_pendingPdfTiles.clear();
+    cancelTileLoads();
 }
 
 void DocumentViewport::invalidatePdfCache()
@@ -4321,29 +4439,20 @@ void DocumentViewport::invalidatePdfCache()
     for (QFutureWatcher<QImage>* watcher : m_activePdfWatchers) {
         watcher->cancel();
     }
+    m_pendingPdfTiles.clear();
     
-    // Thread-safe cache clear
-    QMutexLocker locker(&m_pdfCacheMutex);
 #ifdef SPEEDYNOTE_DEBUG
-    if (!m_pdfCache.isEmpty()) {
-        qDebug() << "PDF CACHE INVALIDATED: cleared" << m_pdfCache.size() << "entries";
+    if (m_pdfTileCache.tileCount() > 0) {
+        qDebug() << "PDF CACHE INVALIDATED: cleared" << m_pdfTileCache.tileCount() << "tiles";
     }
 #endif
-    m_pdfCache.clear();
-    m_cachedDpi = 0;
+    m_pdfTileCache.clear();
 }
 
 void DocumentViewport::invalidatePdfCachePage(const QString& sourceId, int pageIndex)
 {
-    // Thread-safe page removal
-    QMutexLocker locker(&m_pdfCacheMutex);
-    m_pdfCache.erase(
-        std::remove_if(m_pdfCache.begin(), m_pdfCache.end(),
-                       [&sourceId, pageIndex](const PdfCacheEntry& entry) {
-                           return entry.pageIndex == pageIndex && entry.sourceId == sourceId;
-                       }),
-        m_pdfCache.end()
-    );
+    // All levels of the page go; the tile cache is thread-safe.
+    m_pdfTileCache.removePage(sourceId, pageIndex);
 }
 
 void DocumentViewport::updatePdfCacheCapacity()
@@ -4356,47 +4465,18 @@ void DocumentViewport::updatePdfCacheCapacity()
     //         6 pages for 2-column (1 row above + 1 row below = 4, plus margin)
     int buffer = (m_layoutMode == LayoutMode::TwoColumn) ? 6 : 3;
     
-    // New capacity with minimum of 4
-    int newCapacity = qMax(4, visibleCount + buffer);
-    
-    // Thread-safe capacity update and eviction
-    // Acquire mutex BEFORE updating capacity to prevent race conditions
-    QMutexLocker locker(&m_pdfCacheMutex);
+    // One "screen" worth of tiles: the viewport in device pixels, padded by a
+    // tile on each axis for partially visible tiles at the edges.
+    const qreal dpr = devicePixelRatioF();
+    const qint64 screenBytes = qint64(width() * dpr + PdfTileCache::TILE_SIZE)
+                             * qint64(height() * dpr + PdfTileCache::TILE_SIZE) * 4;
+    const qint64 newBudget = qBound(PDF_CACHE_MIN_BYTES,
+                                    screenBytes * (visibleCount + buffer),
+                                    PDF_CACHE_MAX_BYTES);
     
-    // Only update if changed
-    if (m_pdfCacheCapacity != newCapacity) {
-        m_pdfCacheCapacity = newCapacity;
-        
-        // Immediately evict if over new capacity
-        evictFurthestCacheEntries();
-    }
-}
-
-void DocumentViewport::evictFurthestCacheEntries()
-{
-    // Must be called with m_pdfCacheMutex locked
-    
-    // Get reference page for distance calculation
-    int centerPage = m_currentPageIndex;
-    
-    // Evict furthest entries until within capacity
-    while (m_pdfCache.size() > m_pdfCacheCapacity) {
-        int evictIdx = 0;
-        int maxDistance = -1;
-        
-        for (int i = 0; i < m_pdfCache.size(); ++i) {
-            int dist = qAbs(m_pdfCache[i].pageIndex - centerPage);
-            if (dist > maxDistance) {
-                maxDistance = dist;
-                evictIdx = i;
-            }
-        }
-        
-#ifdef SPEEDYNOTE_DEBUG
-        qDebug() << "PDF cache evict: page" << m_pdfCache[evictIdx].pageIndex 
-                 << "distance" << maxDistance << "new size" << (m_pdfCache.size() - 1);
-#endif
-        m_pdfCache.removeAt(evictIdx);
+    // Only update if changed (a smaller budget evicts LRU tiles immediately)
+    if (m_pdfTileCache.budgetBytes() != newBudget) {
+        m_pdfTileCache.setBudgetBytes(newBudget);
     }
 }
 
@@ -4620,57 +4700,71 @@ void DocumentViewport::evictDistantTiles()
         return;
     }
     
-    QRectF viewRect = visibleRect();
-    
-    // Dynamic margin: at high zoom * dpr, each tile cache is large (up to
-    // MAX_STROKE_CACHE_DIM^2 * 4 bytes) but the viewport covers a tiny
-    // fraction of a tile. Reduce the margin to limit total memory.
-    // At low effective scale the caches are small, so a generous margin
-    // is affordable and ensures smooth panning without disk-load stutters.
-    qreal effectiveScale = m_zoomLevel * devicePixelRatioF();
-    int keepMargin;
-    if (effectiveScale <= 2.0)
-        keepMargin = 2;
-    else if (effectiveScale <= 4.0)
-        keepMargin = 1;
-    else
-        keepMargin = 0;
-    int tileSize = Document::EDGELESS_TILE_SIZE;
+    // Loaded tiles may stay as long as they fit the budget: the stroke caches
+    // dominate, so at high zoom * dpr fewer tiles fit, at low zoom more do
+    // (panning back then needs no reload at all).
+    QVector<Document::TileCoord> loadedTiles = m_document->allLoadedTileCoords();
+    qint64 totalBytes = 0;
+    std::vector<std::pair<Document::TileCoord, qint64>> tileBytes;
+    tileBytes.reserve(loadedTiles.size());
+    for (const auto& coord : loadedTiles) {
+        Page* tile = m_document->loadedTile(coord);
+        const qint64 bytes = tile ? tile->memoryBytes() : 0;
+        tileBytes.emplace_back(coord, bytes);
+        totalBytes += bytes;
+    }
+    if (totalBytes <= EDGELESS_TILE_BUDGET_BYTES) {
+        return;
+    }
     
-    QRectF keepRect = viewRect.adjusted(
-        -keepMargin * tileSize, -keepMargin * tileSize,
-        keepMargin * tileSize, keepMargin * tileSize);
+    // Never evict what is visible or about to be (prefetched along the pan).
+    const QRectF viewRect = effectiveVisibleRect();
+    std::set<Document::TileCoord> keep;
+    for (const auto& coord : predictTileFetchOrder(viewRect, predictedPanMotion())) {
+        keep.insert(coord);
+    }
     
-    // Get all loaded tiles and check which to evict
-    QVector<Document::TileCoord> loadedTiles = m_document->allLoadedTileCoords();
+    // Farthest from the view center first
+    const int tileSize = Document::EDGELESS_TILE_SIZE;
+    const QPointF center = viewRect.center();
+    auto distance = [center, tileSize](const Document::TileCoord& coord) {
+        const QPointF d = QPointF((coord.first + 0.5) * tileSize, (coord.second + 0.5) * tileSize) - center;
+        return d.x() * d.x() + d.y() * d.y();
+    };
+    std::sort(tileBytes.begin(), tileBytes.end(),
+              [&distance](const auto& a, const auto& b) {
+                  return distance(a.first) > distance(b.first);
+              });
     
     int evictedCount = 0;
     bool selectionChanged = false;
     
-    for (const auto& coord : loadedTiles) {
-        // Phase 5.6.5: No longer need to protect origin tile - layer structure comes from manifest
-        
-        QRectF tileRect(coord.first * tileSize, coord.second * tileSize,
-                        tileSize, tileSize);
+    for (const auto& entry : tileBytes) {
+        if (totalBytes <= EDGELESS_TILE_BUDGET_BYTES) {
+            break;
+        }
+        const Document::TileCoord& coord = entry.first;
+        if (keep.count(coord) > 0) {
+            continue;
+        }
         
-        if (!keepRect.intersects(tileRect)) {
-            // CR-O1: Clear selection for objects on tiles about to be evicted
-            // This prevents dangling pointers in m_selectedObjects and m_hoveredObject
-            Page* tile = m_document->getTile(coord.first, coord.second);
-            if (tile && !tile->objects.empty()) {
-                for (const auto& obj : tile->objects) {
-                    if (m_hoveredObject == obj.get()) {
-                        m_hoveredObject = nullptr;
-                    }
-                    if (m_selectedObjects.removeOne(obj.get())) {
-                        selectionChanged = true;
-                    }
+        // CR-O1: Clear selection for objects on tiles about to be evicted
+        // This prevents dangling pointers in m_selectedObjects and m_hoveredObject
+        Page* tile = m_document->loadedTile(coord);
+        if (tile && !tile->objects.empty()) {
+            for (const auto& obj : tile->objects) {
+                if (m_hoveredObject == obj.get()) {
+                    m_hoveredObject = nullptr;
+                }
+                if (m_selectedObjects.removeOne(obj.get())) {
+                    selectionChanged = true;
                 }
             }
-            
-            m_document->evictTile(coord);
-            ++evictedCount;
         }
+        
+        m_document->evictTile(coord);
+        totalBytes -= entry.second;
+        ++evictedCount;
     }
     
     if (selectionChanged) {
@@ -4683,11 +4777,228 @@ void DocumentViewport::evictDistantTiles()
     
 #ifdef SPEEDYNOTE_DEBUG
     if (evictedCount > 0) {
-        qDebug() << "Evicted" << evictedCount << "tiles, remaining:" << m_document->tileCount();
+        qDebug() << "Evicted" << evictedCount << "tiles, remaining:" << m_document->tileCount()
+                 << "using" << totalBytes / (1024 * 1024) << "MB";
     }
 #endif
 }
 
+// ===== Edgeless Tile Prefetch =====
+
+QVector<Document::TileCoord> DocumentViewport::predictTileFetchOrder(const QRectF& viewRect,
+                                                                     const QPointF& motion,
+                                                                     int marginTiles,
+                                                                     int* pathCount)
+{
+    const qreal tileSize = Document::EDGELESS_TILE_SIZE;
+    
+    // Candidates: the tiles the view sweeps while moving by `motion`, plus
+    // the margin ring.
+    const QRectF swept = viewRect.united(viewRect.translated(motion));
+    const int minTx = static_cast<int>(std::floor(swept.left() / tileSize)) - marginTiles;
+    const int maxTx = static_cast<int>(std::floor(swept.right() / tileSize)) + marginTiles;
+    const int minTy = static_cast<int>(std::floor(swept.top() / tileSize)) - marginTiles;
+    const int maxTy = static_cast<int>(std::floor(swept.bottom() / tileSize)) + marginTiles;
+    
+    // When the moving view (viewRect + t * motion, t in [0, 1]) first
+    // overlaps [lo, hi) along one axis, as an interval of t.
+    auto overlapInterval = [](qreal viewLo, qreal viewHi, qreal move,
+                              qreal lo, qreal hi, qreal& from, qreal& to) {
+        if (qFuzzyIsNull(move)) {
+            if (viewLo < hi && viewHi > lo) {
+                from = -std::numeric_limits<qreal>::infinity();
+                to = std::numeric_limits<qreal>::infinity();
+            } else {
+                from = 1;
+                to = 0;  // Never
+            }
+            return;
+        }
+        const qreal enter = ((move > 0 ? lo - viewHi : hi - viewLo)) / move;
+        const qreal leave = ((move > 0 ? hi - viewLo : lo - viewHi)) / move;
+        from = enter;
+        to = leave;
+    };
+    
+    struct Candidate {
+        Document::TileCoord coord;
+        qreal arrival;   ///< t in [0, 1] the view reaches the tile, or > 1: never
+        qreal distance;  ///< From the view center (squared)
+    };
+    std::vector<Candidate> candidates;
+    const QPointF center = viewRect.center();
+    for (int ty = minTy; ty <= maxTy; ++ty) {
+        for (int tx = minTx; tx <= maxTx; ++tx) {
+            const qreal x0 = tx * tileSize;
+            const qreal y0 = ty * tileSize;
+            qreal fromX, toX, fromY, toY;
+            overlapInterval(viewRect.left(), viewRect.right(), motion.x(),
+                            x0, x0 + tileSize, fromX, toX);
+            overlapInterval(viewRect.top(), viewRect.bottom(), motion.y(),
+                            y0, y0 + tileSize, fromY, toY);
+            const qreal from = qMax(qMax(fromX, fromY), qreal(0));
+            const qreal to = qMin(qMin(toX, toY), qreal(1));
+            const QPointF d = QPointF(x0 + tileSize / 2, y0 + tileSize / 2) - center;
+            candidates.push_back({ {tx, ty}, from < to ? from : qreal(2),
+                                   d.x() * d.x() + d.y() * d.y() });
+        }
+    }
+    
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) {
+                  if (a.arrival != b.arrival) {
+                      return a.arrival < b.arrival;
+                  }
+                  return a.distance < b.distance;
+              });
+    
+    QVector<Document::TileCoord> order;
+    order.reserve(static_cast<int>(candidates.size()));
+    int onPath = 0;
+    for (const Candidate& c : candidates) {
+        order.append(c.coord);
+        if (c.arrival <= 1) {
+            ++onPath;
+        }
+    }
+    if (pathCount) {
+        *pathCount = onPath;
+    }
+    return order;
+}
+
+QRectF DocumentViewport::effectiveVisibleRect() const
+{
+    if (m_gesture.activeType == ViewportGestureState::Pan) {
+        return QRectF(m_gesture.targetPan, QSizeF(width() / m_zoomLevel, height() / m_zoomLevel));
+    }
+    return visibleRect();
+}
+
+QPointF DocumentViewport::predictedPanMotion() const
+{
+    if (m_touchHandler) {
+        const QPointF glide = m_touchHandler->remainingInertiaPan();
+        if (!glide.isNull()) {
+            return glide;
+        }
+    }
+    if (m_lastTrackedPanMs < 0 ||
+        m_panVelocityClock.elapsed() - m_lastTrackedPanMs > PAN_VELOCITY_STALE_MS) {
+        return QPointF();  // The view has come to rest
+    }
+    return m_panVelocity * TILE_PREFETCH_LOOKAHEAD_MS;
+}
+
+void DocumentViewport::trackPanVelocity()
+{
+    // A zoom gesture moves the view too, but not in a way worth extrapolating
+    if (m_gesture.activeType == ViewportGestureState::Zoom ||
+        m_gesture.activeType == ViewportGestureState::ZoomAndPan) {
+        m_lastTrackedPanMs = -1;
+        m_panVelocity = QPointF();
+        return;
+    }
+    
+    const QPointF pan = effectiveVisibleRect().topLeft();
+    const qint64 now = m_panVelocityClock.elapsed();
+    if (m_lastTrackedPanMs >= 0 && now > m_lastTrackedPanMs) {
+        const qint64 dt = now - m_lastTrackedPanMs;
+        const QPointF sample = (pan - m_lastTrackedPan) / qreal(dt);
+        if (dt > PAN_VELOCITY_STALE_MS) {
+            m_panVelocity = sample;  // Starting from rest
+        } else {
+            // Exponential smoothing: frame-to-frame deltas are noisy.
+            m_panVelocity = m_panVelocity * 0.5 + sample * 0.5;
+        }
+    }
+    if (now > m_lastTrackedPanMs) {
+        m_lastTrackedPan = pan;
+        m_lastTrackedPanMs = now;
+    }
+}
+
+void DocumentViewport::scheduleTileLoads()
+{
+    if (!m_document || !m_document->isEdgeless() || !m_document->isLazyLoadEnabled()) {
+        return;
+    }
+    if (m_activeTileWatchers.size() >= MAX_TILE_LOADS_IN_FLIGHT) {
+        return;
+    }
+    
+    int pathCount = 0;
+    const QVector<Document::TileCoord> order =
+        predictTileFetchOrder(effectiveVisibleRect(), predictedPanMotion(), 1, &pathCount);
+    
+    // Pre-render stroke caches on the worker when the Capped tier would
+    // build them anyway (same predicate as chooseRenderTier()), and only for
+    // tiles about to be shown: a margin tile's cache may never be needed.
+    const qreal dpr = devicePixelRatioF();
+    const bool capped = m_zoomLevel * dpr * Document::EDGELESS_TILE_SIZE
+                        <= VectorLayer::MAX_STROKE_CACHE_DIM;
+    
+    for (int i = 0; i < order.size(); ++i) {
+        if (m_activeTileWatchers.size() >= MAX_TILE_LOADS_IN_FLIGHT) {
+            break;
+        }
+        const Document::TileCoord coord = order[i];
+        if (m_pendingTileLoads.count(coord) > 0 || !m_document->tileExistsOnDisk(coord) ||
+            m_document->loadedTile(coord)) {
+            continue;
+        }
+        
+        const bool preRender = capped && i < pathCount;
+        auto decode = m_document->tileDecoder(coord, preRender ? m_zoomLevel : 0,
+                                              preRender ? dpr : 0);
+        if (!decode) {
+            continue;
+        }
+        
+        using DecodedTilePtr = std::shared_ptr<Document::DecodedTile>;
+        m_pendingTileLoads.insert(coord);
+        auto* watcher = new QFutureWatcher<DecodedTilePtr>(this);
+        m_activeTileWatchers.append(watcher);
+        
+        Document* doc = m_document;
+        connect(watcher, &QFutureWatcher<DecodedTilePtr>::finished, this, [this, watcher, doc, coord]() {
+            m_activeTileWatchers.removeOne(watcher);
+            
+            const bool wasCancelled = watcher->isCanceled();
+            DecodedTilePtr decoded;
+            if (!wasCancelled) {
+                decoded = watcher->result();
+            }
+            delete watcher;
+            
+            if (wasCancelled) {
+                return;  // cancelTileLoads() already dropped the pending set
+            }
+            m_pendingTileLoads.erase(coord);
+            
+            if (decoded && doc == m_document && m_document->adoptDecodedTile(*decoded)) {
+                update();
+            }
+            
+            // Keep the queue moving toward where the view is heading now.
+            scheduleTileLoads();
+        });
+        
+        watcher->setFuture(QtConcurrent::run(&m_tileLoadPool, decode));
+    }
+}
+
+void DocumentViewport::cancelTileLoads()
+{
+    for (auto* watcher : m_activeTileWatchers) {
+        watcher->cancel();
+        watcher->waitForFinished();
+        delete watcher;
+    }
+    m_activeTileWatchers.clear();
+    m_pendingTileLoads.clear();
+}
+
 void DocumentViewport::releaseFocusCachesBelowThreshold()
 {
     if (!m_document) return;
@@ -5212,7 +5523,7 @@ void DocumentViewport::startStroke(const PointerEvent& pe)
         
         // Initialize new stroke
         m_currentStroke = VectorStroke();
-        m_currentStroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        m_currentStroke.id = Id128::create();
         m_currentStroke.color = strokeColor;
         m_currentStroke.baseThickness = strokeThickness;
         
@@ -5244,7 +5555,7 @@ void DocumentViewport::startStroke(const PointerEvent& pe)
     
     // Initialize new stroke
     m_currentStroke = VectorStroke();
-    m_currentStroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    m_currentStroke.id = Id128::create();
     m_currentStroke.color = strokeColor;
     m_currentStroke.baseThickness = strokeThickness;
     
@@ -5273,7 +5584,7 @@ void DocumentViewport::continueStroke(const PointerEvent& pe)
         // Point decimation (same logic as addPointToStroke but for document coords)
         // Zoom-aware: threshold is constant in screen pixels, not document space.
         if (!m_currentStroke.points.isEmpty()) {
-            const QPointF& lastPos = m_currentStroke.points.last().pos;
+            const QPointF lastPos = m_currentStroke.points.position(m_currentStroke.points.size() - 1);
             qreal dx = docPt.x() - lastPos.x();
             qreal dy = docPt.y() - lastPos.y();
             qreal distSq = dx * dx + dy * dy;
@@ -5283,8 +5594,9 @@ void DocumentViewport::continueStroke(const PointerEvent& pe)
                 // Point too close - but update pressure peak if higher.
                 // Compare the floored effective pressure, not the raw reading,
                 // so the stored pressure can never slip below the min-width floor.
-                if (!useFixedPressure && effectivePressure > m_currentStroke.points.last().pressure) {
-                    m_currentStroke.points.last().pressure = effectivePressure;
+                const int lastIndex = m_currentStroke.points.size() - 1;
+                if (!useFixedPressure && effectivePressure > m_currentStroke.points.pressure(lastIndex)) {
+                    m_currentStroke.points.setPressure(lastIndex, effectivePressure);
                 }
                 return;
             }
@@ -5303,7 +5615,7 @@ void DocumentViewport::continueStroke(const PointerEvent& pe)
         QRectF dirtyRect(vpPos.x() - padding, vpPos.y() - padding, padding * 2, padding * 2);
         
         if (m_currentStroke.points.size() > 1) {
-            const auto& prevPt = m_currentStroke.points[m_currentStroke.points.size() - 2];
+            const StrokePoint prevPt = m_currentStroke.points.at(m_currentStroke.points.size() - 2);
             QPointF prevVpPos = documentToViewport(prevPt.pos);
             dirtyRect = dirtyRect.united(QRectF(prevVpPos.x() - padding, prevVpPos.y() - padding, 
                                                  padding * 2, padding * 2));
@@ -5345,7 +5657,8 @@ void DocumentViewport::finishStroke()
         return;
     }
     
-    // Finalize stroke
+    // Finalize stroke (drop growth slack before it is copied into the layer)
+    m_currentStroke.points.squeeze();
     m_currentStroke.updateBoundingBox();
     
     // Branch for edgeless mode
@@ -5424,17 +5737,14 @@ void DocumentViewport::finishStrokeEdgeless()
         
         // Create local stroke (convert from document coords to tile-local)
         VectorStroke localStroke = m_currentStroke;  // Copy base properties (color, width, etc.)
-        localStroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);  // New unique ID for each segment
-        localStroke.points.clear();
+        localStroke.id = Id128::create();  // New unique ID for each segment
         
         QPointF tileOrigin(seg.coord.first * Document::EDGELESS_TILE_SIZE,
                            seg.coord.second * Document::EDGELESS_TILE_SIZE);
         
-        for (const StrokePoint& pt : seg.points) {
-            StrokePoint localPt = pt;
-            localPt.pos -= tileOrigin;
-            localStroke.points.append(localPt);
-        }
+        localStroke.points = seg.points;
+        localStroke.points.squeeze();  // Exact-size, unshared buffer before translating
+        localStroke.points.translate(-tileOrigin);
         localStroke.updateBoundingBox();
         
         // Add to tile's layer (addStroke handles cache update incrementally)
@@ -5520,17 +5830,14 @@ QVector<QPair<Document::TileCoord, VectorStroke>> DocumentViewport::addStrokeToE
         
         // Create local stroke (convert from document coords to tile-local)
         VectorStroke localStroke = stroke;  // Copy base properties (color, width, etc.)
-        localStroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);  // New unique ID
-        localStroke.points.clear();
+        localStroke.id = Id128::create();  // New unique ID
         
         QPointF tileOrigin(seg.coord.first * Document::EDGELESS_TILE_SIZE,
                            seg.coord.second * Document::EDGELESS_TILE_SIZE);
         
-        for (const StrokePoint& pt : seg.points) {
-            StrokePoint localPt = pt;
-            localPt.pos -= tileOrigin;
-            localStroke.points.append(localPt);
-        }
+        localStroke.points = seg.points;
+        localStroke.points.squeeze();  // Exact-size, unshared buffer before translating
+        localStroke.points.translate(-tileOrigin);
         localStroke.updateBoundingBox();
         
         // Add to tile's layer (addStroke handles cache update incrementally)
@@ -5569,7 +5876,7 @@ void DocumentViewport::createStraightLineStroke(const QPointF& start, const QPoi
     
     // Create stroke with just two points (start and end)
     VectorStroke stroke;
-    stroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    stroke.id = Id128::create();
     stroke.color = strokeColor;
     stroke.baseThickness = strokeThickness;
     
@@ -5611,8 +5918,7 @@ void DocumentViewport::createStraightLineStroke(const QPointF& start, const QPoi
             QPointF tileOrigin(startTile.first * Document::EDGELESS_TILE_SIZE,
                                startTile.second * Document::EDGELESS_TILE_SIZE);
             VectorStroke localStroke = stroke;
-            localStroke.points[0].pos -= tileOrigin;
-            localStroke.points[1].pos -= tileOrigin;
+            localStroke.points.translate(-tileOrigin);
             localStroke.updateBoundingBox();
             
             layer->addStroke(localStroke);
@@ -5639,7 +5945,8 @@ void DocumentViewport::createStraightLineStroke(const QPointF& start, const QPoi
                                          std::pow(end.y() - start.y(), 2));
             int numPoints = qMax(2, static_cast<int>(lineLength / 10.0));  // ~10px spacing
             
-            QVector<StrokePoint> linePoints;
+            StrokePointList linePoints;
+            linePoints.reserve(numPoints + 1);
             for (int i = 0; i <= numPoints; ++i) {
                 qreal t = static_cast<qreal>(i) / numPoints;
                 StrokePoint pt;
@@ -5667,18 +5974,16 @@ void DocumentViewport::createStraightLineStroke(const QPointF& start, const QPoi
                 if (!layer) continue;
                 
                 VectorStroke localStroke;
-                localStroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+                localStroke.id = Id128::create();
                 localStroke.color = strokeColor;
                 localStroke.baseThickness = strokeThickness;
                 
                 QPointF tileOrigin(seg.coord.first * Document::EDGELESS_TILE_SIZE,
                                    seg.coord.second * Document::EDGELESS_TILE_SIZE);
                 
-                for (const StrokePoint& pt : seg.points) {
-                    StrokePoint localPt = pt;
-                    localPt.pos -= tileOrigin;
-                    localStroke.points.append(localPt);
-                }
+                localStroke.points = seg.points;
+                localStroke.points.squeeze();  // Exact-size, unshared buffer before translating
+                localStroke.points.translate(-tileOrigin);
                 localStroke.updateBoundingBox();
                 
                 layer->addStroke(localStroke);
@@ -8979,16 +9284,16 @@ void DocumentViewport::finalizeLassoSelection()
             QPointF tileOrigin(coord.first * Document::EDGELESS_TILE_SIZE,
                                coord.second * Document::EDGELESS_TILE_SIZE);
             
-            const auto& strokes = layer->strokes();
-            for (int i = 0; i < strokes.size(); ++i) {
+            // Broad phase via the layer's spatial index (tile-local coords)
+            const QRectF localLassoBounds = m_lassoPath.boundingRect().translated(-tileOrigin);
+            const QVector<VectorStroke>& strokes = std::as_const(*layer).strokes();
+            for (int i : layer->strokeIndicesIntersecting(localLassoBounds)) {
                 const VectorStroke& stroke = strokes[i];
                 
                 // Transform stroke to document coordinates for hit test
                 // We create a temporary copy with document coords
                 VectorStroke docStroke = stroke;
-                for (auto& pt : docStroke.points) {
-                    pt.pos += tileOrigin;
-                }
+                docStroke.points.translate(tileOrigin);
                 docStroke.updateBoundingBox();
                 
                 if (strokeIntersectsLasso(docStroke, m_lassoPath)) {
@@ -9029,8 +9334,8 @@ void DocumentViewport::finalizeLassoSelection()
         
         m_lassoSelection.sourceLayerIndex = page->activeLayerIndex;
         
-        const auto& strokes = layer->strokes();
-        for (int i = 0; i < strokes.size(); ++i) {
+        const QVector<VectorStroke>& strokes = std::as_const(*layer).strokes();
+        for (int i : layer->strokeIndicesIntersecting(m_lassoPath.boundingRect())) {
             const VectorStroke& stroke = strokes[i];
             
             if (strokeIntersectsLasso(stroke, m_lassoPath)) {
@@ -9069,8 +9374,8 @@ bool DocumentViewport::strokeIntersectsLasso(const VectorStroke& stroke,
                                               const QPolygonF& lasso) const
 {
     // Check if any point of the stroke is inside the lasso polygon
-    for (const auto& pt : stroke.points) {
-        if (lasso.containsPoint(pt.pos, Qt::OddEvenFill)) {
+    for (int i = 0; i < stroke.points.size(); ++i) {
+        if (lasso.containsPoint(stroke.points.position(i), Qt::OddEvenFill)) {
             return true;
         }
     }
@@ -9609,12 +9914,8 @@ void DocumentViewport::renderLassoSelection(QPainter& painter)
             transformedStroke.color = stroke.color;
             transformedStroke.baseThickness = stroke.baseThickness;
             
-            for (const StrokePoint& pt : stroke.points) {
-                StrokePoint tPt;
-                tPt.pos = transform.map(pt.pos);
-                tPt.pressure = pt.pressure;
-                transformedStroke.points.append(tPt);
-            }
+            transformedStroke.points = stroke.points;
+            transformedStroke.points.transform(transform);
             transformedStroke.updateBoundingBox();
             
             painter.save();
@@ -9629,7 +9930,8 @@ void DocumentViewport::renderLassoSelection(QPainter& painter)
                 painter.translate(pageOrigin);
             }
             
-            VectorLayer::renderStroke(painter, transformedStroke);
+            // Transformed copy changes every frame: don't cache its outline
+            VectorLayer::renderStroke(painter, transformedStroke, false);
             painter.restore();
         }
     }
@@ -9915,9 +10217,7 @@ void DocumentViewport::startSelectionTransform(HandleHit handle, const QPointF&
         
         // Translate stored strokes to match
         for (VectorStroke& stroke : m_lassoSelection.selectedStrokes) {
-            for (StrokePoint& pt : stroke.points) {
-                pt.pos += m_lassoSelection.offset;
-            }
+            stroke.points.translate(m_lassoSelection.offset);
             stroke.updateBoundingBox();
         }
         
@@ -10146,9 +10446,7 @@ void DocumentViewport::finalizeSelectionTransform()
 
 void DocumentViewport::transformStrokePoints(VectorStroke& stroke, const QTransform& transform)
 {
-    for (StrokePoint& pt : stroke.points) {
-        pt.pos = transform.map(pt.pos);
-    }
+    stroke.points.transform(transform);
     stroke.updateBoundingBox();
 }
 
@@ -10232,7 +10530,7 @@ void DocumentViewport::applySelectionTransform()
         for (const VectorStroke& stroke : m_lassoSelection.selectedStrokes) {
             VectorStroke transformedStroke = stroke;
             transformStrokePoints(transformedStroke, transform);
-            transformedStroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+            transformedStroke.id = Id128::create();
             transformedStroke.updateBoundingBox();
 
             // Determine destination page by stroke centre in document coords
@@ -10253,8 +10551,7 @@ void DocumentViewport::applySelectionTransform()
             if (destPage != srcPage) {
                 QPointF dstOrigin = pagePosition(destPage);
                 QPointF offset = srcOrigin - dstOrigin;
-                for (auto& pt : transformedStroke.points)
-                    pt.pos += offset;
+                transformedStroke.points.translate(offset);
                 transformedStroke.updateBoundingBox();
             }
 
@@ -10453,7 +10750,7 @@ void DocumentViewport::copySelection()
         VectorStroke transformedStroke = stroke;
         transformStrokePoints(transformedStroke, transform);
         // Give new ID to avoid conflicts when pasting
-        transformedStroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        transformedStroke.id = Id128::create();
         s_clipboard.strokes.append(transformedStroke);
     }
     
@@ -10505,8 +10802,7 @@ void DocumentViewport::pasteSelection()
 
         for (const VectorStroke& stroke : s_clipboard.strokes) {
             VectorStroke pastedStroke = stroke;
-            for (StrokePoint& pt : pastedStroke.points)
-                pt.pos += offset;
+            pastedStroke.points.translate(offset);
             pastedStroke.updateBoundingBox();
 
             auto addedSegments = addStrokeToEdgelessTiles(pastedStroke, m_edgelessActiveLayerIndex);
@@ -10537,10 +10833,9 @@ void DocumentViewport::pasteSelection()
 
         for (const VectorStroke& stroke : s_clipboard.strokes) {
             VectorStroke pastedStroke = stroke;
-            for (StrokePoint& pt : pastedStroke.points)
-                pt.pos += offset;
+            pastedStroke.points.translate(offset);
             pastedStroke.updateBoundingBox();
-            pastedStroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+            pastedStroke.id = Id128::create();
             layer->addStroke(pastedStroke);
 
             UndoAction::StrokeSegment seg;
@@ -10660,7 +10955,7 @@ void DocumentViewport::recolorLassoSelection(const QColor& newColor)
 
     // Build the set of selected stroke IDs once for O(1) lookup per layer
     // stroke (the existing selection stores strokes by value, not just by id).
-    const QSet<QString>& selectedIds = m_lassoSelection.getSelectedIds();
+    const QSet<Id128>& selectedIds = m_lassoSelection.getSelectedIds();
 
     UndoAction action;
     action.type = UndoAction::RecolorStrokes;
@@ -12205,7 +12500,7 @@ VectorStroke DocumentViewport::createHighlightStroke(const QRectF& rect,
                                                      HighlightStyle style) const
 {
     VectorStroke stroke;
-    stroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    stroke.id = Id128::create();
     stroke.color = color;
 
     // Geometry depends on style:
@@ -12258,7 +12553,7 @@ QVector<VectorStroke> DocumentViewport::createDottedUnderlineStrokes(const QRect
     dots.reserve(static_cast<int>((lastX - firstX) / step) + 1);
     for (qreal x = firstX; x <= lastX; x += step) {
         VectorStroke dot;
-        dot.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        dot.id = Id128::create();
         dot.color = color;
         dot.baseThickness = thickness;
         StrokePoint p;
@@ -12271,9 +12566,9 @@ QVector<VectorStroke> DocumentViewport::createDottedUnderlineStrokes(const QRect
     return dots;
 }
 
-QVector<QString> DocumentViewport::createHighlightStrokes()
+QVector<Id128> DocumentViewport::createHighlightStrokes()
 {
-    QVector<QString> createdIds;
+    QVector<Id128> createdIds;
 
     // Validate selection
     if (!m_textSelection.isValid() || m_textSelection.highlightRects.isEmpty()) {
@@ -12470,7 +12765,7 @@ void DocumentViewport::addPointToStroke(const QPointF& pagePos, qreal pressure,
     const qreal flooredPressure = applyPenPressureFloor(pressure);
 
     if (!m_currentStroke.points.isEmpty()) {
-        const QPointF& lastPos = m_currentStroke.points.last().pos;
+        const QPointF lastPos = m_currentStroke.points.position(m_currentStroke.points.size() - 1);
         qreal dx = pagePos.x() - lastPos.x();
         qreal dy = pagePos.y() - lastPos.y();
         qreal distSq = dx * dx + dy * dy;
@@ -12480,8 +12775,9 @@ void DocumentViewport::addPointToStroke(const QPointF& pagePos, qreal pressure,
             // Point too close - but update pressure peak if higher.
             // Compare the *floored* pressure so the stored peak never slips
             // below the preset's min-width floor.
-            if (flooredPressure > m_currentStroke.points.last().pressure) {
-                m_currentStroke.points.last().pressure = flooredPressure;
+            const int lastIndex = m_currentStroke.points.size() - 1;
+            if (flooredPressure > m_currentStroke.points.pressure(lastIndex)) {
+                m_currentStroke.points.setPressure(lastIndex, flooredPressure);
             }
             return;  // Skip this point
         }
@@ -12506,7 +12802,7 @@ void DocumentViewport::addPointToStroke(const QPointF& pagePos, qreal pressure,
     
     // Include line from previous point if exists
     if (m_currentStroke.points.size() > 1) {
-        const auto& prevPt = m_currentStroke.points[m_currentStroke.points.size() - 2];
+        const StrokePoint prevPt = m_currentStroke.points.at(m_currentStroke.points.size() - 2);
         QPointF prevVpPos = pageToViewport(m_activeDrawingPage, prevPt.pos);
         QRectF prevRect(prevVpPos.x() - padding, prevVpPos.y() - padding, padding * 2, padding * 2);
         dirtyRect = dirtyRect.united(prevRect);
@@ -12636,13 +12932,14 @@ void DocumentViewport::renderCurrentStrokeIncremental(QPainter& painter)
         // Render using the same path as finalized strokes (Catmull-Rom smoothing).
         // For semi-transparent strokes, create a copy with full opacity (alpha
         // is applied during the blit step below). For opaque strokes, render
-        // directly to avoid copying the stroke's point vector.
+        // directly to avoid copying the stroke's point vector. The live
+        // stroke grows every frame, so it bypasses the outline cache.
         if (hasSemiTransparency) {
             VectorStroke drawStroke = m_currentStroke;
             drawStroke.color.setAlpha(255);
-            VectorLayer::renderStroke(cachePainter, drawStroke);
+            VectorLayer::renderStroke(cachePainter, drawStroke, false);
         } else {
-            VectorLayer::renderStroke(cachePainter, m_currentStroke);
+            VectorLayer::renderStroke(cachePainter, m_currentStroke, false);
         }
         
         m_lastRenderedPointIndex = n;
@@ -12705,31 +13002,13 @@ void DocumentViewport::eraseAt(const PointerEvent& pe)
     if (!layer || layer->locked) return;
     
     // Find strokes at eraser position
-    QVector<QString> hitIds = layer->strokesAtPoint(pe.pageHit.pagePoint, m_eraserSize);
+    QVector<Id128> hitIds = layer->strokesAtPoint(pe.pageHit.pagePoint, m_eraserSize);
     
     if (hitIds.isEmpty()) return;
     
-    // Collect strokes for undo before removing
-    // Use a set for O(1) lookup instead of O(n) per ID
-    QSet<QString> hitIdSet(hitIds.begin(), hitIds.end());
-    QVector<VectorStroke> removedStrokes;
-    removedStrokes.reserve(hitIds.size());
-    
-    for (const VectorStroke& s : layer->strokes()) {
-        if (hitIdSet.contains(s.id)) {
-            removedStrokes.append(s);
-            if (removedStrokes.size() == hitIds.size()) {
-                break;  // Found all strokes, no need to continue
-            }
-        }
-    }
-    
-    // Remove strokes
-    for (const QString& id : hitIds) {
-        layer->removeStroke(id);
-    }
-    
-    // Stroke cache is incrementally patched by removeStroke()
+    // Remove strokes in one batch; the removed copies (in layer order) are
+    // kept for undo. Stroke cache is incrementally patched by removeStrokes().
+    QVector<VectorStroke> removedStrokes = layer->removeStrokes(hitIds);
     
     // Mark page dirty for lazy save (BUG FIX: was missing)
     if (!removedStrokes.isEmpty()) {
@@ -12792,22 +13071,15 @@ void DocumentViewport::eraseAtEdgeless(QPointF viewportPos)
 
             QPointF tileOrigin(tx * tileSize, ty * tileSize);
             QPointF localPt = docPt - tileOrigin;
-            QVector<QString> hitIds = layer->strokesAtPoint(localPt, m_eraserSize);
+            QVector<Id128> hitIds = layer->strokesAtPoint(localPt, m_eraserSize);
             if (hitIds.isEmpty()) continue;
 
-            for (const QString& id : hitIds) {
-                for (const VectorStroke& stroke : layer->strokes()) {
-                    if (stroke.id == id) {
-                        UndoAction::StrokeSegment seg;
-                        seg.tileCoord = {tx, ty};
-                        seg.stroke = stroke;
-                        undoAction.segments.append(seg);
-                        break;
-                    }
-                }
+            for (VectorStroke& stroke : layer->removeStrokes(hitIds)) {
+                UndoAction::StrokeSegment seg;
+                seg.tileCoord = {tx, ty};
+                seg.stroke = std::move(stroke);
+                undoAction.segments.append(seg);
             }
-            for (const QString& id : hitIds)
-                layer->removeStroke(id);
             m_document->markTileDirty({tx, ty});
             m_document->removeTileIfEmpty(tx, ty);
         }
@@ -12887,35 +13159,27 @@ void DocumentViewport::finalizeEraserLasso()
             QPointF tileOrigin(coord.first * Document::EDGELESS_TILE_SIZE,
                                coord.second * Document::EDGELESS_TILE_SIZE);
 
-            QSet<QString> idsToRemove;
-            const auto& strokes = layer->strokes();
-            for (const VectorStroke& stroke : strokes) {
-                // Quick bounding-box rejection before expensive per-point copy + test
-                QRectF docBBox = stroke.boundingBox.translated(tileOrigin);
-                if (!docBBox.intersects(lassoBounds)) continue;
-
-                VectorStroke docStroke = stroke;
-                for (auto& pt : docStroke.points) {
-                    pt.pos += tileOrigin;
-                }
+            // Broad phase: only strokes whose bbox meets the lasso bounds
+            // (spatial index query in tile-local coordinates).
+            QVector<Id128> idsToRemove;
+            const QVector<VectorStroke>& strokes = std::as_const(*layer).strokes();
+            for (int i : layer->strokeIndicesIntersecting(lassoBounds.translated(-tileOrigin))) {
+                VectorStroke docStroke = strokes[i];
+                docStroke.points.translate(tileOrigin);
                 if (strokeIntersectsLasso(docStroke, m_lassoPath)) {
-                    idsToRemove.insert(stroke.id);
+                    idsToRemove.append(strokes[i].id);
                 }
             }
 
             if (idsToRemove.isEmpty()) continue;
 
-            QVector<VectorStroke>& layerStrokes = layer->strokes();
-            for (int i = static_cast<int>(layerStrokes.size()) - 1; i >= 0; --i) {
-                if (idsToRemove.contains(layerStrokes[i].id)) {
-                    UndoAction::StrokeSegment seg;
-                    seg.tileCoord = coord;
-                    seg.stroke = layerStrokes[i];
-                    undoAction.segments.append(seg);
-                    layerStrokes.removeAt(i);
-                }
+            QVector<VectorStroke> removed = layer->removeStrokes(idsToRemove);
+            for (int i = static_cast<int>(removed.size()) - 1; i >= 0; --i) {
+                UndoAction::StrokeSegment seg;
+                seg.tileCoord = coord;
+                seg.stroke = std::move(removed[i]);
+                undoAction.segments.append(seg);
             }
-            layer->invalidateStrokeCache();
             m_document->markTileDirty(coord);
         }
     } else {
@@ -12927,25 +13191,22 @@ void DocumentViewport::finalizeEraserLasso()
 
         undoAction.layerIndex = page->activeLayerIndex;
 
-        QSet<QString> idsToRemove;
-        for (const VectorStroke& stroke : layer->strokes()) {
-            if (strokeIntersectsLasso(stroke, m_lassoPath)) {
-                idsToRemove.insert(stroke.id);
+        QVector<Id128> idsToRemove;
+        const QVector<VectorStroke>& strokes = std::as_const(*layer).strokes();
+        for (int i : layer->strokeIndicesIntersecting(m_lassoPath.boundingRect())) {
+            if (strokeIntersectsLasso(strokes[i], m_lassoPath)) {
+                idsToRemove.append(strokes[i].id);
             }
         }
 
         if (!idsToRemove.isEmpty()) {
-            QVector<VectorStroke>& layerStrokes = layer->strokes();
-            for (int i = static_cast<int>(layerStrokes.size()) - 1; i >= 0; --i) {
-                if (idsToRemove.contains(layerStrokes[i].id)) {
-                    UndoAction::StrokeSegment seg;
-                    seg.pageIndex = m_eraserLassoPageIndex;
-                    seg.stroke = layerStrokes[i];
-                    undoAction.segments.append(seg);
-                    layerStrokes.removeAt(i);
-                }
+            QVector<VectorStroke> removed = layer->removeStrokes(idsToRemove);
+            for (int i = static_cast<int>(removed.size()) - 1; i >= 0; --i) {
+                UndoAction::StrokeSegment seg;
+                seg.pageIndex = m_eraserLassoPageIndex;
+                seg.stroke = std::move(removed[i]);
+                undoAction.segments.append(seg);
             }
-            layer->invalidateStrokeCache();
             m_document->markPageDirty(m_eraserLassoPageIndex);
         }
     }
@@ -13184,7 +13445,7 @@ void DocumentViewport::trimUndoStack()
 //  all undo/redo is now handled by the unified undo() and redo() below)
 
 QVector<DocumentViewport::TileSegment> DocumentViewport::splitStrokeIntoTileSegments(
-    const QVector<StrokePoint>& points) const
+    const StrokePointList& points) const
 {
     QVector<TileSegment> segments;
     
@@ -13199,7 +13460,7 @@ QVector<DocumentViewport::TileSegment> DocumentViewport::splitStrokeIntoTileSegm
     
     // Walk through remaining points, detecting tile boundary crossings
     for (int i = 1; i < points.size(); ++i) {
-        const StrokePoint& pt = points[i];
+        const StrokePoint pt = points.at(i);
         Document::TileCoord ptTile = m_document->tileCoordForPoint(pt.pos);
         
         if (ptTile != currentSegment.coord) {
@@ -13261,6 +13522,30 @@ static void tryRemoveEmptyTile(Document* doc, const UndoAction::StrokeSegment& s
         doc->removeTileIfEmpty(seg.tileCoord.first, seg.tileCoord.second);
 }
 
+/// Remove the segments' strokes with one removeStrokes() call per layer, so
+/// undoing a large add or transform compacts each layer (and renumbers its
+/// index) once instead of once per stroke.
+static void removeSegmentStrokes(Document* doc, const QVector<UndoAction::StrokeSegment>& segs,
+                                 int layerIndex)
+{
+    QHash<VectorLayer*, QVector<Id128>> idsByLayer;
+    QVector<const UndoAction::StrokeSegment*> touched;
+    touched.reserve(segs.size());
+    for (const auto& seg : segs) {
+        Page* c = getContainer(doc, seg, false);
+        if (!c) continue;
+        if (VectorLayer* layer = c->layer(layerIndex))
+            idsByLayer[layer].append(seg.stroke.id);
+        touched.append(&seg);
+    }
+    for (auto it = idsByLayer.begin(); it != idsByLayer.end(); ++it)
+        it.key()->removeStrokes(it.value());
+    for (const auto* seg : std::as_const(touched))
+        markSegDirty(doc, *seg);
+    for (const auto* seg : std::as_const(touched))
+        tryRemoveEmptyTile(doc, *seg);
+}
+
 static Page* getObjContainer(Document* doc, const UndoAction& a, bool create)
 {
     if (doc->isEdgeless()) {
@@ -13484,14 +13769,7 @@ void DocumentViewport::undo()
         }
     } else if (action.type == UndoAction::TransformSelection) {
         // Remove added strokes
-        for (const auto& seg : action.addedSegments) {
-            Page* c = getContainer(m_document, seg, false);
-            if (!c) continue;
-            VectorLayer* layer = c->layer(action.layerIndex);
-            if (layer) layer->removeStroke(seg.stroke.id);
-            markSegDirty(m_document, seg);
-            tryRemoveEmptyTile(m_document, seg);
-        }
+        removeSegmentStrokes(m_document, action.addedSegments, action.layerIndex);
         // Restore removed strokes
         for (const auto& seg : action.removedSegments) {
             Page* c = getContainer(m_document, seg, true);
@@ -13526,7 +13804,7 @@ void DocumentViewport::undo()
         // and rasterized overlay would otherwise still paint the post-recolor
         // color even after undo restored the underlying layer to OLD colors.
         if (m_lassoSelection.isValid() && !m_lassoSelection.selectedStrokes.isEmpty()) {
-            QHash<QString, QColor> oldById;
+            QHash<Id128, QColor> oldById;
             oldById.reserve(action.segments.size());
             for (const auto& seg : action.segments)
                 oldById.insert(seg.stroke.id, seg.stroke.color);
@@ -13543,10 +13821,11 @@ void DocumentViewport::undo()
                 m_selectionCacheDirty = true;
             }
         }
+    } else if (action.type == UndoAction::AddStroke) {
+        removeSegmentStrokes(m_document, action.segments, action.layerIndex);
     } else {
         for (const auto& seg : action.segments) {
-            Page* c = getContainer(m_document, seg,
-                                   action.type != UndoAction::AddStroke);
+            Page* c = getContainer(m_document, seg, true);
             if (!c) continue;
             while (c->layerCount() <= action.layerIndex)
                 c->addLayer(QString("Layer %1").arg(c->layerCount() + 1));
@@ -13554,11 +13833,6 @@ void DocumentViewport::undo()
             if (!layer) continue;
 
             switch (action.type) {
-                case UndoAction::AddStroke:
-                    layer->removeStroke(seg.stroke.id);
-                    markSegDirty(m_document, seg);
-                    tryRemoveEmptyTile(m_document, seg);
-                    break;
                 case UndoAction::RemoveStroke:
                 case UndoAction::RemoveMultiple:
                     layer->addStroke(seg.stroke);
@@ -13808,14 +14082,7 @@ void DocumentViewport::redo()
         }
     } else if (action.type == UndoAction::TransformSelection) {
         // Remove original strokes (redo the remove)
-        for (const auto& seg : action.removedSegments) {
-            Page* c = getContainer(m_document, seg, false);
-            if (!c) continue;
-            VectorLayer* layer = c->layer(action.layerIndex);
-            if (layer) layer->removeStroke(seg.stroke.id);
-            markSegDirty(m_document, seg);
-            tryRemoveEmptyTile(m_document, seg);
-        }
+        removeSegmentStrokes(m_document, action.removedSegments, action.layerIndex);
         // Add transformed strokes (redo the add)
         for (const auto& seg : action.addedSegments) {
             Page* c = getContainer(m_document, seg, true);
@@ -13829,7 +14096,7 @@ void DocumentViewport::redo()
     } else if (action.type == UndoAction::RecolorStrokes) {
         // In-place re-apply of the stored target color, preserving each
         // stroke's existing alpha (matches recolorLassoSelection's policy).
-        QSet<QString> actionIds;
+        QSet<Id128> actionIds;
         actionIds.reserve(action.segments.size());
         for (const auto& seg : action.segments) {
             actionIds.insert(seg.stroke.id);
@@ -13867,6 +14134,9 @@ void DocumentViewport::redo()
                 m_selectionCacheDirty = true;
             }
         }
+    } else if (action.type == UndoAction::RemoveStroke
+               || action.type == UndoAction::RemoveMultiple) {
+        removeSegmentStrokes(m_document, action.segments, action.layerIndex);
     } else {
         for (const auto& seg : action.segments) {
             Page* c = getContainer(m_document, seg,
@@ -13882,12 +14152,6 @@ void DocumentViewport::redo()
                     layer->addStroke(seg.stroke);
                     markSegDirty(m_document, seg);
                     break;
-                case UndoAction::RemoveStroke:
-                case UndoAction::RemoveMultiple:
-                    layer->removeStroke(seg.stroke.id);
-                    markSegDirty(m_document, seg);
-                    tryRemoveEmptyTile(m_document, seg);
-                    break;
                 default: break;
             }
         }
@@ -14276,8 +14540,6 @@ void DocumentViewport::renderPage(QPainter& painter, Page* page, int pageIndex)
 {
     if (!page || !m_document) return;
     
-    Q_UNUSED(pageIndex);  // Used for PDF page lookup via page->pdfPageNumber
-    
     QSizeF pageSize = page->size;
     QRectF pageRect(0, 0, pageSize.width(), pageSize.height());
     
@@ -14291,27 +14553,26 @@ void DocumentViewport::renderPage(QPainter& painter, Page* page, int pageIndex)
             break;
             
         case Page::BackgroundType::PDF:
-            // Render PDF page from cache (Task 1.3.6), resolving the page's own source.
-            if (page->pdfPageNumber >= 0) {
-                PdfProvider* prov = m_document->providerForSource(page->pdfSourceId);
-                // Skip pages whose original number can't be served by the resolved
-                // provider (e.g. a bundled source without the original PDF where the
-                // page isn't in the mini-PDF's page map). Rendering would return null
-                // and, since nulls aren't cached, retry on every repaint. Draw blank.
-                const int resolvedPage = m_document->resolveSourcePageIndex(page->pdfSourceId, page->pdfPageNumber);
-                if (prov && prov->isValid() && resolvedPage >= 0 && resolvedPage < prov->pageCount()) {
-                    qreal dpi = effectivePdfDpi();
+            // Render PDF page tiles from cache (Task 1.3.6), resolving the page's own source.
+            // pdfRasterForPage() rejects pages whose original number can't be served by
+            // the resolved provider (e.g. a bundled source without the original PDF where
+            // the page isn't in the mini-PDF's page map). Rendering would return null
+            // and, since nulls aren't cached, retry on every repaint. Draw blank.
+            {
+                const PdfPageRaster raster = pdfRasterForPage(page, effectivePdfDpi());
+                // Only the part of the page inside the viewport needs tiles.
+                const QRectF visiblePart = visibleRect().translated(-pagePosition(pageIndex))
+                                                        .intersected(pageRect);
+                if (raster.isValid() && !visiblePart.isEmpty()) {
                     // SP2: never render synchronously while scrolling - draw the
-                    // cached pixmap if present, else fall back to the page
-                    // background (already filled above). The settle handler
-                    // renders the final visible pages once scrolling stops.
-                    QPixmap pdfPixmap = isScrolling()
-                        ? lookupCachedPdfPage(page->pdfSourceId, page->pdfPageNumber, dpi)
-                        : getCachedPdfPage(page->pdfSourceId, page->pdfPageNumber, dpi);
-                    
-                    if (!pdfPixmap.isNull()) {
-                        // Scale pixmap to fit page rect
-                        painter.drawPixmap(pageRect.toRect(), pdfPixmap);
+                    // cached tiles (or a cached stand-in level) if present, else
+                    // fall back to the page background (already filled above).
+                    // The settle handler renders the final visible tiles once
+                    // scrolling stops.
+                    if (isScrolling()) {
+                        lookupCachedPdfPage(painter, raster, visiblePart);
+                    } else {
+                        getCachedPdfPage(painter, raster, visiblePart);
                     }
                 }
             }
@@ -14383,7 +14644,7 @@ void DocumentViewport::renderPage(QPainter& painter, Page* page, int pageIndex)
     // CR-2B-7: Check if this page has selected strokes that should be excluded
     bool hasSelectionOnThisPage = m_lassoSelection.isValid() && 
                                    m_lassoSelection.sourcePageIndex == pageIndex;
-    QSet<QString> excludeIds;
+    QSet<Id128> excludeIds;
     if (hasSelectionOnThisPage) {
         excludeIds = m_lassoSelection.getSelectedIds();
     }
@@ -14504,8 +14765,10 @@ void DocumentViewport::renderEdgelessMode(QPainter& painter)
         QPointF tileOrigin(coord.first * tileSize, coord.second * tileSize);
         QRectF tileRect(tileOrigin.x(), tileOrigin.y(), tileSize, tileSize);
         
-        // Check if tile exists - use its settings, otherwise use document defaults
-        Page* tile = m_document->getTile(coord.first, coord.second);
+        // Check if tile is loaded - use its settings, otherwise use document
+        // defaults. Paint never loads tiles: those still on disk are loaded
+        // in the background (scheduleTileLoads()) and appear when ready.
+        Page* tile = m_document->loadedTile(coord);
         
         if (tile) {
             // Existing tile: use its background settings
@@ -14531,6 +14794,11 @@ void DocumentViewport::renderEdgelessMode(QPainter& painter)
                 m_document->defaultLineSpacing,
                 1.0 / m_zoomLevel  // Constant pen width in screen pixels
             );
+            
+            // Content still loading: faint veil so it does not read as empty
+            if (m_document->tileExistsOnDisk(coord)) {
+                painter.fillRect(tileRect, QColor(128, 128, 128, 24));
+            }
         }
     }
     
@@ -14545,7 +14813,7 @@ void DocumentViewport::renderEdgelessMode(QPainter& painter)
     // First, determine the maximum layer count across all visible tiles
     int maxLayerCount = 0;
     for (const auto& coord : allTiles) {
-        Page* tile = m_document->getTile(coord.first, coord.second);
+        Page* tile = m_document->loadedTile(coord);
         if (tile) {
             maxLayerCount = qMax(maxLayerCount, tile->layerCount());
         }
@@ -14556,7 +14824,7 @@ void DocumentViewport::renderEdgelessMode(QPainter& painter)
     for (int layerIdx = 0; layerIdx < maxLayerCount; ++layerIdx) {
         // PASS 3a: Render this layer's strokes from all tiles
         for (const auto& coord : allTiles) {
-            Page* tile = m_document->getTile(coord.first, coord.second);
+            Page* tile = m_document->loadedTile(coord);
             if (!tile) continue;
             
             QPointF tileOrigin(coord.first * tileSize, coord.second * tileSize);
@@ -14643,7 +14911,7 @@ void DocumentViewport::dispatchTileLayer(QPainter& painter, VectorLayer* layer,
                                          int layerIdx,
                                          const QSizeF& tileSize,
                                          Document::TileCoord coord, qreal dpr,
-                                         const QSet<QString>& excludeIds)
+                                         const QSet<Id128>& excludeIds)
 {
     if (!layer || !layer->visible) return;
 
@@ -14692,7 +14960,7 @@ void DocumentViewport::renderTileStrokes(QPainter& painter, Page* tile, Document
     // Note: In edgeless mode, selected strokes are stored in document coordinates,
     // but they originated from specific tiles. We check by ID across all tiles
     // since a selection might span multiple tiles.
-    QSet<QString> excludeIds;
+    QSet<Id128> excludeIds;
     if (m_lassoSelection.isValid()) {
         excludeIds = m_lassoSelection.getSelectedIds();
     }
@@ -14721,7 +14989,7 @@ void DocumentViewport::renderTileLayerStrokes(QPainter& painter, Page* tile,
     qreal dpr = devicePixelRatioF();
 
     // CR-2B-7: Check if this layer has selected strokes that should be excluded
-    QSet<QString> excludeIds;
+    QSet<Id128> excludeIds;
     if (m_lassoSelection.isValid()) {
         excludeIds = m_lassoSelection.getSelectedIds();
     }
@@ -14763,7 +15031,7 @@ void DocumentViewport::renderEdgelessObjectsWithAffinity(
     
     // Iterate all loaded tiles and render objects with matching affinity
     for (const auto& coord : allTiles) {
-        Page* tile = m_document->getTile(coord.first, coord.second);
+        Page* tile = m_document->loadedTile(coord);
         if (!tile) continue;
         
         // Check if this tile has objects with this affinity
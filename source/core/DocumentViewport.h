@@ -28,6 +28,7 @@ enum class TouchGestureMode {
 #include "Document.h"
 #include "Page.h"
 #include "ToolType.h"
+#include "PdfTileCache.h"
 #include "../strokes/VectorStroke.h"
 #include "../pdf/PdfProvider.h"
 #include "../pdf/PdfSearchEngine.h"
@@ -165,7 +166,11 @@ struct UndoAction {
 #include <QTimer>
 #include <QMutex>
 #include <QFutureWatcher>
+#include <QThreadPool>
+#include <atomic>
 #include <deque>
+#include <set>
+#include <memory>
 
 // Forward declarations
 class QPaintEvent;
@@ -201,21 +206,39 @@ struct PageHit {
 };
 
 /**
- * @brief Cache entry for a rendered PDF page (Task 1.3.6).
+ * @brief One PDF page background as seen by the tiled PDF cache (Task 1.3.6).
  */
-struct PdfCacheEntry {
+struct PdfPageRaster {
     QString sourceId;       ///< PDF source id (empty = primary source)
-    int pageIndex = -1;     ///< Which page this is (-1 = invalid)
-    qreal dpi = 0;          ///< DPI at which it was rendered
-    QPixmap pixmap;         ///< The rendered PDF image
-    
-    bool isValid() const { return pageIndex >= 0 && !pixmap.isNull(); }
-    bool matches(const QString& source, int page, qreal targetDpi) const {
-        // Note: qFuzzyCompare doesn't work well near 0, so use relative comparison
-        if (sourceId != source) return false;
-        if (pageIndex != page) return false;
-        if (dpi == 0 || targetDpi == 0) return dpi == targetDpi;
-        return qFuzzyCompare(dpi, targetDpi);
+    int pageIndex = -1;     ///< Original PDF page number (-1 = invalid)
+    int level = 0;          ///< Target resolution level (PdfTileCache::levelForDpi)
+    QSizeF pagePts;         ///< PDF page size in points
+    QRectF pageRect;        ///< Page rect in page-local coordinates
+    
+    bool isValid() const { return pageIndex >= 0 && !pagePts.isEmpty(); }
+    
+    /// Full-page raster size at @p atLevel.
+    QSize pixelSize(int atLevel) const {
+        return PdfTileCache::pagePixelSize(pagePts, PdfTileCache::dpiForLevel(atLevel));
+    }
+    
+    /// Tile (tx, ty) at @p atLevel mapped into page-local coordinates.
+    QRectF tileRectInPage(int atLevel, int tx, int ty) const {
+        const QSize px = pixelSize(atLevel);
+        const QRect r = PdfTileCache::tilePixelRect(px, tx, ty);
+        const qreal sx = pageRect.width() / px.width();
+        const qreal sy = pageRect.height() / px.height();
+        return QRectF(pageRect.x() + r.x() * sx, pageRect.y() + r.y() * sy,
+                      r.width() * sx, r.height() * sy);
+    }
+    
+    /// Page-local rect mapped to full-page pixels at @p atLevel (rounded out).
+    QRect pixelRectForPageRect(int atLevel, const QRectF& rect) const {
+        const QSize px = pixelSize(atLevel);
+        const qreal sx = px.width() / pageRect.width();
+        const qreal sy = px.height() / pageRect.height();
+        return QRectF((rect.x() - pageRect.x()) * sx, (rect.y() - pageRect.y()) * sy,
+                      rect.width() * sx, rect.height() * sy).toAlignedRect();
     }
 };
 
@@ -2185,7 +2208,7 @@ private:
         qreal scaleX = 1.0, scaleY = 1.0;        ///< Current scale factors
         QPointF offset;                          ///< Move offset
         
-        mutable QSet<QString> m_cachedIds;       ///< Cached stroke IDs for CR-2B-7 exclusion
+        mutable QSet<Id128> m_cachedIds;         ///< Cached stroke IDs for CR-2B-7 exclusion
         
         bool isValid() const { return !selectedStrokes.isEmpty(); }
         bool hasTransform() const {
@@ -2197,7 +2220,7 @@ private:
         }
         /// CR-2B-7: Get set of selected stroke IDs for exclusion during layer render
         /// Uses cached set for performance (rebuilt when selection changes)
-        const QSet<QString>& getSelectedIds() const {
+        const QSet<Id128>& getSelectedIds() const {
             if (m_cachedIds.isEmpty() && !selectedStrokes.isEmpty()) {
                 for (const VectorStroke& s : selectedStrokes) {
                     m_cachedIds.insert(s.id);
@@ -2647,8 +2670,21 @@ private:
     static StrokeClipboard s_clipboard;
     
     // ----- Performance/Memory Settings -----
-    /// CUSTOMIZABLE: PDF cache capacity - higher = more RAM, smoother scrolling (range: 4-16)
-    int m_pdfCacheCapacity = 6;  // Default for single column (visible + ±2 buffer)
+    /// CUSTOMIZABLE: PDF tile cache budget bounds - higher = more RAM, smoother
+    /// scrolling/zooming. The effective budget scales with the viewport size.
+    static constexpr qint64 PDF_CACHE_MIN_BYTES = 64LL * 1024 * 1024;
+#if defined(Q_OS_ANDROID) || defined(Q_OS_IOS)
+    static constexpr qint64 PDF_CACHE_MAX_BYTES = 256LL * 1024 * 1024;
+#else
+    static constexpr qint64 PDF_CACHE_MAX_BYTES = 512LL * 1024 * 1024;
+#endif
+    /// CUSTOMIZABLE: Memory budget for loaded edgeless tiles (strokes, stroke
+    /// caches, images). Above it, tiles farthest from the view are evicted.
+#if defined(Q_OS_ANDROID) || defined(Q_OS_IOS)
+    static constexpr qint64 EDGELESS_TILE_BUDGET_BYTES = 192LL * 1024 * 1024;
+#else
+    static constexpr qint64 EDGELESS_TILE_BUDGET_BYTES = 512LL * 1024 * 1024;
+#endif
     /// CUSTOMIZABLE: Max undo actions - higher = more RAM (range: 10-200)
     static const int MAX_UNDO_ACTIONS = 100;
     
@@ -2657,14 +2693,30 @@ private:
     // =========================================================================
     
     // ===== PDF Cache State (Task 1.3.6) =====
-    QVector<PdfCacheEntry> m_pdfCache;
-    qreal m_cachedDpi = 0;       ///< DPI at which cache was rendered
-    mutable QMutex m_pdfCacheMutex;  ///< Mutex for thread-safe cache access
+    PdfTileCache m_pdfTileCache;         ///< Tiled multi-resolution PDF raster cache (thread-safe)
+    QSet<PdfTileKey> m_pendingPdfTiles;  ///< Tiles with an async render in flight
+    /// Level the viewport currently wants. Queued background renders for any
+    /// other level (stale after a zoom) skip themselves before rendering.
+    std::shared_ptr<std::atomic<int>> m_pdfWantedLevel = std::make_shared<std::atomic<int>>(0);
     
     // ===== Async PDF Preloading =====
     QTimer* m_pdfPreloadTimer = nullptr;  ///< Debounce timer for preload requests
     QList<QFutureWatcher<QImage>*> m_activePdfWatchers;  ///< Active async render operations (returns QImage for thread safety)
     static constexpr int PDF_PRELOAD_DELAY_MS = 150;   ///< Debounce delay (ms) before preloading
+    
+    // ===== Edgeless Tile Prefetch =====
+    /// Tiles are read and decoded off the GUI thread (Document::tileDecoder())
+    /// in the order predicted from the pan velocity; paint never loads them.
+    QThreadPool m_tileLoadPool;          ///< Workers for tile loads
+    QList<QFutureWatcher<std::shared_ptr<Document::DecodedTile>>*> m_activeTileWatchers;
+    std::set<Document::TileCoord> m_pendingTileLoads;  ///< Tiles with a load in flight
+    QPointF m_panVelocity;               ///< Smoothed view velocity (doc coords/ms)
+    QPointF m_lastTrackedPan;            ///< View origin at the last velocity sample
+    qint64 m_lastTrackedPanMs = -1;      ///< Time of the last sample (-1: none)
+    QElapsedTimer m_panVelocityClock;
+    static constexpr int MAX_TILE_LOADS_IN_FLIGHT = 4;
+    static constexpr int TILE_PREFETCH_LOOKAHEAD_MS = 400;  ///< How far ahead to predict the pan
+    static constexpr int PAN_VELOCITY_STALE_MS = 100;       ///< Older samples mean the view is still
 
     // ===== Scroll-activity gate (SP1) =====
     // The immediate-pan route (wheel/touchpad/scroll-bar) marks itself active on
@@ -2836,19 +2888,55 @@ private:
     // ===== PDF Cache Helpers (Task 1.3.6) =====
     
     /**
-     * @brief Get a cached PDF page pixmap, rendering if necessary.
-     * @param pageIndex The page index.
-     * @param dpi The target DPI.
-     * @return Cached or freshly rendered pixmap (may be null if not a PDF page).
+     * @brief Describe a page's PDF background for the tile cache.
+     * @return Invalid raster if the page has no renderable PDF background.
      */
-    QPixmap getCachedPdfPage(const QString& sourceId, int pageIndex, qreal dpi);
+    PdfPageRaster pdfRasterForPage(const Page* page, qreal dpi) const;
+    
+    /**
+     * @brief Draw a page's PDF background, rendering missing tiles if necessary.
+     * @param raster The page's PDF raster description.
+     * @param visibleRect Visible part of the page (page-local coordinates).
+     * 
+     * Tiles at the target level that have no cached stand-in are rendered
+     * synchronously (in one region render) so a freshly shown page is never
+     * blank; tiles that do have a stand-in are queued for async rendering
+     * and refine in place when they arrive.
+     */
+    void getCachedPdfPage(QPainter& painter, const PdfPageRaster& raster, const QRectF& visibleRect);
 
     /**
-     * @brief Cache-only PDF page lookup (SP2).
-     * Returns the cached pixmap, or a null QPixmap on a miss. Never renders, so
-     * it is safe to call on the paint path while scrolling (see isScrolling()).
+     * @brief Cache-only PDF page draw (SP2).
+     * Draws cached target-level tiles and, for missing ones, the nearest
+     * cached lower- or higher-resolution level. Never renders, so it is safe
+     * on the paint path while scrolling (see isScrolling()).
+     * @param uncovered If non-null, receives target tiles that had no stand-in.
+     * @return Target-level tiles that are not cached yet.
+     */
+    QVector<QPoint> lookupCachedPdfPage(QPainter& painter, const PdfPageRaster& raster,
+                                        const QRectF& visibleRect,
+                                        QVector<QPoint>* uncovered = nullptr);
+    
+    /**
+     * @brief Draw the nearest cached stand-in level for a missing tile.
+     * @return True if stand-in tiles fully covered the target tile.
+     */
+    bool drawPdfTileFallback(QPainter& painter, const PdfPageRaster& raster,
+                             int tx, int ty);
+    
+    /**
+     * @brief Queue a background render of target-level tiles of one page.
+     * Tiles already cached or in flight are skipped; the rest are rendered as
+     * one region and split into tiles on completion.
+     */
+    void requestPdfTiles(const PdfPageRaster& raster, const QVector<QPoint>& tiles);
+    
+    /**
+     * @brief Split a rendered region into tiles and insert them in the cache.
+     * @param image Rendered region (dark-mode processing not yet applied).
+     * @param region The region's rect in full-page pixels.
      */
-    QPixmap lookupCachedPdfPage(const QString& sourceId, int pageIndex, qreal dpi) const;
+    void insertPdfTiles(const PdfPageRaster& raster, QImage image, const QRect& region);
     
     /**
      * @brief Request PDF preload (debounced).
@@ -2896,21 +2984,15 @@ private:
     void invalidatePdfCachePage(const QString& sourceId, int pageIndex);
     
     /**
-     * @brief Update cache capacity based on visible pages and layout mode.
+     * @brief Update the tile cache memory budget from the viewport size.
      * 
-     * Capacity = visible_pages + buffer (3 for 1-column, 6 for 2-column).
-     * If capacity decreases, immediately evicts furthest entries.
+     * Budget = enough screens of tiles for the visible pages plus a buffer
+     * (3 for 1-column, 6 for 2-column), clamped to
+     * [PDF_CACHE_MIN_BYTES, PDF_CACHE_MAX_BYTES]. A smaller budget evicts
+     * least recently used tiles immediately.
      */
     void updatePdfCacheCapacity();
     
-    /**
-     * @brief Evict furthest cache entries until within capacity.
-     * 
-     * Must be called with m_pdfCacheMutex locked.
-     * Evicts pages furthest from m_currentPageIndex first.
-     */
-    void evictFurthestCacheEntries();
-    
     /**
      * @brief Invalidate page layout cache - call when pages added/removed/resized.
      */
@@ -2958,10 +3040,63 @@ private:
     /**
      * @brief Evict tiles that are far from the visible area.
      * 
-     * For edgeless mode with lazy loading enabled, this saves dirty tiles
-     * and removes them from memory to bound memory usage.
+     * For edgeless mode with lazy loading enabled: while the loaded tiles
+     * exceed EDGELESS_TILE_BUDGET_BYTES, saves dirty tiles and removes them
+     * from memory, farthest from the view first. Tiles that are visible or
+     * on the predicted pan path are never evicted.
      */
     void evictDistantTiles();
+    
+    // ===== Edgeless Tile Prefetch =====
+    
+    /**
+     * @brief Order in which to load edgeless tiles for a moving view.
+     * @param viewRect Visible rect in document coordinates.
+     * @param motion Expected pan over the lookahead window (doc coords).
+     * @param marginTiles Ring of tiles around the view and its path to include.
+     * @param pathCount If set, receives how many leading entries are visible
+     *        or on the predicted path (the rest is the margin ring).
+     * @return Tile coordinates: visible tiles first (nearest to the view
+     *         center first), then path tiles in the order the moving view
+     *         reaches them, then the margin ring, nearest first.
+     */
+    static QVector<Document::TileCoord> predictTileFetchOrder(const QRectF& viewRect,
+                                                              const QPointF& motion,
+                                                              int marginTiles = 1,
+                                                              int* pathCount = nullptr);
+    
+    /**
+     * @brief Visible rect including an in-flight pan gesture.
+     */
+    QRectF effectiveVisibleRect() const;
+    
+    /**
+     * @brief Expected pan over the next TILE_PREFETCH_LOOKAHEAD_MS.
+     * 
+     * The remaining touch inertia glide if one is running, otherwise the
+     * smoothed pan velocity (zero once the view has been still for a while).
+     */
+    QPointF predictedPanMotion() const;
+    
+    /**
+     * @brief Sample the view position into the smoothed pan velocity.
+     */
+    void trackPanVelocity();
+    
+    /**
+     * @brief Start background loads for unloaded tiles the view needs next.
+     * 
+     * Runs from every paint in edgeless mode. Loads the tiles of
+     * predictTileFetchOrder() that exist on disk, at most
+     * MAX_TILE_LOADS_IN_FLIGHT at once; tiles on the predicted path also get
+     * their stroke caches pre-rendered on the worker.
+     */
+    void scheduleTileLoads();
+    
+    /**
+     * @brief Cancel background tile loads and block until they complete.
+     */
+    void cancelTileLoads();
 
     /**
      * @brief Release focus caches when zoom drops below the cap threshold.
@@ -3446,7 +3581,7 @@ private:
      * 
      * @return List of created stroke IDs.
      */
-    QVector<QString> createHighlightStrokes();
+    QVector<Id128> createHighlightStrokes();
     
     /**
      * @brief Update cursor based on Highlighter tool availability.
@@ -3564,7 +3699,7 @@ private:
      */
     struct TileSegment {
         Document::TileCoord coord;      ///< The tile this segment belongs to
-        QVector<StrokePoint> points;    ///< Points in document coordinates
+        StrokePointList points;         ///< Points in document coordinates
     };
     
     /**
@@ -3584,7 +3719,7 @@ private:
      * @param points The stroke points in document coordinates.
      * @return Vector of TileSegments, each containing points for one tile.
      */
-    QVector<TileSegment> splitStrokeIntoTileSegments(const QVector<StrokePoint>& points) const;
+    QVector<TileSegment> splitStrokeIntoTileSegments(const StrokePointList& points) const;
     
     // ===== Rendering Helpers (Task 1.3.3) =====
     
@@ -3697,7 +3832,7 @@ private:
      */
     void dispatchTileLayer(QPainter& painter, VectorLayer* layer, int layerIdx,
                            const QSizeF& tileSize, Document::TileCoord coord,
-                           qreal dpr, const QSet<QString>& excludeIds);
+                           qreal dpr, const QSet<Id128>& excludeIds);
     
     /**
      * @brief Render objects with a specific affinity from all loaded tiles.
@@ -370,6 +370,122 @@ public:
         return true;
     }
     
+    /**
+     * @brief Test tiled PDF cache levels, tile geometry and byte budget.
+     */
+    static bool testPdfTileCache() {
+        printf("  testPdfTileCache... ");
+        
+        // Levels snap up and round-trip exactly at level DPIs
+        if (PdfTileCache::levelForDpi(96.0) != 0 || PdfTileCache::levelForDpi(192.0) != 4) {
+            printf("FAILED: exact octave DPIs should map to levels 0 and 4\n");
+            return false;
+        }
+        for (qreal dpi : { 50.0, 96.0, 110.0, 144.0, 200.0, 299.0, 300.0, 600.0 }) {
+            const int level = PdfTileCache::levelForDpi(dpi);
+            if (PdfTileCache::dpiForLevel(level) + 1e-9 < qMin(dpi, PdfTileCache::MAX_DPI)) {
+                printf("FAILED: level for %.1f DPI renders blurrier than requested\n", dpi);
+                return false;
+            }
+            if (level > PdfTileCache::levelForDpi(PdfTileCache::MAX_DPI)) {
+                printf("FAILED: level for %.1f DPI exceeds the DPI cap\n", dpi);
+                return false;
+            }
+        }
+        
+        // US Letter at 96 DPI is 816x1056: 2x3 tiles, clipped at the edges
+        const QSize pagePx = PdfTileCache::pagePixelSize(QSizeF(612, 792), 96.0);
+        if (pagePx != QSize(816, 1056)) {
+            printf("FAILED: page pixel size %dx%d\n", pagePx.width(), pagePx.height());
+            return false;
+        }
+        if (PdfTileCache::tilesCovering(pagePx, QRect(QPoint(0, 0), pagePx)).size() != 6) {
+            printf("FAILED: full page should cover 6 tiles\n");
+            return false;
+        }
+        if (PdfTileCache::tilePixelRect(pagePx, 1, 2) != QRect(512, 1024, 304, 32)) {
+            printf("FAILED: edge tile not clipped to the page\n");
+            return false;
+        }
+        const QVector<QPoint> inner = PdfTileCache::tilesCovering(pagePx, QRect(500, 500, 20, 20));
+        if (inner.size() != 4 || inner.first() != QPoint(0, 0) || inner.last() != QPoint(1, 1)) {
+            printf("FAILED: rect straddling a tile corner should cover 4 tiles\n");
+            return false;
+        }
+        
+        // Byte budget with LRU eviction (64x64 ARGB32 tile = 16 KiB)
+        QPixmap tile(64, 64);
+        tile.fill(Qt::white);
+        const qint64 tileBytes = qint64(tile.width()) * tile.height() * (tile.depth() / 8);
+        PdfTileCache cache(tileBytes * 3);
+        auto key = [](int tx) { return PdfTileKey{ QString(), 0, 0, tx, 0 }; };
+        cache.insert(key(0), tile);
+        cache.insert(key(1), tile);
+        cache.insert(key(2), tile);
+        cache.find(key(0));          // 1 is now least recently used
+        cache.insert(key(3), tile);
+        if (cache.contains(key(1)) || !cache.contains(key(0)) || !cache.contains(key(3))) {
+            printf("FAILED: LRU tile not evicted first\n");
+            return false;
+        }
+        if (cache.bytesUsed() > cache.budgetBytes()) {
+            printf("FAILED: cache over budget\n");
+            return false;
+        }
+        cache.insert(PdfTileKey{ QString(), 0, 4, 0, 0 }, tile);
+        cache.removePage(QString(), 0);
+        if (cache.tileCount() != 0 || cache.bytesUsed() != 0) {
+            printf("FAILED: removePage should drop every level of the page\n");
+            return false;
+        }
+        
+        printf("PASSED\n");
+        return true;
+    }
+    
+    /**
+     * @brief Test the edgeless tile prefetch order for a moving view.
+     */
+    static bool testTileFetchOrder() {
+        printf("  testTileFetchOrder... ");
+        
+        using Coord = Document::TileCoord;
+        const QRectF view(0, 0, 1000, 800);  // Inside tile (0, 0)
+        
+        // At rest: the visible tile, then the ring around it
+        int pathCount = -1;
+        QVector<Coord> order = DocumentViewport::predictTileFetchOrder(view, QPointF(), 1, &pathCount);
+        if (order.size() != 9 || order.first() != Coord(0, 0) || pathCount != 1) {
+            printf("FAILED: resting view should fetch its tile, then 8 neighbours\n");
+            return false;
+        }
+        
+        // Panning right: tiles in the order the view reaches them, ring last
+        order = DocumentViewport::predictTileFetchOrder(view, QPointF(3000, 0), 1, &pathCount);
+        const QVector<Coord> path = { {0, 0}, {1, 0}, {2, 0}, {3, 0} };
+        if (pathCount != path.size() || order.mid(0, path.size()) != path) {
+            printf("FAILED: tiles along a rightward pan out of order\n");
+            return false;
+        }
+        if (order.size() != 6 * 3) {
+            printf("FAILED: swept area plus ring should be 18 tiles, got %d\n", int(order.size()));
+            return false;
+        }
+        
+        // Panning up-left: all three neighbours are reached at the same
+        // moment, so the nearest comes first
+        order = DocumentViewport::predictTileFetchOrder(QRectF(100, 100, 800, 600),
+                                                        QPointF(-500, -500), 0, &pathCount);
+        const QVector<Coord> diagonal = { {0, 0}, {0, -1}, {-1, 0}, {-1, -1} };
+        if (order != diagonal || pathCount != 4) {
+            printf("FAILED: diagonal pan order\n");
+            return false;
+        }
+        
+        printf("PASSED\n");
+        return true;
+    }
+    
     /**
      * @brief Test PointerEvent creation from mouse events.
      */
@@ -437,6 +553,8 @@ public:
         runTest(testVisiblePages, "testVisiblePages");
         runTest(testScrollFractions, "testScrollFractions");
         runTest(testPdfCache, "testPdfCache");
+        runTest(testPdfTileCache, "testPdfTileCache");
+        runTest(testTileFetchOrder, "testTileFetchOrder");
         runTest(testPointerEvents, "testPointerEvents");
         
         printf("\n=== Results: %d passed, %d failed ===\n\n", passed, failed);
@@ -0,0 +1,176 @@
+// ============================================================================
+// Id128 - Implementation
+// ============================================================================
+
+#include "Id128.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QReadWriteLock>
+#include <QVector>
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Intern table for non-UUID id text
+// ---------------------------------------------------------------------------
+// Ids are decoded on worker threads (page loading, export preparation), so
+// the table is guarded; lookups of already-interned text take the read lock.
+
+struct InternTable {
+    QReadWriteLock lock;
+    QHash<QString, quint64> slots;   ///< Text -> slot (1-based)
+    QVector<QString> texts;          ///< Slot - 1 -> text
+};
+
+InternTable& internTable()
+{
+    static InternTable table;
+    return table;
+}
+
+quint64 intern(const QString& text)
+{
+    InternTable& table = internTable();
+    {
+        QReadLocker locker(&table.lock);
+        auto it = table.slots.constFind(text);
+        if (it != table.slots.constEnd()) {
+            return *it;
+        }
+    }
+    QWriteLocker locker(&table.lock);
+    auto it = table.slots.constFind(text);  // Raced with another writer?
+    if (it != table.slots.constEnd()) {
+        return *it;
+    }
+    table.texts.append(text);
+    const quint64 slot = quint64(table.texts.size());
+    table.slots.insert(text, slot);
+    return slot;
+}
+
+inline int hexValue(uint c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;  // Upper case is not canonical: it is interned verbatim
+}
+
+/// Dash positions of the canonical 8-4-4-4-12 form.
+inline bool isDashPosition(int i)
+{
+    return i == 8 || i == 13 || i == 18 || i == 23;
+}
+
+/**
+ * @brief Parse canonical lowercase "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx".
+ * @param code Maps a character index to its code point (UTF-16 or bytes).
+ */
+template <typename CodeAt>
+bool parseCanonical(int size, CodeAt code, quint64& hi, quint64& lo)
+{
+    if (size != 36) {
+        return false;
+    }
+    quint64 words[2] = { 0, 0 };
+    int nibble = 0;
+    for (int i = 0; i < 36; ++i) {
+        const uint c = code(i);
+        if (isDashPosition(i)) {
+            if (c != '-') return false;
+            continue;
+        }
+        const int v = hexValue(c);
+        if (v < 0) return false;
+        quint64& word = words[nibble / 16];
+        word = (word << 4) | quint64(v);
+        ++nibble;
+    }
+    hi = words[0];
+    lo = words[1];
+    return true;
+}
+
+} // namespace
+
+Id128 Id128::create()
+{
+    QRandomGenerator* rng = QRandomGenerator::global();
+    quint64 hi = rng->generate64();
+    quint64 lo = rng->generate64();
+    // Version 4 and RFC 4122 variant, same layout as QUuid::createUuid().
+    hi = (hi & ~quint64(0xf000)) | quint64(0x4000);
+    lo = (lo & ~(quint64(0xc) << 60)) | (quint64(0x8) << 60);
+    return Id128(hi, lo);
+}
+
+Id128 Id128::fromString(const QString& text)
+{
+    if (text.isEmpty()) {
+        return Id128();
+    }
+    quint64 hi = 0;
+    quint64 lo = 0;
+    // hi == 0 is reserved for interned ids; a canonical UUID with all-zero
+    // high bits (only the nil UUID in practice) is interned like any text.
+    const QChar* data = text.constData();
+    if (parseCanonical(int(text.size()), [data](int i) { return uint(data[i].unicode()); }, hi, lo)
+        && hi != 0) {
+        return Id128(hi, lo);
+    }
+    return Id128(0, intern(text));
+}
+
+Id128 Id128::fromUtf8(const char* data, int size)
+{
+    if (size <= 0) {
+        return Id128();
+    }
+    // Page containers store ids as UTF-8; parse canonical UUIDs straight
+    // from the bytes without building a QString.
+    quint64 hi = 0;
+    quint64 lo = 0;
+    if (parseCanonical(size, [data](int i) { return uint(uchar(data[i])); }, hi, lo)
+        && hi != 0) {
+        return Id128(hi, lo);
+    }
+    return Id128(0, intern(QString::fromUtf8(data, size)));
+}
+
+QString Id128::toString() const
+{
+    if (isNull()) {
+        return QString();
+    }
+    if (isInterned()) {
+        InternTable& table = internTable();
+        QReadLocker locker(&table.lock);
+        const qint64 index = qint64(m_lo) - 1;
+        return index < table.texts.size() ? table.texts[int(index)] : QString();
+    }
+
+    static const char digits[] = "0123456789abcdef";
+    QChar out[36];
+    const quint64 words[2] = { m_hi, m_lo };
+    int nibble = 0;
+    for (int i = 0; i < 36; ++i) {
+        if (isDashPosition(i)) {
+            out[i] = QLatin1Char('-');
+            continue;
+        }
+        const quint64 word = words[nibble / 16];
+        const int shift = 60 - (nibble % 16) * 4;
+        out[i] = QLatin1Char(digits[(word >> shift) & 0xf]);
+        ++nibble;
+    }
+    return QString(out, 36);
+}
+
+QDebug operator<<(QDebug dbg, const Id128& id)
+{
+    QDebugStateSaver saver(dbg);
+    dbg.nospace() << "Id128(" << id.toString() << ')';
+    return dbg;
+}
@@ -0,0 +1,104 @@
+#ifndef ID128_H
+#define ID128_H
+
+// ============================================================================
+// Id128 - Compact 128-bit identifier for strokes and pages
+// ============================================================================
+// Strokes and pages are identified by UUIDs. Keeping them as 36-character
+// QStrings costs a heap block of ~100 bytes per id and a string hash on every
+// eraser/undo/page-cache lookup. Id128 stores the 16 UUID bytes inline and
+// hashes/compares as two integers; text is produced only where ids are
+// written to JSON, page containers or other external formats.
+//
+// Ids that are not canonical lowercase UUIDs (hand-written test ids, ids from
+// foreign files, upper-case UUIDs) are interned in a process-wide table so
+// fromString()/toString() always round-trip the exact original text.
+// ============================================================================
+
+#include <QMetaType>
+#include <QString>
+#include <QUuid>
+
+#include <functional>
+
+class QDebug;
+
+/**
+ * @brief 16-byte id value: a packed UUID or a handle to interned text.
+ *
+ * Packed UUIDs keep their RFC 4122 byte order in (hi, lo), so ordering by
+ * Id128 matches ordering by the canonical lowercase text. Interned ids use
+ * hi == 0, a range no generated UUID occupies (its version nibble is never
+ * zero).
+ */
+class Id128 {
+public:
+    constexpr Id128() = default;
+
+    /**
+     * @brief Generate a new random id (UUID version 4).
+     */
+    static Id128 create();
+
+    /**
+     * @brief Parse an id from text.
+     * @param text Canonical UUIDs are packed directly; any other non-empty
+     *             text is interned. Empty text gives a null id.
+     */
+    static Id128 fromString(const QString& text);
+
+    /**
+     * @brief Same as fromString() for UTF-8 text (binary page containers).
+     */
+    static Id128 fromUtf8(const char* data, int size);
+
+    /**
+     * @brief Text form: canonical lowercase UUID without braces, the original
+     *        interned text, or an empty string for a null id.
+     */
+    QString toString() const;
+
+    bool isNull() const { return m_hi == 0 && m_lo == 0; }
+
+    /// True if this id refers to interned (non-UUID) text.
+    bool isInterned() const { return m_hi == 0 && m_lo != 0; }
+
+    quint64 hi() const { return m_hi; }
+    quint64 lo() const { return m_lo; }
+
+    friend bool operator==(const Id128& a, const Id128& b) {
+        return a.m_hi == b.m_hi && a.m_lo == b.m_lo;
+    }
+    friend bool operator!=(const Id128& a, const Id128& b) { return !(a == b); }
+    friend bool operator<(const Id128& a, const Id128& b) {
+        return a.m_hi < b.m_hi || (a.m_hi == b.m_hi && a.m_lo < b.m_lo);
+    }
+
+private:
+    constexpr Id128(quint64 hi, quint64 lo) : m_hi(hi), m_lo(lo) {}
+
+    quint64 m_hi = 0;
+    quint64 m_lo = 0;
+};
+
+Q_DECLARE_TYPEINFO(Id128, Q_PRIMITIVE_TYPE);
+Q_DECLARE_METATYPE(Id128)
+
+/// Debug output uses the text form.
+QDebug operator<<(QDebug dbg, const Id128& id);
+
+inline size_t qHash(const Id128& id, size_t seed = 0) noexcept
+{
+    // UUID bits are already uniformly random; fold them instead of rehashing.
+    const quint64 x = id.hi() ^ (id.lo() * 0x9e3779b97f4a7c15ull);
+    return static_cast<size_t>(x ^ (x >> 32)) ^ seed;
+}
+
+namespace std {
+template <>
+struct hash<Id128> {
+    size_t operator()(const Id128& id) const noexcept { return qHash(id); }
+};
+} // namespace std
+
+#endif // ID128_H
@@ -0,0 +1,897 @@
+// ============================================================================
+// LibrarySearchIndex - Implementation
+// ============================================================================
+//
+// Layout (all integers little-endian):
+//
+//   Header   char[4] "SNLS" | u16 version | u16 reserved | u64 reserved
+//   Records  back to back, each:
+//            u32 payloadSize | u32 checksum (low half of the FNV-1a of the
+//            payload) | payload
+//   Payload  QDataStream (Qt 5.12 format):
+//            u8 kind | QString bundlePath | u64 stamp
+//            | QByteArray bloom (u64 words) | QByteArray qCompress(text as UTF-16)
+//
+// Removed notebooks get a record with an empty filter and text. Records are
+// read in order and the last one of a path wins; a scan stops at the first
+// torn or corrupt record and the next flush() rewrites the file.
+// ============================================================================
+
+#include "LibrarySearchIndex.h"
+#include "Document.h"
+#include "NotebookLibrary.h"
+#include "../ocr/OcrTextBlock.h"
+#include "../pdf/PdfSearchEngine.h"
+#include "../pdf/PdfSearchIndex.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'N', 'L', 'S'};
+constexpr int kHeaderSize = 16;
+constexpr int kRecordHeaderSize = 8;
+
+/// Rewrite instead of appending once stale bytes outweigh live ones.
+constexpr qint64 kMinGarbageToRewrite = 1024 * 1024;
+
+/// Bumped when collectNotebookText() changes, so every notebook is re-read.
+constexpr quint64 kTextVersion = 1;
+
+/// Bloom filter sizing: ~0.7% false positives per trigram.
+constexpr quint64 kBloomBitsPerTrigram = 12;
+constexpr int kBloomProbes = 4;
+constexpr quint64 kMinBloomBits = 512;
+
+/// Candidates verified between two result batches.
+constexpr int kVerifyWindow = 64;
+
+template <typename T>
+void appendLE(QByteArray& buf, T v)
+{
+    char b[sizeof(T)];
+    qToLittleEndian(v, b);
+    buf.append(b, sizeof(T));
+}
+
+quint32 payloadChecksum(const char* data, qint64 size)
+{
+    quint64 h = 0xcbf29ce484222325ULL;
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    for (qint64 i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return quint32(h);
+}
+
+QByteArray makeHeader()
+{
+    QByteArray header;
+    header.reserve(kHeaderSize);
+    header.append(kMagic, 4);
+    appendLE<quint16>(header, LibrarySearchIndex::FORMAT_VERSION);
+    appendLE<quint16>(header, 0);
+    appendLE<quint64>(header, 0);
+    return header;
+}
+
+void appendRecord(QByteArray& buf, const QByteArray& payload)
+{
+    appendLE<quint32>(buf, quint32(payload.size()));
+    appendLE<quint32>(buf, payloadChecksum(payload.constData(), payload.size()));
+    buf.append(payload);
+}
+
+/// splitmix64 finalizer; spreads trigram codes over the filter.
+inline quint64 mix64(quint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+QVector<quint64> buildBloom(const QVector<quint64>& trigrams)
+{
+    quint64 bits = kMinBloomBits;
+    while (bits < quint64(trigrams.size()) * kBloomBitsPerTrigram) {
+        bits <<= 1;
+    }
+    QVector<quint64> words(int(bits / 64), 0);
+    const quint64 mask = bits - 1;
+    for (quint64 trigram : trigrams) {
+        const quint64 h = mix64(trigram);
+        const quint64 h1 = quint32(h);
+        const quint64 h2 = quint32(h >> 32) | 1u;
+        for (int i = 0; i < kBloomProbes; ++i) {
+            const quint64 bit = (h1 + quint64(i) * h2) & mask;
+            words[int(bit >> 6)] |= quint64(1) << (bit & 63);
+        }
+    }
+    return words;
+}
+
+/// Whether every hashed trigram of @p hashes may be in @p bloom.
+bool bloomMayContain(const QVector<quint64>& bloom, const QVector<quint64>& hashes)
+{
+    if (bloom.isEmpty()) {
+        return hashes.isEmpty();
+    }
+    const quint64 mask = quint64(bloom.size()) * 64 - 1;
+    for (quint64 h : hashes) {
+        const quint64 h1 = quint32(h);
+        const quint64 h2 = quint32(h >> 32) | 1u;
+        for (int i = 0; i < kBloomProbes; ++i) {
+            const quint64 bit = (h1 + quint64(i) * h2) & mask;
+            if (!(bloom[int(bit >> 6)] & (quint64(1) << (bit & 63)))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QByteArray bloomBytes(const QVector<quint64>& bloom)
+{
+    QByteArray out;
+    out.reserve(bloom.size() * 8);
+    for (quint64 word : bloom) {
+        appendLE<quint64>(out, word);
+    }
+    return out;
+}
+
+QVector<quint64> bloomFromBytes(const QByteArray& bytes)
+{
+    QVector<quint64> bloom(int(bytes.size() / 8));
+    const uchar* p = reinterpret_cast<const uchar*>(bytes.constData());
+    for (int i = 0; i < bloom.size(); ++i) {
+        bloom[i] = qFromLittleEndian<quint64>(p + i * 8);
+    }
+    return bloom;
+}
+
+QByteArray compressText(const QString& text)
+{
+    if (text.isEmpty()) {
+        return QByteArray();
+    }
+    return qCompress(QByteArray(reinterpret_cast<const char*>(text.utf16()),
+                                int(text.size() * sizeof(char16_t))));
+}
+
+bool uncompressText(const QByteArray& blob, QString& text)
+{
+    text.clear();
+    if (blob.isEmpty()) {
+        return true;
+    }
+    const QByteArray raw = qUncompress(blob);
+    if (raw.isEmpty() || raw.size() % int(sizeof(char16_t)) != 0) {
+        return false;
+    }
+    text = QString(reinterpret_cast<const QChar*>(raw.constData()),
+                   int(raw.size() / int(sizeof(char16_t))));
+    return true;
+}
+
+QByteArray encodePayload(quint8 kind, const QString& bundlePath, quint64 stamp,
+                         const QVector<quint64>& bloom, const QString& text)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << kind << bundlePath << stamp << bloomBytes(bloom) << compressText(text);
+    return payload;
+}
+
+/// Read the record at @p offset of @p file. Returns false at the end of the
+/// file or on a torn or corrupt record.
+bool readRecord(QFile& file, qint64 offset, QByteArray& payload)
+{
+    if (!file.seek(offset)) {
+        return false;
+    }
+    const QByteArray head = file.read(kRecordHeaderSize);
+    if (head.size() != kRecordHeaderSize) {
+        return false;
+    }
+    const uchar* p = reinterpret_cast<const uchar*>(head.constData());
+    const quint32 payloadSize = qFromLittleEndian<quint32>(p);
+    if (payloadSize > quint64(file.size() - offset - kRecordHeaderSize)) {
+        return false;
+    }
+    payload = file.read(payloadSize);
+    return payload.size() == int(payloadSize)
+        && payloadChecksum(payload.constData(), payloadSize) == qFromLittleEndian<quint32>(p + 4);
+}
+
+} // namespace
+
+LibrarySearchIndex* LibrarySearchIndex::s_instance = nullptr;
+
+LibrarySearchIndex* LibrarySearchIndex::instance()
+{
+    if (!s_instance) {
+        const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        QDir().mkpath(dataPath);
+        s_instance = new LibrarySearchIndex(dataPath + "/" + fileName(),
+                                            QCoreApplication::instance());
+
+        NotebookLibrary* library = NotebookLibrary::instance();
+        connect(library, &NotebookLibrary::notebookUpdated,
+                s_instance, &LibrarySearchIndex::refresh);
+        connect(library, &NotebookLibrary::notebookRemoved,
+                s_instance, &LibrarySearchIndex::remove);
+
+        // Catch up with saves made while the index did not exist.
+        QStringList paths;
+        for (const NotebookInfo& nb : library->recentNotebooks()) {
+            paths.append(nb.bundlePath);
+        }
+        s_instance->refreshAll(paths);
+    }
+    return s_instance;
+}
+
+LibrarySearchIndex::LibrarySearchIndex(const QString& path, QObject* parent)
+    : QObject(parent)
+    , m_path(path)
+{
+    m_indexPool.setMaxThreadCount(1);
+    m_queryPool.setMaxThreadCount(1);
+}
+
+LibrarySearchIndex::~LibrarySearchIndex()
+{
+    m_cancelled.store(true);
+    cancelQuery();
+    m_indexPool.waitForDone();
+    m_queryPool.waitForDone();
+    if (m_loaded.load()) {
+        flush();
+    }
+    if (s_instance == this) {
+        s_instance = nullptr;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Indexing
+// ----------------------------------------------------------------------------
+
+void LibrarySearchIndex::refresh(const QString& bundlePath)
+{
+    enqueue({bundlePath});
+}
+
+void LibrarySearchIndex::refreshAll(const QStringList& bundlePaths)
+{
+    QSet<QString> keep;
+    for (const QString& path : bundlePaths) {
+        keep.insert(path);
+    }
+
+    QMutexLocker lock(&m_queueMutex);
+    // Notebooks the library no longer lists are dropped by the indexing
+    // thread, once the file is loaded.
+    m_keepOnly = keep;
+    m_pruneQueued = true;
+    enqueueLocked(bundlePaths);
+}
+
+void LibrarySearchIndex::remove(const QString& bundlePath)
+{
+    QMutexLocker lock(&m_queueMutex);
+    m_queue.removeAll(bundlePath);
+    m_removals.insert(bundlePath);
+    enqueueLocked({});
+}
+
+void LibrarySearchIndex::waitForIndexing()
+{
+    m_indexPool.waitForDone();
+}
+
+void LibrarySearchIndex::enqueue(const QStringList& bundlePaths)
+{
+    QMutexLocker lock(&m_queueMutex);
+    enqueueLocked(bundlePaths);
+}
+
+void LibrarySearchIndex::enqueueLocked(const QStringList& bundlePaths)
+{
+    for (const QString& path : bundlePaths) {
+        m_removals.remove(path);
+        if (!m_queue.contains(path)) {
+            m_queue.append(path);
+        }
+    }
+    if (m_indexing || m_cancelled.load()) {
+        return;
+    }
+    m_indexing = true;
+    m_indexFuture = QtConcurrent::run(&m_indexPool, [this]() {
+        drainQueue();
+    });
+}
+
+void LibrarySearchIndex::drainQueue()
+{
+    // Indexing loads whole notebooks; stay out of the way of the UI.
+    QThread::currentThread()->setPriority(QThread::LowPriority);
+    ensureLoaded();
+
+    bool changed = false;
+    for (;;) {
+        QString path;
+        QSet<QString> removals;
+        QSet<QString> keepOnly;
+        bool prune = false;
+        {
+            QMutexLocker lock(&m_queueMutex);
+            removals.swap(m_removals);
+            if (m_pruneQueued) {
+                keepOnly.swap(m_keepOnly);
+                prune = true;
+                m_pruneQueued = false;
+            }
+            if (removals.isEmpty() && !prune && (m_queue.isEmpty() || m_cancelled.load())) {
+                m_indexing = false;
+                break;
+            }
+            if (!m_queue.isEmpty()) {
+                path = m_queue.takeFirst();
+            }
+        }
+
+        if (!removals.isEmpty() || prune) {
+            QWriteLocker lock(&m_lock);
+            QStringList dropped;
+            for (const QString& bundlePath : std::as_const(removals)) {
+                dropped.append(bundlePath);
+            }
+            if (prune) {
+                for (auto it = m_idByPath.cbegin(); it != m_idByPath.cend(); ++it) {
+                    if (!keepOnly.contains(it.key())) {
+                        dropped.append(it.key());
+                    }
+                }
+            }
+            for (const QString& bundlePath : std::as_const(dropped)) {
+                changed |= removeLocked(bundlePath);
+            }
+        }
+        if (!path.isEmpty() && !m_cancelled.load()) {
+            changed |= indexNotebook(path);
+        }
+    }
+
+    flush();
+    if (changed && !m_cancelled.load()) {
+        emit indexUpdated();
+    }
+}
+
+bool LibrarySearchIndex::indexNotebook(const QString& bundlePath)
+{
+    if (!QFileInfo::exists(bundlePath + "/document.json")) {
+        QWriteLocker lock(&m_lock);
+        return removeLocked(bundlePath);
+    }
+
+    const quint64 stamp = notebookStamp(bundlePath);
+    {
+        QReadLocker lock(&m_lock);
+        const int id = m_idByPath.value(bundlePath, -1);
+        if (id >= 0 && m_entries[id].stamp == stamp) {
+            return false;
+        }
+    }
+
+    // On failure the previous text (if any) stays searchable; the stamp
+    // still differs, so the next refresh tries again.
+    QString text;
+    if (!collectNotebookText(bundlePath, text, m_cancelled)) {
+        return false;
+    }
+    insert(bundlePath, stamp, text);
+    flush();
+    return true;
+}
+
+void LibrarySearchIndex::insert(const QString& bundlePath, quint64 stamp, const QString& text)
+{
+    QVector<quint64> bloom = buildBloom(PdfSearchIndex::trigrams(text));
+    ensureLoaded();
+
+    QWriteLocker lock(&m_lock);
+    int id = m_idByPath.value(bundlePath, -1);
+    if (id < 0) {
+        id = m_entries.size();
+        m_entries.append(Entry());
+        m_idByPath.insert(bundlePath, id);
+    } else if (m_entries[id].payloadOffset >= 0) {
+        m_liveBytes -= kRecordHeaderSize + m_entries[id].payloadSize;
+    }
+
+    Entry& entry = m_entries[id];
+    entry.bundlePath = bundlePath;
+    entry.stamp = stamp;
+    entry.bloom = std::move(bloom);
+    entry.text = text;
+    entry.payloadOffset = -1;
+    entry.payloadSize = 0;
+    entry.live = true;
+}
+
+bool LibrarySearchIndex::removeLocked(const QString& bundlePath)
+{
+    const int id = m_idByPath.value(bundlePath, -1);
+    if (id < 0) {
+        return false;
+    }
+    Entry& entry = m_entries[id];
+    if (entry.payloadOffset >= 0) {
+        m_liveBytes -= kRecordHeaderSize + entry.payloadSize;
+        m_removedOnDisk.append(bundlePath);
+    }
+    entry.live = false;
+    entry.bloom.clear();
+    entry.text.clear();
+    m_idByPath.remove(bundlePath);
+    return true;
+}
+
+quint64 LibrarySearchIndex::notebookStamp(const QString& bundlePath)
+{
+    // document.json is rewritten by every save; page and tile files (and
+    // their OCR sidecars) are replaced, which touches their directory; notes
+    // are written in place.
+    quint64 h = 0xcbf29ce484222325ULL;
+    auto mix = [&h](quint64 v) {
+        h ^= v;
+        h *= 0x100000001b3ULL;
+    };
+    auto addFile = [&mix](const QFileInfo& info) {
+        if (!info.exists()) {
+            mix(~quint64(0));
+            return;
+        }
+        mix(quint64(info.size()));
+        mix(quint64(info.lastModified().toMSecsSinceEpoch()));
+    };
+
+    mix(kTextVersion);
+    addFile(QFileInfo(bundlePath + "/document.json"));
+    addFile(QFileInfo(bundlePath + "/pages"));
+    addFile(QFileInfo(bundlePath + "/tiles"));
+    const QDir notes(bundlePath + "/assets/notes");
+    const QFileInfoList noteFiles =
+        notes.entryInfoList({QStringLiteral("*.md")}, QDir::Files, QDir::Name);
+    for (const QFileInfo& info : noteFiles) {
+        mix(qHash(info.fileName()));
+        addFile(info);
+    }
+    return h;
+}
+
+bool LibrarySearchIndex::collectNotebookText(const QString& bundlePath, QString& text,
+                                             const std::atomic<bool>& cancelled)
+{
+    QFile docFile(bundlePath + "/document.json");
+    if (!docFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonObject manifest = QJsonDocument::fromJson(docFile.readAll()).object();
+    docFile.close();
+    const bool edgeless = manifest.value(QStringLiteral("mode")).toString() == QLatin1String("edgeless");
+
+    QStringList parts;
+    if (!edgeless) {
+        // The bundle's own search index has the PDF text, OCR blocks and text
+        // boxes, and is shared with in-notebook search.
+        std::unique_ptr<Document> doc = Document::loadBundle(bundlePath);
+        if (!doc || !PdfSearchEngine::indexDocument(doc.get(), &cancelled)) {
+            return false;
+        }
+        doc.reset();
+        PdfSearchIndex::readTexts(bundlePath + "/" + PdfSearchIndex::fileName(), parts);
+    } else {
+        // Edgeless tiles have no bundle index; their OCR sidecars are read
+        // without loading the tiles.
+        const QDir tiles(bundlePath + "/tiles");
+        const QFileInfoList sidecars =
+            tiles.entryInfoList({QStringLiteral("*.ocr.json")}, QDir::Files, QDir::Name);
+        for (const QFileInfo& info : sidecars) {
+            if (cancelled.load()) {
+                return false;
+            }
+            for (const OcrTextBlock& block : Document::loadOcrBlocksFromFile(info.filePath())) {
+                if (!block.text.isEmpty()) {
+                    parts.append(block.text);
+                }
+            }
+        }
+    }
+
+    const QDir notes(bundlePath + "/assets/notes");
+    const QFileInfoList noteFiles =
+        notes.entryInfoList({QStringLiteral("*.md")}, QDir::Files, QDir::Name);
+    for (const QFileInfo& info : noteFiles) {
+        QFile note(info.filePath());
+        if (note.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            parts.append(QString::fromUtf8(note.readAll()));
+        }
+    }
+
+    text = parts.join('\n');
+    return !cancelled.load();
+}
+
+// ----------------------------------------------------------------------------
+// Queries
+// ----------------------------------------------------------------------------
+
+void LibrarySearchIndex::search(const QString& text,
+                                const std::function<void(const QStringList&)>& onBatch,
+                                const std::atomic<bool>& cancelled)
+{
+    const QString needle = text.trimmed();
+    if (needle.size() < MIN_QUERY_LENGTH) {
+        return;
+    }
+    QVector<quint64> hashes;
+    for (quint64 trigram : PdfSearchIndex::trigrams(needle)) {
+        hashes.append(mix64(trigram));
+    }
+    ensureLoaded();
+
+    // Held until the last batch: the verifying tasks below read m_entries
+    // under this thread's lock.
+    QReadLocker lock(&m_lock);
+    QVector<int> candidates;
+    for (int id = 0; id < m_entries.size(); ++id) {
+        const Entry& entry = m_entries[id];
+        if (entry.live && (hashes.isEmpty() || bloomMayContain(entry.bloom, hashes))) {
+            candidates.append(id);
+        }
+    }
+
+    const QVector<Entry>& entries = m_entries;
+    const int tasks = qMax(1, QThread::idealThreadCount());
+    for (int start = 0; start < candidates.size(); start += kVerifyWindow) {
+        if (cancelled.load()) {
+            return;
+        }
+        const int end = qMin(start + kVerifyWindow, int(candidates.size()));
+        std::vector<char> hit(size_t(end - start), 0);
+
+        QVector<QFuture<void>> futures;
+        for (int t = 0; t < tasks && start + t < end; ++t) {
+            futures.append(QtConcurrent::run([&, t]() {
+                QFile file(m_path);
+                for (int i = start + t; i < end; i += tasks) {
+                    if (cancelled.load()) {
+                        return;
+                    }
+                    hit[size_t(i - start)] =
+                        entryContainsLocked(entries.at(candidates.at(i)), needle, file);
+                }
+            }));
+        }
+        for (QFuture<void>& future : futures) {
+            future.waitForFinished();
+        }
+
+        QStringList batch;
+        for (int i = start; i < end; ++i) {
+            if (hit[size_t(i - start)]) {
+                batch.append(entries.at(candidates.at(i)).bundlePath);
+            }
+        }
+        if (!batch.isEmpty() && !cancelled.load()) {
+            onBatch(batch);
+        }
+    }
+}
+
+QStringList LibrarySearchIndex::search(const QString& text)
+{
+    QStringList matches;
+    const std::atomic<bool> notCancelled{false};
+    search(text, [&matches](const QStringList& batch) { matches += batch; }, notCancelled);
+    return matches;
+}
+
+bool LibrarySearchIndex::entryContainsLocked(const Entry& entry, const QString& needle,
+                                             QFile& file) const
+{
+    if (entry.payloadOffset < 0) {
+        return entry.text.contains(needle, Qt::CaseInsensitive);
+    }
+    if (!file.isOpen() && !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray payload;
+    if (!readRecord(file, entry.payloadOffset - kRecordHeaderSize, payload)) {
+        return false;
+    }
+
+    quint8 kind = 0;
+    QString bundlePath;
+    quint64 stamp = 0;
+    QByteArray bloom;
+    QByteArray blob;
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_5_12);
+    in >> kind >> bundlePath >> stamp >> bloom >> blob;
+
+    // The file may have been replaced by another instance since we read it.
+    QString text;
+    return in.status() == QDataStream::Ok && bundlePath == entry.bundlePath
+        && uncompressText(blob, text) && text.contains(needle, Qt::CaseInsensitive);
+}
+
+quint64 LibrarySearchIndex::startQuery(const QString& text)
+{
+    cancelQuery();
+    const quint64 queryId = ++m_lastQueryId;
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_queryCancelled = cancelled;
+
+    m_queryFuture = QtConcurrent::run(&m_queryPool, [this, queryId, text, cancelled]() {
+        search(text, [this, queryId](const QStringList& batch) {
+            emit contentMatches(queryId, batch);
+        }, *cancelled);
+        if (!cancelled->load()) {
+            emit queryFinished(queryId);
+        }
+    });
+    return queryId;
+}
+
+void LibrarySearchIndex::cancelQuery()
+{
+    if (m_queryCancelled) {
+        m_queryCancelled->store(true);
+        m_queryCancelled.reset();
+    }
+}
+
+int LibrarySearchIndex::notebookCount()
+{
+    ensureLoaded();
+    QReadLocker lock(&m_lock);
+    return m_idByPath.size();
+}
+
+// ----------------------------------------------------------------------------
+// Reading
+// ----------------------------------------------------------------------------
+
+void LibrarySearchIndex::ensureLoaded()
+{
+    if (m_loaded.load()) {
+        return;
+    }
+    QMutexLocker loadLock(&m_loadMutex);
+    if (m_loaded.load()) {
+        return;
+    }
+    {
+        QWriteLocker lock(&m_lock);
+        if (!m_path.isEmpty()) {
+            loadLocked();
+        }
+    }
+    m_loaded.store(true);
+}
+
+bool LibrarySearchIndex::loadLocked()
+{
+    QFile file(m_path);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray header = file.read(kHeaderSize);
+    if (header.size() != kHeaderSize || std::memcmp(header.constData(), kMagic, 4) != 0
+        || qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(header.constData()) + 4)
+               != FORMAT_VERSION) {
+        return false; // foreign or older file; rewritten by the next flush()
+    }
+    m_fileSize = file.size();
+
+    qint64 offset = kHeaderSize;
+    QByteArray payload;
+    while (readRecord(file, offset, payload)) {
+        const qint64 payloadOffset = offset + kRecordHeaderSize;
+        offset = payloadOffset + payload.size();
+
+        // The text stays on disk; only the filter is kept.
+        quint8 kind = 0;
+        QString bundlePath;
+        quint64 stamp = 0;
+        QByteArray bloom;
+        QDataStream in(payload);
+        in.setVersion(QDataStream::Qt_5_12);
+        in >> kind >> bundlePath >> stamp >> bloom;
+        if (in.status() != QDataStream::Ok || bundlePath.isEmpty()) {
+            continue;
+        }
+
+        removeLocked(bundlePath);
+        m_removedOnDisk.removeAll(bundlePath);
+        if (kind != quint8(Kind::Notebook)) {
+            continue;
+        }
+        const int id = m_entries.size();
+        Entry entry;
+        entry.bundlePath = bundlePath;
+        entry.stamp = stamp;
+        entry.bloom = bloomFromBytes(bloom);
+        entry.payloadOffset = payloadOffset;
+        entry.payloadSize = quint32(payload.size());
+        m_entries.append(std::move(entry));
+        m_idByPath.insert(bundlePath, id);
+        m_liveBytes += kRecordHeaderSize + payload.size();
+    }
+    m_intact = (offset == m_fileSize);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Writing
+// ----------------------------------------------------------------------------
+
+bool LibrarySearchIndex::flush()
+{
+    ensureLoaded();
+    QWriteLocker lock(&m_lock);
+    if (m_path.isEmpty()) {
+        m_removedOnDisk.clear();
+        return true;
+    }
+    if (m_writeFailed) {
+        return false;
+    }
+
+    QVector<int> pending;
+    for (int id = 0; id < m_entries.size(); ++id) {
+        if (m_entries[id].live && m_entries[id].payloadOffset < 0) {
+            pending.append(id);
+        }
+    }
+    if (pending.isEmpty() && m_removedOnDisk.isEmpty()) {
+        return true;
+    }
+
+    const qint64 garbage = m_fileSize - kHeaderSize - m_liveBytes;
+    const bool canAppend = m_intact
+                        && (garbage < kMinGarbageToRewrite || garbage <= m_liveBytes)
+                        && QFileInfo(m_path).size() == m_fileSize;
+    if (!canAppend) {
+        return rewriteLocked();
+    }
+
+    // Tombstones first: a path removed and indexed again ends up live.
+    QByteArray tail;
+    for (const QString& path : std::as_const(m_removedOnDisk)) {
+        appendRecord(tail, encodePayload(quint8(Kind::Removed), path, 0, {}, QString()));
+    }
+    struct Written {
+        int id;
+        qint64 payloadOffset;  ///< within the tail
+        quint32 payloadSize;
+    };
+    QVector<Written> written;
+    for (int id : std::as_const(pending)) {
+        const Entry& entry = m_entries[id];
+        const QByteArray payload = encodePayload(quint8(Kind::Notebook), entry.bundlePath,
+                                                 entry.stamp, entry.bloom, entry.text);
+        written.append({id, tail.size() + kRecordHeaderSize, quint32(payload.size())});
+        appendRecord(tail, payload);
+    }
+
+    QFile file(m_path);
+    const bool ok = file.open(QIODevice::ReadWrite) && file.seek(m_fileSize)
+                 && file.write(tail) == tail.size();
+    file.close();
+    if (!ok) {
+        // Entries stay searchable in memory; a torn tail is dropped on load.
+        m_intact = false;
+        m_writeFailed = true;
+        return false;
+    }
+
+    for (const Written& w : std::as_const(written)) {
+        Entry& entry = m_entries[w.id];
+        entry.payloadOffset = m_fileSize + w.payloadOffset;
+        entry.payloadSize = w.payloadSize;
+        entry.text.clear();
+        m_liveBytes += kRecordHeaderSize + entry.payloadSize;
+    }
+    m_fileSize += tail.size();
+    m_removedOnDisk.clear();
+    return true;
+}
+
+bool LibrarySearchIndex::rewriteLocked()
+{
+    // Entries already on disk are copied over record by record.
+    QFile old(m_path);
+    const bool haveOld = old.open(QIODevice::ReadOnly);
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_writeFailed = true;
+        return false;
+    }
+    const QByteArray header = makeHeader();
+    file.write(header);
+    qint64 offset = header.size();
+
+    // Copies, so a failed commit leaves the index as it was.
+    QVector<Entry> entries;
+    entries.reserve(m_idByPath.size());
+    for (Entry entry : std::as_const(m_entries)) {
+        if (!entry.live) {
+            continue;
+        }
+        QByteArray payload;
+        if (entry.payloadOffset < 0) {
+            payload = encodePayload(quint8(Kind::Notebook), entry.bundlePath, entry.stamp,
+                                    entry.bloom, entry.text);
+        } else if (!haveOld
+                   || !readRecord(old, entry.payloadOffset - kRecordHeaderSize, payload)) {
+            continue; // lost; re-read on the next refresh
+        }
+
+        QByteArray record;
+        appendRecord(record, payload);
+        file.write(record);
+        entry.payloadOffset = offset + kRecordHeaderSize;
+        entry.payloadSize = quint32(payload.size());
+        entry.text.clear();
+        offset += record.size();
+        entries.append(std::move(entry));
+    }
+
+    if (!file.commit()) {
+        m_writeFailed = true;
+        return false;
+    }
+
+    m_entries = std::move(entries);
+    m_idByPath.clear();
+    m_liveBytes = 0;
+    for (int id = 0; id < m_entries.size(); ++id) {
+        m_idByPath.insert(m_entries[id].bundlePath, id);
+        m_liveBytes += kRecordHeaderSize + m_entries[id].payloadSize;
+    }
+    m_removedOnDisk.clear();
+    m_fileSize = offset;
+    m_intact = true;
+    return true;
+}
@@ -0,0 +1,234 @@
+#ifndef LIBRARYSEARCHINDEX_H
+#define LIBRARYSEARCHINDEX_H
+
+// ============================================================================
+// LibrarySearchIndex - Full-text search across all notebooks of the library
+// ============================================================================
+// The Launcher search only matched notebook names and PDF file names. This
+// index answers "which notebook did I write X in" over the whole library.
+//
+// Each notebook contributes one text: the texts of its bundle's search index
+// (search.snsi: PDF text, OCR blocks, text boxes; refreshed here first, see
+// PdfSearchEngine::indexDocument()), or the OCR sidecars of its tiles for
+// edgeless notebooks, plus its markdown notes. A notebook is re-read only
+// when its stamp (document.json, page/tile directories, notes) changed, so
+// the refresh that follows every open and save (NotebookLibrary::
+// notebookUpdated()) is a handful of stat() calls for unchanged notebooks.
+//
+// In memory each notebook keeps a Bloom filter over the case-folded
+// trigrams of its text (a few bits per distinct trigram, the same trigrams
+// PdfSearchIndex posts). A query tests its trigrams against every filter,
+// which takes microseconds for thousands of notebooks, and only the
+// surviving candidates have their text read back and matched exactly.
+// Queries shorter than three characters have no trigrams and check every
+// notebook's text; single characters are not searched.
+//
+// library_search.snls in the app data directory is an append-only log of
+// checksummed records (filter + compressed text per notebook, tombstones for
+// removed notebooks), rewritten once stale records outweigh live ones. It is
+// a cache: an unreadable file is treated as empty and rebuilt.
+//
+// Indexing runs on one background thread, queries on another; results are
+// reported through queued signals. Thread-safe.
+// ============================================================================
+
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class QFile;
+
+class LibrarySearchIndex : public QObject {
+    Q_OBJECT
+
+public:
+    /// File format version stored in the header.
+    static constexpr quint16 FORMAT_VERSION = 1;
+    /// Queries shorter than this (after trimming) are not searched.
+    static constexpr int MIN_QUERY_LENGTH = 2;
+
+    /// File name inside the app data directory.
+    static QString fileName() { return QStringLiteral("library_search.snls"); }
+
+    /**
+     * @brief The application's index, kept up to date with NotebookLibrary.
+     *
+     * Created on first use; queues a refresh of every library notebook.
+     */
+    static LibrarySearchIndex* instance();
+
+    /**
+     * @param path Index file; empty keeps the index in memory only.
+     */
+    explicit LibrarySearchIndex(const QString& path, QObject* parent = nullptr);
+    ~LibrarySearchIndex() override;
+
+    // ===== Indexing =====
+
+    /**
+     * @brief Re-index a notebook in the background if its content changed.
+     */
+    void refresh(const QString& bundlePath);
+
+    /**
+     * @brief Refresh every notebook in @p bundlePaths and drop all others.
+     */
+    void refreshAll(const QStringList& bundlePaths);
+
+    /**
+     * @brief Drop a notebook from the index.
+     */
+    void remove(const QString& bundlePath);
+
+    /**
+     * @brief Block until queued refreshes and removals are done.
+     */
+    void waitForIndexing();
+
+    /**
+     * @brief Store @p text as the content of @p bundlePath.
+     * @param stamp notebookStamp() the text was read at.
+     *
+     * The indexer's last step; the text is written by the next flush().
+     */
+    void insert(const QString& bundlePath, quint64 stamp, const QString& text);
+
+    /**
+     * @brief Stamp of the parts of a bundle that carry searchable text.
+     */
+    static quint64 notebookStamp(const QString& bundlePath);
+
+    /**
+     * @brief Gather the searchable text of a notebook (see the file comment).
+     * @return false if the bundle could not be read or @p cancelled was set.
+     */
+    static bool collectNotebookText(const QString& bundlePath, QString& text,
+                                    const std::atomic<bool>& cancelled);
+
+    // ===== Queries =====
+
+    /**
+     * @brief Notebooks whose text contains @p text (case-insensitive).
+     * @param onBatch Called with each batch of confirmed matches, in index order.
+     *
+     * Blocks; candidates are verified in parallel.
+     */
+    void search(const QString& text, const std::function<void(const QStringList&)>& onBatch,
+                const std::atomic<bool>& cancelled);
+
+    /// Blocking search returning all matches.
+    QStringList search(const QString& text);
+
+    /**
+     * @brief Start an asynchronous query, cancelling the previous one.
+     * @return Query id carried by contentMatches() and queryFinished().
+     */
+    quint64 startQuery(const QString& text);
+
+    /**
+     * @brief Cancel the running query; no further signals are emitted for it.
+     */
+    void cancelQuery();
+
+    // ===== Persistence =====
+
+    /// Write changes since the last flush. Returns false on an I/O error.
+    bool flush();
+
+    QString path() const { return m_path; }
+    int notebookCount();
+
+signals:
+    /**
+     * @brief A batch of notebooks matching query @p queryId (queued).
+     */
+    void contentMatches(quint64 queryId, const QStringList& bundlePaths);
+
+    /**
+     * @brief Query @p queryId has reported all its matches (queued).
+     */
+    void queryFinished(quint64 queryId);
+
+    /**
+     * @brief Emitted after notebooks were re-indexed or dropped (queued).
+     */
+    void indexUpdated();
+
+private:
+    enum class Kind : quint8 { Notebook = 1, Removed = 2 };
+
+    struct Entry {
+        QString bundlePath;
+        quint64 stamp = 0;
+        QVector<quint64> bloom;       ///< Bloom filter over the text's trigrams
+        QString text;                 ///< Until written (always, in memory-only mode)
+        qint64 payloadOffset = -1;    ///< Record payload in the file, -1 while pending
+        quint32 payloadSize = 0;
+        bool live = true;
+    };
+
+    /// Load the file on first use (from whichever thread gets there first).
+    void ensureLoaded();
+    bool loadLocked();
+
+    /// Returns false if @p bundlePath is not indexed.
+    bool removeLocked(const QString& bundlePath);
+    bool rewriteLocked();
+
+    /// Whether @p entry's text contains @p needle. Caller holds a lock;
+    /// @p file is opened on demand and reused across calls.
+    bool entryContainsLocked(const Entry& entry, const QString& needle, QFile& file) const;
+
+    /// Queue @p bundlePaths and start the indexing thread if it is idle.
+    void enqueue(const QStringList& bundlePaths);
+    void enqueueLocked(const QStringList& bundlePaths);
+    /// Index queued notebooks until the queue is empty (indexing thread).
+    void drainQueue();
+    /// Returns true if the notebook's entry changed.
+    bool indexNotebook(const QString& bundlePath);
+
+    const QString m_path;
+
+    mutable QReadWriteLock m_lock;
+    QMutex m_loadMutex;
+    std::atomic<bool> m_loaded{false};
+    QVector<Entry> m_entries;                 ///< Removed ones stay until the next rewrite
+    QHash<QString, int> m_idByPath;           ///< Live entries
+    QStringList m_removedOnDisk;              ///< Tombstones to write
+    qint64 m_fileSize = 0;
+    qint64 m_liveBytes = 0;                   ///< Record bytes of live entries on disk
+    bool m_intact = false;                    ///< Header valid, no torn tail
+    bool m_writeFailed = false;
+
+    // Indexing thread
+    QThreadPool m_indexPool;
+    QMutex m_queueMutex;
+    QStringList m_queue;
+    QSet<QString> m_removals;                 ///< Notebooks to drop
+    QSet<QString> m_keepOnly;                 ///< refreshAll(): drop everything else
+    bool m_pruneQueued = false;
+    bool m_indexing = false;
+    QFuture<void> m_indexFuture;
+    std::atomic<bool> m_cancelled{false};
+
+    // Query thread
+    QThreadPool m_queryPool;
+    quint64 m_lastQueryId = 0;
+    std::shared_ptr<std::atomic<bool>> m_queryCancelled;
+    QFuture<void> m_queryFuture;
+
+    static LibrarySearchIndex* s_instance;
+};
+
+#endif // LIBRARYSEARCHINDEX_H
@@ -0,0 +1,283 @@
+#pragma once
+
+// ============================================================================
+// LibrarySearchIndexTests - Tests for the library-wide full-text search
+// ============================================================================
+// Checks that queries find exactly the notebooks containing them (case-
+// insensitive, across line breaks, CJK, no trigrams for two characters),
+// that library_search.snls survives a reopen with replaced and removed
+// notebooks, and reports query times over a synthetic 1,000-notebook library
+// (design target: under 100 ms).
+//
+// Run with: speedynote --test-library-search
+// ============================================================================
+
+#include "LibrarySearchIndex.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+namespace LibrarySearchIndexTests {
+
+/// Sorted copy, for order-independent comparison.
+inline QStringList sorted(QStringList list)
+{
+    std::sort(list.begin(), list.end());
+    return list;
+}
+
+/**
+ * @brief Queries match exactly the notebooks that contain them.
+ */
+inline bool testQueries()
+{
+    qDebug() << "=== Test: library queries ===";
+
+    LibrarySearchIndex index(QString());
+    index.insert(QStringLiteral("/lib/physics.snb"), 1,
+                 QStringLiteral("Lecture 3: Maxwell equations\nDisplacement current"));
+    index.insert(QStringLiteral("/lib/recipes.snb"), 2,
+                 QStringLiteral("Pancakes: flour, milk, eggs.\nCurrent favourite!"));
+    index.insert(QStringLiteral("/lib/chinese.snb"), 3,
+                 QStringLiteral("Vocabulary ") + QChar(0x4E2D) + QChar(0x6587) + QStringLiteral(" lesson"));
+
+    struct Case {
+        QString query;
+        QStringList expected;
+    };
+    const QVector<Case> cases = {
+        {QStringLiteral("maxwell"), {QStringLiteral("/lib/physics.snb")}},
+        {QStringLiteral("CURRENT"), {QStringLiteral("/lib/physics.snb"), QStringLiteral("/lib/recipes.snb")}},
+        {QStringLiteral("equations\ndisplacement"), {QStringLiteral("/lib/physics.snb")}},
+        {QString(QChar(0x4E2D)) + QChar(0x6587), {QStringLiteral("/lib/chinese.snb")}},
+        {QStringLiteral("  eggs  "), {QStringLiteral("/lib/recipes.snb")}},
+        {QStringLiteral("maxwell current"), {}},
+        {QStringLiteral("e"), {}},
+    };
+
+    bool success = true;
+    for (const Case& c : cases) {
+        const QStringList found = sorted(index.search(c.query));
+        if (found != sorted(c.expected)) {
+            qDebug() << "FAIL:" << c.query << "found" << found << "expected" << c.expected;
+            success = false;
+        }
+    }
+
+    // A replaced text no longer matches its old content.
+    index.insert(QStringLiteral("/lib/recipes.snb"), 4, QStringLiteral("Waffles"));
+    if (!index.search(QStringLiteral("pancakes")).isEmpty()
+        || index.search(QStringLiteral("waffles")).size() != 1) {
+        qDebug() << "FAIL: replaced notebook text";
+        success = false;
+    }
+
+    if (success) {
+        qDebug() << "PASS: library queries";
+    }
+    return success;
+}
+
+/**
+ * @brief Notebooks survive a reopen; replaced texts and removed notebooks do not.
+ */
+inline bool testPersistence()
+{
+    qDebug() << "=== Test: library_search.snls persistence ===";
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: no temporary directory";
+        return false;
+    }
+    const QString path = dir.filePath(LibrarySearchIndex::fileName());
+    const QString a = QStringLiteral("/missing/a.snb");
+    const QString b = QStringLiteral("/missing/b.snb");
+    const QString c = QStringLiteral("/missing/c.snb");
+
+    {
+        LibrarySearchIndex index(path);
+        index.insert(a, 1, QStringLiteral("alpha first draft"));
+        index.insert(b, 2, QStringLiteral("bravo"));
+        index.insert(c, 3, QStringLiteral("charlie"));
+        if (!index.flush()) {
+            qDebug() << "FAIL: first flush";
+            return false;
+        }
+        // Appended behind the first records; the last one wins.
+        index.insert(a, 4, QStringLiteral("alpha final"));
+        index.flush();
+        index.remove(b);
+        index.waitForIndexing();
+    }
+
+    bool success = true;
+    {
+        LibrarySearchIndex index(path);
+        if (index.notebookCount() != 2) {
+            qDebug() << "FAIL: reopen count" << index.notebookCount();
+            return false;
+        }
+        if (index.search(QStringLiteral("alpha final")) != QStringList{a}
+            || !index.search(QStringLiteral("first draft")).isEmpty()) {
+            qDebug() << "FAIL: replaced notebook";
+            success = false;
+        }
+        if (!index.search(QStringLiteral("bravo")).isEmpty()
+            || index.search(QStringLiteral("charlie")) != QStringList{c}) {
+            qDebug() << "FAIL: removed notebook came back";
+            success = false;
+        }
+
+        // Notebooks the library no longer lists are dropped.
+        index.refreshAll({a});
+        index.waitForIndexing();
+    }
+    {
+        LibrarySearchIndex index(path);
+        if (index.notebookCount() != 0) {
+            // a's bundle does not exist either, so it goes too.
+            qDebug() << "FAIL: refreshAll left" << index.notebookCount() << "notebooks";
+            success = false;
+        }
+    }
+
+    if (success) {
+        qDebug() << "PASS: library_search.snls persistence";
+    }
+    return success;
+}
+
+/**
+ * @brief Query times over a synthetic library of @p notebooks notebooks.
+ *
+ * Each notebook gets ~@p wordsPerNotebook words from a shared vocabulary; a
+ * rare phrase is planted in a few of them. Fails only on wrong results; the
+ * times are reported against the 100 ms design target.
+ */
+inline bool benchmarkLibrarySearch(int notebooks = 1000, int wordsPerNotebook = 2000)
+{
+    qDebug() << "=== Benchmark: library search ===";
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: no temporary directory";
+        return false;
+    }
+    const QString path = dir.filePath(LibrarySearchIndex::fileName());
+
+    QRandomGenerator rng(1234);
+    QStringList vocabulary;
+    for (int i = 0; i < 5000; ++i) {
+        QString word;
+        const int length = 3 + int(rng.bounded(6));
+        for (int j = 0; j < length; ++j) {
+            word += QChar('a' + int(rng.bounded(26)));
+        }
+        vocabulary.append(word);
+    }
+
+    const QString phrase = QStringLiteral("Quarterly Zephyr Review");
+    QStringList planted;
+    QElapsedTimer timer;
+    timer.start();
+    {
+        LibrarySearchIndex index(path);
+        for (int n = 0; n < notebooks; ++n) {
+            QStringList words;
+            for (int w = 0; w < wordsPerNotebook; ++w) {
+                words.append(vocabulary[rng.bounded(int(vocabulary.size()))]);
+            }
+            const QString bundlePath = QStringLiteral("/library/notebook_%1.snb").arg(n);
+            if (n % 200 == 7) {
+                words.insert(words.size() / 2, phrase);
+                planted.append(bundlePath);
+            }
+            index.insert(bundlePath, quint64(n), words.join(' '));
+        }
+        index.flush();
+    }
+    const qint64 buildMs = timer.elapsed();
+
+    LibrarySearchIndex index(path);
+    timer.restart();
+    const int count = index.notebookCount();
+    const qint64 loadMs = timer.elapsed();
+
+    bool success = (count == notebooks);
+    if (!success) {
+        qDebug() << "FAIL: loaded" << count << "of" << notebooks << "notebooks";
+    }
+
+    struct Query {
+        QString text;
+        int expected;  ///< -1: not checked
+    };
+    const QVector<Query> queries = {
+        {QStringLiteral("zephyr review"), int(planted.size())},
+        {QStringLiteral("no such words here"), 0},
+        {vocabulary[0] + ' ' + vocabulary[1], -1},
+        {vocabulary[2], -1},
+    };
+
+    qDebug() << "Library:" << notebooks << "notebooks," << wordsPerNotebook << "words each;"
+             << "index built in" << buildMs << "ms, loaded in" << loadMs << "ms,"
+             << QFileInfo(path).size() / 1024 << "KiB";
+    for (const Query& q : queries) {
+        timer.restart();
+        const QStringList found = index.search(q.text);
+        const qint64 ms = timer.elapsed();
+        qDebug().noquote() << QString("  \"%1\": %2 notebooks in %3 ms%4")
+                                  .arg(q.text).arg(found.size()).arg(ms)
+                                  .arg(ms > 100 ? QStringLiteral(" (over the 100 ms target)") : QString());
+        if (q.expected >= 0 && found.size() != q.expected) {
+            qDebug() << "FAIL: expected" << q.expected << "matches";
+            success = false;
+        }
+        if (q.expected > 0 && sorted(found) != sorted(planted)) {
+            qDebug() << "FAIL: wrong notebooks" << found;
+            success = false;
+        }
+    }
+
+    if (success) {
+        qDebug() << "PASS: library search benchmark";
+    }
+    return success;
+}
+
+/**
+ * @brief Run all LibrarySearchIndex tests.
+ * @return true if all tests pass, false otherwise.
+ */
+inline bool runAllTests()
+{
+    qDebug() << "";
+    qDebug() << "========================================";
+    qDebug() << "   LibrarySearchIndex Tests";
+    qDebug() << "========================================";
+
+    bool allPassed = true;
+
+    allPassed &= testQueries();
+    allPassed &= testPersistence();
+    allPassed &= benchmarkLibrarySearch();
+
+    qDebug() << "";
+    if (allPassed) {
+        qDebug() << "✅ All LibrarySearchIndex tests passed!";
+    } else {
+        qDebug() << "❌ Some LibrarySearchIndex tests failed!";
+    }
+    qDebug() << "========================================";
+    qDebug() << "";
+
+    return allPassed;
+}
+
+} // namespace LibrarySearchIndexTests
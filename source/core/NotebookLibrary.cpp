@@ -68,6 +68,7 @@ void NotebookLibrary::addToRecent(const QString& bundlePath)
         existing->lastModified = docJsonInfo.lastModified();
         
         markDirty();
+        emit notebookUpdated(bundlePath);
         return;
     }
     
@@ -119,6 +120,7 @@ void NotebookLibrary::addToRecent(const QString& bundlePath)
     // Add to list
     m_notebooks.append(nb);
     markDirty();
+    emit notebookUpdated(bundlePath);
 }
 
 void NotebookLibrary::removeFromRecent(const QString& bundlePath)
@@ -127,6 +129,7 @@ void NotebookLibrary::removeFromRecent(const QString& bundlePath)
         if (m_notebooks[i].bundlePath == bundlePath) {
             m_notebooks.removeAt(i);
             markDirty();
+            emit notebookRemoved(bundlePath);
             return;
         }
     }
@@ -759,6 +762,12 @@ void NotebookLibrary::markDirty()
     scheduleSave();
 }
 
+NotebookInfo NotebookLibrary::notebookInfo(const QString& bundlePath) const
+{
+    const NotebookInfo* nb = findNotebook(bundlePath);
+    return nb ? *nb : NotebookInfo();
+}
+
 // === Private Helpers ===
 
 NotebookInfo* NotebookLibrary::findNotebook(const QString& bundlePath)
@@ -222,6 +222,12 @@ public:
     
     // === Search ===
     
+    /**
+     * @brief Look up a notebook by path.
+     * @return The notebook's info, or an invalid NotebookInfo if it is not in the library.
+     */
+    NotebookInfo notebookInfo(const QString& bundlePath) const;
+    
     /**
      * @brief Search notebooks by name and PDF filename.
      * @param query Search query string.
@@ -283,6 +289,18 @@ signals:
      * @param bundlePath The notebook whose thumbnail changed.
      */
     void thumbnailUpdated(const QString& bundlePath);
+    
+    /**
+     * @brief Emitted when a notebook is added, opened or saved (addToRecent()).
+     * @param bundlePath The notebook whose contents may have changed.
+     */
+    void notebookUpdated(const QString& bundlePath);
+    
+    /**
+     * @brief Emitted when a notebook is removed from the library.
+     * @param bundlePath The removed notebook.
+     */
+    void notebookRemoved(const QString& bundlePath);
 
 private:
     /**
@@ -9,6 +9,7 @@
 #include <QUuid>       // Phase C.0.1: UUID generation for LinkObject position links
 #include <algorithm>
 #include <climits>  // For INT_MIN (Phase O3.5.5: affinity filtering)
+#include <utility>  // For std::as_const
 
 // ===== Constructors =====
 
@@ -269,7 +270,7 @@ int Page::duplicateLayer(int index)
     // Deep copy strokes with new UUIDs
     for (const VectorStroke& stroke : source->strokes()) {
         VectorStroke copy = stroke;  // Copy all properties
-        copy.id = QUuid::createUuid().toString(QUuid::WithoutBraces);  // New UUID
+        copy.id = Id128::create();  // New UUID
         newLayer->addStroke(std::move(copy));
     }
     
@@ -699,7 +700,7 @@ void Page::renderObjectsWithAffinity(QPainter& painter, qreal zoom, int affinity
 
 // ===== Serialization =====
 
-QJsonObject Page::toJson() const
+QJsonObject Page::toJson(bool includeStrokes) const
 {
     QJsonObject obj;
     
@@ -734,7 +735,7 @@ QJsonObject Page::toJson() const
     // Layers
     QJsonArray layersArray;
     for (const auto& layer : vectorLayers) {
-        layersArray.append(layer->toJson());
+        layersArray.append(layer->toJson(includeStrokes));
     }
     obj["layers"] = layersArray;
     
@@ -822,6 +823,36 @@ std::unique_ptr<Page> Page::fromJson(const QJsonObject& obj)
     return page;
 }
 
+std::unique_ptr<Page> Page::fromContainer(PageCodec::Container&& container)
+{
+    auto page = fromJson(container.meta);
+    if (!page || !container.binary) {
+        return page;  // Legacy JSON: strokes were parsed inline
+    }
+    
+    // fromJson() creates one layer per meta["layers"] entry (or a single
+    // default layer when the array is empty); the binary layer table must
+    // describe exactly those layers.
+    const int declaredLayers = static_cast<int>(container.meta["layers"].toArray().size());
+    if (container.layerStrokes.size() != declaredLayers) {
+        return nullptr;
+    }
+    for (int i = 0; i < declaredLayers; ++i) {
+        page->vectorLayers[i]->setStrokes(std::move(container.layerStrokes[i]));
+    }
+    return page;
+}
+
+QVector<const QVector<VectorStroke>*> Page::layerStrokeLists() const
+{
+    QVector<const QVector<VectorStroke>*> lists;
+    lists.reserve(static_cast<int>(vectorLayers.size()));
+    for (const auto& layer : vectorLayers) {
+        lists.append(&std::as_const(*layer).strokes());
+    }
+    return lists;
+}
+
 int Page::loadImages(const QString& basePath)
 {
     if (basePath.isEmpty()) {
@@ -977,3 +1008,19 @@ QRectF Page::contentBoundingRect() const
     
     return bounds;
 }
+
+qint64 Page::memoryBytes() const
+{
+    qint64 bytes = sizeof(Page);
+    for (const auto& layer : vectorLayers) {
+        bytes += layer->memoryBytes();
+    }
+    for (const auto& obj : objects) {
+        bytes += 256;  // Object, properties, affinity entry
+        if (auto* img = dynamic_cast<const ImageObject*>(obj.get())) {
+            const QPixmap& pixmap = img->pixmap();
+            bytes += qint64(pixmap.width()) * pixmap.height() * 4;
+        }
+    }
+    return bytes;
+}
@@ -18,6 +18,7 @@
 #include "../objects/InsertedObject.h"
 #include "../objects/ImageObject.h"
 #include "../ocr/OcrTextBlock.h"
+#include "PageCodec.h"
 
 #include <QSizeF>
 #include <QColor>
@@ -431,9 +432,11 @@ public:
     
     /**
      * @brief Serialize page to JSON.
+     * @param includeStrokes If false, layers are written without their
+     *        "strokes" arrays (header of the binary page container).
      * @return JSON object containing all page data.
      */
-    QJsonObject toJson() const;
+    QJsonObject toJson(bool includeStrokes = true) const;
     
     /**
      * @brief Deserialize page from JSON.
@@ -444,6 +447,21 @@ public:
      */
     static std::unique_ptr<Page> fromJson(const QJsonObject& obj);
     
+    /**
+     * @brief Deserialize a page from a decoded page container.
+     * @param container Binary container (strokes in packed columns) or
+     *        legacy JSON document (strokes inline).
+     * @return Page with data loaded, or nullptr if the layer table of a
+     *         binary container does not match its JSON header.
+     */
+    static std::unique_ptr<Page> fromContainer(PageCodec::Container&& container);
+    
+    /**
+     * @brief Collect per-layer stroke lists for PageCodec::encode().
+     * @return One pointer per layer, in the same order as toJson(false)["layers"].
+     */
+    QVector<const QVector<VectorStroke>*> layerStrokeLists() const;
+    
     /**
      * @brief Load all images in objects from disk.
      * @param basePath Bundle path (e.g., "/path/to/notebook.snb").
@@ -490,4 +508,13 @@ public:
      * Useful for edgeless canvas mode.
      */
     QRectF contentBoundingRect() const;
+    
+    /**
+     * @brief Approximate memory held by this page in bytes.
+     * 
+     * Counts stroke points, the layers' render caches and decoded images -
+     * what stays resident while the page is loaded. Used to hold loaded
+     * edgeless tiles to a memory budget.
+     */
+    qint64 memoryBytes() const;
 };
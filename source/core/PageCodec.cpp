@@ -0,0 +1,613 @@
+// ============================================================================
+// PageCodec - Implementation
+// ============================================================================
+//
+// Binary layout (all integers little-endian):
+//
+//   Header      char[4] "SNPB" | u16 version | u8 coordEncoding | u8 reserved
+//               u32 metaLength | u32 layerCount
+//   Meta        metaLength bytes of compact UTF-8 JSON
+//   Layers      u32 strokeCount[layerCount]
+//   Strokes     (S = sum of strokeCount)
+//               u32 pointCount[S] | u32 argb[S] | f64 thickness[S] | u8 flags[S]
+//               S x (u16 idLength + UTF-8 id bytes)
+//   Points      (N = sum of pointCount)
+//               Float32:   f32 x[N] | f32 y[N]
+//               Quantized: u32 byteLength | varint zigzag (dx, dy) pairs,
+//                          deltas reset at the start of every stroke
+//               u16 pressure[N]   (0..65535 maps to 0.0..1.0)
+//               u32 byteLength | varint zigzag timestamp deltas, only for
+//                                strokes with STROKE_HAS_TIMESTAMPS, reset
+//                                at the start of every stroke
+// ============================================================================
+
+#include "PageCodec.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QtMath>
+
+#include <cstring>
+
+namespace PageCodec {
+
+namespace {
+
+constexpr char MAGIC[4] = { 'S', 'N', 'P', 'B' };
+constexpr int HEADER_SIZE = 16;
+
+/// Per-stroke flag: the stroke carries recorded timestamps.
+constexpr quint8 STROKE_HAS_TIMESTAMPS = 0x01;
+
+// ---------------------------------------------------------------------------
+// Little-endian writers
+// ---------------------------------------------------------------------------
+
+class Writer {
+public:
+    explicit Writer(QByteArray& buffer) : m_buf(buffer) {}
+
+    void raw(const char* data, int len) { m_buf.append(data, len); }
+
+    void u8(quint8 v) { m_buf.append(static_cast<char>(v)); }
+
+    void u16(quint16 v) {
+        char b[2] = { char(v & 0xff), char((v >> 8) & 0xff) };
+        m_buf.append(b, 2);
+    }
+
+    void u32(quint32 v) {
+        char b[4] = { char(v & 0xff), char((v >> 8) & 0xff),
+                      char((v >> 16) & 0xff), char((v >> 24) & 0xff) };
+        m_buf.append(b, 4);
+    }
+
+    void u64(quint64 v) {
+        u32(static_cast<quint32>(v & 0xffffffffu));
+        u32(static_cast<quint32>(v >> 32));
+    }
+
+    void f32(float v) {
+        quint32 bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u32(bits);
+    }
+
+    void f64(double v) {
+        quint64 bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u64(bits);
+    }
+
+    void varint(quint64 v) {
+        while (v >= 0x80) {
+            m_buf.append(static_cast<char>((v & 0x7f) | 0x80));
+            v >>= 7;
+        }
+        m_buf.append(static_cast<char>(v));
+    }
+
+    void zigzag(qint64 v) {
+        varint((static_cast<quint64>(v) << 1) ^ static_cast<quint64>(v >> 63));
+    }
+
+    int size() const { return static_cast<int>(m_buf.size()); }
+
+    /// Overwrite a previously reserved u32 slot at @p offset.
+    void patchU32(int offset, quint32 v) {
+        m_buf[offset]     = char(v & 0xff);
+        m_buf[offset + 1] = char((v >> 8) & 0xff);
+        m_buf[offset + 2] = char((v >> 16) & 0xff);
+        m_buf[offset + 3] = char((v >> 24) & 0xff);
+    }
+
+private:
+    QByteArray& m_buf;
+};
+
+// ---------------------------------------------------------------------------
+// Bounds-checked little-endian reader over a contiguous buffer
+// ---------------------------------------------------------------------------
+
+class Reader {
+public:
+    Reader(const char* data, qint64 size)
+        : m_p(reinterpret_cast<const uchar*>(data)), m_end(m_p + size) {}
+
+    bool ok() const { return m_ok; }
+    qint64 remaining() const { return m_end - m_p; }
+    const char* pos() const { return reinterpret_cast<const char*>(m_p); }
+
+    bool need(qint64 n) {
+        if (!m_ok || n < 0 || remaining() < n) {
+            m_ok = false;
+            return false;
+        }
+        return true;
+    }
+
+    void skip(qint64 n) { if (need(n)) m_p += n; }
+
+    quint8 u8() {
+        if (!need(1)) return 0;
+        return *m_p++;
+    }
+
+    quint16 u16() {
+        if (!need(2)) return 0;
+        quint16 v = quint16(m_p[0]) | (quint16(m_p[1]) << 8);
+        m_p += 2;
+        return v;
+    }
+
+    quint32 u32() {
+        if (!need(4)) return 0;
+        quint32 v = quint32(m_p[0]) | (quint32(m_p[1]) << 8)
+                  | (quint32(m_p[2]) << 16) | (quint32(m_p[3]) << 24);
+        m_p += 4;
+        return v;
+    }
+
+    quint64 u64() {
+        quint64 lo = u32();
+        quint64 hi = u32();
+        return lo | (hi << 32);
+    }
+
+    float f32() {
+        quint32 bits = u32();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    double f64() {
+        quint64 bits = u64();
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    quint64 varint() {
+        quint64 v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!need(1)) return 0;
+            const uchar b = *m_p++;
+            v |= quint64(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        m_ok = false;  // Over-long varint
+        return 0;
+    }
+
+    qint64 zigzag() {
+        const quint64 v = varint();
+        return static_cast<qint64>(v >> 1) ^ -static_cast<qint64>(v & 1);
+    }
+
+private:
+    const uchar* m_p;
+    const uchar* m_end;
+    bool m_ok = true;
+};
+
+inline qint64 quantizeCoord(qreal v)
+{
+    return qRound64(v * QUANTIZE_SCALE);
+}
+
+} // namespace
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+bool isBinary(const char* data, qint64 size)
+{
+    return size >= HEADER_SIZE && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+QByteArray encode(const QJsonObject& meta,
+                  const QVector<const QVector<VectorStroke>*>& layerStrokes,
+                  CoordEncoding encoding)
+{
+    const QByteArray metaBytes = QJsonDocument(meta).toJson(QJsonDocument::Compact);
+
+    qint64 strokeCount = 0;
+    qint64 pointCount = 0;
+    for (const QVector<VectorStroke>* strokes : layerStrokes) {
+        if (!strokes) continue;
+        strokeCount += strokes->size();
+        for (const VectorStroke& s : *strokes) {
+            pointCount += s.points.size();
+        }
+    }
+
+    QByteArray buffer;
+    // Float32 layout: 10 bytes per point plus ~1-2 bytes of timestamp delta;
+    // per-stroke overhead is dominated by the 36-char id.
+    buffer.reserve(static_cast<int>(HEADER_SIZE + metaBytes.size()
+                                    + strokeCount * 64 + pointCount * 12));
+    Writer w(buffer);
+
+    // ----- Header -----
+    w.raw(MAGIC, sizeof(MAGIC));
+    w.u16(FORMAT_VERSION);
+    w.u8(static_cast<quint8>(encoding));
+    w.u8(0);
+    w.u32(static_cast<quint32>(metaBytes.size()));
+    w.u32(static_cast<quint32>(layerStrokes.size()));
+
+    // ----- Meta -----
+    w.raw(metaBytes.constData(), static_cast<int>(metaBytes.size()));
+
+    // ----- Layers -----
+    for (const QVector<VectorStroke>* strokes : layerStrokes) {
+        w.u32(strokes ? static_cast<quint32>(strokes->size()) : 0u);
+    }
+
+    // Iterate every stroke across layers in file order.
+    auto forEachStroke = [&](auto&& fn) {
+        for (const QVector<VectorStroke>* strokes : layerStrokes) {
+            if (!strokes) continue;
+            for (const VectorStroke& s : *strokes) fn(s);
+        }
+    };
+
+    // ----- Stroke table (columnar) -----
+    forEachStroke([&](const VectorStroke& s) { w.u32(static_cast<quint32>(s.points.size())); });
+    forEachStroke([&](const VectorStroke& s) { w.u32(s.color.rgba()); });
+    forEachStroke([&](const VectorStroke& s) { w.f64(s.baseThickness); });
+    forEachStroke([&](const VectorStroke& s) {
+        w.u8(s.points.hasTimestamps() ? STROKE_HAS_TIMESTAMPS : 0);
+    });
+    forEachStroke([&](const VectorStroke& s) {
+        const QByteArray id = s.id.toString().toUtf8();
+        w.u16(static_cast<quint16>(qMin<int>(id.size(), 0xffff)));
+        w.raw(id.constData(), qMin<int>(id.size(), 0xffff));
+    });
+
+    // ----- Point columns -----
+    if (encoding == CoordEncoding::Quantized) {
+        const int lengthSlot = w.size();
+        w.u32(0);
+        forEachStroke([&](const VectorStroke& s) {
+            qint64 prevX = 0, prevY = 0;
+            const float* xs = s.points.xData();
+            const float* ys = s.points.yData();
+            for (int i = 0; i < s.points.size(); ++i) {
+                const qint64 qx = quantizeCoord(xs[i]);
+                const qint64 qy = quantizeCoord(ys[i]);
+                w.zigzag(qx - prevX);
+                w.zigzag(qy - prevY);
+                prevX = qx;
+                prevY = qy;
+            }
+        });
+        w.patchU32(lengthSlot, static_cast<quint32>(w.size() - lengthSlot - 4));
+    } else {
+        // In-memory columns are already float32: copy them straight through.
+        forEachStroke([&](const VectorStroke& s) {
+            const float* xs = s.points.xData();
+            for (int i = 0; i < s.points.size(); ++i) w.f32(xs[i]);
+        });
+        forEachStroke([&](const VectorStroke& s) {
+            const float* ys = s.points.yData();
+            for (int i = 0; i < s.points.size(); ++i) w.f32(ys[i]);
+        });
+    }
+
+    forEachStroke([&](const VectorStroke& s) {
+        const quint16* ps = s.points.pressureData();
+        for (int i = 0; i < s.points.size(); ++i) w.u16(ps[i]);
+    });
+
+    const int tsSlot = w.size();
+    w.u32(0);
+    forEachStroke([&](const VectorStroke& s) {
+        if (!s.points.hasTimestamps()) return;
+        qint64 prev = 0;
+        for (int i = 0; i < s.points.size(); ++i) {
+            const qint64 t = s.points.timestamp(i);
+            w.zigzag(t - prev);
+            prev = t;
+        }
+    });
+    w.patchU32(tsSlot, static_cast<quint32>(w.size() - tsSlot - 4));
+
+    return buffer;
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+namespace {
+
+bool fail(QString* error, const QString& message)
+{
+    if (error) *error = message;
+    return false;
+}
+
+bool decodeJson(const char* data, qint64 size, Container& out, QString* error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(
+        QByteArray::fromRawData(data, static_cast<int>(size)), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        return fail(error, QStringLiteral("JSON parse error: ") + parseError.errorString());
+    }
+    out.meta = doc.object();
+    out.layerStrokes.clear();
+    out.binary = false;
+    return true;
+}
+
+} // namespace
+
+bool decode(const char* data, qint64 size, Container& out,
+            bool withStrokes, QString* error)
+{
+    if (!isBinary(data, size)) {
+        return decodeJson(data, size, out, error);
+    }
+
+    Reader r(data, size);
+    r.skip(sizeof(MAGIC));
+    const quint16 version = r.u16();
+    const auto encoding = static_cast<CoordEncoding>(r.u8());
+    r.u8();  // reserved
+    const quint32 metaLength = r.u32();
+    const quint32 layerCount = r.u32();
+
+    if (version > FORMAT_VERSION) {
+        return fail(error, QStringLiteral("unsupported page container version %1").arg(version));
+    }
+    if (encoding != CoordEncoding::Float32 && encoding != CoordEncoding::Quantized) {
+        return fail(error, QStringLiteral("unknown coordinate encoding"));
+    }
+    if (!r.need(metaLength)) {
+        return fail(error, QStringLiteral("truncated page container header"));
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument metaDoc = QJsonDocument::fromJson(
+        QByteArray::fromRawData(r.pos(), static_cast<int>(metaLength)), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !metaDoc.isObject()) {
+        return fail(error, QStringLiteral("page container meta: ") + parseError.errorString());
+    }
+    r.skip(metaLength);
+
+    out.meta = metaDoc.object();
+    out.binary = true;
+    out.layerStrokes.clear();
+    if (!withStrokes) {
+        return true;
+    }
+
+    // Every declared layer needs at least its 4-byte count.
+    if (!r.need(static_cast<qint64>(layerCount) * 4)) {
+        return fail(error, QStringLiteral("truncated layer table"));
+    }
+    QVector<quint32> strokesPerLayer(static_cast<int>(layerCount));
+    qint64 strokeCount = 0;
+    for (quint32 i = 0; i < layerCount; ++i) {
+        strokesPerLayer[static_cast<int>(i)] = r.u32();
+        strokeCount += strokesPerLayer[static_cast<int>(i)];
+    }
+
+    // Stroke table: 4 + 4 + 8 + 1 + 2 bytes minimum per stroke.
+    if (!r.need(strokeCount * 19)) {
+        return fail(error, QStringLiteral("truncated stroke table"));
+    }
+    const int S = static_cast<int>(strokeCount);
+    QVector<quint32> pointCounts(S);
+    QVector<quint32> colors(S);
+    QVector<double> thickness(S);
+    QVector<quint8> flags(S);
+    qint64 pointCount = 0;
+    for (int i = 0; i < S; ++i) { pointCounts[i] = r.u32(); pointCount += pointCounts[i]; }
+    for (int i = 0; i < S; ++i) colors[i] = r.u32();
+    for (int i = 0; i < S; ++i) thickness[i] = r.f64();
+    for (int i = 0; i < S; ++i) flags[i] = r.u8();
+
+    // Reject corrupt point counts before allocating: every point needs at
+    // least 4 bytes (Quantized) or 10 bytes (Float32) of column data.
+    const qint64 minBytesPerPoint = (encoding == CoordEncoding::Float32) ? 10 : 4;
+    if (!r.need(pointCount * minBytesPerPoint)) {
+        return fail(error, QStringLiteral("truncated point columns"));
+    }
+
+    // Materialize strokes and their point storage in file order.
+    QVector<VectorStroke> all(S);
+    for (int i = 0; i < S; ++i) {
+        VectorStroke& s = all[i];
+        const quint16 idLength = r.u16();
+        if (!r.need(idLength)) break;
+        s.id = Id128::fromUtf8(r.pos(), idLength);
+        r.skip(idLength);
+        if (s.id.isNull()) {
+            s.id = Id128::create();
+        }
+        s.color = QColor::fromRgba(colors[i]);
+        s.baseThickness = thickness[i];
+        s.points.resize(static_cast<int>(pointCounts[i]));
+    }
+    if (!r.ok()) {
+        return fail(error, QStringLiteral("truncated stroke ids"));
+    }
+
+    // ----- Coordinates -----
+    if (encoding == CoordEncoding::Quantized) {
+        const quint32 byteLength = r.u32();
+        if (!r.need(byteLength)) {
+            return fail(error, QStringLiteral("truncated coordinate stream"));
+        }
+        Reader coords(r.pos(), byteLength);
+        for (VectorStroke& s : all) {
+            qint64 x = 0, y = 0;
+            float* xs = s.points.mutableXData();
+            float* ys = s.points.mutableYData();
+            for (int k = 0; k < s.points.size(); ++k) {
+                x += coords.zigzag();
+                y += coords.zigzag();
+                xs[k] = static_cast<float>(static_cast<qreal>(x) / QUANTIZE_SCALE);
+                ys[k] = static_cast<float>(static_cast<qreal>(y) / QUANTIZE_SCALE);
+            }
+        }
+        if (!coords.ok()) {
+            return fail(error, QStringLiteral("corrupt coordinate stream"));
+        }
+        r.skip(byteLength);
+    } else {
+        if (!r.need(pointCount * 8)) {
+            return fail(error, QStringLiteral("truncated coordinate columns"));
+        }
+        Reader xs(r.pos(), pointCount * 4);
+        Reader ys(r.pos() + pointCount * 4, pointCount * 4);
+        for (VectorStroke& s : all) {
+            float* px = s.points.mutableXData();
+            float* py = s.points.mutableYData();
+            for (int k = 0; k < s.points.size(); ++k) {
+                px[k] = xs.f32();
+                py[k] = ys.f32();
+            }
+        }
+        r.skip(pointCount * 8);
+    }
+
+    // ----- Pressure -----
+    if (!r.need(pointCount * 2)) {
+        return fail(error, QStringLiteral("truncated pressure column"));
+    }
+    for (VectorStroke& s : all) {
+        quint16* ps = s.points.mutablePressureData();
+        for (int k = 0; k < s.points.size(); ++k) ps[k] = r.u16();
+    }
+
+    // ----- Timestamps -----
+    const quint32 tsLength = r.u32();
+    if (!r.need(tsLength)) {
+        return fail(error, QStringLiteral("truncated timestamp stream"));
+    }
+    Reader ts(r.pos(), tsLength);
+    for (int i = 0; i < S; ++i) {
+        if (!(flags[i] & STROKE_HAS_TIMESTAMPS)) continue;
+        qint64 t = 0;
+        StrokePointList& points = all[i].points;
+        for (int k = 0; k < points.size(); ++k) {
+            t += ts.zigzag();
+            points.setTimestamp(k, t);
+        }
+    }
+    if (!ts.ok()) {
+        return fail(error, QStringLiteral("corrupt timestamp stream"));
+    }
+
+    for (VectorStroke& s : all) {
+        s.updateBoundingBox();
+    }
+
+    // Split the flat stroke list back into layers.
+    out.layerStrokes.resize(static_cast<int>(layerCount));
+    int next = 0;
+    for (int l = 0; l < static_cast<int>(layerCount); ++l) {
+        QVector<VectorStroke>& dst = out.layerStrokes[l];
+        const int n = static_cast<int>(strokesPerLayer[l]);
+        dst.reserve(n);
+        for (int k = 0; k < n; ++k) {
+            dst.append(std::move(all[next++]));
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// File helpers
+// ============================================================================
+
+QString existingFile(const QString& stemPath)
+{
+    const QString binaryPath = stemPath + binarySuffix();
+    if (QFile::exists(binaryPath)) return binaryPath;
+    const QString jsonPath = stemPath + jsonSuffix();
+    if (QFile::exists(jsonPath)) return jsonPath;
+    return QString();
+}
+
+bool fileExists(const QString& stemPath)
+{
+    return !existingFile(stemPath).isEmpty();
+}
+
+bool readFile(const QString& stemPath, Container& out, bool withStrokes, QString* error)
+{
+    const QString path = existingFile(stemPath);
+    if (path.isEmpty()) {
+        return fail(error, QStringLiteral("file not found"));
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(error, QStringLiteral("cannot open ") + path);
+    }
+
+    const qint64 size = file.size();
+    if (size <= 0) {
+        return fail(error, QStringLiteral("empty file ") + path);
+    }
+
+    // Decode straight out of the page cache when the platform supports it;
+    // fall back to a single read into one contiguous buffer otherwise.
+    if (uchar* mapped = file.map(0, size)) {
+        const bool ok = decode(reinterpret_cast<const char*>(mapped), size,
+                               out, withStrokes, error);
+        file.unmap(mapped);
+        return ok;
+    }
+
+    const QByteArray data = file.readAll();
+    return decode(data.constData(), data.size(), out, withStrokes, error);
+}
+
+bool writeFile(const QString& stemPath, const QJsonObject& meta,
+               const QVector<const QVector<VectorStroke>*>& layerStrokes,
+               CoordEncoding encoding)
+{
+    const QByteArray bytes = encode(meta, layerStrokes, encoding);
+
+    // Write to a temporary file and rename it over the old one, so a crash
+    // mid-save leaves the previous version intact.
+    QSaveFile file(stemPath + binarySuffix());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (file.write(bytes) != bytes.size() || !file.commit()) {
+        return false;
+    }
+
+    // The binary file supersedes any legacy JSON written by older versions.
+    QFile::remove(stemPath + jsonSuffix());
+    return true;
+}
+
+bool removeFiles(const QString& stemPath)
+{
+    const bool removedBinary = QFile::remove(stemPath + binarySuffix());
+    const bool removedJson = QFile::remove(stemPath + jsonSuffix());
+    return removedBinary || removedJson;
+}
+
+bool copyFile(const QString& fromStemPath, const QString& toStemPath)
+{
+    const QString from = existingFile(fromStemPath);
+    if (from.isEmpty()) return false;
+    const QString suffix = from.endsWith(binarySuffix()) ? binarySuffix() : jsonSuffix();
+    return QFile::copy(from, toStemPath + suffix);
+}
+
+} // namespace PageCodec
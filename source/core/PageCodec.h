@@ -0,0 +1,150 @@
+// ============================================================================
+// PageCodec - Binary columnar container for page and tile files
+// ============================================================================
+// Page and tile files used to be a single compact JSON document in which every
+// stroke point is its own {"x","y","p","t"} object. For pages with hundreds of
+// thousands of points that means megabytes of JSON text to format and parse.
+//
+// The binary container (".snpb", bundle format 4) splits a page/tile into:
+// - a small compact JSON header carrying everything except stroke points
+//   (page settings, layer properties, objects) - identical to the legacy JSON
+//   with each layer's "strokes" array removed, so Page::fromJson() and the
+//   outline/asset peek helpers can keep consuming it unchanged;
+// - packed columnar stroke arrays: per-stroke metadata, x/y as float32 or
+//   quantized delta varints, pressure as uint16, timestamps delta-encoded.
+//
+// Decoding works on a single contiguous buffer (a memory-mapped file where
+// available), so loading a page is one pass over the columns with no
+// intermediate JSON values for the points.
+// ============================================================================
+
+#ifndef PAGECODEC_H
+#define PAGECODEC_H
+
+#include "../strokes/VectorStroke.h"
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+namespace PageCodec {
+
+/// Container format version stored in the file header.
+constexpr quint16 FORMAT_VERSION = 1;
+
+/// File suffix of binary page/tile containers (legacy files use ".json").
+inline QString binarySuffix() { return QStringLiteral(".snpb"); }
+
+/// File suffix of legacy JSON page/tile files.
+inline QString jsonSuffix() { return QStringLiteral(".json"); }
+
+/**
+ * @brief How x/y coordinates are stored in the point columns.
+ *
+ * Float32 is the default: fixed-width columns that decode with no branching.
+ * Quantized stores per-stroke zigzag deltas in 1/QUANTIZE_SCALE pixel units
+ * as varints, which is roughly half the size for typical handwriting at the
+ * cost of a slightly slower decode.
+ */
+enum class CoordEncoding : quint8 {
+    Float32 = 0,
+    Quantized = 1
+};
+
+/// Quantization step for CoordEncoding::Quantized (units per logical pixel).
+constexpr int QUANTIZE_SCALE = 100;
+
+/**
+ * @brief A decoded page/tile container.
+ *
+ * For binary files, @c meta holds the JSON header (layers without their
+ * "strokes" arrays) and @c layerStrokes holds one stroke list per entry of
+ * meta["layers"], in the same order. For legacy JSON files, @c meta is the
+ * complete document (strokes inline) and @c layerStrokes is empty.
+ */
+struct Container {
+    QJsonObject meta;
+    QVector<QVector<VectorStroke>> layerStrokes;
+    bool binary = false;
+};
+
+/**
+ * @brief Check whether @p data starts with the binary container magic.
+ */
+bool isBinary(const char* data, qint64 size);
+
+/**
+ * @brief Encode a page/tile into a binary container.
+ * @param meta Page/tile JSON without per-layer "strokes" arrays.
+ * @param layerStrokes One stroke list per meta["layers"] entry (same order).
+ * @param encoding Coordinate encoding for the point columns.
+ * @return The encoded bytes.
+ */
+QByteArray encode(const QJsonObject& meta,
+                  const QVector<const QVector<VectorStroke>*>& layerStrokes,
+                  CoordEncoding encoding = CoordEncoding::Float32);
+
+/**
+ * @brief Decode a binary container or a legacy JSON document.
+ * @param data Pointer to the file contents.
+ * @param size Number of bytes at @p data.
+ * @param out Receives the decoded container.
+ * @param withStrokes If false, only the JSON header is decoded (used by the
+ *        outline/asset peek helpers that only look at "objects").
+ * @param error Optional human-readable error on failure.
+ * @return True on success.
+ */
+bool decode(const char* data, qint64 size, Container& out,
+            bool withStrokes = true, QString* error = nullptr);
+
+/**
+ * @brief Read and decode a page/tile file.
+ * @param stemPath File path without suffix (e.g. ".../pages/<uuid>").
+ *        The binary file is preferred; the legacy JSON file is the fallback.
+ * @param out Receives the decoded container.
+ * @param withStrokes See decode().
+ * @param error Optional error description on failure.
+ * @return True on success, false if neither file exists or decoding failed.
+ */
+bool readFile(const QString& stemPath, Container& out,
+              bool withStrokes = true, QString* error = nullptr);
+
+/**
+ * @brief Encode and write a page/tile file as a binary container.
+ * @param stemPath File path without suffix.
+ *
+ * The file is replaced atomically (QSaveFile). A stale legacy JSON file for
+ * the same stem is removed after a successful write so the loader never sees
+ * two versions of the same page.
+ */
+bool writeFile(const QString& stemPath, const QJsonObject& meta,
+               const QVector<const QVector<VectorStroke>*>& layerStrokes,
+               CoordEncoding encoding = CoordEncoding::Float32);
+
+/**
+ * @brief Return the existing file for @p stemPath (binary first, then JSON),
+ *        or an empty string if neither exists.
+ */
+QString existingFile(const QString& stemPath);
+
+/**
+ * @brief Check whether a page/tile file exists in either format.
+ */
+bool fileExists(const QString& stemPath);
+
+/**
+ * @brief Remove both the binary and the legacy JSON file for @p stemPath.
+ * @return True if at least one file was removed.
+ */
+bool removeFiles(const QString& stemPath);
+
+/**
+ * @brief Copy the page/tile file (whichever format exists) to another stem.
+ * @return True if a file was copied.
+ */
+bool copyFile(const QString& fromStemPath, const QString& toStemPath);
+
+} // namespace PageCodec
+
+#endif // PAGECODEC_H
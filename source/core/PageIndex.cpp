@@ -0,0 +1,339 @@
+// ============================================================================
+// PageIndex - Implementation
+// ============================================================================
+//
+// Layout (all integers little-endian):
+//
+//   Header   char[4] "SNPI" | u16 version | u16 recordSize
+//            u32 pageCount | u32 sourceCount | u64 stamp
+//            u32 sourceTableOffset | u32 reserved
+//   Records  pageCount x RECORD_SIZE, in document order:
+//            u8 uuid[16] (RFC 4122) | f64 width | f64 height
+//            i32 pdfPage (-1 = none) | i32 sourceSlot (-1 = primary)
+//            u32 flags | u32 reserved
+//   Sorted   u32 recordIndex[pageCount], ordered by uuid bytes
+//   Sources  sourceCount x (u16 length + UTF-8 id bytes)
+// ============================================================================
+
+#include "PageIndex.h"
+
+#include <QHash>
+#include <QUuid>
+#include <QVector>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+
+constexpr char MAGIC[4] = { 'S', 'N', 'P', 'I' };
+constexpr int HEADER_SIZE = 32;
+constexpr int RECORD_SIZE = 48;
+constexpr int UUID_SIZE = 16;
+
+/// Record flag: width/height are valid.
+constexpr quint32 RECORD_HAS_SIZE = 0x01;
+
+template <typename T>
+void appendLE(QByteArray& buf, T v)
+{
+    char b[sizeof(T)];
+    qToLittleEndian(v, b);
+    buf.append(b, sizeof(T));
+}
+
+void appendF64(QByteArray& buf, double v)
+{
+    quint64 bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    appendLE<quint64>(buf, bits);
+}
+
+template <typename T>
+T readLE(const uchar* p)
+{
+    return qFromLittleEndian<T>(p);
+}
+
+double readF64(const uchar* p)
+{
+    const quint64 bits = readLE<quint64>(p);
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+} // namespace
+
+PageIndex::~PageIndex()
+{
+    close();
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+bool PageIndex::canIndex(const QStringList& pageOrder)
+{
+    for (const QString& uuid : pageOrder) {
+        const QUuid parsed(uuid);
+        if (parsed.isNull() || parsed.toString(QUuid::WithoutBraces) != uuid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PageIndex::writeFile(const QString& path, const QStringList& pageOrder,
+                          const std::map<QString, QSizeF>& sizes,
+                          const std::map<QString, int>& pdfPages,
+                          const std::map<QString, QString>& pdfSources,
+                          quint64 stamp)
+{
+    const int count = pageOrder.size();
+
+    QStringList sources;
+    QHash<QString, int> sourceSlots;
+    QVector<QByteArray> keys(count);
+
+    QByteArray records;
+    records.reserve(count * RECORD_SIZE);
+    for (int i = 0; i < count; ++i) {
+        const QString& uuid = pageOrder[i];
+        keys[i] = QUuid(uuid).toRfc4122();
+        records.append(keys[i]);
+
+        quint32 flags = 0;
+        QSizeF size;
+        auto sizeIt = sizes.find(uuid);
+        if (sizeIt != sizes.end()) {
+            size = sizeIt->second;
+            flags |= RECORD_HAS_SIZE;
+        }
+        appendF64(records, size.width());
+        appendF64(records, size.height());
+
+        auto pdfIt = pdfPages.find(uuid);
+        appendLE<qint32>(records, pdfIt != pdfPages.end() ? pdfIt->second : -1);
+
+        qint32 slot = -1;
+        auto srcIt = pdfSources.find(uuid);
+        if (srcIt != pdfSources.end() && !srcIt->second.isEmpty()) {
+            auto slotIt = sourceSlots.constFind(srcIt->second);
+            if (slotIt == sourceSlots.constEnd()) {
+                slotIt = sourceSlots.insert(srcIt->second, sources.size());
+                sources.append(srcIt->second);
+            }
+            slot = *slotIt;
+        }
+        appendLE<qint32>(records, slot);
+        appendLE<quint32>(records, flags);
+        appendLE<quint32>(records, 0);
+    }
+
+    QVector<quint32> sorted(count);
+    for (int i = 0; i < count; ++i) {
+        sorted[i] = quint32(i);
+    }
+    std::sort(sorted.begin(), sorted.end(), [&keys](quint32 a, quint32 b) {
+        return std::memcmp(keys[a].constData(), keys[b].constData(), UUID_SIZE) < 0;
+    });
+
+    const quint32 sourceTableOffset = quint32(HEADER_SIZE + records.size() + count * 4);
+
+    QByteArray bytes;
+    bytes.reserve(int(sourceTableOffset) + sources.size() * 40);
+    bytes.append(MAGIC, 4);
+    appendLE<quint16>(bytes, FORMAT_VERSION);
+    appendLE<quint16>(bytes, RECORD_SIZE);
+    appendLE<quint32>(bytes, quint32(count));
+    appendLE<quint32>(bytes, quint32(sources.size()));
+    appendLE<quint64>(bytes, stamp);
+    appendLE<quint32>(bytes, sourceTableOffset);
+    appendLE<quint32>(bytes, 0);
+    bytes.append(records);
+    for (quint32 index : std::as_const(sorted)) {
+        appendLE<quint32>(bytes, index);
+    }
+    for (const QString& source : std::as_const(sources)) {
+        const QByteArray utf8 = source.toUtf8();
+        appendLE<quint16>(bytes, quint16(utf8.size()));
+        bytes.append(utf8);
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    const bool written = file.write(bytes) == bytes.size();
+    file.close();
+    return written;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+bool PageIndex::open(const QString& path, quint64 expectedStamp)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const qint64 size = m_file.size();
+    if (size < HEADER_SIZE) {
+        close();
+        return false;
+    }
+
+    // Same approach as PageCodec::readFile(): map when the platform allows,
+    // otherwise keep one contiguous copy.
+    m_mapped = m_file.map(0, size);
+    if (m_mapped) {
+        m_data = m_mapped;
+    } else {
+        m_buffer = m_file.readAll();
+        m_file.close();
+        if (m_buffer.size() != size) {
+            close();
+            return false;
+        }
+        m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+    }
+
+    const quint32 count = readLE<quint32>(m_data + 8);
+    const quint32 sourceCount = readLE<quint32>(m_data + 12);
+    const quint32 sourceTableOffset = readLE<quint32>(m_data + 24);
+    const bool headerOk = std::memcmp(m_data, MAGIC, 4) == 0
+        && readLE<quint16>(m_data + 4) == FORMAT_VERSION
+        && readLE<quint16>(m_data + 6) == RECORD_SIZE
+        && readLE<quint64>(m_data + 16) == expectedStamp
+        && count <= quint32(std::numeric_limits<int>::max() / RECORD_SIZE)
+        && qint64(sourceTableOffset) == HEADER_SIZE + qint64(count) * (RECORD_SIZE + 4)
+        && qint64(sourceTableOffset) <= size;
+    if (!headerOk) {
+        close();
+        return false;
+    }
+
+    // The source table is a handful of ids; decode it once up front.
+    qint64 pos = sourceTableOffset;
+    for (quint32 s = 0; s < sourceCount; ++s) {
+        if (pos + 2 > size) {
+            close();
+            return false;
+        }
+        const quint16 len = readLE<quint16>(m_data + pos);
+        pos += 2;
+        if (pos + len > size) {
+            close();
+            return false;
+        }
+        m_sources.append(QString::fromUtf8(reinterpret_cast<const char*>(m_data + pos), len));
+        pos += len;
+    }
+
+    m_pageCount = int(count);
+    return true;
+}
+
+void PageIndex::close()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_buffer.clear();
+    m_data = nullptr;
+    m_pageCount = 0;
+    m_sources.clear();
+}
+
+const uchar* PageIndex::record(int index) const
+{
+    if (!m_data || index < 0 || index >= m_pageCount) {
+        return nullptr;
+    }
+    return m_data + HEADER_SIZE + qint64(index) * RECORD_SIZE;
+}
+
+QString PageIndex::uuidAt(int index) const
+{
+    const uchar* r = record(index);
+    if (!r) {
+        return QString();
+    }
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(r), UUID_SIZE);
+    return QUuid::fromRfc4122(bytes).toString(QUuid::WithoutBraces);
+}
+
+bool PageIndex::sizeAt(int index, QSizeF& size) const
+{
+    const uchar* r = record(index);
+    if (!r || !(readLE<quint32>(r + 40) & RECORD_HAS_SIZE)) {
+        return false;
+    }
+    size = QSizeF(readF64(r + 16), readF64(r + 24));
+    return true;
+}
+
+int PageIndex::pdfPageAt(int index) const
+{
+    const uchar* r = record(index);
+    return r ? readLE<qint32>(r + 32) : -1;
+}
+
+QString PageIndex::pdfSourceAt(int index) const
+{
+    const uchar* r = record(index);
+    if (!r) {
+        return QString();
+    }
+    const qint32 slot = readLE<qint32>(r + 36);
+    return (slot >= 0 && slot < m_sources.size()) ? m_sources[slot] : QString();
+}
+
+int PageIndex::indexOf(const QString& uuid) const
+{
+    if (!m_data || uuid.isEmpty()) {
+        return -1;
+    }
+    // Only canonical strings are stored; anything else (braces, upper case)
+    // would not have matched the QStringList lookup this replaces either.
+    const QUuid parsed(uuid);
+    if (parsed.isNull() || parsed.toString(QUuid::WithoutBraces) != uuid) {
+        return -1;
+    }
+    const QByteArray key = parsed.toRfc4122();
+
+    const uchar* sorted = m_data + HEADER_SIZE + qint64(m_pageCount) * RECORD_SIZE;
+    int lo = 0;
+    int hi = m_pageCount;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        const quint32 candidate = readLE<quint32>(sorted + qint64(mid) * 4);
+        const uchar* r = record(int(candidate));
+        if (!r) {
+            return -1;  // Corrupt permutation table
+        }
+        const int cmp = std::memcmp(r, key.constData(), UUID_SIZE);
+        if (cmp == 0) {
+            return int(candidate);
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -1;
+}
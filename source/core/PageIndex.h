@@ -0,0 +1,133 @@
+#ifndef PAGEINDEX_H
+#define PAGEINDEX_H
+
+// ============================================================================
+// PageIndex - Memory-mapped binary page table for paged bundles
+// ============================================================================
+// A paged bundle's manifest (document.json) carries the page order and a
+// per-page metadata object (size, PDF page, PDF source). Loading a large
+// notebook used to convert all of it into a QStringList and three
+// std::map<QString, ...> tables before the first page could be painted.
+//
+// pages.snpi stores the same page table as fixed-size records that are read
+// straight out of a memory-mapped file, so Document can answer "what is page
+// i", "how big is it" and "where is uuid X" without building anything. The
+// JSON page table is still written next to it and is used whenever the index
+// is missing, stale or unreadable.
+//
+// Page content lives in pages/<uuid>.snpb, addressed by uuid, so records do
+// not need a file offset.
+// ============================================================================
+
+#include <QByteArray>
+#include <QFile>
+#include <QSizeF>
+#include <QString>
+#include <QStringList>
+
+#include <map>
+
+/**
+ * @brief Read-only view of a pages.snpi file, plus the writer for it.
+ *
+ * The index is tied to the manifest it was written with by a random stamp
+ * stored in both; open() rejects an index whose stamp does not match, which
+ * covers crashes between the two writes and bundles saved by older versions
+ * that only updated document.json.
+ */
+class PageIndex {
+public:
+    /// File format version stored in the header.
+    static constexpr quint16 FORMAT_VERSION = 1;
+
+    /// File name inside the bundle directory.
+    static QString fileName() { return QStringLiteral("pages.snpi"); }
+
+    PageIndex() = default;
+    ~PageIndex();
+
+    PageIndex(const PageIndex&) = delete;
+    PageIndex& operator=(const PageIndex&) = delete;
+
+    // ===== Writing =====
+
+    /**
+     * @brief Check whether every uuid in @p pageOrder can be stored as a
+     *        16-byte record key and read back as the identical string.
+     */
+    static bool canIndex(const QStringList& pageOrder);
+
+    /**
+     * @brief Write an index for the given page table.
+     * @param path Destination file.
+     * @param pageOrder Page uuids in document order (must pass canIndex()).
+     * @param sizes Page sizes; pages without an entry are stored as unsized.
+     * @param pdfPages PDF page number of PDF-backed pages.
+     * @param pdfSources Source id of pages backed by a non-primary source.
+     * @param stamp Value that the manifest records alongside the index.
+     * @return true on success.
+     */
+    static bool writeFile(const QString& path, const QStringList& pageOrder,
+                          const std::map<QString, QSizeF>& sizes,
+                          const std::map<QString, int>& pdfPages,
+                          const std::map<QString, QString>& pdfSources,
+                          quint64 stamp);
+
+    // ===== Reading =====
+
+    /**
+     * @brief Map @p path and validate it against @p expectedStamp.
+     * @return true if the index is usable; on false the object stays closed.
+     */
+    bool open(const QString& path, quint64 expectedStamp);
+
+    /**
+     * @brief Unmap and close the file.
+     */
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    int pageCount() const { return m_pageCount; }
+
+    /**
+     * @brief Page uuid at document position @p index (empty if out of range).
+     */
+    QString uuidAt(int index) const;
+
+    /**
+     * @brief Stored size of the page at @p index.
+     * @return false if out of range or the page has no stored size.
+     */
+    bool sizeAt(int index, QSizeF& size) const;
+
+    /**
+     * @brief PDF page number of the page at @p index, or -1 if not PDF-backed.
+     */
+    int pdfPageAt(int index) const;
+
+    /**
+     * @brief PDF source id of the page at @p index (empty = primary source).
+     */
+    QString pdfSourceAt(int index) const;
+
+    /**
+     * @brief Document position of @p uuid, or -1 if it is not in the index.
+     *
+     * Binary search over the uuid-sorted permutation table: O(log n) with
+     * no per-document hash to build.
+     */
+    int indexOf(const QString& uuid) const;
+
+private:
+    const uchar* record(int index) const;
+
+    QFile m_file;
+    QByteArray m_buffer;             ///< Backing store when mapping is unavailable
+    const uchar* m_data = nullptr;   ///< Start of the file contents
+    uchar* m_mapped = nullptr;       ///< Mapping to release in close()
+    int m_pageCount = 0;
+    QStringList m_sources;           ///< Source id table (slot -> id)
+};
+
+#endif // PAGEINDEX_H
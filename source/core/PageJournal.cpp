@@ -0,0 +1,694 @@
+// ============================================================================
+// PageJournal - Implementation
+// ============================================================================
+//
+// Layout (all integers little-endian):
+//
+//   Header   char[4] "SNJL" | u16 version | u16 reserved | u64 firstSeq
+//   Records  u32 payloadSize | u16 keySize | u16 reserved | u64 seq
+//            u8 key[keySize] (UTF-8 stem relative to the bundle, e.g.
+//            "pages/<uuid>" or "tiles/3,-1") | u8 payload[payloadSize]
+//            u64 checksum (FNV-1a over the record up to the checksum)
+//
+// A payload is a PageCodec container. Its JSON header holds:
+//   "layers"   [{ "id" }] - layers with added strokes, one stroke list each
+//   "removed"  { layerId: [strokeId, ...] } - strokes removed per layer
+//   "page"     the page/tile header JSON, present only when it changed
+// Replay applies "page" first (re-keying stroke lists by layer id), then
+// removals, then additions.
+// ============================================================================
+
+#include "PageJournal.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr char MAGIC[4] = { 'S', 'N', 'J', 'L' };
+constexpr int HEADER_SIZE = 16;
+constexpr int RECORD_HEADER_SIZE = 16;
+constexpr int CHECKSUM_SIZE = 8;
+
+/// Container header key carrying the sequence a container was written at.
+const QString SEQ_KEY = QStringLiteral("journalSeq");
+
+/// Upper bound for one record's payload; anything larger is corruption.
+constexpr quint32 MAX_PAYLOAD = 256u * 1024 * 1024;
+
+template <typename T>
+void appendLE(QByteArray& buf, T v)
+{
+    char b[sizeof(T)];
+    qToLittleEndian(v, b);
+    buf.append(b, sizeof(T));
+}
+
+template <typename T>
+T readLE(const char* p)
+{
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(p));
+}
+
+quint64 fnv1a(const char* data, qint64 size, quint64 hash = 0xcbf29ce484222325ull)
+{
+    for (qint64 i = 0; i < size; ++i) {
+        hash ^= static_cast<uchar>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+QByteArray headerBytes(quint64 firstSeq)
+{
+    QByteArray header;
+    header.append(MAGIC, sizeof(MAGIC));
+    appendLE<quint16>(header, PageJournal::FORMAT_VERSION);
+    appendLE<quint16>(header, 0);
+    appendLE<quint64>(header, firstSeq);
+    return header;
+}
+
+/// Sequence numbers start at the wall clock so that they keep increasing
+/// across journal resets and "save as" copies of stamped containers.
+quint64 clockSeq()
+{
+    return quint64(qMax<qint64>(1, QDateTime::currentMSecsSinceEpoch())) << 10;
+}
+
+} // namespace
+
+PageJournal::~PageJournal()
+{
+    close();
+}
+
+// ============================================================================
+// Attaching
+// ============================================================================
+
+void PageJournal::open(const QString& bundlePath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_file.close();
+    m_records.clear();
+    m_baselines.clear();
+    m_recordCount = 0;
+    m_validSize = 0;
+    m_fileSize = 0;
+    m_bundlePath = bundlePath;
+    m_nextSeq = clockSeq();
+
+    m_file.setFileName(bundlePath + "/" + fileName());
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return;  // No journal yet
+    }
+    const QByteArray data = m_file.readAll();
+    m_file.close();
+    m_fileSize = data.size();
+
+    if (data.size() < HEADER_SIZE || std::memcmp(data.constData(), MAGIC, sizeof(MAGIC)) != 0
+        || readLE<quint16>(data.constData() + 4) > FORMAT_VERSION) {
+        qWarning() << "PageJournal: ignoring unreadable journal" << m_file.fileName();
+        return;  // m_validSize = 0: the next append starts a new file
+    }
+    m_nextSeq = qMax(m_nextSeq, readLE<quint64>(data.constData() + 8));
+
+    qint64 pos = HEADER_SIZE;
+    while (pos + RECORD_HEADER_SIZE <= data.size()) {
+        const char* rec = data.constData() + pos;
+        const quint32 payloadSize = readLE<quint32>(rec);
+        const quint16 keySize = readLE<quint16>(rec + 4);
+        const quint64 seq = readLE<quint64>(rec + 8);
+        if (payloadSize > MAX_PAYLOAD) {
+            break;
+        }
+        const qint64 bodySize = RECORD_HEADER_SIZE + keySize + qint64(payloadSize);
+        if (pos + bodySize + CHECKSUM_SIZE > data.size()
+            || fnv1a(rec, bodySize) != readLE<quint64>(rec + bodySize)) {
+            break;  // Torn or corrupt tail: everything from here on is dropped
+        }
+        const QString key = QString::fromUtf8(rec + RECORD_HEADER_SIZE, keySize);
+        m_records[key].append(RecordRef{seq, pos + RECORD_HEADER_SIZE + keySize,
+                                        static_cast<qint32>(payloadSize)});
+        ++m_recordCount;
+        m_nextSeq = qMax(m_nextSeq, seq + 1);
+        pos += bodySize + CHECKSUM_SIZE;
+    }
+    m_validSize = pos;
+    if (m_validSize < m_fileSize) {
+        qWarning() << "PageJournal: dropping" << (m_fileSize - m_validSize)
+                   << "bytes of incomplete records in" << m_file.fileName();
+    }
+}
+
+void PageJournal::close()
+{
+    QMutexLocker locker(&m_mutex);
+    m_file.close();
+    m_records.clear();
+    m_baselines.clear();
+    m_recordCount = 0;
+    m_validSize = 0;
+    m_fileSize = 0;
+    m_bundlePath.clear();
+}
+
+QString PageJournal::bundlePath() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bundlePath;
+}
+
+QString PageJournal::keyFor(const QString& stemPath) const
+{
+    const QString prefix = m_bundlePath + "/";
+    if (!m_bundlePath.isEmpty() && stemPath.startsWith(prefix)) {
+        return stemPath.mid(prefix.size());
+    }
+    return QString();  // Not in this bundle: never journaled
+}
+
+quint64 PageJournal::takeSeq()
+{
+    return m_nextSeq++;
+}
+
+quint64 PageJournal::raiseSeqLocked(const QJsonObject& meta) const
+{
+    // A container copied from another bundle (or written while the clock was
+    // ahead) may carry a stamp above m_nextSeq. Records appended after it
+    // must still sort above the stamp, or readLocked() would skip them.
+    const quint64 stamp = meta.value(SEQ_KEY).toString().toULongLong();
+    m_nextSeq = qMax(m_nextSeq, stamp + 1);
+    return stamp;
+}
+
+// ============================================================================
+// Baselines and deltas
+// ============================================================================
+
+quint64 PageJournal::fingerprint(const VectorStroke& stroke)
+{
+    // Point data is covered by its revision; the rest is hashed.
+    const quint64 parts[3] = {
+        stroke.points.revision(),
+        quint64(stroke.color.rgba64()),
+        quint64(qHash(stroke.baseThickness)),
+    };
+    return fnv1a(reinterpret_cast<const char*>(parts), sizeof(parts));
+}
+
+std::shared_ptr<const PageJournal::Baseline> PageJournal::capture(
+    const QJsonObject& meta, const QVector<const QVector<VectorStroke>*>& layerStrokes)
+{
+    auto baseline = std::make_shared<Baseline>();
+    baseline->meta = meta;
+    baseline->meta.remove(SEQ_KEY);
+
+    const QJsonArray layers = meta["layers"].toArray();
+    const int count = qMin(int(layers.size()), int(layerStrokes.size()));
+    baseline->layers.resize(count);
+    for (int i = 0; i < count; ++i) {
+        LayerBaseline& layer = baseline->layers[i];
+        layer.id = layers[i].toObject()["id"].toString();
+        if (!layerStrokes[i]) continue;
+        layer.strokes.reserve(layerStrokes[i]->size());
+        for (const VectorStroke& stroke : *layerStrokes[i]) {
+            layer.strokes.append(StrokeStamp{stroke.id, fingerprint(stroke)});
+        }
+    }
+    return baseline;
+}
+
+bool PageJournal::makeDelta(const Baseline& baseline, const QJsonObject& meta,
+                            const QVector<const QVector<VectorStroke>*>& layerStrokes,
+                            QByteArray& payload)
+{
+    payload.clear();
+    const QJsonArray layers = meta["layers"].toArray();
+    if (layers.size() != layerStrokes.size()) {
+        return false;
+    }
+
+    QHash<QString, const LayerBaseline*> baseLayers;
+    for (const LayerBaseline& layer : baseline.layers) {
+        baseLayers.insert(layer.id, &layer);
+    }
+
+    QJsonArray addedLayers;
+    QVector<QVector<VectorStroke>> addedStrokes;
+    QJsonObject removed;
+    qint64 total = 0;
+    qint64 changed = 0;
+
+    for (int i = 0; i < layers.size(); ++i) {
+        const QString layerId = layers[i].toObject()["id"].toString();
+        const QVector<VectorStroke> empty;
+        const QVector<VectorStroke>& strokes = layerStrokes[i] ? *layerStrokes[i] : empty;
+        const LayerBaseline* base = baseLayers.value(layerId, nullptr);
+        const int baseCount = base ? base->strokes.size() : 0;
+
+        QHash<Id128, int> baseIndex;
+        baseIndex.reserve(baseCount);
+        for (int j = 0; j < baseCount; ++j) {
+            baseIndex.insert(base->strokes[j].id, j);
+        }
+
+        // Expressible as a delta: surviving strokes unchanged and in their
+        // old order, new strokes only after the last survivor.
+        QVector<bool> kept(baseCount, false);
+        QVector<VectorStroke> added;
+        int last = -1;
+        for (const VectorStroke& stroke : strokes) {
+            auto it = baseIndex.constFind(stroke.id);
+            if (it == baseIndex.constEnd()) {
+                added.append(stroke);
+                continue;
+            }
+            const int j = it.value();
+            if (!added.isEmpty() || j <= last || base->strokes[j].fingerprint != fingerprint(stroke)) {
+                return false;
+            }
+            kept[j] = true;
+            last = j;
+        }
+
+        QJsonArray removedIds;
+        for (int j = 0; j < baseCount; ++j) {
+            if (!kept[j]) {
+                removedIds.append(base->strokes[j].id.toString());
+            }
+        }
+        total += baseCount;
+        changed += removedIds.size() + added.size();
+        if (!removedIds.isEmpty()) {
+            removed[layerId] = removedIds;
+        }
+        if (!added.isEmpty()) {
+            QJsonObject layerObj;
+            layerObj["id"] = layerId;
+            addedLayers.append(layerObj);
+            addedStrokes.append(std::move(added));
+        }
+    }
+
+    const bool metaChanged = meta != baseline.meta;
+    if (!metaChanged && removed.isEmpty() && addedLayers.isEmpty()) {
+        return true;  // Unchanged
+    }
+    // A mostly replaced page is as cheap to rewrite and stays compact.
+    if (changed > 64 && changed * 2 > total) {
+        return false;
+    }
+
+    QJsonObject deltaMeta;
+    deltaMeta["layers"] = addedLayers;
+    if (!removed.isEmpty()) {
+        deltaMeta["removed"] = removed;
+    }
+    if (metaChanged) {
+        deltaMeta["page"] = meta;
+    }
+    QVector<const QVector<VectorStroke>*> lists;
+    lists.reserve(addedStrokes.size());
+    for (const QVector<VectorStroke>& strokes : std::as_const(addedStrokes)) {
+        lists.append(&strokes);
+    }
+    payload = PageCodec::encode(deltaMeta, lists);
+    return true;
+}
+
+bool PageJournal::applyDelta(PageCodec::Container& container, const QByteArray& payload,
+                             bool withStrokes)
+{
+    PageCodec::Container delta;
+    if (!PageCodec::decode(payload.constData(), payload.size(), delta, withStrokes)) {
+        return false;
+    }
+
+    if (delta.meta.contains("page")) {
+        const QJsonObject page = delta.meta["page"].toObject();
+        if (withStrokes) {
+            // Carry stroke lists over to the new layer table by layer id.
+            QHash<QString, int> oldIndex;
+            const QJsonArray oldLayers = container.meta["layers"].toArray();
+            for (int i = 0; i < oldLayers.size(); ++i) {
+                oldIndex.insert(oldLayers[i].toObject()["id"].toString(), i);
+            }
+            const QJsonArray newLayers = page["layers"].toArray();
+            QVector<QVector<VectorStroke>> lists(newLayers.size());
+            for (int i = 0; i < newLayers.size(); ++i) {
+                const int old = oldIndex.value(newLayers[i].toObject()["id"].toString(), -1);
+                if (old >= 0 && old < container.layerStrokes.size()) {
+                    lists[i] = std::move(container.layerStrokes[old]);
+                }
+            }
+            container.layerStrokes = std::move(lists);
+        }
+        container.meta = page;
+    }
+    if (!withStrokes) {
+        return true;
+    }
+
+    QHash<QString, int> layerIndex;
+    const QJsonArray layers = container.meta["layers"].toArray();
+    for (int i = 0; i < layers.size(); ++i) {
+        layerIndex.insert(layers[i].toObject()["id"].toString(), i);
+    }
+    container.layerStrokes.resize(layers.size());
+
+    const QJsonObject removed = delta.meta["removed"].toObject();
+    for (auto it = removed.constBegin(); it != removed.constEnd(); ++it) {
+        const int index = layerIndex.value(it.key(), -1);
+        if (index < 0) continue;
+        QSet<Id128> ids;
+        for (const QJsonValue& id : it.value().toArray()) {
+            ids.insert(Id128::fromString(id.toString()));
+        }
+        QVector<VectorStroke>& strokes = container.layerStrokes[index];
+        strokes.erase(std::remove_if(strokes.begin(), strokes.end(),
+                                     [&ids](const VectorStroke& s) { return ids.contains(s.id); }),
+                      strokes.end());
+    }
+
+    const QJsonArray added = delta.meta["layers"].toArray();
+    for (int i = 0; i < added.size() && i < delta.layerStrokes.size(); ++i) {
+        const int index = layerIndex.value(added[i].toObject()["id"].toString(), -1);
+        if (index < 0) continue;
+        QVector<VectorStroke>& strokes = container.layerStrokes[index];
+        for (VectorStroke& stroke : delta.layerStrokes[i]) {
+            strokes.append(std::move(stroke));
+        }
+    }
+    return true;
+}
+
+void PageJournal::setBaseline(const QString& stemPath, const PageCodec::Container& container)
+{
+    if (!container.binary) {
+        return;
+    }
+    QVector<const QVector<VectorStroke>*> lists;
+    lists.reserve(container.layerStrokes.size());
+    for (const QVector<VectorStroke>& strokes : container.layerStrokes) {
+        lists.append(&strokes);
+    }
+    auto baseline = capture(container.meta, lists);
+
+    QMutexLocker locker(&m_mutex);
+    raiseSeqLocked(container.meta);
+    const QString key = keyFor(stemPath);
+    if (!key.isEmpty()) {
+        m_baselines.insert(key, std::move(baseline));
+    }
+}
+
+void PageJournal::dropBaseline(const QString& stemPath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_baselines.remove(keyFor(stemPath));
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+bool PageJournal::read(const QString& stemPath, PageCodec::Container& out,
+                       bool withStrokes, QString* error) const
+{
+    QMutexLocker locker(&m_mutex);
+    return readLocked(stemPath, out, withStrokes, error);
+}
+
+bool PageJournal::readLocked(const QString& stemPath, PageCodec::Container& out,
+                             bool withStrokes, QString* error) const
+{
+    if (!PageCodec::readFile(stemPath, out, withStrokes, error)) {
+        return false;
+    }
+    const quint64 stamp = raiseSeqLocked(out.meta);
+    out.meta.remove(SEQ_KEY);
+
+    auto it = m_records.constFind(keyFor(stemPath));
+    if (it == m_records.constEnd() || !out.binary) {
+        return true;
+    }
+    if (!m_file.isOpen() && !m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "PageJournal: cannot reopen" << m_file.fileName();
+        return true;
+    }
+    for (const RecordRef& ref : it.value()) {
+        if (ref.seq <= stamp) {
+            continue;  // Already folded into this container
+        }
+        QByteArray payload;
+        if (m_file.seek(ref.offset)) {
+            payload = m_file.read(ref.size);
+        }
+        if (payload.size() != ref.size || !applyDelta(out, payload, withStrokes)) {
+            qWarning() << "PageJournal: cannot replay record for" << stemPath;
+            break;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+bool PageJournal::writeContainerLocked(const QString& stemPath, const QJsonObject& meta,
+                                       const QVector<const QVector<VectorStroke>*>& layerStrokes)
+{
+    QJsonObject stamped = meta;
+    const QString key = keyFor(stemPath);
+    if (!key.isEmpty()) {
+        // String, not double: JSON numbers cannot carry all 64 bits.
+        stamped[SEQ_KEY] = QString::number(takeSeq());
+    }
+    if (!PageCodec::writeFile(stemPath, stamped, layerStrokes)) {
+        return false;
+    }
+    if (!key.isEmpty()) {
+        auto it = m_records.find(key);
+        if (it != m_records.end()) {
+            m_recordCount -= it.value().size();
+            m_records.erase(it);
+        }
+    }
+    return true;
+}
+
+bool PageJournal::appendLocked(const QString& key, const QByteArray& payload)
+{
+    if (m_file.isOpen() && !(m_file.openMode() & QIODevice::WriteOnly)) {
+        m_file.close();
+    }
+    if (!m_file.isOpen()) {
+        if (!m_file.open(QIODevice::ReadWrite)) {
+            return false;
+        }
+        if (m_validSize < HEADER_SIZE) {
+            // New or unreadable journal: start over.
+            if (!m_file.resize(0) || m_file.write(headerBytes(m_nextSeq)) != HEADER_SIZE) {
+                m_file.close();
+                return false;
+            }
+            m_validSize = HEADER_SIZE;
+        } else if (m_fileSize > m_validSize && !m_file.resize(m_validSize)) {
+            m_file.close();
+            return false;  // Never append after a torn record
+        }
+        m_fileSize = m_validSize;
+    }
+
+    const QByteArray keyBytes = key.toUtf8();
+    const quint64 seq = takeSeq();
+    QByteArray record;
+    record.reserve(RECORD_HEADER_SIZE + keyBytes.size() + payload.size() + CHECKSUM_SIZE);
+    appendLE<quint32>(record, static_cast<quint32>(payload.size()));
+    appendLE<quint16>(record, static_cast<quint16>(keyBytes.size()));
+    appendLE<quint16>(record, 0);
+    appendLE<quint64>(record, seq);
+    record.append(keyBytes);
+    record.append(payload);
+    appendLE<quint64>(record, fnv1a(record.constData(), record.size()));
+
+    if (!m_file.seek(m_validSize) || m_file.write(record) != record.size() || !m_file.flush()) {
+        // Leave the partial record behind as a torn tail; cut it next time.
+        m_fileSize = m_file.size();
+        m_file.close();
+        return false;
+    }
+    m_records[key].append(RecordRef{seq, m_validSize + RECORD_HEADER_SIZE + keyBytes.size(),
+                                    static_cast<qint32>(payload.size())});
+    ++m_recordCount;
+    m_validSize += record.size();
+    m_fileSize = m_validSize;
+    return true;
+}
+
+PageJournal::SaveResult PageJournal::save(const QString& stemPath, const QJsonObject& meta,
+                                          const QVector<const QVector<VectorStroke>*>& layerStrokes,
+                                          bool forceFull)
+{
+    QMutexLocker locker(&m_mutex);
+    const QString key = keyFor(stemPath);
+    std::shared_ptr<const Baseline> baseline = key.isEmpty() ? nullptr : m_baselines.value(key);
+
+    if (!forceFull && baseline && PageCodec::fileExists(stemPath)
+        && m_records.value(key).size() < MAX_RECORDS_PER_PAGE) {
+        QByteArray payload;
+        if (makeDelta(*baseline, meta, layerStrokes, payload)) {
+            if (payload.isEmpty()) {
+                return SaveResult::Unchanged;
+            }
+            if (appendLocked(key, payload)) {
+                m_baselines.insert(key, capture(meta, layerStrokes));
+                return SaveResult::Journaled;
+            }
+            qWarning() << "PageJournal: append failed, writing" << stemPath << "in full";
+        }
+    }
+
+    if (!writeContainerLocked(stemPath, meta, layerStrokes)) {
+        return SaveResult::Failed;
+    }
+    if (!key.isEmpty()) {
+        m_baselines.insert(key, capture(meta, layerStrokes));
+    }
+    return SaveResult::Written;
+}
+
+bool PageJournal::removeFiles(const QString& stemPath)
+{
+    QMutexLocker locker(&m_mutex);
+    const QString key = keyFor(stemPath);
+    m_baselines.remove(key);
+    auto it = m_records.find(key);
+    if (it != m_records.end()) {
+        m_recordCount -= it.value().size();
+        m_records.erase(it);
+    }
+    return PageCodec::removeFiles(stemPath);
+}
+
+bool PageJournal::copyFile(const QString& fromStemPath, const QString& toStemPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_records.contains(keyFor(fromStemPath))) {
+        return PageCodec::copyFile(fromStemPath, toStemPath);
+    }
+    PageCodec::Container container;
+    if (!readLocked(fromStemPath, container, true, nullptr)) {
+        return false;
+    }
+    QVector<const QVector<VectorStroke>*> lists;
+    for (const QVector<VectorStroke>& strokes : std::as_const(container.layerStrokes)) {
+        lists.append(&strokes);
+    }
+    return PageCodec::writeFile(toStemPath, container.meta, lists);
+}
+
+// ============================================================================
+// Compaction
+// ============================================================================
+
+bool PageJournal::needsCompaction() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_validSize > COMPACT_BYTES || m_recordCount > COMPACT_RECORDS;
+}
+
+bool PageJournal::compact()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_bundlePath.isEmpty() || (m_recordCount == 0 && m_fileSize <= HEADER_SIZE)) {
+        return true;
+    }
+
+    // Fold every page with pending records. Each container is replaced
+    // atomically and stamped past all of its records, so a crash before the
+    // journal reset below just makes those records no-ops on replay.
+    bool ok = true;
+    const QStringList keys = m_records.keys();
+    for (const QString& key : keys) {
+        const QString stem = m_bundlePath + "/" + key;
+        if (!PageCodec::fileExists(stem)) {
+            m_recordCount -= m_records.take(key).size();
+            continue;  // Page deleted since; nothing to fold into
+        }
+        PageCodec::Container container;
+        QString error;
+        if (!readLocked(stem, container, true, &error)) {
+            qWarning() << "PageJournal: cannot compact" << stem << error;
+            ok = false;
+            continue;
+        }
+        QVector<const QVector<VectorStroke>*> lists;
+        for (const QVector<VectorStroke>& strokes : std::as_const(container.layerStrokes)) {
+            lists.append(&strokes);
+        }
+        if (!writeContainerLocked(stem, container.meta, lists)) {
+            qWarning() << "PageJournal: cannot write compacted" << stem;
+            ok = false;
+        }
+    }
+    if (!ok) {
+        return false;  // Keep the journal; folded pages are already stamped
+    }
+    return resetLocked();
+}
+
+bool PageJournal::resetLocked()
+{
+    m_file.close();
+    QSaveFile file(m_file.fileName());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(headerBytes(m_nextSeq));
+    if (!file.commit()) {
+        return false;
+    }
+    m_records.clear();
+    m_recordCount = 0;
+    m_validSize = HEADER_SIZE;
+    m_fileSize = HEADER_SIZE;
+    return true;
+}
+
+qint64 PageJournal::sizeBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_fileSize;
+}
+
+int PageJournal::pendingRecords() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_recordCount;
+}
+
+int PageJournal::pendingRecords(const QString& stemPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_records.value(keyFor(stemPath)).size();
+}
+
+quint64 PageJournal::lastRecordSeq(const QString& stemPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_records.constFind(keyFor(stemPath));
+    return (it == m_records.constEnd() || it->isEmpty()) ? 0 : it->last().seq;
+}
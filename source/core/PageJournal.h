@@ -0,0 +1,204 @@
+#ifndef PAGEJOURNAL_H
+#define PAGEJOURNAL_H
+
+// ============================================================================
+// PageJournal - Append-only delta log for page and tile containers
+// ============================================================================
+// Saving a dirty page used to re-encode and rewrite its whole container, so
+// one new stroke on a 30k-stroke page cost a full page write on every save.
+//
+// The journal (journal.snj in the bundle directory) records what changed
+// since a page was last written instead: strokes added and removed per layer,
+// plus the page's JSON header (settings, layer table, objects) when that
+// changed. Each record is a small PageCodec container, so added strokes use
+// the same packed columns as page files. A save therefore costs O(delta).
+//
+// Which records apply to a container is decided by sequence numbers: every
+// full container write stamps the container with a fresh "journalSeq", and
+// only records with a higher sequence are replayed on top of it. Compaction
+// folds pending records into their containers (written atomically) and then
+// atomically replaces the journal with an empty one; a crash at any point
+// leaves either the old or the new state readable. A torn record at the end
+// of the journal is detected by its checksum and dropped on open.
+//
+// Deltas are computed against a per-page baseline captured when the page was
+// last read or written. Changes a delta cannot express cheaply (strokes edited
+// in place or reordered, pages without a baseline, long record chains) fall
+// back to a full container write.
+//
+// All methods are thread-safe: the bundle writer thread saves through the
+// journal while the GUI thread loads pages through it.
+// ============================================================================
+
+#include "PageCodec.h"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+class PageJournal {
+public:
+    /// File format version stored in the header.
+    static constexpr quint16 FORMAT_VERSION = 1;
+
+    /// Compact once the journal grows beyond this many bytes...
+    static constexpr qint64 COMPACT_BYTES = 8ll * 1024 * 1024;
+
+    /// ...or holds this many records.
+    static constexpr int COMPACT_RECORDS = 4096;
+
+    /// A page with this many pending records is rewritten in full instead.
+    static constexpr int MAX_RECORDS_PER_PAGE = 32;
+
+    /// File name inside the bundle directory.
+    static QString fileName() { return QStringLiteral("journal.snj"); }
+
+    /// Outcome of save().
+    enum class SaveResult {
+        Failed,
+        Unchanged,   ///< Identical to the last written state; nothing written
+        Journaled,   ///< Delta appended to the journal
+        Written      ///< Full container written
+    };
+
+    PageJournal() = default;
+    ~PageJournal();
+
+    PageJournal(const PageJournal&) = delete;
+    PageJournal& operator=(const PageJournal&) = delete;
+
+    /**
+     * @brief Attach to the bundle at @p bundlePath and index its journal.
+     *
+     * Scans journal.snj (if any) and remembers where each page's records are.
+     * A torn tail is ignored here and truncated before the next append, so
+     * opening never writes and works on read-only bundles. Baselines of the
+     * previously attached bundle are dropped.
+     */
+    void open(const QString& bundlePath);
+
+    /// Detach; pending records stay in the file for the next open().
+    void close();
+
+    QString bundlePath() const;
+
+    /**
+     * @brief Read a page/tile container with its pending records applied.
+     * @param stemPath Absolute file path without suffix (see PageCodec).
+     * @see PageCodec::readFile()
+     */
+    bool read(const QString& stemPath, PageCodec::Container& out,
+              bool withStrokes = true, QString* error = nullptr) const;
+
+    /**
+     * @brief Remember @p container as the on-disk state of @p stemPath.
+     *
+     * Call right after read(), before the container's strokes are moved into
+     * a Page (stroke point revisions survive the move). Legacy JSON
+     * containers get no baseline, so their next save converts them.
+     */
+    void setBaseline(const QString& stemPath, const PageCodec::Container& container);
+
+    /// Forget the baseline of an evicted page (its next save is full).
+    void dropBaseline(const QString& stemPath);
+
+    /**
+     * @brief Persist a page/tile: journal the delta against its baseline if
+     *        possible, otherwise write the whole container.
+     * @param forceFull Always write the container (e.g. saving elsewhere).
+     */
+    SaveResult save(const QString& stemPath, const QJsonObject& meta,
+                    const QVector<const QVector<VectorStroke>*>& layerStrokes,
+                    bool forceFull = false);
+
+    /**
+     * @brief Delete a page/tile file together with its baseline and records.
+     * @return True if a file was removed (see PageCodec::removeFiles()).
+     */
+    bool removeFiles(const QString& stemPath);
+
+    /**
+     * @brief Copy a page/tile to another stem, folding in pending records.
+     * @return True if a file was written or copied.
+     */
+    bool copyFile(const QString& fromStemPath, const QString& toStemPath) const;
+
+    /// True if the journal is past COMPACT_BYTES or COMPACT_RECORDS.
+    bool needsCompaction() const;
+
+    /**
+     * @brief Fold all pending records into their containers and reset the
+     *        journal to empty.
+     */
+    bool compact();
+
+    /// Current journal size in bytes (0 when there is no journal file).
+    qint64 sizeBytes() const;
+
+    /// Number of pending records across all pages.
+    int pendingRecords() const;
+
+    /// Number of pending records for one page/tile.
+    int pendingRecords(const QString& stemPath) const;
+
+    /// Sequence of the newest pending record of one page/tile (0 if none).
+    quint64 lastRecordSeq(const QString& stemPath) const;
+
+private:
+    struct StrokeStamp {
+        Id128 id;
+        quint64 fingerprint;
+    };
+    struct LayerBaseline {
+        QString id;
+        QVector<StrokeStamp> strokes;
+    };
+    struct Baseline {
+        QJsonObject meta;                ///< Header JSON without "journalSeq"
+        QVector<LayerBaseline> layers;
+    };
+    struct RecordRef {
+        quint64 seq;
+        qint64 offset;                   ///< Payload offset in the file
+        qint32 size;                     ///< Payload size
+    };
+
+    static quint64 fingerprint(const VectorStroke& stroke);
+    static std::shared_ptr<const Baseline> capture(
+        const QJsonObject& meta, const QVector<const QVector<VectorStroke>*>& layerStrokes);
+    static bool makeDelta(const Baseline& baseline, const QJsonObject& meta,
+                          const QVector<const QVector<VectorStroke>*>& layerStrokes,
+                          QByteArray& payload);
+    static bool applyDelta(PageCodec::Container& container, const QByteArray& payload,
+                           bool withStrokes);
+
+    QString keyFor(const QString& stemPath) const;
+    quint64 takeSeq();
+    /// Keep m_nextSeq above a container's "journalSeq" stamp; returns the stamp.
+    quint64 raiseSeqLocked(const QJsonObject& meta) const;
+
+    // Callers hold m_mutex
+    bool readLocked(const QString& stemPath, PageCodec::Container& out,
+                    bool withStrokes, QString* error) const;
+    bool writeContainerLocked(const QString& stemPath, const QJsonObject& meta,
+                              const QVector<const QVector<VectorStroke>*>& layerStrokes);
+    bool appendLocked(const QString& key, const QByteArray& payload);
+    bool resetLocked();
+
+    mutable QMutex m_mutex;
+    QString m_bundlePath;
+    mutable QFile m_file;                ///< Opened on demand
+    qint64 m_validSize = 0;              ///< Bytes of intact records (incl. header)
+    qint64 m_fileSize = 0;               ///< Bytes on disk, including a torn tail
+    mutable quint64 m_nextSeq = 1;      ///< Raised by reads of stamped containers
+    int m_recordCount = 0;
+    QHash<QString, QVector<RecordRef>> m_records;
+    QHash<QString, std::shared_ptr<const Baseline>> m_baselines;
+};
+
+#endif // PAGEJOURNAL_H
@@ -7,16 +7,33 @@
 // 
 // Simple compile-time tests to verify Page functionality:
 // - Serialization round-trip (toJson/fromJson)
+// - Binary page container round-trip (PageCodec) and a JSON-vs-binary
+//   load/save benchmark
+// - VectorLayer spatial index consistency and an eraser/lasso hit-test
+//   microbenchmark
+// - Id128 round-trip and a QString-vs-Id128 stroke id memory report
+// - StrokePointList column storage and a bytes-per-point report
+// - StrokeOutlineCache reuse, invalidation and LRU eviction
 // - Layer management
 // - Object management
 // - Optional PNG export for visual verification
 // ============================================================================
 
 #include "Page.h"
+#include "PageCodec.h"
 #include "../objects/ImageObject.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QtMath>
 #include <cassert>
+#include <utility>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 namespace PageTests {
 
@@ -42,7 +59,7 @@ inline bool testSerializationRoundTrip()
     
     // Add strokes to both layers
     VectorStroke stroke1;
-    stroke1.id = "stroke-001";
+    stroke1.id = Id128::fromString(QStringLiteral("stroke-001"));
     stroke1.color = Qt::red;
     stroke1.baseThickness = 3.0;
     stroke1.points.append({QPointF(10, 10), 0.5});
@@ -53,7 +70,7 @@ inline bool testSerializationRoundTrip()
     page->layer(0)->addStroke(stroke1);
     
     VectorStroke stroke2;
-    stroke2.id = "stroke-002";
+    stroke2.id = Id128::fromString(QStringLiteral("stroke-002"));
     stroke2.color = Qt::blue;
     stroke2.baseThickness = 5.0;
     stroke2.points.append({QPointF(50, 100), 1.0});
@@ -124,7 +141,7 @@ inline bool testSerializationRoundTrip()
     
     // Check stroke data preserved
     const auto& restoredStroke = restored->layer(0)->strokes()[0];
-    if (restoredStroke.id != "stroke-001") {
+    if (restoredStroke.id.toString() != "stroke-001") {
         qDebug() << "FAIL: stroke id mismatch";
         success = false;
     }
@@ -169,6 +186,835 @@ inline bool testSerializationRoundTrip()
     return success;
 }
 
+/**
+ * @brief Build a page with synthetic handwriting for codec tests.
+ * @param strokeCount Number of strokes (spread across two layers).
+ * @param pointsPerStroke Points per stroke.
+ * @param seed Random seed (deterministic output).
+ */
+inline std::unique_ptr<Page> makeSyntheticInkPage(int strokeCount, int pointsPerStroke,
+                                                  quint32 seed = 42)
+{
+    QRandomGenerator rng(seed);
+    auto page = Page::createDefault(QSizeF(816, 1056));
+    page->addLayer("Layer 2");
+    
+    const qint64 baseTime = 1700000000000LL;
+    for (int s = 0; s < strokeCount; ++s) {
+        VectorStroke stroke;
+        stroke.id = Id128::create();
+        stroke.color = QColor::fromRgba(0xff000000u | rng.bounded(0x1000000u));
+        stroke.baseThickness = 1.0 + rng.bounded(8) * 0.5;
+        
+        qreal x = rng.bounded(800.0);
+        qreal y = rng.bounded(1040.0);
+        qreal angle = rng.bounded(2 * M_PI);
+        const bool timed = (s % 4) != 0;  // Mix recorded and legacy strokes
+        for (int i = 0; i < pointsPerStroke; ++i) {
+            angle += rng.bounded(0.6) - 0.3;
+            x += qCos(angle) * 1.5;
+            y += qSin(angle) * 1.5;
+            StrokePoint pt;
+            pt.pos = QPointF(x, y);
+            pt.pressure = 0.2 + rng.bounded(0.8);
+            pt.timestamp = timed ? baseTime + s * 1000 + i * 8 : 0;
+            stroke.points.append(pt);
+        }
+        stroke.updateBoundingBox();
+        page->layer(s % 2)->addStroke(std::move(stroke));
+    }
+    return page;
+}
+
+/**
+ * @brief Compare two pages' strokes within codec quantization tolerance.
+ * @param coordEps Allowed coordinate error (float32 or 1/QUANTIZE_SCALE).
+ */
+inline bool strokesMatch(const Page& a, const Page& b, qreal coordEps)
+{
+    if (a.layerCount() != b.layerCount()) return false;
+    for (int l = 0; l < a.layerCount(); ++l) {
+        const auto& sa = a.layer(l)->strokes();
+        const auto& sb = b.layer(l)->strokes();
+        if (sa.size() != sb.size()) return false;
+        for (int i = 0; i < sa.size(); ++i) {
+            if (sa[i].id != sb[i].id || sa[i].color != sb[i].color ||
+                sa[i].baseThickness != sb[i].baseThickness ||
+                sa[i].points.size() != sb[i].points.size()) {
+                return false;
+            }
+            for (int k = 0; k < sa[i].points.size(); ++k) {
+                const StrokePoint& pa = sa[i].points[k];
+                const StrokePoint& pb = sb[i].points[k];
+                if (qAbs(pa.pos.x() - pb.pos.x()) > coordEps ||
+                    qAbs(pa.pos.y() - pb.pos.y()) > coordEps ||
+                    qAbs(pa.pressure - pb.pressure) > 1.0 / 65535.0 ||
+                    pa.timestamp != pb.timestamp) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Test the binary page container round-trip (both coordinate
+ *        encodings) and legacy JSON fallback decoding.
+ */
+inline bool testBinaryContainerRoundTrip()
+{
+    qDebug() << "=== Test: Binary Page Container Round-Trip ===";
+    
+    bool success = true;
+    auto page = makeSyntheticInkPage(50, 40);
+    page->bookmarkLabel = QStringLiteral("Chapter 1");
+    page->isBookmarked = true;
+    
+    const struct { PageCodec::CoordEncoding encoding; qreal eps; const char* name; } cases[] = {
+        { PageCodec::CoordEncoding::Float32,   1e-3,                        "float32"   },
+        { PageCodec::CoordEncoding::Quantized, 0.5 / PageCodec::QUANTIZE_SCALE + 1e-9, "quantized" },
+    };
+    
+    for (const auto& c : cases) {
+        const QByteArray bytes = PageCodec::encode(page->toJson(false),
+                                                   page->layerStrokeLists(), c.encoding);
+        PageCodec::Container container;
+        QString error;
+        if (!PageCodec::decode(bytes.constData(), bytes.size(), container, true, &error)) {
+            qDebug() << "FAIL:" << c.name << "decode error:" << error;
+            success = false;
+            continue;
+        }
+        auto restored = Page::fromContainer(std::move(container));
+        if (!restored) {
+            qDebug() << "FAIL:" << c.name << "fromContainer returned nullptr";
+            success = false;
+            continue;
+        }
+        if (!strokesMatch(*page, *restored, c.eps)) {
+            qDebug() << "FAIL:" << c.name << "stroke data mismatch";
+            success = false;
+        }
+        if (restored->bookmarkLabel != page->bookmarkLabel || !restored->isBookmarked) {
+            qDebug() << "FAIL:" << c.name << "page metadata mismatch";
+            success = false;
+        }
+        
+        // Truncated input must be rejected, never crash.
+        PageCodec::Container truncated;
+        if (PageCodec::decode(bytes.constData(), bytes.size() / 2, truncated)) {
+            qDebug() << "FAIL:" << c.name << "truncated container was accepted";
+            success = false;
+        }
+    }
+    
+    // Legacy JSON pages decode through the same entry point.
+    const QByteArray json = QJsonDocument(page->toJson()).toJson(QJsonDocument::Compact);
+    PageCodec::Container legacy;
+    if (!PageCodec::decode(json.constData(), json.size(), legacy) || legacy.binary) {
+        qDebug() << "FAIL: legacy JSON page not decoded";
+        success = false;
+    } else {
+        auto restored = Page::fromContainer(std::move(legacy));
+        if (!restored || !strokesMatch(*page, *restored, 1e-6)) {
+            qDebug() << "FAIL: legacy JSON page stroke mismatch";
+            success = false;
+        }
+    }
+    
+    if (success) {
+        qDebug() << "PASS: Binary container round-trip successful!";
+    }
+    return success;
+}
+
+/**
+ * @brief Benchmark JSON vs binary page files on a synthetic notebook.
+ * @param totalPoints Total stroke points across the notebook.
+ * @param pages Number of pages the points are spread over.
+ * @return True if every binary page round-trips.
+ *
+ * Reports save (serialize) and load (parse + Page construction) time and
+ * the on-disk size ratio. Run with --bench-page-codec.
+ */
+inline bool benchmarkPageCodec(int totalPoints = 1000000, int pages = 10)
+{
+    qDebug() << "=== Benchmark: JSON vs binary page files ===";
+    
+    const int pointsPerStroke = 100;
+    const int strokesPerPage = qMax(1, totalPoints / pages / pointsPerStroke);
+    
+    std::vector<std::unique_ptr<Page>> notebook;
+    for (int p = 0; p < pages; ++p) {
+        notebook.push_back(makeSyntheticInkPage(strokesPerPage, pointsPerStroke, 1000 + p));
+    }
+    
+    bool success = true;
+    QElapsedTimer timer;
+    
+    // ----- JSON -----
+    QVector<QByteArray> jsonFiles;
+    timer.start();
+    for (const auto& page : notebook) {
+        jsonFiles.append(QJsonDocument(page->toJson()).toJson(QJsonDocument::Compact));
+    }
+    const qint64 jsonSaveMs = timer.elapsed();
+    
+    timer.restart();
+    for (const QByteArray& bytes : jsonFiles) {
+        PageCodec::Container c;
+        PageCodec::decode(bytes.constData(), bytes.size(), c);
+        auto page = Page::fromContainer(std::move(c));
+        Q_UNUSED(page);
+    }
+    const qint64 jsonLoadMs = timer.elapsed();
+    
+    // ----- Binary (both coordinate encodings) -----
+    const PageCodec::CoordEncoding encodings[] = {
+        PageCodec::CoordEncoding::Float32, PageCodec::CoordEncoding::Quantized
+    };
+    qint64 jsonBytes = 0;
+    for (const QByteArray& bytes : jsonFiles) jsonBytes += bytes.size();
+    
+    qDebug() << "Notebook:" << pages << "pages," << strokesPerPage * pages << "strokes,"
+             << strokesPerPage * pages * pointsPerStroke << "points";
+    qDebug() << "JSON:      save" << jsonSaveMs << "ms, load" << jsonLoadMs << "ms,"
+             << jsonBytes / 1024 << "KiB";
+    
+    for (PageCodec::CoordEncoding encoding : encodings) {
+        QVector<QByteArray> binFiles;
+        timer.restart();
+        for (const auto& page : notebook) {
+            binFiles.append(PageCodec::encode(page->toJson(false), page->layerStrokeLists(), encoding));
+        }
+        const qint64 saveMs = timer.elapsed();
+        
+        std::vector<std::unique_ptr<Page>> loaded;
+        timer.restart();
+        for (const QByteArray& bytes : binFiles) {
+            PageCodec::Container c;
+            PageCodec::decode(bytes.constData(), bytes.size(), c);
+            loaded.push_back(Page::fromContainer(std::move(c)));
+        }
+        const qint64 loadMs = timer.elapsed();
+        
+        qint64 binBytes = 0;
+        for (const QByteArray& bytes : binFiles) binBytes += bytes.size();
+        
+        const qreal eps = (encoding == PageCodec::CoordEncoding::Float32)
+                              ? 1e-3 : 0.5 / PageCodec::QUANTIZE_SCALE + 1e-9;
+        for (size_t i = 0; i < notebook.size(); ++i) {
+            if (!loaded[i] || !strokesMatch(*notebook[i], *loaded[i], eps)) {
+                qDebug() << "FAIL: binary page" << i << "did not round-trip";
+                success = false;
+            }
+        }
+        
+        qDebug().noquote() << (encoding == PageCodec::CoordEncoding::Float32 ? "float32:  " : "quantized:")
+                           << "save" << saveMs << "ms, load" << loadMs << "ms,"
+                           << binBytes / 1024 << "KiB"
+                           << QString("(size %1x smaller, load %2x faster)")
+                                  .arg(qreal(jsonBytes) / qMax<qint64>(1, binBytes), 0, 'f', 1)
+                                  .arg(qreal(jsonLoadMs) / qMax<qint64>(1, loadMs), 0, 'f', 1);
+    }
+    
+    return success;
+}
+
+/**
+ * @brief Build a layer of short random strokes scattered over @p area.
+ */
+inline void fillLayerWithRandomStrokes(VectorLayer& layer, int strokeCount,
+                                       const QSizeF& area, quint32 seed = 7)
+{
+    QRandomGenerator rng(seed);
+    for (int s = 0; s < strokeCount; ++s) {
+        VectorStroke stroke;
+        stroke.id = Id128::create();
+        stroke.baseThickness = 2.0;
+        qreal x = rng.bounded(area.width());
+        qreal y = rng.bounded(area.height());
+        for (int i = 0; i < 12; ++i) {
+            stroke.points.append({QPointF(x, y), 0.5});
+            x += rng.bounded(6.0) - 3.0;
+            y += rng.bounded(6.0) - 3.0;
+        }
+        stroke.updateBoundingBox();
+        layer.addStroke(std::move(stroke));
+    }
+}
+
+/**
+ * @brief Brute-force reference for VectorLayer::strokesAtPoint.
+ */
+inline QVector<Id128> strokesAtPointLinear(const VectorLayer& layer,
+                                            const QPointF& pt, qreal tolerance)
+{
+    QVector<Id128> result;
+    for (const VectorStroke& stroke : layer.strokes()) {
+        if (stroke.containsPoint(pt, tolerance)) {
+            result.append(stroke.id);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Test that the VectorLayer spatial index stays in sync with the
+ *        stroke list across add/remove/batch-remove/bulk-replace.
+ */
+inline bool testSpatialIndexConsistency()
+{
+    qDebug() << "=== Test: VectorLayer Spatial Index ===";
+    
+    bool success = true;
+    const QSizeF area(816, 1056);
+    VectorLayer layer;
+    fillLayerWithRandomStrokes(layer, 2000, area);
+    
+    // One long stroke spanning the whole page exercises the oversized list.
+    VectorStroke ruler;
+    ruler.points.append({QPointF(0, 500), 0.5});
+    ruler.points.append({QPointF(816, 520), 0.5});
+    ruler.updateBoundingBox();
+    layer.addStroke(ruler);
+    
+    QRandomGenerator rng(99);
+    auto checkProbes = [&](const char* stage) {
+        for (int i = 0; i < 200; ++i) {
+            const QPointF pt(rng.bounded(area.width()), rng.bounded(area.height()));
+            const qreal tol = rng.bounded(20.0);
+            if (layer.strokesAtPoint(pt, tol) != strokesAtPointLinear(layer, pt, tol)) {
+                qDebug() << "FAIL:" << stage << "hit test differs from linear scan at" << pt;
+                success = false;
+                return;
+            }
+        }
+        for (int i = 0; i < layer.strokeCount(); i += 97) {
+            const Id128& id = std::as_const(layer).strokes()[i].id;
+            if (layer.indexOfStroke(id) != i) {
+                qDebug() << "FAIL:" << stage << "indexOfStroke mismatch at" << i;
+                success = false;
+                return;
+            }
+        }
+    };
+    
+    checkProbes("after add");
+    
+    // Single removals from the middle shift every later index.
+    for (int i = 0; i < 50; ++i) {
+        const int victim = static_cast<int>(rng.bounded(layer.strokeCount()));
+        layer.removeStroke(std::as_const(layer).strokes()[victim].id);
+    }
+    checkProbes("after removeStroke");
+    
+    // Batch removal (eraser path) returns the removed strokes in z-order.
+    QVector<Id128> batch;
+    for (int i = 0; i < layer.strokeCount(); i += 5) {
+        batch.append(std::as_const(layer).strokes()[i].id);
+    }
+    const int before = layer.strokeCount();
+    const QVector<VectorStroke> removed = layer.removeStrokes(batch);
+    if (removed.size() != batch.size() || layer.strokeCount() != before - batch.size()) {
+        qDebug() << "FAIL: removeStrokes removed" << removed.size() << "of" << batch.size();
+        success = false;
+    } else if (removed.first().id != batch.first() || removed.last().id != batch.last()) {
+        qDebug() << "FAIL: removeStrokes did not preserve layer order";
+        success = false;
+    }
+    checkProbes("after removeStrokes");
+    
+    // Strokes sharing an ID (e.g. pasted twice): erasing the newer one must
+    // leave the older one findable.
+    const VectorStroke twin = std::as_const(layer).strokes()[10];
+    layer.addStroke(twin);
+    layer.removeStroke(twin.id);
+    if (layer.indexOfStroke(twin.id) != 10) {
+        qDebug() << "FAIL: removing a duplicate ID lost the surviving stroke";
+        success = false;
+    }
+    checkProbes("after duplicate ID removal");
+    
+    // Mutable access invalidates; the next query rebuilds from scratch.
+    for (VectorStroke& stroke : layer.strokes()) {
+        stroke.points.translate(QPointF(15, -10));
+        stroke.updateBoundingBox();
+    }
+    checkProbes("after in-place edit");
+    
+    // Lasso broad phase must return every stroke whose bbox meets the rect.
+    const QRectF lassoRect(100, 100, 300, 200);
+    QVector<int> expected;
+    for (int i = 0; i < layer.strokeCount(); ++i) {
+        if (std::as_const(layer).strokes()[i].boundingBox.intersects(lassoRect)) expected.append(i);
+    }
+    if (layer.strokeIndicesIntersecting(lassoRect) != expected) {
+        qDebug() << "FAIL: strokeIndicesIntersecting differs from linear scan";
+        success = false;
+    }
+    
+    if (success) {
+        qDebug() << "PASS: Spatial index consistent with stroke list!";
+    }
+    return success;
+}
+
+/**
+ * @brief Microbenchmark eraser/lasso hit testing with and without the
+ *        spatial index at 1k / 10k / 100k strokes. Run with --bench-stroke-index.
+ */
+inline bool benchmarkStrokeSpatialIndex()
+{
+    qDebug() << "=== Benchmark: VectorLayer hit testing ===";
+    
+    bool success = true;
+    const int probes = 2000;
+    const qreal tolerance = 10.0;
+    
+    for (int strokeCount : {1000, 10000, 100000}) {
+        // Keep density roughly constant: bigger layers cover a bigger area
+        // (as an edgeless tile set or a long lecture page would).
+        const qreal side = 816.0 * qSqrt(strokeCount / 1000.0);
+        const QSizeF area(side, side);
+        VectorLayer layer;
+        fillLayerWithRandomStrokes(layer, strokeCount, area);
+        
+        QRandomGenerator rng(1234);
+        QVector<QPointF> points;
+        points.reserve(probes);
+        for (int i = 0; i < probes; ++i) {
+            points.append(QPointF(rng.bounded(area.width()), rng.bounded(area.height())));
+        }
+        
+        QElapsedTimer timer;
+        timer.start();
+        layer.strokeIndicesIntersecting(QRectF());  // Build the index outside the timed loop
+        const qint64 buildNs = timer.nsecsElapsed();
+        
+        int indexedHits = 0;
+        timer.restart();
+        for (const QPointF& pt : points) {
+            indexedHits += layer.strokesAtPoint(pt, tolerance).size();
+        }
+        const qint64 indexedNs = timer.nsecsElapsed();
+        
+        int linearHits = 0;
+        timer.restart();
+        for (const QPointF& pt : points) {
+            linearHits += strokesAtPointLinear(layer, pt, tolerance).size();
+        }
+        const qint64 linearNs = timer.nsecsElapsed();
+        
+        // Erase loop: hit test + batch remove, as DocumentViewport::eraseAt does.
+        timer.restart();
+        int erased = 0;
+        for (int i = 0; i < 200; ++i) {
+            erased += layer.removeStrokes(layer.strokesAtPoint(points[i], tolerance)).size();
+        }
+        const qint64 eraseNs = timer.nsecsElapsed();
+        
+        if (indexedHits != linearHits) {
+            qDebug() << "FAIL: indexed and linear hit counts differ" << indexedHits << linearHits;
+            success = false;
+        }
+        
+        qDebug().noquote()
+            << QString("%1 strokes: build %2 ms | hit test %3 us/probe (linear %4 us, %5x) | "
+                       "erase %6 us/step (%7 strokes)")
+                   .arg(strokeCount, 6)
+                   .arg(buildNs / 1e6, 0, 'f', 2)
+                   .arg(indexedNs / 1e3 / probes, 0, 'f', 2)
+                   .arg(linearNs / 1e3 / probes, 0, 'f', 2)
+                   .arg(qreal(linearNs) / qMax<qint64>(1, indexedNs), 0, 'f', 1)
+                   .arg(eraseNs / 1e3 / 200, 0, 'f', 1)
+                   .arg(erased);
+    }
+    
+    return success;
+}
+
+/**
+ * @brief Test Id128 text round trip for generated, parsed, interned and
+ *        null ids, and that a page container keeps stroke ids intact.
+ */
+inline bool testId128RoundTrip()
+{
+    qDebug() << "=== Test: Id128 Round Trip ===";
+    
+    bool success = true;
+    
+    const Id128 created = Id128::create();
+    const QString createdText = created.toString();
+    if (created.isNull() || created.isInterned()
+        || createdText != QUuid(createdText).toString(QUuid::WithoutBraces)
+        || Id128::fromString(createdText) != created) {
+        qDebug() << "FAIL: generated id does not round-trip as a canonical UUID" << createdText;
+        success = false;
+    }
+    
+    const QString canonical = QStringLiteral("3f2504e0-4f89-41d3-9a0c-0305e82c3301");
+    const Id128 parsed = Id128::fromString(canonical);
+    const QByteArray utf8 = canonical.toUtf8();
+    if (parsed.isInterned() || parsed.toString() != canonical
+        || Id128::fromUtf8(utf8.constData(), utf8.size()) != parsed) {
+        qDebug() << "FAIL: canonical UUID text is not packed losslessly";
+        success = false;
+    }
+    
+    // Non-canonical ids (test fixtures, upper case, foreign files) must come
+    // back exactly as written and compare equal to a second parse.
+    for (const QString& text : {QStringLiteral("stroke-1"),
+                                QStringLiteral("3F2504E0-4F89-41D3-9A0C-0305E82C3301"),
+                                QStringLiteral("00000000-0000-0000-0000-000000000000")}) {
+        const Id128 id = Id128::fromString(text);
+        if (!id.isInterned() || id.toString() != text || Id128::fromString(text) != id) {
+            qDebug() << "FAIL: interned id does not round-trip" << text;
+            success = false;
+        }
+    }
+    
+    if (!Id128::fromString(QString()).isNull() || !Id128::fromString(QString()).toString().isEmpty()) {
+        qDebug() << "FAIL: empty text should give a null id";
+        success = false;
+    }
+    
+    // Ordering of packed ids follows the canonical text.
+    const Id128 a = Id128::fromString(QStringLiteral("10000000-0000-4000-8000-000000000000"));
+    const Id128 b = Id128::fromString(QStringLiteral("10000000-0000-4000-8000-000000000001"));
+    if (!(a < b) || b < a) {
+        qDebug() << "FAIL: packed id ordering does not match text ordering";
+        success = false;
+    }
+    
+    if (success) {
+        qDebug() << "PASS: Id128 round trip";
+    }
+    return success;
+}
+
+/**
+ * @brief Bytes currently allocated on the heap, or -1 where the C library
+ *        does not report it.
+ */
+inline qint64 heapBytesInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return qint64(mallinfo2().uordblks);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Report the memory cost of stroke ids as QString vs Id128 for a
+ *        100k-stroke notebook: the id field itself plus the per-layer
+ *        id -> index hash. Run with --bench-stroke-ids.
+ *
+ * Heap figures are measured with mallinfo2() where glibc provides it;
+ * elsewhere only the inline sizes are printed.
+ */
+inline bool benchmarkStrokeIdMemory(int strokeCount = 100000)
+{
+    qDebug() << "=== Benchmark: stroke id memory (QString vs Id128) ===";
+    
+    QVector<Id128> ids;
+    ids.reserve(strokeCount);
+    for (int i = 0; i < strokeCount; ++i) {
+        ids.append(Id128::create());
+    }
+    
+    // Old representation: one heap string per stroke.
+    QVector<QString> texts;
+    texts.reserve(strokeCount);
+    qint64 before = heapBytesInUse();
+    for (const Id128& id : std::as_const(ids)) {
+        texts.append(id.toString());
+    }
+    const qint64 stringHeap = heapBytesInUse() - before;
+    
+    before = heapBytesInUse();
+    QHash<QString, int> textIndex;
+    textIndex.reserve(strokeCount);
+    for (int i = 0; i < strokeCount; ++i) {
+        textIndex.insert(texts[i], i);
+    }
+    const qint64 textHashHeap = heapBytesInUse() - before;
+    
+    before = heapBytesInUse();
+    QHash<Id128, int> idIndex;
+    idIndex.reserve(strokeCount);
+    for (int i = 0; i < strokeCount; ++i) {
+        idIndex.insert(ids[i], i);
+    }
+    const qint64 idHashHeap = heapBytesInUse() - before;
+    
+    // Lookup cost, as in eraser/undo paths (removeStrokes, indexOfStroke).
+    QElapsedTimer timer;
+    timer.start();
+    qint64 textSum = 0;
+    for (const QString& t : std::as_const(texts)) {
+        textSum += textIndex.value(t, -1);
+    }
+    const qint64 textLookupNs = timer.nsecsElapsed();
+    timer.restart();
+    qint64 idSum = 0;
+    for (const Id128& id : std::as_const(ids)) {
+        idSum += idIndex.value(id, -1);
+    }
+    const qint64 idLookupNs = timer.nsecsElapsed();
+    
+    const bool measured = before >= 0;
+    const qreal n = strokeCount;
+    const qreal oldPerStroke = sizeof(QString) + (measured ? stringHeap / n : 0);
+    const qreal newPerStroke = sizeof(Id128);
+    
+    qDebug().noquote() << QString("%1 strokes, heap measurement %2")
+                              .arg(strokeCount).arg(measured ? "mallinfo2" : "unavailable");
+    qDebug().noquote() << QString("id field:   QString %1 B/stroke (%2 inline + %3 heap) | Id128 %4 B/stroke")
+                              .arg(oldPerStroke, 0, 'f', 1)
+                              .arg(sizeof(QString))
+                              .arg(measured ? stringHeap / n : 0.0, 0, 'f', 1)
+                              .arg(newPerStroke, 0, 'f', 1);
+    if (measured) {
+        qDebug().noquote() << QString("id index:   QHash<QString,int> %1 B/stroke | QHash<Id128,int> %2 B/stroke")
+                                  .arg(textHashHeap / n, 0, 'f', 1)
+                                  .arg(idHashHeap / n, 0, 'f', 1);
+        const qreal oldTotal = oldPerStroke + textHashHeap / n;
+        const qreal newTotal = newPerStroke + idHashHeap / n;
+        qDebug().noquote() << QString("total:      %1 -> %2 B/stroke, %3 MB saved per %4 strokes")
+                                  .arg(oldTotal, 0, 'f', 1)
+                                  .arg(newTotal, 0, 'f', 1)
+                                  .arg((oldTotal - newTotal) * n / (1024.0 * 1024.0), 0, 'f', 2)
+                                  .arg(strokeCount);
+    }
+    qDebug().noquote() << QString("lookup:     QString %1 ns | Id128 %2 ns")
+                              .arg(textLookupNs / n, 0, 'f', 1)
+                              .arg(idLookupNs / n, 0, 'f', 1);
+    
+    if (textSum != idSum) {
+        qDebug() << "FAIL: QString and Id128 indices disagree";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Test StrokePointList: values survive the float/uint16 columns,
+ *        timestamps round-trip exactly (including the wide fallback), and
+ *        copies share storage until written.
+ */
+inline bool testStrokePointList()
+{
+    qDebug() << "=== Test: StrokePointList ===";
+    
+    bool success = true;
+    const qint64 baseTime = 1700000000000LL;
+    
+    StrokePointList points;
+    for (int i = 0; i < 100; ++i) {
+        StrokePoint pt;
+        pt.pos = QPointF(10.25 + i * 3.5, 800.0 - i * 1.75);
+        pt.pressure = (i % 11) / 10.0;
+        pt.timestamp = (i % 10 == 3) ? 0 : baseTime + i * 8;  // Some unrecorded
+        points.append(pt);
+    }
+    for (int i = 0; i < points.size(); ++i) {
+        const StrokePoint pt = points.at(i);
+        if (qAbs(pt.pos.x() - (10.25 + i * 3.5)) > 1e-3 || qAbs(pt.pos.y() - (800.0 - i * 1.75)) > 1e-3
+            || qAbs(pt.pressure - (i % 11) / 10.0) > 1.0 / 65535.0
+            || pt.timestamp != ((i % 10 == 3) ? 0 : baseTime + i * 8)) {
+            qDebug() << "FAIL: point" << i << "does not round-trip";
+            success = false;
+            break;
+        }
+    }
+    
+    // Copies share the column buffer until one side writes.
+    StrokePointList copy = points;
+    copy.translate(QPointF(5, 5));
+    if (qAbs(points.position(0).x() - 10.25) > 1e-3 || qAbs(copy.position(0).x() - 15.25) > 1e-3) {
+        qDebug() << "FAIL: writing a copy changed the original";
+        success = false;
+    }
+    
+    // A timestamp too far from the first one switches to exact 64-bit storage.
+    const qint64 farTime = baseTime + 40LL * 24 * 3600 * 1000;
+    points.append(QPointF(1, 1), 0.5, farTime);
+    if (points.timestamp(points.size() - 1) != farTime || points.timestamp(0) != baseTime
+        || points.timestamp(3) != 0) {
+        qDebug() << "FAIL: wide timestamps do not round-trip";
+        success = false;
+    }
+    
+    StrokePointList untimed;
+    untimed.append(QPointF(0, 0), 1.0);
+    if (untimed.hasTimestamps() || untimed.timestamp(0) != 0) {
+        qDebug() << "FAIL: untimed list should not report timestamps";
+        success = false;
+    }
+    
+    if (success) {
+        qDebug() << "PASS: StrokePointList";
+    }
+    return success;
+}
+
+/**
+ * @brief Report bytes per point for QVector<StrokePoint> vs StrokePointList
+ *        and time the column-based hot paths. Run with --bench-stroke-points.
+ */
+inline bool benchmarkStrokePointMemory(int strokeCount = 100000)
+{
+    qDebug() << "=== Benchmark: stroke point storage ===";
+    
+    VectorLayer layer;
+    const QSizeF area(8160, 8160);
+    fillLayerWithRandomStrokes(layer, strokeCount, area);
+    
+    // fillLayerWithRandomStrokes does not record timestamps; stamp every
+    // point as live pen input would.
+    qint64 time = 1700000000000LL;
+    for (VectorStroke& stroke : layer.strokes()) {
+        for (int i = 0; i < stroke.points.size(); ++i) {
+            stroke.points.setTimestamp(i, time += 8);
+        }
+        stroke.points.squeeze();
+    }
+    
+    qint64 points = 0;
+    qint64 columnBytes = 0;
+    for (const VectorStroke& stroke : std::as_const(layer).strokes()) {
+        points += stroke.points.size();
+        columnBytes += stroke.points.byteSize();
+    }
+    const qreal aosPerPoint = sizeof(StrokePoint);
+    const qreal soaPerPoint = qreal(columnBytes) / qMax<qint64>(1, points);
+    
+    QElapsedTimer timer;
+    timer.start();
+    for (VectorStroke& stroke : layer.strokes()) {
+        stroke.updateBoundingBox();
+    }
+    const qint64 bboxNs = timer.nsecsElapsed();
+    
+    QRandomGenerator rng(99);
+    int hits = 0;
+    timer.restart();
+    for (int probe = 0; probe < 200; ++probe) {
+        const QPointF pt(rng.bounded(area.width()), rng.bounded(area.height()));
+        for (const VectorStroke& stroke : std::as_const(layer).strokes()) {
+            hits += stroke.containsPoint(pt, 10.0) ? 1 : 0;
+        }
+    }
+    const qint64 hitNs = timer.nsecsElapsed();
+    
+    qint64 polygonPoints = 0;
+    timer.restart();
+    for (const VectorStroke& stroke : std::as_const(layer).strokes()) {
+        polygonPoints += VectorLayer::buildStrokePolygon(stroke).polygon.size();
+    }
+    const qint64 polygonNs = timer.nsecsElapsed();
+    
+    qDebug().noquote() << QString("%1 strokes, %2 points (timestamps recorded)")
+                              .arg(strokeCount).arg(points);
+    qDebug().noquote() << QString("memory:  QVector<StrokePoint> %1 B/point | StrokePointList %2 B/point (%3%)")
+                              .arg(aosPerPoint, 0, 'f', 1)
+                              .arg(soaPerPoint, 0, 'f', 1)
+                              .arg(100.0 * soaPerPoint / aosPerPoint, 0, 'f', 0);
+    qDebug().noquote() << QString("bbox %1 ns/point | hit test %2 ns/point | polygon %3 ns/point")
+                              .arg(qreal(bboxNs) / points, 0, 'f', 2)
+                              .arg(qreal(hitNs) / (200.0 * points), 0, 'f', 2)
+                              .arg(qreal(polygonNs) / points, 0, 'f', 2);
+    
+    if (polygonPoints == 0 || soaPerPoint >= aosPerPoint / 2) {
+        qDebug() << "FAIL: column storage is not below half the AoS size";
+        return false;
+    }
+    Q_UNUSED(hits);
+    return true;
+}
+
+/**
+ * @brief Test StrokeOutlineCache hits, invalidation on geometry changes and
+ *        LRU eviction under a memory budget.
+ */
+inline bool testStrokeOutlineCache()
+{
+    qDebug() << "=== Test: StrokeOutlineCache ===";
+    
+    bool success = true;
+    StrokeOutlineCache& cache = StrokeOutlineCache::instance();
+    const qint64 savedBudget = cache.budget();
+    cache.clear();
+    
+    VectorStroke stroke;
+    stroke.baseThickness = 4.0;
+    for (int i = 0; i < 50; ++i) {
+        stroke.points.append(QPointF(100 + i * 2.0, 100 + qSin(i * 0.3) * 20.0), 0.6);
+    }
+    stroke.updateBoundingBox();
+    
+    const auto first = VectorLayer::cachedStrokePolygon(stroke);
+    const auto second = VectorLayer::cachedStrokePolygon(stroke);
+    if (first != second) {
+        qDebug() << "FAIL: second lookup rebuilt the outline";
+        success = false;
+    }
+    
+    // Recolored copies (undo snapshots, export snapshots) share the outline.
+    VectorStroke recolored = stroke;
+    recolored.color = Qt::red;
+    if (VectorLayer::cachedStrokePolygon(recolored) != first) {
+        qDebug() << "FAIL: recolored copy did not reuse the outline";
+        success = false;
+    }
+    
+    // Moving the points must produce a fresh, moved outline.
+    VectorStroke moved = stroke;
+    moved.points.translate(QPointF(10, 0));
+    const auto movedOutline = VectorLayer::cachedStrokePolygon(moved);
+    if (movedOutline == first
+        || qAbs(movedOutline->startCapCenter.x() - (first->startCapCenter.x() + 10.0)) > 1e-3) {
+        qDebug() << "FAIL: translated stroke reused a stale outline";
+        success = false;
+    }
+    
+    // Thickness is part of the key.
+    VectorStroke thicker = stroke;
+    thicker.baseThickness = 8.0;
+    if (VectorLayer::cachedStrokePolygon(thicker) == first) {
+        qDebug() << "FAIL: thickness change reused the outline";
+        success = false;
+    }
+    
+    // A tight budget keeps memory bounded by evicting the oldest outlines.
+    cache.setBudget(first->polygon.size() * qint64(sizeof(QPointF)) * 3);
+    for (int i = 0; i < 20; ++i) {
+        VectorStroke copy = stroke;
+        copy.points.translate(QPointF(i, i));
+        VectorLayer::cachedStrokePolygon(copy);
+    }
+    const StrokeOutlineCache::Stats stats = cache.stats();
+    if (stats.bytes > cache.budget() && stats.entries > 1) {
+        qDebug() << "FAIL: cache exceeds its budget:" << stats.bytes << ">" << cache.budget();
+        success = false;
+    }
+    if (stats.evictions == 0) {
+        qDebug() << "FAIL: expected LRU evictions under a small budget";
+        success = false;
+    }
+    
+    cache.setBudget(savedBudget);
+    cache.clear();
+    
+    if (success) {
+        qDebug() << "PASS: StrokeOutlineCache";
+    }
+    return success;
+}
+
 /**
  * @brief Test layer management operations.
  */
@@ -220,9 +1066,9 @@ inline bool testLayerManagement()
     page->addLayer("New Layer 3");
     
     // Add content to identify layers
-    VectorStroke s1; s1.id = "L1"; s1.updateBoundingBox();
-    VectorStroke s2; s2.id = "L2"; s2.updateBoundingBox();
-    VectorStroke s3; s3.id = "L3"; s3.updateBoundingBox();
+    VectorStroke s1; s1.id = Id128::fromString(QStringLiteral("L1")); s1.updateBoundingBox();
+    VectorStroke s2; s2.id = Id128::fromString(QStringLiteral("L2")); s2.updateBoundingBox();
+    VectorStroke s3; s3.id = Id128::fromString(QStringLiteral("L3")); s3.updateBoundingBox();
     page->layer(0)->addStroke(s1);
     page->layer(1)->addStroke(s2);
     page->layer(2)->addStroke(s3);
@@ -231,11 +1077,11 @@ inline bool testLayerManagement()
     page->moveLayer(0, 2);
     
     // Verify order changed
-    if (page->layer(0)->strokes()[0].id != "L2") {
+    if (page->layer(0)->strokes()[0].id.toString() != "L2") {
         qDebug() << "FAIL: After move, layer 0 should have L2 stroke";
         success = false;
     }
-    if (page->layer(2)->strokes()[0].id != "L1") {
+    if (page->layer(2)->strokes()[0].id.toString() != "L1") {
         qDebug() << "FAIL: After move, layer 2 should have L1 stroke";
         success = false;
     }
@@ -418,6 +1264,21 @@ inline bool runAllTests()
     allPass &= testObjectManagement();
     qDebug() << "";
     
+    allPass &= testBinaryContainerRoundTrip();
+    qDebug() << "";
+    
+    allPass &= testSpatialIndexConsistency();
+    qDebug() << "";
+    
+    allPass &= testId128RoundTrip();
+    qDebug() << "";
+    
+    allPass &= testStrokePointList();
+    qDebug() << "";
+    
+    allPass &= testStrokeOutlineCache();
+    qDebug() << "";
+    
     // Optional: Render to PNG
     renderTestPageToPng("test_page_render.png");
     
@@ -0,0 +1,184 @@
+// ============================================================================
+// PdfTileCache - Implementation
+// ============================================================================
+
+#include "PdfTileCache.h"
+
+#include <QMutexLocker>
+#include <QtMath>
+
+#include <cmath>
+#include <limits>
+
+PdfTileCache::PdfTileCache(qint64 budgetBytes)
+    : m_budgetBytes(budgetBytes)
+{
+}
+
+// ============================================================================
+// Levels and geometry
+// ============================================================================
+
+int PdfTileCache::levelForDpi(qreal dpi)
+{
+    if (dpi <= 0) {
+        return 0;
+    }
+    // Snap up: the smallest level whose DPI is >= the target, so a level
+    // is only ever downscaled on screen. The epsilon keeps exact level DPIs
+    // (96, 192, ...) from rounding up a whole step.
+    const qreal steps = std::log2(qMin(dpi, MAX_DPI) / BASE_DPI) * LEVELS_PER_OCTAVE;
+    return qCeil(steps - 1e-6);
+}
+
+qreal PdfTileCache::dpiForLevel(int level)
+{
+    const qreal dpi = BASE_DPI * std::pow(2.0, qreal(level) / LEVELS_PER_OCTAVE);
+    return qMin(dpi, MAX_DPI);
+}
+
+QSize PdfTileCache::pagePixelSize(const QSizeF& pagePts, qreal dpi)
+{
+    // fz_round_rect() ceils the far edge with a 0.001 tolerance.
+    const qreal scale = dpi / 72.0;
+    return QSize(qMax(1, qCeil(pagePts.width() * scale - 0.001)),
+                 qMax(1, qCeil(pagePts.height() * scale - 0.001)));
+}
+
+QRect PdfTileCache::tilePixelRect(const QSize& pagePx, int tx, int ty)
+{
+    return QRect(tx * TILE_SIZE, ty * TILE_SIZE, TILE_SIZE, TILE_SIZE)
+        .intersected(QRect(QPoint(0, 0), pagePx));
+}
+
+QVector<QPoint> PdfTileCache::tilesCovering(const QSize& pagePx, const QRect& pixelRect)
+{
+    QVector<QPoint> tiles;
+    const QRect clipped = pixelRect.intersected(QRect(QPoint(0, 0), pagePx));
+    if (clipped.isEmpty()) {
+        return tiles;
+    }
+    const int tx0 = clipped.left() / TILE_SIZE;
+    const int ty0 = clipped.top() / TILE_SIZE;
+    const int tx1 = clipped.right() / TILE_SIZE;
+    const int ty1 = clipped.bottom() / TILE_SIZE;
+    tiles.reserve((tx1 - tx0 + 1) * (ty1 - ty0 + 1));
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            tiles.append(QPoint(tx, ty));
+        }
+    }
+    return tiles;
+}
+
+// ============================================================================
+// Cache access
+// ============================================================================
+
+QPixmap PdfTileCache::find(const PdfTileKey& key)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return QPixmap();
+    }
+    it->lastUsed = ++m_useCounter;
+    return it->pixmap;
+}
+
+bool PdfTileCache::contains(const PdfTileKey& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.contains(key);
+}
+
+void PdfTileCache::insert(const PdfTileKey& key, const QPixmap& pixmap)
+{
+    if (pixmap.isNull()) {
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    Entry& entry = m_entries[key];
+    m_bytesUsed -= entry.bytes;  // 0 for a fresh entry
+    entry.pixmap = pixmap;
+    entry.bytes = pixmapBytes(pixmap);
+    entry.lastUsed = ++m_useCounter;
+    m_bytesUsed += entry.bytes;
+    evictToBudget(&key);
+}
+
+void PdfTileCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_bytesUsed = 0;
+}
+
+void PdfTileCache::removePage(const QString& sourceId, int pageIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it.key().pageIndex == pageIndex && it.key().sourceId == sourceId) {
+            m_bytesUsed -= it->bytes;
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// ============================================================================
+// Budget
+// ============================================================================
+
+void PdfTileCache::setBudgetBytes(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budgetBytes = bytes;
+    evictToBudget(nullptr);
+}
+
+qint64 PdfTileCache::budgetBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budgetBytes;
+}
+
+qint64 PdfTileCache::bytesUsed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytesUsed;
+}
+
+int PdfTileCache::tileCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_entries.size());
+}
+
+void PdfTileCache::evictToBudget(const PdfTileKey* keep)
+{
+    // Linear LRU scan: the cache holds at most a few hundred tiles, so this
+    // is cheaper than maintaining a separate recency list on every lookup.
+    while (m_bytesUsed > m_budgetBytes && !m_entries.isEmpty()) {
+        auto victim = m_entries.end();
+        quint64 oldest = std::numeric_limits<quint64>::max();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (keep && it.key() == *keep) continue;
+            if (it->lastUsed < oldest) {
+                oldest = it->lastUsed;
+                victim = it;
+            }
+        }
+        if (victim == m_entries.end()) {
+            break;  // Only the protected tile is left
+        }
+        m_bytesUsed -= victim->bytes;
+        m_entries.erase(victim);
+    }
+}
+
+qint64 PdfTileCache::pixmapBytes(const QPixmap& pixmap)
+{
+    return qint64(pixmap.width()) * pixmap.height() * qMax(1, pixmap.depth() / 8);
+}
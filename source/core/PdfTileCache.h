@@ -0,0 +1,173 @@
+#ifndef PDFTILECACHE_H
+#define PDFTILECACHE_H
+
+// ============================================================================
+// PdfTileCache - Tiled, multi-resolution PDF background raster cache
+// ============================================================================
+// Replaces the viewport's flat list of whole-page pixmaps. A PDF page is
+// rasterized as fixed-size tiles at a small set of resolution levels (DPI
+// snapped up to quarter-octave buckets), so:
+// - only the visible part of a page is rendered at the target DPI;
+// - a zoom change does not throw away the previous level - its tiles stay
+//   around as a lower/higher resolution stand-in until the new level has
+//   been rendered (progressive refinement);
+// - memory is bounded by a byte budget with LRU eviction instead of an
+//   entry count, which was meaningless when one "entry" of an A3 scan at
+//   300 DPI was 70 MB.
+//
+// The cache only stores pixmaps; rendering and scheduling live in
+// DocumentViewport. All methods are thread-safe.
+// ============================================================================
+
+#include <QHash>
+#include <QMutex>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Identifies one tile of one PDF page at one resolution level.
+ */
+struct PdfTileKey {
+    QString sourceId;       ///< PDF source id (empty = primary source)
+    int pageIndex = -1;     ///< Original PDF page number
+    int level = 0;          ///< Resolution level (see PdfTileCache::dpiForLevel)
+    int tx = 0;             ///< Tile column
+    int ty = 0;             ///< Tile row
+
+    bool operator==(const PdfTileKey& other) const {
+        return pageIndex == other.pageIndex && level == other.level &&
+               tx == other.tx && ty == other.ty && sourceId == other.sourceId;
+    }
+    bool operator!=(const PdfTileKey& other) const { return !(*this == other); }
+};
+
+inline size_t qHash(const PdfTileKey& key, size_t seed = 0) noexcept
+{
+    size_t h = qHash(key.sourceId, seed);
+    h = h * 31u + static_cast<uint>(key.pageIndex);
+    h = h * 31u + static_cast<uint>(key.level);
+    h = h * 31u + static_cast<uint>(key.tx);
+    h = h * 31u + static_cast<uint>(key.ty);
+    return h;
+}
+
+/**
+ * @brief Byte-budgeted LRU cache of PDF page tiles.
+ */
+class PdfTileCache {
+public:
+    /// Tile edge length in device pixels.
+    static constexpr int TILE_SIZE = 512;
+
+    /// DPI of level 0 (100% zoom on a 1x screen).
+    static constexpr qreal BASE_DPI = 96.0;
+
+    /// Resolution levels per doubling of DPI. 4 keeps the oversampling of a
+    /// snapped-up level under ~19%.
+    static constexpr int LEVELS_PER_OCTAVE = 4;
+
+    /// Highest render DPI (matches the cap in DocumentViewport::effectivePdfDpi).
+    static constexpr qreal MAX_DPI = 300.0;
+
+    /// How many levels away from the target a stand-in tile may come from.
+    static constexpr int MAX_FALLBACK_LEVEL_DISTANCE = 8;
+
+    explicit PdfTileCache(qint64 budgetBytes = 192LL * 1024 * 1024);
+
+    // ===== Levels and geometry =====
+
+    /**
+     * @brief Resolution level for a target DPI (snapped up, never blurrier).
+     */
+    static int levelForDpi(qreal dpi);
+
+    /**
+     * @brief Render DPI of a resolution level (capped at MAX_DPI).
+     */
+    static qreal dpiForLevel(int level);
+
+    /**
+     * @brief Full-page raster size at @p dpi for a page of @p pagePts points.
+     *
+     * Mirrors MuPDF's bbox rounding so tile edges line up with what the
+     * provider renders.
+     */
+    static QSize pagePixelSize(const QSizeF& pagePts, qreal dpi);
+
+    /**
+     * @brief Pixel rect of tile (@p tx, @p ty), clipped to the page.
+     */
+    static QRect tilePixelRect(const QSize& pagePx, int tx, int ty);
+
+    /**
+     * @brief Tiles (column, row) of a page raster that intersect @p pixelRect.
+     */
+    static QVector<QPoint> tilesCovering(const QSize& pagePx, const QRect& pixelRect);
+
+    // ===== Cache access =====
+
+    /**
+     * @brief Look up a tile and mark it most recently used.
+     * @return The tile pixmap, or a null pixmap on a miss.
+     */
+    QPixmap find(const PdfTileKey& key);
+
+    /**
+     * @brief Check for a tile without touching its LRU position.
+     */
+    bool contains(const PdfTileKey& key) const;
+
+    /**
+     * @brief Insert (or replace) a tile, then evict least recently used
+     *        tiles until the cache fits its budget again.
+     *
+     * The inserted tile itself is never evicted by its own insertion, so a
+     * single tile larger than the budget still displays.
+     */
+    void insert(const PdfTileKey& key, const QPixmap& pixmap);
+
+    /**
+     * @brief Remove every tile.
+     */
+    void clear();
+
+    /**
+     * @brief Remove all tiles (all levels) of one page.
+     */
+    void removePage(const QString& sourceId, int pageIndex);
+
+    // ===== Budget =====
+
+    /**
+     * @brief Set the memory budget in bytes, evicting immediately if over.
+     */
+    void setBudgetBytes(qint64 bytes);
+
+    qint64 budgetBytes() const;
+    qint64 bytesUsed() const;
+    int tileCount() const;
+
+private:
+    struct Entry {
+        QPixmap pixmap;
+        qint64 bytes = 0;
+        quint64 lastUsed = 0;
+    };
+
+    /// Evict LRU entries (except @p keep) until within budget. Mutex held.
+    void evictToBudget(const PdfTileKey* keep);
+
+    static qint64 pixmapBytes(const QPixmap& pixmap);
+
+    mutable QMutex m_mutex;
+    QHash<PdfTileKey, Entry> m_entries;
+    qint64 m_budgetBytes;
+    qint64 m_bytesUsed = 0;
+    quint64 m_useCounter = 0;
+};
+
+#endif // PDFTILECACHE_H
@@ -0,0 +1,403 @@
+// ============================================================================
+// ThumbnailStore - Implementation
+// ============================================================================
+//
+// Layout (all integers little-endian):
+//
+//   Header   char[4] "SNTH" | u16 version | u16 rowSize
+//            u32 entryCount | u32 reserved
+//            u64 indexOffset | u64 indexChecksum (FNV-1a of the index)
+//   Blobs    encoded thumbnails, back to back; superseded ones stay behind
+//            until the next full rewrite
+//   Index    entryCount x ROW_SIZE at indexOffset, ordered by uuid bytes:
+//            u8 uuid[16] (RFC 4122) | u64 contentStamp | u64 blobOffset
+//            u32 blobSize | u32 pixelWidth | u32 flags | u32 reserved
+//
+// An incremental update appends blobs and a fresh index after everything
+// already in the file and rewrites the header last. Older indexes become
+// dead space like superseded blobs.
+// ============================================================================
+
+#include "ThumbnailStore.h"
+
+#include <QSaveFile>
+#include <QUuid>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+
+constexpr char MAGIC[4] = { 'S', 'N', 'T', 'H' };
+constexpr int HEADER_SIZE = 32;
+constexpr int ROW_SIZE = 48;
+constexpr int UUID_SIZE = 16;
+
+/// Row flag: rendered with the PDF background inverted.
+constexpr quint32 ROW_PDF_DARK = 0x01;
+
+/// Dead bytes tolerated before an update rewrites the whole file.
+constexpr qint64 MIN_DEAD_BYTES = 1024 * 1024;
+
+template <typename T>
+void appendLE(QByteArray& buf, T v)
+{
+    char b[sizeof(T)];
+    qToLittleEndian(v, b);
+    buf.append(b, sizeof(T));
+}
+
+template <typename T>
+T readLE(const uchar* p)
+{
+    return qFromLittleEndian<T>(p);
+}
+
+quint64 fnv1a(const uchar* data, qint64 size)
+{
+    quint64 h = 14695981039346656037ull;
+    for (qint64 i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/// RFC 4122 bytes of a canonical uuid string, or empty for anything else.
+QByteArray uuidKey(const QString& uuid)
+{
+    const QUuid parsed(uuid);
+    if (parsed.isNull() || parsed.toString(QUuid::WithoutBraces) != uuid) {
+        return QByteArray();
+    }
+    return parsed.toRfc4122();
+}
+
+/// Decoded index row. Rows already in the file keep their offset into it;
+/// new rows carry their data in blob and get an offset when written.
+struct Row {
+    QByteArray key;
+    quint64 contentStamp = 0;
+    quint64 offset = 0;
+    quint32 size = 0;
+    quint32 pixelWidth = 0;
+    quint32 flags = 0;
+    QByteArray blob;  ///< New rows only
+};
+
+void appendRow(QByteArray& index, const Row& row)
+{
+    index.append(row.key);
+    appendLE<quint64>(index, row.contentStamp);
+    appendLE<quint64>(index, row.offset);
+    appendLE<quint32>(index, row.size);
+    appendLE<quint32>(index, row.pixelWidth);
+    appendLE<quint32>(index, row.flags);
+    appendLE<quint32>(index, 0);
+}
+
+QByteArray makeHeader(quint32 count, quint64 indexOffset, const QByteArray& index)
+{
+    QByteArray header;
+    header.reserve(HEADER_SIZE);
+    header.append(MAGIC, 4);
+    appendLE<quint16>(header, ThumbnailStore::FORMAT_VERSION);
+    appendLE<quint16>(header, ROW_SIZE);
+    appendLE<quint32>(header, count);
+    appendLE<quint32>(header, 0);
+    appendLE<quint64>(header, indexOffset);
+    appendLE<quint64>(header, fnv1a(reinterpret_cast<const uchar*>(index.constData()),
+                                    index.size()));
+    return header;
+}
+
+/// Validate the header of @p data and return the entry count (-1 if invalid).
+int validate(const uchar* data, qint64 size, qint64& indexOffset)
+{
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0
+        || readLE<quint16>(data + 4) != ThumbnailStore::FORMAT_VERSION
+        || readLE<quint16>(data + 6) != ROW_SIZE) {
+        return -1;
+    }
+    const quint32 count = readLE<quint32>(data + 8);
+    const quint64 offset = readLE<quint64>(data + 16);
+    if (count > quint32(std::numeric_limits<int>::max() / ROW_SIZE)
+        || offset < quint64(HEADER_SIZE)
+        || offset + quint64(count) * ROW_SIZE > quint64(size)) {
+        return -1;
+    }
+    if (fnv1a(data + offset, qint64(count) * ROW_SIZE) != readLE<quint64>(data + 24)) {
+        return -1;  // Torn update; the cache starts over
+    }
+    indexOffset = qint64(offset);
+    return int(count);
+}
+
+} // namespace
+
+ThumbnailStore::~ThumbnailStore()
+{
+    close();
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+bool ThumbnailStore::update(const QString& path, const QVector<Entry>& added,
+                            const std::function<bool(const QString& uuid)>& keep)
+{
+    // Collect the surviving rows of the current file (if it is valid). The
+    // mapping stays open until the write path is chosen, so kept blobs are
+    // only copied out of it for a full rewrite.
+    QVector<Row> rows;
+    qint64 fileSize = 0;
+    qint64 liveBytes = 0;
+    bool incremental = false;
+    ThumbnailStore current;
+    if (current.open(path)) {
+        fileSize = current.m_size;
+        incremental = true;
+        rows.reserve(current.m_count + added.size());
+        for (int i = 0; i < current.m_count; ++i) {
+            const uchar* r = current.m_index + qint64(i) * ROW_SIZE;
+            Row row;
+            row.key = QByteArray(reinterpret_cast<const char*>(r), UUID_SIZE);
+            row.offset = readLE<quint64>(r + 24);
+            row.size = readLE<quint32>(r + 32);
+            if (row.offset < quint64(HEADER_SIZE) || row.offset + row.size > quint64(fileSize)) {
+                continue;  // Checksummed, so only a foreign writer gets here
+            }
+            const QString uuid = QUuid::fromRfc4122(row.key).toString(QUuid::WithoutBraces);
+            if (!keep(uuid)) {
+                continue;
+            }
+            row.contentStamp = readLE<quint64>(r + 16);
+            row.pixelWidth = readLE<quint32>(r + 36);
+            row.flags = readLE<quint32>(r + 40);
+            rows.append(row);
+        }
+    }
+
+    // Replace or add the new entries. Interned (non-uuid) page ids are not
+    // stable across sessions and are skipped.
+    QVector<Row> fresh;
+    fresh.reserve(added.size());
+    for (const Entry& entry : added) {
+        const QByteArray key = uuidKey(entry.uuid);
+        if (key.isEmpty() || entry.data.isEmpty()) {
+            continue;
+        }
+        Row row;
+        row.key = key;
+        row.contentStamp = entry.contentStamp;
+        row.size = quint32(entry.data.size());
+        row.pixelWidth = entry.pixelWidth;
+        row.flags = entry.pdfDarkMode ? ROW_PDF_DARK : 0;
+        row.blob = entry.data;
+        fresh.append(row);
+    }
+    auto byKey = [](const Row& a, const Row& b) {
+        return std::memcmp(a.key.constData(), b.key.constData(), UUID_SIZE) < 0;
+    };
+    // Later entries for the same page win.
+    std::stable_sort(fresh.begin(), fresh.end(), byKey);
+    QVector<Row> merged;
+    merged.reserve(rows.size() + fresh.size());
+    {
+        std::sort(rows.begin(), rows.end(), byKey);
+        int i = 0;
+        int j = 0;
+        while (i < rows.size() || j < fresh.size()) {
+            if (j + 1 < fresh.size() && fresh[j].key == fresh[j + 1].key) {
+                ++j;
+                continue;
+            }
+            if (j >= fresh.size() || (i < rows.size() && byKey(rows[i], fresh[j]))) {
+                merged.append(rows[i++]);
+            } else {
+                if (i < rows.size() && rows[i].key == fresh[j].key) {
+                    ++i;
+                }
+                merged.append(fresh[j++]);
+            }
+        }
+    }
+
+    qint64 keptBytes = 0;  // Blobs already in the file that stay referenced
+    for (const Row& row : std::as_const(merged)) {
+        liveBytes += row.size;
+        if (row.offset != 0) {
+            keptBytes += row.size;
+        }
+    }
+    const qint64 indexBytes = qint64(merged.size()) * ROW_SIZE;
+    const qint64 deadBytes = fileSize - HEADER_SIZE - keptBytes;
+    if (deadBytes > std::max(MIN_DEAD_BYTES, liveBytes)) {
+        incremental = false;
+    }
+
+    if (!incremental) {
+        QByteArray blobs;
+        blobs.reserve(int(liveBytes));
+        for (Row& row : merged) {
+            const quint64 oldOffset = row.offset;
+            row.offset = quint64(HEADER_SIZE + blobs.size());
+            if (oldOffset != 0) {
+                blobs.append(reinterpret_cast<const char*>(current.m_data + oldOffset),
+                             int(row.size));
+            } else {
+                blobs.append(row.blob);
+            }
+        }
+        current.close();  // Release the mapping before the file is replaced
+        QByteArray index;
+        index.reserve(int(indexBytes));
+        for (const Row& row : std::as_const(merged)) {
+            appendRow(index, row);
+        }
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        const QByteArray header = makeHeader(quint32(merged.size()),
+                                             quint64(HEADER_SIZE + blobs.size()), index);
+        if (file.write(header) != header.size() || file.write(blobs) != blobs.size()
+            || file.write(index) != index.size()) {
+            file.cancelWriting();
+            return false;
+        }
+        return file.commit();
+    }
+
+    // Incremental: append the new blobs and index after everything in the
+    // file, then point the header at them. Kept rows keep their offsets.
+    current.close();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite) || !file.seek(fileSize)) {
+        return false;
+    }
+    QByteArray tail;
+    for (Row& row : merged) {
+        if (row.offset == 0) {  // New rows have no offset yet
+            row.offset = quint64(fileSize + tail.size());
+            tail.append(row.blob);
+        }
+    }
+    const quint64 indexOffset = quint64(fileSize + tail.size());
+    QByteArray index;
+    index.reserve(int(indexBytes));
+    for (const Row& row : std::as_const(merged)) {
+        appendRow(index, row);
+    }
+    tail.append(index);
+    if (file.write(tail) != tail.size() || !file.flush()) {
+        return false;
+    }
+    const QByteArray header = makeHeader(quint32(merged.size()), indexOffset, index);
+    const bool written = file.seek(0) && file.write(header) == header.size();
+    file.close();
+    return written;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+bool ThumbnailStore::open(const QString& path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const qint64 size = m_file.size();
+    if (size < HEADER_SIZE) {
+        close();
+        return false;
+    }
+
+    // Same approach as PageIndex::open(): map when the platform allows,
+    // otherwise keep one contiguous copy.
+    m_mapped = m_file.map(0, size);
+    if (m_mapped) {
+        m_data = m_mapped;
+    } else {
+        m_buffer = m_file.readAll();
+        m_file.close();
+        if (m_buffer.size() != size) {
+            close();
+            return false;
+        }
+        m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+    }
+
+    qint64 indexOffset = 0;
+    const int count = validate(m_data, size, indexOffset);
+    if (count < 0) {
+        close();
+        return false;
+    }
+    m_size = size;
+    m_index = m_data + indexOffset;
+    m_count = count;
+    return true;
+}
+
+void ThumbnailStore::close()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_index = nullptr;
+    m_count = 0;
+}
+
+QByteArray ThumbnailStore::find(const QString& uuid, quint32 pixelWidth, bool pdfDarkMode,
+                                quint64 contentStamp) const
+{
+    if (!m_data) {
+        return QByteArray();
+    }
+    const QByteArray key = uuidKey(uuid);
+    if (key.isEmpty()) {
+        return QByteArray();
+    }
+
+    int lo = 0;
+    int hi = m_count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        const uchar* r = m_index + qint64(mid) * ROW_SIZE;
+        const int cmp = std::memcmp(r, key.constData(), UUID_SIZE);
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else if (cmp > 0) {
+            hi = mid;
+        } else {
+            const quint64 offset = readLE<quint64>(r + 24);
+            const quint32 size = readLE<quint32>(r + 32);
+            const bool dark = (readLE<quint32>(r + 40) & ROW_PDF_DARK) != 0;
+            if (readLE<quint64>(r + 16) != contentStamp
+                || readLE<quint32>(r + 36) != pixelWidth || dark != pdfDarkMode
+                || offset < quint64(HEADER_SIZE) || offset + size > quint64(m_size)) {
+                return QByteArray();
+            }
+            return QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + offset),
+                                           int(size));
+        }
+    }
+    return QByteArray();
+}
@@ -0,0 +1,103 @@
+#ifndef THUMBNAILSTORE_H
+#define THUMBNAILSTORE_H
+
+// ============================================================================
+// ThumbnailStore - Persistent page thumbnails inside a paged bundle
+// ============================================================================
+// The page panel used to re-render every thumbnail (page load, stroke copy,
+// PDF raster) each time a notebook was opened. thumbnails.snth keeps the
+// encoded thumbnails (JPEG, PNG fallback) next to the pages so reopening a
+// notebook only decodes a few kilobytes per visible page.
+//
+// Each entry is keyed by page uuid and carries the pixel width and PDF dark
+// mode it was rendered for, plus a content stamp of the page's on-disk state
+// (see Document::pageContentStamp()). An entry whose stamp no longer matches
+// is simply not used, so edits made by other versions are never shown stale.
+//
+// Updates are incremental: new thumbnails and a new index are appended and
+// the header is rewritten last, so a crash leaves the previous index intact.
+// Superseded blobs are reclaimed by a full rewrite once they outweigh the
+// live ones. The file is a cache: anything unreadable is treated as empty.
+// ============================================================================
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @brief Read-only view of a thumbnails.snth file, plus the updater for it.
+ */
+class ThumbnailStore {
+public:
+    /// File format version stored in the header.
+    static constexpr quint16 FORMAT_VERSION = 1;
+
+    /// File name inside the bundle directory.
+    static QString fileName() { return QStringLiteral("thumbnails.snth"); }
+
+    /// One encoded thumbnail.
+    struct Entry {
+        QString uuid;                ///< Page uuid (canonical form)
+        quint64 contentStamp = 0;    ///< Page state the thumbnail shows
+        quint32 pixelWidth = 0;      ///< Rendered width in device pixels
+        bool pdfDarkMode = false;    ///< PDF background was inverted
+        QByteArray data;             ///< Encoded image
+    };
+
+    ThumbnailStore() = default;
+    ~ThumbnailStore();
+
+    ThumbnailStore(const ThumbnailStore&) = delete;
+    ThumbnailStore& operator=(const ThumbnailStore&) = delete;
+
+    // ===== Writing =====
+
+    /**
+     * @brief Add thumbnails to the store at @p path.
+     * @param added Entries to store; each replaces any entry of its page.
+     * @param keep Called for every existing entry's uuid; false drops it
+     *        (deleted pages).
+     * @return true on success.
+     *
+     * Must not be called on a file this process has open(); close() first.
+     */
+    static bool update(const QString& path, const QVector<Entry>& added,
+                       const std::function<bool(const QString& uuid)>& keep);
+
+    // ===== Reading =====
+
+    /**
+     * @brief Map @p path. Returns false (and stays closed) if the file is
+     *        missing or unreadable.
+     */
+    bool open(const QString& path);
+
+    /// Unmap and close the file.
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    int entryCount() const { return m_count; }
+
+    /**
+     * @brief Encoded thumbnail of @p uuid if it matches all parameters.
+     * @return Bytes pointing into the mapping (valid until close()), or an
+     *         empty array.
+     */
+    QByteArray find(const QString& uuid, quint32 pixelWidth, bool pdfDarkMode,
+                    quint64 contentStamp) const;
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;             ///< Backing store when mapping is unavailable
+    const uchar* m_data = nullptr;   ///< Start of the file contents
+    uchar* m_mapped = nullptr;       ///< Mapping to release in close()
+    qint64 m_size = 0;
+    const uchar* m_index = nullptr;  ///< Sorted index rows
+    int m_count = 0;
+};
+
+#endif // THUMBNAILSTORE_H
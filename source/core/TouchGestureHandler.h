@@ -88,6 +88,20 @@ public:
      * Includes active pan, pinch, or inertia animation.
      */
     bool isActive() const { return m_panActive || m_pinchActive || (m_inertiaTimer && m_inertiaTimer->isActive()); }
+    
+    /**
+     * @brief Distance the running inertia animation will still pan.
+     * @return Pan delta in doc coords until the glide stops (friction series
+     *         of the current velocity), or a null point if no inertia runs.
+     * 
+     * Lets the viewport prefetch edgeless tiles along the glide.
+     */
+    QPointF remainingInertiaPan() const {
+        if (!m_inertiaTimer || !m_inertiaTimer->isActive()) {
+            return QPointF();
+        }
+        return m_inertiaVelocity * (INERTIA_INTERVAL_MS * INERTIA_FRICTION / (1.0 - INERTIA_FRICTION));
+    }
 
 private slots:
     /**
@@ -0,0 +1,96 @@
+// ============================================================================
+// StrokeOutlineCache - Implementation
+// ============================================================================
+
+#include "StrokeOutlineCache.h"
+
+#include <QMutexLocker>
+
+StrokeOutlineCache& StrokeOutlineCache::instance()
+{
+    static StrokeOutlineCache cache;
+    return cache;
+}
+
+qint64 StrokeOutlineCache::entryBytes(const StrokePolygonResult& outline)
+{
+    // Vertices, the result struct and its control block, the LRU node and
+    // the hash node. Close enough to keep the budget honest.
+    return qint64(outline.polygon.capacity()) * qint64(sizeof(QPointF))
+           + qint64(sizeof(StrokePolygonResult)) + qint64(sizeof(Entry)) + 96;
+}
+
+StrokeOutlineCache::Outline StrokeOutlineCache::get(quint64 revision, qreal thickness,
+                                                     const std::function<StrokePolygonResult()>& build)
+{
+    const Key key{revision, thickness};
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_index.constFind(key);
+        if (it != m_index.constEnd()) {
+            m_lru.splice(m_lru.begin(), m_lru, it.value());
+            ++m_stats.hits;
+            return m_lru.front().outline;
+        }
+        ++m_stats.misses;
+    }
+
+    // Tessellate outside the lock so render/export threads don't serialize
+    // on each other's misses. Two threads missing the same stroke at once
+    // both build it; the second insert just refreshes the entry.
+    Outline outline = std::make_shared<const StrokePolygonResult>(build());
+    const qint64 bytes = entryBytes(*outline);
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it.value());
+        return m_lru.front().outline;
+    }
+    m_lru.push_front(Entry{key, outline, bytes});
+    m_index.insert(key, m_lru.begin());
+    m_stats.bytes += bytes;
+    evictToBudget();
+    return outline;
+}
+
+void StrokeOutlineCache::evictToBudget()
+{
+    // Keep at least the entry just inserted, even if it alone is over budget.
+    while (m_stats.bytes > m_budget && m_lru.size() > 1) {
+        const Entry& victim = m_lru.back();
+        m_stats.bytes -= victim.bytes;
+        m_index.remove(victim.key);
+        m_lru.pop_back();
+        ++m_stats.evictions;
+    }
+}
+
+void StrokeOutlineCache::setBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = qMax<qint64>(0, bytes);
+    evictToBudget();
+}
+
+qint64 StrokeOutlineCache::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+void StrokeOutlineCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_index.clear();
+    m_lru.clear();
+    m_stats = Stats();
+}
+
+StrokeOutlineCache::Stats StrokeOutlineCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.entries = int(m_lru.size());
+    return stats;
+}
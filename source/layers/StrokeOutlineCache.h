@@ -0,0 +1,122 @@
+#pragma once
+
+// ============================================================================
+// StrokeOutlineCache - Memory-budgeted LRU cache of tessellated strokes
+// ============================================================================
+// A stroke's filled outline (Catmull-Rom smoothing + variable-width offsets)
+// depends only on its points and base thickness, both of which are fixed
+// after pen-up. Without a cache, every stroke-cache rebuild, focus-cache
+// rebuild, Direct-tier repaint and PDF export re-tessellates every visible
+// stroke; zooming a dense board at high zoom rebuilds thousands of polygons
+// per frame.
+//
+// Entries are keyed by (StrokePointList::revision(), baseThickness). A
+// transform, erase-split or pressure edit gives the points a new revision,
+// so stale outlines are simply never looked up again and age out of the LRU.
+// Color is not part of the key: recoloring reuses the outline. Copies of a
+// stroke (undo stack, tile segments before translation, clipboard) share the
+// revision of their points and therefore the outline.
+//
+// One process-wide instance, shared by rendering and export threads.
+// ============================================================================
+
+#include <QHash>
+#include <QMutex>
+#include <QPointF>
+#include <QPolygonF>
+
+#include <functional>
+#include <list>
+#include <memory>
+
+/**
+ * @brief Result of building a stroke polygon.
+ *
+ * Contains the filled polygon representing the stroke outline, plus
+ * information about round end caps if needed. This is used by both
+ * QPainter rendering and PDF export.
+ */
+struct StrokePolygonResult {
+    QPolygonF polygon;              ///< The filled polygon outline
+    bool isSinglePoint = false;     ///< True if stroke is just a dot
+    bool hasRoundCaps = false;      ///< True if round end caps should be drawn
+    QPointF startCapCenter;         ///< Center of start cap ellipse
+    qreal startCapRadius = 0;       ///< Radius of start cap
+    QPointF endCapCenter;           ///< Center of end cap ellipse
+    qreal endCapRadius = 0;         ///< Radius of end cap
+};
+
+/**
+ * @brief Process-wide LRU cache of StrokePolygonResult.
+ *
+ * Outlines are handed out as shared pointers, so an entry evicted by one
+ * thread stays valid for a renderer that is still drawing it.
+ */
+class StrokeOutlineCache {
+public:
+    using Outline = std::shared_ptr<const StrokePolygonResult>;
+
+    /// Default memory budget (polygon vertices plus bookkeeping).
+    static constexpr qint64 DEFAULT_BUDGET_BYTES = 64ll * 1024 * 1024;
+
+    struct Stats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 evictions = 0;
+        qint64 bytes = 0;
+        int entries = 0;
+    };
+
+    static StrokeOutlineCache& instance();
+
+    /**
+     * @brief Cached outline for (revision, thickness), or build and insert it.
+     * @param revision StrokePointList::revision() of the stroke's points.
+     * @param thickness Stroke base thickness.
+     * @param build Called without the lock held on a miss.
+     */
+    Outline get(quint64 revision, qreal thickness,
+                const std::function<StrokePolygonResult()>& build);
+
+    /**
+     * @brief Change the memory budget, evicting least recently used
+     *        outlines until the cache fits.
+     */
+    void setBudget(qint64 bytes);
+    qint64 budget() const;
+
+    /// Drop all outlines and reset the statistics.
+    void clear();
+
+    Stats stats() const;
+
+private:
+    StrokeOutlineCache() = default;
+
+    struct Key {
+        quint64 revision;
+        qreal thickness;
+        bool operator==(const Key& other) const {
+            return revision == other.revision && thickness == other.thickness;
+        }
+    };
+    friend size_t qHash(const Key& key, size_t seed = 0) noexcept {
+        return ::qHash(key.revision, seed) ^ ::qHash(key.thickness, seed);
+    }
+
+    struct Entry {
+        Key key;
+        Outline outline;
+        qint64 bytes;
+    };
+    using Lru = std::list<Entry>;  ///< Front = most recently used
+
+    static qint64 entryBytes(const StrokePolygonResult& outline);
+    void evictToBudget();  ///< Caller holds m_mutex
+
+    mutable QMutex m_mutex;
+    Lru m_lru;
+    QHash<Key, Lru::iterator> m_index;
+    qint64 m_budget = DEFAULT_BUDGET_BYTES;
+    Stats m_stats;
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+// ============================================================================
+// StrokeSpatialIndex - Uniform grid over stroke bounding boxes
+// ============================================================================
+// Used by VectorLayer to answer "which strokes touch this rect?" without
+// walking every stroke. Pages and tiles are bounded (a few thousand logical
+// pixels), and handwriting strokes are small relative to them, so a hashed
+// uniform grid beats a tree here: insert is O(cells covered), a query is
+// O(cells covered + k), and there is no rebalancing.
+//
+// Entries are stroke indices into the owning layer's stroke vector, so the
+// index must be told about removals (which shift later indices down).
+// ============================================================================
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+#include <QtMath>
+
+#include <algorithm>
+
+/**
+ * @brief Hashed uniform grid mapping cells to stroke indices.
+ *
+ * Strokes whose bounding box covers more than MAX_CELLS_PER_ENTRY cells
+ * (long ruler lines, big scribbles) are kept in a separate "oversized" list
+ * that every query includes, so a single huge stroke can't bloat the grid.
+ */
+class StrokeSpatialIndex {
+public:
+    /// Grid cell edge length in page/tile logical pixels.
+    static constexpr qreal CELL_SIZE = 64.0;
+
+    /// Entries covering more cells than this go to the oversized list.
+    static constexpr int MAX_CELLS_PER_ENTRY = 64;
+
+    /**
+     * @brief Remove all entries.
+     */
+    void clear() {
+        m_cells.clear();
+        m_oversized.clear();
+        m_count = 0;
+    }
+
+    /**
+     * @brief Number of indexed strokes.
+     */
+    int size() const { return m_count; }
+
+    /**
+     * @brief Add a stroke index covering @p bounds.
+     * @param index Stroke index in the owning layer.
+     * @param bounds Stroke bounding box.
+     *
+     * Indices must be inserted in increasing order (append semantics), which
+     * keeps every cell list sorted without extra work.
+     */
+    void insert(int index, const QRectF& bounds) {
+        ++m_count;
+        CellRange r;
+        if (!cellRange(bounds, r) || r.cellCount() > MAX_CELLS_PER_ENTRY) {
+            m_oversized.append(index);
+            return;
+        }
+        for (int cy = r.y0; cy <= r.y1; ++cy) {
+            for (int cx = r.x0; cx <= r.x1; ++cx) {
+                m_cells[cellKey(cx, cy)].append(index);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove several entries at once and compact the remaining indices.
+     * @param indices Removed stroke indices, sorted ascending.
+     * @param bounds Bounding boxes matching @p indices (as inserted).
+     *
+     * Dropping the entries touches only their cells; shifting the survivors
+     * is a linear pass over all entries, the same order of work as the
+     * QVector compaction it mirrors.
+     */
+    void removeIndices(const QVector<int>& indices, const QVector<QRectF>& bounds) {
+        if (indices.isEmpty()) return;
+
+        // Drop the entries from the cells they were inserted into.
+        for (int i = 0; i < indices.size(); ++i) {
+            const int index = indices[i];
+            CellRange r;
+            if (!cellRange(bounds[i], r) || r.cellCount() > MAX_CELLS_PER_ENTRY) {
+                eraseSorted(m_oversized, index);
+                continue;
+            }
+            for (int cy = r.y0; cy <= r.y1; ++cy) {
+                for (int cx = r.x0; cx <= r.x1; ++cx) {
+                    auto it = m_cells.find(cellKey(cx, cy));
+                    if (it == m_cells.end()) continue;
+                    eraseSorted(*it, index);
+                    if (it->isEmpty()) m_cells.erase(it);
+                }
+            }
+        }
+        m_count -= static_cast<int>(indices.size());
+
+        // Shift the survivors: new index = old index - (# removed below it).
+        auto remap = [&indices](int& v) {
+            v -= static_cast<int>(std::lower_bound(indices.begin(), indices.end(), v)
+                                  - indices.begin());
+        };
+        const int firstRemoved = indices.first();
+        for (auto it = m_cells.begin(); it != m_cells.end(); ++it) {
+            for (int& v : *it) {
+                if (v > firstRemoved) remap(v);
+            }
+        }
+        for (int& v : m_oversized) {
+            if (v > firstRemoved) remap(v);
+        }
+    }
+
+    /**
+     * @brief Collect candidate stroke indices whose cells overlap @p rect.
+     * @param rect Query rectangle (page/tile coordinates).
+     * @return Sorted, de-duplicated indices. Candidates only: callers apply
+     *         their own exact test (bounding box, containsPoint, lasso).
+     */
+    QVector<int> query(const QRectF& rect) const {
+        QVector<int> result = m_oversized;
+        CellRange r;
+        if (cellRange(rect, r)) {
+            // A huge query rect (e.g. select-all lasso) is cheaper to answer
+            // by walking the occupied cells than by probing every empty one.
+            if (r.cellCount() > m_cells.size()) {
+                for (auto it = m_cells.constBegin(); it != m_cells.constEnd(); ++it) {
+                    const int cx = static_cast<qint32>(it.key() >> 32);
+                    const int cy = static_cast<qint32>(it.key() & 0xffffffffu);
+                    if (cx >= r.x0 && cx <= r.x1 && cy >= r.y0 && cy <= r.y1) {
+                        result += *it;
+                    }
+                }
+            } else {
+                for (int cy = r.y0; cy <= r.y1; ++cy) {
+                    for (int cx = r.x0; cx <= r.x1; ++cx) {
+                        auto it = m_cells.constFind(cellKey(cx, cy));
+                        if (it != m_cells.constEnd()) result += *it;
+                    }
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+private:
+    struct CellRange {
+        int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+        qint64 cellCount() const {
+            return qint64(x1 - x0 + 1) * qint64(y1 - y0 + 1);
+        }
+    };
+
+    static bool cellRange(const QRectF& rect, CellRange& r) {
+        // Zero-size rects are fine (a point probe); negative or NaN are not.
+        if (!(rect.width() >= 0 && rect.height() >= 0)) return false;
+        // Clamp so absurd coordinates can't overflow the int cell math.
+        constexpr qreal LIMIT = 1.0e9;
+        r.x0 = qFloor(qBound(-LIMIT, rect.left(), LIMIT) / CELL_SIZE);
+        r.y0 = qFloor(qBound(-LIMIT, rect.top(), LIMIT) / CELL_SIZE);
+        r.x1 = qFloor(qBound(-LIMIT, rect.right(), LIMIT) / CELL_SIZE);
+        r.y1 = qFloor(qBound(-LIMIT, rect.bottom(), LIMIT) / CELL_SIZE);
+        return true;
+    }
+
+    static quint64 cellKey(int cx, int cy) {
+        return (quint64(quint32(cx)) << 32) | quint64(quint32(cy));
+    }
+
+    static void eraseSorted(QVector<int>& list, int value) {
+        auto it = std::lower_bound(list.begin(), list.end(), value);
+        if (it != list.end() && *it == value) list.erase(it);
+    }
+
+    QHash<quint64, QVector<int>> m_cells;  ///< Cell key -> sorted stroke indices
+    QVector<int> m_oversized;              ///< Strokes spanning too many cells
+    int m_count = 0;
+};
@@ -9,17 +9,24 @@
 // ============================================================================
 
 #include "../strokes/VectorStroke.h"
+#include "../strokes/StrokeKernels.h"
+#include "StrokeOutlineCache.h"
+#include "StrokeSpatialIndex.h"
 
 #include <QString>
 #include <QVector>
+#include <QHash>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QUuid>
 #include <QPainter>
+#include <QImage>
 #include <QPolygonF>
 #include <QPixmap>
 #include <QtMath>
 
+#include <algorithm>
+
 /**
  * @brief A single vector layer containing strokes.
  * 
@@ -67,6 +74,7 @@ public:
      */
     void addStroke(const VectorStroke& stroke) {
         m_strokes.append(stroke);
+        indexAppendedStroke();
         markStrokePending();
     }
     
@@ -76,6 +84,7 @@ public:
      */
     void addStroke(VectorStroke&& stroke) {
         m_strokes.append(std::move(stroke));
+        indexAppendedStroke();
         markStrokePending();
     }
     
@@ -89,16 +98,80 @@ public:
      * rebuilding the entire cache. This makes eraser O(k) where k is the
      * number of strokes overlapping the erased one, instead of O(n) for all.
      */
-    bool removeStroke(const QString& strokeId) {
-        for (int i = static_cast<int>(m_strokes.size()) - 1; i >= 0; --i) {
-            if (m_strokes[i].id == strokeId) {
-                QRectF removedBounds = m_strokes[i].boundingBox;
-                m_strokes.removeAt(i);
-                patchCacheAfterRemoval(removedBounds);
-                return true;
+    bool removeStroke(const Id128& strokeId) {
+        const int i = indexOfStroke(strokeId);
+        if (i < 0) {
+            return false;
+        }
+        // Copy before removeAt: strokeId may refer into m_strokes itself.
+        const QRectF removedBounds = m_strokes[i].boundingBox;
+        const Id128 removedId = m_strokes[i].id;
+        m_strokes.removeAt(i);
+        unindexRemovedStrokes({ i }, { removedBounds }, { removedId });
+        patchCacheAfterRemoval(removedBounds);
+        return true;
+    }
+    
+    /**
+     * @brief Remove several strokes by ID in one pass.
+     * @param strokeIds IDs to remove (unknown IDs are ignored).
+     * @return The removed strokes, in layer (z) order - ready for undo.
+     * 
+     * Eraser and lasso-erase remove many strokes at once; doing it here
+     * compacts the stroke vector and the spatial index once instead of once
+     * per stroke, and saves callers a second scan to copy the strokes out.
+     */
+    QVector<VectorStroke> removeStrokes(const QVector<Id128>& strokeIds) {
+        QVector<int> indices;
+        indices.reserve(strokeIds.size());
+        for (const Id128& id : strokeIds) {
+            const int i = indexOfStroke(id);
+            if (i >= 0) indices.append(i);
+        }
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        
+        QVector<VectorStroke> removed;
+        if (indices.isEmpty()) {
+            return removed;
+        }
+        removed.reserve(indices.size());
+        QVector<QRectF> removedBounds;
+        removedBounds.reserve(indices.size());
+        QVector<Id128> removedIds;
+        removedIds.reserve(indices.size());
+        
+        // Single compaction pass: move survivors down over the holes.
+        int write = indices.first();
+        int next = 0;
+        for (int read = indices.first(); read < m_strokes.size(); ++read) {
+            if (next < indices.size() && indices[next] == read) {
+                removedBounds.append(m_strokes[read].boundingBox);
+                removedIds.append(m_strokes[read].id);
+                removed.append(std::move(m_strokes[read]));
+                ++next;
+            } else {
+                if (write != read) m_strokes[write] = std::move(m_strokes[read]);
+                ++write;
             }
         }
-        return false;
+        m_strokes.resize(write);
+        
+        unindexRemovedStrokes(indices, removedBounds, removedIds);
+        for (const QRectF& bounds : removedBounds) {
+            patchCacheAfterRemoval(bounds);
+        }
+        return removed;
+    }
+    
+    /**
+     * @brief Find the index of a stroke by ID.
+     * @param strokeId The UUID of the stroke.
+     * @return Index into strokes(), or -1 if not found. O(1) via the ID hash.
+     */
+    int indexOfStroke(const Id128& strokeId) const {
+        ensureSpatialIndex();
+        return m_strokeIndexById.value(strokeId, -1);
     }
     
     /**
@@ -110,8 +183,15 @@ public:
     /**
      * @brief Get all strokes (mutable reference for modification).
      * @return Mutable vector of strokes.
+     * 
+     * Callers may move, edit or reorder strokes through this reference, so
+     * the spatial index is dropped and rebuilt on the next query. Read-only
+     * callers on hot paths should go through a const layer instead.
      */
-    QVector<VectorStroke>& strokes() { return m_strokes; }
+    QVector<VectorStroke>& strokes() {
+        invalidateSpatialIndex();
+        return m_strokes;
+    }
     
     /**
      * @brief Get the number of strokes in this layer.
@@ -128,27 +208,65 @@ public:
      */
     void clear() { 
         m_strokes.clear(); 
+        invalidateSpatialIndex();
         invalidateStrokeCache();  // Cache needs rebuild
     }
     
+    /**
+     * @brief Replace all strokes in this layer (bulk load path).
+     * @param strokes The strokes to take ownership of.
+     * 
+     * Used by the binary page loader, which decodes whole stroke columns
+     * at once instead of adding strokes one by one.
+     */
+    void setStrokes(QVector<VectorStroke>&& strokes) {
+        m_strokes = std::move(strokes);
+        invalidateSpatialIndex();
+        invalidateStrokeCache();
+    }
+    
     // ===== Hit Testing =====
     
     /**
      * @brief Find all strokes that contain a given point (for eraser).
      * @param pt The point to test.
      * @param tolerance Additional radius around the point.
-     * @return List of stroke IDs that contain the point.
+     * @return List of stroke IDs that contain the point, in layer order.
+     * 
+     * Only strokes from the spatial index cells around the point are
+     * tested, so the cost is independent of the total stroke count.
      */
-    QVector<QString> strokesAtPoint(const QPointF& pt, qreal tolerance) const {
-        QVector<QString> result;
-        for (const auto& stroke : m_strokes) {
-            if (stroke.containsPoint(pt, tolerance)) {
-                result.append(stroke.id);
+    QVector<Id128> strokesAtPoint(const QPointF& pt, qreal tolerance) const {
+        QVector<Id128> result;
+        ensureSpatialIndex();
+        const QRectF probe(pt.x() - tolerance, pt.y() - tolerance,
+                           tolerance * 2, tolerance * 2);
+        for (int i : m_spatialIndex.query(probe)) {
+            if (m_strokes[i].containsPoint(pt, tolerance)) {
+                result.append(m_strokes[i].id);
             }
         }
         return result;
     }
     
+    /**
+     * @brief Find the strokes whose bounding box intersects a rectangle.
+     * @param rect Query rectangle in page/tile coordinates.
+     * @return Stroke indices in ascending (z) order.
+     * 
+     * Used as the broad phase for lasso selection/erase and for the cache
+     * patch after a removal.
+     */
+    QVector<int> strokeIndicesIntersecting(const QRectF& rect) const {
+        ensureSpatialIndex();
+        QVector<int> result = m_spatialIndex.query(rect);
+        result.erase(std::remove_if(result.begin(), result.end(), [&](int i) {
+                         return !m_strokes[i].boundingBox.intersects(rect);
+                     }),
+                     result.end());
+        return result;
+    }
+    
     /**
      * @brief Calculate bounding box of all strokes in this layer.
      * @return Bounding rectangle, or empty rect if layer is empty.
@@ -166,22 +284,8 @@ public:
     
     // ===== Rendering =====
     
-    /**
-     * @brief Result of building a stroke polygon.
-     * 
-     * Contains the filled polygon representing the stroke outline, plus
-     * information about round end caps if needed. This is used by both
-     * QPainter rendering and PDF export.
-     */
-    struct StrokePolygonResult {
-        QPolygonF polygon;              ///< The filled polygon outline
-        bool isSinglePoint = false;     ///< True if stroke is just a dot
-        bool hasRoundCaps = false;      ///< True if round end caps should be drawn
-        QPointF startCapCenter;         ///< Center of start cap ellipse
-        qreal startCapRadius = 0;       ///< Radius of start cap
-        QPointF endCapCenter;           ///< Center of end cap ellipse
-        qreal endCapRadius = 0;         ///< Radius of end cap
-    };
+    /// Stroke outline (defined next to StrokeOutlineCache, which stores it).
+    using StrokePolygonResult = ::StrokePolygonResult;
     
     /**
      * @brief Build the filled polygon for a stroke (reusable for rendering and export).
@@ -193,7 +297,7 @@ public:
      * - PDF export (MuPdfExporter - converts to MuPDF paths)
      * 
      * The stored stroke points are first smoothed with Catmull-Rom interpolation
-     * (see catmullRomSubdivide) to produce a dense, smooth point sequence. This
+     * (see StrokeKernels::buildOutline) to produce a dense, smooth point sequence. This
      * eliminates the visible polyline edges that would otherwise appear at high zoom.
      * 
      * The polygon represents the variable-width stroke outline:
@@ -209,94 +313,62 @@ public:
             // Single point - just a dot
             if (stroke.points.size() == 1) {
                 result.isSinglePoint = true;
-                result.startCapCenter = stroke.points[0].pos;
+                result.startCapCenter = stroke.points.position(0);
                 // Minimum stroke width is now enforced at capture time in
                 // DocumentViewport (per pen preset), so the stored per-point
                 // pressure already embeds the floor.  No qMax() needed here.
-                qreal width = stroke.baseThickness * stroke.points[0].pressure;
+                qreal width = stroke.baseThickness * stroke.points.pressure(0);
                 result.startCapRadius = width / 2.0;
             }
             return result;
         }
         
-        // Smooth the stroke points with Catmull-Rom interpolation.
-        // This inserts intermediate points along a smooth curve between each
-        // pair of stored points, eliminating the visible polyline edges that
-        // appear when zoomed in. For 2-point strokes (straight lines),
-        // catmullRomSubdivide returns them unchanged.
-        const QVector<StrokePoint>& pts = catmullRomSubdivide(stroke.points);
-        const int n = static_cast<int>(pts.size());
-        
-        // Pre-calculate half-widths for each point
-        QVector<qreal> halfWidths(n);
-        for (int i = 0; i < n; ++i) {
-            // See comment above: minimum-width floor is applied in
-            // DocumentViewport at capture time, not here.
-            qreal width = stroke.baseThickness * pts[i].pressure;
-            halfWidths[i] = width / 2.0;
-        }
-        
-        // Build the stroke outline polygon
-        // Left edge goes forward, right edge goes backward
-        QVector<QPointF> leftEdge(n);
-        QVector<QPointF> rightEdge(n);
-        
-        for (int i = 0; i < n; ++i) {
-            const QPointF& pos = pts[i].pos;
-            qreal hw = halfWidths[i];
-            
-            // Calculate perpendicular direction
-            QPointF tangent;
-            if (i == 0) {
-                // First point: use direction to next point
-                tangent = pts[1].pos - pos;
-            } else if (i == n - 1) {
-                // Last point: use direction from previous point
-                tangent = pos - pts[n - 2].pos;
-            } else {
-                // Middle points: average of incoming and outgoing directions
-                tangent = pts[i + 1].pos - pts[i - 1].pos;
-            }
-            
-            // Normalize tangent
-            qreal len = qSqrt(tangent.x() * tangent.x() + tangent.y() * tangent.y());
-            if (len < 0.0001) {
-                // Degenerate case: use arbitrary perpendicular
-                tangent = QPointF(1.0, 0.0);
-                len = 1.0;
-            }
-            tangent /= len;
-            
-            // Perpendicular vector (rotate 90 degrees)
-            QPointF perp(-tangent.y(), tangent.x());
-            
-            // Calculate left and right edge points
-            leftEdge[i] = pos + perp * hw;
-            rightEdge[i] = pos - perp * hw;
-        }
+        // Smooth the stroke points with Catmull-Rom interpolation and offset
+        // the smoothed centerline by the per-point half width. Subdivision
+        // eliminates the visible polyline edges that appear when zoomed in;
+        // 2-point strokes (straight lines) are not subdivided. The kernels
+        // work on the stroke's float columns in a per-thread scratch arena,
+        // so the polygon below is the only allocation.
+        const StrokeKernels::Outline outline = StrokeKernels::buildOutline(
+            stroke.points, stroke.baseThickness, CURVE_SUBDIVISIONS);
+        const int n = outline.count;
         
         // Build polygon: left edge forward, then right edge backward
-        result.polygon.reserve(n * 2);
-        
+        result.polygon.resize(n * 2);
+        QPointF* out = result.polygon.data();
         for (int i = 0; i < n; ++i) {
-            result.polygon << leftEdge[i];
-        }
-        for (int i = n - 1; i >= 0; --i) {
-            result.polygon << rightEdge[i];
+            out[i] = QPointF(outline.leftX[i], outline.leftY[i]);
+            out[2 * n - 1 - i] = QPointF(outline.rightX[i], outline.rightY[i]);
         }
         
         // Set up round cap information
         // Use first/last smoothed points (which equal the original stroke endpoints,
         // since Catmull-Rom passes through its control points)
         result.hasRoundCaps = true;
-        result.startCapCenter = pts.first().pos;
-        result.startCapRadius = halfWidths[0];
-        result.endCapCenter = pts.last().pos;
-        result.endCapRadius = halfWidths[n - 1];
+        result.startCapCenter = QPointF(outline.x[0], outline.y[0]);
+        result.startCapRadius = outline.halfWidth[0];
+        result.endCapCenter = QPointF(outline.x[n - 1], outline.y[n - 1]);
+        result.endCapRadius = outline.halfWidth[n - 1];
         
         return result;
     }
     
+    /**
+     * @brief Outline of a stroke from the shared StrokeOutlineCache.
+     * @param stroke The stroke to convert.
+     * @return Shared, immutable polygon; built on the first request for these
+     *         points and thickness, reused afterwards.
+     * 
+     * Use this for finished strokes. Strokes that change every frame (the
+     * live stroke, a lasso transform preview) should call buildStrokePolygon
+     * directly so they don't churn the cache.
+     */
+    static StrokeOutlineCache::Outline cachedStrokePolygon(const VectorStroke& stroke) {
+        return StrokeOutlineCache::instance().get(
+            stroke.points.revision(), stroke.baseThickness,
+            [&stroke]() { return buildStrokePolygon(stroke); });
+    }
+    
     /**
      * @brief Render all strokes in this layer.
      * @param painter The QPainter to render to (should have antialiasing enabled).
@@ -331,9 +403,21 @@ public:
      * For semi-transparent strokes with round caps, renders to a temp buffer at
      * full opacity then blits with the stroke's alpha to avoid alpha compounding
      * where the caps overlap the stroke body.
+     * 
+     * @param cacheOutline Take the outline from StrokeOutlineCache (default).
+     *        Pass false for strokes whose points change every frame.
      */
-    static void renderStroke(QPainter& painter, const VectorStroke& stroke) {
-        StrokePolygonResult poly = buildStrokePolygon(stroke);
+    static void renderStroke(QPainter& painter, const VectorStroke& stroke,
+                             bool cacheOutline = true) {
+        // Dots are cheaper to build than to look up.
+        StrokeOutlineCache::Outline cached;
+        StrokePolygonResult built;
+        if (cacheOutline && stroke.points.size() >= 2) {
+            cached = cachedStrokePolygon(stroke);
+        } else {
+            built = buildStrokePolygon(stroke);
+        }
+        const StrokePolygonResult& poly = cached ? *cached : built;
         
         if (poly.isSinglePoint) {
             // Single point - draw a dot (no alpha compounding issue)
@@ -382,7 +466,9 @@ public:
                 return;
             }
             
-            QPixmap tempBuffer(bufW, bufH);
+            // QImage rather than QPixmap: this also runs on worker threads
+            // (export, Document::tileDecoder()).
+            QImage tempBuffer(bufW, bufH, QImage::Format_ARGB32_Premultiplied);
             tempBuffer.setDevicePixelRatio(dpr);
             tempBuffer.fill(Qt::transparent);
             
@@ -407,7 +493,7 @@ public:
             painter.save();
             painter.resetTransform();
             painter.setOpacity(strokeAlpha / 255.0);
-            painter.drawPixmap(mappedBounds.topLeft(), tempBuffer);
+            painter.drawImage(mappedBounds.topLeft(), tempBuffer);
             painter.restore();
         } else {
             // Standard rendering for opaque strokes (no alpha compounding issue)
@@ -429,9 +515,11 @@ public:
     
     /**
      * @brief Serialize layer to JSON.
+     * @param includeStrokes If false, the "strokes" array is omitted (the
+     *        binary page container stores strokes in packed columns instead).
      * @return JSON object containing layer data.
      */
-    QJsonObject toJson() const {
+    QJsonObject toJson(bool includeStrokes = true) const {
         QJsonObject obj;
         obj["id"] = id;
         obj["name"] = name;
@@ -439,11 +527,13 @@ public:
         obj["opacity"] = opacity;
         obj["locked"] = locked;
         
-        QJsonArray strokesArray;
-        for (const auto& stroke : m_strokes) {
-            strokesArray.append(stroke.toJson());
+        if (includeStrokes) {
+            QJsonArray strokesArray;
+            for (const auto& stroke : m_strokes) {
+                strokesArray.append(stroke.toJson());
+            }
+            obj["strokes"] = strokesArray;
         }
-        obj["strokes"] = strokesArray;
         
         return obj;
     }
@@ -588,6 +678,68 @@ public:
      * @return True if cache pixmap is allocated.
      */
     bool hasStrokeCacheAllocated() const { return !m_strokeCache.isNull(); }
+    
+    /**
+     * @brief Render what ensureStrokeCacheValid() would cache, into an image.
+     * @return The cache contents at @p size, @p zoom and @p dpr.
+     * 
+     * Unlike the cache itself this may run on any thread, as long as no other
+     * thread modifies the layer meanwhile. Document::tileDecoder() uses it to
+     * pre-render the caches of tiles it loads in the background; hand the
+     * result to adoptStrokeCacheImage() on the GUI thread.
+     */
+    QImage renderStrokeCacheImage(const QSizeF& size, qreal zoom, qreal dpr) const {
+        int divisor = computeCacheDivisor(size, zoom, dpr);
+        QSize physicalSize = cappedPhysicalSize(size, zoom, dpr, divisor);
+        qreal rawScale = zoom * dpr / divisor;
+        
+        QImage image(physicalSize, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(cacheDevicePixelRatio(rawScale));
+        image.fill(Qt::transparent);
+        paintStrokeCache(image, rawScale);
+        return image;
+    }
+    
+    /**
+     * @brief Install an image from renderStrokeCacheImage() as the stroke cache.
+     * 
+     * GUI thread only. Ignored if @p image does not have the size the cache
+     * would have for @p size, @p zoom and @p dpr, or if the layer already has
+     * a valid cache.
+     */
+    void adoptStrokeCacheImage(const QImage& image, const QSizeF& size, qreal zoom, qreal dpr) {
+        int divisor = computeCacheDivisor(size, zoom, dpr);
+        if (image.isNull() || image.size() != cappedPhysicalSize(size, zoom, dpr, divisor)) {
+            return;
+        }
+        if (!m_strokeCacheDirty && !m_strokeCache.isNull()) {
+            return;
+        }
+        m_strokeCache = QPixmap::fromImage(image);
+        m_strokeCache.setDevicePixelRatio(image.devicePixelRatio());
+        m_strokeCacheDirty = false;
+        m_pendingStrokeStart = -1;
+        m_cacheZoom = zoom;
+        m_cacheDpr = dpr;
+        m_cacheDivisor = divisor;
+    }
+    
+    /**
+     * @brief Approximate memory held by this layer's strokes and caches.
+     */
+    qint64 memoryBytes() const {
+        qint64 bytes = 0;
+        for (const auto& stroke : m_strokes) {
+            bytes += qint64(sizeof(VectorStroke)) + stroke.points.byteSize();
+        }
+        if (!m_strokeCache.isNull()) {
+            bytes += qint64(m_strokeCache.width()) * m_strokeCache.height() * 4;
+        }
+        if (!m_focusCache.isNull()) {
+            bytes += qint64(m_focusCache.width()) * m_focusCache.height() * 4;
+        }
+        return bytes;
+    }
 
     // ===== Focus Cache (viewport-clipped, high-zoom path) =====
 
@@ -697,8 +849,8 @@ public:
         p.fillRect(clearRect, Qt::transparent);
         p.setCompositionMode(QPainter::CompositionMode_SourceOver);
         p.setClipRect(clearRect);
-        for (const auto& s : m_strokes) {
-            if (s.boundingBox.intersects(clearRect)) renderStroke(p, s);
+        for (int i : strokeIndicesIntersecting(clearRect)) {
+            renderStroke(p, m_strokes[i]);
         }
     }
     
@@ -769,7 +921,7 @@ public:
      * rendering the transformed copies separately. This bypasses the cache
      * to allow per-stroke exclusion.
      */
-    void renderExcluding(QPainter& painter, const QSet<QString>& excludeIds) {
+    void renderExcluding(QPainter& painter, const QSet<Id128>& excludeIds) {
         if (!visible || m_strokes.isEmpty() || excludeIds.isEmpty()) {
             // No exclusions needed, but caller expects direct render (no cache)
             render(painter);
@@ -822,7 +974,7 @@ public:
      * focus rect.
      */
     void renderDirectExcludingClipped(QPainter& painter,
-                                      const QSet<QString>& excludeIds,
+                                      const QSet<Id128>& excludeIds,
                                       const QRectF& clipRect) const {
         if (!visible || m_strokes.isEmpty()) return;
         painter.setRenderHint(QPainter::Antialiasing, true);
@@ -897,7 +1049,7 @@ public:
      * for the typical lasso interaction pattern.)
      */
     void renderExcludingTiered(QPainter& painter,
-                               const QSet<QString>& excludeIds,
+                               const QSet<Id128>& excludeIds,
                                const QSizeF& size, qreal zoom, qreal dpr,
                                RenderTier tier, const QRectF& focusRect) {
         Q_UNUSED(size);
@@ -920,74 +1072,89 @@ public:
 private:
     QVector<VectorStroke> m_strokes;  ///< All strokes in this layer
     
-    // ===== Curve Smoothing =====
+    // ===== Spatial Index =====
+    // Grid over stroke bounding boxes plus an ID -> index hash. Maintained
+    // incrementally by addStroke/removeStroke/removeStrokes; anything that
+    // can rewrite m_strokes wholesale (mutable strokes(), clear, setStrokes,
+    // fromJson) marks it dirty and it is rebuilt lazily on the next query.
+    mutable StrokeSpatialIndex m_spatialIndex;
+    mutable QHash<Id128, int> m_strokeIndexById;  ///< Last stroke with each ID
+    mutable bool m_spatialIndexDirty = true;
+    mutable bool m_duplicateStrokeIds = false;    ///< Some ID is on several strokes
     
-    /// Number of interpolated points to insert between each pair of stored points.
-    /// Higher values produce smoother curves at high zoom, at the cost of more
-    /// polygon vertices (which are cached, so the per-frame cost is zero).
-    /// 4 subdivisions keeps segments under ~4 screen pixels at 10x zoom.
-    static constexpr int CURVE_SUBDIVISIONS = 4;
+    /**
+     * @brief Drop the spatial index; it is rebuilt on the next query.
+     */
+    void invalidateSpatialIndex() {
+        if (m_spatialIndexDirty) return;
+        m_spatialIndexDirty = true;
+        m_spatialIndex.clear();
+        m_strokeIndexById.clear();
+    }
     
     /**
-     * @brief Subdivide stroke points using uniform Catmull-Rom interpolation.
-     * @param points The original (decimated) stroke points.
-     * @return A denser point sequence following a smooth curve through the originals.
+     * @brief Rebuild the spatial index from m_strokes if it is dirty. O(n).
+     */
+    void ensureSpatialIndex() const {
+        if (!m_spatialIndexDirty) return;
+        m_spatialIndex.clear();
+        m_strokeIndexById.clear();
+        m_strokeIndexById.reserve(static_cast<int>(m_strokes.size()));
+        for (int i = 0; i < m_strokes.size(); ++i) {
+            m_spatialIndex.insert(i, m_strokes[i].boundingBox);
+            m_strokeIndexById.insert(m_strokes[i].id, i);
+        }
+        m_duplicateStrokeIds = m_strokeIndexById.size() != m_strokes.size();
+        m_spatialIndexDirty = false;
+    }
+    
+    /**
+     * @brief Add the last stroke of m_strokes to a valid spatial index.
+     */
+    void indexAppendedStroke() {
+        if (m_spatialIndexDirty) return;  // Rebuilt on demand anyway
+        const int i = static_cast<int>(m_strokes.size()) - 1;
+        m_spatialIndex.insert(i, m_strokes[i].boundingBox);
+        m_duplicateStrokeIds |= m_strokeIndexById.contains(m_strokes[i].id);
+        m_strokeIndexById.insert(m_strokes[i].id, i);
+    }
+    
+    /**
+     * @brief Update the spatial index after strokes were removed from m_strokes.
+     * @param indices Removed indices (ascending, pre-removal numbering).
+     * @param bounds Bounding boxes of the removed strokes.
+     * @param ids IDs of the removed strokes.
      * 
-     * Interpolates both position and pressure. Endpoint tangents are computed
-     * by duplicating the first/last control point (zero-acceleration boundary).
-     * Interpolated pressure is clamped to [0.1, 1.0] to prevent overshoot.
+     * Only strokes behind the first removed one move, so the ID hash is
+     * renumbered from there (nothing when erasing the newest strokes). If
+     * an ID is shared by several strokes, dropping it could orphan a
+     * survivor; the index is then rebuilt on the next query instead.
      */
-    static QVector<StrokePoint> catmullRomSubdivide(const QVector<StrokePoint>& points) {
-        const int n = static_cast<int>(points.size());
-        if (n < 3) return points;  // Straight lines don't benefit from smoothing
-        
-        QVector<StrokePoint> result;
-        result.reserve((n - 1) * CURVE_SUBDIVISIONS + 1);
-        
-        for (int i = 0; i < n - 1; ++i) {
-            // Four control points: P0, P1, P2, P3
-            // Clamp at boundaries (duplicate endpoint)
-            const StrokePoint& p0 = points[qMax(0, i - 1)];
-            const StrokePoint& p1 = points[i];
-            const StrokePoint& p2 = points[i + 1];
-            const StrokePoint& p3 = points[qMin(n - 1, i + 2)];
-            
-            // Include start point of the first segment
-            if (i == 0) {
-                result.append(p1);
-            }
-            
-            // Interpolate CURVE_SUBDIVISIONS points between p1 and p2
-            for (int s = 1; s <= CURVE_SUBDIVISIONS; ++s) {
-                qreal t = static_cast<qreal>(s) / CURVE_SUBDIVISIONS;
-                qreal t2 = t * t;
-                qreal t3 = t2 * t;
-                
-                // Uniform Catmull-Rom: q(t) = 0.5 * [ (2·P1) + (-P0+P2)·t
-                //   + (2·P0 - 5·P1 + 4·P2 - P3)·t² + (-P0 + 3·P1 - 3·P2 + P3)·t³ ]
-                qreal x = 0.5 * (2.0 * p1.pos.x()
-                    + (-p0.pos.x() + p2.pos.x()) * t
-                    + (2.0 * p0.pos.x() - 5.0 * p1.pos.x() + 4.0 * p2.pos.x() - p3.pos.x()) * t2
-                    + (-p0.pos.x() + 3.0 * p1.pos.x() - 3.0 * p2.pos.x() + p3.pos.x()) * t3);
-                qreal y = 0.5 * (2.0 * p1.pos.y()
-                    + (-p0.pos.y() + p2.pos.y()) * t
-                    + (2.0 * p0.pos.y() - 5.0 * p1.pos.y() + 4.0 * p2.pos.y() - p3.pos.y()) * t2
-                    + (-p0.pos.y() + 3.0 * p1.pos.y() - 3.0 * p2.pos.y() + p3.pos.y()) * t3);
-                qreal pr = 0.5 * (2.0 * p1.pressure
-                    + (-p0.pressure + p2.pressure) * t
-                    + (2.0 * p0.pressure - 5.0 * p1.pressure + 4.0 * p2.pressure - p3.pressure) * t2
-                    + (-p0.pressure + 3.0 * p1.pressure - 3.0 * p2.pressure + p3.pressure) * t3);
-                
-                StrokePoint pt;
-                pt.pos = QPointF(x, y);
-                pt.pressure = qBound(0.1, pr, 1.0);
-                result.append(pt);
-            }
+    void unindexRemovedStrokes(const QVector<int>& indices,
+                               const QVector<QRectF>& bounds,
+                               const QVector<Id128>& ids) {
+        if (m_spatialIndexDirty) return;
+        if (m_duplicateStrokeIds) {
+            invalidateSpatialIndex();
+            return;
+        }
+        m_spatialIndex.removeIndices(indices, bounds);
+        for (const Id128& id : ids) {
+            m_strokeIndexById.remove(id);
+        }
+        for (int i = indices.first(); i < m_strokes.size(); ++i) {
+            m_strokeIndexById[m_strokes[i].id] = i;
         }
-        
-        return result;
     }
     
+    // ===== Curve Smoothing =====
+    
+    /// Number of interpolated points to insert between each pair of stored points.
+    /// Higher values produce smoother curves at high zoom, at the cost of more
+    /// polygon vertices (which are cached, so the per-frame cost is zero).
+    /// 4 subdivisions keeps segments under ~4 screen pixels at 10x zoom.
+    static constexpr int CURVE_SUBDIVISIONS = 4;
+    
     // Stroke cache for performance (Task 1.3.7 + Zoom-Aware + Incremental)
     mutable QPixmap m_strokeCache;          ///< Cached rendered strokes at current zoom
     mutable bool m_strokeCacheDirty = true; ///< Whether cache needs full rebuild
@@ -1128,10 +1295,8 @@ private:
         cachePainter.setClipRect(removedBounds);
         cachePainter.setRenderHint(QPainter::Antialiasing, true);
         
-        for (const auto& stroke : m_strokes) {
-            if (stroke.boundingBox.intersects(removedBounds)) {
-                renderStroke(cachePainter, stroke);
-            }
+        for (int i : strokeIndicesIntersecting(removedBounds)) {
+            renderStroke(cachePainter, m_strokes[i]);
         }
     }
     
@@ -1215,41 +1380,46 @@ private:
         QSize physicalSize = cappedPhysicalSize(size, zoom, dpr, divisor);
         qreal rawScale = zoom * dpr / divisor;
         
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        // Qt5: QPixmap::setDevicePixelRatio() breaks with values < 1.0.
-        // Use DPR = max(1.0, rawScale) and compensate with a painter scale()
-        // so strokes rasterize at the correct zoomed-out resolution with
-        // proper anti-aliasing (instead of rendering at page resolution and
-        // then downscaling the whole pixmap, which causes aliasing).
-        qreal cacheDpr = qMax(1.0, rawScale);
-#else
-        qreal cacheDpr = rawScale;
-#endif
-        
         m_strokeCache = QPixmap(physicalSize);
-        m_strokeCache.setDevicePixelRatio(cacheDpr);
+        m_strokeCache.setDevicePixelRatio(cacheDevicePixelRatio(rawScale));
         m_strokeCache.fill(Qt::transparent);
+        paintStrokeCache(m_strokeCache, rawScale);
         
+        m_strokeCacheDirty = false;
+        m_cacheZoom = zoom;
+        m_cacheDpr = dpr;
+        m_cacheDivisor = divisor;
+    }
+    
+    /**
+     * @brief Paint all strokes into a cleared stroke cache device.
+     * @param rawScale Physical pixels per page unit (zoom * dpr / divisor).
+     */
+    void paintStrokeCache(QPaintDevice& device, qreal rawScale) const {
         if (m_strokes.isEmpty()) {
-            m_strokeCacheDirty = false;
-            m_cacheZoom = zoom;
-            m_cacheDpr = dpr;
-            m_cacheDivisor = divisor;
             return;
         }
         
-        QPainter cachePainter(&m_strokeCache);
+        QPainter cachePainter(&device);
         cachePainter.setRenderHint(QPainter::Antialiasing, true);
         applyCachePainterScale(cachePainter, rawScale);
         
         for (const auto& stroke : m_strokes) {
             renderStroke(cachePainter, stroke);
         }
-        
-        m_strokeCacheDirty = false;
-        m_cacheZoom = zoom;
-        m_cacheDpr = dpr;
-        m_cacheDivisor = divisor;
+    }
+    
+    static qreal cacheDevicePixelRatio(qreal rawScale) {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        // Qt5: QPixmap::setDevicePixelRatio() breaks with values < 1.0.
+        // Use DPR = max(1.0, rawScale) and compensate with a painter scale()
+        // so strokes rasterize at the correct zoomed-out resolution with
+        // proper anti-aliasing (instead of rendering at page resolution and
+        // then downscaling the whole pixmap, which causes aliasing).
+        return qMax(1.0, rawScale);
+#else
+        return rawScale;
+#endif
     }
     
     static int computeCacheDivisor(const QSizeF& size, qreal zoom, qreal dpr) {
@@ -468,7 +468,7 @@ QColor OcrTextObject::dominantStrokeColor(const Page* page,
         if (!layer)
             continue;
         for (const auto& stroke : layer->strokes()) {
-            if (idSet.contains(stroke.id)) {
+            if (idSet.contains(stroke.id.toString())) {
                 QRgb rgb = stroke.color.rgb();
                 colorCounts[rgb]++;
             }
@@ -504,7 +504,7 @@ int OcrTextObject::resolveLayerAffinity(const Page* page,
         if (!layer) continue;
         int count = 0;
         for (const auto& stroke : layer->strokes()) {
-            if (idSet.contains(stroke.id))
+            if (idSet.contains(stroke.id.toString()))
                 ++count;
         }
         if (count > bestCount) {
@@ -1,4 +1,5 @@
 #include "OcrEngine.h"
+#include "../strokes/VectorStroke.h"
 
 #ifdef SPEEDYNOTE_HAS_WINDOWS_INK
 #include "engines/WindowsInkOcrEngine.h"
@@ -48,3 +49,17 @@ std::unique_ptr<OcrEngine> OcrEngine::createBest()
 #endif
     return nullptr;
 }
+
+QVector<QVector<OcrEngine::Result>> OcrEngine::analyzeBatch(
+    const QVector<QVector<VectorStroke>>& strokeSets)
+{
+    QVector<QVector<Result>> results;
+    results.reserve(strokeSets.size());
+    for (const auto& strokes : strokeSets) {
+        clearStrokes();
+        addStrokes(strokes);
+        results.append(analyze());
+    }
+    clearStrokes();
+    return results;
+}
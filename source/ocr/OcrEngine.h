@@ -14,6 +14,7 @@
 #include <QStringList>
 #include <QVector>
 #include <QRectF>
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -30,6 +31,11 @@ public:
     using StatusCallback = std::function<void(const QString&)>;
     void setStatusCallback(StatusCallback cb) { m_statusCallback = std::move(cb); }
 
+    // Optional cancellation flag, owned by the caller (the worker's cancel
+    // state). Long-running engines poll it between units of work and return
+    // early; the caller discards whatever a cancelled call returns.
+    void setCancelFlag(const std::atomic<bool>* flag) { m_cancelFlag = flag; }
+
     virtual QString engineId() const = 0;
 
     virtual bool isAvailable() const = 0;
@@ -68,6 +74,36 @@ public:
 
     virtual QVector<Result> analyze() = 0;
 
+    /**
+     * @brief Recognize several independent stroke sets in one call.
+     *
+     * Each set is analyzed as if it were the whole stroke buffer (pages of a
+     * batch scan, snap groups of a page); result i belongs to strokeSets[i].
+     * Replaces the stroke buffer and leaves it empty on return, so callers
+     * must not mix this with incremental add/remove bookkeeping. The default
+     * runs clear/add/analyze per set; raster engines override it to run all
+     * sets' line strips through the recognizer together.
+     */
+    virtual QVector<QVector<Result>> analyzeBatch(const QVector<QVector<VectorStroke>>& strokeSets);
+
+    /// Tuning for engines that run a neural recognizer in-process. Zero
+    /// means "engine default". Engines backed by an OS service ignore the
+    /// inference fields; prepareThreads applies to every raster engine and
+    /// to OcrWorker's batch planning (0 = one thread per core).
+    struct InferenceOptions {
+        int maxBatchSize = 0;    ///< max line strips per inference call (a memory cap may split further)
+        int intraOpThreads = 0;  ///< threads used inside one operator
+        int interOpThreads = 0;  ///< independent operators run concurrently
+        int prepareThreads = 0;  ///< threads grouping/rasterizing lines; 1 = sequential
+    };
+    virtual void setInferenceOptions(const InferenceOptions& options) { m_inferenceOptions = options; }
+    const InferenceOptions& inferenceOptions() const { return m_inferenceOptions; }
+
+    /// Persist recognized lines in @p path so unchanged ink is not
+    /// recognized again after a restart. Empty disables it (the default).
+    /// Engines without a result cache ignore it.
+    virtual void setPersistentCachePath(const QString& path) { Q_UNUSED(path); }
+
     static std::unique_ptr<OcrEngine> createBest();
 
 protected:
@@ -76,7 +112,11 @@ protected:
         if (m_statusCallback)
             m_statusCallback(message);
     }
+    bool isCancelled() const { return m_cancelFlag && m_cancelFlag->load(); }
+
+    InferenceOptions m_inferenceOptions;
 
 private:
     StatusCallback m_statusCallback;
+    const std::atomic<bool>* m_cancelFlag = nullptr;
 };
@@ -19,18 +19,28 @@
 //     with a GENERATED note (re-run to actually compare).
 //   - To force-regenerate existing baselines:  SPEEDYNOTE_GEN_GOLDEN=1 speedynote --test-ocr-golden
 //
+// benchmarkOcrThroughput() reuses the same cases as an OCR corpus: it tiles
+// them into synthetic pages and reports recognized lines/sec through the best
+// available engine, one strip per inference call vs. batched per page vs.
+// batched across pages, and a re-run answered by the persistent line cache.
+//
 // Run with:  speedynote --test-ocr-golden   (debug, non-mobile builds only)
+//            speedynote --bench-ocr
 // ============================================================================
 
+#include "OcrEngine.h"
+#include "OcrLineGrouper.h"
 #include "OcrStrokeRasterizer.h"
 #include "../strokes/VectorStroke.h"
 
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QImage>
 #include <QPointF>
 #include <QString>
+#include <QTemporaryDir>
 #include <QVector>
 
 #include <cmath>
@@ -51,7 +61,7 @@ struct GoldenCase {
 inline VectorStroke makeStroke(const QString& id, const QVector<QPointF>& pts)
 {
     VectorStroke s;
-    s.id = id;
+    s.id = Id128::fromString(id);
     s.baseThickness = 3.0;
     for (const QPointF& p : pts)
         s.points.append({p, 0.5});
@@ -197,4 +207,130 @@ inline bool runAllTests()
     return allPass;
 }
 
+// ----------------------------------------------------------------------------
+// Benchmark: OCR throughput on pages tiled from the golden cases.
+// ----------------------------------------------------------------------------
+
+/// A page of @p lines text lines, each the golden cases side by side,
+/// vertically centered on the line so the grouper sees one line per row.
+inline QVector<VectorStroke> makeBenchPage(int page, int lines)
+{
+    constexpr qreal kLinePitch = 150.0;
+    constexpr qreal kCaseGap = 30.0;
+
+    const QVector<GoldenCase> cases = goldenCases();
+    QVector<VectorStroke> strokes;
+    for (int line = 0; line < lines; ++line) {
+        const qreal centerY = 100.0 + line * kLinePitch;
+        qreal x = 40.0;
+        for (int c = 0; c < cases.size(); ++c) {
+            QRectF bounds;
+            for (const VectorStroke& s : cases[c].strokes)
+                bounds = bounds.isNull() ? s.boundingBox : bounds.united(s.boundingBox);
+            const QPointF offset(x - bounds.left(), centerY - bounds.center().y());
+
+            for (int k = 0; k < cases[c].strokes.size(); ++k) {
+                QVector<QPointF> pts;
+                for (const auto& pt : cases[c].strokes[k].points)
+                    pts.append(pt.pos + offset);
+                strokes.append(makeStroke(
+                    QStringLiteral("p%1l%2c%3s%4").arg(page).arg(line).arg(c).arg(k), pts));
+            }
+            x += bounds.width() + kCaseGap;
+        }
+    }
+    return strokes;
+}
+
+inline bool benchmarkOcrThroughput(int pageCount = 24, int linesPerPage = 20)
+{
+    qDebug() << "=== Benchmark: OCR lines/sec (golden corpus) ===";
+
+    std::unique_ptr<OcrEngine> engine = OcrEngine::createBest();
+    if (!engine || !engine->isAvailable()) {
+        qDebug() << "SKIP: no OCR engine available on this build/machine";
+        return true;
+    }
+
+    QVector<QVector<VectorStroke>> pages;
+    int lineCount = 0;
+    for (int p = 0; p < pageCount; ++p) {
+        pages.append(makeBenchPage(p, linesPerPage));
+        for (const auto& line : groupStrokesIntoLines(pages.last()))
+            lineCount += splitLineByHorizontalGaps(line, pages.last()).size();
+    }
+    qDebug() << "Engine:" << engine->engineId() << "-" << pageCount << "pages,"
+             << lineCount << "line strips";
+
+    // Warm-up: model load / on-demand download must not count.
+    engine->addStrokes(pages.first());
+    engine->analyze();
+    engine->clearStrokes();
+
+    auto report = [&](const char* label, qint64 ms, int recognized) {
+        qDebug().noquote() << QStringLiteral("  %1 %2 lines/sec (%3 ms, %4 lines with text)")
+                                  .arg(QString::fromLatin1(label), -26)
+                                  .arg(lineCount * 1000.0 / qMax<qint64>(1, ms), 0, 'f', 1)
+                                  .arg(ms)
+                                  .arg(recognized);
+    };
+
+    auto runPerPage = [&]() {
+        int recognized = 0;
+        for (const auto& page : pages) {
+            engine->clearStrokes();
+            engine->addStrokes(page);
+            recognized += engine->analyze().size();
+        }
+        engine->clearStrokes();
+        return recognized;
+    };
+
+    QElapsedTimer timer;
+
+    OcrEngine::InferenceOptions single = engine->inferenceOptions();
+    single.maxBatchSize = 1;
+    const OcrEngine::InferenceOptions defaults = engine->inferenceOptions();
+
+    engine->setInferenceOptions(single);
+    timer.start();
+    const int unbatched = runPerPage();
+    report("one strip per call:", timer.elapsed(), unbatched);
+
+    engine->setInferenceOptions(defaults);
+    timer.restart();
+    const int perPage = runPerPage();
+    report("batched per page:", timer.elapsed(), perPage);
+
+    constexpr int kPagesPerCall = 8;
+    timer.restart();
+    int crossPage = 0;
+    for (int first = 0; first < pages.size(); first += kPagesPerCall) {
+        for (const auto& results : engine->analyzeBatch(pages.mid(first, kPagesPerCall)))
+            crossPage += results.size();
+    }
+    report("batched across pages:", timer.elapsed(), crossPage);
+
+    // Re-OCR of an unchanged notebook: first pass fills the cache, the timed
+    // one must not touch the recognizer.
+    int cached = -1;
+    QTemporaryDir cacheDir;
+    if (cacheDir.isValid()) {
+        engine->setPersistentCachePath(cacheDir.filePath(QStringLiteral("lines.snoc")));
+        runPerPage();
+        timer.restart();
+        cached = runPerPage();
+        report("persistent cache re-run:", timer.elapsed(), cached);
+        engine->setPersistentCachePath(QString());
+    }
+
+    // Batching must not change what gets recognized (line counts, at least;
+    // padding may legitimately shift a character on the odd line).
+    const bool ok = unbatched == perPage && perPage == crossPage
+                 && (cached < 0 || cached == perPage);
+    qDebug() << (ok ? "PASS" : "FAIL") << "- recognized line counts"
+             << unbatched << perPage << crossPage << cached;
+    return ok;
+}
+
 } // namespace OcrGoldenTests
@@ -0,0 +1,376 @@
+// ============================================================================
+// OcrLineCache - Implementation
+// ============================================================================
+//
+// Layout (all integers little-endian):
+//
+//   Header   char[4] "SNOC" | u16 version | u16 reserved | u64 reserved
+//   Records  back to back, each:
+//            u64 key | u32 payloadSize | u32 checksum (low half of the
+//            FNV-1a of the payload) | payload
+//   Payload  QDataStream (Qt 5.12 format) of one OcrEngine::Result
+//
+// Records are only ever appended. A scan stops at the first record that runs
+// past the end of the file or fails its checksum (a crash mid-append); the
+// next flush() then rewrites the file instead of appending behind the tear.
+// ============================================================================
+
+#include "OcrLineCache.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'N', 'O', 'C'};
+constexpr int kHeaderSize = 16;
+constexpr int kRecordHeaderSize = 16;
+
+template <typename T>
+void appendLE(QByteArray& buf, T v)
+{
+    char b[sizeof(T)];
+    qToLittleEndian(v, b);
+    buf.append(b, sizeof(T));
+}
+
+template <typename T>
+T readLE(const uchar* p)
+{
+    return qFromLittleEndian<T>(p);
+}
+
+constexpr quint64 kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+constexpr quint64 kFnvPrime       = 0x100000001b3ULL;
+
+void fnvBytes(quint64& h, const void* data, qint64 size)
+{
+    const uchar* p = static_cast<const uchar*>(data);
+    for (qint64 i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= kFnvPrime;
+    }
+}
+
+void fnvString(quint64& h, const QString& s)
+{
+    fnvBytes(h, s.constData(), qint64(s.size()) * qint64(sizeof(QChar)));
+    const quint32 len = quint32(s.size());
+    fnvBytes(h, &len, sizeof(len)); // length-terminated: "ab"+"c" != "a"+"bc"
+}
+
+quint32 payloadChecksum(const char* data, qint64 size)
+{
+    quint64 h = kFnvOffsetBasis;
+    fnvBytes(h, data, size);
+    return quint32(h);
+}
+
+QByteArray makeHeader()
+{
+    QByteArray header;
+    header.reserve(kHeaderSize);
+    header.append(kMagic, 4);
+    appendLE<quint16>(header, OcrLineCache::FORMAT_VERSION);
+    appendLE<quint16>(header, 0);
+    appendLE<quint64>(header, 0);
+    return header;
+}
+
+void appendRecord(QByteArray& buf, quint64 key, const QByteArray& payload)
+{
+    appendLE<quint64>(buf, key);
+    appendLE<quint32>(buf, quint32(payload.size()));
+    appendLE<quint32>(buf, payloadChecksum(payload.constData(), payload.size()));
+    buf.append(payload);
+}
+
+QByteArray encodeResult(const OcrEngine::Result& r)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << r.text << r.boundingRect << r.confidence << r.sourceStrokeIds;
+    out << qint32(r.wordSegments.size());
+    for (const auto& ws : r.wordSegments)
+        out << ws.text << ws.boundingRect << ws.charBoundingBoxes;
+    return data;
+}
+
+bool decodeResult(const QByteArray& data, OcrEngine::Result& r)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_12);
+    r = OcrEngine::Result();
+    in >> r.text >> r.boundingRect >> r.confidence >> r.sourceStrokeIds;
+    qint32 count = 0;
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 0)
+        return false;
+    for (qint32 i = 0; i < count; ++i) {
+        OcrEngine::Result::WordSegment ws;
+        in >> ws.text >> ws.boundingRect >> ws.charBoundingBoxes;
+        if (in.status() != QDataStream::Ok)
+            return false;
+        r.wordSegments.append(ws);
+    }
+    return true;
+}
+
+} // namespace
+
+OcrLineCache::OcrLineCache(const QString& path, qint64 budgetBytes)
+    : m_path(path)
+    , m_budget(budgetBytes)
+{
+    load();
+}
+
+OcrLineCache::~OcrLineCache()
+{
+    flush();
+    unmap();
+}
+
+// ----------------------------------------------------------------------------
+// Keys
+// ----------------------------------------------------------------------------
+
+quint64 OcrLineCache::recognizerKey(const QString& engineId, const QByteArray& modelFingerprint,
+                                    const QString& languageTag, int stripHeightPx)
+{
+    quint64 h = kFnvOffsetBasis;
+    fnvString(h, engineId);
+    fnvBytes(h, modelFingerprint.constData(), modelFingerprint.size());
+    const quint32 fpLen = quint32(modelFingerprint.size());
+    fnvBytes(h, &fpLen, sizeof(fpLen));
+    fnvString(h, languageTag);
+    const qint32 height = stripHeightPx;
+    fnvBytes(h, &height, sizeof(height));
+    return h;
+}
+
+quint64 OcrLineCache::lineKey(quint64 recognizerKey, quint64 lineSignature)
+{
+    quint64 h = recognizerKey;
+    fnvBytes(h, &lineSignature, sizeof(lineSignature));
+    return h;
+}
+
+// ----------------------------------------------------------------------------
+// Lookup / insert
+// ----------------------------------------------------------------------------
+
+int OcrLineCache::entryCount() const
+{
+    int count = m_index.size();
+    for (auto it = m_pending.constBegin(); it != m_pending.constEnd(); ++it) {
+        if (!m_index.contains(it.key()))
+            ++count;
+    }
+    return count;
+}
+
+bool OcrLineCache::find(quint64 key, OcrEngine::Result& out)
+{
+    auto pending = m_pending.constFind(key);
+    if (pending != m_pending.constEnd())
+        return decodeResult(pending.value(), out);
+
+    auto it = m_index.constFind(key);
+    if (it == m_index.constEnd() || !m_data)
+        return false;
+
+    // Records were checksummed by load(); only the decode can still fail
+    // (e.g. a payload written by a future format).
+    const QByteArray payload = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(m_data + it->offset), int(it->size));
+    if (!decodeResult(payload, out))
+        return false;
+    m_used.insert(key);
+    return true;
+}
+
+void OcrLineCache::insert(quint64 key, const OcrEngine::Result& result)
+{
+    if (!m_pending.contains(key))
+        m_pendingOrder.append(key);
+    m_pending.insert(key, encodeResult(result));
+}
+
+// ----------------------------------------------------------------------------
+// Writing
+// ----------------------------------------------------------------------------
+
+bool OcrLineCache::flush()
+{
+    if (m_pending.isEmpty())
+        return true;
+
+    QByteArray tail;
+    for (quint64 key : std::as_const(m_pendingOrder))
+        appendRecord(tail, key, m_pending.value(key));
+
+    // Append only behind an intact file that stays within budget and that no
+    // other process has grown since load() (its records would be unindexed
+    // but harmless; a torn tail would hide ours from the next scan).
+    const bool canAppend = m_intact && m_size + tail.size() <= m_budget
+                        && QFileInfo(m_path).size() == m_size;
+    if (!canAppend)
+        return rewrite();
+
+    unmap();
+    QFile file(m_path);
+    const bool ok = file.open(QIODevice::ReadWrite) && file.seek(file.size())
+                 && file.write(tail) == tail.size();
+    file.close();
+
+    // Dropped on failure too, like rewrite(): a cache that cannot be written
+    // must not keep growing in memory. A short write leaves a torn tail that
+    // load() notices.
+    m_pending.clear();
+    m_pendingOrder.clear();
+    load();
+    return ok;
+}
+
+bool OcrLineCache::rewrite()
+{
+    struct Entry {
+        quint64 key;
+        QByteArray payload;
+    };
+
+    // Entries that earned their place this session first (pending, then
+    // those hit on disk), then the rest newest-first.
+    QVector<Entry> order;
+    order.reserve(m_pending.size() + m_index.size());
+    for (quint64 key : std::as_const(m_pendingOrder))
+        order.append({key, m_pending.value(key)});
+
+    QVector<QPair<qint64, quint64>> rest; // (offset, key)
+    for (auto it = m_index.constBegin(); it != m_index.constEnd(); ++it) {
+        if (m_pending.contains(it.key()))
+            continue;
+        if (m_used.contains(it.key())) {
+            order.append({it.key(), QByteArray(reinterpret_cast<const char*>(m_data + it->offset),
+                                               int(it->size))});
+        } else {
+            rest.append({it->offset, it.key()});
+        }
+    }
+    std::sort(rest.begin(), rest.end(),
+              [](const QPair<qint64, quint64>& a, const QPair<qint64, quint64>& b) {
+                  return a.first > b.first;
+              });
+    for (const auto& r : std::as_const(rest)) {
+        const Location loc = m_index.value(r.second);
+        order.append({r.second, QByteArray(reinterpret_cast<const char*>(m_data + loc.offset),
+                                           int(loc.size))});
+    }
+
+    const qint64 target = m_budget - m_budget / 4;
+    QByteArray contents = makeHeader();
+    for (const Entry& e : std::as_const(order)) {
+        const qint64 recordSize = kRecordHeaderSize + e.payload.size();
+        if (contents.size() + recordSize > target)
+            continue; // smaller, older entries may still fit
+        appendRecord(contents, e.key, e.payload);
+    }
+
+    unmap();
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile file(m_path);
+    bool ok = file.open(QIODevice::WriteOnly);
+    if (ok && file.write(contents) != contents.size()) {
+        file.cancelWriting();
+        ok = false;
+    }
+    ok = ok && file.commit();
+
+    // Pending entries are dropped either way: the cache must not grow
+    // without bound in memory when the disk refuses writes.
+    m_pending.clear();
+    m_pendingOrder.clear();
+    m_used.clear();
+    load();
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+// Reading
+// ----------------------------------------------------------------------------
+
+void OcrLineCache::load()
+{
+    unmap();
+    m_index.clear();
+    m_intact = false;
+
+    m_file.setFileName(m_path);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return;
+    const qint64 size = m_file.size();
+    if (size < kHeaderSize) {
+        unmap();
+        return;
+    }
+
+    // Same approach as ThumbnailStore::open(): map when the platform allows,
+    // otherwise keep one contiguous copy.
+    m_mapped = m_file.map(0, size);
+    if (m_mapped) {
+        m_data = m_mapped;
+    } else {
+        m_buffer = m_file.readAll();
+        m_file.close();
+        if (m_buffer.size() != size) {
+            unmap();
+            return;
+        }
+        m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+    }
+    m_size = size;
+
+    if (std::memcmp(m_data, kMagic, 4) != 0
+        || readLE<quint16>(m_data + 4) != FORMAT_VERSION) {
+        unmap(); // foreign or older file; rewritten by the next flush()
+        return;
+    }
+
+    qint64 offset = kHeaderSize;
+    while (offset + kRecordHeaderSize <= size) {
+        const uchar* r = m_data + offset;
+        const quint64 key = readLE<quint64>(r);
+        const quint32 payloadSize = readLE<quint32>(r + 8);
+        const qint64 payloadOffset = offset + kRecordHeaderSize;
+        if (payloadSize > quint32(size - payloadOffset))
+            break;
+        if (payloadChecksum(reinterpret_cast<const char*>(m_data + payloadOffset), payloadSize)
+            != readLE<quint32>(r + 12))
+            break;
+        m_index.insert(key, Location{payloadOffset, payloadSize});
+        offset = payloadOffset + payloadSize;
+    }
+    m_intact = (offset == size);
+}
+
+void OcrLineCache::unmap()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if (m_file.isOpen())
+        m_file.close();
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+// ============================================================================
+// OcrLineCache - Persistent, size-bounded cache of recognized OCR lines
+// ============================================================================
+// RasterOcrEngine's in-memory line cache lives only as long as the engine and
+// is emptied by every clearStrokes(), so re-running OCR on an unchanged
+// notebook used to re-render and re-recognize every line. This cache keeps
+// recognized lines on disk, content-addressed by the line signature (stroke
+// ids + quantized geometry, see RasterOcrEngine.cpp) combined with the
+// recognizer identity: engine id, model fingerprint, language tag and strip
+// height. A change to any of them is simply a miss.
+//
+// The file is an append-only log of checksummed records; a key written twice
+// resolves to its last record. Once the file outgrows its budget it is
+// rewritten, keeping the entries used or added this session first and then
+// the newest others, down to three quarters of the budget. It is a cache:
+// a torn or foreign file is dropped and rebuilt on the next flush().
+//
+// Owned by one engine on the OCR worker thread; not thread-safe.
+// ============================================================================
+
+#include "OcrEngine.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class OcrLineCache {
+public:
+    /// File format version stored in the header.
+    static constexpr quint16 FORMAT_VERSION = 1;
+    /// Default size bound of the cache file.
+    static constexpr qint64 DEFAULT_BUDGET_BYTES = 32LL * 1024 * 1024;
+
+    explicit OcrLineCache(const QString& path, qint64 budgetBytes = DEFAULT_BUDGET_BYTES);
+    /// Flushes pending entries.
+    ~OcrLineCache();
+
+    OcrLineCache(const OcrLineCache&) = delete;
+    OcrLineCache& operator=(const OcrLineCache&) = delete;
+
+    /// Hash of everything except the line itself that decides its recognition.
+    static quint64 recognizerKey(const QString& engineId, const QByteArray& modelFingerprint,
+                                 const QString& languageTag, int stripHeightPx);
+    /// Cache key of one line (its signature) under a recognizerKey().
+    static quint64 lineKey(quint64 recognizerKey, quint64 lineSignature);
+
+    /**
+     * @brief Look up @p key.
+     * @return true on a hit. A hit with empty text records a line that was
+     *         recognized as blank (scribbles, drawings), so it is not retried.
+     */
+    bool find(quint64 key, OcrEngine::Result& out);
+
+    /// Remember @p result for @p key; written by the next flush().
+    void insert(quint64 key, const OcrEngine::Result& result);
+
+    /// Append the entries inserted since the last flush, compacting the file
+    /// when it would exceed the budget. Returns false on an I/O error.
+    bool flush();
+
+    QString path() const { return m_path; }
+    /// Distinct keys on disk plus pending ones.
+    int entryCount() const;
+
+private:
+    struct Location {
+        qint64 offset = 0;   ///< payload offset in the file
+        quint32 size = 0;    ///< payload size
+    };
+
+    /// (Re)read the file: map it and index every intact record.
+    void load();
+    void unmap();
+    /// Rewrite the file within budget from the on-disk and pending entries.
+    bool rewrite();
+
+    QString m_path;
+    qint64 m_budget;
+
+    QFile m_file;
+    QByteArray m_buffer;             ///< Backing store when mapping is unavailable
+    const uchar* m_data = nullptr;   ///< Start of the file contents
+    uchar* m_mapped = nullptr;       ///< Mapping to release in unmap()
+    qint64 m_size = 0;               ///< Bytes covered by m_data
+    bool m_intact = false;           ///< Header valid and no torn tail
+
+    QHash<quint64, Location> m_index;       ///< on-disk entries
+    QHash<quint64, QByteArray> m_pending;   ///< encoded, not yet written
+    QVector<quint64> m_pendingOrder;        ///< insertion order of m_pending
+    QSet<quint64> m_used;                   ///< on-disk keys hit this session
+};
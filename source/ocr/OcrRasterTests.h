@@ -6,13 +6,15 @@
 // Header-only, runnable on any desktop OS before a real backend exists. Uses a
 // StubRasterOcrEngine whose recognizeImage() returns a fixed string with
 // evenly-spaced synthetic per-character boxes spanning the strip, so the whole
-// pipeline (grouping, rasterization, line-signature cache, transform inverse,
-// segment assembly, serialization) is exercised deterministically.
+// pipeline (grouping, rasterization, line-signature cache, batched
+// recognition, transform inverse, segment assembly, serialization) is
+// exercised deterministically.
 //
 // Run with:  speedynote --test-ocr-raster   (debug, non-mobile builds only)
 // ============================================================================
 
 #include "engines/RasterOcrEngine.h"
+#include "OcrLineCache.h"
 #include "OcrStrokeRasterizer.h"
 #include "OcrTextBlock.h"
 #include "../strokes/VectorStroke.h"
@@ -22,8 +24,10 @@
 #include <QPointF>
 #include <QRectF>
 #include <QString>
+#include <QTemporaryDir>
 #include <QVector>
 
+#include <atomic>
 #include <cmath>
 
 namespace OcrRasterTests {
@@ -36,6 +40,7 @@ public:
     QString text = QStringLiteral("ab"); ///< text returned per strip
     bool emitCharBoxes = true;           ///< when false, return text only
     int recognizeCalls = 0;              ///< number of recognizeImage() calls
+    int batchCalls = 0;                  ///< number of recognizeImages() calls
 
     QString engineId() const override { return QStringLiteral("stub_raster"); }
     bool isAvailable() const override { return true; }
@@ -55,6 +60,13 @@ protected:
         }
         return rec;
     }
+
+    QVector<ImageRecognition> recognizeImages(const QVector<QImage>& strips,
+                                              const QString& lang) override
+    {
+        ++batchCalls;
+        return RasterOcrEngine::recognizeImages(strips, lang);
+    }
 };
 
 inline bool nearlyEqual(qreal a, qreal b, qreal eps = 0.5)
@@ -66,7 +78,7 @@ inline VectorStroke makeLineStroke(const QString& id, qreal x0, qreal y0,
                                    qreal x1, qreal y1)
 {
     VectorStroke s;
-    s.id = id;
+    s.id = Id128::fromString(id);
     s.baseThickness = 3.0;
     s.points.append({QPointF(x0, y0), 0.5});
     s.points.append({QPointF((x0 + x1) / 2.0, (y0 + y1) / 2.0), 0.5});
@@ -189,6 +201,170 @@ inline bool testCacheHitEvict()
     return ok;
 }
 
+// ----------------------------------------------------------------------------
+// Test: analyzeBatch recognizes every set's lines in one recognizer call and
+// scatters the results back to the set they came from.
+// ----------------------------------------------------------------------------
+inline bool testBatchScatter()
+{
+    qDebug() << "=== Test: Batch Scatter ===";
+    StubRasterOcrEngine engine;
+    engine.text = QStringLiteral("ok");
+    engine.addStrokes({makeLineStroke(QStringLiteral("stale"), 10, 10, 110, 12)});
+
+    const QVector<QVector<VectorStroke>> sets = {
+        {makeLineStroke(QStringLiteral("p0a"), 10, 10, 110, 12),
+         makeLineStroke(QStringLiteral("p0b"), 10, 200, 110, 202)},
+        {},
+        {makeLineStroke(QStringLiteral("p2a"), 10, 10, 110, 12)},
+    };
+    const auto results = engine.analyzeBatch(sets);
+
+    bool ok = results.size() == 3
+           && results[0].size() == 2 && results[1].isEmpty() && results[2].size() == 1;
+    ok = ok && engine.batchCalls == 1 && engine.recognizeCalls == 3;
+    if (ok) {
+        ok = results[0][0].sourceStrokeIds == QVector<QString>{sets[0][0].id.toString()}
+          && results[0][1].sourceStrokeIds == QVector<QString>{sets[0][1].id.toString()}
+          && results[2][0].sourceStrokeIds == QVector<QString>{sets[2][0].id.toString()};
+    }
+
+    // The batch replaced the stroke buffer and left it empty.
+    ok = ok && engine.analyze().isEmpty();
+
+    qDebug() << (ok ? "PASS" : "FAIL") << "- batch calls" << engine.batchCalls
+             << "recognizeCalls" << engine.recognizeCalls;
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+// Test: parallel line preparation gives exactly the sequential results, and a
+// raised cancel flag stops a batch before the recognizer runs.
+// ----------------------------------------------------------------------------
+inline bool testParallelPrepare()
+{
+    qDebug() << "=== Test: Parallel Prepare ===";
+
+    // 12 pages x 6 lines of 3 words, every stroke distinct.
+    QVector<QVector<VectorStroke>> sets;
+    for (int page = 0; page < 12; ++page) {
+        QVector<VectorStroke> strokes;
+        for (int line = 0; line < 6; ++line) {
+            for (int word = 0; word < 3; ++word) {
+                const qreal x = 10 + word * 150 + page;
+                const qreal y = 20 + line * 80;
+                strokes.append(makeLineStroke(
+                    QStringLiteral("p%1l%2w%3").arg(page).arg(line).arg(word),
+                    x, y, x + 90, y + 3));
+            }
+        }
+        sets.append(strokes);
+    }
+
+    auto run = [&](int prepareThreads) {
+        StubRasterOcrEngine engine;
+        OcrEngine::InferenceOptions options;
+        options.prepareThreads = prepareThreads;
+        engine.setInferenceOptions(options);
+        return engine.analyzeBatch(sets);
+    };
+    const auto sequential = run(1);
+    const auto parallel = run(4);
+
+    bool ok = sequential.size() == sets.size() && parallel.size() == sets.size();
+    int lines = 0;
+    for (int s = 0; ok && s < sets.size(); ++s) {
+        ok = !sequential[s].isEmpty() && sequential[s].size() == parallel[s].size();
+        for (int i = 0; ok && i < sequential[s].size(); ++i) {
+            const auto& a = sequential[s][i];
+            const auto& b = parallel[s][i];
+            ok = a.text == b.text && a.boundingRect == b.boundingRect
+              && a.sourceStrokeIds == b.sourceStrokeIds
+              && a.wordSegments.size() == b.wordSegments.size();
+            for (int w = 0; ok && w < a.wordSegments.size(); ++w)
+                ok = a.wordSegments[w].charBoundingBoxes == b.wordSegments[w].charBoundingBoxes;
+            ++lines;
+        }
+    }
+
+    std::atomic<bool> cancelled{true};
+    StubRasterOcrEngine engine;
+    engine.setCancelFlag(&cancelled);
+    const auto none = engine.analyzeBatch(sets);
+    ok = ok && none.size() == sets.size() && engine.batchCalls == 0;
+    for (const auto& r : none)
+        ok = ok && r.isEmpty();
+
+    qDebug() << (ok ? "PASS" : "FAIL") << "- lines compared" << lines
+             << "recognizer calls after cancel" << engine.batchCalls;
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+// Test: the persistent line cache answers a fresh engine (a restart), keeps
+// blank lines blank, and misses when the language changes.
+// ----------------------------------------------------------------------------
+inline bool testPersistentCache()
+{
+    qDebug() << "=== Test: Persistent Line Cache ===";
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL - could not create a temporary directory";
+        return false;
+    }
+    const QString path = dir.filePath(QStringLiteral("lines.snoc"));
+    const QVector<VectorStroke> ink = {
+        makeLineStroke(QStringLiteral("a"), 10, 10, 110, 12),
+        makeLineStroke(QStringLiteral("b"), 10, 200, 110, 202),
+    };
+
+    bool ok = true;
+    {
+        StubRasterOcrEngine engine;
+        engine.text = QStringLiteral("kept");
+        engine.setPersistentCachePath(path);
+        engine.addStrokes(ink);
+        ok = ok && engine.analyze().size() == 2 && engine.recognizeCalls == 2;
+    }
+    {
+        // "Restart": a new engine recognizes nothing and returns the same lines.
+        StubRasterOcrEngine engine;
+        engine.text = QStringLiteral("changed");
+        engine.setPersistentCachePath(path);
+        engine.addStrokes(ink);
+        const auto results = engine.analyze();
+        ok = ok && engine.recognizeCalls == 0 && results.size() == 2
+                && results[0].text == QStringLiteral("kept")
+                && results[0].wordSegments.size() == 1
+                && results[0].wordSegments[0].charBoundingBoxes.size() == 4;
+
+        // Another language is another recognizer.
+        engine.setLanguage(QStringLiteral("fr-FR"));
+        engine.analyze();
+        ok = ok && engine.recognizeCalls == 2;
+    }
+    {
+        // Lines recognized as blank are remembered as blank.
+        const QVector<VectorStroke> scribble = {
+            makeLineStroke(QStringLiteral("s"), 10, 400, 110, 402)};
+        StubRasterOcrEngine first;
+        first.text = QString();
+        first.setPersistentCachePath(path);
+        first.addStrokes(scribble);
+        ok = ok && first.analyze().isEmpty() && first.recognizeCalls == 1;
+        first.setPersistentCachePath(QString()); // flush + detach
+
+        StubRasterOcrEngine second;
+        second.setPersistentCachePath(path);
+        second.addStrokes(scribble);
+        ok = ok && second.analyze().isEmpty() && second.recognizeCalls == 0;
+    }
+    ok = ok && OcrLineCache(path).entryCount() == 5;
+
+    qDebug() << (ok ? "PASS" : "FAIL") << "- persistent line cache";
+    return ok;
+}
+
 // ----------------------------------------------------------------------------
 // Test: Latin words split on space; CJK emits one segment per glyph.
 // ----------------------------------------------------------------------------
@@ -495,6 +671,9 @@ inline bool runAllTests()
     allPass &= testRenderNormalization();
     allPass &= testTransformRoundTrip();
     allPass &= testCacheHitEvict();
+    allPass &= testBatchScatter();
+    allPass &= testParallelPrepare();
+    allPass &= testPersistentCache();
     allPass &= testSegmentAssembly();
     allPass &= testCharBoxJsonRoundTrip();
     allPass &= testFlattenBlockCharRects();
@@ -3,9 +3,16 @@
 #include "../strokes/VectorStroke.h"
 
 #include <QHash>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
 #include <QUuid>
+#include <QtConcurrent>
 #include <cmath>
 
+// Pages per OcrEngine::analyzeBatch() call in processBatch().
+static constexpr int kPagesPerBatch = 8;
+
 // Ensures the result has at least one wordSegment so OcrTextObject::render()
 // can take the snap-aware rendering path. Engines like ML Kit Digital Ink
 // return plain text with no per-word geometry; in snap mode the worker has
@@ -146,17 +153,24 @@ static OcrEngine::Result rerunPerCell(const StrokeLineGroup& group,
         byCol[col].append(s);
     }
 
-    QVector<OcrEngine::Result> cellResults;
-    cellResults.reserve(cellCount);
-
+    // One engine call for all occupied cells, so raster engines can batch them.
+    QVector<int> cellCols;
+    QVector<QVector<VectorStroke>> cellSets;
     for (int col = runStart; col <= runEnd; ++col) {
         auto it = byCol.constFind(col);
         if (it == byCol.constEnd() || it->isEmpty())
             continue;
+        cellCols.append(col);
+        cellSets.append(*it);
+    }
+    const QVector<QVector<OcrEngine::Result>> cellOutputs = engine->analyzeBatch(cellSets);
+
+    QVector<OcrEngine::Result> cellResults;
+    cellResults.reserve(cellCols.size());
 
-        engine->clearStrokes();
-        engine->addStrokes(*it);
-        auto r = engine->analyze();
+    for (int k = 0; k < cellCols.size() && k < cellOutputs.size(); ++k) {
+        const int col = cellCols[k];
+        const auto& r = cellOutputs[k];
         if (r.isEmpty())
             continue;
 
@@ -189,21 +203,24 @@ static OcrEngine::Result rerunPerCell(const StrokeLineGroup& group,
     return mergeChunkedGroup(std::move(cellResults), group.boundingRect, snap);
 }
 
-// Runs the full "recognize one snap group" pipeline: feed strokes to the
-// engine, merge multi-chunk output into a single Result with one WordSegment
-// per chunk, then in CJK grid mode fall back to per-cell recognition when
-// the recognized char count does not match the occupied cell count.
-//
-// Returns false when the group produced no usable result (engine returned
-// empty, or cancellation); callers should skip the group in that case.
-// Extracted from processPage/processBatch so future fixes only need to touch
-// one place. Keeps the per-group clearStrokes call out of the helper so the
-// caller owns engine state bookkeeping.
-static bool recognizeSnapGroup(OcrEngine* engine,
-                               const StrokeLineGroup& group,
-                               const QVector<VectorStroke>& filtered,
-                               const OcrSnapParams& snap,
-                               OcrEngine::Result& outMerged)
+// Snap-mode grouping shared by processPage and processBatch.
+static QVector<StrokeLineGroup> buildSnapGroups(const QVector<VectorStroke>& filtered,
+                                                const OcrSnapParams& snap)
+{
+    if (snap.cjkGridMode && snap.backgroundIsGrid) {
+        // Grid-cell snapping ONLY for CJK (snap.cjkGridMode is already gated
+        // on a CJK language in MainWindow::buildOcrSnapParams).
+        return groupStrokesByGridCells(filtered, snap.gridSpacing);
+    }
+    // Everything else (Latin on grid OR lines): line snapping by line
+    // spacing, regardless of the background style. Grid spacing is never
+    // used for non-CJK text.
+    return groupStrokesByLineBands(filtered, snap.lineSpacing);
+}
+
+// The strokes of one snap group, as the stroke set handed to analyzeBatch().
+static QVector<VectorStroke> snapGroupStrokes(const StrokeLineGroup& group,
+                                              const QVector<VectorStroke>& filtered)
 {
     QVector<VectorStroke> groupStrokes;
     groupStrokes.reserve(group.strokeIndices.size());
@@ -211,11 +228,26 @@ static bool recognizeSnapGroup(OcrEngine* engine,
         if (idx >= 0 && idx < filtered.size())
             groupStrokes.append(filtered[idx]);
     }
+    return groupStrokes;
+}
 
-    engine->clearStrokes();
-    engine->addStrokes(groupStrokes);
-    auto groupResults = engine->analyze();
-
+// Finishes the "recognize one snap group" pipeline once the engine has
+// analyzed the group's strokes (see snapGroupStrokes): merge multi-chunk
+// output into a single Result with one WordSegment per chunk, then in CJK
+// grid mode fall back to per-cell recognition when the recognized char count
+// does not match the occupied cell count.
+//
+// Returns false when the group produced no usable result; callers should skip
+// the group in that case. Shared by processPage/processBatch so future fixes
+// only need to touch one place. Recognition itself is left to the caller so
+// all groups of a page (or of several pages) go through one analyzeBatch().
+static bool finishSnapGroup(OcrEngine* engine,
+                            const StrokeLineGroup& group,
+                            const QVector<VectorStroke>& filtered,
+                            const OcrSnapParams& snap,
+                            QVector<OcrEngine::Result> groupResults,
+                            OcrEngine::Result& outMerged)
+{
     if (groupResults.size() == 1) {
         outMerged = std::move(groupResults[0]);
         outMerged.boundingRect = group.boundingRect;
@@ -260,6 +292,13 @@ OcrWorker::~OcrWorker() = default;
 void OcrWorker::setEngine(std::unique_ptr<OcrEngine> engine)
 {
     m_engine = std::move(engine);
+    if (m_engine)
+        m_engine->setCancelFlag(&m_cancelled);
+}
+
+void OcrWorker::setInferenceOptions(const OcrEngine::InferenceOptions& options)
+{
+    m_inferenceOptions = options;
 }
 
 bool OcrWorker::isEngineAvailable() const
@@ -287,6 +326,14 @@ void OcrWorker::initEngine()
         m_engine->setStatusCallback([this](const QString& message) {
             emit statusMessage(message);
         });
+        m_engine->setCancelFlag(&m_cancelled);
+        m_engine->setInferenceOptions(m_inferenceOptions);
+        // Recognized lines survive restarts, so re-scanning an unchanged
+        // notebook skips rasterization and inference (raster engines only).
+        const QString cacheDir =
+            QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (!cacheDir.isEmpty())
+            m_engine->setPersistentCachePath(cacheDir + QStringLiteral("/ocr/lines.snoc"));
     }
     bool ok = m_engine && m_engine->isAvailable();
     emit engineReady(ok);
@@ -360,41 +407,38 @@ void OcrWorker::processPage(const QString& pageId,
     QVector<VectorStroke> filtered;
     filtered.reserve(strokes.size());
     for (const auto& stroke : strokes) {
-        if (!suppressedStrokeIds.contains(stroke.id))
+        if (!suppressedStrokeIds.contains(stroke.id.toString()))
             filtered.append(stroke);
     }
 
     bool useSnap = snap.enabled && (snap.backgroundIsGrid || snap.backgroundIsLines);
 
     if (useSnap) {
-        QVector<StrokeLineGroup> groups;
-        if (snap.cjkGridMode && snap.backgroundIsGrid) {
-            // Grid-cell snapping ONLY for CJK (snap.cjkGridMode is already gated
-            // on a CJK language in MainWindow::buildOcrSnapParams).
-            groups = groupStrokesByGridCells(filtered, snap.gridSpacing);
-        } else {
-            // Everything else (Latin on grid OR lines): line snapping by line
-            // spacing, regardless of the background style. Grid spacing is never
-            // used for non-CJK text.
-            groups = groupStrokesByLineBands(filtered, snap.lineSpacing);
-        }
+        const QVector<StrokeLineGroup> groups = buildSnapGroups(filtered, snap);
+
+        QVector<QVector<VectorStroke>> groupSets;
+        groupSets.reserve(groups.size());
+        for (const auto& group : groups)
+            groupSets.append(snapGroupStrokes(group, filtered));
+        QVector<QVector<OcrEngine::Result>> groupResults = m_engine->analyzeBatch(groupSets);
 
         QVector<OcrEngine::Result> allResults;
 
-        for (const auto& group : groups) {
+        for (int g = 0; g < groups.size() && g < groupResults.size(); ++g) {
             if (m_cancelled) break;
 
             OcrEngine::Result merged;
-            if (recognizeSnapGroup(m_engine.get(), group, filtered, snap, merged))
+            if (finishSnapGroup(m_engine.get(), groups[g], filtered, snap,
+                                std::move(groupResults[g]), merged))
                 allResults.append(std::move(merged));
         }
 
         if (m_cancelled) { m_busy = false; return; }
 
-        m_lastPageId = pageId;
+        // analyzeBatch() leaves the engine empty, so there is no stroke state
+        // an incremental scan could diff against; force a full scan next time.
+        m_lastPageId.clear();
         m_knownStrokeIds.clear();
-        for (const auto& s : filtered)
-            m_knownStrokeIds.insert(s.id);
 
         m_busy = false;
         emit resultsReady(pageId, buildBlocks(allResults));
@@ -415,7 +459,7 @@ void OcrWorker::processPage(const QString& pageId,
         m_lastPageId = pageId;
         m_knownStrokeIds.clear();
         for (const auto& s : filtered)
-            m_knownStrokeIds.insert(s.id);
+            m_knownStrokeIds.insert(s.id.toString());
 
         m_busy = false;
         emit resultsReady(pageId, buildBlocks(results));
@@ -451,9 +495,10 @@ void OcrWorker::processPageIncremental(const QString& pageId,
     QSet<QString> currentIds;
     QHash<QString, const VectorStroke*> currentMap;
     for (const auto& stroke : strokes) {
-        if (!suppressedStrokeIds.contains(stroke.id)) {
-            currentIds.insert(stroke.id);
-            currentMap.insert(stroke.id, &stroke);
+        const QString strokeId = stroke.id.toString();
+        if (!suppressedStrokeIds.contains(strokeId)) {
+            currentIds.insert(strokeId);
+            currentMap.insert(strokeId, &stroke);
         }
     }
 
@@ -529,69 +574,143 @@ void OcrWorker::processBatch(const QVector<QString>& pageIds,
     m_busy = true;
     m_cancelled = false;
 
-    for (int i = 0; i < total; ++i) {
+    // Pages are recognized kPagesPerBatch at a time: every page contributes
+    // its filtered strokes (or, in snap mode, one stroke set per snap group)
+    // to a single analyzeBatch() call, which lets raster engines fill their
+    // inference batches across page boundaries. Cancellation is checked
+    // between chunks and while post-processing each page; the engine polls
+    // the same flag.
+    struct PagePlan {
+        QVector<VectorStroke> filtered;
+        OcrSnapParams snap;
+        bool useSnap = false;
+        QVector<StrokeLineGroup> groups;      ///< snap mode only
+        QVector<QVector<VectorStroke>> sets;  ///< this page's stroke sets
+        int firstSet = 0;                     ///< index of sets[0] in the chunk
+    };
+
+    // Filtering and snap grouping only read this call's arguments, so pages
+    // are planned independently. Pure function of the page index: the plans
+    // (and so the results) do not depend on which thread built them.
+    auto planPage = [&](int i) {
+        PagePlan plan;
         if (m_cancelled)
-            break;
+            return plan;
 
         const QSet<QString>& suppressed = (i < suppressedSets.size())
             ? suppressedSets[i] : emptySet;
-        const OcrSnapParams& snap = (i < snapParams.size())
-            ? snapParams[i] : defaultSnap;
+        plan.snap = (i < snapParams.size()) ? snapParams[i] : defaultSnap;
 
-        QVector<VectorStroke> filtered;
         const auto& strokes = strokeSets[i];
-        filtered.reserve(strokes.size());
+        plan.filtered.reserve(strokes.size());
         for (const auto& stroke : strokes) {
-            if (!suppressed.contains(stroke.id))
-                filtered.append(stroke);
+            if (!suppressed.contains(stroke.id.toString()))
+                plan.filtered.append(stroke);
         }
 
-        bool useSnap = snap.enabled && (snap.backgroundIsGrid || snap.backgroundIsLines);
+        plan.useSnap = plan.snap.enabled
+                    && (plan.snap.backgroundIsGrid || plan.snap.backgroundIsLines);
+        if (plan.useSnap) {
+            plan.groups = buildSnapGroups(plan.filtered, plan.snap);
+            plan.sets.reserve(plan.groups.size());
+            for (const auto& group : plan.groups)
+                plan.sets.append(snapGroupStrokes(group, plan.filtered));
+        } else {
+            plan.sets.append(plan.filtered);
+        }
+        return plan;
+    };
+
+    // Worker-pool mode (prepareThreads != 1): a chunk's pages are planned in
+    // parallel on a private pool, and the next chunk is planned while the
+    // engine recognizes the current one, much like MuPdfExporter prepares
+    // pages ahead of its writer. Declared after everything planPage
+    // references so its destructor joins in-flight plans (e.g. after a
+    // cancel) before those go away.
+    const int prepareThreads = m_inferenceOptions.prepareThreads > 0
+        ? m_inferenceOptions.prepareThreads : QThread::idealThreadCount();
+    const bool planAhead = prepareThreads > 1;
+    QThreadPool planPool;
+    planPool.setMaxThreadCount(qMax(1, prepareThreads));
+
+    auto dispatchChunk = [&](int chunkStart) {
+        QVector<QFuture<PagePlan>> futures;
+        const int chunkEnd = qMin(total, chunkStart + kPagesPerBatch);
+        for (int i = chunkStart; i < chunkEnd; ++i)
+            futures.append(QtConcurrent::run(&planPool, planPage, i));
+        return futures;
+    };
+
+    QVector<QFuture<PagePlan>> ahead;
+    if (planAhead)
+        ahead = dispatchChunk(0);
+
+    for (int chunkStart = 0; chunkStart < total && !m_cancelled; chunkStart += kPagesPerBatch) {
+        const int chunkEnd = qMin(total, chunkStart + kPagesPerBatch);
+
+        QVector<PagePlan> plans;
+        plans.reserve(chunkEnd - chunkStart);
+        if (planAhead) {
+            const QVector<QFuture<PagePlan>> current = std::move(ahead);
+            ahead.clear();
+            if (chunkEnd < total)
+                ahead = dispatchChunk(chunkEnd);
+            for (const QFuture<PagePlan>& f : current)
+                plans.append(f.result());
+        } else {
+            for (int i = chunkStart; i < chunkEnd; ++i)
+                plans.append(planPage(i));
+        }
 
-        QVector<OcrEngine::Result> results;
+        QVector<QVector<VectorStroke>> sets;
+        for (PagePlan& plan : plans) {
+            plan.firstSet = sets.size();
+            sets += plan.sets;
+            plan.sets.clear();
+        }
 
-        if (useSnap) {
-            QVector<StrokeLineGroup> groups;
-            if (snap.cjkGridMode && snap.backgroundIsGrid) {
-                // Grid-cell snapping ONLY for CJK (see processPage).
-                groups = groupStrokesByGridCells(filtered, snap.gridSpacing);
-            } else {
-                // Latin on grid OR lines: line snapping by line spacing,
-                // regardless of background style.
-                groups = groupStrokesByLineBands(filtered, snap.lineSpacing);
-            }
+        if (m_cancelled)
+            break;
 
-            for (const auto& group : groups) {
-                if (m_cancelled) break;
+        QVector<QVector<OcrEngine::Result>> setResults = m_engine->analyzeBatch(sets);
+        setResults.resize(sets.size());
 
-                OcrEngine::Result merged;
-                if (recognizeSnapGroup(m_engine.get(), group, filtered, snap, merged))
-                    results.append(std::move(merged));
-            }
-        } else {
-            m_engine->clearStrokes();
-            m_engine->addStrokes(filtered);
+        for (int p = 0; p < plans.size(); ++p) {
+            if (m_cancelled)
+                break;
 
-            if (m_cancelled) break;
+            const PagePlan& plan = plans[p];
+            QVector<OcrEngine::Result> results;
 
-            results = m_engine->analyze();
+            if (plan.useSnap) {
+                for (int g = 0; g < plan.groups.size(); ++g) {
+                    if (m_cancelled) break;
 
-            for (auto& r : results)
-                ensureWordSegment(r);
-        }
+                    OcrEngine::Result merged;
+                    if (finishSnapGroup(m_engine.get(), plan.groups[g], plan.filtered,
+                                        plan.snap, std::move(setResults[plan.firstSet + g]),
+                                        merged))
+                        results.append(std::move(merged));
+                }
+            } else {
+                results = std::move(setResults[plan.firstSet]);
+                for (auto& r : results)
+                    ensureWordSegment(r);
+            }
 
-        if (m_cancelled)
-            break;
+            if (m_cancelled)
+                break;
 
-        QVector<OcrTextBlock> blocks = buildBlocks(results);
+            QVector<OcrTextBlock> blocks = buildBlocks(results);
 
-        if (!blocks.isEmpty())
-            ++pagesWithText;
+            if (!blocks.isEmpty())
+                ++pagesWithText;
 
-        emit resultsReady(pageIds[i], blocks);
+            emit resultsReady(pageIds[chunkStart + p], blocks);
 
-        ++completed;
-        emit batchProgress(completed, total);
+            ++completed;
+            emit batchProgress(completed, total);
+        }
     }
 
     m_lastPageId.clear();
@@ -8,6 +8,8 @@
 // Runs OCR on a dedicated QThread. Receives stroke data by value
 // (implicit sharing / COW), never accesses Page directly.
 // Results come back via signals (queued connection to main thread).
+// processBatch() plans pages (filtering, snap grouping) on a private thread
+// pool ahead of recognition; results are still emitted in page order.
 // ============================================================================
 
 #include <QObject>
@@ -37,6 +39,9 @@ public:
     ~OcrWorker() override;
 
     void setEngine(std::unique_ptr<OcrEngine> engine);
+    /// Inference tuning handed to the engine in initEngine(). Call before the
+    /// worker thread starts.
+    void setInferenceOptions(const OcrEngine::InferenceOptions& options);
     bool isEngineAvailable() const;
     bool isBusy() const;
     QStringList availableLanguages() const;
@@ -83,6 +88,7 @@ private:
     void emitDownloadedLanguages();
 
     std::unique_ptr<OcrEngine> m_engine;
+    OcrEngine::InferenceOptions m_inferenceOptions;
     std::atomic<bool> m_cancelled{false};
     std::atomic<bool> m_busy{false};
 
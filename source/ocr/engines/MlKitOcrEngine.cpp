@@ -191,7 +191,7 @@ QString MlKitOcrEngine::language() const
 void MlKitOcrEngine::addStrokes(const QVector<VectorStroke>& strokes)
 {
     for (const auto& stroke : strokes) {
-        m_strokeIndexById.insert(stroke.id, static_cast<int>(m_strokes.size()));
+        m_strokeIndexById.insert(stroke.id.toString(), static_cast<int>(m_strokes.size()));
         m_strokes.append(stroke);
     }
 }
@@ -208,7 +208,7 @@ void MlKitOcrEngine::removeStrokes(const QVector<QString>& strokeIds)
 
         if (idx < m_strokes.size() - 1) {
             m_strokes[idx] = m_strokes.last();
-            m_strokeIndexById[m_strokes[idx].id] = idx;
+            m_strokeIndexById[m_strokes[idx].id.toString()] = idx;
         }
         m_strokes.removeLast();
     }
@@ -247,7 +247,7 @@ QVector<OcrEngine::Result> MlKitOcrEngine::analyze()
 
                 for (int idx : chunk.strokeIndices) {
                     subStrokes.append(m_strokes[idx]);
-                    sourceIds.append(m_strokes[idx].id);
+                    sourceIds.append(m_strokes[idx].id.toString());
                 }
 
                 const QString text = recognizeStrokesNative(subStrokes);
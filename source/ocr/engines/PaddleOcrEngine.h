@@ -14,6 +14,11 @@
 // QA Q11.3), CTC-decoding the logits to text plus approximate per-character X
 // boxes (good X, full-height Y, QA Q11.2).
 //
+// recognizeImages() batches: strips are sorted by resized width, packed into
+// batches whose padded width stays close to the narrowest member, and run as
+// one [N,3,H,W] tensor each. Thread counts and the batch cap come from
+// OcrEngine::InferenceOptions.
+//
 // The recognition models are the RapidAI/RapidOCR pre-converted ONNX exports,
 // which embed their character dictionary in the ONNX metadata (key
 // "character"), so no separate dict files are needed (see fetch-ocr-models.sh).
@@ -46,14 +51,22 @@ public:
     /// Clears the per-session failed-download cache on a real language change,
     /// then defers to the base (cache invalidation + tag normalization).
     void setLanguage(const QString& recognizerName) override;
+    /// Drops the loaded sessions when the thread counts change; they are
+    /// rebuilt with the new options on next use.
+    void setInferenceOptions(const InferenceOptions& options) override;
 
 protected:
     ImageRecognition recognizeImage(const QImage& strip,
                                     const QString& languageTag) override;
+    QVector<ImageRecognition> recognizeImages(const QVector<QImage>& strips,
+                                              const QString& languageTag) override;
 
     /// PP-OCRv5 mobile recognition models expect ~48 px input height.
     int targetStripHeightPx() const override { return 48; }
 
+    /// Model file name, size and mtime of the model that serves @p languageTag.
+    QByteArray modelFingerprint(const QString& languageTag) const override;
+
     /// Map a BCP-47-ish language tag to a recognition model file name (by
     /// script). The mapped file may be bundled or downloadable on demand.
     /// Protected so test harnesses can exercise the mapping without I/O.
@@ -5,9 +5,10 @@
 // ============================================================================
 // PaddleOcrEngine (Linux) - PP-OCRv5 recognition via ONNX Runtime (CPU EP).
 // ============================================================================
-// Implements the single RasterOcrEngine bridge, recognizeImage():
-//   normalized strip -> resize/normalize/CHW tensor -> Ort::Session::Run ->
-//   greedy CTC decode -> text + approximate per-character X boxes.
+// Implements the RasterOcrEngine bridge, recognizeImages():
+//   normalized strips -> resize/normalize -> width-bucketed [N,3,H,W] batches
+//   -> Ort::Session::Run -> greedy CTC decode per strip -> text + approximate
+//   per-character X boxes. recognizeImage() is the one-strip case.
 //
 // The character dictionary is read from the ONNX model metadata (key
 // "character"; RapidOCR convention), then the PaddleOCR CTC label table is
@@ -19,6 +20,7 @@
 #include <QByteArray>
 #include <QCoreApplication>
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
 #include <QEventLoop>
 #include <QFileInfo>
@@ -66,6 +68,26 @@ namespace {
 constexpr int kMinStripWidth = 16;
 constexpr int kMaxStripWidth = 4096;
 
+// Batching. Strips are sorted by resized width and a batch is closed once the
+// widest member would pad the narrowest by more than half its width (or one
+// quantum for very short strips), so padding stays a small share of the work.
+constexpr int kDefaultMaxBatchSize = 16;
+constexpr int kWidthQuantum = 32;
+
+// The recognizer's [N x T x C] float logits (T ~= padded width / 8) dominate
+// a batch's memory with the large CJK dictionary (C ~= 18k): 16 wide strips
+// would need over a gigabyte. A batch is also closed before its estimated
+// logits exceed this budget; a single strip always runs.
+constexpr size_t kMaxBatchLogitsBytes = size_t(64) << 20;
+constexpr int kRecWidthStride = 8;
+
+int defaultIntraOpThreads()
+{
+    // The recognizer shares the machine with the GUI thread and the PDF
+    // render lanes; a few threads already saturate a 16-strip batch.
+    return std::clamp(QThread::idealThreadCount() / 2, 1, 4);
+}
+
 // ----------------------------------------------------------------------------
 // Model catalog (Phase 4D). RapidAI/RapidOCR pre-converted PP-OCRv5 *mobile*
 // recognition models. SHAs and the base URL match linux/fetch-ocr-models.sh
@@ -212,6 +234,84 @@ QVector<QString> buildCharTable(Ort::Session& session)
     return table;
 }
 
+// Greedy CTC decode of one strip's [T x C] logits.
+struct CtcLine {
+    QString text;
+    QVector<QRectF> charBoxes; ///< strip pixels; empty when not one box per char
+};
+
+// @p inkWidth is the strip's resized width inside a tensor of @p tensorWidth
+// columns (wider when the batch padded it). Returned boxes are in the
+// received strip's pixel space (@p stripW x @p stripH).
+CtcLine decodeCtc(const float* logits, int T, int C, const QVector<QString>& charTable,
+                  int inkWidth, int tensorWidth, int stripW, int stripH)
+{
+    CtcLine out;
+
+    // Keep a token iff (it differs from the previous raw token) AND (not blank,
+    // index 0) -- identical to PaddleOCR/RapidOCR CTCLabelDecode.
+    struct Emit { QString ch; int col; };
+    std::vector<Emit> emits;
+    emits.reserve(T);
+
+    int prevRaw = -1;
+    for (int t = 0; t < T; ++t) {
+        const float* p = logits + static_cast<size_t>(t) * C;
+        int best = 0;
+        float bestVal = p[0];
+        for (int c = 1; c < C; ++c) {
+            if (p[c] > bestVal) { bestVal = p[c]; best = c; }
+        }
+        if (best != prevRaw && best != 0) {
+            const QString ch = (best < charTable.size()) ? charTable[best] : QString();
+            if (!ch.isEmpty())
+                emits.push_back({ch, t});
+        }
+        prevRaw = best;
+    }
+
+    // CTC gives a meaningful column (good X); Y is weak so each box spans the
+    // full strip height (QA Q11.2). Box edges are midpoints between adjacent
+    // character centers, mapped from feature columns to strip width. Tokens
+    // centered in the batch padding right of the ink are dropped.
+    const double colPx = static_cast<double>(tensorWidth) / T;
+    const double toStrip = static_cast<double>(stripW) / inkWidth;
+    std::vector<const Emit*> kept;
+    std::vector<double> centers;
+    kept.reserve(emits.size());
+    centers.reserve(emits.size());
+    for (const Emit& e : emits) {
+        const double cx = (e.col + 0.5) * colPx;
+        if (cx > inkWidth)
+            continue;
+        kept.push_back(&e);
+        centers.push_back(cx * toStrip);
+    }
+
+    const int n = static_cast<int>(kept.size());
+    if (n == 0)
+        return out;
+
+    QVector<QRectF> boxes;
+    bool charBoxesValid = true;
+    for (int i = 0; i < n; ++i) {
+        const double left  = (i == 0)      ? 0.0    : (centers[i - 1] + centers[i]) / 2.0;
+        const double right = (i == n - 1)  ? stripW : (centers[i] + centers[i + 1]) / 2.0;
+        const QRectF box(left, 0.0, std::max(0.0, right - left), stripH);
+
+        const QString& ch = kept[i]->ch;
+        out.text += ch;
+        for (int k = 0; k < ch.length(); ++k)
+            boxes.append(box);
+        if (ch.length() != 1)
+            charBoxesValid = false; // multi-codepoint token -> degrade to word rects
+    }
+
+    if (charBoxesValid && boxes.size() == out.text.length())
+        out.charBoxes = boxes; // else base falls back to the word rect
+    return out;
+}
+
 } // namespace
 
 PaddleOcrEngine::PaddleOcrEngine()
@@ -371,6 +471,16 @@ bool PaddleOcrEngine::ensureModelDownloaded(const QString& fileName)
     return false;
 }
 
+void PaddleOcrEngine::setInferenceOptions(const InferenceOptions& options)
+{
+    const InferenceOptions prev = inferenceOptions();
+    RasterOcrEngine::setInferenceOptions(options);
+    // Thread counts are baked into each Ort::Session; reload lazily.
+    if (options.intraOpThreads != prev.intraOpThreads
+        || options.interOpThreads != prev.interOpThreads)
+        m_models.clear();
+}
+
 void PaddleOcrEngine::setLanguage(const QString& recognizerName)
 {
     const QString prev = language();
@@ -381,6 +491,22 @@ void PaddleOcrEngine::setLanguage(const QString& recognizerName)
         m_downloadFailed.clear();
 }
 
+QByteArray PaddleOcrEngine::modelFingerprint(const QString& languageTag) const
+{
+    // Resolves like modelForLanguage() (the language's model, else the latin
+    // fallback) but without loading or downloading anything. Name, size and
+    // mtime identify the file without hashing megabytes per analyze().
+    QString file = modelFileForLanguage(languageTag);
+    QString path = findModelFile(file);
+    if (path.isEmpty()) {
+        file = QStringLiteral("latin_rec.onnx");
+        path = findModelFile(file);
+    }
+    const QFileInfo info(path);
+    return (file + QLatin1Char('|') + QString::number(info.size()) + QLatin1Char('|')
+            + QString::number(info.lastModified().toMSecsSinceEpoch())).toUtf8();
+}
+
 PaddleOcrEngine::Model* PaddleOcrEngine::modelForLanguage(const QString& languageTag)
 {
     QString file = modelFileForLanguage(languageTag);
@@ -416,7 +542,14 @@ PaddleOcrEngine::Model* PaddleOcrEngine::modelForLanguage(const QString& languag
     try {
         Ort::SessionOptions opts;
         opts.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        opts.SetIntraOpNumThreads(1); // tiny single-line model; avoid oversubscription
+        const InferenceOptions& io = inferenceOptions();
+        opts.SetIntraOpNumThreads(io.intraOpThreads > 0 ? io.intraOpThreads
+                                                        : defaultIntraOpThreads());
+        if (io.interOpThreads > 1) {
+            // Inter-op threads only apply to the parallel executor.
+            opts.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+            opts.SetInterOpNumThreads(io.interOpThreads);
+        }
 
         const std::string pathStd = path.toStdString();
         Ort::Session session(m_impl->env, pathStd.c_str(), opts);
@@ -452,133 +585,148 @@ PaddleOcrEngine::Model* PaddleOcrEngine::modelForLanguage(const QString& languag
 RasterOcrEngine::ImageRecognition
 PaddleOcrEngine::recognizeImage(const QImage& strip, const QString& languageTag)
 {
-    ImageRecognition out;
-    if (strip.isNull())
+    return recognizeImages({strip}, languageTag).value(0);
+}
+
+QVector<RasterOcrEngine::ImageRecognition>
+PaddleOcrEngine::recognizeImages(const QVector<QImage>& strips, const QString& languageTag)
+{
+    // Every strip counts as failed until its batch has been decoded.
+    ImageRecognition notRun;
+    notRun.failed = true;
+    QVector<ImageRecognition> out(strips.size(), notRun);
+    if (strips.isEmpty())
         return out;
 
     Model* model = modelForLanguage(languageTag);
     if (!model)
         return out;
 
-    // --- 1. Preprocess: Grayscale8 strip -> resized RGB CHW float tensor. ---
-    const QImage gray = strip.convertToFormat(QImage::Format_Grayscale8);
-    const int stripW = gray.width();
-    const int stripH = gray.height();
-    if (stripW <= 0 || stripH <= 0)
-        return out;
-
+    // --- 1. Preprocess: Grayscale8 strip -> model-height grayscale. ---------
+    struct Prepared {
+        int index;       ///< position in strips / out
+        QImage resized;  ///< H x W Grayscale8
+        int stripW;
+        int stripH;
+    };
     const int H = model->recHeight;
-    int W = static_cast<int>(std::lround(static_cast<double>(H) * stripW / stripH));
-    W = std::clamp(W, kMinStripWidth, kMaxStripWidth);
-
-    const QImage resized =
-        gray.scaled(W, H, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
-            .convertToFormat(QImage::Format_Grayscale8);
-
-    // CHW, 3 channels (grayscale replicated), PP-OCR normalize (x/255-0.5)/0.5.
-    std::vector<float> input(static_cast<size_t>(3) * H * W);
-    for (int y = 0; y < H; ++y) {
-        const uchar* row = resized.constScanLine(y);
-        for (int x = 0; x < W; ++x) {
-            const float v = (static_cast<float>(row[x]) / 255.0f - 0.5f) / 0.5f;
-            const size_t idx = static_cast<size_t>(y) * W + x;
-            input[idx] = v;                                  // R
-            input[static_cast<size_t>(H) * W + idx] = v;     // G
-            input[static_cast<size_t>(2) * H * W + idx] = v; // B
-        }
-    }
+    std::vector<Prepared> items;
+    items.reserve(strips.size());
+    for (int i = 0; i < strips.size(); ++i) {
+        if (strips[i].isNull())
+            continue;
+        const QImage gray = strips[i].convertToFormat(QImage::Format_Grayscale8);
+        const int stripW = gray.width();
+        const int stripH = gray.height();
+        if (stripW <= 0 || stripH <= 0)
+            continue;
 
-    // --- 2. Run inference. --------------------------------------------------
-    // Keep the output Ort::Value alive past the try so the CTC decoder can read
-    // its logits in place -- copying the whole [T x C] buffer out would cost
-    // tens of MB for wide lines with the large (C ~= 18k) CJK dictionary.
-    std::vector<Ort::Value> outputs;
-    try {
-        Ort::MemoryInfo memInfo =
-            Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-        const std::array<int64_t, 4> shape{1, 3, H, W};
-        Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-            memInfo, input.data(), input.size(), shape.data(), shape.size());
-
-        const char* inNames[]  = {model->inputName.c_str()};
-        const char* outNames[] = {model->outputName.c_str()};
-        outputs = model->session.Run(Ort::RunOptions{nullptr},
-                                     inNames, &inputTensor, 1, outNames, 1);
-    } catch (const Ort::Exception&) {
-        return out;
-    } catch (...) {
-        return out;
+        int W = static_cast<int>(std::lround(static_cast<double>(H) * stripW / stripH));
+        W = std::clamp(W, kMinStripWidth, kMaxStripWidth);
+        items.push_back({i,
+                         gray.scaled(W, H, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+                             .convertToFormat(QImage::Format_Grayscale8),
+                         stripW, stripH});
     }
 
-    if (outputs.empty())
-        return out;
-    const std::vector<int64_t> oShape =
-        outputs[0].GetTensorTypeAndShapeInfo().GetShape();
-    if (oShape.size() != 3)
-        return out; // expect [1, T, C]
-    const int T = static_cast<int>(oShape[1]);
-    const int C = static_cast<int>(oShape[2]);
-    if (T <= 0 || C <= 0)
-        return out;
-    const float* logits = outputs[0].GetTensorData<float>();
-
-    // --- 3. Greedy CTC decode + per-char column. ----------------------------
-    // Keep a token iff (it differs from the previous raw token) AND (not blank,
-    // index 0) -- identical to PaddleOCR/RapidOCR CTCLabelDecode.
-    struct Emit { QString ch; int col; };
-    std::vector<Emit> emits;
-    emits.reserve(T);
-
-    int prevRaw = -1;
-    for (int t = 0; t < T; ++t) {
-        const float* p = logits + static_cast<size_t>(t) * C;
-        int best = 0;
-        float bestVal = p[0];
-        for (int c = 1; c < C; ++c) {
-            if (p[c] > bestVal) { bestVal = p[c]; best = c; }
-        }
-        if (best != prevRaw && best != 0) {
-            const QString ch = (best < model->charTable.size())
-                                   ? model->charTable[best]
-                                   : QString();
-            if (!ch.isEmpty())
-                emits.push_back({ch, t});
+    // --- 2. Bucket by width. ------------------------------------------------
+    std::stable_sort(items.begin(), items.end(), [](const Prepared& a, const Prepared& b) {
+        return a.resized.width() < b.resized.width();
+    });
+    const size_t maxBatch = static_cast<size_t>(
+        inferenceOptions().maxBatchSize > 0 ? inferenceOptions().maxBatchSize
+                                            : kDefaultMaxBatchSize);
+
+    size_t begin = 0;
+    while (begin < items.size()) {
+        // A cancelled scan leaves the remaining strips failed, so nothing of
+        // it reaches the persistent cache.
+        if (isCancelled())
+            break;
+
+        const int narrowest = items[begin].resized.width();
+        const int maxPadded = narrowest + std::max(kWidthQuantum, narrowest / 2);
+        const size_t classes = static_cast<size_t>(std::max(1, static_cast<int>(model->charTable.size())));
+        auto logitsBytes = [&](size_t count, int paddedWidth) {
+            return count * static_cast<size_t>(paddedWidth / kRecWidthStride + 1)
+                   * classes * sizeof(float);
+        };
+        size_t end = begin + 1;
+        while (end < items.size() && end - begin < maxBatch
+               && items[end].resized.width() <= maxPadded
+               && logitsBytes(end - begin + 1, items[end].resized.width())
+                      <= kMaxBatchLogitsBytes)
+            ++end;
+
+        const int N = static_cast<int>(end - begin);
+        const int Wp = items[end - 1].resized.width(); // widest member
+
+        // NCHW, 3 channels (grayscale replicated), PP-OCR normalize
+        // (x/255-0.5)/0.5. Columns right of a strip's own width stay 0, the
+        // normalized mid-gray PaddleOCR itself pads batches with.
+        const size_t plane = static_cast<size_t>(H) * Wp;
+        std::vector<float> input(static_cast<size_t>(N) * 3 * plane, 0.0f);
+        for (int b = 0; b < N; ++b) {
+            const QImage& img = items[begin + b].resized;
+            float* base = input.data() + static_cast<size_t>(b) * 3 * plane;
+            for (int y = 0; y < H; ++y) {
+                const uchar* row = img.constScanLine(y);
+                for (int x = 0; x < img.width(); ++x) {
+                    const float v = (static_cast<float>(row[x]) / 255.0f - 0.5f) / 0.5f;
+                    const size_t idx = static_cast<size_t>(y) * Wp + x;
+                    base[idx] = v;             // R
+                    base[plane + idx] = v;     // G
+                    base[2 * plane + idx] = v; // B
+                }
+            }
         }
-        prevRaw = best;
-    }
-
-    if (emits.empty())
-        return out;
-
-    // --- 4. Text + approximate per-char boxes in received-strip pixels. -----
-    // CTC gives a meaningful column (good X); Y is weak so each box spans the
-    // full strip height (QA Q11.2). Box edges are midpoints between adjacent
-    // character centers, mapped from feature columns to strip width.
-    QString text;
-    QVector<QRectF> boxes;
-    bool charBoxesValid = true;
 
-    const int n = static_cast<int>(emits.size());
-    std::vector<double> centers(n);
-    for (int i = 0; i < n; ++i)
-        centers[i] = (emits[i].col + 0.5) / static_cast<double>(T) * stripW;
+        // --- 3. Run inference. ----------------------------------------------
+        // Keep the output Ort::Value alive so the CTC decoder can read its
+        // logits in place -- copying the whole [N x T x C] buffer out would
+        // cost tens of MB per strip with the large (C ~= 18k) CJK dictionary.
+        std::vector<Ort::Value> outputs;
+        try {
+            Ort::MemoryInfo memInfo =
+                Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            const std::array<int64_t, 4> shape{N, 3, H, Wp};
+            Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+                memInfo, input.data(), input.size(), shape.data(), shape.size());
+
+            const char* inNames[]  = {model->inputName.c_str()};
+            const char* outNames[] = {model->outputName.c_str()};
+            outputs = model->session.Run(Ort::RunOptions{nullptr},
+                                         inNames, &inputTensor, 1, outNames, 1);
+        } catch (...) {
+            outputs.clear(); // this batch stays unrecognized; try the next one
+        }
 
-    for (int i = 0; i < n; ++i) {
-        const double left  = (i == 0)      ? 0.0    : (centers[i - 1] + centers[i]) / 2.0;
-        const double right = (i == n - 1)  ? stripW : (centers[i] + centers[i + 1]) / 2.0;
-        const QRectF box(left, 0.0, std::max(0.0, right - left), stripH);
+        if (!outputs.empty()) {
+            const std::vector<int64_t> oShape =
+                outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+            // Expect [N, T, C].
+            if (oShape.size() == 3 && oShape[0] == N && oShape[1] > 0 && oShape[2] > 0) {
+                const int T = static_cast<int>(oShape[1]);
+                const int C = static_cast<int>(oShape[2]);
+                const float* logits = outputs[0].GetTensorData<float>();
+
+                // --- 4. Decode each strip of the batch. ---------------------
+                for (int b = 0; b < N; ++b) {
+                    const Prepared& item = items[begin + b];
+                    const CtcLine line = decodeCtc(
+                        logits + static_cast<size_t>(b) * T * C, T, C, model->charTable,
+                        item.resized.width(), Wp, item.stripW, item.stripH);
+                    ImageRecognition& rec = out[item.index];
+                    rec.text = line.text;
+                    rec.charBoxesImage = line.charBoxes;
+                    rec.failed = false;
+                }
+            }
+        }
 
-        const QString& ch = emits[i].ch;
-        text += ch;
-        for (int k = 0; k < ch.length(); ++k)
-            boxes.append(box);
-        if (ch.length() != 1)
-            charBoxesValid = false; // multi-codepoint token -> degrade to word rects
+        begin = end;
     }
 
-    out.text = text;
-    if (charBoxesValid && boxes.size() == text.length())
-        out.charBoxesImage = boxes; // else base falls back to the word rect
     return out;
 }
 
@@ -1,5 +1,6 @@
 #include "RasterOcrEngine.h"
 
+#include "../OcrLineCache.h"
 #include "../OcrLineGrouper.h"
 #include "../OcrStrokeRasterizer.h"
 #include "../OcrTextBlock.h" // isCjkLikeChar
@@ -7,11 +8,16 @@
 #include <QLocale>
 #include <QSet>
 #include <QStringList>
+#include <QSysInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
 #ifdef SPEEDYNOTE_DEBUG
 #include <QDebug>
 #endif
 
 #include <algorithm>
+#include <atomic>
 
 // ----------------------------------------------------------------------------
 // Line signature: an order-independent 64-bit hash over a group's sorted stroke
@@ -44,7 +50,7 @@ quint64 lineSignature(const StrokeLineGroup& group,
     for (int idx : group.strokeIndices) {
         if (idx < 0 || idx >= strokes.size())
             continue;
-        items.append({strokes[idx].id, idx});
+        items.append({strokes[idx].id.toString(), idx});
     }
     std::sort(items.begin(), items.end(),
               [](const QPair<QString, int>& a, const QPair<QString, int>& b) {
@@ -66,11 +72,41 @@ quint64 lineSignature(const StrokeLineGroup& group,
     return h;
 }
 
+// Runs fn(i) for every i in [0, count): on the calling thread alone without a
+// pool, otherwise on the calling thread plus the pool's threads, each pulling
+// the next index from a shared counter. fn may only write state owned by its
+// index; the order of calls does not matter, so the outcome is identical to
+// the sequential loop.
+template <typename Fn>
+void forEachIndex(QThreadPool* pool, int count, const Fn& fn)
+{
+    const int helpers = pool ? qMin(pool->maxThreadCount(), count - 1) : 0;
+    if (helpers <= 0) {
+        for (int i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    std::atomic<int> next{0};
+    auto drain = [&]() {
+        for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+            fn(i);
+    };
+    QVector<QFuture<void>> running;
+    running.reserve(helpers);
+    for (int t = 0; t < helpers; ++t)
+        running.append(QtConcurrent::run(pool, drain));
+    drain();
+    for (QFuture<void>& f : running)
+        f.waitForFinished();
+}
+
 } // namespace
 
 RasterOcrEngine::RasterOcrEngine()
     : m_languageTag(QStringLiteral("en-US"))
 {
+    resetPreparePool();
 }
 
 RasterOcrEngine::~RasterOcrEngine() = default;
@@ -171,10 +207,43 @@ QString RasterOcrEngine::language() const
     return m_languageTag;
 }
 
+void RasterOcrEngine::setPersistentCachePath(const QString& path)
+{
+    if (m_diskCache && m_diskCache->path() == path)
+        return;
+    m_diskCache.reset(); // flushes
+    if (!path.isEmpty())
+        m_diskCache = std::make_unique<OcrLineCache>(path);
+}
+
+void RasterOcrEngine::setInferenceOptions(const InferenceOptions& options)
+{
+    const int prev = inferenceOptions().prepareThreads;
+    OcrEngine::setInferenceOptions(options);
+    if (options.prepareThreads != prev)
+        resetPreparePool();
+}
+
+void RasterOcrEngine::resetPreparePool()
+{
+    const int requested = inferenceOptions().prepareThreads;
+    const int threads = requested > 0 ? requested : QThread::idealThreadCount();
+    m_preparePool.reset();
+    if (threads <= 1)
+        return;
+    m_preparePool = std::make_unique<QThreadPool>();
+    m_preparePool->setMaxThreadCount(threads - 1); // the caller is the last one
+}
+
+QByteArray RasterOcrEngine::modelFingerprint(const QString& /*languageTag*/) const
+{
+    return (QSysInfo::productType() + QLatin1Char(' ') + QSysInfo::productVersion()).toUtf8();
+}
+
 void RasterOcrEngine::addStrokes(const QVector<VectorStroke>& strokes)
 {
     for (const auto& stroke : strokes) {
-        m_strokeIndexById.insert(stroke.id, static_cast<int>(m_strokes.size()));
+        m_strokeIndexById.insert(stroke.id.toString(), static_cast<int>(m_strokes.size()));
         m_strokes.append(stroke);
     }
 }
@@ -192,7 +261,7 @@ void RasterOcrEngine::removeStrokes(const QVector<QString>& strokeIds)
         // Swap-and-pop to keep the index map cheap (matches MlKitOcrEngine).
         if (idx < m_strokes.size() - 1) {
             m_strokes[idx] = m_strokes.last();
-            m_strokeIndexById[m_strokes[idx].id] = idx;
+            m_strokeIndexById[m_strokes[idx].id.toString()] = idx;
         }
         m_strokes.removeLast();
     }
@@ -212,61 +281,204 @@ QVector<OcrEngine::Result> RasterOcrEngine::analyze()
         return {};
     }
 
+    QSet<quint64> liveSigs;
+    QVector<QVector<Result>> results = recognizeStrokeSets({&m_strokes}, liveSigs);
+
+    // Evict cache entries for lines that no longer exist (moved/edited/removed).
+    for (auto it = m_lineCache.begin(); it != m_lineCache.end();) {
+        if (!liveSigs.contains(it.key()))
+            it = m_lineCache.erase(it);
+        else
+            ++it;
+    }
+
+    return results.first();
+}
+
+QVector<QVector<OcrEngine::Result>> RasterOcrEngine::analyzeBatch(
+    const QVector<QVector<VectorStroke>>& strokeSets)
+{
+    // Same contract as the OcrEngine default: the batch replaces the stroke
+    // buffer and leaves it empty, and so must not leave its lines cached.
+    clearStrokes();
+
+    QVector<const QVector<VectorStroke>*> sets;
+    sets.reserve(strokeSets.size());
+    for (const auto& strokes : strokeSets)
+        sets.append(&strokes);
+
+    QSet<quint64> liveSigs;
+    QVector<QVector<Result>> results = recognizeStrokeSets(sets, liveSigs);
+    m_lineCache.clear();
+    return results;
+}
+
+QVector<RasterOcrEngine::ImageRecognition>
+RasterOcrEngine::recognizeImages(const QVector<QImage>& strips, const QString& languageTag)
+{
+    QVector<ImageRecognition> recs;
+    recs.reserve(strips.size());
+    for (const QImage& strip : strips)
+        recs.append(recognizeImage(strip, languageTag));
+    return recs;
+}
+
+QVector<QVector<OcrEngine::Result>> RasterOcrEngine::recognizeStrokeSets(
+    const QVector<const QVector<VectorStroke>*>& sets, QSet<quint64>& liveSigs)
+{
+    // One line of a set, as grouped in the first pass.
+    struct Line {
+        StrokeLineGroup group;
+        quint64 sig;
+    };
+    // A line the cache could not answer, waiting for its strip's recognition.
+    struct Job {
+        int set;
+        StrokeLineGroup group;
+        quint64 sig;
+        RasterStrip strip;
+    };
+    // One output line per slot: either a cache hit or a job index.
+    struct Slot {
+        int job = -1;
+        Result cached;
+    };
+
+    QThreadPool* pool = m_preparePool.get();
+
+    // --- 1. Group every set (in parallel; sets are independent). -----------
     // Internal default grouping mirrors MlKitOcrEngine::analyze(): adaptive
     // line detection then horizontal-gap splitting. The worker handles
     // OcrSnapParams-driven grid/band grouping upstream (QA Q2.3 Option B).
-    const auto lineGroups = groupStrokesIntoLines(m_strokes);
-
-    QVector<Result> results;
-    QSet<quint64> liveSigs;
+    QVector<QVector<Line>> setLines(sets.size());
+    QVector<Line>* linesOut = setLines.data(); // detached once, before fanning out
+    forEachIndex(pool, sets.size(), [&](int s) {
+        const QVector<VectorStroke>& strokes = *sets[s];
+        if (strokes.isEmpty() || isCancelled())
+            return;
+        for (const auto& line : groupStrokesIntoLines(strokes)) {
+            for (const auto& group : splitLineByHorizontalGaps(line, strokes)) {
+                if (!group.strokeIndices.isEmpty())
+                    linesOut[s].append(Line{group, lineSignature(group, strokes)});
+            }
+        }
+    });
 
-    for (const auto& line : lineGroups) {
-        const auto subGroups = splitLineByHorizontalGaps(line, m_strokes);
+    // --- 2. Answer what the caches can (sequential: they are not shared). --
+    QVector<QVector<Slot>> lineSlots(sets.size());
+    QVector<Job> jobs;
+    QHash<quint64, int> jobBySig; // identical ink in two sets is recognized once
 
-        for (const auto& group : subGroups) {
-            if (group.strokeIndices.isEmpty())
-                continue;
+    const quint64 recognizer = m_diskCache
+        ? OcrLineCache::recognizerKey(engineId(), modelFingerprint(m_languageTag),
+                                      m_languageTag, targetStripHeightPx())
+        : 0;
 
-            const quint64 sig = lineSignature(group, m_strokes);
-            liveSigs.insert(sig);
+    for (int s = 0; s < sets.size(); ++s) {
+        for (const Line& line : std::as_const(setLines[s])) {
+            liveSigs.insert(line.sig);
 
-            auto cached = m_lineCache.constFind(sig);
+            auto cached = m_lineCache.constFind(line.sig);
             if (cached != m_lineCache.constEnd()) {
-                results.append(cached->result);
+                lineSlots[s].append(Slot{-1, cached->result});
                 continue;
             }
-
-            const RasterStrip strip =
-                rasterizeStrokes(m_strokes, group.strokeIndices, targetStripHeightPx());
-            if (strip.image.isNull())
+            auto pending = jobBySig.constFind(line.sig);
+            if (pending != jobBySig.constEnd()) {
+                lineSlots[s].append(Slot{pending.value(), Result()});
                 continue;
+            }
 
-            const ImageRecognition rec = recognizeImage(strip.image, m_languageTag);
-            if (rec.text.isEmpty())
+            // Persistent cache: a hit skips rasterization and recognition.
+            // A stored blank line (no text) stays blank.
+            Result stored;
+            if (m_diskCache
+                && m_diskCache->find(OcrLineCache::lineKey(recognizer, line.sig), stored)) {
+                if (!stored.text.isEmpty()) {
+                    m_lineCache.insert(line.sig, CachedLine{stored});
+                    lineSlots[s].append(Slot{-1, std::move(stored)});
+                }
                 continue;
+            }
 
-            // Move the freshly built Result into the cache, then append a copy
-            // from the cache (one copy, matching the cache-hit path above).
-            const auto inserted =
-                m_lineCache.insert(sig, CachedLine{buildResult(group, strip.transform, rec)});
-            results.append(inserted.value().result);
+            jobBySig.insert(line.sig, static_cast<int>(jobs.size()));
+            lineSlots[s].append(Slot{static_cast<int>(jobs.size()), Result()});
+            jobs.append(Job{s, line.group, line.sig, RasterStrip()});
         }
     }
 
-    // Evict cache entries for lines that no longer exist (moved/edited/removed).
-    for (auto it = m_lineCache.begin(); it != m_lineCache.end();) {
-        if (!liveSigs.contains(it.key()))
-            it = m_lineCache.erase(it);
-        else
-            ++it;
+    // --- 3. Rasterize the misses (in parallel; one strip per job). ---------
+    Job* jobData = jobs.data();
+    forEachIndex(pool, jobs.size(), [&](int j) {
+        if (isCancelled())
+            return;
+        Job& job = jobData[j];
+        job.strip = rasterizeStrokes(*sets[job.set], job.group.strokeIndices,
+                                     targetStripHeightPx());
+    });
+
+    // The caller discards a cancelled call; skip the recognizer and leave
+    // both caches as they are.
+    if (isCancelled())
+        return QVector<QVector<Result>>(sets.size());
+
+    // --- 4. One recognizer call for every miss, so batching backends see the
+    //        whole page (or the whole batch of pages) at once. ---------------
+    QVector<QImage> strips;
+    QVector<int> stripJob;
+    strips.reserve(jobs.size());
+    stripJob.reserve(jobs.size());
+    for (int j = 0; j < jobs.size(); ++j) {
+        if (jobs[j].strip.image.isNull())
+            continue; // nothing to draw; the line is dropped
+        strips.append(jobs[j].strip.image);
+        stripJob.append(j);
+    }
+
+    QVector<Result> built(jobs.size());
+    QVector<bool> recognized(jobs.size(), false);
+    if (!strips.isEmpty()) {
+        const QVector<ImageRecognition> recs = recognizeImages(strips, m_languageTag);
+
+        // Stored under the recognizer that actually ran: recognizing may
+        // just have downloaded the language's model.
+        const quint64 ranWith = m_diskCache
+            ? OcrLineCache::recognizerKey(engineId(), modelFingerprint(m_languageTag),
+                                          m_languageTag, targetStripHeightPx())
+            : 0;
+
+        for (int k = 0; k < stripJob.size() && k < recs.size(); ++k) {
+            const int j = stripJob[k];
+            const Job& job = jobs[j];
+            if (!recs[k].text.isEmpty()) {
+                built[j] = buildResult(job.group, *sets[job.set], job.strip.transform, recs[k]);
+                recognized[j] = true;
+                m_lineCache.insert(job.sig, CachedLine{built[j]});
+            }
+            if (m_diskCache && !recs[k].failed)
+                m_diskCache->insert(OcrLineCache::lineKey(ranWith, job.sig), built[j]);
+        }
+        if (m_diskCache)
+            m_diskCache->flush();
     }
 
+    QVector<QVector<Result>> results(sets.size());
+    for (int s = 0; s < sets.size(); ++s) {
+        results[s].reserve(lineSlots[s].size());
+        for (Slot& slot : lineSlots[s]) {
+            if (slot.job < 0)
+                results[s].append(std::move(slot.cached));
+            else if (recognized[slot.job])
+                results[s].append(built[slot.job]);
+        }
+    }
     return results;
 }
 
 OcrEngine::Result RasterOcrEngine::buildResult(const StrokeLineGroup& group,
+                                               const QVector<VectorStroke>& strokes,
                                                const RasterTransform& transform,
-                                               const ImageRecognition& rec) const
+                                               const ImageRecognition& rec)
 {
     Result r;
     r.text = rec.text;
@@ -274,8 +486,8 @@ OcrEngine::Result RasterOcrEngine::buildResult(const StrokeLineGroup& group,
     r.confidence = 1.0f;
     r.sourceStrokeIds.reserve(group.strokeIndices.size());
     for (int idx : group.strokeIndices) {
-        if (idx >= 0 && idx < m_strokes.size())
-            r.sourceStrokeIds.append(m_strokes[idx].id);
+        if (idx >= 0 && idx < strokes.size())
+            r.sourceStrokeIds.append(strokes[idx].id.toString());
     }
 
     const bool haveChars = !rec.text.isEmpty()
@@ -13,11 +13,18 @@
 //   - normalized rasterization (OcrStrokeRasterizer)
 //   - a line-signature cache that gives raster engines incremental-like
 //     behavior: only changed lines are re-rendered/re-recognized (QA Q2.x)
+//   - an optional persistent line cache (OcrLineCache) consulted after the
+//     in-memory one, so unchanged ink is not recognized again after a restart
+//   - batching: every cache-missing strip of a page (or of all sets passed to
+//     analyzeBatch()) reaches the backend in one recognizeImages() call
+//   - parallel preparation: line grouping and rasterization of independent
+//     sets/lines run on a private thread pool (InferenceOptions::prepareThreads)
 //   - per-character geometry mapped back to canvas space and assembled into
 //     Latin-word / CJK-glyph WordSegments (QA Q3.2)
 //
 // Concrete backends implement only recognizeImage() plus the OcrEngine
-// availability/identity hooks (engineId/isAvailable/availableLanguages).
+// availability/identity hooks (engineId/isAvailable/availableLanguages), and
+// may override recognizeImages() to run several strips per inference call.
 // ============================================================================
 
 #include "../OcrEngine.h"
@@ -26,9 +33,14 @@
 #include <QHash>
 #include <QImage>
 #include <QRectF>
+#include <QSet>
 #include <QString>
 #include <QVector>
 
+#include <memory>
+
+class OcrLineCache;     // OcrLineCache.h
+class QThreadPool;
 struct RasterTransform; // OcrStrokeRasterizer.h
 struct StrokeLineGroup; // OcrLineGrouper.h
 
@@ -74,6 +86,9 @@ public:
     void removeStrokes(const QVector<QString>& strokeIds) override;
     void clearStrokes() override;
     QVector<Result> analyze() override;
+    QVector<QVector<Result>> analyzeBatch(const QVector<QVector<VectorStroke>>& strokeSets) override;
+    void setPersistentCachePath(const QString& path) override;
+    void setInferenceOptions(const InferenceOptions& options) override;
 
 protected:
     /// Result of an image recognition pass, in image-pixel space.
@@ -82,6 +97,9 @@ protected:
         /// Optional per-character boxes in image-pixel space. When populated,
         /// charBoxesImage.size() == text.length(); otherwise empty.
         QVector<QRectF> charBoxesImage;
+        /// The backend could not run (model missing, inference error). Unlike
+        /// an empty text, a failure is not remembered by the persistent cache.
+        bool failed = false;
     };
 
     /**
@@ -92,15 +110,42 @@ protected:
     virtual ImageRecognition recognizeImage(const QImage& strip,
                                             const QString& languageTag) = 0;
 
+    /**
+     * @brief Recognize many strips at once; result i belongs to strips[i].
+     *
+     * Called once per analyze()/analyzeBatch() with every strip the line
+     * cache could not answer. The default loops recognizeImage(); backends
+     * whose recognizer accepts batched input override it.
+     */
+    virtual QVector<ImageRecognition> recognizeImages(const QVector<QImage>& strips,
+                                                      const QString& languageTag);
+
     /// Target ink height (px) fed to the rasterizer; backends may tune this.
     virtual int targetStripHeightPx() const { return 48; }
 
+    /**
+     * @brief Identity of the recognizer that serves @p languageTag, for the
+     *        persistent cache key. Must change whenever the same strip could
+     *        be recognized differently. Default: the OS version, which is
+     *        what updates a system-provided recognizer.
+     */
+    virtual QByteArray modelFingerprint(const QString& languageTag) const;
+
     QString m_languageTag;
 
 private:
-    Result buildResult(const StrokeLineGroup& group,
-                       const RasterTransform& transform,
-                       const ImageRecognition& rec) const;
+    /// Group, cache-check, rasterize and recognize every set in one pass.
+    /// Signatures of all lines seen are added to @p liveSigs.
+    QVector<QVector<Result>> recognizeStrokeSets(const QVector<const QVector<VectorStroke>*>& sets,
+                                                 QSet<quint64>& liveSigs);
+
+    /// (Re)create m_preparePool for the current prepareThreads option.
+    void resetPreparePool();
+
+    static Result buildResult(const StrokeLineGroup& group,
+                              const QVector<VectorStroke>& strokes,
+                              const RasterTransform& transform,
+                              const ImageRecognition& rec);
 
     QVector<VectorStroke> m_strokes;
     QHash<QString, int> m_strokeIndexById;
@@ -109,4 +154,8 @@ private:
         OcrEngine::Result result;
     };
     QHash<quint64, CachedLine> m_lineCache; ///< key = line signature
+    std::unique_ptr<OcrLineCache> m_diskCache; ///< null unless a path is set
+    /// Helper threads for grouping/rasterizing; null when preparation runs
+    /// sequentially. The calling thread always takes part as well.
+    std::unique_ptr<QThreadPool> m_preparePool;
 };
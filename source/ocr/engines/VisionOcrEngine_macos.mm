@@ -76,8 +76,10 @@ VisionOcrEngine::recognizeImage(const QImage& strip, const QString& languageTag)
             kCGImageAlphaNone, provider, nullptr, false, kCGRenderingIntentDefault);
         CGDataProviderRelease(provider);
         CGColorSpaceRelease(cs);
-        if (!cg)
+        if (!cg) {
+            out.failed = true;
             return out;
+        }
 
         // 2. Configure the request (QA Q6.1).
         VNRecognizeTextRequest *req = [[VNRecognizeTextRequest alloc] init];
@@ -95,6 +97,8 @@ VisionOcrEngine::recognizeImage(const QImage& strip, const QString& languageTag)
         if (!ok || err || req.results.count == 0) {
             if (err)
                 NSLog(@"VisionOcrEngine: performRequests error: %@", err.localizedDescription);
+            // No observations is a genuinely blank strip; an error is not.
+            out.failed = !ok || err != nil;
             return out;
         }
 
@@ -206,8 +206,8 @@ void WindowsInkOcrEngine::addStrokes(const QVector<VectorStroke>& strokes)
             m_impl->analyzer.AddDataForStroke(inkStroke);
 
             uint32_t winrtId = inkStroke.Id();
-            m_impl->uuidToWinrtId[stroke.id] = winrtId;
-            m_impl->winrtIdToUuid[winrtId] = stroke.id;
+            m_impl->uuidToWinrtId[stroke.id.toString()] = winrtId;
+            m_impl->winrtIdToUuid[winrtId] = stroke.id.toString();
 
         } catch (const winrt::hresult_error& e) {
             qWarning() << "WindowsInkOcrEngine: addStroke failed:"
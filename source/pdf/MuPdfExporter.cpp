@@ -9,6 +9,7 @@
 #include "../core/DarkModeUtils.h"
 #include "../core/Document.h"
 #include "../core/Page.h"
+#include "../core/PageCodec.h"
 #include "../layers/VectorLayer.h"
 #include "../objects/ImageObject.h"
 
@@ -16,25 +17,96 @@
 #include <mupdf/pdf.h>
 
 #include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QPainter>
 #include <QRegularExpression>
 #include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>  // For the page preparation pool
 
 #include <algorithm> // for std::sort
 #include <cmath>     // for cosf, sinf, M_PI
+#include <deque>     // for the in-flight page window
+#include <filesystem> // atomic replace of a rebuilt incremental export
 #include <functional> // OUT2: std::function for the outline export-index resolver
 #include <map>       // for ExtGState alpha cache
 #include <unordered_map> // OUT2: notebook-page -> export-index lookup
 #include <vector>    // for content stream tokenizer
 
+// ============================================================================
+// Parallel Page Pipeline Data
+// ============================================================================
+// Plain Qt data passed between the exporting thread and the page preparation
+// workers (see MuPdfExporter::preparePage()). Nothing here touches MuPDF.
+
+/**
+ * @brief One paint-order entry of a page snapshot: a layer's strokes or one image.
+ */
+struct PageItemSnapshot {
+    enum class Kind { Layer, Image };
+    Kind kind = Kind::Layer;
+    bool visible = true;
+
+    // Kind::Layer
+    QVector<VectorStroke> strokes;  ///< Implicitly shared copy of the layer's strokes
+    float opacity = 1.0f;           ///< Layer opacity
+
+    // Kind::Image
+    QImage image;                   ///< Converted from the pixmap on the exporting thread
+    QString imagePath;              ///< For diagnostics only
+    QPointF position;               ///< Top-left, SpeedyNote units
+    QSizeF size;                    ///< Display size, SpeedyNote units
+    qreal rotation = 0.0;           ///< Degrees
+};
+
+/**
+ * @brief A resource referenced by a prepared content stream.
+ *
+ * Kept in the order the resources were first used, so the writer creates
+ * the PDF objects in the same sequence whichever thread prepared the page.
+ */
+struct PreparedResource {
+    enum class Kind { ExtGState, Image };
+    Kind kind = Kind::ExtGState;
+    QByteArray name;                ///< Resource name ("GS0", "Img2", ...)
+    float alpha = 1.0f;             ///< Kind::ExtGState: fill alpha (ca)
+    QByteArray imageData;           ///< Kind::Image: compressed JPEG/PNG bytes
+};
+
+struct MuPdfExporter::PageJob {
+    int pageIndex = -1;
+    const Document* document = nullptr;  ///< For the dark-mode raster (provider calls are thread-safe)
+    QString sourceId;                    ///< PDF source of the background ("" = primary)
+    int pdfPageNumber = -1;              ///< ORIGINAL PDF page number, -1 = none
+    QSizeF pageSize;                     ///< SpeedyNote units (96 DPI)
+    bool rasterDarkBackground = false;   ///< Prepare the inverted raster background
+    QImage customBackground;             ///< Custom background image, or null
+    std::vector<PageItemSnapshot> items; ///< Layers and images in paint order
+    int dpi = 300;
+    bool darkenStrokes = false;
+    bool skipImageMasking = false;
+};
+
+struct MuPdfExporter::PreparedPage {
+    bool prepared = false;                   ///< false if preparation was cancelled
+    QByteArray darkBackground;               ///< Compressed raster dark-mode background, or empty
+    QByteArray customBackground;             ///< Compressed custom background (named Img0), or empty
+    QByteArray annotations;                  ///< "q ... Q" content for layers and objects
+    std::vector<PreparedResource> resources; ///< Resources referenced by annotations
+};
+
 // Forward declarations for static helper functions defined later in this file
-static void appendLayerStrokesToBuffer(fz_context* ctx, pdf_document* outputDoc,
-                                       fz_buffer* buf, pdf_obj* resources,
-                                       const VectorLayer* layer, qreal pageHeightSn,
-                                       int& gsIndex, std::map<int, QString>& alphaToGsName,
+static void appendLayerStrokesToBuffer(QByteArray& buf, std::vector<PreparedResource>& resources,
+                                       const PageItemSnapshot& layer, qreal pageHeightSn,
+                                       int& gsIndex, std::map<int, QByteArray>& alphaToGsName,
                                        bool darkenStrokes = false);
 static int getSourcePageRotation(fz_context* ctx, pdf_document* srcPdf, int pageIndex);
 static fz_rect getSourcePageBBox(fz_context* ctx, pdf_document* srcPdf, int pageIndex);
@@ -45,10 +117,17 @@ static fz_rect getSourcePageBBox(fz_context* ctx, pdf_document* srcPdf, int page
 static pdf_obj* buildAggregatedOutline(fz_context* ctx, pdf_document* outputDoc,
                                        const QVector<PdfOutlineItem>& items,
                                        const std::function<int(const PdfOutlineItem&)>& exportIndexOf);
-static bool addImageToPage(fz_context* ctx, pdf_document* outputDoc,
-                           const ImageObject* img, fz_buffer* contentBuf,
-                           pdf_obj* resources, int imageIndex, float pageHeightPt,
-                           const PdfExportOptions& options);
+static bool appendImageToBuffer(QByteArray& buf, std::vector<PreparedResource>& resources,
+                                const PageItemSnapshot& img, int imageIndex, float pageHeightPt,
+                                int targetDpi);
+static QByteArray renderDarkBackground(const Document* document, const QString& sourceId,
+                                       int pdfPageNumber, const QSizeF& pageSizePt,
+                                       int targetDpi, bool skipImageMasking);
+static pdf_obj* addCompressedImage(fz_context* ctx, pdf_document* outputDoc,
+                                   const QByteArray& compressed);
+static void addPreparedResources(fz_context* ctx, pdf_document* outputDoc, pdf_obj* resources,
+                                 const std::vector<PreparedResource>& prepared);
+static bool replaceFile(const QString& from, const QString& to);
 
 /**
  * @brief Scale factor from SpeedyNote units (96 DPI) to PDF points (72 DPI).
@@ -744,6 +823,15 @@ PdfExportResult MuPdfExporter::exportPdf(const PdfExportOptions& options)
         return result;
     }
     
+    // Incremental export: load the previous export's manifest. Pages are
+    // hashed as they are dispatched below. Before openSourcePdf(): its graft
+    // maps are bound to the output document, which append-update mode replaces.
+    QVector<QByteArray> pageHashes;
+    if (options.incremental) {
+        pageHashes.resize(pageIndices.size());
+        openPreviousExport(static_cast<int>(pageIndices.size()));
+    }
+    
     // Open source PDF if document has one
     if (!openSourcePdf()) {
         // Use detailed error message if available
@@ -756,10 +844,102 @@ PdfExportResult MuPdfExporter::exportPdf(const PdfExportOptions& options)
         return result;
     }
     
+    // Rendered pages are prepared (strokes tessellated, images compressed,
+    // dark-mode rasters rendered) on a private pool up to `window` pages ahead
+    // of the writer loop below, which assembles them in page order. Workers
+    // read the PDF providers, so open them all here: providerForSource() opens
+    // lazily and must not race.
+    m_document->ensureAllPdfProvidersLoaded();
+    QThreadPool preparePool;
+    preparePool.setMaxThreadCount(preparationThreads());
+    const int window = preparePool.maxThreadCount() * IN_FLIGHT_PAGES_PER_THREAD;
+    
+    enum class PageRoute { Missing, Graft, Modified, Blank, Reuse };
+    struct InFlightPage {
+        int pageIndex = -1;
+        PageRoute route = PageRoute::Missing;
+        int reuseFrom = -1;  // PageRoute::Reuse: page of the previous export
+        bool hasPdfBinding = false;
+        QString sourceId;
+        QFuture<PreparedPage> prepared;
+    };
+    std::deque<InFlightPage> inFlight;
+    const std::atomic<bool>* cancelled = &m_cancelled;
+    
+    // Decide how a page is exported and queue its preparation. Runs on this
+    // thread: it loads pages and opens source PDFs.
+    auto dispatchPage = [&](int outputIndex) {
+        InFlightPage entry;
+        const int pageIndex = pageIndices[outputIndex];
+        entry.pageIndex = pageIndex;
+        
+        Page* currentPage = m_document->page(pageIndex);
+        if (!currentPage) {
+            inFlight.push_back(std::move(entry));
+            return;
+        }
+        
+        // Incremental export: unchanged since the previous export?
+        if (options.incremental) {
+            pageHashes[outputIndex] = pageContentHash(pageIndex, currentPage);
+            entry.reuseFrom = reusablePreviousPage(outputIndex, pageHashes[outputIndex]);
+            if (entry.reuseFrom >= 0) {
+                entry.route = PageRoute::Reuse;
+                inFlight.push_back(std::move(entry));
+                return;
+            }
+        }
+        
+        // Each page is exported against its own PDF source (multi-source docs).
+        int pdfPage = -1;
+        entry.hasPdfBinding = m_document->pdfBindingForNotebookPage(pageIndex, entry.sourceId, pdfPage);
+        SourceHandles* source = entry.hasPdfBinding ? sourceHandlesFor(entry.sourceId) : nullptr;
+        const bool hasPdf = source && source->pdf && currentPage->pdfPageNumber >= 0;
+        
+        if (isPageModified(pageIndex)) {
+            // Page has annotations - need to render, over the PDF page if any
+            entry.route = hasPdf ? PageRoute::Modified : PageRoute::Blank;
+        } else if (hasPdf) {
+            // Unmodified page with PDF. Dark mode export requires color
+            // rewriting, can't byte-copy.
+            entry.route = m_options.darkModeBackground ? PageRoute::Modified : PageRoute::Graft;
+        } else {
+            // Unmodified blank page - still need to render
+            entry.route = PageRoute::Blank;
+        }
+        
+        if (entry.route == PageRoute::Modified || entry.route == PageRoute::Blank) {
+            const bool rasterDark = entry.route == PageRoute::Modified &&
+                                    !m_options.annotationsOnly &&
+                                    m_options.darkModeBackground && m_options.skipImageMasking;
+            PageJob job;
+            snapshotPage(pageIndex, currentPage, rasterDark, job);
+            job.sourceId = entry.sourceId;
+            entry.prepared = QtConcurrent::run(&preparePool, [job = std::move(job), cancelled]() {
+                return preparePage(job, *cancelled);
+            });
+        }
+        inFlight.push_back(std::move(entry));
+    };
+    
     // Process each page
     int total = static_cast<int>(pageIndices.size());
+    int nextToDispatch = 0;
     for (int i = 0; i < total; ++i) {
+        while (nextToDispatch < total && nextToDispatch < i + window) {
+            dispatchPage(nextToDispatch++);
+        }
+        InFlightPage entry = std::move(inFlight.front());
+        inFlight.pop_front();
+        
+        PreparedPage prepared;
+        if (entry.route == PageRoute::Modified || entry.route == PageRoute::Blank) {
+            prepared = entry.prepared.result();  // Blocks until the worker is done
+            entry.prepared = QFuture<PreparedPage>();
+        }
+        
         if (m_cancelled.load()) {
+            preparePool.clear();
             result.errorMessage = tr("Export cancelled");
             cleanup();
             emit exportCancelled();
@@ -767,49 +947,42 @@ PdfExportResult MuPdfExporter::exportPdf(const PdfExportOptions& options)
             return result;
         }
         
-        int pageIndex = pageIndices[i];
+        int pageIndex = entry.pageIndex;
         emit progressUpdated(i + 1, total);
         
+        // Point the active-source aliases at THIS page's own PDF source so that
+        // graft/render/import operate on the correct source (multi-source docs).
+        if (entry.hasPdfBinding) {
+            activateSource(entry.sourceId);
+        }
+        
         bool pageSuccess = false;
+        switch (entry.route) {
+            case PageRoute::Missing:
+                qWarning() << "[MuPdfExporter] Failed to get page" << pageIndex;
+                break;
+            case PageRoute::Graft:
+                pageSuccess = graftPage(pageIndex);
+                break;
+            case PageRoute::Modified:
+                pageSuccess = renderModifiedPage(pageIndex, prepared);
+                break;
+            case PageRoute::Blank:
+                pageSuccess = renderBlankPage(pageIndex, prepared);
+                break;
+            case PageRoute::Reuse:
+                // In append-update mode the page is already in place
+                pageSuccess = m_appendUpdate || reusePreviousPage(entry.reuseFrom);
+                break;
+        }
         
-        // Determine how to handle this page
-        Page* currentPage = m_document->page(pageIndex);
-        if (!currentPage) {
-            qWarning() << "[MuPdfExporter] Failed to get page" << pageIndex;
-            pageSuccess = false;
-        } else {
-            // Point the active-source aliases at THIS page's own PDF source so that
-            // graft/render/import operate on the correct source (multi-source docs).
-            QString srcId;
-            int pdfPage = -1;
-            if (m_document->pdfBindingForNotebookPage(pageIndex, srcId, pdfPage)) {
-                activateSource(srcId);
-            }
-
-            if (isPageModified(pageIndex)) {
-                // Page has annotations - need to render
-                if (currentPage->pdfPageNumber >= 0 && m_sourcePdf) {
-                    // Modified page with PDF background
-                    pageSuccess = renderModifiedPage(pageIndex);
-                } else {
-                    // No PDF background (blank notebook page)
-                    pageSuccess = renderBlankPage(pageIndex);
-                }
-            } else if (m_sourcePdf && currentPage->pdfPageNumber >= 0) {
-                // Unmodified page with PDF
-                if (m_options.darkModeBackground) {
-                    // Dark mode export requires color rewriting, can't byte-copy
-                    pageSuccess = renderModifiedPage(pageIndex);
-                } else {
-                    pageSuccess = graftPage(pageIndex);
-                }
-            } else {
-                // Unmodified blank page - still need to render
-                pageSuccess = renderBlankPage(pageIndex);
-            }
+        // Append-update mode: the new page was appended; swap it in
+        if (pageSuccess && m_appendUpdate && entry.route != PageRoute::Reuse) {
+            pageSuccess = replacePageWithLast(i);
         }
         
         if (!pageSuccess) {
+            preparePool.clear();
             result.errorMessage = tr("Failed to export page %1").arg(pageIndex + 1);
             cleanup();
             emit exportFailed(result.errorMessage);
@@ -818,6 +991,9 @@ PdfExportResult MuPdfExporter::exportPdf(const PdfExportOptions& options)
         }
         
         result.pagesExported++;
+        if (entry.route == PageRoute::Reuse) {
+            result.pagesReused++;
+        }
     }
     
     // Metadata and outline are taken from the PRIMARY source; re-activate it since
@@ -834,14 +1010,26 @@ PdfExportResult MuPdfExporter::exportPdf(const PdfExportOptions& options)
         qWarning() << "[MuPdfExporter] Failed to write outline (non-fatal)";
     }
     
-    // Save to disk
-    if (!saveDocument(options.outputPath)) {
+    // Save to disk. A rebuild that reused pages reads the previous file
+    // until the end, so it is written next to it and moved into place.
+    const bool replacesPrevious = m_previous.doc && !m_appendUpdate;
+    const QString savePath = replacesPrevious ? options.outputPath + QStringLiteral(".part")
+                                              : options.outputPath;
+    const bool appendUpdate = m_appendUpdate;
+    const qint64 previousSize = appendUpdate ? QFileInfo(options.outputPath).size() : -1;
+    if (!saveDocument(savePath, appendUpdate)) {
         result.errorMessage = tr("Failed to save PDF file");
         cleanup();
         
-        // Clean up partial output file if it exists
-        if (QFile::exists(options.outputPath)) {
-            QFile::remove(options.outputPath);
+        if (appendUpdate) {
+            // Drop a partial update section; the previous export stays valid
+            QFile previous(options.outputPath);
+            if (previous.size() > previousSize) {
+                previous.resize(previousSize);
+            }
+        } else if (QFile::exists(savePath)) {
+            // Clean up partial output file if it exists
+            QFile::remove(savePath);
             #ifdef SPEEDYNOTE_DEBUG
             qDebug() << "[MuPdfExporter] Removed partial output file";
             #endif
@@ -851,6 +1039,19 @@ PdfExportResult MuPdfExporter::exportPdf(const PdfExportOptions& options)
         m_isExporting = false;
         return result;
     }
+    if (replacesPrevious) {
+        closePreviousExport();
+        if (!replaceFile(savePath, options.outputPath)) {
+            // The previous export is untouched; keep the new one next to it
+            result.errorMessage = tr("Failed to replace %1. The new export was saved as %2")
+                                      .arg(options.outputPath, savePath);
+            cleanup();
+            emit exportFailed(result.errorMessage);
+            m_isExporting = false;
+            return result;
+        }
+    }
+    result.appendedUpdate = appendUpdate;
     
     // Get file size
     QFileInfo fileInfo(options.outputPath);
@@ -858,12 +1059,24 @@ PdfExportResult MuPdfExporter::exportPdf(const PdfExportOptions& options)
     
     // Cleanup and signal success
     cleanup();
+    
+    // The manifest describes the file just written; a full export leaves
+    // nothing for a later incremental one to trust.
+    if (options.incremental) {
+        if (!writeManifest(options.outputPath, pageHashes)) {
+            qWarning() << "[MuPdfExporter] Failed to write export manifest (non-fatal)";
+        }
+    } else {
+        QFile::remove(manifestPath(options.outputPath));
+    }
+    
     result.success = true;
     m_isExporting = false;
     #ifdef SPEEDYNOTE_DEBUG
     qDebug() << "[MuPdfExporter] Export complete:"
-             << result.pagesExported << "pages,"
-             << (result.fileSizeBytes / 1024) << "KB";
+             << result.pagesExported << "pages," << result.pagesReused << "reused,"
+             << (result.fileSizeBytes / 1024) << "KB"
+             << (result.appendedUpdate ? "(incremental update)" : "");
     #endif
     emit exportComplete();
     return result;
@@ -1034,6 +1247,14 @@ void MuPdfExporter::cleanup()
     }
     m_sources.clear();
     m_currentSourceId.clear();
+    
+    // Previous export (incremental). In append-update mode m_outputDoc holds
+    // its own reference to the same document, dropped below.
+    closePreviousExport();
+    m_previousHashes.clear();
+    m_previousPageFor.clear();
+    m_appendUpdate = false;
+    m_sourceIdentities.clear();
 
     // Active-source aliases are non-owning; just clear them.
     m_sourceDoc = nullptr;
@@ -1260,7 +1481,459 @@ bool MuPdfExporter::graftPage(int pageIndex)
     return true;
 }
 
-bool MuPdfExporter::renderModifiedPage(int pageIndex)
+// ============================================================================
+// Incremental Export
+// ============================================================================
+
+// Part of exportSettingsKey(): bump when the same page content would export
+// differently, so manifests written by older versions are not trusted.
+static constexpr int EXPORT_MANIFEST_VERSION = 1;
+
+/**
+ * @brief Move @p from over @p to in one step (rename(2) on POSIX, MoveFileEx
+ *        with MOVEFILE_REPLACE_EXISTING on Windows).
+ *
+ * Unlike remove + QFile::rename(), there is no moment without a file at
+ * @p to, and a failure leaves both files as they were.
+ */
+static bool replaceFile(const QString& from, const QString& to)
+{
+#ifdef Q_OS_WIN
+    const std::filesystem::path source(from.toStdWString());
+    const std::filesystem::path target(to.toStdWString());
+#else
+    const std::filesystem::path source(QFile::encodeName(from).toStdString());
+    const std::filesystem::path target(QFile::encodeName(to).toStdString());
+#endif
+    std::error_code error;
+    std::filesystem::rename(source, target, error);
+    if (error) {
+        qWarning() << "[MuPdfExporter] Failed to move" << from << "to" << to << ":"
+                   << QString::fromStdString(error.message());
+        return false;
+    }
+    return true;
+}
+
+QString MuPdfExporter::manifestPath(const QString& outputPath)
+{
+    return outputPath + QStringLiteral(".snexport");
+}
+
+QJsonObject MuPdfExporter::readManifest(const QString& outputPath, const QString& documentId)
+{
+    QFile manifestFile(manifestPath(outputPath));
+    if (documentId.isEmpty() || !manifestFile.open(QIODevice::ReadOnly)) {
+        return QJsonObject();  // Nothing exported here with a manifest yet
+    }
+    const QJsonObject manifest = QJsonDocument::fromJson(manifestFile.readAll()).object();
+    manifestFile.close();
+    
+    // The manifest must describe this very file, exported from this notebook
+    const QFileInfo outputInfo(outputPath);
+    if (!outputInfo.exists() ||
+        manifest.value(QStringLiteral("document")).toString() != documentId ||
+        qint64(manifest.value(QStringLiteral("outputSize")).toDouble(-1)) != outputInfo.size() ||
+        qint64(manifest.value(QStringLiteral("outputModified")).toDouble(-1)) !=
+            outputInfo.lastModified().toMSecsSinceEpoch()) {
+        return QJsonObject();
+    }
+    return manifest;
+}
+
+bool MuPdfExporter::isIncrementalExportOf(const QString& outputPath, const QString& documentId)
+{
+    return !readManifest(outputPath, documentId).isEmpty();
+}
+
+QString MuPdfExporter::exportSettingsKey() const
+{
+    return QStringLiteral("v%1;dpi=%2;annotationsOnly=%3;dark=%4;darkenStrokes=%5;"
+                          "skipImageMasking=%6;metadata=%7;outline=%8")
+        .arg(EXPORT_MANIFEST_VERSION)
+        .arg(m_options.dpi)
+        .arg(int(m_options.annotationsOnly))
+        .arg(int(m_options.darkModeBackground))
+        .arg(int(m_options.darkenStrokes))
+        .arg(int(m_options.skipImageMasking))
+        .arg(int(m_options.preserveMetadata))
+        .arg(int(m_options.preserveOutline));
+}
+
+QByteArray MuPdfExporter::pageContentHash(int pageIndex, const Page* page)
+{
+    // The page as PageCodec would store it: the JSON header minus what never
+    // reaches the PDF (identity, bookmarks, editor state), so renumbering or
+    // bookmarking a page does not force it to be rendered again, plus the
+    // packed stroke columns (no per-point JSON).
+    QJsonObject meta = page->toJson(false);
+    meta.remove(QStringLiteral("uuid"));
+    meta.remove(QStringLiteral("pageIndex"));
+    meta.remove(QStringLiteral("isBookmarked"));
+    meta.remove(QStringLiteral("bookmarkLabel"));
+    meta.remove(QStringLiteral("activeLayerIndex"));
+    
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(PageCodec::encode(meta, page->layerStrokeLists()));
+    
+    // The custom background pixmap is not part of the JSON
+    if (page->backgroundType == Page::BackgroundType::Custom && !page->customBackground.isNull()) {
+        const QImage image = page->customBackground.toImage();
+        hash.addData(QStringLiteral("bg:%1x%2:%3;").arg(image.width()).arg(image.height())
+                         .arg(int(image.format())).toLatin1());
+        hash.addData(QByteArray::fromRawData(reinterpret_cast<const char*>(image.constBits()),
+                                             int(image.sizeInBytes())));
+    }
+    
+    // The PDF page behind it: which file, which version of it, which page
+    QString sourceId;
+    int pdfPage = -1;
+    if (m_document->pdfBindingForNotebookPage(pageIndex, sourceId, pdfPage)) {
+        auto it = m_sourceIdentities.constFind(sourceId);
+        if (it == m_sourceIdentities.constEnd()) {
+            const QFileInfo info(m_document->pdfPathForSource(sourceId));
+            const QString identity = info.exists()
+                ? QStringLiteral("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size())
+                      .arg(info.lastModified().toMSecsSinceEpoch())
+                : QStringLiteral("missing|%1").arg(info.filePath());
+            it = m_sourceIdentities.insert(sourceId, identity.toUtf8());
+        }
+        hash.addData(it.value());
+        hash.addData(QByteArray::number(
+            m_document->resolveSourcePageIndex(page->pdfSourceId, page->pdfPageNumber)));
+    }
+    
+    return hash.result();
+}
+
+void MuPdfExporter::openPreviousExport(int pageCount)
+{
+    const QString& outputPath = m_options.outputPath;
+    const QJsonObject manifest = readManifest(outputPath, m_document->id);
+    if (manifest.value(QStringLiteral("settings")).toString() != exportSettingsKey()) {
+        #ifdef SPEEDYNOTE_DEBUG
+        qDebug() << "[MuPdfExporter] Manifest does not match" << outputPath << "- full export";
+        #endif
+        return;
+    }
+    
+    QVector<QByteArray> previousHashes;
+    const QJsonArray pages = manifest.value(QStringLiteral("pages")).toArray();
+    for (const QJsonValue& value : pages) {
+        previousHashes.append(QByteArray::fromHex(value.toString().toLatin1()));
+    }
+    
+    QByteArray pathUtf8 = outputPath.toUtf8();
+    int previousPageCount = -1;
+    fz_try(m_ctx) {
+        m_previous.doc = fz_open_document(m_ctx, pathUtf8.constData());
+        m_previous.pdf = pdf_document_from_fz_document(m_ctx, m_previous.doc);
+        if (m_previous.pdf) {
+            previousPageCount = pdf_count_pages(m_ctx, m_previous.pdf);
+        }
+    }
+    fz_catch(m_ctx) {
+        qWarning() << "[MuPdfExporter] Failed to open previous export:" << fz_caught_message(m_ctx);
+    }
+    if (previousPageCount != previousHashes.size()) {
+        closePreviousExport();
+        return;
+    }
+    
+    int canAppend = 0;
+    if (m_options.appendUpdate && previousPageCount == pageCount) {
+        fz_try(m_ctx) {
+            canAppend = pdf_can_be_saved_incrementally(m_ctx, m_previous.pdf);
+        }
+        fz_catch(m_ctx) {
+            canAppend = 0;
+        }
+    }
+    
+    if (canAppend) {
+        // Append-update: the previous file becomes the output document. Pages
+        // unchanged at the same position stay; the others are replaced.
+        bool adopted = true;
+        fz_try(m_ctx) {
+            // Rewritten by writeOutline() if still wanted
+            pdf_obj* catalog = pdf_dict_get(m_ctx, pdf_trailer(m_ctx, m_previous.pdf), PDF_NAME(Root));
+            pdf_dict_del(m_ctx, catalog, PDF_NAME(Outlines));
+            pdf_dict_del(m_ctx, catalog, PDF_NAME(PageMode));
+        }
+        fz_catch(m_ctx) {
+            adopted = false;
+        }
+        if (adopted) {
+            pdf_drop_document(m_ctx, m_outputDoc);
+            m_outputDoc = pdf_keep_document(m_ctx, m_previous.pdf);
+            m_appendUpdate = true;
+            m_previousHashes = previousHashes;
+            return;
+        }
+    }
+    
+    // Rebuild: graft unchanged pages from the previous file, wherever they
+    // were (pages may have been inserted, removed or reordered since).
+    fz_try(m_ctx) {
+        m_previous.graft = pdf_new_graft_map(m_ctx, m_outputDoc);
+    }
+    fz_catch(m_ctx) {
+        qWarning() << "[MuPdfExporter] Failed to map previous export:" << fz_caught_message(m_ctx);
+    }
+    if (!m_previous.graft) {
+        closePreviousExport();
+        return;
+    }
+    
+    for (int i = static_cast<int>(previousHashes.size()) - 1; i >= 0; --i) {
+        if (!previousHashes[i].isEmpty()) {
+            m_previousPageFor.insert(previousHashes[i], i);  // First occurrence wins
+        }
+    }
+}
+
+int MuPdfExporter::reusablePreviousPage(int outputIndex, const QByteArray& pageHash) const
+{
+    if (pageHash.isEmpty()) {
+        return -1;
+    }
+    if (m_appendUpdate) {
+        // Only pages unchanged at the same position stay in place
+        return (outputIndex < m_previousHashes.size() && m_previousHashes[outputIndex] == pageHash)
+            ? outputIndex : -1;
+    }
+    return m_previous.graft ? m_previousPageFor.value(pageHash, -1) : -1;
+}
+
+void MuPdfExporter::closePreviousExport()
+{
+    // The graft map references the previous document; drop it first
+    if (m_previous.graft) {
+        pdf_drop_graft_map(m_ctx, m_previous.graft);
+    }
+    if (m_previous.doc) {
+        fz_drop_document(m_ctx, m_previous.doc);
+    }
+    m_previous = SourceHandles{};
+}
+
+bool MuPdfExporter::reusePreviousPage(int previousIndex)
+{
+    if (!m_previous.pdf || !m_previous.graft || !m_outputDoc || !m_ctx) {
+        return false;
+    }
+    
+    fz_try(m_ctx) {
+        // The previous output page already holds background, strokes and
+        // images; copy it like an unmodified source page.
+        pdf_graft_mapped_page(m_ctx, m_previous.graft, -1, m_previous.pdf, previousIndex);
+    }
+    fz_catch(m_ctx) {
+        qWarning() << "[MuPdfExporter] Failed to reuse page" << previousIndex
+                   << "of the previous export:" << fz_caught_message(m_ctx);
+        return false;
+    }
+    
+    return true;
+}
+
+bool MuPdfExporter::replacePageWithLast(int outputIndex)
+{
+    bool success = true;
+    pdf_obj* pageObj = nullptr;
+    fz_var(pageObj);
+    
+    fz_try(m_ctx) {
+        const int last = pdf_count_pages(m_ctx, m_outputDoc) - 1;
+        pageObj = pdf_keep_obj(m_ctx, pdf_lookup_page_obj(m_ctx, m_outputDoc, last));
+        pdf_delete_page(m_ctx, m_outputDoc, last);
+        pdf_delete_page(m_ctx, m_outputDoc, outputIndex);
+        pdf_insert_page(m_ctx, m_outputDoc, outputIndex, pageObj);
+    }
+    fz_always(m_ctx) {
+        pdf_drop_obj(m_ctx, pageObj);
+    }
+    fz_catch(m_ctx) {
+        qWarning() << "[MuPdfExporter] Failed to replace page" << outputIndex
+                   << ":" << fz_caught_message(m_ctx);
+        success = false;
+    }
+    
+    return success;
+}
+
+bool MuPdfExporter::writeManifest(const QString& outputPath, const QVector<QByteArray>& pageHashes)
+{
+    QJsonArray pages;
+    for (const QByteArray& pageHash : pageHashes) {
+        pages.append(QString::fromLatin1(pageHash.toHex()));
+    }
+    
+    const QFileInfo outputInfo(outputPath);
+    QJsonObject manifest;
+    manifest[QStringLiteral("document")] = m_document->id;
+    manifest[QStringLiteral("settings")] = exportSettingsKey();
+    manifest[QStringLiteral("outputSize")] = double(outputInfo.size());
+    manifest[QStringLiteral("outputModified")] = double(outputInfo.lastModified().toMSecsSinceEpoch());
+    manifest[QStringLiteral("pages")] = pages;
+    
+    QFile file(manifestPath(outputPath));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+// ============================================================================
+// Parallel Page Pipeline
+// ============================================================================
+
+int MuPdfExporter::preparationThreads() const
+{
+    const int threads = m_options.maxThreads > 0 ? m_options.maxThreads
+                                                 : QThread::idealThreadCount();
+    return qBound(1, threads, MAX_PREPARE_THREADS);
+}
+
+void MuPdfExporter::snapshotPage(int pageIndex, const Page* page, bool rasterDarkBackground,
+                                 PageJob& job) const
+{
+    job.pageIndex = pageIndex;
+    job.document = m_document;
+    job.pdfPageNumber = page->pdfPageNumber;
+    job.pageSize = page->size;
+    job.rasterDarkBackground = rasterDarkBackground;
+    job.dpi = m_options.dpi;
+    job.darkenStrokes = m_options.darkenStrokes;
+    job.skipImageMasking = m_options.skipImageMasking;
+    
+    // Custom background image (covers the page; skipped in annotations-only mode)
+    if (!m_options.annotationsOnly &&
+        page->backgroundType == Page::BackgroundType::Custom &&
+        !page->customBackground.isNull()) {
+        job.customBackground = page->customBackground.toImage();
+    }
+    
+    // Paint order with layer affinity:
+    // 1. Objects with affinity -1 (below all strokes)
+    // 2. Layer 0 strokes, then objects with affinity 0
+    // 3. Layer 1 strokes, then objects with affinity 1, ... and so on
+    // 4. Objects with affinity >= numLayers (always on top)
+    auto addObjects = [&job](const std::vector<InsertedObject*>& objects) {
+        // Sort by zOrder (the map stores pointers, not owned objects)
+        std::vector<InsertedObject*> sorted = objects;
+        std::sort(sorted.begin(), sorted.end(), 
+                  [](const InsertedObject* a, const InsertedObject* b) {
+                      return a->zOrder < b->zOrder;
+                  });
+        
+        for (const InsertedObject* obj : sorted) {
+            if (obj->type() != QStringLiteral("image")) {
+                continue;
+            }
+            const ImageObject* imgObj = dynamic_cast<const ImageObject*>(obj);
+            if (!imgObj || !imgObj->isLoaded()) {
+                continue;
+            }
+            PageItemSnapshot item;
+            item.kind = PageItemSnapshot::Kind::Image;
+            item.visible = imgObj->visible;
+            item.imagePath = imgObj->imagePath;
+            item.position = imgObj->position;
+            item.size = imgObj->size;
+            item.rotation = imgObj->rotation;
+            if (item.visible) {
+                item.image = imgObj->pixmap().toImage();
+            }
+            job.items.push_back(std::move(item));
+        }
+    };
+    
+    int numLayers = static_cast<int>(page->vectorLayers.size());
+    
+    auto below = page->objectsByAffinity.find(-1);
+    if (below != page->objectsByAffinity.end()) {
+        addObjects(below->second);
+    }
+    
+    for (int layerIdx = 0; layerIdx < numLayers; ++layerIdx) {
+        const VectorLayer* layer = page->vectorLayers[layerIdx].get();
+        if (layer) {
+            PageItemSnapshot item;
+            item.kind = PageItemSnapshot::Kind::Layer;
+            item.visible = layer->visible;
+            item.opacity = static_cast<float>(layer->opacity);
+            item.strokes = layer->strokes();
+            job.items.push_back(std::move(item));
+        }
+        
+        auto above = page->objectsByAffinity.find(layerIdx);
+        if (above != page->objectsByAffinity.end()) {
+            addObjects(above->second);
+        }
+    }
+    
+    for (const auto& [affinity, objects] : page->objectsByAffinity) {
+        if (affinity >= numLayers) {
+            addObjects(objects);
+        }
+    }
+}
+
+MuPdfExporter::PreparedPage MuPdfExporter::preparePage(const PageJob& job,
+                                                       const std::atomic<bool>& cancelled)
+{
+    PreparedPage out;
+    if (cancelled.load()) {
+        return out;
+    }
+    
+    // Convert page size from SpeedyNote units (96 DPI) to PDF points (72 DPI)
+    float widthPt = job.pageSize.width() * SN_TO_PDF_SCALE;
+    float heightPt = job.pageSize.height() * SN_TO_PDF_SCALE;
+    QSizeF pageSizePt(widthPt, heightPt);
+    
+    // Dark mode background: rasterize PDF page, invert, compress
+    if (job.rasterDarkBackground && job.document) {
+        out.darkBackground = renderDarkBackground(job.document, job.sourceId, job.pdfPageNumber,
+                                                  pageSizePt, job.dpi, job.skipImageMasking);
+        if (cancelled.load()) {
+            return out;
+        }
+    }
+    
+    if (!job.customBackground.isNull()) {
+        out.customBackground = compressImage(job.customBackground,
+                                             job.customBackground.hasAlphaChannel(),
+                                             pageSizePt, job.dpi);
+    }
+    
+    // Resource names are numbered per page, in paint order. The custom
+    // background takes Img0 when present.
+    int imageIndex = out.customBackground.isEmpty() ? 0 : 1;
+    int gsIndex = 0;  // Counter for ExtGState names (for stroke transparency)
+    std::map<int, QByteArray> alphaToGsName;  // Cache: alpha (0-100) -> GS name
+    qreal pageHeightSn = job.pageSize.height();
+    
+    // Save graphics state for strokes/objects
+    out.annotations.append("q\n");
+    for (const PageItemSnapshot& item : job.items) {
+        if (item.kind == PageItemSnapshot::Kind::Layer) {
+            appendLayerStrokesToBuffer(out.annotations, out.resources, item, pageHeightSn,
+                                       gsIndex, alphaToGsName, job.darkenStrokes);
+        } else {
+            appendImageToBuffer(out.annotations, out.resources, item, imageIndex++,
+                                heightPt, job.dpi);
+        }
+    }
+    // Restore graphics state
+    out.annotations.append("Q\n");
+    
+    out.prepared = true;
+    return out;
+}
+
+bool MuPdfExporter::renderModifiedPage(int pageIndex, const PreparedPage& prepared)
 {
     if (!m_outputDoc || !m_ctx || !m_document) {
         return false;
@@ -1277,7 +1950,7 @@ bool MuPdfExporter::renderModifiedPage(int pageIndex)
     int pdfPageNum = m_document->resolveSourcePageIndex(page->pdfSourceId, origPageNum);
     if (origPageNum < 0 || pdfPageNum < 0 || !m_sourcePdf) {
         // No PDF background - use blank page rendering
-        return renderBlankPage(pageIndex);
+        return renderBlankPage(pageIndex, prepared);
     }
     
     QSizeF pageSize = page->size;
@@ -1309,7 +1982,7 @@ bool MuPdfExporter::renderModifiedPage(int pageIndex)
             bgXObject = importPageAsXObject(pdfPageNum);
             if (!bgXObject) {
                 qWarning() << "[MuPdfExporter] Failed to import PDF page as XObject, falling back to blank";
-                return renderBlankPage(pageIndex);
+                return renderBlankPage(pageIndex, prepared);
             }
         }
     }
@@ -1325,42 +1998,32 @@ bool MuPdfExporter::renderModifiedPage(int pageIndex)
         // Create Resources dictionary
         resources = pdf_new_dict(m_ctx, m_outputDoc, 4);
         
-        // Dark mode background: rasterize PDF page, invert, embed as image
+        // Dark mode background: rasterize PDF page, invert, embed as image.
+        // Normally prepared by a worker; the XObject-import fallback above is
+        // only discovered here, so that case renders synchronously.
         if (bgIsRasterDarkMode && m_sourceDoc) {
-            QImage bgImage = m_document->renderPdfPageToImage(m_currentSourceId, origPageNum, static_cast<qreal>(m_options.dpi));
-            if (!bgImage.isNull()) {
-                QVector<QRect> imgRegions;
-                if (!m_options.skipImageMasking) {
-                    imgRegions = m_document->pdfImageRegions(m_currentSourceId, origPageNum, static_cast<qreal>(m_options.dpi));
-                }
-                DarkModeUtils::invertImageLightness(bgImage, imgRegions);
-
-                QByteArray compressed = compressImage(bgImage, false,
-                    QSizeF(widthPt, heightPt), m_options.dpi);
-                if (!compressed.isEmpty()) {
-                    fz_buffer* imgBuf = fz_new_buffer_from_copied_data(m_ctx,
-                        reinterpret_cast<const unsigned char*>(compressed.constData()),
-                        compressed.size());
-                    fz_image* fzImg = fz_new_image_from_buffer(m_ctx, imgBuf);
-                    fz_drop_buffer(m_ctx, imgBuf);
-
-                    pdf_obj* imgXObj = pdf_add_image(m_ctx, m_outputDoc, fzImg);
-                    fz_drop_image(m_ctx, fzImg);
-
-                    pdf_obj* xobjectDict = pdf_dict_get(m_ctx, resources, PDF_NAME(XObject));
-                    if (!xobjectDict) {
-                        xobjectDict = pdf_new_dict(m_ctx, m_outputDoc, 4);
-                        pdf_dict_put(m_ctx, resources, PDF_NAME(XObject), xobjectDict);
-                    }
-                    pdf_dict_put(m_ctx, xobjectDict, pdf_new_name(m_ctx, "BGDark"), imgXObj);
+            QByteArray compressed = prepared.darkBackground;
+            if (compressed.isEmpty()) {
+                compressed = renderDarkBackground(m_document, m_currentSourceId, origPageNum,
+                                                  QSizeF(widthPt, heightPt), m_options.dpi,
+                                                  m_options.skipImageMasking);
+            }
+            if (!compressed.isEmpty()) {
+                pdf_obj* imgXObj = addCompressedImage(m_ctx, m_outputDoc, compressed);
 
-                    char cmd[128];
-                    fz_append_string(m_ctx, combinedContent, "q\n");
-                    snprintf(cmd, sizeof(cmd), "%.4f 0 0 %.4f 0 0 cm\n", widthPt, heightPt);
-                    fz_append_string(m_ctx, combinedContent, cmd);
-                    fz_append_string(m_ctx, combinedContent, "/BGDark Do\n");
-                    fz_append_string(m_ctx, combinedContent, "Q\n");
+                pdf_obj* xobjectDict = pdf_dict_get(m_ctx, resources, PDF_NAME(XObject));
+                if (!xobjectDict) {
+                    xobjectDict = pdf_new_dict(m_ctx, m_outputDoc, 4);
+                    pdf_dict_put(m_ctx, resources, PDF_NAME(XObject), xobjectDict);
                 }
+                pdf_dict_put(m_ctx, xobjectDict, pdf_new_name(m_ctx, "BGDark"), imgXObj);
+
+                char cmd[128];
+                fz_append_string(m_ctx, combinedContent, "q\n");
+                snprintf(cmd, sizeof(cmd), "%.4f 0 0 %.4f 0 0 cm\n", widthPt, heightPt);
+                fz_append_string(m_ctx, combinedContent, cmd);
+                fz_append_string(m_ctx, combinedContent, "/BGDark Do\n");
+                fz_append_string(m_ctx, combinedContent, "Q\n");
             }
         }
 
@@ -1442,83 +2105,11 @@ bool MuPdfExporter::renderModifiedPage(int pageIndex)
             pdf_dict_put(m_ctx, resources, PDF_NAME(XObject), xobjectDict);
         }
         
-        // Render content with proper layer affinity ordering:
-        // 1. Objects with affinity -1 (below all strokes)
-        // 2. Layer 0 strokes
-        // 3. Objects with affinity 0
-        // 4. Layer 1 strokes
-        // 5. Objects with affinity 1
-        // ... and so on
-        // N. Objects with affinity >= numLayers (always on top)
-        
-        int imageIndex = 0;
-        int gsIndex = 0;  // Counter for ExtGState names (for stroke transparency)
-        std::map<int, QString> alphaToGsName;  // Cache: alpha (0-100) -> GS name
-        int numLayers = static_cast<int>(page->vectorLayers.size());
-        qreal pageHeightSn = page->size.height();
-        
-        // Save graphics state for strokes/objects
-        fz_append_string(m_ctx, combinedContent, "q\n");
-        
-        // Helper lambda to add objects with a specific affinity (sorted by zOrder)
-        auto addObjectsWithAffinity = [&](int affinity) {
-            auto it = page->objectsByAffinity.find(affinity);
-            if (it == page->objectsByAffinity.end()) return;
-            
-            // Sort by zOrder (the map stores pointers, not owned objects)
-            std::vector<InsertedObject*> sorted = it->second;
-            std::sort(sorted.begin(), sorted.end(), 
-                      [](const InsertedObject* a, const InsertedObject* b) {
-                          return a->zOrder < b->zOrder;
-                      });
-            
-            for (const InsertedObject* obj : sorted) {
-                if (obj->type() == QStringLiteral("image")) {
-                    const ImageObject* imgObj = dynamic_cast<const ImageObject*>(obj);
-                    if (imgObj && imgObj->isLoaded()) {
-                        addImageToPage(m_ctx, m_outputDoc, imgObj, combinedContent, resources, imageIndex++, heightPt, m_options);
-                    }
-                }
-            }
-        };
-        
-        // 1. Objects with affinity -1 (below all strokes)
-        addObjectsWithAffinity(-1);
-        
-        // 2. Interleave layers and objects
-        for (int layerIdx = 0; layerIdx < numLayers; ++layerIdx) {
-            // Render this layer's strokes (with transparency support)
-            appendLayerStrokesToBuffer(m_ctx, m_outputDoc, combinedContent, resources,
-                                      page->vectorLayers[layerIdx].get(), pageHeightSn, gsIndex, alphaToGsName,
-                                      m_options.darkenStrokes);
-            
-            // Render objects with affinity = layerIdx (above this layer, below next)
-            addObjectsWithAffinity(layerIdx);
-        }
-        
-        // 3. Objects with affinity >= numLayers (always on top of all strokes)
-        for (const auto& [affinity, objects] : page->objectsByAffinity) {
-            if (affinity >= numLayers) {
-                // Sort by zOrder
-                std::vector<InsertedObject*> sorted = objects;
-                std::sort(sorted.begin(), sorted.end(), 
-                          [](const InsertedObject* a, const InsertedObject* b) {
-                              return a->zOrder < b->zOrder;
-                          });
-                
-                for (const InsertedObject* obj : sorted) {
-                    if (obj->type() == QStringLiteral("image")) {
-                        const ImageObject* imgObj = dynamic_cast<const ImageObject*>(obj);
-                        if (imgObj && imgObj->isLoaded()) {
-                            addImageToPage(m_ctx, m_outputDoc, imgObj, combinedContent, resources, imageIndex++, heightPt, m_options);
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Restore graphics state
-        fz_append_string(m_ctx, combinedContent, "Q\n");
+        // Layers and objects in affinity order, prepared by preparePage().
+        // Resources are created in the order the content first uses them.
+        addPreparedResources(m_ctx, m_outputDoc, resources, prepared.resources);
+        fz_append_data(m_ctx, combinedContent, prepared.annotations.constData(),
+                       static_cast<size_t>(prepared.annotations.size()));
         
         // Create the page with our resources and content
         fz_rect mediabox = fz_make_rect(0, 0, widthPt, heightPt);
@@ -1661,7 +2252,7 @@ static fz_buffer* buildBackgroundContentStream(fz_context* ctx, const Page* page
     return buf;
 }
 
-bool MuPdfExporter::renderBlankPage(int pageIndex)
+bool MuPdfExporter::renderBlankPage(int pageIndex, const PreparedPage& prepared)
 {
     if (!m_outputDoc || !m_ctx) {
         return false;
@@ -1721,10 +2312,6 @@ bool MuPdfExporter::renderBlankPage(int pageIndex)
             // We create it whenever we have content, as strokes may need ExtGState for transparency
             resources = pdf_new_dict(m_ctx, m_outputDoc, 4);
             
-            int imageIndex = 0;
-            int gsIndex = 0;  // Counter for ExtGState names (for stroke transparency)
-            std::map<int, QString> alphaToGsName;  // Cache: alpha (0-100) -> GS name
-            
             // 1. Background color/grid/lines first
             if (backgroundContent) {
                 unsigned char* data;
@@ -1732,145 +2319,43 @@ bool MuPdfExporter::renderBlankPage(int pageIndex)
                 fz_append_data(m_ctx, finalContent, data, len);
             }
             
-            // 2. Custom background image (covers entire page, before strokes)
-            if (hasCustomBackground) {
-                // Convert QPixmap to QImage
-                QImage bgImage = page->customBackground.toImage();
-                if (!bgImage.isNull()) {
-                    // Compress the background image
-                    bool hasAlpha = bgImage.hasAlphaChannel();
-                    QSizeF displaySizePt(widthPt, heightPt);
-                    QByteArray compressedData = compressImage(bgImage, hasAlpha, displaySizePt, m_options.dpi);
+            // 2. Custom background image (covers entire page, before strokes),
+            //    compressed by preparePage()
+            if (hasCustomBackground && !prepared.customBackground.isEmpty()) {
+                fz_try(m_ctx) {
+                    pdf_obj* imgXObj = addCompressedImage(m_ctx, m_outputDoc, prepared.customBackground);
                     
-                    if (!compressedData.isEmpty()) {
-                        // Create image XObject with proper memory management
-                        fz_buffer* imgBuf = nullptr;
-                        fz_image* fzImage = nullptr;
-                        
-                        fz_try(m_ctx) {
-                            imgBuf = fz_new_buffer_from_copied_data(m_ctx,
-                                reinterpret_cast<const unsigned char*>(compressedData.constData()),
-                                compressedData.size());
-                            
-                            fzImage = fz_new_image_from_buffer(m_ctx, imgBuf);
-                            fz_drop_buffer(m_ctx, imgBuf);
-                            imgBuf = nullptr;  // Prevent double-drop
-                            
-                            pdf_obj* imgXObj = pdf_add_image(m_ctx, m_outputDoc, fzImage);
-                            fz_drop_image(m_ctx, fzImage);
-                            fzImage = nullptr;  // Prevent double-drop
-                            
-                            // Add to resources
-                            pdf_obj* xobjectDict = pdf_dict_get(m_ctx, resources, PDF_NAME(XObject));
-                            if (!xobjectDict) {
-                                xobjectDict = pdf_new_dict(m_ctx, m_outputDoc, 4);
-                                pdf_dict_put(m_ctx, resources, PDF_NAME(XObject), xobjectDict);
-                            }
-                            
-                            char imgName[16];
-                            snprintf(imgName, sizeof(imgName), "Img%d", imageIndex++);
-                            pdf_dict_put(m_ctx, xobjectDict, pdf_new_name(m_ctx, imgName), imgXObj);
-                            
-                            // Draw image covering entire page
-                            char cmd[128];
-                            fz_append_string(m_ctx, finalContent, "q\n");
-                            snprintf(cmd, sizeof(cmd), "%.4f 0 0 %.4f 0 0 cm\n", widthPt, heightPt);
-                            fz_append_string(m_ctx, finalContent, cmd);
-                            snprintf(cmd, sizeof(cmd), "/%s Do\n", imgName);
-                            fz_append_string(m_ctx, finalContent, cmd);
-                            fz_append_string(m_ctx, finalContent, "Q\n");
-                            
-                            #ifdef SPEEDYNOTE_DEBUG
-                            qDebug() << "[MuPdfExporter] Added custom background image";
-                            #endif
-                        }
-                        fz_always(m_ctx) {
-                            if (imgBuf) fz_drop_buffer(m_ctx, imgBuf);
-                            if (fzImage) fz_drop_image(m_ctx, fzImage);
-                        }
-                        fz_catch(m_ctx) {
-                            qWarning() << "[MuPdfExporter] Failed to add custom background:" 
-                                       << fz_caught_message(m_ctx);
-                            // Continue without background (non-fatal)
-                        }
-                    }
-                }
-            }
-            
-            // 3. Render content with proper layer affinity ordering:
-            //    - Objects with affinity -1 (below all strokes)
-            //    - Layer 0 strokes
-            //    - Objects with affinity 0
-            //    - Layer 1 strokes
-            //    - Objects with affinity 1
-            //    - ... and so on
-            //    - Objects with affinity >= numLayers (always on top)
-            
-            int numLayers = static_cast<int>(page->vectorLayers.size());
-            qreal pageHeightSn = page->size.height();
-            
-            // Save graphics state for strokes/objects
-            fz_append_string(m_ctx, finalContent, "q\n");
-            
-            // Helper lambda to add objects with a specific affinity (sorted by zOrder)
-            auto addObjectsWithAffinity = [&](int affinity) {
-                auto it = page->objectsByAffinity.find(affinity);
-                if (it == page->objectsByAffinity.end()) return;
-                
-                // Sort by zOrder
-                std::vector<InsertedObject*> sorted = it->second;
-                std::sort(sorted.begin(), sorted.end(), 
-                          [](const InsertedObject* a, const InsertedObject* b) {
-                              return a->zOrder < b->zOrder;
-                          });
-                
-                for (const InsertedObject* obj : sorted) {
-                    if (obj->type() == QStringLiteral("image")) {
-                        const ImageObject* imgObj = dynamic_cast<const ImageObject*>(obj);
-                        if (imgObj && imgObj->isLoaded()) {
-                            addImageToPage(m_ctx, m_outputDoc, imgObj, finalContent, resources, imageIndex++, heightPt, m_options);
-                        }
+                    // Add to resources
+                    pdf_obj* xobjectDict = pdf_dict_get(m_ctx, resources, PDF_NAME(XObject));
+                    if (!xobjectDict) {
+                        xobjectDict = pdf_new_dict(m_ctx, m_outputDoc, 4);
+                        pdf_dict_put(m_ctx, resources, PDF_NAME(XObject), xobjectDict);
                     }
-                }
-            };
-            
-            // Objects with affinity -1 (below all strokes)
-            addObjectsWithAffinity(-1);
-            
-            // Interleave layers and objects
-            for (int layerIdx = 0; layerIdx < numLayers; ++layerIdx) {
-                // Render this layer's strokes (with transparency support)
-                appendLayerStrokesToBuffer(m_ctx, m_outputDoc, finalContent, resources,
-                                          page->vectorLayers[layerIdx].get(), pageHeightSn, gsIndex, alphaToGsName,
-                                          m_options.darkenStrokes);
-                
-                // Render objects with affinity = layerIdx (above this layer, below next)
-                addObjectsWithAffinity(layerIdx);
-            }
-            
-            // Objects with affinity >= numLayers (always on top of all strokes)
-            for (const auto& [affinity, objects] : page->objectsByAffinity) {
-                if (affinity >= numLayers) {
-                    // Sort by zOrder
-                    std::vector<InsertedObject*> sorted = objects;
-                    std::sort(sorted.begin(), sorted.end(), 
-                              [](const InsertedObject* a, const InsertedObject* b) {
-                                  return a->zOrder < b->zOrder;
-                              });
+                    pdf_dict_put(m_ctx, xobjectDict, pdf_new_name(m_ctx, "Img0"), imgXObj);
                     
-                    for (const InsertedObject* obj : sorted) {
-                        if (obj->type() == QStringLiteral("image")) {
-                            const ImageObject* imgObj = dynamic_cast<const ImageObject*>(obj);
-                            if (imgObj && imgObj->isLoaded()) {
-                                addImageToPage(m_ctx, m_outputDoc, imgObj, finalContent, resources, imageIndex++, heightPt, m_options);
-                            }
-                        }
-                    }
+                    // Draw image covering entire page
+                    char cmd[128];
+                    fz_append_string(m_ctx, finalContent, "q\n");
+                    snprintf(cmd, sizeof(cmd), "%.4f 0 0 %.4f 0 0 cm\n", widthPt, heightPt);
+                    fz_append_string(m_ctx, finalContent, cmd);
+                    fz_append_string(m_ctx, finalContent, "/Img0 Do\n");
+                    fz_append_string(m_ctx, finalContent, "Q\n");
+                    
+                    #ifdef SPEEDYNOTE_DEBUG
+                    qDebug() << "[MuPdfExporter] Added custom background image";
+                    #endif
+                }
+                fz_catch(m_ctx) {
+                    qWarning() << "[MuPdfExporter] Failed to add custom background:" 
+                               << fz_caught_message(m_ctx);
+                    // Continue without background (non-fatal)
                 }
             }
             
-            // Restore graphics state
-            fz_append_string(m_ctx, finalContent, "Q\n");
+            // 3. Layers and objects in affinity order, prepared by preparePage()
+            addPreparedResources(m_ctx, m_outputDoc, resources, prepared.resources);
+            fz_append_data(m_ctx, finalContent, prepared.annotations.constData(),
+                           static_cast<size_t>(prepared.annotations.size()));
             
             // Create page with resources and combined content
             pdf_obj* pageObj = pdf_add_page(m_ctx, m_outputDoc, mediabox, 0, resources, finalContent);
@@ -1930,8 +2415,7 @@ static inline void transformPoint(float& x, float& y, qreal pageHeightSn)
  * body + round cap circles) are filled as one composite area without
  * double-compositing semi-transparent alpha.
  */
-static void appendPolygonToBuffer(fz_context* ctx, fz_buffer* buf, 
-                                   const QPolygonF& polygon, qreal pageHeightSn)
+static void appendPolygonToBuffer(QByteArray& buf, const QPolygonF& polygon, qreal pageHeightSn)
 {
     if (polygon.isEmpty()) return;
     
@@ -1942,7 +2426,7 @@ static void appendPolygonToBuffer(fz_context* ctx, fz_buffer* buf,
     float y = static_cast<float>(polygon[0].y());
     transformPoint(x, y, pageHeightSn);
     snprintf(cmd, sizeof(cmd), "%.4f %.4f m\n", x, y);
-    fz_append_string(ctx, buf, cmd);
+    buf.append(cmd);
     
     // Line to remaining points
     for (int i = 1; i < polygon.size(); ++i) {
@@ -1950,11 +2434,11 @@ static void appendPolygonToBuffer(fz_context* ctx, fz_buffer* buf,
         y = static_cast<float>(polygon[i].y());
         transformPoint(x, y, pageHeightSn);
         snprintf(cmd, sizeof(cmd), "%.4f %.4f l\n", x, y);
-        fz_append_string(ctx, buf, cmd);
+        buf.append(cmd);
     }
     
     // Close subpath (caller emits a single 'f' after all subpaths are written)
-    fz_append_string(ctx, buf, "h\n");
+    buf.append("h\n");
 }
 
 /**
@@ -1964,8 +2448,8 @@ static void appendPolygonToBuffer(fz_context* ctx, fz_buffer* buf,
  * Uses operators: m (moveto), c (curveto), h (closepath).
  * Does NOT emit f (fill) -- see appendPolygonToBuffer for rationale.
  */
-static void appendCircleToBuffer(fz_context* ctx, fz_buffer* buf,
-                                  const QPointF& center, qreal radius, qreal pageHeightSn)
+static void appendCircleToBuffer(QByteArray& buf, const QPointF& center, qreal radius,
+                                 qreal pageHeightSn)
 {
     if (radius <= 0) return;
     
@@ -1982,38 +2466,38 @@ static void appendCircleToBuffer(fz_context* ctx, fz_buffer* buf,
     
     // Start at right point of circle (3 o'clock)
     snprintf(cmd, sizeof(cmd), "%.4f %.4f m\n", cx + r, cy);
-    fz_append_string(ctx, buf, cmd);
+    buf.append(cmd);
     
     // Top-right quadrant (to 12 o'clock)
     snprintf(cmd, sizeof(cmd), "%.4f %.4f %.4f %.4f %.4f %.4f c\n",
              cx + r, cy + k,      // control point 1
              cx + k, cy + r,      // control point 2
              cx, cy + r);         // end point
-    fz_append_string(ctx, buf, cmd);
+    buf.append(cmd);
     
     // Top-left quadrant (to 9 o'clock)
     snprintf(cmd, sizeof(cmd), "%.4f %.4f %.4f %.4f %.4f %.4f c\n",
              cx - k, cy + r,
              cx - r, cy + k,
              cx - r, cy);
-    fz_append_string(ctx, buf, cmd);
+    buf.append(cmd);
     
     // Bottom-left quadrant (to 6 o'clock)
     snprintf(cmd, sizeof(cmd), "%.4f %.4f %.4f %.4f %.4f %.4f c\n",
              cx - r, cy - k,
              cx - k, cy - r,
              cx, cy - r);
-    fz_append_string(ctx, buf, cmd);
+    buf.append(cmd);
     
     // Bottom-right quadrant (back to 3 o'clock)
     snprintf(cmd, sizeof(cmd), "%.4f %.4f %.4f %.4f %.4f %.4f c\n",
              cx + k, cy - r,
              cx + r, cy - k,
              cx + r, cy);
-    fz_append_string(ctx, buf, cmd);
+    buf.append(cmd);
     
     // Close subpath (caller emits a single 'f' after all subpaths are written)
-    fz_append_string(ctx, buf, "h\n");
+    buf.append("h\n");
 }
 
 // NOTE: This function is currently unused. The implementation uses content stream operators
@@ -2060,30 +2544,26 @@ fz_path* MuPdfExporter::polygonToPath(const QPolygonF& polygon, qreal pageHeight
 
 /**
  * @brief Get or create an ExtGState resource for a given alpha value.
- * @param ctx MuPDF context
- * @param outputDoc Output PDF document
- * @param resources Resources dictionary to add ExtGState to
+ * @param resources Prepared resources of the page (a new ExtGState is appended)
  * @param alpha The fill alpha value (0.0 to 1.0)
  * @param gsIndex Current graphics state index (will be incremented only if new entry created)
  * @param alphaToGsName Cache mapping alpha values to existing GS names (for reuse)
  * @return The name of the ExtGState (e.g., "GS0", "GS1", etc.) or empty if alpha is 1.0
  * 
- * Creates an ExtGState dictionary with:
+ * The writer turns each entry into an ExtGState dictionary with:
  *   /Type /ExtGState
  *   /ca <alpha>   (fill alpha)
- * 
- * The ExtGState is added to resources under /ExtGState/<name>.
+ * added to the page resources under /ExtGState/<name>.
  * 
  * OPTIMIZATION: Caches ExtGState entries by alpha value (quantized to 2 decimal places).
  * Multiple strokes with the same opacity reuse the same ExtGState entry.
  */
-static QString getOrCreateExtGState(fz_context* ctx, pdf_document* outputDoc,
-                                     pdf_obj* resources, float alpha, int& gsIndex,
-                                     std::map<int, QString>& alphaToGsName)
+static QByteArray getOrCreateExtGState(std::vector<PreparedResource>& resources, float alpha,
+                                       int& gsIndex, std::map<int, QByteArray>& alphaToGsName)
 {
     // If fully opaque, no need for ExtGState
     if (alpha >= 0.999f) {
-        return QString();
+        return QByteArray();
     }
     
     // Clamp alpha to valid range
@@ -2100,23 +2580,13 @@ static QString getOrCreateExtGState(fz_context* ctx, pdf_document* outputDoc,
     }
     
     // Generate unique name for this graphics state
-    QString gsName = QStringLiteral("GS%1").arg(gsIndex++);
-    QByteArray gsNameUtf8 = gsName.toUtf8();
+    QByteArray gsName = "GS" + QByteArray::number(gsIndex++);
     
-    // Get or create ExtGState dictionary in resources
-    pdf_obj* extGStateDict = pdf_dict_get(ctx, resources, PDF_NAME(ExtGState));
-    if (!extGStateDict) {
-        extGStateDict = pdf_new_dict(ctx, outputDoc, 4);
-        pdf_dict_put(ctx, resources, PDF_NAME(ExtGState), extGStateDict);
-    }
-    
-    // Create the graphics state dictionary
-    pdf_obj* gsDict = pdf_new_dict(ctx, outputDoc, 2);
-    pdf_dict_put(ctx, gsDict, PDF_NAME(Type), PDF_NAME(ExtGState));
-    pdf_dict_put_real(ctx, gsDict, PDF_NAME(ca), alpha);  // Fill alpha (lowercase 'ca')
-    
-    // Add to ExtGState dictionary
-    pdf_dict_put(ctx, extGStateDict, pdf_new_name(ctx, gsNameUtf8.constData()), gsDict);
+    PreparedResource gs;
+    gs.kind = PreparedResource::Kind::ExtGState;
+    gs.name = gsName;
+    gs.alpha = alpha;
+    resources.push_back(std::move(gs));
     
     // Cache for reuse
     alphaToGsName[alphaKey] = gsName;
@@ -2126,57 +2596,55 @@ static QString getOrCreateExtGState(fz_context* ctx, pdf_document* outputDoc,
 
 /**
  * @brief Append a single layer's strokes to the content buffer.
- * @param ctx MuPDF context
- * @param outputDoc Output PDF document (for creating ExtGState resources)
- * @param buf Buffer to append to (must not be null)
- * @param resources Resources dictionary (for adding ExtGState entries)
- * @param layer The vector layer to render
+ * @param buf Content stream to append to
+ * @param resources Prepared resources of the page (for ExtGState entries)
+ * @param layer Snapshot of the vector layer to render
  * @param pageHeightSn Page height in SpeedyNote coordinates (for Y-flip)
  * @param gsIndex Current graphics state index counter (modified by function)
  * @param alphaToGsName Cache for ExtGState names by alpha value (for reuse)
  * 
  * This is used by the interleaved rendering to render layers one at a time,
  * allowing objects to be inserted between layers based on their affinity.
+ * Runs on the preparation workers, so it only touches Qt data.
  * 
  * Opacity handling:
  * - Layer opacity is applied to all strokes in the layer
  * - Stroke color alpha is multiplied with layer opacity
  * - Total alpha < 1.0 creates an ExtGState with fill alpha (ca)
  */
-static void appendLayerStrokesToBuffer(fz_context* ctx, pdf_document* outputDoc,
-                                       fz_buffer* buf, pdf_obj* resources,
-                                       const VectorLayer* layer, qreal pageHeightSn,
-                                       int& gsIndex, std::map<int, QString>& alphaToGsName,
+static void appendLayerStrokesToBuffer(QByteArray& buf, std::vector<PreparedResource>& resources,
+                                       const PageItemSnapshot& layer, qreal pageHeightSn,
+                                       int& gsIndex, std::map<int, QByteArray>& alphaToGsName,
                                        bool darkenStrokes)
 {
-    if (!ctx || !buf || !layer) return;
-    
-    if (!layer->visible || layer->strokes().isEmpty()) {
+    if (!layer.visible || layer.strokes.isEmpty()) {
         return;
     }
     
     // Get layer opacity
-    float layerOpacity = static_cast<float>(layer->opacity);
+    float layerOpacity = layer.opacity;
     
-    for (const VectorStroke& stroke : layer->strokes()) {
-        // Build the stroke polygon using existing VectorLayer logic
-        VectorLayer::StrokePolygonResult polyResult = VectorLayer::buildStrokePolygon(stroke);
+    for (const VectorStroke& stroke : layer.strokes) {
+        // Stroke polygon from the shared outline cache (usually already
+        // tessellated by on-screen rendering)
+        const StrokeOutlineCache::Outline cached = VectorLayer::cachedStrokePolygon(stroke);
+        const VectorLayer::StrokePolygonResult& polyResult = *cached;
         
         // Calculate effective alpha (stroke alpha × layer opacity)
         float strokeAlpha = static_cast<float>(stroke.color.alphaF());
         float effectiveAlpha = strokeAlpha * layerOpacity;
-        bool needsTransparency = (effectiveAlpha < 0.999f) && resources && outputDoc;
+        bool needsTransparency = (effectiveAlpha < 0.999f);
         
         // Save graphics state if using transparency (so we can restore after)
         if (needsTransparency) {
-            fz_append_string(ctx, buf, "q\n");
+            buf.append("q\n");
             
             // Apply transparency via ExtGState (reuses existing entry if same alpha)
-            QString gsName = getOrCreateExtGState(ctx, outputDoc, resources, effectiveAlpha, gsIndex, alphaToGsName);
+            QByteArray gsName = getOrCreateExtGState(resources, effectiveAlpha, gsIndex, alphaToGsName);
             if (!gsName.isEmpty()) {
                 char gsCmd[32];
-                snprintf(gsCmd, sizeof(gsCmd), "/%s gs\n", gsName.toUtf8().constData());
-                fz_append_string(ctx, buf, gsCmd);
+                snprintf(gsCmd, sizeof(gsCmd), "/%s gs\n", gsName.constData());
+                buf.append(gsCmd);
             }
         }
         
@@ -2191,29 +2659,29 @@ static void appendLayerStrokesToBuffer(fz_context* ctx, pdf_document* outputDoc,
         
         char colorCmd[64];
         snprintf(colorCmd, sizeof(colorCmd), "%.4f %.4f %.4f rg\n", r, g, b);
-        fz_append_string(ctx, buf, colorCmd);
+        buf.append(colorCmd);
         
         if (polyResult.isSinglePoint) {
-            appendCircleToBuffer(ctx, buf, polyResult.startCapCenter, 
-                                polyResult.startCapRadius, pageHeightSn);
-            fz_append_string(ctx, buf, "f\n");
+            appendCircleToBuffer(buf, polyResult.startCapCenter, 
+                                 polyResult.startCapRadius, pageHeightSn);
+            buf.append("f\n");
         } else if (!polyResult.polygon.isEmpty()) {
-            appendPolygonToBuffer(ctx, buf, polyResult.polygon, pageHeightSn);
+            appendPolygonToBuffer(buf, polyResult.polygon, pageHeightSn);
             
             if (polyResult.hasRoundCaps) {
-                appendCircleToBuffer(ctx, buf, polyResult.startCapCenter,
-                                    polyResult.startCapRadius, pageHeightSn);
-                appendCircleToBuffer(ctx, buf, polyResult.endCapCenter,
-                                    polyResult.endCapRadius, pageHeightSn);
+                appendCircleToBuffer(buf, polyResult.startCapCenter,
+                                     polyResult.startCapRadius, pageHeightSn);
+                appendCircleToBuffer(buf, polyResult.endCapCenter,
+                                     polyResult.endCapRadius, pageHeightSn);
             }
             // Single fill for all subpaths (polygon + caps) to prevent
             // double-opacity at cap/body overlap for semi-transparent strokes
-            fz_append_string(ctx, buf, "f\n");
+            buf.append("f\n");
         }
         
         // Restore graphics state if we saved it for transparency
         if (needsTransparency) {
-            fz_append_string(ctx, buf, "Q\n");
+            buf.append("Q\n");
         }
     }
 }
@@ -2409,30 +2877,32 @@ pdf_obj* MuPdfExporter::importPageAsXObject(int sourcePageIndex)
 // Image Handling (Phase 5 - TODO)
 // ============================================================================
 
-static bool addImageToPage(fz_context* ctx, pdf_document* outputDoc,
-                           const ImageObject* img, fz_buffer* contentBuf,
-                           pdf_obj* resources, int imageIndex, float pageHeightPt,
-                           const PdfExportOptions& options)
+/**
+ * @brief Compress an image object and append the commands that draw it.
+ * @param buf Content stream to append to
+ * @param resources Prepared resources of the page (the image is appended)
+ * @param img Snapshot of the image object
+ * @param imageIndex Index for the resource name (Img<index>)
+ * @param pageHeightPt Page height in PDF points (for Y-flip)
+ * @param targetDpi Target resolution for downsampling
+ * @return true if the image was added (or is invisible)
+ *
+ * Runs on the preparation workers; the writer creates the XObject later
+ * from the compressed bytes (addPreparedResources()).
+ */
+static bool appendImageToBuffer(QByteArray& buf, std::vector<PreparedResource>& resources,
+                                const PageItemSnapshot& img, int imageIndex, float pageHeightPt,
+                                int targetDpi)
 {
-    if (!img || !contentBuf || !resources || !ctx || !outputDoc) {
-        return false;
-    }
-    
-    // Check if image is loaded
-    if (!img->isLoaded() || img->pixmap().isNull()) {
-        qWarning() << "[MuPdfExporter] Image not loaded:" << img->imagePath;
-        return false;
-    }
-    
     // Skip invisible images
-    if (!img->visible) {
+    if (!img.visible) {
         return true;
     }
     
     // Get image data
-    QImage qimg = img->pixmap().toImage();
+    const QImage& qimg = img.image;
     if (qimg.isNull()) {
-        qWarning() << "[MuPdfExporter] Failed to convert pixmap to image";
+        qWarning() << "[MuPdfExporter] Failed to convert pixmap to image:" << img.imagePath;
         return false;
     }
     
@@ -2441,8 +2911,8 @@ static bool addImageToPage(fz_context* ctx, pdf_document* outputDoc,
     
     // Calculate display size in PDF points
     // SpeedyNote uses 96 DPI, PDF uses 72 DPI
-    float displayWidthPt = static_cast<float>(img->size.width()) * SN_TO_PDF_SCALE;
-    float displayHeightPt = static_cast<float>(img->size.height()) * SN_TO_PDF_SCALE;
+    float displayWidthPt = static_cast<float>(img.size.width()) * SN_TO_PDF_SCALE;
+    float displayHeightPt = static_cast<float>(img.size.height()) * SN_TO_PDF_SCALE;
     
     // Skip zero-size images (would cause invalid transformation matrix)
     if (displayWidthPt <= 0 || displayHeightPt <= 0) {
@@ -2453,132 +2923,199 @@ static bool addImageToPage(fz_context* ctx, pdf_document* outputDoc,
     QSizeF displaySizePt(displayWidthPt, displayHeightPt);
     
     // Compress with downsampling
-    QByteArray compressedData = MuPdfExporter::compressImage(qimg, hasAlpha, displaySizePt, options.dpi);
+    QByteArray compressedData = MuPdfExporter::compressImage(qimg, hasAlpha, displaySizePt, targetDpi);
     if (compressedData.isEmpty()) {
         qWarning() << "[MuPdfExporter] Failed to compress image";
         return false;
     }
     
+    // Image XObject with unique name, created by the writer
+    QByteArray imgName = "Img" + QByteArray::number(imageIndex);
+    PreparedResource resource;
+    resource.kind = PreparedResource::Kind::Image;
+    resource.name = imgName;
+    resource.imageData = compressedData;
+    resources.push_back(std::move(resource));
+    
+    // Build transformation matrix for position, scale, and rotation
+    // PDF image XObjects are 1x1 unit, so we need to scale to display size
+    // Position is relative to page origin (bottom-left in PDF)
+    
+    float posX = static_cast<float>(img.position.x()) * SN_TO_PDF_SCALE;
+    float posY = static_cast<float>(img.position.y()) * SN_TO_PDF_SCALE;
+    
+    // Convert Y from top-left origin to bottom-left origin
+    // The image's top-left corner in PDF coords
+    float pdfY = pageHeightPt - posY - displayHeightPt;
+    
+    // Append drawing commands to content buffer
+    buf.append("q\n");  // Save graphics state
+    
+    if (img.rotation != 0.0) {
+        // For rotation, we need to:
+        // 1. Translate to image center
+        // 2. Rotate
+        // 3. Translate back
+        // 4. Scale and position
+        
+        float centerX = posX + displayWidthPt / 2.0f;
+        float centerY = pdfY + displayHeightPt / 2.0f;
+        
+        // Negate rotation angle to account for Y-axis flip
+        // SpeedyNote: Y increases downward, positive rotation = counterclockwise
+        // PDF: Y increases upward, so we need to negate to preserve visual rotation direction
+        float radians = static_cast<float>(-img.rotation * M_PI / 180.0);
+        float cosR = cosf(radians);
+        float sinR = sinf(radians);
+        
+        // Combined matrix: translate to center, rotate, translate back, then scale/position
+        // This is complex, so let's build it step by step in the content stream
+        char cmd[256];
+        
+        // Translate to center, rotate, translate back
+        snprintf(cmd, sizeof(cmd), 
+                 "1 0 0 1 %.4f %.4f cm\n",  // Translate to center
+                 centerX, centerY);
+        buf.append(cmd);
+        
+        snprintf(cmd, sizeof(cmd),
+                 "%.4f %.4f %.4f %.4f 0 0 cm\n",  // Rotate
+                 cosR, sinR, -sinR, cosR);
+        buf.append(cmd);
+        
+        snprintf(cmd, sizeof(cmd),
+                 "1 0 0 1 %.4f %.4f cm\n",  // Translate back
+                 -displayWidthPt / 2.0f, -displayHeightPt / 2.0f);
+        buf.append(cmd);
+        
+        // Scale to display size (image XObject is 1x1)
+        snprintf(cmd, sizeof(cmd),
+                 "%.4f 0 0 %.4f 0 0 cm\n",
+                 displayWidthPt, displayHeightPt);
+        buf.append(cmd);
+    } else {
+        // No rotation - simple scale and position
+        char cmd[128];
+        snprintf(cmd, sizeof(cmd),
+                 "%.4f 0 0 %.4f %.4f %.4f cm\n",
+                 displayWidthPt, displayHeightPt, posX, pdfY);
+        buf.append(cmd);
+    }
+    
+    // Draw the image
+    char doCmd[32];
+    snprintf(doCmd, sizeof(doCmd), "/%s Do\n", imgName.constData());
+    buf.append(doCmd);
+    
+    buf.append("Q\n");  // Restore graphics state
+    
+    #ifdef SPEEDYNOTE_DEBUG
+    qDebug() << "[MuPdfExporter] Added image" << imageIndex 
+             << "at (" << posX << "," << pdfY << ")"
+             << "size" << displayWidthPt << "x" << displayHeightPt
+             << "rotation" << img.rotation;
+    #endif
+    
+    return true;
+}
+
+/**
+ * @brief Rasterize a source PDF page and invert it for a dark-mode export.
+ * @return Compressed (JPEG) background, or empty if the page could not be rendered
+ *
+ * Safe on the preparation workers: the document's providers are opened
+ * up front (Document::ensureAllPdfProvidersLoaded()) and render in parallel.
+ */
+static QByteArray renderDarkBackground(const Document* document, const QString& sourceId,
+                                       int pdfPageNumber, const QSizeF& pageSizePt,
+                                       int targetDpi, bool skipImageMasking)
+{
+    QImage bgImage = document->renderPdfPageToImage(sourceId, pdfPageNumber, static_cast<qreal>(targetDpi));
+    if (bgImage.isNull()) {
+        return QByteArray();
+    }
+    QVector<QRect> imgRegions;
+    if (!skipImageMasking) {
+        imgRegions = document->pdfImageRegions(sourceId, pdfPageNumber, static_cast<qreal>(targetDpi));
+    }
+    DarkModeUtils::invertImageLightness(bgImage, imgRegions);
+    return MuPdfExporter::compressImage(bgImage, false, pageSizePt, targetDpi);
+}
+
+/**
+ * @brief Add compressed JPEG/PNG bytes to the output as an image XObject.
+ * @return The XObject reference. Throws (fz_throw) on failure.
+ */
+static pdf_obj* addCompressedImage(fz_context* ctx, pdf_document* outputDoc,
+                                   const QByteArray& compressed)
+{
     fz_buffer* imgBuf = nullptr;
     fz_image* fzImage = nullptr;
+    pdf_obj* imgXObj = nullptr;
+    fz_var(imgBuf);
+    fz_var(fzImage);
     
     fz_try(ctx) {
-        // Create image from compressed data
-        imgBuf = fz_new_buffer_from_copied_data(ctx, 
-            reinterpret_cast<const unsigned char*>(compressedData.constData()),
-            compressedData.size());
-        
+        imgBuf = fz_new_buffer_from_copied_data(ctx,
+            reinterpret_cast<const unsigned char*>(compressed.constData()),
+            compressed.size());
         fzImage = fz_new_image_from_buffer(ctx, imgBuf);
-        fz_drop_buffer(ctx, imgBuf);
-        imgBuf = nullptr;  // Prevent double-drop in fz_always
-        
-        // Add image to PDF as XObject
-        pdf_obj* imgXObj = pdf_add_image(ctx, outputDoc, fzImage);
-        fz_drop_image(ctx, fzImage);
-        fzImage = nullptr;  // Prevent double-drop in fz_always
-        
-        // Get or create XObject dictionary in resources
-        pdf_obj* xobjectDict = pdf_dict_get(ctx, resources, PDF_NAME(XObject));
-        if (!xobjectDict) {
-            xobjectDict = pdf_new_dict(ctx, outputDoc, 4);
-            pdf_dict_put(ctx, resources, PDF_NAME(XObject), xobjectDict);
-        }
-        
-        // Add image XObject with unique name
-        char imgName[16];
-        snprintf(imgName, sizeof(imgName), "Img%d", imageIndex);
-        pdf_dict_put(ctx, xobjectDict, pdf_new_name(ctx, imgName), imgXObj);
-        
-        // Build transformation matrix for position, scale, and rotation
-        // PDF image XObjects are 1x1 unit, so we need to scale to display size
-        // Position is relative to page origin (bottom-left in PDF)
-        
-        float posX = static_cast<float>(img->position.x()) * SN_TO_PDF_SCALE;
-        float posY = static_cast<float>(img->position.y()) * SN_TO_PDF_SCALE;
-        
-        // Convert Y from top-left origin to bottom-left origin
-        // The image's top-left corner in PDF coords
-        float pdfY = pageHeightPt - posY - displayHeightPt;
-        
-        // Append drawing commands to content buffer
-        fz_append_string(ctx, contentBuf, "q\n");  // Save graphics state
-        
-        if (img->rotation != 0.0) {
-            // For rotation, we need to:
-            // 1. Translate to image center
-            // 2. Rotate
-            // 3. Translate back
-            // 4. Scale and position
-            
-            float centerX = posX + displayWidthPt / 2.0f;
-            float centerY = pdfY + displayHeightPt / 2.0f;
-            
-            // Negate rotation angle to account for Y-axis flip
-            // SpeedyNote: Y increases downward, positive rotation = counterclockwise
-            // PDF: Y increases upward, so we need to negate to preserve visual rotation direction
-            float radians = static_cast<float>(-img->rotation * M_PI / 180.0);
-            float cosR = cosf(radians);
-            float sinR = sinf(radians);
-            
-            // Combined matrix: translate to center, rotate, translate back, then scale/position
-            // This is complex, so let's build it step by step in the content stream
-            char cmd[256];
-            
-            // Translate to center, rotate, translate back
-            snprintf(cmd, sizeof(cmd), 
-                     "1 0 0 1 %.4f %.4f cm\n",  // Translate to center
-                     centerX, centerY);
-            fz_append_string(ctx, contentBuf, cmd);
-            
-            snprintf(cmd, sizeof(cmd),
-                     "%.4f %.4f %.4f %.4f 0 0 cm\n",  // Rotate
-                     cosR, sinR, -sinR, cosR);
-            fz_append_string(ctx, contentBuf, cmd);
-            
-            snprintf(cmd, sizeof(cmd),
-                     "1 0 0 1 %.4f %.4f cm\n",  // Translate back
-                     -displayWidthPt / 2.0f, -displayHeightPt / 2.0f);
-            fz_append_string(ctx, contentBuf, cmd);
-            
-            // Scale to display size (image XObject is 1x1)
-            snprintf(cmd, sizeof(cmd),
-                     "%.4f 0 0 %.4f 0 0 cm\n",
-                     displayWidthPt, displayHeightPt);
-            fz_append_string(ctx, contentBuf, cmd);
-        } else {
-            // No rotation - simple scale and position
-            char cmd[128];
-            snprintf(cmd, sizeof(cmd),
-                     "%.4f 0 0 %.4f %.4f %.4f cm\n",
-                     displayWidthPt, displayHeightPt, posX, pdfY);
-            fz_append_string(ctx, contentBuf, cmd);
-        }
-        
-        // Draw the image
-        char doCmd[32];
-        snprintf(doCmd, sizeof(doCmd), "/%s Do\n", imgName);
-        fz_append_string(ctx, contentBuf, doCmd);
-        
-        fz_append_string(ctx, contentBuf, "Q\n");  // Restore graphics state
-        
-        #ifdef SPEEDYNOTE_DEBUG
-        qDebug() << "[MuPdfExporter] Added image" << imageIndex 
-                 << "at (" << posX << "," << pdfY << ")"
-                 << "size" << displayWidthPt << "x" << displayHeightPt
-                 << "rotation" << img->rotation;
-        #endif
+        imgXObj = pdf_add_image(ctx, outputDoc, fzImage);
     }
     fz_always(ctx) {
-        // Clean up any resources that weren't transferred to the document
-        if (imgBuf) fz_drop_buffer(ctx, imgBuf);
-        if (fzImage) fz_drop_image(ctx, fzImage);
+        fz_drop_image(ctx, fzImage);
+        fz_drop_buffer(ctx, imgBuf);
     }
     fz_catch(ctx) {
-        qWarning() << "[MuPdfExporter] Failed to add image:" << fz_caught_message(ctx);
-        return false;
+        fz_rethrow(ctx);
     }
     
-    return true;
+    return imgXObj;
+}
+
+/**
+ * @brief Create a prepared page's resources in the output document.
+ * @param resources The page's Resources dictionary
+ * @param prepared Resources in first-use order (from preparePage())
+ *
+ * Writer thread only. A failed image is skipped with a warning (its Do
+ * operator then draws nothing), matching the old per-image behaviour.
+ */
+static void addPreparedResources(fz_context* ctx, pdf_document* outputDoc, pdf_obj* resources,
+                                 const std::vector<PreparedResource>& prepared)
+{
+    for (const PreparedResource& res : prepared) {
+        if (res.kind == PreparedResource::Kind::ExtGState) {
+            // Get or create ExtGState dictionary in resources
+            pdf_obj* extGStateDict = pdf_dict_get(ctx, resources, PDF_NAME(ExtGState));
+            if (!extGStateDict) {
+                extGStateDict = pdf_new_dict(ctx, outputDoc, 4);
+                pdf_dict_put(ctx, resources, PDF_NAME(ExtGState), extGStateDict);
+            }
+            
+            // Create the graphics state dictionary
+            pdf_obj* gsDict = pdf_new_dict(ctx, outputDoc, 2);
+            pdf_dict_put(ctx, gsDict, PDF_NAME(Type), PDF_NAME(ExtGState));
+            pdf_dict_put_real(ctx, gsDict, PDF_NAME(ca), res.alpha);  // Fill alpha (lowercase 'ca')
+            pdf_dict_put(ctx, extGStateDict, pdf_new_name(ctx, res.name.constData()), gsDict);
+            continue;
+        }
+        
+        fz_try(ctx) {
+            pdf_obj* imgXObj = addCompressedImage(ctx, outputDoc, res.imageData);
+            
+            // Get or create XObject dictionary in resources
+            pdf_obj* xobjectDict = pdf_dict_get(ctx, resources, PDF_NAME(XObject));
+            if (!xobjectDict) {
+                xobjectDict = pdf_new_dict(ctx, outputDoc, 4);
+                pdf_dict_put(ctx, resources, PDF_NAME(XObject), xobjectDict);
+            }
+            pdf_dict_put(ctx, xobjectDict, pdf_new_name(ctx, res.name.constData()), imgXObj);
+        }
+        fz_catch(ctx) {
+            qWarning() << "[MuPdfExporter] Failed to add image:" << fz_caught_message(ctx);
+        }
+    }
 }
 
 QByteArray MuPdfExporter::compressImage(const QImage& image, bool hasAlpha,
@@ -2924,7 +3461,7 @@ static pdf_obj* buildAggregatedOutline(fz_context* ctx, pdf_document* outputDoc,
 // Finalization
 // ============================================================================
 
-bool MuPdfExporter::saveDocument(const QString& outputPath)
+bool MuPdfExporter::saveDocument(const QString& outputPath, bool incrementalUpdate)
 {
     if (!m_outputDoc || !m_ctx) {
         return false;
@@ -2938,6 +3475,7 @@ bool MuPdfExporter::saveDocument(const QString& outputPath)
         opts.do_compress = 1;       // Compress streams
         opts.do_compress_images = 1; // Compress images
         opts.do_compress_fonts = 1;  // Compress fonts
+        opts.do_incremental = incrementalUpdate ? 1 : 0;  // Append to the opened file
         
         pdf_save_document(m_ctx, m_outputDoc, pathUtf8.constData(), &opts);
     }
@@ -8,6 +8,7 @@
 // Uses MuPDF library to create PDF files from SpeedyNote documents.
 // Key features:
 // - Page grafting: Copy unmodified PDF pages efficiently (no re-rendering)
+// - Incremental export: Reuse unchanged pages of the previous output file
 // - Vector strokes: Convert SpeedyNote strokes to PDF vector paths
 // - PDF backgrounds: Embed source PDF pages as XObjects (preserves quality)
 // - Image embedding: Export ImageObjects with smart compression
@@ -18,6 +19,8 @@
 // ============================================================================
 
 // Qt includes needed by both real and stub class
+#include <QHash>
+#include <QJsonObject>
 #include <QObject>
 #include <QString>
 #include <QVector>
@@ -41,6 +44,10 @@ struct PdfExportOptions {
     bool darkModeBackground = false; ///< Apply HSL lightness inversion to PDF background (dark mode)
     bool darkenStrokes = false;      ///< Darken light-coloured strokes for printing (L>0.5 -> 1-L)
     bool skipImageMasking = false;   ///< Bypass image-region detection (invert everything)
+    int maxThreads = 0;              ///< Page preparation threads (0 = one per core, 1 = serial)
+    bool incremental = false;        ///< Reuse unchanged pages of the previous export (sidecar manifest)
+    bool appendUpdate = false;       ///< With incremental: save changes as a PDF incremental update
+                                     ///< when the page list is unchanged (file grows; no rewrite)
 };
 
 /**
@@ -50,6 +57,8 @@ struct PdfExportResult {
     bool success = false;
     QString errorMessage;
     int pagesExported = 0;
+    int pagesReused = 0;             ///< Incremental export: pages copied from the previous output
+    bool appendedUpdate = false;     ///< Incremental export: saved as an incremental update section
     qint64 fileSizeBytes = 0;
 };
 
@@ -85,6 +94,9 @@ struct pdf_obj;
  * 
  * Thread Safety: This class is NOT thread-safe. Export operations should
  * be run from a single thread, though progress signals are emitted for UI updates.
+ * Internally, rendered pages are prepared (strokes tessellated, images
+ * compressed) on a private thread pool a few pages ahead of the writer, which
+ * assembles them in page order; the output is identical for any thread count.
  * 
  * Usage:
  * @code
@@ -127,6 +139,12 @@ public:
      * 
      * This is a blocking operation. Connect to progressUpdated() for UI updates.
      * The document must be saved before export (no unsaved changes allowed).
+     * 
+     * With options.incremental, pages whose content hash matches the manifest
+     * of the previous export to the same path are copied from that file
+     * instead of being rendered again (see manifestPath()). Any mismatch in
+     * settings or notebook, or an output file changed since, falls back to a
+     * full export.
      */
     PdfExportResult exportPdf(const PdfExportOptions& options);
     
@@ -156,6 +174,28 @@ public:
      */
     static QVector<int> parsePageRange(const QString& rangeString, int totalPages);
     
+    /**
+     * @brief Path of the incremental export manifest for an output PDF.
+     * @param outputPath The exported PDF
+     * @return outputPath + ".snexport"
+     * 
+     * The manifest is a small JSON file holding one content hash per output
+     * page plus the export settings and the size/mtime of the PDF it
+     * describes. It is written by exports with options.incremental set and
+     * removed by full exports to the same path.
+     */
+    static QString manifestPath(const QString& outputPath);
+    
+    /**
+     * @brief True if @p outputPath is an unchanged incremental export of the
+     *        notebook with id @p documentId (its manifest names that id and
+     *        the file's current size/mtime).
+     * 
+     * Batch export uses this to update its own previous output in place
+     * instead of auto-renaming around it.
+     */
+    static bool isIncrementalExportOf(const QString& outputPath, const QString& documentId);
+    
     /**
      * @brief Compress an image for PDF embedding with optional downsampling.
      * @param image Source image
@@ -208,6 +248,11 @@ private:
         struct pdf_graft_map* graft = nullptr;  // one graft map per source
     };
 
+    // Parallel page pipeline (defined in MuPdfExporter.cpp): a PageJob is the
+    // Qt-side snapshot of one page, a PreparedPage the worker's output for it.
+    struct PageJob;
+    struct PreparedPage;
+
     // ===== Initialization =====
     
     /**
@@ -267,16 +312,118 @@ private:
     /**
      * @brief Render a modified page (strokes, images, background).
      * @param pageIndex 0-based page index
+     * @param prepared Output of preparePage() for this page
      * @return true if successful
      */
-    bool renderModifiedPage(int pageIndex);
+    bool renderModifiedPage(int pageIndex, const PreparedPage& prepared);
     
     /**
      * @brief Render a page without PDF background (blank notebook page).
      * @param pageIndex 0-based page index
+     * @param prepared Output of preparePage() for this page
      * @return true if successful
      */
-    bool renderBlankPage(int pageIndex);
+    bool renderBlankPage(int pageIndex, const PreparedPage& prepared);
+    
+    // ===== Incremental Export =====
+    
+    /**
+     * @brief Hash everything that decides how a page is exported.
+     * @param pageIndex 0-based page index
+     * @param page The page (already loaded by the dispatching thread)
+     * @return SHA-1 of the page's PageCodec encoding, its custom background
+     *         and its PDF source page
+     */
+    QByteArray pageContentHash(int pageIndex, const Page* page);
+    
+    /**
+     * @brief Export settings that change page output; part of the manifest.
+     */
+    QString exportSettingsKey() const;
+    
+    /// Manifest of @p outputPath if it describes that file as exported from
+    /// @p documentId; an empty object otherwise.
+    static QJsonObject readManifest(const QString& outputPath, const QString& documentId);
+    
+    /**
+     * @brief Open the previous export described by the manifest, if usable.
+     * @param pageCount Number of pages this export will write
+     * 
+     * Keeps the previous page hashes for reusablePreviousPage(). In
+     * append-update mode (same page count) the previous file becomes the
+     * output document itself and only changed pages are replaced.
+     */
+    void openPreviousExport(int pageCount);
+    
+    /**
+     * @brief Page of the previous export that output page @p outputIndex can
+     *        reuse, given its pageContentHash(); -1 to export it normally.
+     */
+    int reusablePreviousPage(int outputIndex, const QByteArray& pageHash) const;
+    
+    /**
+     * @brief Release the previous export's handles (before replacing the file).
+     */
+    void closePreviousExport();
+    
+    /**
+     * @brief Graft page @p previousIndex of the previous export onto the output.
+     */
+    bool reusePreviousPage(int previousIndex);
+    
+    /**
+     * @brief Append-update mode: replace page @p outputIndex with the page just
+     *        appended at the end of the output.
+     */
+    bool replacePageWithLast(int outputIndex);
+    
+    /**
+     * @brief Write the manifest for a finished export.
+     */
+    bool writeManifest(const QString& outputPath, const QVector<QByteArray>& pageHashes);
+    
+    // ===== Parallel Page Pipeline =====
+    
+    /// Upper bound on page preparation threads.
+#if defined(Q_OS_ANDROID) || defined(Q_OS_IOS)
+    static constexpr int MAX_PREPARE_THREADS = 2;
+#else
+    static constexpr int MAX_PREPARE_THREADS = 8;
+#endif
+    
+    /// Prepared pages allowed ahead of the writer, per preparation thread.
+    /// Bounds memory: each in-flight page holds its compressed images.
+    static constexpr int IN_FLIGHT_PAGES_PER_THREAD = 2;
+    
+    /**
+     * @brief Snapshot the Qt-side content of a page for preparePage().
+     * @param pageIndex 0-based page index
+     * @param page The page (already loaded by the calling thread)
+     * @param rasterDarkBackground Whether the page needs a rasterized dark-mode background
+     * @param job Filled with copies of the strokes and images in paint order
+     *
+     * Calling thread only: Document::page() loads lazily and QPixmap is
+     * GUI-thread data, so both are read here and never by a worker.
+     */
+    void snapshotPage(int pageIndex, const Page* page, bool rasterDarkBackground,
+                      PageJob& job) const;
+    
+    /**
+     * @brief Build a page's content stream, resources and compressed images.
+     * @param job Snapshot from snapshotPage()
+     * @param cancelled Checked between the expensive steps
+     * @return The prepared page (prepared == false if cancelled)
+     *
+     * Uses only Qt types and thread-safe Document/PdfProvider calls, so it
+     * runs on any thread. Resource names come from per-page counters, which
+     * is what makes the output independent of scheduling.
+     */
+    static PreparedPage preparePage(const PageJob& job, const std::atomic<bool>& cancelled);
+    
+    /**
+     * @brief Number of page preparation threads for the current options.
+     */
+    int preparationThreads() const;
     
     // ===== Vector Stroke Conversion =====
     
@@ -309,8 +456,9 @@ private:
     
     // ===== Image Handling =====
     
-    // Note: addImageToPage is implemented as a static helper function in MuPdfExporter.cpp
-    // to avoid exposing MuPDF types (fz_buffer, pdf_obj) in the header.
+    // Note: images are compressed on the preparation workers by appendImageToBuffer()
+    // and turned into XObjects by addPreparedResources(), both static helpers in
+    // MuPdfExporter.cpp to avoid exposing MuPDF types (fz_buffer, pdf_obj) in the header.
     
     // ===== Metadata and Outline =====
     
@@ -334,9 +482,11 @@ private:
     /**
      * @brief Write the PDF to disk.
      * @param outputPath Path to output file
+     * @param incrementalUpdate Append an update section to the opened file
+     *        instead of writing a new one (append-update mode)
      * @return true if successful
      */
-    bool saveDocument(const QString& outputPath);
+    bool saveDocument(const QString& outputPath, bool incrementalUpdate = false);
 
 private:
     // Document reference
@@ -357,6 +507,16 @@ private:
     pdf_document* m_sourcePdf = nullptr;
     struct pdf_graft_map* m_graftMap = nullptr;
     
+    // Incremental export: the previous output (owning; graft is null in
+    // append-update mode, where m_outputDoc holds its own reference to it),
+    // its page hashes (in order, and hash -> first page), and the source
+    // identity cache.
+    SourceHandles m_previous;
+    QVector<QByteArray> m_previousHashes;
+    QHash<QByteArray, int> m_previousPageFor;
+    bool m_appendUpdate = false;
+    QHash<QString, QByteArray> m_sourceIdentities;
+    
     // Export state
     bool m_isExporting = false;
     std::atomic<bool> m_cancelled{false};  ///< Thread-safe cancellation flag
@@ -390,6 +550,8 @@ public:
     bool isExporting() const { return false; }
     
     static QVector<int> parsePageRange(const QString&, int) { return {}; }
+    static QString manifestPath(const QString& outputPath) { return outputPath + QStringLiteral(".snexport"); }
+    static bool isIncrementalExportOf(const QString&, const QString&) { return false; }
 
 signals:
     void progressUpdated(int current, int total);
@@ -8,11 +8,25 @@
 //
 // Current tests:
 // - parsePageRange() edge cases
+// - parallel page preparation produces byte-identical output
+// - incremental export reuses unchanged pages
 // ============================================================================
 
 #include "MuPdfExporter.h"
 #include <QDebug>
 
+#ifdef SPEEDYNOTE_MUPDF_EXPORT
+#include "../core/Document.h"
+#include "../core/Page.h"
+#include "../layers/VectorLayer.h"
+#include "../objects/ImageObject.h"
+
+#include <QFile>
+#include <QPixmap>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#endif
+
 namespace MuPdfExporterTests {
 
 /**
@@ -299,6 +313,224 @@ inline bool testParsePageRange()
     return success;
 }
 
+#ifdef SPEEDYNOTE_MUPDF_EXPORT
+/**
+ * @brief Build a notebook with translucent strokes, a second layer and
+ *        images on every page, so each page has ExtGState and image resources.
+ */
+inline std::unique_ptr<Document> makeExportTestDocument(int pageCount)
+{
+    auto doc = Document::createNew("Export Determinism");
+    while (doc->pageCount() < pageCount) {
+        doc->addPage();
+    }
+
+    QImage photo(320, 200, QImage::Format_RGB32);
+    QImage sticker(96, 96, QImage::Format_ARGB32);
+    for (int y = 0; y < photo.height(); ++y) {
+        for (int x = 0; x < photo.width(); ++x) {
+            photo.setPixel(x, y, qRgb(x % 256, y % 256, (x * y) % 256));
+        }
+    }
+    sticker.fill(QColor(255, 0, 0, 128));
+
+    for (int p = 0; p < pageCount; ++p) {
+        Page* page = doc->page(p);
+        VectorLayer* top = page->addLayer(QStringLiteral("Top"));
+        for (int s = 0; s < 30; ++s) {
+            VectorStroke stroke;
+            stroke.color = QColor::fromHsv((p * 40 + s * 11) % 360, 200, 200, 80 + (s % 4) * 50);
+            stroke.baseThickness = 2.0 + s % 5;
+            for (int i = 0; i < 40; ++i) {
+                StrokePoint pt;
+                pt.pos = QPointF(40 + i * 12, 60 + s * 25 + (i % 7) * 3);
+                pt.pressure = 0.3 + (i % 10) * 0.07;
+                stroke.points.append(pt);
+            }
+            stroke.updateBoundingBox();
+            (s % 2 ? top : page->vectorLayers[0].get())->addStroke(stroke);
+        }
+
+        auto image = std::make_unique<ImageObject>();
+        image->position = QPointF(100, 300);
+        image->size = QSizeF(320, 200);
+        image->setPixmap(QPixmap::fromImage(photo));
+        image->setLayerAffinity(0);
+        page->addObject(std::move(image));
+
+        auto overlay = std::make_unique<ImageObject>();
+        overlay->position = QPointF(400, 500);
+        overlay->size = QSizeF(96, 96);
+        overlay->rotation = 30.0;
+        overlay->setPixmap(QPixmap::fromImage(sticker));
+        overlay->setLayerAffinity(2);
+        page->addObject(std::move(overlay));
+    }
+    return doc;
+}
+
+/**
+ * @brief Parallel page preparation must not change a single output byte.
+ *
+ * Pages are prepared on worker threads but assembled in page order with
+ * per-page resource numbering, so 1 and N preparation threads must produce
+ * the same file (apart from MuPDF's random trailer /ID, if written).
+ */
+inline bool testParallelExportDeterministic()
+{
+    qDebug() << "=== Test: parallel export is byte-deterministic ===";
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: could not create temp dir";
+        return false;
+    }
+    auto doc = makeExportTestDocument(12);
+
+    auto exportWith = [&](int threads) -> QByteArray {
+        PdfExportOptions options;
+        options.outputPath = dir.filePath(QStringLiteral("threads-%1.pdf").arg(threads));
+        options.preserveMetadata = false;  // ModDate is the current time
+        options.maxThreads = threads;
+        MuPdfExporter exporter;
+        exporter.setDocument(doc.get());
+        if (!exporter.exportPdf(options).success) {
+            return QByteArray();
+        }
+        QFile file(options.outputPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return QByteArray();
+        }
+        static const QRegularExpression idEntry(QStringLiteral("/ID\\s*\\[[^\\]]*\\]"));
+        return QString::fromLatin1(file.readAll()).remove(idEntry).toLatin1();
+    };
+
+    const QByteArray serial = exportWith(1);
+    const QByteArray parallel = exportWith(4);
+
+    bool success = true;
+    if (serial.isEmpty() || parallel.isEmpty()) {
+        qDebug() << "FAIL: export failed";
+        success = false;
+    } else if (serial != parallel) {
+        qDebug() << "FAIL: 1-thread and 4-thread exports differ"
+                 << serial.size() << "vs" << parallel.size() << "bytes";
+        success = false;
+    } else {
+        qDebug() << "PASS: 1-thread and 4-thread exports identical (" << serial.size() << "bytes)";
+    }
+    return success;
+}
+
+/**
+ * @brief Incremental export re-renders only pages changed since the last one.
+ *
+ * Covers the rebuild and append-update paths, a settings change (full
+ * export), an export of another notebook to the same path and a plain
+ * export dropping the manifest.
+ */
+inline bool testIncrementalExport()
+{
+    qDebug() << "=== Test: incremental export reuses unchanged pages ===";
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: could not create temp dir";
+        return false;
+    }
+    auto doc = makeExportTestDocument(6);
+
+    PdfExportOptions options;
+    options.outputPath = dir.filePath(QStringLiteral("incremental.pdf"));
+    options.incremental = true;
+    const QString manifest = MuPdfExporter::manifestPath(options.outputPath);
+
+    auto run = [&](bool appendUpdate) {
+        options.appendUpdate = appendUpdate;
+        MuPdfExporter exporter;
+        exporter.setDocument(doc.get());
+        return exporter.exportPdf(options);
+    };
+    auto editPage = [&](int pageIndex) {
+        VectorStroke stroke;
+        stroke.color = Qt::black;
+        stroke.baseThickness = 3.0;
+        for (int i = 0; i < 10; ++i) {
+            StrokePoint pt;
+            pt.pos = QPointF(50 + i * 20, 900);
+            pt.pressure = 0.5;
+            stroke.points.append(pt);
+        }
+        stroke.updateBoundingBox();
+        doc->page(pageIndex)->vectorLayers[0]->addStroke(stroke);
+    };
+    auto readOutput = [&]() {
+        QFile file(options.outputPath);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    };
+
+    bool success = true;
+    auto check = [&success](bool ok, const char* what) {
+        if (ok) {
+            qDebug() << "  -" << what << ": OK";
+        } else {
+            qDebug() << "FAIL:" << what;
+            success = false;
+        }
+    };
+
+    PdfExportResult first = run(false);
+    check(first.success && first.pagesReused == 0, "first export renders every page");
+    check(QFile::exists(manifest), "manifest written");
+
+    PdfExportResult second = run(false);
+    check(second.success && second.pagesReused == 6, "unchanged re-export reuses every page");
+
+    editPage(2);
+    PdfExportResult third = run(false);
+    check(third.success && third.pagesReused == 5 && third.pagesExported == 6,
+          "edited page is rendered again");
+
+    const QByteArray beforeUpdate = readOutput();
+    editPage(4);
+    PdfExportResult fourth = run(true);
+    const QByteArray afterUpdate = readOutput();
+    check(fourth.success && fourth.appendedUpdate && fourth.pagesReused == 5,
+          "append-update replaces only the edited page");
+    check(!beforeUpdate.isEmpty() && afterUpdate.size() > beforeUpdate.size() &&
+              afterUpdate.startsWith(beforeUpdate),
+          "append-update leaves the previous file as a prefix");
+
+    PdfExportResult fifth = run(false);
+    check(fifth.success && fifth.pagesReused == 6, "export after an append-update reuses it");
+
+    options.dpi = 150;
+    PdfExportResult sixth = run(false);
+    check(sixth.success && sixth.pagesReused == 0, "changed settings force a full export");
+
+    check(MuPdfExporter::isIncrementalExportOf(options.outputPath, doc->id) &&
+              !MuPdfExporter::isIncrementalExportOf(options.outputPath, QStringLiteral("other")),
+          "manifest records which notebook it was exported from");
+    {
+        auto otherDoc = makeExportTestDocument(6);
+        MuPdfExporter exporter;
+        exporter.setDocument(otherDoc.get());
+        PdfExportResult other = exporter.exportPdf(options);
+        check(other.success && other.pagesReused == 0,
+              "another notebook's export to the same path reuses nothing");
+    }
+
+    options.incremental = false;
+    PdfExportResult seventh = run(false);
+    check(seventh.success && !QFile::exists(manifest), "plain export removes the manifest");
+
+    if (success) {
+        qDebug() << "PASS: incremental export";
+    }
+    return success;
+}
+#endif // SPEEDYNOTE_MUPDF_EXPORT
+
 /**
  * @brief Run all MuPdfExporter tests.
  * @return true if all tests pass, false otherwise.
@@ -313,6 +545,10 @@ inline bool runAllTests()
     bool allPassed = true;
     
     allPassed &= testParsePageRange();
+#ifdef SPEEDYNOTE_MUPDF_EXPORT
+    allPassed &= testParallelExportDeterministic();
+    allPassed &= testIncrementalExport();
+#endif
     
     qDebug() << "";
     if (allPassed) {
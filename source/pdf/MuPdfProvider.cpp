@@ -10,6 +10,8 @@
 #include <QDebug>
 #include <QFile>
 #include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrent>
 
 // CJK detection shared with PdfSearchEngine / DocumentViewport / OCR engines
 // so the "one PdfTextBox per CJK glyph" rule below stays consistent with the
@@ -17,7 +19,7 @@
 #include "../ocr/OcrTextBlock.h"
 
 // ============================================================================
-// BUG-Q003: Shared lock context for MuPDF thread safety (Qt5/Win32)
+// BUG-Q003: Shared lock context for MuPDF thread safety
 // ============================================================================
 // MuPDF routes OpenJPEG/HarfBuzz/FreeType allocations through plain global
 // variables (opj_secret, fz_hb_secret, ftmemory.user), protected by
@@ -28,8 +30,11 @@
 // Providing a real fz_locks_context shared across ALL provider instances lets
 // MuPDF's own fine-grained locking work correctly: only the critical sections
 // are serialised, while the rest of each render runs in parallel.
+//
+// The lock context is also what makes fz_clone_context() possible (it refuses
+// to clone a context without locks), which the per-provider lane pool relies
+// on, so it is installed on every platform.
 // ============================================================================
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 static QMutex s_mupdfLocks[FZ_LOCK_MAX];
 
 static void sn_mupdf_lock(void * /*user*/, int lock)
@@ -47,7 +52,6 @@ static fz_locks_context s_mupdfLocksCtx = {
     sn_mupdf_lock,
     sn_mupdf_unlock
 };
-#endif
 
 // ============================================================================
 // Construction / Destruction
@@ -58,18 +62,14 @@ static constexpr size_t SN_MUPDF_STORE_MAX = 32 << 20; // 32 MiB
 MuPdfProvider::MuPdfProvider(const QString& pdfPath)
     : m_path(pdfPath)
 {
-    // Create MuPDF context
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    // Create the base MuPDF context (cloned per lane, never used for work)
     m_ctx = fz_new_context(nullptr, &s_mupdfLocksCtx, SN_MUPDF_STORE_MAX);
-#else
-    m_ctx = fz_new_context(nullptr, nullptr, SN_MUPDF_STORE_MAX);
-#endif
     if (!m_ctx) {
         qWarning() << "MuPdfProvider: Failed to create MuPDF context";
         return;
     }
     
-    // Register document handlers (PDF, XPS, etc.)
+    // Register document handlers (PDF, XPS, etc.) - shared with every clone
     fz_try(m_ctx) {
         fz_register_document_handlers(m_ctx);
     }
@@ -80,25 +80,26 @@ MuPdfProvider::MuPdfProvider(const QString& pdfPath)
         return;
     }
     
-    // Open the document
-    QByteArray pathUtf8 = pdfPath.toUtf8();
-    fz_try(m_ctx) {
-        m_doc = fz_open_document(m_ctx, pathUtf8.constData());
-    }
-    fz_catch(m_ctx) {
-        qWarning() << "MuPdfProvider: Failed to open" << pdfPath 
-                   << "-" << fz_caught_message(m_ctx);
+    // Open the document on the first lane
+    Lane* lane = openLane();
+    if (!lane) {
         // FIX: Drop context to prevent memory leak when document fails to open
         fz_drop_context(m_ctx);
         m_ctx = nullptr;
         return;
     }
+    m_lanes.emplace_back(lane);
+    m_idleLanes.append(lane);
+    m_laneCount = 1;
+    m_maxLanes = qBound(1, QThread::idealThreadCount(), MAX_LANES);
+    m_opened = true;
+    m_prefetchPool.setMaxThreadCount(1);
     
     // Cache page count
-    fz_try(m_ctx) {
-        m_pageCount = fz_count_pages(m_ctx, m_doc);
+    fz_try(lane->ctx) {
+        m_pageCount = fz_count_pages(lane->ctx, lane->doc);
     }
-    fz_catch(m_ctx) {
+    fz_catch(lane->ctx) {
         qWarning() << "MuPdfProvider: Failed to get page count";
         m_pageCount = 0;
     }
@@ -109,31 +110,133 @@ MuPdfProvider::MuPdfProvider(const QString& pdfPath)
 
 MuPdfProvider::~MuPdfProvider()
 {
-    if (m_doc) {
-        fz_drop_document(m_ctx, m_doc);
-        m_doc = nullptr;
+    // The prefetch thread is ours, not a caller: stop it before the lanes go.
+    m_closing = true;
+    {
+        QMutexLocker locker(&m_prefetchMutex);
+        m_prefetchQueue.clear();
+    }
+    m_prefetchPool.waitForDone();
+    
+    // Callers must not be mid-call (same contract as before the lane pool),
+    // so every lane is idle here.
+    for (const std::unique_ptr<Lane>& lane : m_lanes) {
+        if (lane->doc) {
+            fz_drop_document(lane->ctx, lane->doc);
+        }
+        fz_drop_context(lane->ctx);
     }
+    m_lanes.clear();
+    m_idleLanes.clear();
     if (m_ctx) {
         fz_drop_context(m_ctx);
         m_ctx = nullptr;
     }
 }
 
+// ============================================================================
+// Lane Pool
+// ============================================================================
+
+MuPdfProvider::Lane* MuPdfProvider::openLane() const
+{
+    fz_context* ctx = nullptr;
+    {
+        QMutexLocker locker(&m_cloneMutex);
+        ctx = fz_clone_context(m_ctx);
+    }
+    if (!ctx) {
+        qWarning() << "MuPdfProvider: Failed to clone MuPDF context";
+        return nullptr;
+    }
+    
+    fz_document* doc = nullptr;
+    QByteArray pathUtf8 = m_path.toUtf8();
+    fz_try(ctx) {
+        doc = fz_open_document(ctx, pathUtf8.constData());
+    }
+    fz_catch(ctx) {
+        qWarning() << "MuPdfProvider: Failed to open" << m_path 
+                   << "-" << fz_caught_message(ctx);
+        fz_drop_context(ctx);
+        return nullptr;
+    }
+    
+    Lane* lane = new Lane;
+    lane->ctx = ctx;
+    lane->doc = doc;
+    return lane;
+}
+
+MuPdfProvider::LaneLease MuPdfProvider::acquireLane() const
+{
+    if (!m_opened) {
+        return LaneLease();
+    }
+    
+    QMutexLocker locker(&m_poolMutex);
+    for (;;) {
+        if (!m_idleLanes.isEmpty()) {
+            return LaneLease(this, m_idleLanes.takeLast());
+        }
+        
+        if (m_laneCount < m_maxLanes) {
+            // Reserve the slot, then open outside the pool mutex: parsing the
+            // document can take a while and must not block releases.
+            ++m_laneCount;
+            locker.unlock();
+            Lane* lane = openLane();
+            locker.relock();
+            if (lane) {
+                m_lanes.emplace_back(lane);
+                return LaneLease(this, lane);
+            }
+            // Cloning failed (e.g. out of memory): stop growing and wait
+            // for one of the existing lanes instead.
+            --m_laneCount;
+            m_maxLanes = m_laneCount;
+            continue;
+        }
+        
+        m_laneReleased.wait(&m_poolMutex);
+    }
+}
+
+void MuPdfProvider::releaseLane(Lane* lane) const
+{
+    QMutexLocker locker(&m_poolMutex);
+    m_idleLanes.append(lane);
+    m_laneReleased.wakeOne();
+}
+
+int MuPdfProvider::maxLanes() const
+{
+    QMutexLocker locker(&m_poolMutex);
+    return m_maxLanes;
+}
+
+void MuPdfProvider::setMaxLanes(int lanes)
+{
+    QMutexLocker locker(&m_poolMutex);
+    m_maxLanes = qBound(1, lanes, MAX_LANES);
+}
+
 // ============================================================================
 // Document Info
 // ============================================================================
 
 bool MuPdfProvider::isValid() const
 {
-    return m_ctx != nullptr && m_doc != nullptr && m_pageCount > 0;
+    return m_ctx != nullptr && m_opened && m_pageCount > 0;
 }
 
 bool MuPdfProvider::isLocked() const
 {
-    if (!m_doc) return false;
+    LaneLease lane = acquireLane();
+    if (!lane) return false;
     
     // Check if document needs password
-    int needs = fz_needs_password(m_ctx, m_doc);
+    int needs = fz_needs_password(lane.ctx(), lane.doc());
     return needs != 0;
 }
 
@@ -166,11 +269,13 @@ QString MuPdfProvider::getMetadata(const char* key) const
 {
     if (!isValid()) return QString();
     
+    LaneLease lane = acquireLane();
+    fz_context* ctx = lane.ctx();
     char buf[256] = {0};
-    fz_try(m_ctx) {
-        fz_lookup_metadata(m_ctx, m_doc, key, buf, sizeof(buf));
+    fz_try(ctx) {
+        fz_lookup_metadata(ctx, lane.doc(), key, buf, sizeof(buf));
     }
-    fz_catch(m_ctx) {
+    fz_catch(ctx) {
         return QString();
     }
     
@@ -185,17 +290,19 @@ bool MuPdfProvider::hasOutline() const
 {
     if (!isValid()) return false;
     
+    LaneLease lane = acquireLane();
+    fz_context* ctx = lane.ctx();
     fz_outline* ol = nullptr;
-    fz_try(m_ctx) {
-        ol = fz_load_outline(m_ctx, m_doc);
+    fz_try(ctx) {
+        ol = fz_load_outline(ctx, lane.doc());
     }
-    fz_catch(m_ctx) {
+    fz_catch(ctx) {
         return false;
     }
     
     bool has = (ol != nullptr);
     if (ol) {
-        fz_drop_outline(m_ctx, ol);
+        fz_drop_outline(ctx, ol);
     }
     return has;
 }
@@ -204,18 +311,20 @@ QVector<PdfOutlineItem> MuPdfProvider::outline() const
 {
     if (!isValid()) return {};
     
+    LaneLease lane = acquireLane();
+    fz_context* ctx = lane.ctx();
     fz_outline* ol = nullptr;
-    fz_try(m_ctx) {
-        ol = fz_load_outline(m_ctx, m_doc);
+    fz_try(ctx) {
+        ol = fz_load_outline(ctx, lane.doc());
     }
-    fz_catch(m_ctx) {
+    fz_catch(ctx) {
         return {};
     }
     
     QVector<PdfOutlineItem> result = convertOutline(ol);
     
     if (ol) {
-        fz_drop_outline(m_ctx, ol);
+        fz_drop_outline(ctx, ol);
     }
     
     return result;
@@ -263,19 +372,19 @@ QVector<PdfOutlineItem> MuPdfProvider::convertOutline(fz_outline* ol) const
 
 QSizeF MuPdfProvider::pageSize(int pageIndex) const
 {
-    QMutexLocker locker(&m_mutex);
-    
     if (!isValid() || pageIndex < 0 || pageIndex >= m_pageCount) {
         return QSizeF();
     }
     
+    LaneLease lane = acquireLane();
+    fz_context* ctx = lane.ctx();
     fz_rect bounds = fz_empty_rect;
-    fz_try(m_ctx) {
-        fz_page* page = fz_load_page(m_ctx, m_doc, pageIndex);
-        bounds = fz_bound_page(m_ctx, page);
-        fz_drop_page(m_ctx, page);
+    fz_try(ctx) {
+        fz_page* page = fz_load_page(ctx, lane.doc(), pageIndex);
+        bounds = fz_bound_page(ctx, page);
+        fz_drop_page(ctx, page);
     }
-    fz_catch(m_ctx) {
+    fz_catch(ctx) {
         return QSizeF();
     }
     
@@ -288,21 +397,29 @@ QSizeF MuPdfProvider::pageSize(int pageIndex) const
 
 QImage MuPdfProvider::renderPageToImage(int pageIndex, qreal dpi) const
 {
-    // Thread safety: MuPDF context is not thread-safe, so we need to serialize access
-    // This is especially important on Android where main thread sync renders can
-    // overlap with background async renders (BUG-A006)
-    QMutexLocker locker(&m_mutex);
-    
-    if (!isValid() || pageIndex < 0 || pageIndex >= m_pageCount) {
+    return renderToImage(pageIndex, dpi, nullptr);
+}
+
+QImage MuPdfProvider::renderPageRegionToImage(int pageIndex, qreal dpi, const QRect& region) const
+{
+    if (region.isEmpty()) {
         return QImage();
     }
-    
-    // Additional safety check for context
-    if (!m_ctx || !m_doc) {
-        qWarning() << "MuPdfProvider: Context or document is null";
+    return renderToImage(pageIndex, dpi, &region);
+}
+
+QImage MuPdfProvider::renderToImage(int pageIndex, qreal dpi, const QRect* region) const
+{
+    if (!isValid() || pageIndex < 0 || pageIndex >= m_pageCount) {
         return QImage();
     }
     
+    // Thread safety: a MuPDF context is not thread-safe, so each render leases
+    // its own lane. Main thread sync renders and background async renders
+    // (BUG-A006) no longer share one context, so they run in parallel.
+    LaneLease lane = acquireLane();
+    fz_context* ctx = lane.ctx();
+    
     // Scale factor: PDF points are 72 dpi
     float scale = dpi / 72.0f;
     
@@ -310,20 +427,33 @@ QImage MuPdfProvider::renderPageToImage(int pageIndex, qreal dpi) const
     fz_pixmap* pix = nullptr;
     QImage result;
     
-    fz_try(m_ctx) {
+    fz_try(ctx) {
         // Load page
-        page = fz_load_page(m_ctx, m_doc, pageIndex);
+        page = fz_load_page(ctx, lane.doc(), pageIndex);
         if (!page) {
-            fz_throw(m_ctx, FZ_ERROR_GENERIC, "Failed to load page %d", pageIndex);
+            fz_throw(ctx, FZ_ERROR_GENERIC, "Failed to load page %d", pageIndex);
         }
         
         // Create transformation matrix
         fz_matrix ctm = fz_scale(scale, scale);
         
         // Get page bounds at this scale
-        fz_rect bounds = fz_bound_page(m_ctx, page);
+        fz_rect bounds = fz_bound_page(ctx, page);
         fz_irect bbox = fz_round_rect(fz_transform_rect(bounds, ctm));
         
+        // Region render (tiled PDF cache): clip the pixmap to the requested
+        // rect, given relative to the full-page image origin. The draw device
+        // only rasterizes inside the pixmap's bbox, so a tile costs roughly
+        // its own area instead of the whole page.
+        if (region) {
+            const int x0 = bbox.x0 + region->left();
+            const int y0 = bbox.y0 + region->top();
+            bbox.x1 = qMin(bbox.x1, x0 + region->width());
+            bbox.y1 = qMin(bbox.y1, y0 + region->height());
+            bbox.x0 = qMax(bbox.x0, x0);
+            bbox.y0 = qMax(bbox.y0, y0);
+        }
+        
         // Bounds guard. Render DPI is already capped upstream (effectivePdfDpi()
         // caps at 300 DPI), so a full-page render is inherently memory-bounded by
         // the page's physical size. We only reject degenerate bounds and
@@ -339,36 +469,36 @@ QImage MuPdfProvider::renderPageToImage(int pageIndex, qreal dpi) const
             imgWidth > kMaxAxis || imgHeight > kMaxAxis ||
             totalPixels > kMaxPixels) {
             qWarning() << "MuPdfProvider: Invalid page bounds" << imgWidth << "x" << imgHeight;
-            fz_throw(m_ctx, FZ_ERROR_GENERIC, "Invalid page bounds");
+            fz_throw(ctx, FZ_ERROR_GENERIC, "Invalid page bounds");
         }
         
         // Create pixmap (BGRA for Qt compatibility)
-        pix = fz_new_pixmap_with_bbox(m_ctx, fz_device_bgr(m_ctx), bbox, nullptr, 1);
+        pix = fz_new_pixmap_with_bbox(ctx, fz_device_bgr(ctx), bbox, nullptr, 1);
         if (!pix) {
-            fz_throw(m_ctx, FZ_ERROR_GENERIC, "Failed to create pixmap");
+            fz_throw(ctx, FZ_ERROR_GENERIC, "Failed to create pixmap");
         }
-        fz_clear_pixmap_with_value(m_ctx, pix, 255); // White background
+        fz_clear_pixmap_with_value(ctx, pix, 255); // White background
         
         // Render page to pixmap
-        fz_device* dev = fz_new_draw_device(m_ctx, ctm, pix);
+        fz_device* dev = fz_new_draw_device(ctx, ctm, pix);
         if (!dev) {
-            fz_throw(m_ctx, FZ_ERROR_GENERIC, "Failed to create draw device");
+            fz_throw(ctx, FZ_ERROR_GENERIC, "Failed to create draw device");
         }
-        fz_run_page(m_ctx, page, dev, fz_identity, nullptr);
-        fz_close_device(m_ctx, dev);
-        fz_drop_device(m_ctx, dev);
+        fz_run_page(ctx, page, dev, fz_identity, nullptr);
+        fz_close_device(ctx, dev);
+        fz_drop_device(ctx, dev);
         
         // Convert to QImage
-        int width = fz_pixmap_width(m_ctx, pix);
-        int height = fz_pixmap_height(m_ctx, pix);
-        int stride = fz_pixmap_stride(m_ctx, pix);
-        unsigned char* samples = fz_pixmap_samples(m_ctx, pix);
+        int width = fz_pixmap_width(ctx, pix);
+        int height = fz_pixmap_height(ctx, pix);
+        int stride = fz_pixmap_stride(ctx, pix);
+        unsigned char* samples = fz_pixmap_samples(ctx, pix);
         
         // Verify data is valid before copy
         if (!samples || stride < width * 4) {
             qWarning() << "MuPdfProvider: Invalid pixmap data - samples:" << (samples ? "valid" : "null")
                        << "stride:" << stride << "expected:" << (width * 4);
-            fz_throw(m_ctx, FZ_ERROR_GENERIC, "Invalid pixmap data");
+            fz_throw(ctx, FZ_ERROR_GENERIC, "Invalid pixmap data");
         }
         
         // Create QImage and copy data
@@ -376,7 +506,7 @@ QImage MuPdfProvider::renderPageToImage(int pageIndex, qreal dpi) const
         result = QImage(width, height, QImage::Format_ARGB32);
         if (result.isNull()) {
             qWarning() << "MuPdfProvider: Failed to allocate QImage" << width << "x" << height;
-            fz_throw(m_ctx, FZ_ERROR_GENERIC, "Failed to allocate QImage");
+            fz_throw(ctx, FZ_ERROR_GENERIC, "Failed to allocate QImage");
         }
         
         // Copy row by row, using QImage's bytesPerLine for destination stride
@@ -387,13 +517,13 @@ QImage MuPdfProvider::renderPageToImage(int pageIndex, qreal dpi) const
             memmove(dst, src, width * 4);
         }
     }
-    fz_always(m_ctx) {
-        if (pix) fz_drop_pixmap(m_ctx, pix);
-        if (page) fz_drop_page(m_ctx, page);
+    fz_always(ctx) {
+        if (pix) fz_drop_pixmap(ctx, pix);
+        if (page) fz_drop_page(ctx, page);
     }
-    fz_catch(m_ctx) {
+    fz_catch(ctx) {
         qWarning() << "MuPdfProvider: Render failed for page" << pageIndex 
-                   << "-" << fz_caught_message(m_ctx);
+                   << "-" << fz_caught_message(ctx);
         return QImage();
     }
     
@@ -406,9 +536,10 @@ QImage MuPdfProvider::renderPageToImage(int pageIndex, qreal dpi) const
 
 void MuPdfProvider::trimStore() const
 {
-    QMutexLocker locker(&m_mutex);
-    if (m_ctx) {
-        fz_shrink_store(m_ctx, 0);
+    // The store is shared by all lanes; any lane can shrink it.
+    LaneLease lane = acquireLane();
+    if (lane) {
+        fz_shrink_store(lane.ctx(), 0);
     }
 }
 
@@ -448,23 +579,24 @@ static void img_collect_fill_image_mask(fz_context*, fz_device* dev_,
 
 QVector<QRect> MuPdfProvider::imageRegions(int pageIndex, qreal dpi) const
 {
-    QMutexLocker locker(&m_mutex);
     QVector<QRect> result;
 
     if (!isValid() || pageIndex < 0 || pageIndex >= m_pageCount)
         return result;
 
+    LaneLease lane = acquireLane();
+
     float scale = dpi / 72.0f;
     fz_matrix ctm = fz_scale(scale, scale);
     fz_page* page = nullptr;
 
     // fz_new_derived_device macro internally references a bare 'ctx' variable
-    fz_context* ctx = m_ctx;
+    fz_context* ctx = lane.ctx();
 
     fz_device* dev = nullptr;
 
     fz_try(ctx) {
-        page = fz_load_page(ctx, m_doc, pageIndex);
+        page = fz_load_page(ctx, lane.doc(), pageIndex);
 
         // Create a lightweight device that only records image positions
         ImageCollector* collector =
@@ -496,22 +628,81 @@ QVector<QRect> MuPdfProvider::imageRegions(int pageIndex, qreal dpi) const
 
 QVector<PdfTextBox> MuPdfProvider::textBoxes(int pageIndex) const
 {
-    QMutexLocker locker(&m_mutex);
-    
     if (!isValid() || pageIndex < 0 || pageIndex >= m_pageCount) {
         return {};
     }
     
     QVector<PdfTextBox> boxes;
+    if (m_textCache.find(pageIndex, boxes)) {
+        return boxes;
+    }
+    if (!extractTextBoxes(pageIndex, boxes)) {
+        return {};
+    }
+    m_textCache.insert(pageIndex, boxes);
+    return boxes;
+}
+
+void MuPdfProvider::prefetchTextBoxes(const QVector<int>& pageIndices) const
+{
+    if (!isValid() || m_closing) {
+        return;
+    }
+    
+    QVector<int> pages;
+    for (int pageIndex : pageIndices) {
+        if (pageIndex >= 0 && pageIndex < m_pageCount && !pages.contains(pageIndex)
+            && !m_textCache.contains(pageIndex)) {
+            pages.append(pageIndex);
+        }
+    }
+    
+    // The newest request replaces the queue: after a scroll, the pages
+    // around the old position are no longer worth extracting.
+    QMutexLocker locker(&m_prefetchMutex);
+    m_prefetchQueue = pages;
+    if (m_prefetching || m_prefetchQueue.isEmpty()) {
+        return;
+    }
+    m_prefetching = true;
+    m_prefetchFuture = QtConcurrent::run(&m_prefetchPool, [this]() { drainTextPrefetch(); });
+}
+
+void MuPdfProvider::drainTextPrefetch() const
+{
+    // Background work: leave the CPU to rendering and input.
+    QThread::currentThread()->setPriority(QThread::LowPriority);
+    
+    for (;;) {
+        int pageIndex = -1;
+        {
+            QMutexLocker locker(&m_prefetchMutex);
+            if (m_prefetchQueue.isEmpty() || m_closing) {
+                m_prefetching = false;
+                return;
+            }
+            pageIndex = m_prefetchQueue.takeFirst();
+        }
+        // A caller may have extracted it in the meantime.
+        if (!m_textCache.contains(pageIndex)) {
+            textBoxes(pageIndex);
+        }
+    }
+}
+
+bool MuPdfProvider::extractTextBoxes(int pageIndex, QVector<PdfTextBox>& boxes) const
+{
+    LaneLease lane = acquireLane();
+    fz_context* ctx = lane.ctx();
     fz_page* page = nullptr;
     fz_stext_page* textPage = nullptr;
     
-    fz_try(m_ctx) {
-        page = fz_load_page(m_ctx, m_doc, pageIndex);
+    fz_try(ctx) {
+        page = fz_load_page(ctx, lane.doc(), pageIndex);
         
         // Extract text with positions
         fz_stext_options opts = {0};
-        textPage = fz_new_stext_page_from_page(m_ctx, page, &opts);
+        textPage = fz_new_stext_page_from_page(ctx, page, &opts);
         
         // Iterate through text blocks.
         //
@@ -584,16 +775,17 @@ QVector<PdfTextBox> MuPdfProvider::textBoxes(int pageIndex) const
             }
         }
     }
-    fz_always(m_ctx) {
-        if (textPage) fz_drop_stext_page(m_ctx, textPage);
-        if (page) fz_drop_page(m_ctx, page);
+    fz_always(ctx) {
+        if (textPage) fz_drop_stext_page(ctx, textPage);
+        if (page) fz_drop_page(ctx, page);
     }
-    fz_catch(m_ctx) {
+    fz_catch(ctx) {
         qWarning() << "MuPdfProvider: Text extraction failed for page" << pageIndex;
-        return {};
+        boxes.clear();
+        return false;
     }
     
-    return boxes;
+    return true;
 }
 
 // ============================================================================
@@ -602,22 +794,22 @@ QVector<PdfTextBox> MuPdfProvider::textBoxes(int pageIndex) const
 
 QVector<PdfLink> MuPdfProvider::links(int pageIndex) const
 {
-    QMutexLocker locker(&m_mutex);
-    
     if (!isValid() || pageIndex < 0 || pageIndex >= m_pageCount) {
         return {};
     }
     
+    LaneLease lane = acquireLane();
+    fz_context* ctx = lane.ctx();
     QVector<PdfLink> result;
     fz_page* page = nullptr;
     fz_link* links = nullptr;
     
-    fz_try(m_ctx) {
-        page = fz_load_page(m_ctx, m_doc, pageIndex);
-        links = fz_load_links(m_ctx, page);
+    fz_try(ctx) {
+        page = fz_load_page(ctx, lane.doc(), pageIndex);
+        links = fz_load_links(ctx, page);
         
         // Get page bounds for normalization
-        fz_rect pageBounds = fz_bound_page(m_ctx, page);
+        fz_rect pageBounds = fz_bound_page(ctx, page);
         qreal pageWidth = pageBounds.x1 - pageBounds.x0;
         qreal pageHeight = pageBounds.y1 - pageBounds.y0;
         
@@ -654,7 +846,7 @@ QVector<PdfLink> MuPdfProvider::links(int pageIndex) const
                     } else {
                         // Named destination - try to resolve
                         float xp, yp;
-                        fz_location loc = fz_resolve_link(m_ctx, m_doc, link->uri, &xp, &yp);
+                        fz_location loc = fz_resolve_link(ctx, lane.doc(), link->uri, &xp, &yp);
                         if (loc.page >= 0) {
                             pdfLink.type = PdfLinkType::Goto;
                             pdfLink.targetPage = loc.page;
@@ -663,7 +855,7 @@ QVector<PdfLink> MuPdfProvider::links(int pageIndex) const
                 } else {
                     // Other format - try to resolve as destination name
                     float xp, yp;
-                    fz_location loc = fz_resolve_link(m_ctx, m_doc, link->uri, &xp, &yp);
+                    fz_location loc = fz_resolve_link(ctx, lane.doc(), link->uri, &xp, &yp);
                     if (loc.page >= 0) {
                         pdfLink.type = PdfLinkType::Goto;
                         pdfLink.targetPage = loc.page;
@@ -676,11 +868,11 @@ QVector<PdfLink> MuPdfProvider::links(int pageIndex) const
             }
         }
     }
-    fz_always(m_ctx) {
-        if (links) fz_drop_link(m_ctx, links);
-        if (page) fz_drop_page(m_ctx, page);
+    fz_always(ctx) {
+        if (links) fz_drop_link(ctx, links);
+        if (page) fz_drop_page(ctx, page);
     }
-    fz_catch(m_ctx) {
+    fz_catch(ctx) {
         qWarning() << "MuPdfProvider: Link extraction failed for page" << pageIndex;
         return {};
     }
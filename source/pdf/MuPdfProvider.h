@@ -16,7 +16,16 @@
 // ============================================================================
 
 #include "PdfProvider.h"
+#include "PdfTextCache.h"
+#include <QFuture>
 #include <QMutex>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+#include <vector>
 
 // Forward declarations for MuPDF types (avoid exposing mupdf headers)
 struct fz_context;
@@ -27,6 +36,17 @@ struct fz_document;
  * 
  * Wraps the MuPDF library for PDF rendering, text extraction, and navigation.
  * Used on Android where Poppler is not available.
+ * 
+ * Thread safety: an fz_context/fz_document pair may only be used by one
+ * thread at a time, so the provider keeps a small pool of "lanes" - contexts
+ * cloned from a base context (sharing its resource store and locks) with
+ * their own handle on the document. Every call leases a lane for its
+ * duration, so up to maxLanes() threads render or extract text from the
+ * same provider concurrently instead of queueing on one mutex.
+ *
+ * Extracted page text is kept in a PdfTextCache shared by all callers
+ * (selection, highlighter, search), and prefetchTextBoxes() fills it for
+ * neighbouring pages on a background thread.
  */
 class MuPdfProvider : public PdfProvider {
 public:
@@ -65,18 +85,112 @@ public:
     
     // ===== Rendering =====
     QImage renderPageToImage(int pageIndex, qreal dpi) const override;
+    QImage renderPageRegionToImage(int pageIndex, qreal dpi, const QRect& region) const override;
     QVector<QRect> imageRegions(int pageIndex, qreal dpi) const override;
     void trimStore() const override;
     
     // ===== Text Selection =====
     QVector<PdfTextBox> textBoxes(int pageIndex) const override;
     bool supportsTextExtraction() const override { return true; }
+    void prefetchTextBoxes(const QVector<int>& pageIndices) const override;
+    
+    /**
+     * @brief The per-page text cache behind textBoxes() (for budgets and tests).
+     */
+    PdfTextCache& textCache() const { return m_textCache; }
     
     // ===== Links =====
     QVector<PdfLink> links(int pageIndex) const override;
     bool supportsLinks() const override { return true; }
     
+    // ===== Concurrency =====
+    
+    /**
+     * @brief Maximum number of concurrent MuPDF lanes (contexts) in the pool.
+     */
+    int maxLanes() const;
+    
+    /**
+     * @brief Limit the lane pool (clamped to [1, MAX_LANES]).
+     * 
+     * Lanes are opened lazily, so this only caps future growth; lanes that
+     * already exist stay open. Mainly for benchmarks and low-memory devices.
+     */
+    void setMaxLanes(int lanes);
+    
+    /// Hard upper bound on lanes per provider.
+#if defined(Q_OS_ANDROID) || defined(Q_OS_IOS)
+    static constexpr int MAX_LANES = 4;
+#else
+    static constexpr int MAX_LANES = 16;
+#endif
+    
 private:
+    /**
+     * @brief A cloned context plus its own handle on the document.
+     */
+    struct Lane {
+        fz_context* ctx = nullptr;
+        fz_document* doc = nullptr;
+    };
+    
+    /**
+     * @brief RAII lease on a lane; returns it to the pool when destroyed.
+     */
+    class LaneLease {
+    public:
+        LaneLease() = default;
+        LaneLease(const MuPdfProvider* owner, Lane* lane) : m_owner(owner), m_lane(lane) {}
+        ~LaneLease() { if (m_lane) m_owner->releaseLane(m_lane); }
+        LaneLease(const LaneLease&) = delete;
+        LaneLease& operator=(const LaneLease&) = delete;
+        
+        explicit operator bool() const { return m_lane != nullptr; }
+        fz_context* ctx() const { return m_lane->ctx; }
+        fz_document* doc() const { return m_lane->doc; }
+        
+    private:
+        const MuPdfProvider* m_owner = nullptr;
+        Lane* m_lane = nullptr;
+    };
+    
+    /**
+     * @brief Lease an idle lane, opening a new one if the pool may grow,
+     *        otherwise blocking until another thread releases one.
+     * @return Empty lease if the provider is invalid.
+     */
+    LaneLease acquireLane() const;
+    
+    /**
+     * @brief Return a leased lane to the pool and wake one waiter.
+     */
+    void releaseLane(Lane* lane) const;
+    
+    /**
+     * @brief Clone the base context and open the document on the clone.
+     * @return New lane (caller takes ownership), or nullptr on failure.
+     */
+    Lane* openLane() const;
+    
+    /**
+     * @brief Shared full-page / region rasterizer.
+     * @param region Region in full-page pixel coordinates, or nullptr for
+     *        the whole page.
+     */
+    QImage renderToImage(int pageIndex, qreal dpi, const QRect* region) const;
+    
+    /**
+     * @brief Run MuPDF structured-text extraction for one page (uncached).
+     * @return false if extraction failed (nothing to cache).
+     */
+    bool extractTextBoxes(int pageIndex, QVector<PdfTextBox>& boxes) const;
+    
+    /**
+     * @brief Extract queued prefetch pages until the queue is empty
+     *        (prefetch thread).
+     */
+    void drainTextPrefetch() const;
+    
     /**
      * @brief Get metadata string from PDF.
      * @param key Metadata key (e.g., "info:Title", "info:Author")
@@ -91,15 +205,31 @@ private:
      */
     QVector<PdfOutlineItem> convertOutline(struct fz_outline* outline) const;
     
-    // MuPDF context and document are mutable because fz_* functions 
-    // modify internal state even for "read" operations like rendering.
-    // This is required for proper const-correctness with MuPDF's API.
-    mutable fz_context* m_ctx = nullptr;  ///< MuPDF context (owns all allocations)
-    mutable fz_document* m_doc = nullptr; ///< The loaded PDF document
+    // The base context is never used for work: it owns the document handlers
+    // and the shared resource store, and is only cloned (under m_cloneMutex)
+    // to create lanes. Mutable because fz_* functions modify internal state
+    // even for "read" operations like rendering.
+    mutable fz_context* m_ctx = nullptr;  ///< Base MuPDF context (clone source)
     QString m_path;                       ///< Path to the PDF file
     int m_pageCount = 0;                  ///< Cached page count
+    bool m_opened = false;                ///< First lane opened the document
+    
+    // ----- Lane pool (guarded by m_poolMutex) -----
+    mutable QMutex m_poolMutex;
+    mutable QWaitCondition m_laneReleased;
+    mutable std::vector<std::unique_ptr<Lane>> m_lanes;  ///< All open lanes (owned)
+    mutable QVector<Lane*> m_idleLanes;                  ///< Lanes not currently leased
+    mutable int m_laneCount = 0;                         ///< Open + opening lanes
+    mutable int m_maxLanes = 1;
+    mutable QMutex m_cloneMutex;                         ///< Serializes fz_clone_context(m_ctx)
     
-    // Mutex for thread-safety on Android (main thread sync + background async renders)
-    mutable QMutex m_mutex;
+    // ----- Text cache and prefetch (queue guarded by m_prefetchMutex) -----
+    mutable PdfTextCache m_textCache;
+    mutable QMutex m_prefetchMutex;
+    mutable QVector<int> m_prefetchQueue;                ///< Pages still to extract, in order
+    mutable bool m_prefetching = false;                  ///< Prefetch task queued or running
+    mutable QThreadPool m_prefetchPool;                  ///< One background thread
+    mutable QFuture<void> m_prefetchFuture;
+    std::atomic<bool> m_closing{false};                  ///< Destructor running
 };
 
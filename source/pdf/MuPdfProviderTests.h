@@ -0,0 +1,324 @@
+#pragma once
+
+// ============================================================================
+// MuPdfProviderTests - Tests and benchmark for MuPdfProvider concurrency
+// ============================================================================
+// The provider leases one cloned MuPDF context ("lane") per concurrent call.
+// These check that parallel renders/text extraction match serial ones, that
+// the per-page text cache returns what extraction does, and measure how
+// throughput scales with thread count.
+//
+// Run with: speedynote --test-pdfprovider
+//           speedynote --bench-pdf-render [file.pdf]
+// ============================================================================
+
+#include "MuPdfProvider.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace MuPdfProviderTests {
+
+/**
+ * @brief Write a text-and-vector heavy PDF with @p pageCount Letter pages.
+ */
+inline bool writeSyntheticPdf(const QString& path, int pageCount)
+{
+    QPdfWriter writer(path);
+    writer.setPageSize(QPageSize(QPageSize::Letter));
+    writer.setResolution(72);
+
+    QPainter painter(&writer);
+    if (!painter.isActive()) {
+        return false;
+    }
+    for (int p = 0; p < pageCount; ++p) {
+        if (p > 0) {
+            writer.newPage();
+        }
+        painter.setPen(Qt::black);
+        painter.setFont(QFont(QStringLiteral("Sans"), 9));
+        for (int line = 0; line < 60; ++line) {
+            painter.drawText(40, 40 + line * 11,
+                             QStringLiteral("Page %1 line %2: the quick brown fox jumps over the lazy dog")
+                                 .arg(p + 1).arg(line + 1));
+        }
+        for (int i = 0; i < 40; ++i) {
+            painter.setPen(QPen(QColor::fromHsv((p * 37 + i * 9) % 360, 200, 200), 1.5));
+            painter.drawEllipse(QPointF(300 + (i % 8) * 30, 720 - (i / 8) * 25), 12 + i % 5, 9);
+        }
+    }
+    return painter.end();
+}
+
+/**
+ * @brief Run @p work(pageIndex) over all pages on @p threads std::threads.
+ */
+inline void runOnThreads(int threads, int pageCount, const std::function<void(int)>& work)
+{
+    std::atomic<int> next{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (int i = next++; i < pageCount; i = next++) {
+                work(i);
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+}
+
+/**
+ * @brief Parallel renders and text extraction must match a serial pass.
+ */
+inline bool testParallelMatchesSerial()
+{
+    qDebug() << "=== Test: parallel lanes match serial rendering ===";
+
+    QTemporaryDir dir;
+    const QString path = dir.filePath(QStringLiteral("lanes.pdf"));
+    const int pageCount = 12;
+    if (!dir.isValid() || !writeSyntheticPdf(path, pageCount)) {
+        qDebug() << "FAIL: could not write synthetic PDF";
+        return false;
+    }
+
+    QVector<QImage> serialImages(pageCount);
+    QVector<int> serialBoxes(pageCount);
+    {
+        MuPdfProvider serial(path);
+        serial.setMaxLanes(1);
+        for (int i = 0; i < pageCount; ++i) {
+            serialImages[i] = serial.renderPageToImage(i, 72.0);
+            serialBoxes[i] = serial.textBoxes(i).size();
+        }
+    }
+
+    MuPdfProvider parallel(path);
+    parallel.setMaxLanes(4);
+    QVector<QImage> images(pageCount);
+    QVector<int> boxes(pageCount);
+    runOnThreads(4, pageCount, [&](int i) {
+        images[i] = parallel.renderPageToImage(i, 72.0);
+        boxes[i] = parallel.textBoxes(i).size();
+    });
+
+    bool success = true;
+    for (int i = 0; i < pageCount; ++i) {
+        if (serialImages[i].isNull() || images[i] != serialImages[i]) {
+            qDebug() << "FAIL: page" << i << "renders differently in parallel";
+            success = false;
+        }
+        if (serialBoxes[i] == 0 || boxes[i] != serialBoxes[i]) {
+            qDebug() << "FAIL: page" << i << "text boxes" << boxes[i] << "vs" << serialBoxes[i];
+            success = false;
+        }
+    }
+    if (success) {
+        qDebug() << "PASS: parallel lanes match serial rendering";
+    }
+    return success;
+}
+
+/**
+ * @brief The text cache round-trips text boxes, stays within its budget and
+ *        serves repeated and prefetched textBoxes() calls.
+ */
+inline bool testTextCache()
+{
+    qDebug() << "=== Test: per-page text cache ===";
+
+    QTemporaryDir dir;
+    const QString path = dir.filePath(QStringLiteral("text.pdf"));
+    const int pageCount = 8;
+    if (!dir.isValid() || !writeSyntheticPdf(path, pageCount)) {
+        qDebug() << "FAIL: could not write synthetic PDF";
+        return false;
+    }
+
+    auto sameBoxes = [](const QVector<PdfTextBox>& a, const QVector<PdfTextBox>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (int i = 0; i < a.size(); ++i) {
+            if (a[i].text != b[i].text || a[i].boundingBox != b[i].boundingBox
+                || a[i].charBoundingBoxes != b[i].charBoundingBoxes) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    bool success = true;
+    MuPdfProvider provider(path);
+    const QVector<PdfTextBox> first = provider.textBoxes(2);
+    const QVector<PdfTextBox> cached = provider.textBoxes(2);
+    if (first.isEmpty() || !provider.textCache().contains(2) || !sameBoxes(first, cached)) {
+        qDebug() << "FAIL: cached page differs from extracted page";
+        success = false;
+    }
+
+    // Boxes without char rects keep none.
+    QVector<PdfTextBox> mixed = first;
+    if (!mixed.isEmpty()) {
+        mixed[0].charBoundingBoxes.clear();
+    }
+    if (!sameBoxes(PdfTextCache::unpack(PdfTextCache::pack(mixed)), mixed)
+        || !PdfTextCache::unpack(PdfTextCache::pack({})).isEmpty()) {
+        qDebug() << "FAIL: flat layout round trip";
+        success = false;
+    }
+
+    // Prefetched pages are ready without another extraction.
+    provider.prefetchTextBoxes({4, 5, 6});
+    QElapsedTimer timer;
+    timer.start();
+    while (!(provider.textCache().contains(4) && provider.textCache().contains(5)
+             && provider.textCache().contains(6)) && timer.elapsed() < 5000) {
+        QThread::msleep(5);
+    }
+    if (!provider.textCache().contains(6)) {
+        qDebug() << "FAIL: prefetch did not fill the cache";
+        success = false;
+    }
+
+    // A budget of about two pages keeps the most recently used ones.
+    const qint64 pageBytes = PdfTextCache::pack(first).bytes();
+    provider.textCache().setBudgetBytes(pageBytes * 5 / 2);
+    provider.textBoxes(0);
+    provider.textBoxes(1);
+    if (provider.textCache().bytesUsed() > provider.textCache().budgetBytes()
+        || !provider.textCache().contains(1) || provider.textCache().contains(4)) {
+        qDebug() << "FAIL: budget" << provider.textCache().bytesUsed() << "of"
+                 << provider.textCache().budgetBytes() << "bytes," << provider.textCache().pageCount() << "pages";
+        success = false;
+    }
+    qDebug() << "Flat layout:" << pageBytes << "bytes for" << first.size() << "boxes";
+
+    if (success) {
+        qDebug() << "PASS: per-page text cache";
+    }
+    return success;
+}
+
+/**
+ * @brief Report pages/sec vs thread count for rendering and text extraction.
+ * @param pdfPath PDF to use; empty generates a synthetic 600-page document.
+ * @param dpi Render resolution (thumbnail-sized by default).
+ */
+inline bool benchmarkParallelRender(const QString& pdfPath = QString(), qreal dpi = 48.0)
+{
+    qDebug() << "=== Benchmark: MuPdfProvider pages/sec vs threads ===";
+
+    QTemporaryDir dir;
+    QString path = pdfPath;
+    if (path.isEmpty()) {
+        path = dir.filePath(QStringLiteral("bench.pdf"));
+        if (!dir.isValid() || !writeSyntheticPdf(path, 600)) {
+            qDebug() << "FAIL: could not write synthetic PDF";
+            return false;
+        }
+    }
+
+    int pageCount = 0;
+    {
+        MuPdfProvider probe(path);
+        if (!probe.isValid()) {
+            qDebug() << "FAIL: could not open" << path;
+            return false;
+        }
+        pageCount = probe.pageCount();
+    }
+    qDebug() << "Document:" << QDir::toNativeSeparators(path) << "-" << pageCount << "pages,"
+             << "render at" << dpi << "DPI," << QThread::idealThreadCount() << "hardware threads";
+
+    QVector<int> threadCounts;
+    for (int t = 1; t <= qMin(QThread::idealThreadCount(), int(MuPdfProvider::MAX_LANES)); t *= 2) {
+        threadCounts.append(t);
+    }
+    if (threadCounts.last() != qMin(QThread::idealThreadCount(), int(MuPdfProvider::MAX_LANES))) {
+        threadCounts.append(qMin(QThread::idealThreadCount(), int(MuPdfProvider::MAX_LANES)));
+    }
+
+    bool success = true;
+    qreal baseRender = 0;
+    qreal baseText = 0;
+    for (int threads : std::as_const(threadCounts)) {
+        // Fresh provider per run: lane setup (document open) is part of the
+        // cost a freshly opened notebook pays.
+        MuPdfProvider provider(path);
+        provider.setMaxLanes(threads);
+
+        std::atomic<int> failures{0};
+        QElapsedTimer timer;
+        timer.start();
+        runOnThreads(threads, pageCount, [&](int i) {
+            if (provider.renderPageToImage(i, dpi).isNull()) ++failures;
+        });
+        const qreal renderPps = pageCount * 1000.0 / qMax<qint64>(1, timer.elapsed());
+
+        timer.restart();
+        runOnThreads(threads, pageCount, [&](int i) {
+            provider.textBoxes(i);
+        });
+        const qreal textPps = pageCount * 1000.0 / qMax<qint64>(1, timer.elapsed());
+
+        if (threads == 1) {
+            baseRender = renderPps;
+            baseText = textPps;
+        }
+        qDebug().noquote() << QStringLiteral("%1 threads: render %2 pages/s (x%3), text %4 pages/s (x%5)")
+                                  .arg(threads, 2)
+                                  .arg(renderPps, 8, 'f', 1).arg(renderPps / baseRender, 0, 'f', 2)
+                                  .arg(textPps, 8, 'f', 1).arg(textPps / baseText, 0, 'f', 2);
+        if (failures > 0) {
+            qDebug() << "FAIL:" << int(failures) << "pages failed to render with" << threads << "threads";
+            success = false;
+        }
+    }
+    return success;
+}
+
+/**
+ * @brief Run all MuPdfProvider tests.
+ * @return true if all tests pass, false otherwise.
+ */
+inline bool runAllTests()
+{
+    qDebug() << "";
+    qDebug() << "========================================";
+    qDebug() << "   MuPdfProvider Tests";
+    qDebug() << "========================================";
+
+    bool allPassed = true;
+
+    allPassed &= testParallelMatchesSerial();
+    allPassed &= testTextCache();
+
+    qDebug() << "";
+    if (allPassed) {
+        qDebug() << "✅ All MuPdfProvider tests passed!";
+    } else {
+        qDebug() << "❌ Some MuPdfProvider tests failed!";
+    }
+    qDebug() << "========================================";
+    qDebug() << "";
+
+    return allPassed;
+}
+
+} // namespace MuPdfProviderTests
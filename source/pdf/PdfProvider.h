@@ -212,6 +212,25 @@ public:
         return img.isNull() ? QPixmap() : QPixmap::fromImage(img);
     }
     
+    /**
+     * @brief Render a rectangular region of a page to a QImage.
+     * @param pageIndex 0-based page index.
+     * @param dpi Resolution in dots per inch.
+     * @param region Region in pixel coordinates of the full-page image at
+     *        @p dpi (the image renderPageToImage() would return).
+     * @return Image of the region clipped to the page (smaller than @p region
+     *         at the right/bottom edge), or null QImage on error.
+     * 
+     * Used by the viewport's tiled PDF cache. Default implementation renders
+     * the whole page and crops; subclasses should override to rasterize only
+     * the requested region.
+     */
+    virtual QImage renderPageRegionToImage(int pageIndex, qreal dpi, const QRect& region) const {
+        const QImage full = renderPageToImage(pageIndex, dpi);
+        const QRect clipped = region.intersected(full.rect());
+        return clipped.isEmpty() ? QImage() : full.copy(clipped);
+    }
+    
     // ===== Image Region Detection (for dark-mode inversion masking) =====
 
     /**
@@ -257,7 +276,19 @@ public:
      * @return True if textBoxes() returns useful data.
      */
     virtual bool supportsTextExtraction() const = 0;
-    
+
+    /**
+     * @brief Extract the text of pages in the background ahead of use.
+     * @param pageIndices 0-based page indices, most wanted first.
+     *
+     * A hint from the viewport's preload pass: later textBoxes() calls for
+     * these pages are served from the provider's text cache. Replaces any
+     * earlier request that has not started yet. Default does nothing.
+     */
+    virtual void prefetchTextBoxes(const QVector<int>& pageIndices) const {
+        Q_UNUSED(pageIndices);
+    }
+
     // ===== Links =====
     
     /**
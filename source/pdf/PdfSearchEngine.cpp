@@ -1,5 +1,6 @@
 #include "PdfSearchEngine.h"
 #include "PdfProvider.h"
+#include "PdfSearchIndex.h"
 #include "../core/Document.h"
 #include "../core/Page.h"
 #include "../ocr/OcrTextBlock.h"
@@ -16,12 +17,116 @@
 #include <QAbstractTextDocumentLayout>
 #include <QtConcurrent/QtConcurrent>
 
+namespace {
+
+/**
+ * OCR blocks joined into one searchable string. CJK scripts don't use
+ * inter-word spaces, so a space separator is only inserted when the trailing
+ * char of the previous block AND the leading char of the current block are
+ * both non-CJK. Range definitions are shared via isCjkLikeChar() in
+ * OcrTextBlock.h. Separators map to block -1.
+ */
+QString ocrSearchText(const QVector<OcrTextBlock>& blocks,
+                      QVector<int>* charToBlockIndex,
+                      QVector<int>* charToBlockOffset)
+{
+    QString fullText;
+    QChar prevTrailingChar;
+    bool hasPrev = false;
+
+    for (int b = 0; b < blocks.size(); ++b) {
+        const OcrTextBlock& block = blocks[b];
+        if (block.dirty || block.text.isEmpty()) continue;
+
+        if (hasPrev) {
+            QChar leadChar = block.text.at(0);
+            bool needsSpace = !isCjkLikeChar(prevTrailingChar) && !isCjkLikeChar(leadChar);
+            if (needsSpace) {
+                fullText += ' ';
+                if (charToBlockIndex) charToBlockIndex->append(-1);
+                if (charToBlockOffset) charToBlockOffset->append(-1);
+            }
+        }
+
+        fullText += block.text;
+        for (int c = 0; c < block.text.length(); ++c) {
+            if (charToBlockIndex) charToBlockIndex->append(b);
+            if (charToBlockOffset) charToBlockOffset->append(c);
+        }
+        prevTrailingChar = block.text.at(block.text.length() - 1);
+        hasPrev = true;
+    }
+    return fullText;
+}
+
+/**
+ * Everything searchPage() matches on a page besides its PDF text: the OCR
+ * text, then each text box / locked OCR object on its own line. Markdown
+ * boxes contribute their rendered text, which is what QTextDocument::find()
+ * searches.
+ */
+QString annotationSearchText(const Page* page)
+{
+    QString text;
+    if (!page->ocrTextBlocks.isEmpty()) {
+        text = ocrSearchText(page->ocrBlocksForSearch(), nullptr, nullptr);
+    }
+
+    for (const auto& objPtr : page->objects) {
+        if (!objPtr) continue;
+        const InsertedObject* rawObj = objPtr.get();
+
+        const TextBoxObject* textBox = nullptr;
+        if (rawObj->type() == QLatin1String("textbox")) {
+            textBox = static_cast<const TextBoxObject*>(rawObj);
+        } else if (rawObj->type() == QLatin1String("ocr_text")) {
+            auto* ocrObj = static_cast<const OcrTextObject*>(rawObj);
+            if (ocrObj->ocrLocked)
+                textBox = ocrObj;
+        }
+        if (!textBox || textBox->text.isEmpty()) continue;
+
+        text += '\n';
+        if (textBox->isMarkdown()) {
+            QTextDocument tmpDoc;
+            tmpDoc.setMarkdown(textBox->text);
+            text += tmpDoc.toRawText();
+        } else {
+            text += textBox->text;
+        }
+    }
+    return text;
+}
+
+/**
+ * Extract the searchable text of page @p pdfPageIdx of PDF source @p srcId.
+ * Returns false when the source cannot be read (yet).
+ */
+bool extractPdfPageText(const Document* doc, const QString& srcId, int pdfPageIdx,
+                        PdfSearchIndex::PdfPageText& out)
+{
+    // Provider is pre-opened on the main thread (ensureAllPdfProvidersLoaded);
+    // here we only read the cached provider from the worker thread.
+    const PdfProvider* pdf = doc->providerForSource(srcId);
+    // Translate the original page number to the provider's index (bundled sources
+    // remap into a compact mini-PDF via pageMap).
+    const int providerPage = doc->resolveSourcePageIndex(srcId, pdfPageIdx);
+    if (!pdf || !pdf->supportsTextExtraction() || providerPage < 0) {
+        return false;
+    }
+    out = PdfSearchIndex::buildPdfPageText(pdf->textBoxes(providerPage));
+    return true;
+}
+
+} // namespace
+
 // ============================================================================
 // Constructor / Destructor
 // ============================================================================
 
 PdfSearchEngine::PdfSearchEngine(QObject *parent)
     : QObject(parent)
+    , m_index(std::make_unique<PdfSearchIndex>())
 {
     // SBS2: pageScanned is emitted from a worker thread, so its arguments must
     // be registered metatypes for the queued cross-thread connection.
@@ -38,9 +143,12 @@ PdfSearchEngine::~PdfSearchEngine()
 {
     cancel();
     m_scanCancelled.store(true);
+    m_indexCancelled.store(true);
     m_searchWatcher.waitForFinished();
     m_precacheWatcher.waitForFinished();
     m_scanWatcher.waitForFinished();
+    m_indexWatcher.waitForFinished();
+    m_index->flush();
 }
 
 void PdfSearchEngine::setDocument(Document *doc)
@@ -49,9 +157,21 @@ void PdfSearchEngine::setDocument(Document *doc)
         // Cancel any ongoing operations before changing document
         cancel();
         m_scanCancelled.store(true);
+        m_indexCancelled.store(true);
         m_searchWatcher.waitForFinished();
         m_precacheWatcher.waitForFinished();
         m_scanWatcher.waitForFinished();
+        m_indexWatcher.waitForFinished();
+        
+        // Keep what was indexed of the previous document; the next build
+        // opens the new document's index.
+        m_index->flush();
+        m_index->clear();
+        m_indexOpened.store(false);
+        {
+            QMutexLocker lock(&m_pagesMutex);
+            m_pageSnapshots.clear();
+        }
         
         m_document = doc;
         clearCache();
@@ -69,6 +189,7 @@ void PdfSearchEngine::setDocument(Document *doc)
         m_searchCancelled.store(false);
         m_precacheCancelled.store(false);
         m_scanCancelled.store(false);
+        m_indexCancelled.store(false);
     }
 }
 
@@ -153,121 +274,48 @@ QVector<PdfSearchMatch> PdfSearchEngine::searchPage(int pageIndex,
         return matches;
     }
     
-    // --- PDF text search (existing logic) ---
+    // The index rules pages out without touching MuPDF or loading the page.
+    // Pages it does not cover (yet) are searched directly.
+    PageSnapshot snap;
+    const bool indexed = pageSnapshot(pageIndex, snap);
+    const PdfSearchIndex::Query query = PdfSearchIndex::prepareQuery(text);
+    
+    // --- PDF text search ---
     // pageIndex is a notebook page index; resolve it to its own PDF source + page
     // number so that pages backed by ANY source (not just primary) are searchable.
-    QString srcId;
-    int pdfPageIdx = -1;
-    if (m_document->pdfBindingForNotebookPage(pageIndex, srcId, pdfPageIdx)) {
-        // Provider is pre-opened on the main thread (ensureAllPdfProvidersLoaded);
-        // here we only read the cached provider from the worker thread.
-        const PdfProvider* pdf = m_document->providerForSource(srcId);
-        // Translate the original page number to the provider's index (bundled sources
-        // remap into a compact mini-PDF via pageMap).
-        const int providerPage = m_document->resolveSourcePageIndex(srcId, pdfPageIdx);
-        QVector<PdfTextBox> textBoxes = (pdf && pdf->supportsTextExtraction() && providerPage >= 0)
-            ? pdf->textBoxes(providerPage) : QVector<PdfTextBox>();
-        if (!textBoxes.isEmpty()) {
-            QString pageText;
-            QVector<QPair<int, int>> boxMapping;
-            
-            for (int i = 0; i < textBoxes.size(); ++i) {
-                pageText += textBoxes[i].text;
-                
-                for (int j = 0; j < textBoxes[i].text.length(); ++j) {
-                    boxMapping.append({i, j});
-                }
-                
-                // CJK-aware synthetic separator: MuPdfProvider emits one
-                // PdfTextBox per CJK glyph, so blindly inserting a space
-                // between every adjacent box pair would break multi-char
-                // CJK searches (e.g. searching "中文" against a pageText
-                // that became "中 文"). Mirrors the same predicate used by
-                // searchOcrBlocks() below.
-                if (i < textBoxes.size() - 1 && !pageText.endsWith(' ')) {
-                    QChar prevTrailing = textBoxes[i].text.isEmpty()
-                        ? QChar() : textBoxes[i].text.back();
-                    QChar nextLeading  = textBoxes[i + 1].text.isEmpty()
-                        ? QChar() : textBoxes[i + 1].text.front();
-                    bool needsSpace = !isCjkLikeChar(prevTrailing)
-                                   && !isCjkLikeChar(nextLeading);
-                    if (needsSpace) {
-                        pageText += ' ';
-                        boxMapping.append({-1, -1});
-                    }
-                }
-            }
-            
-            Qt::CaseSensitivity cs = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
-            
-            int searchPos = 0;
-            int matchIndex = 0;
-            
-            while (searchPos < pageText.length()) {
-                int foundPos = static_cast<int>(pageText.indexOf(text, searchPos, cs));
-                if (foundPos < 0) {
-                    break;
-                }
-                
-                if (wholeWord) {
-                    if (foundPos > 0) {
-                        QChar before = pageText[foundPos - 1];
-                        if (before.isLetterOrNumber() || before == '_') {
-                            searchPos = foundPos + 1;
-                            continue;
-                        }
-                    }
-                    int endPos = foundPos + static_cast<int>(text.length());
-                    if (endPos < pageText.length()) {
-                        QChar after = pageText[endPos];
-                        if (after.isLetterOrNumber() || after == '_') {
-                            searchPos = foundPos + 1;
-                            continue;
-                        }
-                    }
-                }
-                
-                QRectF matchRect;
-                for (int i = foundPos; i < foundPos + text.length(); ++i) {
-                    if (i >= boxMapping.size()) break;
-                    
-                    int boxIdx = boxMapping[i].first;
-                    int charIdx = boxMapping[i].second;
-                    
-                    if (boxIdx < 0) continue;
-                    
-                    const PdfTextBox& box = textBoxes[boxIdx];
-                    
-                    if (charIdx >= 0 && charIdx < box.charBoundingBoxes.size()) {
-                        if (matchRect.isNull()) {
-                            matchRect = box.charBoundingBoxes[charIdx];
-                        } else {
-                            matchRect = matchRect.united(box.charBoundingBoxes[charIdx]);
-                        }
-                    } else {
-                        if (matchRect.isNull()) {
-                            matchRect = box.boundingBox;
-                        } else {
-                            matchRect = matchRect.united(box.boundingBox);
-                        }
-                    }
-                }
-                
-                if (!matchRect.isNull()) {
-                    PdfSearchMatch match;
-                    match.source = PdfSearchMatch::PdfText;
-                    match.pageIndex = pageIndex;
-                    match.matchIndex = matchIndex++;
-                    match.boundingRect = matchRect;
-                    matches.append(match);
-                }
-                
-                searchPos = foundPos + 1;
-            }
+    QString srcId = snap.pdfSourceId;
+    int pdfPageIdx = snap.pdfPage;
+    const bool hasPdf = indexed
+        ? pdfPageIdx >= 0
+        : m_document->pdfBindingForNotebookPage(pageIndex, srcId, pdfPageIdx);
+    
+    if (hasPdf && snap.pdfKey.isEmpty()) {
+        PdfSearchIndex::PdfPageText pageText;
+        if (extractPdfPageText(m_document, srcId, pdfPageIdx, pageText)) {
+            matches = PdfSearchIndex::matchPdfPageText(pageText, pageIndex, text,
+                                                       caseSensitive, wholeWord);
         }
+    } else if (hasPdf && m_index->mayContain(snap.pdfKey, query)) {
+        PdfSearchIndex::PdfPageText pageText;
+        if (!m_index->pdfPage(snap.pdfKey, pageText)
+            && extractPdfPageText(m_document, srcId, pdfPageIdx, pageText)) {
+            m_index->insertPdfPage(snap.pdfKey, pageText);
+        }
+        matches = PdfSearchIndex::matchPdfPageText(pageText, pageIndex, text,
+                                                   caseSensitive, wholeWord);
     }
     
     // --- OCR text + TextBox / locked OCR object search (paged mode) ---
+    if (indexed && !snap.dirty) {
+        quint64 stamp = 0;
+        quint64 verifiedEpoch = PdfSearchIndex::UNVERIFIED;
+        if (m_index->annotationState(snap.annotationKey, stamp, verifiedEpoch)
+            && verifiedEpoch == snap.editEpoch
+            && !m_index->mayContain(snap.annotationKey, query)) {
+            return matches;
+        }
+    }
+    
     if (pageIndex >= 0 && pageIndex < m_document->pageCount()) {
         const Page* page = m_document->page(pageIndex);
         if (page) {
@@ -313,39 +361,9 @@ QVector<PdfSearchMatch> PdfSearchEngine::searchOcrBlocks(
     int matchIndex = matchIndexOffset;
 
     // Build concatenated text with character-to-block mapping.
-    // CJK scripts don't use inter-word spaces, so we only insert a space
-    // separator when the trailing char of the previous block AND the leading
-    // char of the current block are both non-CJK. Range definitions are
-    // shared via isCjkLikeChar() in OcrTextBlock.h.
-
-    QString fullText;
     QVector<int> charToBlockIndex;
     QVector<int> charToBlockOffset;   // position of each char within its block's text
-    QChar prevTrailingChar;
-    bool hasPrev = false;
-
-    for (int b = 0; b < blocks.size(); ++b) {
-        const OcrTextBlock& block = blocks[b];
-        if (block.dirty || block.text.isEmpty()) continue;
-
-        if (hasPrev) {
-            QChar leadChar = block.text.at(0);
-            bool needsSpace = !isCjkLikeChar(prevTrailingChar) && !isCjkLikeChar(leadChar);
-            if (needsSpace) {
-                fullText += ' ';
-                charToBlockIndex.append(-1);
-                charToBlockOffset.append(-1);
-            }
-        }
-
-        fullText += block.text;
-        for (int c = 0; c < block.text.length(); ++c) {
-            charToBlockIndex.append(b);
-            charToBlockOffset.append(c);
-        }
-        prevTrailingChar = block.text.at(block.text.length() - 1);
-        hasPrev = true;
-    }
+    const QString fullText = ocrSearchText(blocks, &charToBlockIndex, &charToBlockOffset);
 
     // Lazily-built per-block flattened char-rect cache (block index -> rects of
     // size block.text.length(), or empty when the block lacks per-char geometry).
@@ -1048,6 +1066,8 @@ void PdfSearchEngine::findNext(const QString& text, bool caseSensitive, bool who
     // (and pre-cache) worker only reads the provider cache; providerForSource()
     // lazily mutates it, which must not race across threads.
     m_document->ensureAllPdfProvidersLoaded();
+    snapshotPages();
+    startIndexing();
 
     // Reset result state
     {
@@ -1104,6 +1124,8 @@ void PdfSearchEngine::findPrev(const QString& text, bool caseSensitive, bool who
 
     // Pre-open every source's provider on the main thread (see findNext()).
     m_document->ensureAllPdfProvidersLoaded();
+    snapshotPages();
+    startIndexing();
 
     // Reset result state
     {
@@ -1162,6 +1184,8 @@ void PdfSearchEngine::scanAllPages(const QString& text, bool caseSensitive, bool
 
     // Pre-open every source's provider on the main thread (see findNext()).
     m_document->ensureAllPdfProvidersLoaded();
+    snapshotPages();
+    startIndexing();
 
     QFuture<void> future = QtConcurrent::run([this]() {
         doScanAll();
@@ -1201,6 +1225,192 @@ void PdfSearchEngine::cancelScan()
     m_scanCancelled.store(true);
 }
 
+// ============================================================================
+// Search Index
+// ============================================================================
+
+void PdfSearchEngine::snapshotPages()
+{
+    QVector<PageSnapshot> pages;
+    if (m_document && !m_document->isEdgeless()) {
+        pages = takePageSnapshots(m_document);
+    }
+
+    QMutexLocker lock(&m_pagesMutex);
+    m_pageSnapshots = std::move(pages);
+}
+
+QVector<PdfSearchEngine::PageSnapshot> PdfSearchEngine::takePageSnapshots(const Document *doc)
+{
+    const int count = doc->pageCount();
+    QVector<PageSnapshot> pages(count);
+    for (int i = 0; i < count; ++i) {
+        PageSnapshot& snap = pages[i];
+        QString srcId;
+        int pdfPage = -1;
+        if (doc->peekPdfBinding(i, srcId, pdfPage)) {
+            snap.pdfSourceId = srcId;
+            snap.pdfPage = pdfPage;
+            // Keyed by content hash: relinking to another file re-indexes,
+            // pages sharing a source share its text.
+            const PdfSource* source = doc->pdfSourceById(srcId);
+            if (source && !source->hash.isEmpty()) {
+                snap.pdfKey = PdfSearchIndex::pdfKey(source->hash, pdfPage);
+            }
+        }
+        snap.annotationKey = PdfSearchIndex::annotationKey(doc->pageUuidAt(i));
+        snap.editEpoch = doc->pageEditEpoch(i);
+        snap.dirty = doc->isPageDirty(i);
+    }
+    return pages;
+}
+
+bool PdfSearchEngine::pageSnapshot(int pageIndex, PageSnapshot& out) const
+{
+    QMutexLocker lock(&m_pagesMutex);
+    if (pageIndex < 0 || pageIndex >= m_pageSnapshots.size()) {
+        return false;
+    }
+    out = m_pageSnapshots[pageIndex];
+    return true;
+}
+
+void PdfSearchEngine::startIndexing()
+{
+    if (!m_document || m_document->isEdgeless() || m_indexWatcher.isRunning()) {
+        return;
+    }
+
+    // Providers must be open before the worker reads them (see findNext()).
+    m_document->ensureAllPdfProvidersLoaded();
+
+    QVector<PageSnapshot> pages;
+    {
+        QMutexLocker lock(&m_pagesMutex);
+        pages = m_pageSnapshots;
+    }
+    if (pages.size() != m_document->pageCount()) {
+        snapshotPages();
+        QMutexLocker lock(&m_pagesMutex);
+        pages = m_pageSnapshots;
+    }
+
+    const QString bundlePath = m_document->bundlePath();
+    const QString indexPath = bundlePath.isEmpty()
+        ? QString() : bundlePath + "/" + PdfSearchIndex::fileName();
+
+    QFuture<void> future = QtConcurrent::run([this, pages, indexPath]() {
+        doBuildIndex(pages, indexPath);
+    });
+    m_indexWatcher.setFuture(future);
+}
+
+void PdfSearchEngine::doBuildIndex(const QVector<PageSnapshot>& pages, const QString& indexPath)
+{
+    if (!m_document) {
+        return;
+    }
+
+    if (!m_indexOpened.load() || m_index->path() != indexPath) {
+        m_index->open(indexPath);
+        m_indexOpened.store(true);
+    }
+
+    buildIndex(m_document, *m_index, pages, m_indexCancelled);
+
+#ifdef SPEEDYNOTE_DEBUG
+    qDebug() << "[PdfSearchEngine] Search index ready:" << m_index->unitCount() << "units";
+#endif
+}
+
+bool PdfSearchEngine::indexDocument(Document *doc, const std::atomic<bool>* cancelled)
+{
+    if (!doc || doc->isEdgeless() || doc->bundlePath().isEmpty()) {
+        return false;
+    }
+    static const std::atomic<bool> notCancelled{false};
+
+    doc->ensureAllPdfProvidersLoaded();
+    PdfSearchIndex index;
+    index.open(doc->bundlePath() + "/" + PdfSearchIndex::fileName());
+    return buildIndex(doc, index, takePageSnapshots(doc), cancelled ? *cancelled : notCancelled);
+}
+
+bool PdfSearchEngine::buildIndex(Document *doc, PdfSearchIndex& index,
+                                 const QVector<PageSnapshot>& pages,
+                                 const std::atomic<bool>& cancelled)
+{
+    // Without a bundle everything lives in memory and the edit epochs alone
+    // tell whether a page changed.
+    const bool onDisk = !index.path().isEmpty();
+    QSet<QString> keys;
+    int sinceFlush = 0;
+
+    for (int i = 0; i < pages.size(); ++i) {
+        if (cancelled.load()) {
+            index.flush();
+            return false;
+        }
+        const PageSnapshot& snap = pages[i];
+        keys.insert(snap.annotationKey);
+
+        // PDF text never changes for a given source hash.
+        if (!snap.pdfKey.isEmpty()) {
+            keys.insert(snap.pdfKey);
+            PdfSearchIndex::PdfPageText pageText;
+            if (!index.contains(snap.pdfKey)
+                && extractPdfPageText(doc, snap.pdfSourceId, snap.pdfPage, pageText)) {
+                index.insertPdfPage(snap.pdfKey, pageText);
+                ++sinceFlush;
+            }
+        }
+
+        // Unsaved pages are searched directly until they are saved.
+        if (snap.dirty) {
+            continue;
+        }
+        quint64 stamp = 0;
+        quint64 verifiedEpoch = PdfSearchIndex::UNVERIFIED;
+        const bool known = index.annotationState(snap.annotationKey, stamp, verifiedEpoch);
+        if (known && verifiedEpoch == snap.editEpoch) {
+            continue;
+        }
+        // Pages may have been inserted or moved since the snapshot.
+        if (PdfSearchIndex::annotationKey(doc->pageUuidAt(i)) != snap.annotationKey) {
+            continue;
+        }
+
+        bool hasStoredText = true;
+        const quint64 current = onDisk ? doc->pageTextStamp(i, &hasStoredText) : 0;
+        if (known && onDisk && stamp == current) {
+            index.verifyAnnotation(snap.annotationKey, snap.editEpoch);
+            continue;
+        }
+
+        // Pristine PDF pages have no text of their own; don't synthesize them.
+        QString text;
+        if (hasStoredText) {
+            // Same lazy load as doPrecache() / searchPage().
+            const Page* page = doc->page(i);
+            if (!page) {
+                continue;
+            }
+            text = annotationSearchText(page);
+        }
+        index.insertAnnotation(snap.annotationKey, current, text, snap.editEpoch);
+
+        if (++sinceFlush >= INDEX_FLUSH_INTERVAL) {
+            index.flush();
+            sinceFlush = 0;
+        }
+    }
+
+    // Drop deleted pages and PDF sources no longer referenced.
+    index.retain(keys);
+    index.flush();
+    return true;
+}
+
 // ============================================================================
 // Cancel
 // ============================================================================
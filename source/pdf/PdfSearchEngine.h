@@ -10,6 +10,8 @@
 // - Caches search results per page for fast navigation
 // - Uses background thread for non-blocking search
 // - Pre-caches nearby pages after finding first result
+// - Skips pages that cannot match using a persistent text index built in the
+//   background (PdfSearchIndex), and reads PDF text and geometry from it
 // ============================================================================
 
 #include <QString>
@@ -21,10 +23,13 @@
 #include <QThread>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <atomic>
+#include <memory>
 #include <utility>
 
 class Document;
 class Page;
+class PdfSearchIndex;
 struct OcrTextBlock;
 
 // ============================================================================
@@ -216,6 +221,27 @@ public:
      */
     int cacheSize() const;
     
+    /**
+     * @brief Build or refresh the search index of the document in the background.
+     * 
+     * Called by findNext(), findPrev() and scanAllPages(). Only pages edited
+     * since they were last indexed are read again, so later calls are cheap.
+     * No-op for edgeless documents and while a build is running. Pages the
+     * index does not cover yet are searched directly.
+     */
+    void startIndexing();
+
+    /**
+     * @brief Build or refresh the bundle's search index on the calling thread.
+     * 
+     * For documents loaded headlessly by their caller (library indexing). The
+     * document must not be shared with other threads while this runs.
+     * @param doc Saved, paged document.
+     * @param cancelled Optional flag polled between pages.
+     * @return false for edgeless or unsaved documents, or if cancelled.
+     */
+    static bool indexDocument(Document *doc, const std::atomic<bool>* cancelled = nullptr);
+    
 signals:
     /**
      * @brief Emitted when a match is found.
@@ -340,6 +366,47 @@ private:
      */
     void buildEdgelessTileOrder();
 
+    /**
+     * @brief Index-relevant state of a notebook page, taken on the main thread.
+     */
+    struct PageSnapshot {
+        QString pdfSourceId;     ///< PDF binding (Document::peekPdfBinding())
+        int pdfPage = -1;        ///< -1 without PDF background
+        QString pdfKey;          ///< PdfSearchIndex::pdfKey(); empty if not indexable
+        QString annotationKey;   ///< PdfSearchIndex::annotationKey()
+        quint64 editEpoch = 0;   ///< Document::pageEditEpoch()
+        bool dirty = false;      ///< Unsaved edits: searched directly, indexed once saved
+    };
+
+    /**
+     * @brief Refresh m_pageSnapshots from the document (main thread).
+     */
+    void snapshotPages();
+
+    /**
+     * @brief Snapshots of all pages of a paged document.
+     */
+    static QVector<PageSnapshot> takePageSnapshots(const Document *doc);
+
+    /**
+     * @brief Snapshot of a page for the search workers.
+     * @return false if the page is not covered by the current snapshot.
+     */
+    bool pageSnapshot(int pageIndex, PageSnapshot& out) const;
+
+    /**
+     * @brief Background thread function that builds the search index.
+     */
+    void doBuildIndex(const QVector<PageSnapshot>& pages, const QString& indexPath);
+
+    /**
+     * @brief Index @p pages of @p doc into @p index and flush it.
+     * @return false if cancelled.
+     */
+    static bool buildIndex(Document *doc, PdfSearchIndex& index,
+                           const QVector<PageSnapshot>& pages,
+                           const std::atomic<bool>& cancelled);
+
     Document *m_document = nullptr;
     std::atomic<bool> m_searchCancelled{false};   ///< Cancellation for main search only
     std::atomic<bool> m_precacheCancelled{false}; ///< Cancellation for pre-cache only
@@ -374,5 +441,14 @@ private:
     // Edgeless search state
     QVector<std::pair<int,int>> m_edgelessTileOrder;
     bool m_edgelessTileOrderBuilt = false;
+
+    // Search index (paged mode)
+    std::unique_ptr<PdfSearchIndex> m_index;
+    std::atomic<bool> m_indexOpened{false};       ///< m_index holds this document's index
+    std::atomic<bool> m_indexCancelled{false};
+    QFutureWatcher<void> m_indexWatcher;
+    mutable QMutex m_pagesMutex;
+    QVector<PageSnapshot> m_pageSnapshots;        ///< Indexed by notebook page
+    static constexpr int INDEX_FLUSH_INTERVAL = 64;  ///< Pages indexed between writes
 };
 
@@ -0,0 +1,767 @@
+// ============================================================================
+// PdfSearchIndex - Implementation
+// ============================================================================
+//
+// Layout (all integers little-endian):
+//
+//   Header   char[4] "SNSI" | u16 version | u16 reserved | u64 reserved
+//   Records  back to back, each:
+//            u32 payloadSize | u32 checksum (low half of the FNV-1a of the
+//            payload) | payload
+//   Payload  QDataStream (Qt 5.12 format):
+//            u8 kind | QString key | u64 stamp
+//            | QByteArray qCompress(text as UTF-16)
+//            | QByteArray qCompress(char rects, single precision)
+//
+// Text and rects are compressed separately so that loading only inflates the
+// texts; the rects of a page are inflated when a search hits it. As in
+// OcrLineCache, a scan stops at the first torn or corrupt record and the next
+// flush() rewrites the file instead of appending behind it.
+// ============================================================================
+
+#include "PdfSearchIndex.h"
+#include "../ocr/OcrTextBlock.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'N', 'S', 'I'};
+constexpr int kHeaderSize = 16;
+constexpr int kRecordHeaderSize = 8;
+
+/// Renumber once retired entries outnumber live ones (and are worth it).
+constexpr int kMinRetiredToRenumber = 64;
+/// Rewrite instead of appending once stale bytes outweigh live ones.
+constexpr qint64 kMinGarbageToRewrite = 256 * 1024;
+
+template <typename T>
+void appendLE(QByteArray& buf, T v)
+{
+    char b[sizeof(T)];
+    qToLittleEndian(v, b);
+    buf.append(b, sizeof(T));
+}
+
+template <typename T>
+T readLE(const uchar* p)
+{
+    return qFromLittleEndian<T>(p);
+}
+
+quint32 payloadChecksum(const char* data, qint64 size)
+{
+    quint64 h = 0xcbf29ce484222325ULL;
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    for (qint64 i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return quint32(h);
+}
+
+QByteArray makeHeader()
+{
+    QByteArray header;
+    header.reserve(kHeaderSize);
+    header.append(kMagic, 4);
+    appendLE<quint16>(header, PdfSearchIndex::FORMAT_VERSION);
+    appendLE<quint16>(header, 0);
+    appendLE<quint64>(header, 0);
+    return header;
+}
+
+void appendRecord(QByteArray& buf, const QByteArray& payload)
+{
+    appendLE<quint32>(buf, quint32(payload.size()));
+    appendLE<quint32>(buf, payloadChecksum(payload.constData(), payload.size()));
+    buf.append(payload);
+}
+
+QByteArray compressRects(const QVector<QRectF>& rects)
+{
+    if (rects.isEmpty())
+        return QByteArray();
+    QByteArray raw;
+    QDataStream out(&raw, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << rects;
+    return qCompress(raw);
+}
+
+bool uncompressRects(const QByteArray& blob, QVector<QRectF>& rects)
+{
+    rects.clear();
+    if (blob.isEmpty())
+        return true;
+    const QByteArray raw = qUncompress(blob);
+    if (raw.isEmpty())
+        return false;
+    QDataStream in(raw);
+    in.setVersion(QDataStream::Qt_5_12);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    in >> rects;
+    return in.status() == QDataStream::Ok;
+}
+
+QByteArray compressText(const QString& text)
+{
+    if (text.isEmpty())
+        return QByteArray();
+    return qCompress(QByteArray(reinterpret_cast<const char*>(text.utf16()),
+                                int(text.size() * sizeof(char16_t))));
+}
+
+bool uncompressText(const QByteArray& blob, QString& text)
+{
+    text.clear();
+    if (blob.isEmpty())
+        return true;
+    const QByteArray raw = qUncompress(blob);
+    if (raw.isEmpty() || raw.size() % int(sizeof(char16_t)) != 0)
+        return false;
+    text = QString(reinterpret_cast<const QChar*>(raw.constData()),
+                   int(raw.size() / int(sizeof(char16_t))));
+    return true;
+}
+
+/// Payload fields in front of the rects; everything load() needs.
+struct RecordHead {
+    quint8 kind = 0;
+    QString key;
+    quint64 stamp = 0;
+    QByteArray textBlob;
+    QByteArray rectsBlob;
+};
+
+bool decodeRecord(const QByteArray& payload, RecordHead& head)
+{
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_5_12);
+    in >> head.kind >> head.key >> head.stamp >> head.textBlob >> head.rectsBlob;
+    return in.status() == QDataStream::Ok && !head.key.isEmpty();
+}
+
+bool hasValidHeader(const QByteArray& contents)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(contents.constData());
+    return contents.size() >= kHeaderSize && std::memcmp(data, kMagic, 4) == 0
+        && readLE<quint16>(data + 4) == PdfSearchIndex::FORMAT_VERSION;
+}
+
+/// Call @p visit(head, payloadOffset, payloadSize) for each intact record of
+/// @p contents (header already checked). Returns the offset the scan stopped at.
+template <typename Visit>
+qint64 scanRecords(const QByteArray& contents, Visit visit)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(contents.constData());
+    const qint64 size = contents.size();
+    qint64 offset = kHeaderSize;
+    while (offset + kRecordHeaderSize <= size) {
+        const quint32 payloadSize = readLE<quint32>(data + offset);
+        const qint64 payloadOffset = offset + kRecordHeaderSize;
+        if (payloadSize > quint64(size - payloadOffset))
+            break;
+        const char* payload = contents.constData() + payloadOffset;
+        if (payloadChecksum(payload, payloadSize) != readLE<quint32>(data + offset + 4))
+            break;
+
+        RecordHead head;
+        if (decodeRecord(QByteArray::fromRawData(payload, int(payloadSize)), head))
+            visit(head, payloadOffset, payloadSize);
+        offset = payloadOffset + payloadSize;
+    }
+    return offset;
+}
+
+/// Case-folded code unit; 0 for surrogates (no trigram spans them).
+inline char16_t foldUnit(QChar c)
+{
+    if (c.isSurrogate())
+        return 0;
+    return c.toCaseFolded().unicode();
+}
+
+/// Distinct case-folded trigrams of @p text, sorted.
+QVector<quint64> trigramsOf(const QString& text)
+{
+    QVector<quint64> out;
+    if (text.size() < 3)
+        return out;
+    out.reserve(text.size() - 2);
+    char16_t a = foldUnit(text.at(0));
+    char16_t b = foldUnit(text.at(1));
+    for (int i = 2; i < text.size(); ++i) {
+        const char16_t c = foldUnit(text.at(i));
+        if (a && b && c)
+            out.append((quint64(a) << 32) | (quint64(b) << 16) | quint64(c));
+        a = b;
+        b = c;
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+} // namespace
+
+PdfSearchIndex::~PdfSearchIndex()
+{
+    flush();
+}
+
+// ----------------------------------------------------------------------------
+// PDF page text
+// ----------------------------------------------------------------------------
+
+PdfSearchIndex::PdfPageText PdfSearchIndex::buildPdfPageText(const QVector<PdfTextBox>& boxes)
+{
+    PdfPageText page;
+    for (int i = 0; i < boxes.size(); ++i) {
+        const PdfTextBox& box = boxes[i];
+        page.text += box.text;
+        for (int j = 0; j < box.text.length(); ++j) {
+            page.charRects.append(j < box.charBoundingBoxes.size()
+                                  ? box.charBoundingBoxes[j] : box.boundingBox);
+        }
+
+        // CJK-aware synthetic separator: MuPdfProvider emits one PdfTextBox
+        // per CJK glyph, so blindly inserting a space between every adjacent
+        // box pair would break multi-char CJK searches (e.g. searching "中文"
+        // against a page text that became "中 文"). Mirrors the predicate of
+        // PdfSearchEngine::searchOcrBlocks().
+        if (i < boxes.size() - 1 && !page.text.endsWith(' ')) {
+            const QChar prevTrailing = box.text.isEmpty() ? QChar() : box.text.back();
+            const QChar nextLeading = boxes[i + 1].text.isEmpty()
+                ? QChar() : boxes[i + 1].text.front();
+            if (!isCjkLikeChar(prevTrailing) && !isCjkLikeChar(nextLeading)) {
+                page.text += ' ';
+                page.charRects.append(QRectF());
+            }
+        }
+    }
+    return page;
+}
+
+QVector<PdfSearchMatch> PdfSearchIndex::matchPdfPageText(const PdfPageText& page, int pageIndex,
+                                                         const QString& text, bool caseSensitive,
+                                                         bool wholeWord)
+{
+    QVector<PdfSearchMatch> matches;
+    if (text.isEmpty())
+        return matches;
+
+    const QString& pageText = page.text;
+    const Qt::CaseSensitivity cs = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    int searchPos = 0;
+    int matchIndex = 0;
+
+    while (searchPos < pageText.length()) {
+        const int foundPos = static_cast<int>(pageText.indexOf(text, searchPos, cs));
+        if (foundPos < 0)
+            break;
+        searchPos = foundPos + 1;
+
+        if (wholeWord) {
+            if (foundPos > 0) {
+                const QChar before = pageText[foundPos - 1];
+                if (before.isLetterOrNumber() || before == '_')
+                    continue;
+            }
+            const int endPos = foundPos + static_cast<int>(text.length());
+            if (endPos < pageText.length()) {
+                const QChar after = pageText[endPos];
+                if (after.isLetterOrNumber() || after == '_')
+                    continue;
+            }
+        }
+
+        // Separators carry a null rect, which united() skips.
+        QRectF matchRect;
+        const int end = qMin(foundPos + static_cast<int>(text.length()),
+                             static_cast<int>(page.charRects.size()));
+        for (int i = foundPos; i < end; ++i) {
+            const QRectF& r = page.charRects[i];
+            if (!r.isNull())
+                matchRect = matchRect.isNull() ? r : matchRect.united(r);
+        }
+
+        if (!matchRect.isNull()) {
+            PdfSearchMatch match;
+            match.source = PdfSearchMatch::PdfText;
+            match.pageIndex = pageIndex;
+            match.matchIndex = matchIndex++;
+            match.boundingRect = matchRect;
+            matches.append(match);
+        }
+    }
+    return matches;
+}
+
+QString PdfSearchIndex::pdfKey(const QString& sourceHash, int pdfPage)
+{
+    return QStringLiteral("pdf:%1#%2").arg(sourceHash).arg(pdfPage);
+}
+
+bool PdfSearchIndex::pdfPage(const QString& key, PdfPageText& out) const
+{
+    QReadLocker lock(&m_lock);
+    const int id = m_idByKey.value(key, -1);
+    if (id < 0 || m_units[id].kind != Kind::PdfPage)
+        return false;
+    const Unit& unit = m_units[id];
+    out.text = unit.text;
+    if (unit.payloadOffset < 0) {
+        out.charRects = unit.charRects;
+        return true;
+    }
+    return readCharRectsLocked(unit, out.charRects);
+}
+
+void PdfSearchIndex::insertPdfPage(const QString& key, const PdfPageText& page)
+{
+    Unit unit;
+    unit.kind = Kind::PdfPage;
+    unit.key = key;
+    unit.text = page.text;
+    unit.charRects = page.charRects;
+
+    QWriteLocker lock(&m_lock);
+    insertLocked(std::move(unit), true);
+}
+
+// ----------------------------------------------------------------------------
+// Annotations
+// ----------------------------------------------------------------------------
+
+QString PdfSearchIndex::annotationKey(const QString& pageUuid)
+{
+    return QStringLiteral("page:") + pageUuid;
+}
+
+bool PdfSearchIndex::annotationState(const QString& key, quint64& stamp,
+                                     quint64& verifiedEpoch) const
+{
+    QReadLocker lock(&m_lock);
+    const int id = m_idByKey.value(key, -1);
+    if (id < 0 || m_units[id].kind != Kind::Annotation)
+        return false;
+    stamp = m_units[id].stamp;
+    verifiedEpoch = m_units[id].verifiedEpoch;
+    return true;
+}
+
+void PdfSearchIndex::insertAnnotation(const QString& key, quint64 stamp, const QString& text,
+                                      quint64 verifiedEpoch)
+{
+    Unit unit;
+    unit.kind = Kind::Annotation;
+    unit.key = key;
+    unit.stamp = stamp;
+    unit.text = text;
+    unit.verifiedEpoch = verifiedEpoch;
+
+    QWriteLocker lock(&m_lock);
+    insertLocked(std::move(unit), true);
+}
+
+void PdfSearchIndex::verifyAnnotation(const QString& key, quint64 verifiedEpoch)
+{
+    QWriteLocker lock(&m_lock);
+    const int id = m_idByKey.value(key, -1);
+    if (id >= 0)
+        m_units[id].verifiedEpoch = verifiedEpoch;
+}
+
+bool PdfSearchIndex::contains(const QString& key) const
+{
+    QReadLocker lock(&m_lock);
+    return m_idByKey.contains(key);
+}
+
+// ----------------------------------------------------------------------------
+// Queries
+// ----------------------------------------------------------------------------
+
+QVector<quint64> PdfSearchIndex::trigrams(const QString& text)
+{
+    return trigramsOf(text);
+}
+
+PdfSearchIndex::Query PdfSearchIndex::prepareQuery(const QString& text)
+{
+    Query query;
+    query.text = text;
+    query.trigrams = trigramsOf(text);
+    return query;
+}
+
+bool PdfSearchIndex::mayContain(const QString& key, const Query& query) const
+{
+    if (query.text.isEmpty())
+        return true;
+
+    QReadLocker lock(&m_lock);
+    const int id = m_idByKey.value(key, -1);
+    if (id < 0)
+        return true;
+
+    for (quint64 trigram : query.trigrams) {
+        auto it = m_postings.constFind(trigram);
+        if (it == m_postings.constEnd() || !std::binary_search(it->cbegin(), it->cend(), id))
+            return false;
+    }
+    // The postings only prove that every trigram occurs somewhere; the text
+    // at hand settles it (and covers queries too short for trigrams).
+    return m_units[id].text.contains(query.text, Qt::CaseInsensitive);
+}
+
+// ----------------------------------------------------------------------------
+// Units and postings
+// ----------------------------------------------------------------------------
+
+void PdfSearchIndex::insertLocked(Unit unit, bool pending)
+{
+    const int previous = m_idByKey.value(unit.key, -1);
+    if (previous >= 0)
+        retireLocked(previous);
+
+    const int id = m_units.size();
+    for (quint64 trigram : trigramsOf(unit.text))
+        m_postings[trigram].append(id);
+    m_idByKey.insert(unit.key, id);
+    if (pending)
+        m_pending.append(id);
+    else
+        m_liveBytes += kRecordHeaderSize + unit.payloadSize;
+    m_units.append(std::move(unit));
+
+    if (m_retired >= kMinRetiredToRenumber && m_retired > m_idByKey.size())
+        renumberLocked();
+}
+
+void PdfSearchIndex::retireLocked(int id)
+{
+    Unit& unit = m_units[id];
+    if (!unit.live)
+        return;
+    if (unit.payloadOffset >= 0)
+        m_liveBytes -= kRecordHeaderSize + unit.payloadSize;
+    if (m_idByKey.value(unit.key, -1) == id)
+        m_idByKey.remove(unit.key);
+    unit.live = false;
+    unit.text.clear();
+    unit.charRects.clear();
+    ++m_retired;
+}
+
+void PdfSearchIndex::renumberLocked()
+{
+    QVector<int> newId(m_units.size(), -1);
+    QVector<Unit> units;
+    units.reserve(m_idByKey.size());
+    for (int id = 0; id < m_units.size(); ++id) {
+        if (!m_units[id].live)
+            continue;
+        newId[id] = units.size();
+        units.append(std::move(m_units[id]));
+    }
+    m_units = std::move(units);
+    m_retired = 0;
+
+    m_idByKey.clear();
+    m_postings.clear();
+    for (int id = 0; id < m_units.size(); ++id) {
+        m_idByKey.insert(m_units[id].key, id);
+        for (quint64 trigram : trigramsOf(m_units[id].text))
+            m_postings[trigram].append(id);
+    }
+
+    QVector<int> pending;
+    for (int id : std::as_const(m_pending)) {
+        if (newId[id] >= 0)
+            pending.append(newId[id]);
+    }
+    m_pending = std::move(pending);
+}
+
+void PdfSearchIndex::retain(const QSet<QString>& keys)
+{
+    QWriteLocker lock(&m_lock);
+    QVector<int> dropped;
+    for (auto it = m_idByKey.constBegin(); it != m_idByKey.constEnd(); ++it) {
+        if (!keys.contains(it.key()))
+            dropped.append(it.value());
+    }
+    for (int id : std::as_const(dropped))
+        retireLocked(id);
+    if (!dropped.isEmpty()) {
+        // Appending cannot remove records; the next flush() rewrites.
+        m_needsRewrite = true;
+        if (m_retired >= kMinRetiredToRenumber && m_retired > m_idByKey.size())
+            renumberLocked();
+    }
+}
+
+void PdfSearchIndex::clear()
+{
+    QWriteLocker lock(&m_lock);
+    m_path.clear();
+    m_units.clear();
+    m_idByKey.clear();
+    m_postings.clear();
+    m_pending.clear();
+    m_retired = 0;
+    m_fileSize = 0;
+    m_liveBytes = 0;
+    m_intact = false;
+    m_needsRewrite = false;
+    m_writeFailed = false;
+}
+
+QString PdfSearchIndex::path() const
+{
+    QReadLocker lock(&m_lock);
+    return m_path;
+}
+
+int PdfSearchIndex::unitCount() const
+{
+    QReadLocker lock(&m_lock);
+    return m_idByKey.size();
+}
+
+// ----------------------------------------------------------------------------
+// Reading
+// ----------------------------------------------------------------------------
+
+bool PdfSearchIndex::open(const QString& path)
+{
+    clear();
+    QWriteLocker lock(&m_lock);
+    m_path = path;
+    if (path.isEmpty())
+        return true;
+    return loadLocked();
+}
+
+bool PdfSearchIndex::loadLocked()
+{
+    QFile file(m_path);
+    if (!file.exists())
+        return true;
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray contents = file.readAll();
+    file.close();
+
+    const qint64 size = contents.size();
+    if (!hasValidHeader(contents))
+        return false; // foreign or older file; rewritten by the next flush()
+    m_fileSize = size;
+
+    const qint64 end = scanRecords(contents, [this](const RecordHead& head, qint64 payloadOffset,
+                                                    quint32 payloadSize) {
+        Unit unit;
+        if ((head.kind == quint8(Kind::PdfPage) || head.kind == quint8(Kind::Annotation))
+            && uncompressText(head.textBlob, unit.text)) {
+            unit.kind = Kind(head.kind);
+            unit.key = head.key;
+            unit.stamp = head.stamp;
+            unit.payloadOffset = payloadOffset;
+            unit.payloadSize = payloadSize;
+            insertLocked(std::move(unit), false);
+        }
+    });
+    m_intact = (end == size);
+    return true;
+}
+
+bool PdfSearchIndex::readTexts(const QString& path, QStringList& texts)
+{
+    texts.clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray contents = file.readAll();
+    file.close();
+    if (!hasValidHeader(contents))
+        return false;
+
+    // Later records of a key replace earlier ones.
+    QHash<QString, int> slotOfKey;
+    scanRecords(contents, [&](const RecordHead& head, qint64, quint32) {
+        QString text;
+        if (!uncompressText(head.textBlob, text))
+            return;
+        const int at = slotOfKey.value(head.key, -1);
+        if (at >= 0) {
+            texts[at] = text;
+        } else {
+            slotOfKey.insert(head.key, texts.size());
+            texts.append(text);
+        }
+    });
+    return true;
+}
+
+bool PdfSearchIndex::readCharRectsLocked(const Unit& unit, QVector<QRectF>& out) const
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(unit.payloadOffset))
+        return false;
+    const QByteArray payload = file.read(unit.payloadSize);
+    if (payload.size() != int(unit.payloadSize))
+        return false;
+
+    // The file may have been replaced by another instance since we read it.
+    RecordHead head;
+    return decodeRecord(payload, head) && head.key == unit.key
+        && uncompressRects(head.rectsBlob, out);
+}
+
+// ----------------------------------------------------------------------------
+// Writing
+// ----------------------------------------------------------------------------
+
+bool PdfSearchIndex::flush()
+{
+    QWriteLocker lock(&m_lock);
+    if (m_path.isEmpty()) {
+        m_pending.clear();
+        return true;
+    }
+    if (m_writeFailed)
+        return false;
+    if (m_pending.isEmpty() && !m_needsRewrite)
+        return true;
+
+    const qint64 garbage = m_fileSize - kHeaderSize - m_liveBytes;
+    const bool canAppend = m_intact && !m_needsRewrite
+                        && (garbage < kMinGarbageToRewrite || garbage <= m_liveBytes)
+                        && QFileInfo(m_path).size() == m_fileSize;
+    if (!canAppend)
+        return rewriteLocked();
+
+    QByteArray tail;
+    QVector<QPair<int, QByteArray>> written;
+    for (int id : std::as_const(m_pending)) {
+        const Unit& unit = m_units[id];
+        if (!unit.live)
+            continue;
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_12);
+        out << quint8(unit.kind) << unit.key << unit.stamp << compressText(unit.text)
+            << compressRects(unit.charRects);
+        appendRecord(tail, payload);
+        written.append({id, payload});
+    }
+    m_pending.clear();
+
+    QFile file(m_path);
+    const bool ok = file.open(QIODevice::ReadWrite) && file.seek(m_fileSize)
+                 && file.write(tail) == tail.size();
+    file.close();
+    if (!ok) {
+        // Units stay searchable in memory. A partial write leaves a torn
+        // tail, which the next open() stops at.
+        m_intact = false;
+        m_writeFailed = true;
+        return false;
+    }
+
+    qint64 offset = m_fileSize;
+    for (const auto& w : std::as_const(written)) {
+        Unit& unit = m_units[w.first];
+        unit.payloadOffset = offset + kRecordHeaderSize;
+        unit.payloadSize = quint32(w.second.size());
+        unit.charRects.clear();
+        m_liveBytes += kRecordHeaderSize + unit.payloadSize;
+        offset = unit.payloadOffset + unit.payloadSize;
+    }
+    m_fileSize = offset;
+    return true;
+}
+
+bool PdfSearchIndex::rewriteLocked()
+{
+    // Records already on disk are copied over unchanged.
+    QByteArray old;
+    {
+        QFile file(m_path);
+        if (file.open(QIODevice::ReadOnly))
+            old = file.readAll();
+    }
+
+    QByteArray contents = makeHeader();
+    QVector<QPair<int, quint32>> placed; // (id, payload size)
+    QVector<int> lost;
+    for (int id = 0; id < m_units.size(); ++id) {
+        const Unit& unit = m_units[id];
+        if (!unit.live)
+            continue;
+        QByteArray payload;
+        if (unit.payloadOffset >= 0) {
+            if (quint64(unit.payloadOffset) + unit.payloadSize > quint64(old.size())) {
+                lost.append(id);
+                continue;
+            }
+            payload = old.mid(int(unit.payloadOffset), int(unit.payloadSize));
+            RecordHead head;
+            if (!decodeRecord(payload, head) || head.key != unit.key) {
+                lost.append(id); // replaced behind our back
+                continue;
+            }
+        } else {
+            QDataStream out(&payload, QIODevice::WriteOnly);
+            out.setVersion(QDataStream::Qt_5_12);
+            out << quint8(unit.kind) << unit.key << unit.stamp << compressText(unit.text)
+                << compressRects(unit.charRects);
+        }
+        appendRecord(contents, payload);
+        placed.append({id, quint32(payload.size())});
+    }
+    for (int id : std::as_const(lost))
+        retireLocked(id);
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile file(m_path);
+    bool ok = file.open(QIODevice::WriteOnly);
+    if (ok && file.write(contents) != contents.size()) {
+        file.cancelWriting();
+        ok = false;
+    }
+    ok = ok && file.commit();
+    m_pending.clear();
+    if (!ok) {
+        // Nothing on disk moved. Units stay searchable in memory; those that
+        // never made it to disk are simply rebuilt next session.
+        m_writeFailed = true;
+        return false;
+    }
+
+    qint64 offset = kHeaderSize;
+    m_liveBytes = 0;
+    for (const auto& p : std::as_const(placed)) {
+        Unit& unit = m_units[p.first];
+        unit.payloadOffset = offset + kRecordHeaderSize;
+        unit.payloadSize = p.second;
+        unit.charRects.clear();
+        m_liveBytes += kRecordHeaderSize + unit.payloadSize;
+        offset = unit.payloadOffset + unit.payloadSize;
+    }
+    m_fileSize = offset;
+    m_intact = true;
+    m_needsRewrite = false;
+    return true;
+}
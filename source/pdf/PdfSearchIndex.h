@@ -0,0 +1,205 @@
+#pragma once
+
+// ============================================================================
+// PdfSearchIndex - Persistent full-text index behind PdfSearchEngine
+// ============================================================================
+// Every query used to extract text again: PdfProvider::textBoxes() for each
+// PDF page, plus the OCR blocks and text boxes of each notebook page. On long
+// reference PDFs a find-all spent seconds in MuPDF before matching anything.
+//
+// The index keeps, per "unit":
+// - a PDF page (keyed by source hash + PDF page number): the page text laid
+//   out exactly as the search engine joins text boxes, with one highlight
+//   rect per character, so PDF matches and their rects come straight from
+//   the index;
+// - a notebook page's annotations (keyed by page uuid): the OCR and text box
+//   text, used to skip pages that cannot match. Matches on the remaining
+//   pages still come from the live page, so highlight geometry of markdown
+//   text boxes keeps its layout-accurate path.
+//
+// On top of the unit texts sits an inverted index from case-folded character
+// trigrams to the units containing them. A query is answered by intersecting
+// the postings of its trigrams; queries shorter than three characters fall
+// back to a scan of the unit texts. Trigrams give a superset for every search
+// mode (case-sensitive and whole-word matches are case-insensitive substring
+// matches too), so the exact matcher only ever runs on units that can match.
+//
+// search.snsi in the bundle is an append-only log of checksummed unit
+// records with compressed text and geometry; the last record of a key wins.
+// It is rewritten once stale records outweigh live ones. Only texts and
+// postings are kept in memory (rebuilt on load); the character rects of a
+// PDF page are read back from its record when the page has a match. It is a
+// cache: an unreadable file is treated as empty and rebuilt.
+//
+// Thread-safe: the indexer fills it on one thread while searches read it.
+// ============================================================================
+
+#include "PdfProvider.h"
+#include "PdfSearchEngine.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QRectF>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class PdfSearchIndex {
+public:
+    /// File format version stored in the header.
+    static constexpr quint16 FORMAT_VERSION = 1;
+    /// verifiedEpoch of annotation units not yet checked this session.
+    static constexpr quint64 UNVERIFIED = ~quint64(0);
+
+    /// File name inside the bundle directory.
+    static QString fileName() { return QStringLiteral("search.snsi"); }
+
+    PdfSearchIndex() = default;
+    ~PdfSearchIndex();
+
+    PdfSearchIndex(const PdfSearchIndex&) = delete;
+    PdfSearchIndex& operator=(const PdfSearchIndex&) = delete;
+
+    // ===== PDF page text =====
+
+    /**
+     * @brief Searchable text of one PDF page: text boxes joined with a space
+     *        between non-CJK neighbours, one highlight rect per character.
+     *        Inserted separators have a null rect.
+     */
+    struct PdfPageText {
+        QString text;
+        QVector<QRectF> charRects;
+    };
+
+    /// Lay out @p boxes the way PdfSearchEngine searches them.
+    static PdfPageText buildPdfPageText(const QVector<PdfTextBox>& boxes);
+
+    /// All matches of @p text in @p page (PdfSearchMatch::PdfText, numbered
+    /// from 0 in text order).
+    static QVector<PdfSearchMatch> matchPdfPageText(const PdfPageText& page, int pageIndex,
+                                                    const QString& text, bool caseSensitive,
+                                                    bool wholeWord);
+
+    /// Unit key of page @p pdfPage of the PDF with content hash @p sourceHash.
+    static QString pdfKey(const QString& sourceHash, int pdfPage);
+
+    /// Stored text of a PDF page; false if it is not indexed.
+    bool pdfPage(const QString& key, PdfPageText& out) const;
+    void insertPdfPage(const QString& key, const PdfPageText& page);
+
+    // ===== Notebook page annotations =====
+
+    /// Unit key of the OCR/text box text of the page with @p pageUuid.
+    static QString annotationKey(const QString& pageUuid);
+
+    /**
+     * @brief State of an annotation unit.
+     * @param stamp Document::pageTextStamp() the text was taken at.
+     * @param verifiedEpoch Document::pageEditEpoch() at which the text was
+     *        last confirmed current, or UNVERIFIED.
+     * @return false if the page is not indexed.
+     */
+    bool annotationState(const QString& key, quint64& stamp, quint64& verifiedEpoch) const;
+    void insertAnnotation(const QString& key, quint64 stamp, const QString& text,
+                          quint64 verifiedEpoch);
+    /// Confirm an annotation unit as current at @p verifiedEpoch.
+    void verifyAnnotation(const QString& key, quint64 verifiedEpoch);
+
+    /// Whether a unit is stored under @p key.
+    bool contains(const QString& key) const;
+
+    // ===== Queries =====
+
+    /// A query prepared once and tested against many units.
+    struct Query {
+        QString text;
+        QVector<quint64> trigrams; ///< distinct case-folded trigrams
+    };
+    static Query prepareQuery(const QString& text);
+
+    /// Distinct case-folded trigrams of @p text, sorted (the posting keys).
+    static QVector<quint64> trigrams(const QString& text);
+
+    /**
+     * @brief Whether unit @p key may contain @p query (case-insensitively).
+     *        False is definite; true still needs the exact matcher. Units
+     *        that are not indexed return true.
+     */
+    bool mayContain(const QString& key, const Query& query) const;
+
+    // ===== Persistence =====
+
+    /**
+     * @brief Load @p path, replacing the current contents. An empty path
+     *        keeps the index in memory only.
+     * @return false if an existing file could not be read (it is rebuilt).
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief Texts of all units stored in the file at @p path, without
+     *        building an index (library search reads other bundles' files).
+     * @return false if the file is missing or not an index.
+     */
+    static bool readTexts(const QString& path, QStringList& texts);
+
+    /// Write units inserted since the last flush. Returns false on an I/O error.
+    bool flush();
+
+    /// Drop units whose key is not in @p keys (deleted pages, removed PDFs).
+    void retain(const QSet<QString>& keys);
+
+    /// Forget everything and detach from the file (which is left as it is).
+    void clear();
+
+    QString path() const;
+    int unitCount() const;
+
+private:
+    enum class Kind : quint8 { PdfPage = 1, Annotation = 2 };
+
+    struct Unit {
+        Kind kind = Kind::PdfPage;
+        QString key;
+        quint64 stamp = 0;                   ///< Annotation only
+        QString text;
+        QVector<QRectF> charRects;           ///< PdfPage only, until written
+        quint64 verifiedEpoch = UNVERIFIED;  ///< Annotation only; not stored
+        qint64 payloadOffset = -1;           ///< record payload in the file, -1 while pending
+        quint32 payloadSize = 0;
+        bool live = true;                    ///< false once replaced/dropped
+    };
+
+    /// Add @p unit under a fresh id (postings stay sorted) and retire the
+    /// unit it replaces. Caller holds the write lock.
+    void insertLocked(Unit unit, bool pending);
+    /// Retire unit @p id (its postings are dropped by the next renumber).
+    void retireLocked(int id);
+    /// Renumber the live units densely and rebuild the postings.
+    void renumberLocked();
+    /// Rewrite the file from the live units. Caller holds the write lock.
+    bool rewriteLocked();
+
+    /// Load m_path into the (empty) index. Caller holds the write lock.
+    bool loadLocked();
+    /// Character rects of an on-disk unit. Caller holds a lock.
+    bool readCharRectsLocked(const Unit& unit, QVector<QRectF>& out) const;
+
+    mutable QReadWriteLock m_lock;
+    QString m_path;
+
+    QVector<Unit> m_units;                     ///< by id; retired ones emptied
+    QHash<QString, int> m_idByKey;             ///< live units
+    QHash<quint64, QVector<int>> m_postings;   ///< trigram -> ascending unit ids
+    QVector<int> m_pending;                    ///< ids not yet written
+
+    int m_retired = 0;                         ///< retired entries in m_units
+
+    qint64 m_fileSize = 0;                     ///< bytes of the file we wrote/read
+    qint64 m_liveBytes = 0;                    ///< record bytes of live units on disk
+    bool m_intact = false;                     ///< header valid, no torn tail
+    bool m_needsRewrite = false;               ///< units dropped since the last write
+    bool m_writeFailed = false;                ///< stop retrying a read-only bundle
+};
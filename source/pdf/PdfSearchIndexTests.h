@@ -0,0 +1,248 @@
+#pragma once
+
+// ============================================================================
+// PdfSearchIndexTests - Tests for the persistent search index
+// ============================================================================
+// Checks that matching against indexed page text gives the same matches as
+// the text boxes it was built from, that the trigram filter never rules out
+// a unit containing the query, and that search.snsi survives a reopen,
+// replacement of units and dropping of stale ones.
+//
+// Run with: speedynote --test-search-index
+// ============================================================================
+
+#include "PdfSearchIndex.h"
+
+#include <QDebug>
+#include <QTemporaryDir>
+
+namespace PdfSearchIndexTests {
+
+/**
+ * @brief Text boxes of a fake PDF page: Latin words, a CJK run (one box per
+ *        glyph, as MuPdfProvider emits them) and a box without char rects.
+ */
+inline QVector<PdfTextBox> sampleBoxes(int page)
+{
+    QVector<PdfTextBox> boxes;
+    auto addBox = [&boxes](const QString& text, qreal x, qreal y, bool charRects) {
+        PdfTextBox box;
+        box.text = text;
+        box.boundingBox = QRectF(x, y, 6.0 * text.size(), 10.0);
+        if (charRects) {
+            for (int i = 0; i < text.size(); ++i)
+                box.charBoundingBoxes.append(QRectF(x + 6.0 * i, y, 6.0, 10.0));
+        }
+        boxes.append(box);
+    };
+    addBox(QStringLiteral("Search"), 10, 10, true);
+    addBox(QStringLiteral("engines"), 60, 10, true);
+    addBox(QStringLiteral("index"), 110, 10, true);
+    addBox(QStringLiteral("page_%1").arg(page), 160, 10, false);
+    addBox(QString(QChar(0x4E2D)), 10, 30, true);
+    addBox(QString(QChar(0x6587)), 16, 30, true);
+    addBox(QStringLiteral("Index"), 30, 30, true);
+    return boxes;
+}
+
+/**
+ * @brief Indexed text reproduces the matches of the text it was built from.
+ */
+inline bool testMatchesFromIndexedText()
+{
+    qDebug() << "=== Test: indexed page text matches ===";
+
+    const PdfSearchIndex::PdfPageText page = PdfSearchIndex::buildPdfPageText(sampleBoxes(3));
+    bool success = true;
+
+    // No separator next to CJK glyphs.
+    if (page.text != QStringLiteral("Search engines index page_3") + QChar(0x4E2D)
+                         + QChar(0x6587) + QStringLiteral("Index")
+        || page.charRects.size() != page.text.size()) {
+        qDebug() << "FAIL: unexpected page text" << page.text;
+        success = false;
+    }
+
+    // "index" appears once as is and once capitalized; "engine" only inside
+    // "engines".
+    const auto ci = PdfSearchIndex::matchPdfPageText(page, 7, QStringLiteral("index"), false, false);
+    const auto cs = PdfSearchIndex::matchPdfPageText(page, 7, QStringLiteral("index"), true, false);
+    const auto ww = PdfSearchIndex::matchPdfPageText(page, 7, QStringLiteral("engine"), false, true);
+    const auto cjk = PdfSearchIndex::matchPdfPageText(
+        page, 7, QString(QChar(0x4E2D)) + QChar(0x6587), false, false);
+    if (ci.size() != 2 || cs.size() != 1 || !ww.isEmpty() || cjk.size() != 1) {
+        qDebug() << "FAIL: match counts" << ci.size() << cs.size() << ww.size() << cjk.size();
+        success = false;
+    }
+    if (!ci.isEmpty() && (ci[0].pageIndex != 7 || ci[0].matchIndex != 0
+                          || ci[0].boundingRect != QRectF(110, 10, 30, 10))) {
+        qDebug() << "FAIL: match rect" << ci[0].boundingRect;
+        success = false;
+    }
+    if (!cjk.isEmpty() && cjk[0].boundingRect != QRectF(10, 30, 12, 10)) {
+        qDebug() << "FAIL: CJK match rect" << cjk[0].boundingRect;
+        success = false;
+    }
+
+    // A box without char rects highlights as a whole.
+    const auto whole = PdfSearchIndex::matchPdfPageText(page, 7, QStringLiteral("page"), false, false);
+    if (whole.size() != 1 || whole[0].boundingRect != QRectF(160, 10, 36, 10)) {
+        qDebug() << "FAIL: box fallback rect";
+        success = false;
+    }
+
+    if (success) {
+        qDebug() << "PASS: indexed page text matches";
+    }
+    return success;
+}
+
+/**
+ * @brief The trigram filter rules out non-matching units only.
+ */
+inline bool testCandidateFilter()
+{
+    qDebug() << "=== Test: trigram filter ===";
+
+    PdfSearchIndex index;
+    index.open(QString());
+    index.insertPdfPage(QStringLiteral("a"), PdfSearchIndex::buildPdfPageText(sampleBoxes(1)));
+    index.insertAnnotation(QStringLiteral("b"), 1, QStringLiteral("Handwritten Notes\nTODO list"), 0);
+
+    struct Case {
+        QString key;
+        QString query;
+        bool expected;
+    };
+    const QVector<Case> cases = {
+        {QStringLiteral("a"), QStringLiteral("ENGINES INDEX"), true},
+        {QStringLiteral("a"), QStringLiteral("engines  index"), false},
+        {QStringLiteral("a"), QStringLiteral("in"), true},
+        {QStringLiteral("a"), QStringLiteral("zz"), false},
+        {QStringLiteral("a"), QString(QChar(0x4E2D)), true},
+        {QStringLiteral("b"), QStringLiteral("notes\ntodo"), true},
+        {QStringLiteral("b"), QStringLiteral("todos"), false},
+        {QStringLiteral("missing"), QStringLiteral("anything"), true},
+    };
+
+    bool success = true;
+    for (const Case& c : cases) {
+        if (index.mayContain(c.key, PdfSearchIndex::prepareQuery(c.query)) != c.expected) {
+            qDebug() << "FAIL:" << c.key << c.query << "expected" << c.expected;
+            success = false;
+        }
+    }
+    if (success) {
+        qDebug() << "PASS: trigram filter";
+    }
+    return success;
+}
+
+/**
+ * @brief Units survive a reopen; replaced and dropped units do not.
+ */
+inline bool testPersistence()
+{
+    qDebug() << "=== Test: search.snsi persistence ===";
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "FAIL: no temporary directory";
+        return false;
+    }
+    const QString path = dir.filePath(PdfSearchIndex::fileName());
+    const PdfSearchIndex::PdfPageText page = PdfSearchIndex::buildPdfPageText(sampleBoxes(2));
+
+    {
+        PdfSearchIndex index;
+        index.open(path);
+        index.insertPdfPage(PdfSearchIndex::pdfKey(QStringLiteral("sha256:x"), 2), page);
+        index.insertAnnotation(PdfSearchIndex::annotationKey(QStringLiteral("p1")), 11,
+                               QStringLiteral("first"), 0);
+        index.insertAnnotation(PdfSearchIndex::annotationKey(QStringLiteral("p2")), 12,
+                               QStringLiteral("gone"), 0);
+        if (!index.flush()) {
+            qDebug() << "FAIL: first flush";
+            return false;
+        }
+        // Appended behind the first records; the last one wins.
+        index.insertAnnotation(PdfSearchIndex::annotationKey(QStringLiteral("p1")), 21,
+                               QStringLiteral("second"), 0);
+        index.flush();
+    }
+
+    bool success = true;
+    {
+        PdfSearchIndex index;
+        if (!index.open(path) || index.unitCount() != 3) {
+            qDebug() << "FAIL: reopen";
+            return false;
+        }
+
+        PdfSearchIndex::PdfPageText stored;
+        if (!index.pdfPage(PdfSearchIndex::pdfKey(QStringLiteral("sha256:x"), 2), stored)
+            || stored.text != page.text || stored.charRects != page.charRects) {
+            qDebug() << "FAIL: PDF page text or geometry lost";
+            success = false;
+        }
+
+        quint64 stamp = 0;
+        quint64 verified = 0;
+        const QString p1 = PdfSearchIndex::annotationKey(QStringLiteral("p1"));
+        if (!index.annotationState(p1, stamp, verified) || stamp != 21
+            || verified != PdfSearchIndex::UNVERIFIED
+            || !index.mayContain(p1, PdfSearchIndex::prepareQuery(QStringLiteral("second")))
+            || index.mayContain(p1, PdfSearchIndex::prepareQuery(QStringLiteral("first")))) {
+            qDebug() << "FAIL: replaced annotation";
+            success = false;
+        }
+
+        index.retain({PdfSearchIndex::pdfKey(QStringLiteral("sha256:x"), 2), p1});
+        index.flush();
+    }
+    {
+        PdfSearchIndex index;
+        index.open(path);
+        if (index.unitCount() != 2
+            || index.contains(PdfSearchIndex::annotationKey(QStringLiteral("p2")))) {
+            qDebug() << "FAIL: dropped unit came back";
+            success = false;
+        }
+    }
+
+    if (success) {
+        qDebug() << "PASS: search.snsi persistence";
+    }
+    return success;
+}
+
+/**
+ * @brief Run all PdfSearchIndex tests.
+ * @return true if all tests pass, false otherwise.
+ */
+inline bool runAllTests()
+{
+    qDebug() << "";
+    qDebug() << "========================================";
+    qDebug() << "   PdfSearchIndex Tests";
+    qDebug() << "========================================";
+
+    bool allPassed = true;
+
+    allPassed &= testMatchesFromIndexedText();
+    allPassed &= testCandidateFilter();
+    allPassed &= testPersistence();
+
+    qDebug() << "";
+    if (allPassed) {
+        qDebug() << "✅ All PdfSearchIndex tests passed!";
+    } else {
+        qDebug() << "❌ Some PdfSearchIndex tests failed!";
+    }
+    qDebug() << "========================================";
+    qDebug() << "";
+
+    return allPassed;
+}
+
+} // namespace PdfSearchIndexTests
@@ -0,0 +1,208 @@
+// ============================================================================
+// PdfTextCache - Byte-budgeted cache of per-page PDF text layouts
+// ============================================================================
+
+#include "PdfTextCache.h"
+
+#include <QMutexLocker>
+
+#include <limits>
+
+namespace {
+
+void appendRect(QVector<float>& rects, const QRectF& r)
+{
+    rects.append(float(r.x()));
+    rects.append(float(r.y()));
+    rects.append(float(r.width()));
+    rects.append(float(r.height()));
+}
+
+void appendRect(QVector<double>& rects, const QRectF& r)
+{
+    rects.append(r.x());
+    rects.append(r.y());
+    rects.append(r.width());
+    rects.append(r.height());
+}
+
+template <typename T>
+QRectF rectAt(const QVector<T>& rects, int i)
+{
+    const T* r = rects.constData() + 4 * i;
+    return QRectF(r[0], r[1], r[2], r[3]);
+}
+
+} // namespace
+
+// ============================================================================
+// Flat layout
+// ============================================================================
+
+qint64 PdfTextCache::PageLayout::bytes() const
+{
+    return qint64(sizeof(PageLayout)) + qint64(text.size()) * qint64(sizeof(QChar))
+         + qint64(textStarts.size() + charStarts.size()) * qint64(sizeof(int))
+         + qint64(boxRects.size()) * qint64(sizeof(double))
+         + qint64(charRects.size()) * qint64(sizeof(float));
+}
+
+PdfTextCache::PageLayout PdfTextCache::pack(const QVector<PdfTextBox>& boxes)
+{
+    PageLayout layout;
+    if (boxes.isEmpty())
+        return layout;
+
+    int textLength = 0;
+    int charCount = 0;
+    for (const PdfTextBox& box : boxes) {
+        textLength += int(box.text.size());
+        charCount += int(box.charBoundingBoxes.size());
+    }
+    layout.text.reserve(textLength);
+    layout.textStarts.reserve(boxes.size() + 1);
+    layout.boxRects.reserve(4 * boxes.size());
+    if (charCount > 0) {
+        layout.charStarts.reserve(boxes.size() + 1);
+        layout.charRects.reserve(4 * charCount);
+    }
+
+    for (const PdfTextBox& box : boxes) {
+        layout.textStarts.append(int(layout.text.size()));
+        layout.text += box.text;
+        appendRect(layout.boxRects, box.boundingBox);
+        if (charCount == 0)
+            continue;
+        layout.charStarts.append(int(layout.charRects.size() / 4));
+        for (const QRectF& r : box.charBoundingBoxes)
+            appendRect(layout.charRects, r);
+    }
+    layout.textStarts.append(int(layout.text.size()));
+    if (charCount > 0)
+        layout.charStarts.append(int(layout.charRects.size() / 4));
+    return layout;
+}
+
+QVector<PdfTextBox> PdfTextCache::unpack(const PageLayout& layout)
+{
+    const int count = layout.boxCount();
+    QVector<PdfTextBox> boxes(count);
+    const bool hasChars = !layout.charStarts.isEmpty();
+    for (int i = 0; i < count; ++i) {
+        PdfTextBox& box = boxes[i];
+        box.text = layout.text.mid(layout.textStarts[i], layout.textStarts[i + 1] - layout.textStarts[i]);
+        box.boundingBox = rectAt(layout.boxRects, i);
+        if (!hasChars)
+            continue;
+        const int from = layout.charStarts[i];
+        const int to = layout.charStarts[i + 1];
+        box.charBoundingBoxes.reserve(to - from);
+        for (int c = from; c < to; ++c)
+            box.charBoundingBoxes.append(rectAt(layout.charRects, c));
+    }
+    return boxes;
+}
+
+// ============================================================================
+// Cache access
+// ============================================================================
+
+PdfTextCache::PdfTextCache(qint64 budgetBytes)
+    : m_budgetBytes(budgetBytes)
+{
+}
+
+bool PdfTextCache::find(int pageIndex, QVector<PdfTextBox>& boxes)
+{
+    std::shared_ptr<const PageLayout> layout;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entries.find(pageIndex);
+        if (it == m_entries.end())
+            return false;
+        it->lastUsed = ++m_useCounter;
+        layout = it->layout;
+    }
+    // Expanding allocates a string and a vector per box; do it unlocked so
+    // concurrent lookups (search thread vs. UI) do not serialize on it.
+    boxes = unpack(*layout);
+    return true;
+}
+
+bool PdfTextCache::contains(int pageIndex) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.contains(pageIndex);
+}
+
+void PdfTextCache::insert(int pageIndex, const QVector<PdfTextBox>& boxes)
+{
+    Entry entry;
+    auto layout = std::make_shared<PageLayout>(pack(boxes));
+    entry.bytes = layout->bytes();
+    entry.layout = std::move(layout);
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(pageIndex);
+    if (it != m_entries.end())
+        m_bytesUsed -= it->bytes;
+    entry.lastUsed = ++m_useCounter;
+    m_bytesUsed += entry.bytes;
+    m_entries.insert(pageIndex, entry);
+    evictToBudget(pageIndex);
+}
+
+void PdfTextCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_bytesUsed = 0;
+}
+
+// ============================================================================
+// Budget
+// ============================================================================
+
+void PdfTextCache::setBudgetBytes(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budgetBytes = bytes;
+    evictToBudget(-1);
+}
+
+qint64 PdfTextCache::budgetBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budgetBytes;
+}
+
+qint64 PdfTextCache::bytesUsed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytesUsed;
+}
+
+int PdfTextCache::pageCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return int(m_entries.size());
+}
+
+void PdfTextCache::evictToBudget(int keep)
+{
+    // Linear LRU scan, as in PdfTileCache: a few hundred pages at most.
+    while (m_bytesUsed > m_budgetBytes && !m_entries.isEmpty()) {
+        auto victim = m_entries.end();
+        quint64 oldest = std::numeric_limits<quint64>::max();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it.key() != keep && it->lastUsed < oldest) {
+                oldest = it->lastUsed;
+                victim = it;
+            }
+        }
+        if (victim == m_entries.end())
+            break;
+        m_bytesUsed -= victim->bytes;
+        m_entries.erase(victim);
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// ============================================================================
+// PdfTextCache - Byte-budgeted cache of per-page PDF text layouts
+// ============================================================================
+// Structured-text extraction is the expensive part of PdfProvider::textBoxes():
+// MuPDF loads the page, runs its content stream through a text device and
+// allocates a node per glyph. Text selection, the highlighter and search all
+// ask for the same pages again and again, so MuPdfProvider keeps the result
+// here, shared by every caller and thread.
+//
+// A page is stored flat instead of as QVector<PdfTextBox>: one string with
+// the text of all boxes, offset tables, and the character rects as float
+// quadruples (16 bytes instead of QRectF's 32, no per-box vector headers).
+// MuPDF produces character rects in single precision, so this is lossless;
+// box rects are unions computed in double and stay double. A typical text
+// page costs ~25 bytes per glyph; the default budget holds a few hundred
+// pages. Lookups expand a copy outside the lock.
+//
+// All methods are thread-safe.
+// ============================================================================
+
+#include "PdfProvider.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+class PdfTextCache {
+public:
+    /**
+     * @brief Text boxes of one page in the flat layout.
+     */
+    struct PageLayout {
+        QString text;               ///< Texts of all boxes, concatenated
+        QVector<int> textStarts;    ///< Box i's text is [textStarts[i], textStarts[i + 1])
+        QVector<int> charStarts;    ///< Box i's char rects, same scheme (may be empty)
+        QVector<double> boxRects;   ///< x, y, width, height per box
+        QVector<float> charRects;   ///< x, y, width, height per char rect
+
+        int boxCount() const { return textStarts.isEmpty() ? 0 : int(textStarts.size()) - 1; }
+
+        /// Approximate heap footprint, charged against the budget.
+        qint64 bytes() const;
+    };
+
+    /// Flatten @p boxes.
+    static PageLayout pack(const QVector<PdfTextBox>& boxes);
+
+    /// Expand a layout back into text boxes (char rects rounded to float).
+    static QVector<PdfTextBox> unpack(const PageLayout& layout);
+
+    explicit PdfTextCache(qint64 budgetBytes = 16LL * 1024 * 1024);
+
+    // ===== Cache access =====
+
+    /**
+     * @brief Look up a page and mark it most recently used.
+     * @return false on a miss (@p boxes is left untouched).
+     *
+     * A hit may be an empty list: pages without text are cached too.
+     */
+    bool find(int pageIndex, QVector<PdfTextBox>& boxes);
+
+    /**
+     * @brief Check for a page without touching its LRU position.
+     */
+    bool contains(int pageIndex) const;
+
+    /**
+     * @brief Insert (or replace) a page, then evict least recently used
+     *        pages until the cache fits its budget again.
+     */
+    void insert(int pageIndex, const QVector<PdfTextBox>& boxes);
+
+    /**
+     * @brief Remove every page.
+     */
+    void clear();
+
+    // ===== Budget =====
+
+    /**
+     * @brief Set the memory budget in bytes, evicting immediately if over.
+     */
+    void setBudgetBytes(qint64 bytes);
+
+    qint64 budgetBytes() const;
+    qint64 bytesUsed() const;
+    int pageCount() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const PageLayout> layout;
+        qint64 bytes = 0;
+        quint64 lastUsed = 0;
+    };
+
+    /// Evict LRU entries (except @p keep) until within budget. Mutex held.
+    void evictToBudget(int keep);
+
+    mutable QMutex m_mutex;
+    QHash<int, Entry> m_entries;
+    qint64 m_budgetBytes;
+    qint64 m_bytesUsed = 0;
+    quint64 m_useCounter = 0;
+};
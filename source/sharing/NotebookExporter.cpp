@@ -1,18 +1,163 @@
 #include "NotebookExporter.h"
 #include "../core/Document.h"
 
+#include <QDateTime>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QFuture>
 #include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QDebug>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <deque>
 
 // miniz - cross-platform ZIP library (MIT license)
 #include "miniz.h"
 
+// ============================================================================
+// Archive entries
+// ============================================================================
+
+namespace {
+
+/// Files at least this large are streamed from disk by the writer instead of
+/// being read and deflated in memory on a worker.
+constexpr qint64 kInMemoryEntryLimit = 16LL * 1024 * 1024;
+
+/// Source bytes that may be queued (read, compressed or waiting to be
+/// written) ahead of the writer. Bounds peak memory to roughly twice this.
+constexpr qint64 kMaxBytesInFlight = 64LL * 1024 * 1024;
+
+/**
+ * @brief One file of the package, in archive order.
+ */
+struct PackageEntry {
+    QString sourcePath;             ///< File on disk (empty if data is set)
+    QByteArray archiveName;         ///< UTF-8 path inside the ZIP
+    QByteArray data;                ///< Generated content (rewritten document.json)
+    qint64 size = 0;                ///< Uncompressed size
+    bool store = false;             ///< Payload is already compressed
+    bool required = false;          ///< Failure aborts the export
+};
+
+/**
+ * @brief An entry read and (maybe) deflated by a worker.
+ */
+struct PackedEntry {
+    bool ok = false;
+    bool deflated = false;          ///< payload is a raw deflate stream
+    QByteArray payload;             ///< Deflated or original bytes
+    qint64 uncompressedSize = 0;
+    mz_uint32 crc32 = 0;
+};
+
+/// Payloads that deflate would only waste time on.
+bool isPrecompressed(const QString& path)
+{
+    static const QStringList suffixes = {
+        QStringLiteral("pdf"), QStringLiteral("png"), QStringLiteral("jpg"),
+        QStringLiteral("jpeg"), QStringLiteral("webp"), QStringLiteral("gif"),
+        QStringLiteral("zip"), QStringLiteral("snbx"),
+        QStringLiteral("snsi"),     // PdfSearchIndex: qCompress'd records
+        QStringLiteral("snth"),     // ThumbnailStore: JPEG/PNG blobs
+    };
+    return suffixes.contains(QFileInfo(path).suffix().toLower());
+}
+
+/// Worker side: read the entry and deflate it into an independent stream.
+PackedEntry packEntry(const PackageEntry& entry, int level)
+{
+    PackedEntry packed;
+    if (entry.sourcePath.isEmpty()) {
+        packed.payload = entry.data;
+    } else {
+        QFile file(entry.sourcePath);
+        if (!file.open(QIODevice::ReadOnly))
+            return packed;
+        packed.payload = file.readAll();
+    }
+    packed.ok = true;
+    packed.uncompressedSize = packed.payload.size();
+    packed.crc32 = mz_uint32(mz_crc32(MZ_CRC32_INIT,
+        reinterpret_cast<const unsigned char*>(packed.payload.constData()),
+        size_t(packed.payload.size())));
+
+    if (entry.store || level <= 0 || packed.payload.size() <= 3)
+        return packed;
+
+    size_t deflatedSize = 0;
+    const int flags = int(tdefl_create_comp_flags_from_zip_params(
+        level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+    void* deflated = tdefl_compress_mem_to_heap(packed.payload.constData(),
+                                                size_t(packed.payload.size()),
+                                                &deflatedSize, flags);
+    // Keep the original when deflate does not help (tiny or random data).
+    if (deflated && qint64(deflatedSize) < packed.payload.size()) {
+        packed.payload = QByteArray(static_cast<const char*>(deflated), int(deflatedSize));
+        packed.deflated = true;
+    }
+    mz_free(deflated);
+    return packed;
+}
+
+size_t readFileCallback(void* opaque, mz_uint64 offset, void* buffer, size_t n)
+{
+    auto* file = static_cast<QFile*>(opaque);
+    if (file->pos() != qint64(offset) && !file->seek(qint64(offset)))
+        return 0;
+    const qint64 read = file->read(static_cast<char*>(buffer), qint64(n));
+    return read > 0 ? size_t(read) : 0;
+}
+
+/// Writer side: append a large file by streaming it through miniz.
+bool streamEntry(mz_zip_archive* zip, const PackageEntry& entry, int level)
+{
+    QFile file(entry.sourcePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const mz_uint entryLevel = entry.store ? MZ_NO_COMPRESSION : mz_uint(level);
+    // Unlike the in-memory entries (stamped with the current time by miniz),
+    // the callback API leaves a null time as 1980; use the file's own mtime.
+    const MZ_TIME_T* fileTime = nullptr;
+#ifndef MINIZ_NO_TIME
+    MZ_TIME_T modified;
+    const QDateTime mtime = file.fileTime(QFileDevice::FileModificationTime);
+    if (mtime.isValid()) {
+        modified = MZ_TIME_T(mtime.toSecsSinceEpoch());
+        fileTime = &modified;
+    }
+#endif
+    return mz_zip_writer_add_read_buf_callback(zip, entry.archiveName.constData(),
+                                               readFileCallback, &file, mz_uint64(file.size()),
+                                               fileTime, nullptr, 0, entryLevel,
+                                               nullptr, 0, nullptr, 0);
+}
+
+/// Writer side: append an entry a worker has prepared.
+bool writePackedEntry(mz_zip_archive* zip, const PackageEntry& entry,
+                      const PackedEntry& packed, int level)
+{
+    if (!packed.deflated) {
+        return mz_zip_writer_add_mem(zip, entry.archiveName.constData(),
+                                     packed.payload.constData(), size_t(packed.payload.size()),
+                                     MZ_NO_COMPRESSION);
+    }
+    return mz_zip_writer_add_mem_ex_v2(zip, entry.archiveName.constData(),
+                                       packed.payload.constData(), size_t(packed.payload.size()),
+                                       nullptr, 0, mz_uint(level) | MZ_ZIP_FLAG_COMPRESSED_DATA,
+                                       mz_uint64(packed.uncompressedSize), packed.crc32,
+                                       nullptr, nullptr, 0, nullptr, 0);
+}
+
+} // namespace
+
 // ============================================================================
 // NotebookExporter Implementation
 // ============================================================================
@@ -51,11 +196,82 @@ NotebookExporter::ExportResult NotebookExporter::exportPackage(
     if (!notebookName.endsWith(".snb")) {
         notebookName += ".snb";
     }
+    const int level = std::clamp(options.compressionLevel, 0, 9);
     #ifdef SPEEDYNOTE_DEBUG
     qDebug() << "NotebookExporter: Exporting" << notebookName 
              << "to" << options.destPath
-             << "(includePdf:" << options.includePdf << ")";
+             << "(includePdf:" << options.includePdf
+             << "level:" << level << ")";
     #endif
+    
+    // ===== Step 1: List the package entries =====
+    
+    QVector<PackageEntry> entries;
+    
+    // Iterate through all files in the bundle
+    QDirIterator it(bundlePath, QDir::Files | QDir::NoDotAndDotDot, 
+                    QDirIterator::Subdirectories);
+    
+    while (it.hasNext()) {
+        QString filePath = it.next();
+        QString relativePath = bundleDir.relativeFilePath(filePath);
+        
+        PackageEntry entry;
+        entry.archiveName = (notebookName + "/" + relativePath).toUtf8();
+        
+        // Special handling for document.json if we're embedding PDF
+        if (options.includePdf && relativePath == "document.json" && !doc->pdfPath().isEmpty()) {
+            // Read the original document.json
+            QFile jsonFile(filePath);
+            if (!jsonFile.open(QIODevice::ReadOnly)) {
+                result.errorMessage = QObject::tr("Failed to read document.json");
+                return result;
+            }
+            
+            QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonFile.readAll());
+            jsonFile.close();
+            
+            if (!jsonDoc.isObject()) {
+                result.errorMessage = QObject::tr("Invalid document.json format");
+                return result;
+            }
+            
+            // Add the embedded PDF relative path
+            QJsonObject root = jsonDoc.object();
+            const QString embeddedPdfPath = "../embedded/" + QFileInfo(doc->pdfPath()).fileName();
+            root["pdf_relative_path"] = embeddedPdfPath;
+            
+            entry.data = QJsonDocument(root).toJson(QJsonDocument::Indented);
+            entry.size = entry.data.size();
+            entry.required = true;
+            
+            #ifdef SPEEDYNOTE_DEBUG
+            qDebug() << "NotebookExporter: Modified document.json with embedded PDF path:" 
+                     << embeddedPdfPath;
+            #endif
+        } else {
+            entry.sourcePath = filePath;
+            entry.size = it.fileInfo().size();
+            entry.store = isPrecompressed(filePath);
+        }
+        entries.append(entry);
+    }
+    
+    // Embedded PDF, if requested (missing PDF is not fatal)
+    if (options.includePdf && !doc->pdfPath().isEmpty()) {
+        const QFileInfo pdfInfo(doc->pdfPath());
+        if (pdfInfo.exists()) {
+            PackageEntry entry;
+            entry.sourcePath = pdfInfo.filePath();
+            entry.archiveName = ("embedded/" + pdfInfo.fileName()).toUtf8();
+            entry.size = pdfInfo.size();
+            entry.store = true;
+            entries.append(entry);
+        } else {
+            qWarning() << "NotebookExporter: PDF file not found for embedding:" << doc->pdfPath();
+        }
+    }
+    
     // Create parent directory for destination if needed
     QFileInfo destInfo(options.destPath);
     QDir destDir = destInfo.absoluteDir();
@@ -85,126 +301,90 @@ NotebookExporter::ExportResult NotebookExporter::exportPackage(
         return result;
     }
     
+    // ===== Step 2: Compress in parallel, write in order =====
+    
+    // Declared before the queue so its destructor waits for any job still
+    // running when we bail out early.
+    QThreadPool pool;
+    pool.setMaxThreadCount(options.maxThreads > 0 ? options.maxThreads
+                                                  : QThread::idealThreadCount());
+    
+    struct Pending {
+        int index;
+        QFuture<PackedEntry> future;
+    };
+    std::deque<Pending> pending;
+    qint64 bytesInFlight = 0;
+    const int maxQueued = 4 * pool.maxThreadCount();
+    
     // Helper lambda to clean up on error
     auto cleanupOnError = [&]() {
+        for (Pending& p : pending) {
+            p.future.cancel();
+        }
+        pool.waitForDone();
         mz_zip_writer_end(&zipArchive);
         QFile::remove(options.destPath);
     };
     
-    // ===== Step 1: Add all files from the .snb bundle =====
-    
-    // Iterate through all files in the bundle
-    QDirIterator it(bundlePath, QDir::Files | QDir::NoDotAndDotDot, 
-                    QDirIterator::Subdirectories);
+    auto reportFailure = [&](const PackageEntry& entry) {
+        if (entry.required) {
+            result.errorMessage = QObject::tr("Failed to add %1 to archive")
+                                    .arg(QString::fromUtf8(entry.archiveName));
+            return false;
+        }
+        // Not fatal for non-essential files (or the embedded PDF)
+        qWarning() << "NotebookExporter: Failed to add file to archive:" << entry.sourcePath;
+        return true;
+    };
     
-    QString pdfFileName;
-    QString embeddedPdfPath;
+    // Append the oldest queued entry. Returns false on a fatal failure.
+    auto writeFront = [&]() {
+        Pending front = pending.front();
+        pending.pop_front();
+        const PackageEntry& entry = entries[front.index];
+        const PackedEntry packed = front.future.result();
+        bytesInFlight -= entry.size;
+        if (!packed.ok || !writePackedEntry(&zipArchive, entry, packed, level)) {
+            return reportFailure(entry);
+        }
+        return true;
+    };
     
-    while (it.hasNext()) {
-        QString filePath = it.next();
-        QString relativePath = bundleDir.relativeFilePath(filePath);
-        QString zipEntryPath = notebookName + "/" + relativePath;
-        QByteArray zipEntryPathUtf8 = zipEntryPath.toUtf8();
+    for (int i = 0; i < entries.size(); ++i) {
+        const PackageEntry& entry = entries[i];
         
-        // Special handling for document.json if we're embedding PDF
-        if (options.includePdf && relativePath == "document.json" && !doc->pdfPath().isEmpty()) {
-            // Read the original document.json
-            QFile jsonFile(filePath);
-            if (!jsonFile.open(QIODevice::ReadOnly)) {
-                result.errorMessage = QObject::tr("Failed to read document.json");
-                cleanupOnError();
-                return result;
+        if (entry.size >= kInMemoryEntryLimit) {
+            // Large file: flush what is queued to keep order, then stream it.
+            while (!pending.empty()) {
+                if (!writeFront()) {
+                    cleanupOnError();
+                    return result;
+                }
             }
-            
-            QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonFile.readAll());
-            jsonFile.close();
-            
-            if (!jsonDoc.isObject()) {
-                result.errorMessage = QObject::tr("Invalid document.json format");
+            if (!streamEntry(&zipArchive, entry, level) && !reportFailure(entry)) {
                 cleanupOnError();
                 return result;
             }
-            
-            // Modify the JSON to add embedded PDF relative path
-            QJsonObject root = jsonDoc.object();
-            
-            // Get the PDF filename
-            QFileInfo pdfInfo(doc->pdfPath());
-            pdfFileName = pdfInfo.fileName();
-            embeddedPdfPath = "../embedded/" + pdfFileName;
-            
-            // Add the embedded PDF relative path
-            root["pdf_relative_path"] = embeddedPdfPath;
-            
-            // Write modified JSON to ZIP
-            QJsonDocument modifiedDoc(root);
-            QByteArray modifiedJson = modifiedDoc.toJson(QJsonDocument::Indented);
-            
-            if (!mz_zip_writer_add_mem(&zipArchive, zipEntryPathUtf8.constData(),
-                                        modifiedJson.constData(), modifiedJson.size(),
-                                        MZ_BEST_COMPRESSION)) {
-                result.errorMessage = QObject::tr("Failed to add document.json to archive");
+            continue;
+        }
+        
+        while (!pending.empty() && (bytesInFlight + entry.size > kMaxBytesInFlight
+                                    || int(pending.size()) >= maxQueued)) {
+            if (!writeFront()) {
                 cleanupOnError();
                 return result;
             }
-            
-            #ifdef SPEEDYNOTE_DEBUG
-            qDebug() << "NotebookExporter: Modified document.json with embedded PDF path:" 
-                     << embeddedPdfPath;
-            #endif
-        } else {
-            // Regular file - add directly
-            QFile file(filePath);
-            if (!file.open(QIODevice::ReadOnly)) {
-                qWarning() << "NotebookExporter: Failed to read file:" << filePath;
-                continue; // Skip this file but continue
-            }
-            
-            QByteArray fileContent = file.readAll();
-            file.close();
-            
-            if (!mz_zip_writer_add_mem(&zipArchive, zipEntryPathUtf8.constData(),
-                                        fileContent.constData(), fileContent.size(),
-                                        MZ_BEST_COMPRESSION)) {
-                qWarning() << "NotebookExporter: Failed to add file to archive:" << filePath;
-                // Continue - not fatal for non-essential files
-            }
         }
+        bytesInFlight += entry.size;
+        pending.push_back({i, QtConcurrent::run(&pool, [entry, level]() {
+            return packEntry(entry, level);
+        })});
     }
-    
-    // ===== Step 2: Add embedded PDF if requested =====
-    
-    if (options.includePdf && !doc->pdfPath().isEmpty()) {
-        QString pdfPath = doc->pdfPath();
-        
-        if (QFile::exists(pdfPath)) {
-            QFile pdfFile(pdfPath);
-            if (pdfFile.open(QIODevice::ReadOnly)) {
-                QString pdfZipPath = "embedded/" + QFileInfo(pdfPath).fileName();
-                QByteArray pdfZipPathUtf8 = pdfZipPath.toUtf8();
-                QByteArray pdfContent = pdfFile.readAll();
-                pdfFile.close();
-                
-                // PDFs are already compressed, so use no compression for them
-                if (!mz_zip_writer_add_mem(&zipArchive, pdfZipPathUtf8.constData(),
-                                            pdfContent.constData(), pdfContent.size(),
-                                            MZ_NO_COMPRESSION)) {
-                    qWarning() << "NotebookExporter: Failed to add PDF to archive:" << pdfPath;
-                    // Continue without PDF - not a fatal error
-                }
-                #ifdef SPEEDYNOTE_DEBUG
-                else {
-                    qDebug() << "NotebookExporter: Added embedded PDF:" << pdfZipPath
-                             << "(" << pdfContent.size() << "bytes)";
-                }
-                #endif
-            } else {
-                qWarning() << "NotebookExporter: Failed to read PDF for embedding:" << pdfPath;
-                // Continue without PDF - not a fatal error
-            }
-        } else {
-            qWarning() << "NotebookExporter: PDF file not found for embedding:" << pdfPath;
-            // Continue without PDF - not a fatal error
+    while (!pending.empty()) {
+        if (!writeFront()) {
+            cleanupOnError();
+            return result;
         }
     }
     
@@ -11,6 +11,12 @@
 //
 // The exported package can be shared via Android's share sheet or saved
 // to disk on desktop platforms.
+//
+// Entries are deflated in parallel on a thread pool, each into its own raw
+// deflate stream, and appended to the archive in bundle order by the calling
+// thread. Already-compressed payloads (PDF, images, search/thumbnail stores)
+// are stored as-is, and large files are streamed from disk, so memory use
+// stays bounded regardless of notebook size.
 // ============================================================================
 
 #include <QString>
@@ -43,6 +49,8 @@ public:
     struct ExportOptions {
         bool includePdf = false;        ///< Whether to embed the PDF in the package
         QString destPath;               ///< Full path including .snbx extension
+        int compressionLevel = 6;       ///< Deflate level: 0 = store only, 1 = fastest ... 9 = smallest
+        int maxThreads = 0;             ///< Compression threads; 0 = QThread::idealThreadCount()
     };
     
     /**
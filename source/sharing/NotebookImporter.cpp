@@ -7,17 +7,99 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
 
 // miniz - cross-platform ZIP library (MIT license)
 #include "miniz.h"
 
+// ============================================================================
+// Streaming extraction
+// ============================================================================
+
+namespace {
+
+/// Packages smaller than this are extracted on the calling thread; opening
+/// extra readers (each parses the central directory) is not worth it.
+constexpr qint64 kParallelMinBytes = 8LL * 1024 * 1024;
+
+/**
+ * @brief One file to extract.
+ */
+struct ExtractJob {
+    mz_uint index = 0;      ///< Entry index in the archive
+    QString entryName;      ///< For messages
+    QString path;           ///< Destination file
+    qint64 size = 0;        ///< Uncompressed size
+};
+
+/// Serializes "pick a free folder name, then create it" across concurrent imports.
+QMutex& folderReservationMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+size_t writeFileCallback(void* opaque, mz_uint64 offset, const void* buffer, size_t n)
+{
+    Q_UNUSED(offset);  // miniz writes sequentially
+    const qint64 written = static_cast<QFile*>(opaque)->write(static_cast<const char*>(buffer), qint64(n));
+    return written > 0 ? size_t(written) : 0;
+}
+
+/// Decompress one entry chunk by chunk into its file.
+bool extractEntry(mz_zip_archive* zip, const ExtractJob& job)
+{
+    QFile outFile(job.path);
+    if (!outFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "NotebookImporter: Failed to write:" << job.path;
+        return false;
+    }
+    if (!mz_zip_reader_extract_to_callback(zip, job.index, writeFileCallback, &outFile, 0)) {
+        qWarning() << "NotebookImporter: Failed to extract:" << job.entryName;
+        outFile.close();
+        outFile.remove();
+        return false;
+    }
+    outFile.close();
+    
+    #ifdef SPEEDYNOTE_DEBUG
+    qDebug() << "NotebookImporter: Extracted:" << job.path;
+    #endif
+    return true;
+}
+
+/// Split jobs into @p count groups of similar total size (largest first).
+QVector<QVector<ExtractJob>> balanceJobs(QVector<ExtractJob> jobs, int count)
+{
+    std::sort(jobs.begin(), jobs.end(), [](const ExtractJob& a, const ExtractJob& b) {
+        return a.size > b.size;
+    });
+    QVector<QVector<ExtractJob>> groups(count);
+    QVector<qint64> load(count, 0);
+    for (const ExtractJob& job : jobs) {
+        const int lightest = int(std::min_element(load.begin(), load.end()) - load.begin());
+        groups[lightest].append(job);
+        load[lightest] += job.size;
+    }
+    return groups;
+}
+
+} // namespace
+
 // ============================================================================
 // NotebookImporter Implementation
 // ============================================================================
 
 NotebookImporter::ImportResult NotebookImporter::importPackage(
     const QString& snbxPath, 
-    const QString& destDir)
+    const QString& destDir,
+    int maxThreads)
 {
     ImportResult result;
     
@@ -94,9 +176,22 @@ NotebookImporter::ImportResult NotebookImporter::importPackage(
     qDebug() << "NotebookImporter: Found notebook folder:" << snbFolderName;
     #endif
     
-    // Resolve name conflicts (auto-rename if necessary)
-    QString finalSnbName = resolveNameConflict(snbFolderName, destDir);
-    QString extractedSnbPath = destDir + "/" + finalSnbName;
+    // Resolve name conflicts (auto-rename if necessary) and create the .snb
+    // folder in one step, so a concurrent import cannot pick the same name
+    QString finalSnbName;
+    QString extractedSnbPath;
+    {
+        QMutexLocker locker(&folderReservationMutex());
+        finalSnbName = resolveNameConflict(snbFolderName, destDir);
+        extractedSnbPath = destDir + "/" + finalSnbName;
+        
+        QDir snbDir(extractedSnbPath);
+        if (!snbDir.mkpath(".")) {
+            result.errorMessage = QObject::tr("Failed to create notebook folder: %1").arg(extractedSnbPath);
+            cleanup();
+            return result;
+        }
+    }
     
     #ifdef SPEEDYNOTE_DEBUG
     if (finalSnbName != snbFolderName) {
@@ -104,14 +199,6 @@ NotebookImporter::ImportResult NotebookImporter::importPackage(
     }
     #endif
     
-    // Create the .snb folder
-    QDir snbDir(extractedSnbPath);
-    if (!snbDir.mkpath(".")) {
-        result.errorMessage = QObject::tr("Failed to create notebook folder: %1").arg(extractedSnbPath);
-        cleanup();
-        return result;
-    }
-    
     // Track if we find an embedded PDF
     QString embeddedPdfPath;
     
@@ -120,7 +207,10 @@ NotebookImporter::ImportResult NotebookImporter::importPackage(
     // We use "embedded/" as the top-level folder but include the notebook name
     QString embeddedFolderPath = destDir + "/embedded";
     
-    // Extract all files
+    // Plan the extraction: destination of every file, parent folders created up front
+    QVector<ExtractJob> jobs;
+    qint64 totalBytes = 0;
+    QSet<QString> createdDirs;
     for (int i = 0; i < numFiles; i++) {
         mz_zip_archive_file_stat fileStat;
         if (!mz_zip_reader_file_stat(&zipArchive, i, &fileStat)) {
@@ -178,44 +268,48 @@ NotebookImporter::ImportResult NotebookImporter::importPackage(
         }
         
         // Create parent directory for the file
-        QFileInfo extractInfo(extractPath);
-        QDir extractDir = extractInfo.absoluteDir();
-        if (!extractDir.exists() && !extractDir.mkpath(".")) {
-            qWarning() << "NotebookImporter: Failed to create directory:" << extractDir.absolutePath();
-            continue;
-        }
-        
-        // Extract the file
-        size_t uncompressedSize = static_cast<size_t>(fileStat.m_uncomp_size);
-        
-        // Allocate buffer for file contents
-        void* fileData = malloc(uncompressedSize);
-        if (!fileData) {
-            qWarning() << "NotebookImporter: Failed to allocate memory for:" << entryName;
-            continue;
-        }
-        
-        if (!mz_zip_reader_extract_to_mem(&zipArchive, i, fileData, uncompressedSize, 0)) {
-            qWarning() << "NotebookImporter: Failed to extract:" << entryName;
-            free(fileData);
-            continue;
+        QDir extractDir = QFileInfo(extractPath).absoluteDir();
+        const QString extractDirPath = extractDir.absolutePath();
+        if (!createdDirs.contains(extractDirPath)) {
+            if (!extractDir.exists() && !extractDir.mkpath(".")) {
+                qWarning() << "NotebookImporter: Failed to create directory:" << extractDirPath;
+                continue;
+            }
+            createdDirs.insert(extractDirPath);
         }
         
-        // Write to file
-        QFile outFile(extractPath);
-        if (!outFile.open(QIODevice::WriteOnly)) {
-            qWarning() << "NotebookImporter: Failed to write:" << extractPath;
-            free(fileData);
-            continue;
+        ExtractJob job;
+        job.index = mz_uint(i);
+        job.entryName = entryName;
+        job.path = extractPath;
+        job.size = qint64(fileStat.m_uncomp_size);
+        totalBytes += job.size;
+        jobs.append(job);
+    }
+    
+    // Extract: failures of single files are logged and skipped, as before;
+    // a missing document.json is caught below
+    int threads = maxThreads > 0 ? maxThreads : QThread::idealThreadCount();
+    threads = std::min(threads, int(jobs.size()));
+    if (threads <= 1 || totalBytes < kParallelMinBytes) {
+        for (const ExtractJob& job : std::as_const(jobs)) {
+            extractEntry(&zipArchive, job);
         }
-        
-        outFile.write(static_cast<const char*>(fileData), static_cast<qint64>(uncompressedSize));
-        outFile.close();
-        free(fileData);
-        
-        #ifdef SPEEDYNOTE_DEBUG
-        qDebug() << "NotebookImporter: Extracted:" << extractPath;
-        #endif
+    } else {
+        // miniz readers are not thread-safe: every group gets its own
+        QVector<QVector<ExtractJob>> groups = balanceJobs(jobs, threads);
+        QtConcurrent::blockingMap(groups, [&snbxPathUtf8](const QVector<ExtractJob>& group) {
+            mz_zip_archive reader;
+            memset(&reader, 0, sizeof(reader));
+            if (!mz_zip_reader_init_file(&reader, snbxPathUtf8.constData(), 0)) {
+                qWarning() << "NotebookImporter: Failed to reopen package for" << group.size() << "entries";
+                return;
+            }
+            for (const ExtractJob& job : group) {
+                extractEntry(&reader, job);
+            }
+            mz_zip_reader_end(&reader);
+        });
     }
     
     // Close the ZIP archive
@@ -10,6 +10,12 @@
 // - Optionally, an embedded/ folder with the PDF
 //
 // The extracted notebook can be loaded by DocumentManager.
+//
+// Entries are decompressed in chunks straight into their files, so memory
+// stays at a few hundred KB per extracting thread whatever the entry size.
+// Large packages are split across threads, each with its own reader on the
+// package. Several packages may be imported concurrently into the same
+// directory: folder name reservation is serialized.
 // ============================================================================
 
 #include <QString>
@@ -54,9 +60,12 @@ public:
      * 
      * @param snbxPath Path to the .snbx file to import
      * @param destDir Directory to extract to (e.g., notebooks/)
+     * @param maxThreads Threads extracting entries concurrently;
+     *        0 = QThread::idealThreadCount(), 1 = calling thread only
      * @return ImportResult with success status and extracted paths
      */
-    static ImportResult importPackage(const QString& snbxPath, const QString& destDir);
+    static ImportResult importPackage(const QString& snbxPath, const QString& destDir,
+                                      int maxThreads = 0);
     
     /**
      * @brief Generate a unique name if a notebook with the same name exists.
@@ -0,0 +1,428 @@
+// ============================================================================
+// StrokeKernels - Implementation
+// ============================================================================
+//
+// The kernels are written once against a tiny "Ops" interface (load/store,
+// arithmetic, min/max, lane select) and instantiated for:
+//
+//   ScalarOps   1 lane, plain float            (fallback, reference)
+//   SseOps      4 lanes, SSE2                  (x86 / x86_64)
+//   Avx2Ops     8 lanes, AVX2                  (only when the build enables it)
+//   NeonOps     4 lanes, AArch64 NEON
+//
+// Catmull-Rom subdivision vectorizes across the CURVE_SUBDIVISIONS points of
+// one segment (4 lanes = 4 subdivisions), so it always uses the 4-wide type.
+// The outline and bounds kernels are element-wise and use the widest type.
+// ============================================================================
+
+#include "StrokeKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SN_STROKE_SSE 1
+#define SN_STROKE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SN_STROKE_SSE 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SN_STROKE_NEON 1
+#endif
+
+namespace StrokeKernels {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scratch arena
+// ---------------------------------------------------------------------------
+// One growable float buffer per thread (rendering, tile prefetch and export
+// preparation all build polygons on worker threads). Each buildOutline() call
+// carves its arrays out of a single acquire().
+
+class ScratchArena {
+public:
+    float* acquire(int floats) {
+        const size_t needed = size_t(floats);
+        if (m_buffer.size() < needed) {
+            m_buffer.resize(needed);
+        } else if (m_buffer.size() > RELEASE_THRESHOLD && needed * 4 < m_buffer.size()) {
+            // Don't pin the memory of one huge stroke for the thread's lifetime.
+            std::vector<float>(needed).swap(m_buffer);
+        }
+        return m_buffer.data();
+    }
+
+private:
+    static constexpr size_t RELEASE_THRESHOLD = size_t(1) << 18;  // 1 MB
+    std::vector<float> m_buffer;
+};
+
+ScratchArena& scratchArena()
+{
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+// ---------------------------------------------------------------------------
+// Lane operations
+// ---------------------------------------------------------------------------
+
+struct ScalarOps {
+    using V = float;
+    static constexpr int W = 1;
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V splat(float f) { return f; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return a / b; }
+    static V sqrt(V a) { return std::sqrt(a); }
+    static V min(V a, V b) { return a < b ? a : b; }
+    static V max(V a, V b) { return a > b ? a : b; }
+    /// Per lane: a < b ? t : f
+    static V selectLess(V a, V b, V t, V f) { return a < b ? t : f; }
+};
+
+#ifdef SN_STROKE_SSE
+struct SseOps {
+    using V = __m128;
+    static constexpr int W = 4;
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V splat(float f) { return _mm_set1_ps(f); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    static V sqrt(V a) { return _mm_sqrt_ps(a); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+    static V selectLess(V a, V b, V t, V f) {
+        const V mask = _mm_cmplt_ps(a, b);
+        return _mm_or_ps(_mm_and_ps(mask, t), _mm_andnot_ps(mask, f));
+    }
+};
+#endif
+
+#ifdef SN_STROKE_AVX2
+struct Avx2Ops {
+    using V = __m256;
+    static constexpr int W = 8;
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V splat(float f) { return _mm256_set1_ps(f); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V sqrt(V a) { return _mm256_sqrt_ps(a); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V selectLess(V a, V b, V t, V f) {
+        return _mm256_blendv_ps(f, t, _mm256_cmp_ps(a, b, _CMP_LT_OQ));
+    }
+};
+#endif
+
+#ifdef SN_STROKE_NEON
+struct NeonOps {
+    using V = float32x4_t;
+    static constexpr int W = 4;
+    static V load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, V v) { vst1q_f32(p, v); }
+    static V splat(float f) { return vdupq_n_f32(f); }
+    static V add(V a, V b) { return vaddq_f32(a, b); }
+    static V sub(V a, V b) { return vsubq_f32(a, b); }
+    static V mul(V a, V b) { return vmulq_f32(a, b); }
+    static V div(V a, V b) { return vdivq_f32(a, b); }
+    static V sqrt(V a) { return vsqrtq_f32(a); }
+    static V min(V a, V b) { return vminq_f32(a, b); }
+    static V max(V a, V b) { return vmaxq_f32(a, b); }
+    static V selectLess(V a, V b, V t, V f) { return vbslq_f32(vcltq_f32(a, b), t, f); }
+};
+#endif
+
+#if defined(SN_STROKE_AVX2)
+using SubdivOps = SseOps;
+using WideOps = Avx2Ops;
+#elif defined(SN_STROKE_SSE)
+using SubdivOps = SseOps;
+using WideOps = SseOps;
+#elif defined(SN_STROKE_NEON)
+using SubdivOps = NeonOps;
+using WideOps = NeonOps;
+#else
+using SubdivOps = ScalarOps;
+using WideOps = ScalarOps;
+#endif
+
+// ---------------------------------------------------------------------------
+// Catmull-Rom subdivision
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Evaluate subdivisions [s, s + W) of one segment.
+ * @param w Basis weights, 4 rows of S: w0[S] | w1[S] | w2[S] | w3[S].
+ */
+template <typename Ops>
+inline void subdivideLanes(const float* w, int S, int s,
+                           const float c[3][4], float* ox, float* oy, float* op)
+{
+    using V = typename Ops::V;
+    const V w0 = Ops::load(w + s);
+    const V w1 = Ops::load(w + S + s);
+    const V w2 = Ops::load(w + 2 * S + s);
+    const V w3 = Ops::load(w + 3 * S + s);
+    V out[3];
+    for (int k = 0; k < 3; ++k) {
+        out[k] = Ops::add(Ops::add(Ops::mul(w0, Ops::splat(c[k][0])), Ops::mul(w1, Ops::splat(c[k][1]))),
+                          Ops::add(Ops::mul(w2, Ops::splat(c[k][2])), Ops::mul(w3, Ops::splat(c[k][3]))));
+    }
+    Ops::store(ox + s, out[0]);
+    Ops::store(oy + s, out[1]);
+    // Clamp pressure overshoot, as the original scalar loop did.
+    Ops::store(op + s, Ops::min(Ops::max(out[2], Ops::splat(0.1f)), Ops::splat(1.0f)));
+}
+
+template <typename Ops>
+void subdivideKernel(const float* x, const float* y, const float* p, int n,
+                     const float* w, int S, float* ox, float* oy, float* op)
+{
+    ox[0] = x[0];
+    oy[0] = y[0];
+    op[0] = p[0];
+    for (int i = 0; i < n - 1; ++i) {
+        // Four control points, duplicating the endpoints at the boundaries.
+        const int i0 = qMax(0, i - 1);
+        const int i3 = qMin(n - 1, i + 2);
+        const float c[3][4] = {
+            { x[i0], x[i], x[i + 1], x[i3] },
+            { y[i0], y[i], y[i + 1], y[i3] },
+            { p[i0], p[i], p[i + 1], p[i3] },
+        };
+        const int outIndex = 1 + i * S;
+        int s = 0;
+        for (; s + Ops::W <= S; s += Ops::W) {
+            subdivideLanes<Ops>(w, S, s, c, ox + outIndex, oy + outIndex, op + outIndex);
+        }
+        for (; s < S; ++s) {
+            subdivideLanes<ScalarOps>(w, S, s, c, ox + outIndex, oy + outIndex, op + outIndex);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Outline offsets
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Offset W centerline points starting at @p i along the normal of the
+ *        tangent (tx, ty) by their half width.
+ */
+template <typename Ops>
+inline void offsetLanes(const float* x, const float* y, const float* p, int i,
+                        typename Ops::V tx, typename Ops::V ty, typename Ops::V halfScale,
+                        float* hw, float* lx, float* ly, float* rx, float* ry)
+{
+    using V = typename Ops::V;
+    const V eps = Ops::splat(0.0001f);
+    const V one = Ops::splat(1.0f);
+    const V zero = Ops::splat(0.0f);
+    V len = Ops::sqrt(Ops::add(Ops::mul(tx, tx), Ops::mul(ty, ty)));
+    // Degenerate tangent (repeated point): use an arbitrary perpendicular.
+    tx = Ops::selectLess(len, eps, one, tx);
+    ty = Ops::selectLess(len, eps, zero, ty);
+    len = Ops::selectLess(len, eps, one, len);
+
+    const V h = Ops::mul(Ops::load(p + i), halfScale);
+    const V scale = Ops::div(h, len);
+    const V offX = Ops::mul(Ops::sub(zero, ty), scale);  // perpendicular = (-ty, tx) / len
+    const V offY = Ops::mul(tx, scale);
+    const V cx = Ops::load(x + i);
+    const V cy = Ops::load(y + i);
+    Ops::store(hw + i, h);
+    Ops::store(lx + i, Ops::add(cx, offX));
+    Ops::store(ly + i, Ops::add(cy, offY));
+    Ops::store(rx + i, Ops::sub(cx, offX));
+    Ops::store(ry + i, Ops::sub(cy, offY));
+}
+
+template <typename Ops>
+void offsetKernel(const float* x, const float* y, const float* p, int m, float halfScale,
+                  float* hw, float* lx, float* ly, float* rx, float* ry)
+{
+    // Interior points: central difference of the neighbours.
+    const typename Ops::V vHalf = Ops::splat(halfScale);
+    int i = 1;
+    for (; i + Ops::W <= m - 1; i += Ops::W) {
+        offsetLanes<Ops>(x, y, p, i,
+                         Ops::sub(Ops::load(x + i + 1), Ops::load(x + i - 1)),
+                         Ops::sub(Ops::load(y + i + 1), Ops::load(y + i - 1)),
+                         vHalf, hw, lx, ly, rx, ry);
+    }
+    for (; i < m - 1; ++i) {
+        offsetLanes<ScalarOps>(x, y, p, i, x[i + 1] - x[i - 1], y[i + 1] - y[i - 1],
+                               halfScale, hw, lx, ly, rx, ry);
+    }
+    // Endpoints: one-sided direction to/from the neighbour.
+    offsetLanes<ScalarOps>(x, y, p, 0, x[1] - x[0], y[1] - y[0], halfScale, hw, lx, ly, rx, ry);
+    offsetLanes<ScalarOps>(x, y, p, m - 1, x[m - 1] - x[m - 2], y[m - 1] - y[m - 2],
+                           halfScale, hw, lx, ly, rx, ry);
+}
+
+// ---------------------------------------------------------------------------
+// Bounds
+// ---------------------------------------------------------------------------
+
+template <typename Ops>
+void boundsKernel(const float* xs, const float* ys, int n, float out[4])
+{
+    float minX = xs[0], maxX = xs[0];
+    float minY = ys[0], maxY = ys[0];
+    int i = 1;
+    if (n >= Ops::W) {
+        typename Ops::V vMinX = Ops::load(xs), vMaxX = vMinX;
+        typename Ops::V vMinY = Ops::load(ys), vMaxY = vMinY;
+        for (i = Ops::W; i + Ops::W <= n; i += Ops::W) {
+            const typename Ops::V vx = Ops::load(xs + i);
+            const typename Ops::V vy = Ops::load(ys + i);
+            vMinX = Ops::min(vMinX, vx);
+            vMaxX = Ops::max(vMaxX, vx);
+            vMinY = Ops::min(vMinY, vy);
+            vMaxY = Ops::max(vMaxY, vy);
+        }
+        float lanes[4][Ops::W];
+        Ops::store(lanes[0], vMinX);
+        Ops::store(lanes[1], vMaxX);
+        Ops::store(lanes[2], vMinY);
+        Ops::store(lanes[3], vMaxY);
+        for (int l = 0; l < Ops::W; ++l) {
+            minX = qMin(minX, lanes[0][l]);
+            maxX = qMax(maxX, lanes[1][l]);
+            minY = qMin(minY, lanes[2][l]);
+            maxY = qMax(maxY, lanes[3][l]);
+        }
+    }
+    for (; i < n; ++i) {
+        minX = qMin(minX, xs[i]);
+        maxX = qMax(maxX, xs[i]);
+        minY = qMin(minY, ys[i]);
+        maxY = qMax(maxY, ys[i]);
+    }
+    out[0] = minX;
+    out[1] = minY;
+    out[2] = maxX;
+    out[3] = maxY;
+}
+
+} // namespace
+
+// ============================================================================
+// Public entry points
+// ============================================================================
+
+const char* simdName()
+{
+#if defined(SN_STROKE_AVX2)
+    return "AVX2";
+#elif defined(SN_STROKE_SSE)
+    return "SSE2";
+#elif defined(SN_STROKE_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+Outline buildOutline(const StrokePointList& points, qreal baseThickness,
+                     int subdivisions, Backend backend)
+{
+    Outline outline;
+    const int n = points.size();
+    if (n < 2) {
+        return outline;
+    }
+    const bool smooth = n >= 3 && subdivisions > 0;
+    const int S = smooth ? subdivisions : 0;
+    const int m = smooth ? (n - 1) * S + 1 : n;
+
+    // Arena layout: pressure[n] | weights[4S] | cx, cy, cp[m] (smoothing only)
+    //               | hw, lx, ly, rx, ry[m]
+    float* base = scratchArena().acquire(n + 4 * S + (smooth ? 3 * m : 0) + 5 * m);
+    float* pressure = base;
+    float* weights = pressure + n;
+    float* next = weights + 4 * S;
+
+    const quint16* quantized = points.pressureData();
+    for (int i = 0; i < n; ++i) {
+        pressure[i] = quantized[i] * (1.0f / 65535.0f);
+    }
+
+    const float* cx = points.xData();
+    const float* cy = points.yData();
+    const float* cp = pressure;
+    if (smooth) {
+        // Uniform Catmull-Rom basis at t = s / S:
+        //   q(t) = w0 P0 + w1 P1 + w2 P2 + w3 P3
+        for (int s = 1; s <= S; ++s) {
+            const double t = double(s) / S;
+            const double t2 = t * t;
+            const double t3 = t2 * t;
+            weights[s - 1] = float(0.5 * (-t + 2.0 * t2 - t3));
+            weights[S + s - 1] = float(0.5 * (2.0 - 5.0 * t2 + 3.0 * t3));
+            weights[2 * S + s - 1] = float(0.5 * (t + 4.0 * t2 - 3.0 * t3));
+            weights[3 * S + s - 1] = float(0.5 * (-t2 + t3));
+        }
+        float* sx = next;
+        float* sy = sx + m;
+        float* sp = sy + m;
+        next = sp + m;
+        if (backend == Backend::Scalar) {
+            subdivideKernel<ScalarOps>(cx, cy, cp, n, weights, S, sx, sy, sp);
+        } else {
+            subdivideKernel<SubdivOps>(cx, cy, cp, n, weights, S, sx, sy, sp);
+        }
+        cx = sx;
+        cy = sy;
+        cp = sp;
+    }
+
+    float* hw = next;
+    float* lx = hw + m;
+    float* ly = lx + m;
+    float* rx = ly + m;
+    float* ry = rx + m;
+    const float halfScale = float(baseThickness / 2.0);
+    if (backend == Backend::Scalar) {
+        offsetKernel<ScalarOps>(cx, cy, cp, m, halfScale, hw, lx, ly, rx, ry);
+    } else {
+        offsetKernel<WideOps>(cx, cy, cp, m, halfScale, hw, lx, ly, rx, ry);
+    }
+
+    outline.count = m;
+    outline.x = cx;
+    outline.y = cy;
+    outline.halfWidth = hw;
+    outline.leftX = lx;
+    outline.leftY = ly;
+    outline.rightX = rx;
+    outline.rightY = ry;
+    return outline;
+}
+
+void bounds(const float* xs, const float* ys, int n, float out[4], Backend backend)
+{
+    if (backend == Backend::Scalar) {
+        boundsKernel<ScalarOps>(xs, ys, n, out);
+    } else {
+        boundsKernel<WideOps>(xs, ys, n, out);
+    }
+}
+
+} // namespace StrokeKernels
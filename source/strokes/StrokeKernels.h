@@ -0,0 +1,80 @@
+#pragma once
+
+// ============================================================================
+// StrokeKernels - Vectorized geometry kernels for stroke rendering/export
+// ============================================================================
+// VectorLayer::buildStrokePolygon() runs for every stroke on each stroke-cache
+// rebuild and for every stroke in PDF export. These kernels do its number
+// crunching over the StrokePointList float columns:
+//
+//   - Catmull-Rom subdivision of positions and pressure
+//   - per-point normals and left/right outline offsets
+//   - bounding-box min/max reduction (VectorStroke::updateBoundingBox)
+//
+// Each kernel has a scalar implementation and a SIMD one selected at compile
+// time: SSE2 on x86 (AVX2 for the element-wise kernels when the build targets
+// it), NEON on AArch64. Release builds target Nehalem / ARMv8, so SSE2/NEON
+// are the paths that actually ship. Both paths evaluate the same float
+// formulas; results agree to float rounding.
+//
+// Intermediate arrays come from a per-thread scratch arena instead of
+// per-stroke QVectors, so building a polygon allocates only the QPolygonF it
+// returns.
+// ============================================================================
+
+#include "StrokePointList.h"
+
+namespace StrokeKernels {
+
+/// Which implementation to run (Auto = best compiled-in SIMD path).
+enum class Backend {
+    Auto,
+    Scalar
+};
+
+/**
+ * @brief Name of the SIMD instruction set compiled in ("SSE2", "AVX2",
+ *        "NEON"), or "scalar" if none is available.
+ */
+const char* simdName();
+
+/**
+ * @brief Smoothed centerline and outline of a stroke.
+ *
+ * All pointers refer to the calling thread's scratch arena and stay valid
+ * until the next buildOutline() call on the same thread.
+ */
+struct Outline {
+    int count = 0;                  ///< Number of centerline points
+    const float* x = nullptr;       ///< Smoothed centerline
+    const float* y = nullptr;
+    const float* halfWidth = nullptr;
+    const float* leftX = nullptr;   ///< Left edge, forward along the stroke
+    const float* leftY = nullptr;
+    const float* rightX = nullptr;  ///< Right edge, forward along the stroke
+    const float* rightY = nullptr;
+};
+
+/**
+ * @brief Smooth a stroke and compute its variable-width outline.
+ * @param points Stroke points (at least 2).
+ * @param baseThickness Width at full pressure.
+ * @param subdivisions Catmull-Rom points inserted per segment; strokes with
+ *        fewer than 3 points are not smoothed.
+ * @param backend Implementation to use.
+ *
+ * Interpolated pressure is clamped to [0.1, 1.0]; endpoint tangents use a
+ * duplicated first/last control point.
+ */
+Outline buildOutline(const StrokePointList& points, qreal baseThickness,
+                     int subdivisions, Backend backend = Backend::Auto);
+
+/**
+ * @brief Min/max of the coordinate columns.
+ * @param n Number of points (at least 1).
+ * @param bounds Receives { minX, minY, maxX, maxY }.
+ */
+void bounds(const float* xs, const float* ys, int n, float bounds[4],
+            Backend backend = Backend::Auto);
+
+} // namespace StrokeKernels
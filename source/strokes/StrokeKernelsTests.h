@@ -0,0 +1,316 @@
+#pragma once
+
+// ============================================================================
+// StrokeKernelsTests - SIMD vs scalar stroke geometry kernels
+// ============================================================================
+// - testOutlineMatchesScalar / testBoundsMatchScalar: the compiled-in SIMD
+//   path agrees with the scalar reference on strokes of every length class
+//   (tail handling, unsmoothed 2-point strokes, degenerate tangents).
+// - benchmarkStrokeKernels: scalar vs SIMD throughput over recorded strokes
+//   from a notebook bundle, or synthetic handwriting if none is given.
+//
+// Run with:  speedynote --test-stroke-kernels
+//            speedynote --bench-stroke-kernels [notebook.snb]
+// ============================================================================
+
+#include "StrokeKernels.h"
+#include "VectorStroke.h"
+#include "../core/Document.h"
+#include "../core/Page.h"
+#include "../layers/VectorLayer.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QString>
+#include <QVector>
+#include <QtMath>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace StrokeKernelsTests {
+
+/**
+ * @brief Synthetic handwriting: a slowly turning pen path with ~1.5 px
+ *        spacing and pressure that swells and fades along the stroke.
+ */
+inline VectorStroke makeHandwritingStroke(QRandomGenerator& rng, int pointCount, QPointF start)
+{
+    VectorStroke stroke;
+    stroke.baseThickness = 2.0 + rng.bounded(4.0);
+    stroke.points.reserve(pointCount);
+    QPointF pos = start;
+    qreal angle = rng.bounded(2.0 * M_PI);
+    for (int i = 0; i < pointCount; ++i) {
+        const qreal pressure = 0.35 + 0.55 * qSin(M_PI * (i + 0.5) / pointCount);
+        stroke.points.append(pos, pressure);
+        angle += (rng.bounded(1.0) - 0.5) * 0.6;
+        pos += QPointF(qCos(angle), qSin(angle)) * (1.0 + rng.bounded(1.0));
+    }
+    stroke.updateBoundingBox();
+    return stroke;
+}
+
+/// Copy of an Outline (the arena is reused by the next buildOutline call).
+struct OutlineCopy {
+    std::vector<float> x, y, halfWidth, leftX, leftY, rightX, rightY;
+
+    explicit OutlineCopy(const StrokeKernels::Outline& o)
+        : x(o.x, o.x + o.count), y(o.y, o.y + o.count),
+          halfWidth(o.halfWidth, o.halfWidth + o.count),
+          leftX(o.leftX, o.leftX + o.count), leftY(o.leftY, o.leftY + o.count),
+          rightX(o.rightX, o.rightX + o.count), rightY(o.rightY, o.rightY + o.count) {}
+};
+
+inline bool nearlyEqual(const std::vector<float>& a, const float* b, float tolerance)
+{
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (qAbs(a[i] - b[i]) > tolerance * qMax(1.0f, qAbs(a[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief SIMD outline equals the scalar outline for all stroke lengths.
+ */
+inline bool testOutlineMatchesScalar()
+{
+    qDebug() << "=== Test: stroke outline SIMD vs scalar ===" << StrokeKernels::simdName();
+
+    QRandomGenerator rng(2024);
+    const int lengths[] = { 2, 3, 4, 5, 7, 8, 9, 16, 17, 33, 250 };
+    const int subdivisions[] = { 0, 3, 4 };
+    for (int n : lengths) {
+        VectorStroke stroke = makeHandwritingStroke(rng, n, QPointF(500, 500));
+        if (n >= 5) {
+            // Repeated point: exercises the degenerate-tangent fallback.
+            stroke.points.setPosition(2, stroke.points.position(1));
+            stroke.points.setPosition(3, stroke.points.position(1));
+        }
+        for (int s : subdivisions) {
+            const OutlineCopy scalar(StrokeKernels::buildOutline(
+                stroke.points, stroke.baseThickness, s, StrokeKernels::Backend::Scalar));
+            const StrokeKernels::Outline simd = StrokeKernels::buildOutline(
+                stroke.points, stroke.baseThickness, s, StrokeKernels::Backend::Auto);
+
+            const int expected = (n >= 3 && s > 0) ? (n - 1) * s + 1 : n;
+            if (simd.count != expected || int(scalar.x.size()) != expected) {
+                qDebug() << "FAIL: point count" << simd.count << "expected" << expected
+                         << "(n =" << n << "subdivisions =" << s << ")";
+                return false;
+            }
+            // Catmull-Rom passes through its control points.
+            const QPointF first = stroke.points.position(0);
+            const QPointF last = stroke.points.position(n - 1);
+            if (qAbs(simd.x[0] - first.x()) > 1e-3 || qAbs(simd.y[0] - first.y()) > 1e-3
+                || qAbs(simd.x[expected - 1] - last.x()) > 1e-3
+                || qAbs(simd.y[expected - 1] - last.y()) > 1e-3) {
+                qDebug() << "FAIL: smoothed endpoints moved (n =" << n << ")";
+                return false;
+            }
+            const float tol = 1e-5f;
+            if (!nearlyEqual(scalar.x, simd.x, tol) || !nearlyEqual(scalar.y, simd.y, tol)
+                || !nearlyEqual(scalar.halfWidth, simd.halfWidth, tol)
+                || !nearlyEqual(scalar.leftX, simd.leftX, tol)
+                || !nearlyEqual(scalar.leftY, simd.leftY, tol)
+                || !nearlyEqual(scalar.rightX, simd.rightX, tol)
+                || !nearlyEqual(scalar.rightY, simd.rightY, tol)) {
+                qDebug() << "FAIL: SIMD outline differs from scalar (n =" << n
+                         << "subdivisions =" << s << ")";
+                return false;
+            }
+            for (int i = 0; i < expected; ++i) {
+                if (simd.halfWidth[i] < 0.1f * stroke.baseThickness / 2 - 1e-4f
+                    || simd.halfWidth[i] > stroke.baseThickness / 2 + 1e-4f) {
+                    qDebug() << "FAIL: half width outside the clamped pressure range";
+                    return false;
+                }
+            }
+        }
+    }
+
+    qDebug() << "PASS: SIMD outline matches scalar reference";
+    return true;
+}
+
+/**
+ * @brief SIMD bounds equal scalar bounds exactly (min/max do not round).
+ */
+inline bool testBoundsMatchScalar()
+{
+    qDebug() << "=== Test: stroke bounds SIMD vs scalar ===";
+
+    QRandomGenerator rng(7);
+    for (int n = 1; n <= 40; ++n) {
+        const VectorStroke stroke = makeHandwritingStroke(rng, n, QPointF(-200, 300));
+        float scalar[4], simd[4];
+        StrokeKernels::bounds(stroke.points.xData(), stroke.points.yData(), n, scalar,
+                              StrokeKernels::Backend::Scalar);
+        StrokeKernels::bounds(stroke.points.xData(), stroke.points.yData(), n, simd,
+                              StrokeKernels::Backend::Auto);
+        for (int k = 0; k < 4; ++k) {
+            if (scalar[k] != simd[k]) {
+                qDebug() << "FAIL: bounds differ for n =" << n << "component" << k
+                         << scalar[k] << "vs" << simd[k];
+                return false;
+            }
+        }
+    }
+
+    qDebug() << "PASS: SIMD bounds match scalar reference";
+    return true;
+}
+
+/**
+ * @brief Collect every stroke of a notebook bundle (paged or edgeless).
+ */
+inline QVector<VectorStroke> loadBundleStrokes(const QString& bundlePath)
+{
+    QVector<VectorStroke> strokes;
+    std::unique_ptr<Document> doc = Document::loadBundle(bundlePath);
+    if (!doc) {
+        return strokes;
+    }
+    auto collect = [&strokes](const Page* page) {
+        if (!page) {
+            return;
+        }
+        for (int l = 0; l < page->layerCount(); ++l) {
+            if (const VectorLayer* layer = page->layer(l)) {
+                strokes += layer->strokes();
+            }
+        }
+    };
+    if (doc->isEdgeless()) {
+        const auto coords = doc->allKnownTileCoords();
+        for (const auto& coord : coords) {
+            collect(doc->getTile(coord.first, coord.second));
+        }
+    } else {
+        for (int i = 0; i < doc->pageCount(); ++i) {
+            collect(doc->page(i));
+        }
+    }
+    return strokes;
+}
+
+/**
+ * @brief Scalar vs SIMD kernel throughput.
+ * @param bundlePath Optional .snb bundle whose recorded strokes are used;
+ *        synthetic handwriting is generated when empty or unreadable.
+ */
+inline bool benchmarkStrokeKernels(const QString& bundlePath = QString())
+{
+    qDebug() << "=== Benchmark: stroke kernels ===";
+
+    QVector<VectorStroke> strokes;
+    if (!bundlePath.isEmpty()) {
+        strokes = loadBundleStrokes(bundlePath);
+        qDebug().noquote() << QString("loaded %1 strokes from %2").arg(strokes.size()).arg(bundlePath);
+    }
+    if (strokes.isEmpty()) {
+        QRandomGenerator rng(42);
+        for (int i = 0; i < 20000; ++i) {
+            strokes.append(makeHandwritingStroke(rng, 8 + rng.bounded(120),
+                                                 QPointF(rng.bounded(2000.0), rng.bounded(2000.0))));
+        }
+        qDebug().noquote() << QString("using %1 synthetic handwriting strokes").arg(strokes.size());
+    }
+
+    qint64 points = 0;
+    for (const VectorStroke& stroke : std::as_const(strokes)) {
+        points += stroke.points.size();
+    }
+    if (points == 0) {
+        qDebug() << "FAIL: no stroke points to benchmark";
+        return false;
+    }
+
+    const int reps = qMax(1, int(2000000 / points));
+    struct Timing { qint64 outlineNs = 0; qint64 boundsNs = 0; double checksum = 0; };
+    auto run = [&](StrokeKernels::Backend backend) {
+        Timing t;
+        QElapsedTimer timer;
+        timer.start();
+        for (int r = 0; r < reps; ++r) {
+            for (const VectorStroke& stroke : std::as_const(strokes)) {
+                if (stroke.points.size() < 2) {
+                    continue;
+                }
+                const StrokeKernels::Outline o = StrokeKernels::buildOutline(
+                    stroke.points, stroke.baseThickness, 4, backend);
+                t.checksum += o.leftX[o.count / 2] + o.rightY[o.count - 1];
+            }
+        }
+        t.outlineNs = timer.nsecsElapsed();
+        timer.restart();
+        for (int r = 0; r < reps; ++r) {
+            for (const VectorStroke& stroke : std::as_const(strokes)) {
+                if (stroke.points.isEmpty()) {
+                    continue;
+                }
+                float b[4];
+                StrokeKernels::bounds(stroke.points.xData(), stroke.points.yData(),
+                                      stroke.points.size(), b, backend);
+                t.checksum += b[0] + b[3];
+            }
+        }
+        t.boundsNs = timer.nsecsElapsed();
+        return t;
+    };
+
+    run(StrokeKernels::Backend::Auto);  // warm up the scratch arena and caches
+    const Timing scalar = run(StrokeKernels::Backend::Scalar);
+    const Timing simd = run(StrokeKernels::Backend::Auto);
+
+    const qreal totalPoints = qreal(points) * reps;
+    qDebug().noquote() << QString("%1 points x %2 reps, SIMD = %3")
+                              .arg(points).arg(reps).arg(StrokeKernels::simdName());
+    qDebug().noquote() << QString("outline: scalar %1 ns/point | SIMD %2 ns/point (%3x)")
+                              .arg(scalar.outlineNs / totalPoints, 0, 'f', 2)
+                              .arg(simd.outlineNs / totalPoints, 0, 'f', 2)
+                              .arg(qreal(scalar.outlineNs) / qMax<qint64>(1, simd.outlineNs), 0, 'f', 2);
+    qDebug().noquote() << QString("bounds:  scalar %1 ns/point | SIMD %2 ns/point (%3x)")
+                              .arg(scalar.boundsNs / totalPoints, 0, 'f', 3)
+                              .arg(simd.boundsNs / totalPoints, 0, 'f', 3)
+                              .arg(qreal(scalar.boundsNs) / qMax<qint64>(1, simd.boundsNs), 0, 'f', 2);
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 vertices = 0;
+    for (const VectorStroke& stroke : std::as_const(strokes)) {
+        vertices += VectorLayer::buildStrokePolygon(stroke).polygon.size();
+    }
+    qDebug().noquote() << QString("buildStrokePolygon: %1 ns/point (%2 vertices)")
+                              .arg(timer.nsecsElapsed() / qreal(points), 0, 'f', 2)
+                              .arg(vertices);
+
+    // Checksums differ only by float rounding; a large gap means a kernel bug.
+    const bool consistent = qAbs(scalar.checksum - simd.checksum)
+                            <= 1e-4 * qMax(1.0, qAbs(scalar.checksum));
+    qDebug() << (consistent ? "PASS:" : "FAIL:") << "scalar and SIMD checksums"
+             << scalar.checksum << simd.checksum;
+    return consistent;
+}
+
+inline bool runAllTests()
+{
+    qDebug() << "\n========================================";
+    qDebug() << "Running Stroke Kernel Tests";
+    qDebug() << "========================================\n";
+
+    bool allPass = true;
+    allPass &= testOutlineMatchesScalar();
+    allPass &= testBoundsMatchScalar();
+
+    qDebug() << "\n========================================";
+    qDebug() << (allPass ? "ALL TESTS PASSED!" : "SOME TESTS FAILED!");
+    qDebug() << "========================================\n";
+    return allPass;
+}
+
+} // namespace StrokeKernelsTests
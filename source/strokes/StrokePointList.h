@@ -0,0 +1,419 @@
+#pragma once
+
+// ============================================================================
+// StrokePointList - Compact column storage for the points of a stroke
+// ============================================================================
+// A QVector<StrokePoint> costs 32 bytes per point (2 x double position,
+// double pressure, int64 timestamp). Long-running edgeless boards keep tens
+// of millions of points resident, so strokes store their points as columns
+// instead:
+//
+//   x[]        float     4 bytes
+//   y[]        float     4 bytes
+//   pressure[] uint16    2 bytes  (0..65535 maps to 0.0..1.0, as in .snpb)
+//   time[]     int32     4 bytes  offset from the first recorded timestamp;
+//                                 only allocated once a point has one
+//
+// All columns live in one implicitly shared QByteArray, so copying a stroke
+// (undo stack, clipboard, tile split) stays O(1) as it was with QVector.
+//
+// Precision: float32 resolves |v| * 2^-23, so it depends on where a stroke
+// lives. Saved page strokes and committed edgeless strokes are page- or
+// tile-local (tiles are 1024 px), where that is better than 1/1000 px; the
+// binary page format already stores float32. Strokes being drawn, and
+// lasso selections, on an edgeless canvas are in document coordinates
+// until committed: about 1/128 px at 100,000 px from the origin, 1/16 px at
+// 1,000,000 px, and visible quantization a few million px out.
+//
+// Reading code can keep treating the list like a QVector<StrokePoint>
+// (size(), at(), operator[], range-for); those return StrokePoint values
+// built on the fly. Hot loops (hit testing, bounding boxes, polygon
+// building, the page codec) read the columns directly via xData()/yData()/
+// pressureData() without materializing points.
+//
+// Every change to positions or pressure stamps the list with a new
+// process-wide revision(); copies keep the revision of the data they share.
+// Derived geometry (the cached stroke outline) is keyed on it.
+// ============================================================================
+
+#include "StrokePoint.h"
+
+#include <QByteArray>
+#include <QTransform>
+#include <QVector>
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+
+/**
+ * @brief Structure-of-arrays point list used by VectorStroke.
+ */
+class StrokePointList {
+public:
+    StrokePointList() = default;
+
+    StrokePointList(std::initializer_list<StrokePoint> points) {
+        reserve(static_cast<int>(points.size()));
+        for (const StrokePoint& pt : points) {
+            append(pt);
+        }
+    }
+
+    explicit StrokePointList(const QVector<StrokePoint>& points) {
+        reserve(points.size());
+        for (const StrokePoint& pt : points) {
+            append(pt);
+        }
+    }
+
+    // ===== Pressure quantization =====
+
+    static quint16 quantizePressure(qreal p) {
+        return static_cast<quint16>(qRound(qBound(0.0, p, 1.0) * 65535.0));
+    }
+
+    static qreal dequantizePressure(quint16 q) {
+        return q / 65535.0;
+    }
+
+    // ===== Size =====
+
+    int size() const { return m_size; }
+    int count() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    int capacity() const { return m_capacity; }
+
+    /**
+     * @brief Make room for @p n points without further reallocation.
+     */
+    void reserve(int n) {
+        if (n > m_capacity) {
+            relayout(n, m_timeMode);
+        }
+    }
+
+    /**
+     * @brief Resize to @p n points. New points are (0, 0) with pressure 1.0
+     *        and no timestamp; callers fill them through the column pointers.
+     */
+    void resize(int n) {
+        n = qMax(0, n);
+        if (n != m_size) {
+            m_revision = nextRevision();
+        }
+        reserve(n);
+        if (n > m_size) {
+            float* xs = mutableXData();
+            float* ys = mutableYData();
+            quint16* ps = mutablePressureData();
+            for (int i = m_size; i < n; ++i) {
+                xs[i] = 0.0f;
+                ys[i] = 0.0f;
+                ps[i] = 65535;
+            }
+            if (m_timeMode == TimeMode::Offsets) {
+                qint32* ts = mutableTimeOffsets();
+                for (int i = m_size; i < n; ++i) ts[i] = NO_TIME;
+            } else if (m_timeMode == TimeMode::Wide) {
+                m_wideTimes.resize(n);
+            }
+        } else if (m_timeMode == TimeMode::Wide) {
+            m_wideTimes.resize(n);
+        }
+        m_size = n;
+    }
+
+    void clear() {
+        m_columns = QByteArray();
+        m_wideTimes.clear();
+        m_size = 0;
+        m_capacity = 0;
+        m_timeMode = TimeMode::None;
+        m_timeBase = 0;
+        m_revision = nextRevision();
+    }
+
+    /**
+     * @brief Drop spare capacity (e.g. once a live stroke is finished).
+     */
+    void squeeze() {
+        if (m_capacity > m_size) {
+            relayout(m_size, m_timeMode);
+        }
+        m_wideTimes.squeeze();
+    }
+
+    /**
+     * @brief Approximate heap bytes owned by this list (for memory reports).
+     */
+    qint64 byteSize() const {
+        return m_columns.size() + qint64(m_wideTimes.capacity()) * qint64(sizeof(qint64));
+    }
+
+    /**
+     * @brief Geometry revision: changes whenever a position or pressure may
+     *        have changed; equal revisions mean equal points. Timestamps and
+     *        capacity changes do not affect it.
+     */
+    quint64 revision() const { return m_revision; }
+
+    // ===== Element access =====
+
+    StrokePoint at(int i) const {
+        StrokePoint pt;
+        pt.pos = position(i);
+        pt.pressure = pressure(i);
+        pt.timestamp = timestamp(i);
+        return pt;
+    }
+
+    StrokePoint operator[](int i) const { return at(i); }
+    StrokePoint first() const { return at(0); }
+    StrokePoint last() const { return at(m_size - 1); }
+
+    QPointF position(int i) const { return QPointF(xData()[i], yData()[i]); }
+    qreal pressure(int i) const { return dequantizePressure(pressureData()[i]); }
+
+    /**
+     * @brief Timestamp of point @p i, or 0 if it was not recorded.
+     */
+    qint64 timestamp(int i) const {
+        switch (m_timeMode) {
+        case TimeMode::None:
+            return 0;
+        case TimeMode::Offsets: {
+            const qint32 offset = timeOffsets()[i];
+            return offset == NO_TIME ? 0 : m_timeBase + offset;
+        }
+        case TimeMode::Wide:
+            return m_wideTimes[i];
+        }
+        return 0;
+    }
+
+    /// True if any point carries a recorded timestamp.
+    bool hasTimestamps() const { return m_timeMode != TimeMode::None; }
+
+    // ===== Column access =====
+
+    const float* xData() const { return reinterpret_cast<const float*>(m_columns.constData()); }
+    const float* yData() const { return xData() + m_capacity; }
+    const quint16* pressureData() const {
+        return reinterpret_cast<const quint16*>(yData() + m_capacity);
+    }
+
+    /// Writable columns; these detach from any shared copy and bump
+    /// revision(), so read-only code should stick to the const accessors above.
+    float* mutableXData() {
+        m_revision = nextRevision();
+        return reinterpret_cast<float*>(m_columns.data());
+    }
+    float* mutableYData() { return mutableXData() + m_capacity; }
+    quint16* mutablePressureData() { return reinterpret_cast<quint16*>(mutableYData() + m_capacity); }
+
+    // ===== Modification =====
+
+    void append(const QPointF& pos, qreal pressure, qint64 timestamp = 0) {
+        if (m_size == m_capacity) {
+            relayout(qMax(8, m_capacity * 2), m_timeMode);
+        }
+        const int i = m_size++;
+        mutableXData()[i] = static_cast<float>(pos.x());
+        mutableYData()[i] = static_cast<float>(pos.y());
+        mutablePressureData()[i] = quantizePressure(pressure);
+        if (m_timeMode == TimeMode::Offsets) {
+            mutableTimeOffsets()[i] = NO_TIME;
+        } else if (m_timeMode == TimeMode::Wide) {
+            m_wideTimes.append(0);
+        }
+        if (timestamp != 0) {
+            setTimestamp(i, timestamp);
+        }
+    }
+
+    void append(const StrokePoint& pt) { append(pt.pos, pt.pressure, pt.timestamp); }
+
+    StrokePointList& operator<<(const StrokePoint& pt) {
+        append(pt);
+        return *this;
+    }
+
+    void setPosition(int i, const QPointF& pos) {
+        mutableXData()[i] = static_cast<float>(pos.x());
+        mutableYData()[i] = static_cast<float>(pos.y());
+    }
+
+    void setPressure(int i, qreal pressure) { mutablePressureData()[i] = quantizePressure(pressure); }
+
+    void setTimestamp(int i, qint64 timestamp) {
+        if (m_timeMode == TimeMode::None) {
+            if (timestamp == 0) return;
+            m_timeBase = timestamp;
+            relayout(m_capacity, TimeMode::Offsets);
+        }
+        if (m_timeMode == TimeMode::Offsets) {
+            if (timestamp == 0) {
+                mutableTimeOffsets()[i] = NO_TIME;
+                return;
+            }
+            const qint64 offset = timestamp - m_timeBase;
+            if (offset > NO_TIME && offset <= std::numeric_limits<qint32>::max()) {
+                mutableTimeOffsets()[i] = static_cast<qint32>(offset);
+                return;
+            }
+            widenTimestamps();  // More than ~24 days apart: keep exact values
+        }
+        m_wideTimes[i] = timestamp;
+    }
+
+    /**
+     * @brief Move every point by @p offset.
+     */
+    void translate(const QPointF& offset) {
+        if (m_size == 0) return;
+        float* xs = mutableXData();
+        float* ys = mutableYData();
+        const qreal dx = offset.x();
+        const qreal dy = offset.y();
+        for (int i = 0; i < m_size; ++i) {
+            xs[i] = static_cast<float>(xs[i] + dx);
+            ys[i] = static_cast<float>(ys[i] + dy);
+        }
+    }
+
+    /**
+     * @brief Map every point through @p transform.
+     */
+    void transform(const QTransform& transform) {
+        if (m_size == 0) return;
+        float* xs = mutableXData();
+        float* ys = mutableYData();
+        for (int i = 0; i < m_size; ++i) {
+            const QPointF mapped = transform.map(QPointF(xs[i], ys[i]));
+            xs[i] = static_cast<float>(mapped.x());
+            ys[i] = static_cast<float>(mapped.y());
+        }
+    }
+
+    /**
+     * @brief Expand into StrokePoints (for code that needs an AoS copy).
+     */
+    QVector<StrokePoint> toVector() const {
+        QVector<StrokePoint> result;
+        result.reserve(m_size);
+        for (int i = 0; i < m_size; ++i) {
+            result.append(at(i));
+        }
+        return result;
+    }
+
+    // ===== Iteration (read-only, yields StrokePoint values) =====
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = StrokePoint;
+        using difference_type = int;
+        using pointer = void;
+        using reference = StrokePoint;
+
+        const_iterator() = default;
+        const_iterator(const StrokePointList* list, int index) : m_list(list), m_index(index) {}
+
+        StrokePoint operator*() const { return m_list->at(m_index); }
+        const_iterator& operator++() { ++m_index; return *this; }
+        const_iterator operator++(int) { const_iterator it = *this; ++m_index; return it; }
+        const_iterator& operator--() { --m_index; return *this; }
+        const_iterator& operator+=(int n) { m_index += n; return *this; }
+        const_iterator operator+(int n) const { return const_iterator(m_list, m_index + n); }
+        int operator-(const const_iterator& other) const { return m_index - other.m_index; }
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        const StrokePointList* m_list = nullptr;
+        int m_index = 0;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+private:
+    enum class TimeMode : quint8 {
+        None,     ///< No point has a timestamp; no column allocated
+        Offsets,  ///< int32 offsets from m_timeBase in the shared buffer
+        Wide      ///< Exact int64 values in m_wideTimes (offsets overflowed)
+    };
+
+    /// Offset marking a point without a recorded timestamp.
+    static constexpr qint32 NO_TIME = std::numeric_limits<qint32>::min();
+
+    static quint64 nextRevision() {
+        static std::atomic<quint64> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static int timeColumnOffset(int capacity) {
+        // x + y + pressure, rounded up so the int32 column stays aligned
+        return (capacity * 10 + 3) & ~3;
+    }
+
+    static int columnBytes(int capacity, TimeMode mode) {
+        return timeColumnOffset(capacity) + (mode == TimeMode::Offsets ? capacity * 4 : 0);
+    }
+
+    const qint32* timeOffsets() const {
+        return reinterpret_cast<const qint32*>(m_columns.constData() + timeColumnOffset(m_capacity));
+    }
+    qint32* mutableTimeOffsets() {
+        return reinterpret_cast<qint32*>(m_columns.data() + timeColumnOffset(m_capacity));
+    }
+
+    /**
+     * @brief Move the columns into a buffer for @p capacity points, adding
+     *        or dropping the timestamp column to match @p mode.
+     */
+    void relayout(int capacity, TimeMode mode) {
+        QByteArray columns(columnBytes(capacity, mode), Qt::Uninitialized);
+        char* dst = columns.data();
+        if (m_size > 0) {
+            const char* src = m_columns.constData();
+            std::memcpy(dst, src, size_t(m_size) * 4);
+            std::memcpy(dst + capacity * 4, src + m_capacity * 4, size_t(m_size) * 4);
+            std::memcpy(dst + capacity * 8, src + m_capacity * 8, size_t(m_size) * 2);
+        }
+        if (mode == TimeMode::Offsets) {
+            qint32* ts = reinterpret_cast<qint32*>(dst + timeColumnOffset(capacity));
+            if (m_timeMode == TimeMode::Offsets) {
+                std::memcpy(ts, timeOffsets(), size_t(m_size) * 4);
+            } else {
+                for (int i = 0; i < m_size; ++i) ts[i] = NO_TIME;
+            }
+        }
+        m_columns = columns;
+        m_capacity = capacity;
+        m_timeMode = mode;
+    }
+
+    void widenTimestamps() {
+        m_wideTimes.resize(m_size);
+        for (int i = 0; i < m_size; ++i) {
+            m_wideTimes[i] = timestamp(i);
+        }
+        relayout(m_capacity, TimeMode::Wide);
+    }
+
+    QByteArray m_columns;           ///< x | y | pressure | time offsets
+    QVector<qint64> m_wideTimes;    ///< Only used in TimeMode::Wide
+    qint64 m_timeBase = 0;          ///< First recorded timestamp
+    quint64 m_revision = 0;         ///< See revision(); 0 = never written
+    int m_size = 0;
+    int m_capacity = 0;
+    TimeMode m_timeMode = TimeMode::None;
+};
@@ -8,6 +8,9 @@
 // ============================================================================
 
 #include "StrokePoint.h"
+#include "StrokePointList.h"
+#include "StrokeKernels.h"
+#include "../core/Id128.h"
 
 #include <QMetaType>
 #include <QString>
@@ -17,7 +20,6 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QLineF>
-#include <QUuid>
 
 /**
  * @brief A complete vector stroke consisting of multiple points.
@@ -27,8 +29,8 @@
  * Provides hit testing for eraser functionality and serialization.
  */
 struct VectorStroke {
-    QString id;                     ///< UUID for tracking (used in undo/redo)
-    QVector<StrokePoint> points;    ///< All points in the stroke
+    Id128 id;                       ///< UUID for tracking (used in undo/redo)
+    StrokePointList points;         ///< All points in the stroke (column storage)
     QColor color;                   ///< Stroke color
     qreal baseThickness;            ///< Base thickness before pressure scaling
     QRectF boundingBox;             ///< Cached bounding box for fast culling/hit testing
@@ -51,14 +53,9 @@ struct VectorStroke {
             return;
         }
         qreal maxWidth = baseThickness * 2;
-        qreal minX = points[0].pos.x(), maxX = minX;
-        qreal minY = points[0].pos.y(), maxY = minY;
-        for (const auto& pt : points) {
-            minX = qMin(minX, pt.pos.x());
-            maxX = qMax(maxX, pt.pos.x());
-            minY = qMin(minY, pt.pos.y());
-            maxY = qMax(maxY, pt.pos.y());
-        }
+        float b[4];  // minX, minY, maxX, maxY
+        StrokeKernels::bounds(points.xData(), points.yData(), points.size(), b);
+        const qreal minX = b[0], minY = b[1], maxX = b[2], maxY = b[3];
         boundingBox = QRectF(minX - maxWidth, minY - maxWidth,
                              maxX - minX + maxWidth * 2,
                              maxY - minY + maxWidth * 2);
@@ -82,9 +79,11 @@ struct VectorStroke {
         
         // Single-point stroke (dot): check distance to the single point
         // Use baseThickness/2 because that's the actual visual radius of the stroke
+        const float* xs = points.xData();
+        const float* ys = points.yData();
         if (points.size() == 1) {
-            qreal dx = point.x() - points[0].pos.x();
-            qreal dy = point.y() - points[0].pos.y();
+            qreal dx = point.x() - xs[0];
+            qreal dy = point.y() - ys[0];
             qreal distSq = dx * dx + dy * dy;
             qreal threshold = tolerance + baseThickness / 2.0;
             return distSq < threshold * threshold;
@@ -92,8 +91,10 @@ struct VectorStroke {
         
         // Multi-point stroke: check each segment
         // Hit when eraser edge (tolerance) touches stroke edge (baseThickness/2)
+        const qreal threshold = tolerance + baseThickness / 2.0;
+        const qreal thresholdSq = threshold * threshold;
         for (int i = 1; i < points.size(); ++i) {
-            if (distanceToSegment(point, points[i-1].pos, points[i].pos) < tolerance + baseThickness / 2.0) {
+            if (distanceToSegmentSq(point.x(), point.y(), xs[i-1], ys[i-1], xs[i], ys[i]) < thresholdSq) {
                 return true;
             }
         }
@@ -106,7 +107,7 @@ struct VectorStroke {
      */
     QJsonObject toJson() const {
         QJsonObject obj;
-        obj["id"] = id;
+        obj["id"] = id.toString();
         obj["color"] = color.name(QColor::HexArgb);
         obj["thickness"] = baseThickness;
         QJsonArray pointsArray;
@@ -124,16 +125,17 @@ struct VectorStroke {
      */
     static VectorStroke fromJson(const QJsonObject& obj) {
         VectorStroke stroke;
-        stroke.id = obj["id"].toString();
+        stroke.id = Id128::fromString(obj["id"].toString());
         stroke.color = QColor(obj["color"].toString());
         stroke.baseThickness = obj["thickness"].toDouble(5.0);
         
         // Generate UUID if missing (for backwards compatibility)
-        if (stroke.id.isEmpty()) {
-            stroke.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        if (stroke.id.isNull()) {
+            stroke.id = Id128::create();
         }
         
         QJsonArray pointsArray = obj["points"].toArray();
+        stroke.points.reserve(pointsArray.size());
         for (const auto& val : pointsArray) {
             stroke.points.append(StrokePoint::fromJson(val.toObject()));
         }
@@ -143,20 +145,22 @@ struct VectorStroke {
     
 private:
     /**
-     * @brief Calculate distance from a point to a line segment.
-     * @param p The point to test.
-     * @param a Start of segment.
-     * @param b End of segment.
-     * @return Distance from p to the nearest point on segment ab.
+     * @brief Squared distance from point (px, py) to segment a-b.
+     * 
+     * Works on the raw point columns so hit testing never materializes
+     * StrokePoints; comparing squared distances also avoids a sqrt per segment.
      */
-    static qreal distanceToSegment(const QPointF& p, const QPointF& a, const QPointF& b) {
-        QPointF ab = b - a;
-        QPointF ap = p - a;
-        qreal lenSq = ab.x() * ab.x() + ab.y() * ab.y();
-        if (lenSq < 0.0001) return QLineF(p, a).length();
-        qreal t = qBound(0.0, (ap.x() * ab.x() + ap.y() * ab.y()) / lenSq, 1.0);
-        QPointF closest = a + t * ab;
-        return QLineF(p, closest).length();
+    static qreal distanceToSegmentSq(qreal px, qreal py, qreal ax, qreal ay, qreal bx, qreal by) {
+        const qreal abx = bx - ax;
+        const qreal aby = by - ay;
+        const qreal apx = px - ax;
+        const qreal apy = py - ay;
+        const qreal lenSq = abx * abx + aby * aby;
+        if (lenSq < 0.0001) return apx * apx + apy * apy;
+        const qreal t = qBound(0.0, (apx * abx + apy * aby) / lenSq, 1.0);
+        const qreal dx = px - (ax + t * abx);
+        const qreal dy = py - (ay + t * aby);
+        return dx * dx + dy * dy;
     }
 };
 
@@ -21,6 +21,8 @@ PageThumbnailModel::PageThumbnailModel(QObject* parent)
     // Connect renderer signals
     connect(m_renderer, &ThumbnailRenderer::thumbnailReady,
             this, &PageThumbnailModel::onThumbnailRendered);
+    connect(m_renderer, &ThumbnailRenderer::thumbnailEncoded,
+            this, &PageThumbnailModel::onThumbnailEncoded);
 }
 
 PageThumbnailModel::~PageThumbnailModel()
@@ -304,6 +306,7 @@ void PageThumbnailModel::setDevicePixelRatio(qreal dpr)
 
 void PageThumbnailModel::setPdfDarkMode(bool enabled)
 {
+    m_pdfDarkMode = enabled;
     m_renderer->setPdfDarkMode(enabled);
 }
 
@@ -315,8 +318,12 @@ QPixmap PageThumbnailModel::thumbnailForPage(int pageIndex) const
         return m_thumbnailCache.value(pageIndex);
     }
     
-    // Request thumbnail if not already pending
+    // Decode the bundle's stored thumbnail, or request a render if not
+    // already pending
     requestThumbnail(pageIndex);
+    if (m_thumbnailCache.contains(pageIndex)) {
+        return m_thumbnailCache.value(pageIndex);
+    }
     
     // Return null pixmap - delegate will show placeholder
     return QPixmap();
@@ -407,6 +414,38 @@ void PageThumbnailModel::onThumbnailRendered(int pageIndex, QPixmap thumbnail)
     emit thumbnailReady(pageIndex);
 }
 
+void PageThumbnailModel::onThumbnailEncoded(QString pageUuid, int pixelWidth, bool pdfDarkMode,
+                                            quint64 epoch, QByteArray encoded)
+{
+    if (m_document) {
+        m_document->storeThumbnail(pageUuid, pixelWidth, pdfDarkMode, encoded, epoch);
+    }
+}
+
+bool PageThumbnailModel::loadStoredThumbnail(int pageIndex) const
+{
+    if (!m_document) {
+        return false;
+    }
+    // Same physical width ThumbnailRenderer renders at
+    const int pixelWidth = static_cast<int>(m_thumbnailWidth * m_devicePixelRatio);
+    const QByteArray encoded = m_document->storedThumbnail(pageIndex, pixelWidth, m_pdfDarkMode);
+    if (encoded.isEmpty()) {
+        return false;
+    }
+    
+    QPixmap thumbnail;
+    if (!thumbnail.loadFromData(encoded) || thumbnail.width() != pixelWidth) {
+        return false;
+    }
+    thumbnail.setDevicePixelRatio(m_devicePixelRatio);
+    
+    m_thumbnailCache[pageIndex] = thumbnail;
+    touchCache(pageIndex);
+    evictOldestIfNeeded();
+    return true;
+}
+
 // ============================================================================
 // Thumbnail Request Methods
 // ============================================================================
@@ -425,6 +464,11 @@ void PageThumbnailModel::requestThumbnail(int pageIndex) const
         return;
     }
     
+    // Pages unchanged since their thumbnail was stored skip the renderer
+    if (loadStoredThumbnail(pageIndex)) {
+        return;
+    }
+    
     m_renderer->requestThumbnail(m_document, pageIndex, m_thumbnailWidth, m_devicePixelRatio);
 }
 
@@ -179,6 +179,12 @@ private slots:
      * @param thumbnail The rendered thumbnail pixmap.
      */
     void onThumbnailRendered(int pageIndex, QPixmap thumbnail);
+    
+    /**
+     * @brief Hand an encoded thumbnail to the document for the bundle.
+     */
+    void onThumbnailEncoded(QString pageUuid, int pixelWidth, bool pdfDarkMode, quint64 epoch,
+                            QByteArray encoded);
 
 private:
     /**
@@ -202,6 +208,13 @@ private:
      * @param pageIndex Page index to request.
      */
     void requestThumbnail(int pageIndex) const;
+    
+    /**
+     * @brief Decode the document's stored thumbnail into the cache.
+     * @param pageIndex Page index to look up.
+     * @return True if a stored thumbnail was found and cached.
+     */
+    bool loadStoredThumbnail(int pageIndex) const;
 
     // Document reference (not owned)
     Document* m_document = nullptr;
@@ -219,6 +232,7 @@ private:
     // Thumbnail settings
     int m_thumbnailWidth = 150;
     qreal m_devicePixelRatio = 1.0;
+    bool m_pdfDarkMode = false;
     
     // Async thumbnail renderer (owned)
     ThumbnailRenderer* m_renderer = nullptr;
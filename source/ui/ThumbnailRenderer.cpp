@@ -5,10 +5,12 @@
 #include "../layers/VectorLayer.h"
 #include "../pdf/PdfProvider.h"
 
+#include <QBuffer>
 #include <QPainter>
 #include <QtConcurrent>
 #include <QThreadStorage>
 #include <QDebug>
+#include <utility>
 
 // Thread-local cached PDF provider (keyed by resolved source path) so worker
 // threads never touch the Document's lazy provider map. Mirrors the same pattern
@@ -84,7 +86,7 @@ void ThumbnailRenderer::cancelAll()
     m_pendingRequests.clear();
     
     // Cancel active watchers
-    for (QFutureWatcher<QPair<int, QPixmap>>* watcher : m_activeWatchers) {
+    for (QFutureWatcher<RenderResult>* watcher : m_activeWatchers) {
         watcher->cancel();
         watcher->waitForFinished();
         delete watcher;
@@ -127,6 +129,8 @@ void ThumbnailRenderer::startNextTask()
         locker.unlock();
         
         bool wasLoaded = req.doc->isPageLoaded(req.pageIndex);
+        const QString pageUuid = req.doc->pageUuidAt(req.pageIndex);
+        const quint64 epoch = req.doc->thumbnailEpoch();
         
         ThumbnailSnapshot snapshot = createSnapshot(
             req.doc, req.pageIndex, req.width, req.dpr,
@@ -148,15 +152,29 @@ void ThumbnailRenderer::startNextTask()
         int pageIndex = snapshot.pageIndex;
         m_activePages.insert(pageIndex);
         
-        auto* watcher = new QFutureWatcher<QPair<int, QPixmap>>(this);
-        connect(watcher, &QFutureWatcher<QPair<int, QPixmap>>::finished,
+        auto* watcher = new QFutureWatcher<RenderResult>(this);
+        connect(watcher, &QFutureWatcher<RenderResult>::finished,
                 this, &ThumbnailRenderer::onRenderFinished);
         
         m_activeWatchers.append(watcher);
         
-        QFuture<QPair<int, QPixmap>> future = QtConcurrent::run([snapshot = std::move(snapshot)]() {
-            QPixmap result = renderFromSnapshot(snapshot);
-            return qMakePair(snapshot.pageIndex, result);
+        const int pixelWidth = static_cast<int>(req.width * req.dpr);
+        const bool pdfDarkMode = req.pdfDarkMode;
+        QFuture<RenderResult> future = QtConcurrent::run(
+            [snapshot = std::move(snapshot), pageUuid, pixelWidth, pdfDarkMode, epoch]() {
+            RenderResult result;
+            result.pageIndex = snapshot.pageIndex;
+            result.thumbnail = renderFromSnapshot(snapshot);
+            result.pageUuid = pageUuid;
+            result.pixelWidth = pixelWidth;
+            result.pdfDarkMode = pdfDarkMode;
+            result.epoch = epoch;
+            // Compress here so persisting the thumbnail costs the GUI
+            // thread nothing.
+            if (!result.thumbnail.isNull()) {
+                result.encoded = encodeThumbnail(result.thumbnail);
+            }
+            return result;
         });
         
         watcher->setFuture(future);
@@ -170,13 +188,13 @@ void ThumbnailRenderer::onRenderFinished()
     }
     
     // QFutureWatcher is a template without Q_OBJECT, so use static_cast
-    auto* watcher = static_cast<QFutureWatcher<QPair<int, QPixmap>>*>(sender());
+    auto* watcher = static_cast<QFutureWatcher<RenderResult>*>(sender());
     if (!watcher) {
         return;
     }
     
     // Get result before we lock the mutex
-    QPair<int, QPixmap> result;
+    RenderResult result;
     bool wasCancelled = watcher->isCanceled();
     if (!wasCancelled) {
         result = watcher->result();
@@ -188,7 +206,7 @@ void ThumbnailRenderer::onRenderFinished()
         // Remove from active
         m_activeWatchers.removeOne(watcher);
         if (!wasCancelled) {
-            m_activePages.remove(result.first);
+            m_activePages.remove(result.pageIndex);
         }
     }
     
@@ -199,8 +217,12 @@ void ThumbnailRenderer::onRenderFinished()
     delete watcher;
     
     // Emit result if not cancelled
-    if (!wasCancelled && !result.second.isNull()) {
-        emit thumbnailReady(result.first, result.second);
+    if (!wasCancelled && !result.thumbnail.isNull()) {
+        emit thumbnailReady(result.pageIndex, result.thumbnail);
+        if (!result.encoded.isEmpty()) {
+            emit thumbnailEncoded(result.pageUuid, result.pixelWidth, result.pdfDarkMode,
+                                  result.epoch, result.encoded);
+        }
     }
     
     // Try to start next task
@@ -242,8 +264,8 @@ ThumbnailRenderer::ThumbnailSnapshot ThumbnailRenderer::createSnapshot(
     int thumbnailHeight = static_cast<int>(width * aspectRatio);
     
     // Store PDF info for deferred rendering in the worker thread.
-    // MuPdfProvider::renderPageToImage() is already mutex-protected,
-    // so calling it from a worker is safe and keeps the main thread responsive.
+    // MuPdfProvider leases a per-call MuPDF context (lane), so calling it from
+    // a worker is safe, runs in parallel, and keeps the main thread responsive.
     if (page->backgroundType == Page::BackgroundType::PDF && page->pdfPageNumber >= 0
         && doc->providerForSource(page->pdfSourceId)) {
         // The worker renders directly against pdfSourcePath (the bundled mini-PDF when
@@ -267,7 +289,7 @@ ThumbnailRenderer::ThumbnailSnapshot ThumbnailRenderer::createSnapshot(
             LayerSnapshot layerSnap;
             layerSnap.visible = layer->visible;
             layerSnap.opacity = layer->opacity;
-            layerSnap.strokes = layer->strokes();
+            layerSnap.strokes = std::as_const(*layer).strokes();
             snapshot.layers.append(std::move(layerSnap));
         }
     }
@@ -419,3 +441,19 @@ QPixmap ThumbnailRenderer::renderFromSnapshot(const ThumbnailSnapshot& snapshot)
     return thumbnail;
 }
 
+QByteArray ThumbnailRenderer::encodeThumbnail(const QPixmap& thumbnail)
+{
+    // Thumbnails are opaque (filled white), so JPEG loses nothing that
+    // matters at this size and is ~5x smaller than PNG.
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    if (!thumbnail.save(&buffer, "JPG", 85)) {
+        bytes.clear();
+        buffer.seek(0);
+        if (!thumbnail.save(&buffer, "PNG")) {
+            return QByteArray();
+        }
+    }
+    return bytes;
+}
@@ -10,10 +10,12 @@
 // Thread Safety (BUG-PERF-003 fix):
 // Page/stroke data is snapshot-copied on the main thread before async rendering.
 // PDF rendering is deferred to the worker thread via Document::renderPdfPageToImage()
-// which is mutex-protected inside MuPdfProvider.
+// which leases its own MuPDF context inside MuPdfProvider, so workers render
+// pages concurrently.
 // ============================================================================
 
 #include <QObject>
+#include <QByteArray>
 #include <QPixmap>
 #include <QSet>
 #include <QMutex>
@@ -84,6 +86,18 @@ signals:
      */
     void thumbnailReady(int pageIndex, QPixmap thumbnail);
     
+    /**
+     * @brief Emitted after thumbnailReady with the thumbnail encoded for
+     *        Document::storeThumbnail() (encoded on the worker thread).
+     * @param pageUuid Page the thumbnail was rendered from.
+     * @param pixelWidth Rendered width in device pixels.
+     * @param pdfDarkMode Dark mode the thumbnail was requested with.
+     * @param epoch Document::thumbnailEpoch() at snapshot time.
+     * @param encoded JPEG (PNG if JPEG is unavailable) bytes.
+     */
+    void thumbnailEncoded(QString pageUuid, int pixelWidth, bool pdfDarkMode, quint64 epoch,
+                          QByteArray encoded);
+    
 private slots:
     void onRenderFinished();
     
@@ -168,6 +182,25 @@ private:
      */
     static QPixmap renderFromSnapshot(const ThumbnailSnapshot& snapshot);
     
+    /**
+     * @brief Output of one worker task.
+     */
+    struct RenderResult {
+        int pageIndex = -1;
+        QPixmap thumbnail;
+        QByteArray encoded;         // Compressed thumbnail for the bundle
+        QString pageUuid;
+        int pixelWidth = 0;
+        bool pdfDarkMode = false;
+        quint64 epoch = 0;
+    };
+    
+    /**
+     * @brief Compress a thumbnail for storage (called in worker thread).
+     * @return JPEG bytes, PNG if the JPEG plugin is missing, or empty.
+     */
+    static QByteArray encodeThumbnail(const QPixmap& thumbnail);
+    
     /**
      * @brief Lightweight request stored in the pending queue.
      * 
@@ -197,7 +230,7 @@ private:
     static constexpr int MAX_PENDING_REQUESTS = 8;
     
     // Future watchers for active renders
-    QList<QFutureWatcher<QPair<int, QPixmap>>*> m_activeWatchers;
+    QList<QFutureWatcher<RenderResult>*> m_activeWatchers;
     
     // Mutex for thread safety
     mutable QMutex m_mutex;
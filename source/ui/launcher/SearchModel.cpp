@@ -124,6 +124,7 @@ void SearchModel::setResults(const QList<NotebookInfo>& results)
     beginResetModel();
     m_folders.clear();
     m_notebooks = results;
+    m_contentNotebooks.clear();
     rebuildDisplayList();
     endResetModel();
 }
@@ -133,16 +134,53 @@ void SearchModel::setResults(const QStringList& folders, const QList<NotebookInf
     beginResetModel();
     m_folders = folders;
     m_notebooks = notebooks;
+    m_contentNotebooks.clear();
     rebuildDisplayList();
     endResetModel();
 }
 
+void SearchModel::appendContentResults(const QList<NotebookInfo>& notebooks)
+{
+    QList<NotebookInfo> added;
+    for (const NotebookInfo& nb : notebooks) {
+        if (nb.isValid() && !m_listedPaths.contains(nb.bundlePath)) {
+            m_listedPaths.insert(nb.bundlePath);
+            added.append(nb);
+        }
+    }
+    if (added.isEmpty()) {
+        return;
+    }
+    
+    // Section header goes in with the first batch
+    const bool needsHeader = m_contentNotebooks.isEmpty();
+    const int first = static_cast<int>(m_displayList.size());
+    const int last = first + static_cast<int>(added.size()) - (needsHeader ? 0 : 1);
+    beginInsertRows(QModelIndex(), first, last);
+    if (needsHeader) {
+        DisplayItem header;
+        header.type = SectionHeaderItem;
+        header.text = tr("IN CONTENTS");
+        m_displayList.append(header);
+    }
+    for (const NotebookInfo& nb : std::as_const(added)) {
+        m_contentNotebooks.append(nb);
+        DisplayItem nbItem;
+        nbItem.type = NotebookResultItem;
+        nbItem.notebook = nb;
+        m_displayList.append(nbItem);
+    }
+    endInsertRows();
+}
+
 void SearchModel::clear()
 {
     if (!m_displayList.isEmpty()) {
         beginResetModel();
         m_folders.clear();
         m_notebooks.clear();
+        m_contentNotebooks.clear();
+        m_listedPaths.clear();
         m_displayList.clear();
         endResetModel();
     }
@@ -151,6 +189,7 @@ void SearchModel::clear()
 void SearchModel::rebuildDisplayList()
 {
     m_displayList.clear();
+    m_listedPaths.clear();
     
     // Add folders section if there are folder results
     if (!m_folders.isEmpty()) {
@@ -183,6 +222,23 @@ void SearchModel::rebuildDisplayList()
             nbItem.type = NotebookResultItem;
             nbItem.notebook = nb;
             m_displayList.append(nbItem);
+            m_listedPaths.insert(nb.bundlePath);
+        }
+    }
+    
+    // Add content matches section if the full-text search found any
+    if (!m_contentNotebooks.isEmpty()) {
+        DisplayItem header;
+        header.type = SectionHeaderItem;
+        header.text = tr("IN CONTENTS");
+        m_displayList.append(header);
+        
+        for (const NotebookInfo& nb : m_contentNotebooks) {
+            DisplayItem nbItem;
+            nbItem.type = NotebookResultItem;
+            nbItem.notebook = nb;
+            m_displayList.append(nbItem);
+            m_listedPaths.insert(nb.bundlePath);
         }
     }
 }
@@ -3,6 +3,7 @@
 
 #include <QAbstractListModel>
 #include <QList>
+#include <QSet>
 #include "../../core/NotebookLibrary.h"
 
 /**
@@ -16,6 +17,9 @@
  * - Folder items as simple list items
  * - "NOTEBOOKS" section header (if notebooks found)
  * - Notebook cards
+ * - "IN CONTENTS" section header (if the library full-text search found
+ *   notebooks not already listed by name)
+ * - Notebook cards, appended as the content search streams them in
  * 
  * L-009: Updated to support mixed folder + notebook search results.
  * Phase P.3 Performance Optimization: Part of Model/View refactor.
@@ -30,7 +34,7 @@ public:
      * L-009: Distinguishes different item types in search results.
      */
     enum ItemType {
-        SectionHeaderItem = 0,  // Section header ("FOLDERS", "NOTEBOOKS")
+        SectionHeaderItem = 0,  // Section header ("FOLDERS", "NOTEBOOKS", "IN CONTENTS")
         FolderResultItem = 1,   // Folder search result (simple list item)
         NotebookResultItem = 2  // Notebook search result (card)
     };
@@ -83,6 +87,16 @@ public:
      */
     void setResults(const QStringList& folders, const QList<NotebookInfo>& notebooks);
     
+    /**
+     * @brief Append notebooks whose contents match the query.
+     * @param notebooks Matches from LibrarySearchIndex, in arrival order.
+     * 
+     * Notebooks already listed (by name or an earlier batch) are skipped.
+     * Rows are inserted at the end, so visible cards stay where they are.
+     * setResults() and clear() drop the content results.
+     */
+    void appendContentResults(const QList<NotebookInfo>& notebooks);
+    
     /**
      * @brief Clear all results.
      */
@@ -91,7 +105,9 @@ public:
     /**
      * @brief Get the total number of results (folders + notebooks).
      */
-    int resultCount() const { return static_cast<int>(m_folders.size() + m_notebooks.size()); }
+    int resultCount() const {
+        return static_cast<int>(m_folders.size() + m_notebooks.size() + m_contentNotebooks.size());
+    }
     
     /**
      * @brief Get the number of folder results.
@@ -103,10 +119,17 @@ public:
      */
     int notebookCount() const { return static_cast<int>(m_notebooks.size()); }
     
+    /**
+     * @brief Get the number of notebooks found by content only.
+     */
+    int contentNotebookCount() const { return static_cast<int>(m_contentNotebooks.size()); }
+    
     /**
      * @brief Check if the model has any results.
      */
-    bool isEmpty() const { return m_folders.isEmpty() && m_notebooks.isEmpty(); }
+    bool isEmpty() const {
+        return m_folders.isEmpty() && m_notebooks.isEmpty() && m_contentNotebooks.isEmpty();
+    }
     
     /**
      * @brief Get the item type at a specific index.
@@ -150,6 +173,8 @@ private:
     
     QStringList m_folders;           // Raw folder search results
     QList<NotebookInfo> m_notebooks; // Raw notebook search results
+    QList<NotebookInfo> m_contentNotebooks; // Content matches not in m_notebooks
+    QSet<QString> m_listedPaths;     // Bundle paths of all listed notebooks
     QList<DisplayItem> m_displayList; // Flattened list with sections
 };
 
@@ -4,6 +4,7 @@
 #include "NotebookCardDelegate.h"
 #include "../ThemeColors.h"
 #include "../../core/NotebookLibrary.h"
+#include "../../core/LibrarySearchIndex.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -19,7 +20,7 @@
  * @brief Composite delegate for search results with section headers, folders, and notebooks.
  * 
  * Renders three types of items:
- * - Section headers ("FOLDERS", "NOTEBOOKS") - full width, gray text
+ * - Section headers ("FOLDERS", "NOTEBOOKS", "IN CONTENTS") - full width, gray text
  * - Folder items - simple list items with folder icon and arrow
  * - Notebook items - delegated to NotebookCardDelegate
  */
@@ -212,6 +213,15 @@ SearchView::SearchView(QWidget* parent)
     m_debounceTimer->setSingleShot(true);
     m_debounceTimer->setInterval(DEBOUNCE_MS);
     connect(m_debounceTimer, &QTimer::timeout, this, &SearchView::performSearch);
+    
+    // Library full-text search: results stream in per batch
+    LibrarySearchIndex* index = LibrarySearchIndex::instance();
+    connect(index, &LibrarySearchIndex::contentMatches,
+            this, &SearchView::onContentMatches);
+    connect(index, &LibrarySearchIndex::queryFinished,
+            this, &SearchView::onContentQueryFinished);
+    connect(index, &LibrarySearchIndex::indexUpdated,
+            this, &SearchView::onLibraryIndexUpdated);
 }
 
 void SearchView::setupUi()
@@ -340,6 +350,8 @@ void SearchView::updateSearchIcon()
 
 void SearchView::clearSearch()
 {
+    LibrarySearchIndex::instance()->cancelQuery();
+    m_contentSearching = false;
     m_searchInput->clear();
     m_lastQuery.clear();
     m_clearButton->setVisible(false);
@@ -381,6 +393,8 @@ void SearchView::performSearch()
     m_lastQuery = query;
     
     if (query.isEmpty()) {
+        LibrarySearchIndex::instance()->cancelQuery();
+        m_contentSearching = false;
         m_model->clear();
         m_statusLabel->setVisible(false);
         showEmptyState(tr("Type to search notebooks and folders"));
@@ -392,13 +406,77 @@ void SearchView::performSearch()
     QStringList folders = lib->searchStarredFolders(query);
     QList<NotebookInfo> notebooks = lib->search(query);
     
-    int folderCount = static_cast<int>(folders.size());
-    int notebookCount = static_cast<int>(notebooks.size());
+    // Name matches show immediately; content matches are appended as the
+    // library index confirms them.
+    m_model->setResults(folders, notebooks);
+    startContentSearch();
+    updateStatus();
+}
+
+void SearchView::startContentSearch()
+{
+    LibrarySearchIndex* index = LibrarySearchIndex::instance();
+    if (m_lastQuery.size() < LibrarySearchIndex::MIN_QUERY_LENGTH) {
+        index->cancelQuery();
+        m_contentSearching = false;
+        return;
+    }
+    m_contentQueryId = index->startQuery(m_lastQuery);
+    m_contentSearching = true;
+}
+
+void SearchView::onContentMatches(quint64 queryId, const QStringList& bundlePaths)
+{
+    if (queryId != m_contentQueryId || m_lastQuery.isEmpty()) {
+        return;  // Stale query
+    }
+    
+    NotebookLibrary* lib = NotebookLibrary::instance();
+    QList<NotebookInfo> notebooks;
+    for (const QString& path : bundlePaths) {
+        NotebookInfo nb = lib->notebookInfo(path);
+        if (nb.isValid()) {
+            notebooks.append(nb);
+        }
+    }
+    m_model->appendContentResults(notebooks);
+    updateStatus();
+}
+
+void SearchView::onContentQueryFinished(quint64 queryId)
+{
+    if (queryId != m_contentQueryId) {
+        return;
+    }
+    m_contentSearching = false;
+    updateStatus();
+}
+
+void SearchView::onLibraryIndexUpdated()
+{
+    // Notebooks indexed since the query started may match too. Matches
+    // already listed stay; new ones are appended.
+    if (!m_lastQuery.isEmpty()) {
+        startContentSearch();
+        updateStatus();
+    }
+}
+
+void SearchView::updateStatus()
+{
+    if (m_lastQuery.isEmpty()) {
+        return;
+    }
+    
+    int folderCount = m_model->folderCount();
+    int notebookCount = m_model->notebookCount() + m_model->contentNotebookCount();
     int totalCount = folderCount + notebookCount;
     
     // Update status with both counts
     if (totalCount == 0) {
-        m_statusLabel->setText(tr("No results found for \"%1\"").arg(query));
+        m_statusLabel->setText(m_contentSearching
+            ? tr("Searching notebook contents for \"%1\"...").arg(m_lastQuery)
+            : tr("No results found for \"%1\"").arg(m_lastQuery));
     } else {
         // Build status text showing both counts
         QStringList parts;
@@ -413,12 +491,12 @@ void SearchView::performSearch()
     m_statusLabel->setVisible(true);
     
     // Display results
-    if (totalCount == 0) {
-        m_model->clear();
-        showEmptyState(tr("No results match your search.\n\nTry a different search term."));
-    } else {
-        m_model->setResults(folders, notebooks);
+    if (totalCount > 0) {
         showResults();
+    } else if (m_contentSearching) {
+        showEmptyState(tr("Searching notebook contents..."));
+    } else {
+        showEmptyState(tr("No results match your search.\n\nTry a different search term."));
     }
 }
 
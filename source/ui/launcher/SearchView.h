@@ -16,17 +16,20 @@ struct NotebookInfo;
 /**
  * @brief Search view for the Launcher.
  * 
- * Provides search functionality for notebooks by name and PDF filename.
+ * Provides search functionality for notebooks by name and PDF filename,
+ * plus a full-text search of notebook contents (LibrarySearchIndex).
  * 
  * Features:
  * - Search input with clear button
  * - Real-time search with 300ms debounce
  * - Virtualized grid of notebook cards (Model/View)
+ * - Content matches streamed in below the name matches as they are confirmed
  * - "No results" message
  * - Keyboard-friendly: Enter to search, Escape to clear
  * - Touch-friendly scrolling with kinetic momentum
  * 
- * Search scope (per Q&A): Notebook names + PDF filenames
+ * Search scope (per Q&A): Notebook names + PDF filenames; contents (PDF
+ * text, OCR, text boxes, markdown notes) for queries of 2+ characters
  * 
  * Phase P.3: Refactored to use Model/View for virtualization and performance.
  */
@@ -82,12 +85,19 @@ private slots:
     void onNotebookClicked(const QString& bundlePath);
     void onNotebookMenuRequested(const QString& bundlePath, const QPoint& globalPos);
     void onFolderClicked(const QString& folderName);
+    
+    // Slots for the library full-text search
+    void onContentMatches(quint64 queryId, const QStringList& bundlePaths);
+    void onContentQueryFinished(quint64 queryId);
+    void onLibraryIndexUpdated();
 
 private:
     void setupUi();
     void showEmptyState(const QString& message);
     void showResults();
     void updateSearchIcon();
+    void startContentSearch();
+    void updateStatus();
     
     // Search bar
     QWidget* m_searchBar = nullptr;
@@ -111,6 +121,10 @@ private:
     QString m_lastQuery;
     bool m_darkMode = false;
     
+    // Library full-text search (results arrive asynchronously)
+    quint64 m_contentQueryId = 0;
+    bool m_contentSearching = false;
+    
     // Constants
     static constexpr int DEBOUNCE_MS = 300;
     static constexpr int GRID_SPACING = 12;